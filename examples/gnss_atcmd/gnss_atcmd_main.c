@@ -58,6 +58,7 @@
 #include "gnss_usbserial.h"
 #endif /* if defined(CONFIG_EXAMPLES_GNSS_ATCMD_USB) */
 #include "gnss_atcmd.h"
+#include "gnss_nmeabuf.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -72,8 +73,6 @@
 #define READ_FD                   cmdfds[GNSS_ATCMD_READ_FD]
 #define WRITE_FD                  cmdfds[GNSS_ATCMD_WRITE_FD]
 
-#define _USE_STATIC_NMEA_BUF
-
 #ifdef _DEBUG
 #define dbg_printf                printf
 #else
@@ -133,9 +132,8 @@ static pthread_t              atcmd_tid;
 static struct cxd56_gnss_positiondata_s  posdat;
 static int                    cmdfds[2];
 static char                   cmd_rbuf[CMD_RBUF_SIZE];
-#ifdef _USE_STATIC_NMEA_BUF
-static char                   nmea_buf[NMEA_SENTENCE_MAX_LEN];
-#endif
+static struct gnss_nmeabuf_s  nmeabuf;
+static char                   nmea_ring[CONFIG_EXAMPLES_GNSS_ATCMD_NMEABUF_SIZE];
 #ifdef USE_ATCMD_SUB_THREAD
 static sem_t                  syncsem;
 static pthread_t              atcmd_sub_tid;
@@ -170,7 +168,12 @@ static int print_nmea(int fd)
       goto _err1;
     }
 
-   NMEA_Output(&posdat);
+  /* All sentences of this epoch are gathered in the ring, send them at
+   * once.
+   */
+
+  NMEA_Output(&posdat);
+  gnss_nmeabuf_flush(&nmeabuf);
 
 _err1:
   return ret;
@@ -205,6 +208,7 @@ static int print_spectrum(int fd)
         }
 
       NMEA_OutputSpectrum(&spectrumdat);
+      gnss_nmeabuf_flush(&nmeabuf);
     }
   while (1);
 
@@ -237,6 +241,7 @@ static int print_dcreport(int fd)
     }
 
   NMEA_DcReport_Output(&dcreport);
+  gnss_nmeabuf_flush(&nmeabuf);
 
 _err1:
   return ret;
@@ -244,37 +249,30 @@ _err1:
 
 #endif /* ifdef CONFIG_EXAMPLES_GNSS_ATCMD_SUPPORT_DCREPORT */
 
-/* output NMEA */
+/* output NMEA: the library formats each sentence directly into the
+ * ring, the caller of NMEA_Output() flushes it.
+ */
 
 FAR static char *reqbuf(uint16_t size)
 {
-#ifdef _USE_STATIC_NMEA_BUF
-  if (size > sizeof(nmea_buf))
-    {
-      printf("reqbuf error: oversize %s\n", size);
-      return NULL;
-    }
-  return nmea_buf;
-#else
-  return malloc(size);
-#endif
+  return gnss_nmeabuf_reserve(&nmeabuf, size);
 }
 
 static void freebuf(FAR char *buf)
 {
-#ifdef _USE_STATIC_NMEA_BUF
-#else
-  free(buf);
-#endif
+  gnss_nmeabuf_release(&nmeabuf);
 }
 
 static int outnmea(FAR char *buf)
 {
-  return gnss_atcmd_printf(WRITE_FD, "%s", buf);
+  return gnss_nmeabuf_commit(&nmeabuf, strlen(buf));
 }
 
 static int outbin(FAR char *buf, uint32_t len)
 {
+  /* Binary output is not staged, keep it behind the queued sentences */
+
+  gnss_nmeabuf_flush(&nmeabuf);
   return write(WRITE_FD, buf, (size_t)len);
 }
 
@@ -392,6 +390,8 @@ static FAR void atcmd_emulator(FAR void *arg)
   ioctl(fd, TCSETS, (unsigned long)&tio);
 #endif
 
+  gnss_nmeabuf_init(&nmeabuf, WRITE_FD, nmea_ring, sizeof(nmea_ring));
+
   atcmd_info.gnssfd = fd;
   atcmd_info.wfd    = WRITE_FD;
   atcmd_info.rfd    = READ_FD;
@@ -466,6 +466,7 @@ static FAR void atcmd_emulator(FAR void *arg)
 #ifdef _DEBUG
           write(WRITE_FD, cmd_rbuf, sz);
 #endif
+          gnss_nmeabuf_flush(&nmeabuf);
           ret = gnss_atcmd_exec(&atcmd_info, cmd_rbuf, sz);
         }
 
@@ -481,6 +482,11 @@ _continue:
     }
   while (ret != -ESHUTDOWN);
 
+  gnss_nmeabuf_flush(&nmeabuf);
+  printf("NMEA: %lu sentences, %lu writes, %lu dropped\n",
+         (unsigned long)nmeabuf.sentences, (unsigned long)nmeabuf.writes,
+         (unsigned long)nmeabuf.drops);
+
   /* close tty */
 
 #if defined(CONFIG_EXAMPLES_GNSS_ATCMD_USB)
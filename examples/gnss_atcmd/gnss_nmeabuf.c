@@ -0,0 +1,233 @@
+/****************************************************************************
+ * gnss_atcmd/gnss_nmeabuf.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "gnss_nmeabuf.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void nmeabuf_rewind(FAR struct gnss_nmeabuf_s *nb)
+{
+  /* Restart from the top of the storage once everything has been sent so
+   * that the next epoch is contiguous and goes out with a single write().
+   * An outstanding reservation pins the current position.
+   */
+
+  if (nb->resv == NULL && gnss_nmeabuf_pending(nb) == 0)
+    {
+      nb->head = 0;
+      nb->tail = 0;
+      nb->wrap = 0;
+    }
+}
+
+static FAR char *nmeabuf_tryreserve(FAR struct gnss_nmeabuf_s *nb,
+                                    size_t size)
+{
+  nmeabuf_rewind(nb);
+
+  if (nb->wrap == 0)
+    {
+      if (nb->size - nb->head >= size)
+        {
+          return &nb->buf[nb->head];
+        }
+
+      if (nb->tail >= size)
+        {
+          /* Not enough room at the end, continue from the top */
+
+          nb->wrap = nb->head;
+          nb->head = 0;
+          return nb->buf;
+        }
+    }
+  else if (nb->tail - nb->head >= size)
+    {
+      return &nb->buf[nb->head];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void gnss_nmeabuf_init(FAR struct gnss_nmeabuf_s *nb, int fd,
+                       FAR char *buf, size_t size)
+{
+  memset(nb, 0, sizeof(struct gnss_nmeabuf_s));
+  nb->buf  = buf;
+  nb->size = size;
+  nb->fd   = fd;
+}
+
+FAR char *gnss_nmeabuf_reserve(FAR struct gnss_nmeabuf_s *nb, size_t size)
+{
+  FAR char *p;
+
+  nb->resv = NULL;
+
+  p = nmeabuf_tryreserve(nb, size);
+  if (p == NULL)
+    {
+      /* Backpressure: hand what we have to the driver and try again */
+
+      (void)gnss_nmeabuf_flush(nb);
+      p = nmeabuf_tryreserve(nb, size);
+    }
+
+  if (p == NULL)
+    {
+      nb->drops++;
+      return NULL;
+    }
+
+  nb->resv = p;
+  return p;
+}
+
+int gnss_nmeabuf_commit(FAR struct gnss_nmeabuf_s *nb, size_t len)
+{
+  size_t limit;
+
+  if (nb->resv == NULL)
+    {
+      return -EINVAL;
+    }
+
+  limit = nb->wrap ? nb->tail - nb->head : nb->size - nb->head;
+  if (len > limit)
+    {
+      return -EINVAL;
+    }
+
+  nb->head += len;
+  nb->resv  = NULL;
+  nb->sentences++;
+
+  return (int)len;
+}
+
+void gnss_nmeabuf_release(FAR struct gnss_nmeabuf_s *nb)
+{
+  nb->resv = NULL;
+}
+
+ssize_t gnss_nmeabuf_flush(FAR struct gnss_nmeabuf_s *nb)
+{
+  ssize_t total = 0;
+  ssize_t n;
+  size_t  end;
+
+  while (gnss_nmeabuf_pending(nb) > 0)
+    {
+      end = nb->wrap ? nb->wrap : nb->head;
+
+      n = write(nb->fd, &nb->buf[nb->tail], end - nb->tail);
+      if (n < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+              break;
+            }
+
+          return -errno;
+        }
+
+      nb->writes++;
+      if (n == 0)
+        {
+          break;
+        }
+
+      nb->bytes += n;
+      nb->tail  += n;
+      total     += n;
+
+      if (nb->wrap && nb->tail == nb->wrap)
+        {
+          nb->wrap = 0;
+          nb->tail = 0;
+        }
+    }
+
+  nmeabuf_rewind(nb);
+  return total;
+}
+
+size_t gnss_nmeabuf_pending(FAR const struct gnss_nmeabuf_s *nb)
+{
+  if (nb->wrap)
+    {
+      return nb->wrap - nb->tail + nb->head;
+    }
+
+  return nb->head - nb->tail;
+}
+
+size_t gnss_nmeabuf_space(FAR const struct gnss_nmeabuf_s *nb)
+{
+  size_t end;
+
+  if (gnss_nmeabuf_pending(nb) == 0)
+    {
+      return nb->size;
+    }
+
+  if (nb->wrap)
+    {
+      return nb->tail - nb->head;
+    }
+
+  end = nb->size - nb->head;
+  return end > nb->tail ? end : nb->tail;
+}
@@ -0,0 +1,129 @@
+/****************************************************************************
+ * gnss_atcmd/gnss_nmeabuf.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __EXAMPLES_GNSS_ATCMD_GNSS_NMEABUF_H
+#define __EXAMPLES_GNSS_ATCMD_GNSS_NMEABUF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_GNSS_ATCMD_NMEABUF_SIZE
+#  define CONFIG_EXAMPLES_GNSS_ATCMD_NMEABUF_SIZE 2048
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* NMEA output ring.  The NMEA library formats each sentence directly into
+ * space reserved in the ring (bufReq), the sentence is committed by the
+ * output callback (out) and everything gathered for one epoch is handed to
+ * the driver by gnss_nmeabuf_flush().  When the driver does not accept all
+ * of the data (non-blocking descriptor) the rest stays queued and is sent
+ * ahead of the next epoch; whole sentences that do not fit are dropped and
+ * counted.
+ *
+ * The pending data is [tail, head) or, after the producer has wrapped,
+ * [tail, wrap) followed by [0, head).  A flush of an un-wrapped ring is
+ * always a single write().
+ */
+
+struct gnss_nmeabuf_s
+{
+  FAR char *buf;      /* Ring storage */
+  size_t    size;     /* Size of the ring storage */
+  size_t    head;     /* Producer offset */
+  size_t    tail;     /* Consumer (flush) offset */
+  size_t    wrap;     /* End of data before the wrap point, 0 if none */
+  FAR char *resv;     /* Outstanding reservation or NULL */
+  int       fd;       /* Output descriptor */
+
+  /* Statistics */
+
+  uint32_t  sentences; /* Committed sentences */
+  uint32_t  drops;     /* Sentences dropped for lack of space */
+  uint32_t  writes;    /* write() calls issued */
+  uint32_t  bytes;     /* Bytes accepted by the driver */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Attach storage and an output descriptor.  No memory is allocated. */
+
+void gnss_nmeabuf_init(FAR struct gnss_nmeabuf_s *nb, int fd,
+                       FAR char *buf, size_t size);
+
+/* Reserve 'size' contiguous bytes for one sentence.  If the ring is too
+ * full, a flush is tried first.  Returns NULL (and counts a drop) if the
+ * space is still not available.
+ */
+
+FAR char *gnss_nmeabuf_reserve(FAR struct gnss_nmeabuf_s *nb, size_t size);
+
+/* Commit 'len' bytes written to the outstanding reservation. */
+
+int gnss_nmeabuf_commit(FAR struct gnss_nmeabuf_s *nb, size_t len);
+
+/* Release the outstanding reservation, if any, without committing. */
+
+void gnss_nmeabuf_release(FAR struct gnss_nmeabuf_s *nb);
+
+/* Write the pending data.  Returns the number of bytes accepted by the
+ * driver, which may be less than gnss_nmeabuf_pending() when the
+ * descriptor is non-blocking, or a negated errno value.
+ */
+
+ssize_t gnss_nmeabuf_flush(FAR struct gnss_nmeabuf_s *nb);
+
+/* Backpressure status: bytes waiting for the driver, and the largest
+ * sentence that can currently be reserved without flushing.
+ */
+
+size_t gnss_nmeabuf_pending(FAR const struct gnss_nmeabuf_s *nb);
+size_t gnss_nmeabuf_space(FAR const struct gnss_nmeabuf_s *nb);
+
+#endif /* __EXAMPLES_GNSS_ATCMD_GNSS_NMEABUF_H */
@@ -0,0 +1,190 @@
+/****************************************************************************
+ * gnss_atcmd/host/nmea_validate.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "nmea_validate.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int hexval(char c)
+{
+  if (c >= '0' && c <= '9')
+    {
+      return c - '0';
+    }
+
+  if (c >= 'A' && c <= 'F')
+    {
+      return c - 'A' + 10;
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+uint8_t nmea_checksum(FAR const char *s, size_t len)
+{
+  uint8_t sum = 0;
+
+  while (len-- > 0)
+    {
+      sum ^= (uint8_t)*s++;
+    }
+
+  return sum;
+}
+
+int nmea_validate(FAR const char *s, size_t len, size_t maxlen)
+{
+  size_t star;
+  size_t i;
+  int hi;
+  int lo;
+
+  if (len < 1 || (s[0] != '$' && s[0] != '!'))
+    {
+      return NMEA_ERR_START;
+    }
+
+  if (len > maxlen)
+    {
+      return NMEA_ERR_LENGTH;
+    }
+
+  if (len < 2 || s[len - 2] != '\r' || s[len - 1] != '\n')
+    {
+      return NMEA_ERR_EOL;
+    }
+
+  /* Address field: talker and sentence formatter, or proprietary */
+
+  for (i = 1; i < len - 2 && s[i] != ',' && s[i] != '*'; i++)
+    {
+      if (!isupper((unsigned char)s[i]) && !isdigit((unsigned char)s[i]))
+        {
+          return NMEA_ERR_ADDRESS;
+        }
+    }
+
+  if (i == 1)
+    {
+      return NMEA_ERR_ADDRESS;
+    }
+
+  /* Body */
+
+  for (star = i; star < len - 2 && s[star] != '*'; star++)
+    {
+      unsigned char c = (unsigned char)s[star];
+
+      if (c < 0x20 || c > 0x7e || c == '$' || c == '!')
+        {
+          return NMEA_ERR_CHAR;
+        }
+    }
+
+  if (star + 5 != len)
+    {
+      return star >= len - 2 ? NMEA_ERR_NOCHKSUM : NMEA_ERR_CHAR;
+    }
+
+  hi = hexval(s[star + 1]);
+  lo = hexval(s[star + 2]);
+  if (hi < 0 || lo < 0)
+    {
+      return NMEA_ERR_NOCHKSUM;
+    }
+
+  if (nmea_checksum(&s[1], star - 1) != (uint8_t)(hi << 4 | lo))
+    {
+      return NMEA_ERR_CHKSUM;
+    }
+
+  return NMEA_VALID;
+}
+
+int nmea_validate_stream(FAR const char *buf, size_t len, size_t maxlen,
+                         FAR struct nmea_validate_stats_s *st)
+{
+  FAR const char *end = buf + len;
+  FAR const char *lf;
+  int errors = 0;
+  int ret;
+
+  if (st->sentences == 0 && st->errors == 0)
+    {
+      st->firsterr = NMEA_VALID;
+    }
+
+  while (buf < end)
+    {
+      lf = memchr(buf, '\n', end - buf);
+      if (lf == NULL)
+        {
+          st->partial += end - buf;
+          break;
+        }
+
+      st->sentences++;
+      ret = nmea_validate(buf, lf - buf + 1, maxlen);
+      if (ret != NMEA_VALID)
+        {
+          if (st->errors == 0)
+            {
+              st->firsterr = ret;
+              st->firstpos = len - (end - buf);
+            }
+
+          st->errors++;
+          errors++;
+        }
+
+      buf = lf + 1;
+    }
+
+  return errors;
+}
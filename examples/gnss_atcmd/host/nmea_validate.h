@@ -0,0 +1,99 @@
+/****************************************************************************
+ * gnss_atcmd/host/nmea_validate.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __EXAMPLES_GNSS_ATCMD_HOST_NMEA_VALIDATE_H
+#define __EXAMPLES_GNSS_ATCMD_HOST_NMEA_VALIDATE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* nmea_validate() results */
+
+#define NMEA_VALID          0
+#define NMEA_ERR_START     -1  /* Does not start with '$' or '!' */
+#define NMEA_ERR_ADDRESS   -2  /* Bad talker/sentence address field */
+#define NMEA_ERR_CHAR      -3  /* Reserved or non printable character */
+#define NMEA_ERR_NOCHKSUM  -4  /* No "*hh" checksum field */
+#define NMEA_ERR_CHKSUM    -5  /* Checksum mismatch */
+#define NMEA_ERR_EOL       -6  /* Not terminated by CR LF */
+#define NMEA_ERR_LENGTH    -7  /* Longer than the allowed maximum */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct nmea_validate_stats_s
+{
+  uint32_t sentences;  /* Complete sentences seen */
+  uint32_t errors;     /* Sentences rejected */
+  uint32_t partial;    /* Trailing bytes without CR LF */
+  int      firsterr;   /* First error code, NMEA_VALID if none */
+  size_t   firstpos;   /* Offset of the first rejected sentence */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Check one sentence "$<address>,<fields>*<hh>\r\n" of 'len' bytes.  The
+ * address must be alphanumeric, the body printable ASCII without the
+ * reserved '$', '!' and '*', the checksum two upper case hex digits equal
+ * to the XOR of the bytes between the start delimiter and '*', and the
+ * whole sentence at most 'maxlen' bytes including CR LF.
+ */
+
+int nmea_validate(FAR const char *s, size_t len, size_t maxlen);
+
+/* Split 'buf' at CR LF and validate every sentence.  Statistics are
+ * accumulated in 'st'.  Returns the number of rejected sentences.
+ */
+
+int nmea_validate_stream(FAR const char *buf, size_t len, size_t maxlen,
+                         FAR struct nmea_validate_stats_s *st);
+
+/* NMEA checksum of the bytes between the start delimiter and '*' */
+
+uint8_t nmea_checksum(FAR const char *s, size_t len);
+
+#endif /* __EXAMPLES_GNSS_ATCMD_HOST_NMEA_VALIDATE_H */
@@ -0,0 +1,572 @@
+/****************************************************************************
+ * gnss_atcmd/host/nmeabufbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host test and benchmark for the gnss_atcmd NMEA output ring.  A stand-in
+ *   for the NMEA library emits one epoch (GGA, GLL, 2 x GSA, 5 x GSV, RMC,
+ *   VTG, ZDA) through the NMEA_OUTPUT_CB callbacks, either with the former
+ *   per-sentence output (one formatted write() per sentence) or through
+ *   gnss_nmeabuf with one flush per epoch.
+ *
+ *   -t checks that the batched stream is identical to the per-sentence
+ *      stream and passes nmea_validate_stream(), then overfills a
+ *      non-blocking pipe and checks that only whole sentences are dropped.
+ *   -b <epochs> reports write() calls per epoch and CPU time per fix.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <sdk/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+#include "gpsutils/cxd56_gnss_nmea.h"
+#include "gnss_nmeabuf.h"
+#include "nmea_validate.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SENTENCES_PER_EPOCH  12
+#define WBUF_SIZE            256
+#define TEST_EPOCHS          1000
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static NMEA_OUTPUT_CB        g_funcs;
+static int                   g_fd;
+static char                  g_sentence[NMEA_SENTENCE_MAX_LEN];
+static char                  g_wbuf[WBUF_SIZE];
+static struct gnss_nmeabuf_s g_nmeabuf;
+static char                  g_ring[CONFIG_EXAMPLES_GNSS_ATCMD_NMEABUF_SIZE];
+static uint32_t              g_writes;
+static uint32_t              g_emitted;
+
+/****************************************************************************
+ * External Function Prototypes
+ ****************************************************************************/
+
+ssize_t __real_write(int fd, FAR const void *buf, size_t len);
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+ssize_t __wrap_write(int fd, FAR const void *buf, size_t len)
+{
+  g_writes++;
+  return __real_write(fd, buf, len);
+}
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Per-sentence output, as gnss_atcmd did before the ring */
+
+static FAR char *legacy_reqbuf(uint16_t size)
+{
+  return size > sizeof(g_sentence) ? NULL : g_sentence;
+}
+
+static void legacy_freebuf(FAR char *buf)
+{
+}
+
+static int legacy_out(FAR char *buf)
+{
+  int n = snprintf(g_wbuf, WBUF_SIZE, "%s", buf);
+
+  return write(g_fd, g_wbuf, n);
+}
+
+/* Batched output through gnss_nmeabuf */
+
+static FAR char *ring_reqbuf(uint16_t size)
+{
+  return gnss_nmeabuf_reserve(&g_nmeabuf, size);
+}
+
+static void ring_freebuf(FAR char *buf)
+{
+  gnss_nmeabuf_release(&g_nmeabuf);
+}
+
+static int ring_out(FAR char *buf)
+{
+  return gnss_nmeabuf_commit(&g_nmeabuf, strlen(buf));
+}
+
+static void set_output(bool batched, int fd)
+{
+  g_fd = fd;
+  if (batched)
+    {
+      gnss_nmeabuf_init(&g_nmeabuf, fd, g_ring, sizeof(g_ring));
+      g_funcs.bufReq  = ring_reqbuf;
+      g_funcs.bufFree = ring_freebuf;
+      g_funcs.out     = ring_out;
+    }
+  else
+    {
+      g_funcs.bufReq  = legacy_reqbuf;
+      g_funcs.bufFree = legacy_freebuf;
+      g_funcs.out     = legacy_out;
+    }
+}
+
+/* Stand-in for the NMEA library: request a buffer, format into it, output
+ * and free it.
+ */
+
+static void emit(FAR const char *fmt, ...)
+{
+  FAR char *p;
+  va_list ap;
+  int n;
+
+  g_emitted++;
+
+  p = g_funcs.bufReq(NMEA_SENTENCE_MAX_LEN);
+  if (p == NULL)
+    {
+      return;
+    }
+
+  p[0] = '$';
+  va_start(ap, fmt);
+  n = 1 + vsnprintf(&p[1], NMEA_SENTENCE_MAX_LEN - 6, fmt, ap);
+  va_end(ap);
+
+  snprintf(&p[n], 6, "*%02X\r\n", nmea_checksum(&p[1], n - 1));
+  g_funcs.out(p);
+  g_funcs.bufFree(p);
+}
+
+static void emit_epoch(uint32_t i)
+{
+  unsigned int hh = (i / 3600) % 24;
+  unsigned int mm = (i / 60) % 60;
+  unsigned int ss = i % 60;
+  unsigned int lat = 3541 + i % 10;
+  unsigned int sv;
+  unsigned int k;
+
+  emit("GPGGA,%02u%02u%02u.00,%04u.1234,N,13944.5678,E,1,%02u,0.9,42.%u,M,"
+       "39.4,M,,", hh, mm, ss, lat, 8 + i % 4, i % 10);
+  emit("GPGLL,%04u.1234,N,13944.5678,E,%02u%02u%02u.00,A,A",
+       lat, hh, mm, ss);
+  emit("GPGSA,A,3,01,03,08,11,14,17,19,22,28,32,,,1.6,0.9,1.3");
+  emit("GLGSA,A,3,65,66,72,73,81,,,,,,,,1.6,0.9,1.3");
+
+  for (k = 0; k < 3; k++)
+    {
+      sv = k * 4 + 1;
+      emit("GPGSV,3,%u,12,%02u,%02u,%03u,%02u,%02u,%02u,%03u,%02u,"
+           "%02u,%02u,%03u,%02u,%02u,%02u,%03u,%02u", k + 1,
+           sv, 10 + sv, (sv * 37 + i) % 360, 30 + (i + sv) % 20,
+           sv + 1, 20 + sv, (sv * 41 + i) % 360, 30 + (i + sv + 1) % 20,
+           sv + 2, 30 + sv, (sv * 43 + i) % 360, 30 + (i + sv + 2) % 20,
+           sv + 3, 40 + sv, (sv * 47 + i) % 360, 30 + (i + sv + 3) % 20);
+    }
+
+  for (k = 0; k < 2; k++)
+    {
+      sv = 65 + k * 4;
+      emit("GLGSV,2,%u,8,%02u,%02u,%03u,%02u,%02u,%02u,%03u,%02u,"
+           "%02u,%02u,%03u,%02u,%02u,%02u,%03u,%02u", k + 1,
+           sv, 15, (sv * 7 + i) % 360, 25 + i % 15,
+           sv + 1, 25, (sv * 11 + i) % 360, 26 + i % 15,
+           sv + 2, 35, (sv * 13 + i) % 360, 27 + i % 15,
+           sv + 3, 45, (sv * 17 + i) % 360, 28 + i % 15);
+    }
+
+  emit("GPRMC,%02u%02u%02u.00,A,%04u.1234,N,13944.5678,E,0.%02u,%u.0,"
+       "191026,,,A,V", hh, mm, ss, lat, i % 100, i % 360);
+  emit("GPVTG,%u.0,T,,M,0.%02u,N,0.%02u,K,A", i % 360, i % 100, i % 100);
+  emit("GPZDA,%02u%02u%02u.00,19,10,2026,,", hh, mm, ss);
+}
+
+static void run_epochs(bool batched, uint32_t epochs)
+{
+  uint32_t i;
+
+  for (i = 0; i < epochs; i++)
+    {
+      emit_epoch(i);
+      if (batched)
+        {
+          gnss_nmeabuf_flush(&g_nmeabuf);
+        }
+    }
+}
+
+static FAR char *read_file(FAR const char *path, FAR size_t *len)
+{
+  FAR char *buf;
+  FAR FILE *fp;
+  long size;
+
+  fp = fopen(path, "rb");
+  if (fp == NULL)
+    {
+      return NULL;
+    }
+
+  fseek(fp, 0, SEEK_END);
+  size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  buf = malloc(size + 1);
+  if (buf != NULL && fread(buf, 1, size, fp) != (size_t)size)
+    {
+      free(buf);
+      buf = NULL;
+    }
+
+  fclose(fp);
+  *len = size;
+  return buf;
+}
+
+static int write_stream(bool batched, FAR const char *path, uint32_t epochs)
+{
+  int fd;
+
+  fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    {
+      return -errno;
+    }
+
+  set_output(batched, fd);
+  g_writes = 0;
+  run_epochs(batched, epochs);
+  close(fd);
+
+  return (int)g_writes;
+}
+
+static int test_validator(void)
+{
+  static const struct
+  {
+    FAR const char *s;
+    int             expect;
+  }
+  cases[] =
+  {
+    { "$GPGLL,3541.1234,N,13944.5678,E,120000.00,A,A*6A\r\n", NMEA_VALID },
+    { "$GPGLL,3541.1234,N,13944.5678,E,120000.00,A,A*6B\r\n", NMEA_ERR_CHKSUM },
+    { "$GPGLL,3541.1234,N,13944.5678,E,120000.00,A,A*6a\r\n", NMEA_ERR_NOCHKSUM },
+    { "$GPGLL,3541.1234,N,13944.5678,E,120000.00,A,A\r\n",    NMEA_ERR_NOCHKSUM },
+    { "$GPGLL,3541.1234,N,13944.5678,E,120000.00,A,A*6A\n",   NMEA_ERR_EOL },
+    { "GPGLL,3541.1234,N,13944.5678,E,120000.00,A,A*6A\r\n",  NMEA_ERR_START },
+    { "$gpGLL,3541.1234,N,13944.5678,E,120000.00,A,A*6A\r\n", NMEA_ERR_ADDRESS },
+    { "$GPGLL,3541.1234,N,$3944.5678,E,120000.00,A,A*6A\r\n", NMEA_ERR_CHAR },
+  };
+
+  unsigned int i;
+  int errors = 0;
+  int ret;
+
+  for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+      ret = nmea_validate(cases[i].s, strlen(cases[i].s),
+                          NMEA_SENTENCE_MAX_LEN);
+      if (ret != cases[i].expect)
+        {
+          printf("validator case %u: got %d, expected %d\n",
+                 i, ret, cases[i].expect);
+          errors++;
+        }
+    }
+
+  return errors;
+}
+
+static int test_stream(void)
+{
+  struct nmea_validate_stats_s st;
+  char legacypath[64];
+  char ringpath[64];
+  FAR char *legacy;
+  FAR char *ring;
+  size_t legacylen;
+  size_t ringlen;
+  int legacywrites;
+  int ringwrites;
+  int errors = 0;
+
+  snprintf(legacypath, sizeof(legacypath), "/tmp/nmeabuf-%d.a",
+           (int)getpid());
+  snprintf(ringpath, sizeof(ringpath), "/tmp/nmeabuf-%d.b", (int)getpid());
+
+  legacywrites = write_stream(false, legacypath, TEST_EPOCHS);
+  ringwrites   = write_stream(true, ringpath, TEST_EPOCHS);
+
+  legacy = read_file(legacypath, &legacylen);
+  ring   = read_file(ringpath, &ringlen);
+  unlink(legacypath);
+  unlink(ringpath);
+
+  if (legacy == NULL || ring == NULL)
+    {
+      printf("stream: failed to read back the output\n");
+      free(legacy);
+      free(ring);
+      return 1;
+    }
+
+  if (legacylen != ringlen || memcmp(legacy, ring, ringlen) != 0)
+    {
+      printf("stream: batched output differs from per-sentence output\n");
+      errors++;
+    }
+
+  memset(&st, 0, sizeof(st));
+  nmea_validate_stream(ring, ringlen, NMEA_SENTENCE_MAX_LEN, &st);
+  if (st.errors != 0 || st.partial != 0 ||
+      st.sentences != TEST_EPOCHS * SENTENCES_PER_EPOCH)
+    {
+      printf("stream: %u sentences, %u invalid (first %d at %zu), "
+             "%u partial bytes\n", st.sentences, st.errors, st.firsterr,
+             st.firstpos, st.partial);
+      errors++;
+    }
+
+  if (ringwrites != TEST_EPOCHS || g_nmeabuf.drops != 0)
+    {
+      printf("stream: %d writes, %u drops for %d epochs\n",
+             ringwrites, g_nmeabuf.drops, TEST_EPOCHS);
+      errors++;
+    }
+
+  printf("stream: %u sentences, %zu bytes, %d/%d writes "
+         "(per-sentence/batched)\n", st.sentences, ringlen, legacywrites,
+         ringwrites);
+
+  free(legacy);
+  free(ring);
+  return errors;
+}
+
+static size_t drain(int fd, FAR char *buf, size_t size, size_t len)
+{
+  ssize_t n;
+
+  while (len < size && (n = read(fd, &buf[len], size - len)) > 0)
+    {
+      len += n;
+    }
+
+  return len;
+}
+
+static int test_backpressure(void)
+{
+  struct nmea_validate_stats_s st;
+  const size_t size = 4 * 1024 * 1024;
+  FAR char *buf;
+  size_t len = 0;
+  uint32_t i;
+  int fds[2];
+  int errors = 0;
+
+  buf = malloc(size);
+  if (buf == NULL || pipe(fds) < 0)
+    {
+      free(buf);
+      return 1;
+    }
+
+  /* A small pipe that is only drained every 20 epochs, so that the ring
+   * sees partial writes, EAGAIN, wrap-around and drops.
+   */
+
+#ifdef F_SETPIPE_SZ
+  fcntl(fds[1], F_SETPIPE_SZ, 4096);
+#endif
+  fcntl(fds[0], F_SETFL, O_NONBLOCK);
+  fcntl(fds[1], F_SETFL, O_NONBLOCK);
+
+  set_output(true, fds[1]);
+  g_emitted = 0;
+
+  for (i = 0; i < TEST_EPOCHS; i++)
+    {
+      emit_epoch(i);
+      gnss_nmeabuf_flush(&g_nmeabuf);
+
+      if (i % 20 == 19)
+        {
+          len = drain(fds[0], buf, size, len);
+        }
+    }
+
+  while (gnss_nmeabuf_pending(&g_nmeabuf) > 0)
+    {
+      gnss_nmeabuf_flush(&g_nmeabuf);
+      len = drain(fds[0], buf, size, len);
+    }
+
+  len = drain(fds[0], buf, size, len);
+  close(fds[0]);
+  close(fds[1]);
+
+  memset(&st, 0, sizeof(st));
+  nmea_validate_stream(buf, len, NMEA_SENTENCE_MAX_LEN, &st);
+  if (st.errors != 0 || st.partial != 0 ||
+      st.sentences + g_nmeabuf.drops != g_emitted ||
+      g_nmeabuf.drops == 0)
+    {
+      printf("backpressure: %u emitted, %u received, %u dropped, "
+             "%u invalid (first %d), %u partial bytes\n", g_emitted,
+             st.sentences, g_nmeabuf.drops, st.errors, st.firsterr,
+             st.partial);
+      errors++;
+    }
+
+  printf("backpressure: %u emitted, %u received, %u dropped\n",
+         g_emitted, st.sentences, g_nmeabuf.drops);
+
+  free(buf);
+  return errors;
+}
+
+static double cputime(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void bench(uint32_t epochs)
+{
+  double start;
+  double elapsed;
+  int fd;
+  int b;
+
+  fd = open("/dev/null", O_WRONLY);
+  if (fd < 0)
+    {
+      return;
+    }
+
+  for (b = 0; b < 2; b++)
+    {
+      set_output(b, fd);
+      g_writes = 0;
+
+      start = cputime();
+      run_epochs(b, epochs);
+      elapsed = cputime() - start;
+
+      printf("%-12s: %u epochs, %.2f writes/epoch, %.2f us/fix\n",
+             b ? "batched" : "per-sentence", epochs,
+             (double)g_writes / epochs, elapsed * 1e6 / epochs);
+    }
+
+  close(fd);
+}
+
+static void show_usage(FAR const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-t] [-b <epochs>] [-h]\n", progname);
+  fprintf(stderr, "\t-t: Validate the output and the backpressure handling\n");
+  fprintf(stderr, "\t-b <epochs>: Measure writes per epoch and CPU per fix\n");
+  fprintf(stderr, "\t-h: Show this text and exit\n");
+  exit(errcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, FAR char **argv)
+{
+  int errors = 0;
+  int option;
+
+  if (argc < 2)
+    {
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+
+  while ((option = getopt(argc, argv, ":tb:h")) != ERROR)
+    {
+      switch (option)
+        {
+          case 't':
+            errors += test_validator();
+            errors += test_stream();
+            errors += test_backpressure();
+            printf("test: %s\n", errors ? "FAILED" : "OK");
+            break;
+
+          case 'b':
+            bench((uint32_t)strtoul(optarg, NULL, 0));
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -43,6 +43,9 @@
 #include <errno.h>
 #include <sys/ioctl.h>
 #include <arch/chip/gnss.h>
+#ifdef CONFIG_EXAMPLES_PVTLOG_TRACK
+#include "pvtlog_track.h"
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -61,6 +64,7 @@
 #  define PVTLOG_UNITNUM          (CXD56_GNSS_PVTLOG_MAXNUM)
 #endif
 #define TEST_FILE_COUNT         (1 + (int)(TEST_LOOP_TIME / PVTLOG_UNITNUM))
+#define TRACK_FILE_NAME         CONFIG_EXAMPLES_PVTLOG_FILEPATH ".trk"
 
 /****************************************************************************
  * Private Types
@@ -80,6 +84,10 @@ struct cxd56_gnss_dms_s
 
 static struct cxd56_gnss_positiondata_s posdat;
 static struct cxd56_pvtlog_s            pvtlogdat;
+#ifdef CONFIG_EXAMPLES_PVTLOG_TRACK
+static struct pvtlog_track_s            track;
+static struct pvtlog_track_reader_s     trackrd;
+#endif
 
 /****************************************************************************
  * Name: double_to_dmf()
@@ -333,6 +341,41 @@ _err1:
  *
  ****************************************************************************/
 
+#ifdef CONFIG_EXAMPLES_PVTLOG_TRACK
+static int writefile(uint32_t file_count)
+{
+  int      ret = OK;
+  uint32_t i;
+
+  /* Append the notified records to the track file and write the current
+   * block, so that at most one block worth of records is rewritten per
+   * notification.
+   */
+
+  for (i = 0; i < pvtlogdat.log_count && ret == OK; i++)
+    {
+      ret = pvtlog_track_append(&track, &pvtlogdat.log_data[i]);
+    }
+
+  if (ret == OK)
+    {
+      ret = pvtlog_track_flush(&track);
+    }
+
+  if (ret < 0)
+    {
+      printf("%s write error:%d\n", TRACK_FILE_NAME, ret);
+      ret = ERROR;
+    }
+  else
+    {
+      printf("%s write OK(%d line, %d blocks)\n", TRACK_FILE_NAME,
+             track.records, track.nblocks + 1);
+    }
+
+  return ret;
+}
+#else
 static int writefile(uint32_t file_count)
 {
   int fd_write;
@@ -371,6 +414,7 @@ static int writefile(uint32_t file_count)
 
   return ret;
 }
+#endif /* CONFIG_EXAMPLES_PVTLOG_TRACK */
 
 /****************************************************************************
  * Name: gnss_pvtlog_write()
@@ -469,6 +513,15 @@ int gnss_pvtlog_write(int argc, char *argv[])
       printf("start GNSS OK\n");
     }
 
+#ifdef CONFIG_EXAMPLES_PVTLOG_TRACK
+  ret = pvtlog_track_create(&track, TRACK_FILE_NAME);
+  if (ret < 0)
+    {
+      printf("%s create error:%d\n", TRACK_FILE_NAME, ret);
+      goto _err0;
+    }
+#endif
+
   do
     {
       /* Wait signal */
@@ -516,6 +569,10 @@ int gnss_pvtlog_write(int argc, char *argv[])
       writefile(file_count);
     }
 
+#ifdef CONFIG_EXAMPLES_PVTLOG_TRACK
+  pvtlog_track_close(&track);
+#endif
+
 _err0:
   /* Stop GNSS. */
 
@@ -551,6 +608,41 @@ _err3:
   return ret;
 }
 
+/****************************************************************************
+ * Name: print_log()
+ *
+ * Description:
+ *   Print one PVTLOG record.
+ *
+ * Input Parameters:
+ *   log - PVTLOG record.
+ *   no  - Record number to print.
+ *
+ * Returned Value:
+ *   none.
+ *
+ * Assumptions/Limitations:
+ *   none.
+ *
+ ****************************************************************************/
+
+static void print_log(FAR struct cxd56_pvtlog_data_s *log, uint32_t no)
+{
+  printf(" Y=20%2d, M=%2d, d=%2d",
+         log->date.year, log->date.month, log->date.day);
+
+  printf(" h=%2d, m=%2d, s=%2d m=%3d", log->time.hour,
+         log->time.minute, log->time.sec, log->time.msec);
+
+  printf(", Lat %d:%d:%d",log->latitude.degree,
+         log->latitude.minute, log->latitude.frac);
+
+  printf(" , Lon %d:%d:%d", log->longitude.degree,
+         log->longitude.minute, log->longitude.frac);
+
+  printf(", Log No:%d \n", no);
+}
+
 /****************************************************************************
  * Name: gnss_pvtlog_read()
  *
@@ -571,6 +663,48 @@ _err3:
  *
  ****************************************************************************/
 
+#ifdef CONFIG_EXAMPLES_PVTLOG_TRACK
+int gnss_pvtlog_read(int argc, char *argv[])
+{
+  int      ret;
+  uint32_t log_count = 0;
+  struct cxd56_pvtlog_data_s log;
+
+  /* Program start */
+
+  printf("%s() in\n", __func__);
+
+  ret = pvtlog_track_open(&trackrd, TRACK_FILE_NAME);
+  if (ret < 0)
+    {
+      printf("%s open error:%d\n", TRACK_FILE_NAME, ret);
+      goto _err;
+    }
+
+  /* Decode the records one block at a time */
+
+  while ((ret = pvtlog_track_next(&trackrd, &log)) > 0)
+    {
+      print_log(&log, ++log_count);
+    }
+
+  if (ret < 0)
+    {
+      printf("%s read error:%d\n", TRACK_FILE_NAME, ret);
+    }
+  else
+    {
+      printf("%s read OK(%d line)\n", TRACK_FILE_NAME, log_count);
+    }
+
+  pvtlog_track_rclose(&trackrd);
+
+_err:
+  printf("%s() out %d\n", __func__, ret);
+
+  return ret;
+}
+#else
 int gnss_pvtlog_read(int argc, char *argv[])
 {
   int      ret = OK;
@@ -628,19 +762,7 @@ int gnss_pvtlog_read(int argc, char *argv[])
                   /* Printf record */
 
                   log = &pvtlogdat.log_data[log_count];
-                  printf(" Y=20%2d, M=%2d, d=%2d",
-                         log->date.year, log->date.month, log->date.day);
-
-                  printf(" h=%2d, m=%2d, s=%2d m=%3d", log->time.hour,
-                         log->time.minute, log->time.sec, log->time.msec);
-
-                  printf(", Lat %d:%d:%d",log->latitude.degree,
-                         log->latitude.minute, log->latitude.frac);
-
-                  printf(" , Lon %d:%d:%d", log->longitude.degree,
-                         log->longitude.minute, log->longitude.frac);
-
-                  printf(", Log No:%d \n", (log_count + 1));
+                  print_log(log, log_count + 1);
                 }
             }
         }
@@ -655,6 +777,7 @@ int gnss_pvtlog_read(int argc, char *argv[])
 
   return ret;
 }
+#endif /* CONFIG_EXAMPLES_PVTLOG_TRACK */
 
 /****************************************************************************
  * Name: gnss_pvtlog_delete()
@@ -699,6 +822,12 @@ int gnss_pvtlog_delete(int argc, char *argv[])
         }
     }
 
+#ifdef CONFIG_EXAMPLES_PVTLOG_TRACK
+  if (unlink(TRACK_FILE_NAME) == OK)
+    {
+      printf("%s delete ok\n", TRACK_FILE_NAME);
+    }
+#endif
 
   printf("%s() out %d\n", __func__, ret);
 
@@ -0,0 +1,672 @@
+/****************************************************************************
+ * gnss_pvtlog/host/pvtlogbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host test and benchmark for the gnss_pvtlog track format.  Tracks of
+ *   1 Hz PVT log records are generated (walking, driving, stationary) or
+ *   read from the raw files saved by gnss_pvtlog, encoded incrementally the
+ *   way the example does (one flush per notification of 85 records),
+ *   decoded back and compared record by record.
+ *
+ *   -t runs the round trip checks, including records which need the raw
+ *      escape, and the seek corner cases.
+ *   -b <fixes> reports the size against the raw records and against the
+ *      PVTLOG<n>.dat files, the encode time per fix and the latency of
+ *      one minute range queries.
+ *   -r <files> does the same for raw PVTLOG<n>.dat files.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+#include "pvtlog_track.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NOTIFY_UNIT     (CXD56_GNSS_PVTLOG_MAXNUM / 2)
+#define QUERY_COUNT     2000
+#define QUERY_WINDOW    6000     /* One minute in key units */
+#define DATFILE_SIZE    sizeof(struct cxd56_pvtlog_s)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum scenario_e
+{
+  SCENARIO_WALK = 0,
+  SCENARIO_DRIVE,
+  SCENARIO_STATIC,
+  SCENARIO_NUM
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *g_scenario[SCENARIO_NUM] =
+{
+  "walk", "drive", "static"
+};
+
+static char     g_path[64];
+static uint32_t g_seed = 0x2468ace1;
+
+static struct pvtlog_track_s        g_track;
+static struct pvtlog_track_reader_s g_reader;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static double rnd(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return (double)(g_seed >> 8) / (double)(1 << 24);
+}
+
+static double now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void set_dms(double x, FAR uint32_t *sign, FAR uint32_t *degree,
+                    FAR uint32_t *minute, FAR uint32_t *frac)
+{
+  double t;
+
+  *sign = x < 0;
+  x = fabs(x);
+  *degree = (uint32_t)x;
+  t = (x - *degree) * 60;
+  *minute = (uint32_t)t;
+  *frac = (uint32_t)((t - *minute) * 10000);
+}
+
+static void make_record(FAR struct cxd56_pvtlog_data_s *log, uint32_t i,
+                        double lat, double lon, double alt, double knot,
+                        double dir)
+{
+  uint32_t s = 8 * 3600 + i;
+  uint32_t sign;
+  uint32_t deg;
+  uint32_t min;
+  uint32_t frac;
+
+  memset(log, 0, sizeof(struct cxd56_pvtlog_data_s));
+
+  log->date.year   = 26;
+  log->date.month  = 10;
+  log->date.day    = 19 + s / 86400;
+  log->time.hour   = (s / 3600) % 24;
+  log->time.minute = (s / 60) % 60;
+  log->time.sec    = s % 60;
+
+  set_dms(lat, &sign, &deg, &min, &frac);
+  log->latitude.sign   = sign;
+  log->latitude.degree = deg;
+  log->latitude.minute = min;
+  log->latitude.frac   = frac;
+
+  set_dms(lon, &sign, &deg, &min, &frac);
+  log->longitude.sign   = sign;
+  log->longitude.degree = deg;
+  log->longitude.minute = min;
+  log->longitude.frac   = frac;
+
+  log->altitude.sign  = alt < 0;
+  log->altitude.meter = (uint32_t)fabs(alt);
+  log->altitude.frac  = (uint32_t)((fabs(alt) - (uint32_t)fabs(alt)) * 16);
+
+  log->velocity.knot    = (uint32_t)knot;
+  log->direction.degree = (uint32_t)dir;
+  log->direction.frac   = (uint32_t)((dir - (uint32_t)dir) * 16);
+}
+
+static void generate(enum scenario_e sc, FAR struct cxd56_pvtlog_data_s *logs,
+                     uint32_t num)
+{
+  double lat = 35.6812;
+  double lon = 139.7671;
+  double alt = 40.0;
+  double speed;
+  double heading = 90.0;
+  double jlat;
+  double jlon;
+  uint32_t i;
+
+  speed = sc == SCENARIO_WALK ? 1.4 : sc == SCENARIO_DRIVE ? 15.0 : 0.0;
+
+  for (i = 0; i < num; i++)
+    {
+      /* Heading wanders, speed varies a little */
+
+      heading += (rnd() - 0.5) * (sc == SCENARIO_DRIVE ? 6.0 : 20.0);
+      heading  = fmod(heading + 360.0, 360.0);
+      alt     += (rnd() - 0.5) * 0.3 + (40.0 - alt) * 0.01;
+
+      if (sc == SCENARIO_STATIC)
+        {
+          jlat = (rnd() - 0.5) * 0.00002;
+          jlon = (rnd() - 0.5) * 0.00002;
+          make_record(&logs[i], i, lat + jlat, lon + jlon, alt, 0, 0);
+          continue;
+        }
+
+      lat += speed * cos(heading * M_PI / 180.0) / 111320.0;
+      lon += speed * sin(heading * M_PI / 180.0) /
+             (111320.0 * cos(lat * M_PI / 180.0));
+      make_record(&logs[i], i, lat, lon, alt,
+                  (speed + (rnd() - 0.5)) * 1.94384, heading);
+    }
+}
+
+/* Encode like gnss_pvtlog does: append one notification, then flush */
+
+static int encode(FAR const struct cxd56_pvtlog_data_s *logs, uint32_t num,
+                  FAR double *elapsed)
+{
+  double start;
+  uint32_t i;
+  int ret;
+
+  start = now();
+  ret = pvtlog_track_create(&g_track, g_path);
+  for (i = 0; i < num && ret == OK; i++)
+    {
+      ret = pvtlog_track_append(&g_track, &logs[i]);
+      if (ret == OK && (i % NOTIFY_UNIT == NOTIFY_UNIT - 1 || i == num - 1))
+        {
+          ret = pvtlog_track_flush(&g_track);
+        }
+    }
+
+  if (ret == OK)
+    {
+      ret = pvtlog_track_close(&g_track);
+    }
+
+  *elapsed = now() - start;
+  return ret;
+}
+
+static int verify(FAR const struct cxd56_pvtlog_data_s *logs, uint32_t num)
+{
+  struct cxd56_pvtlog_data_s log;
+  uint32_t i = 0;
+  int ret;
+
+  ret = pvtlog_track_open(&g_reader, g_path);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while ((ret = pvtlog_track_next(&g_reader, &log)) > 0)
+    {
+      if (i >= num || memcmp(&log, &logs[i], sizeof(log)) != 0)
+        {
+          printf("  record %u differs\n", i);
+          ret = -EINVAL;
+          break;
+        }
+
+      i++;
+    }
+
+  pvtlog_track_rclose(&g_reader);
+
+  if (ret == 0 && i != num)
+    {
+      printf("  %u of %u records decoded\n", i, num);
+      ret = -EINVAL;
+    }
+
+  return ret;
+}
+
+static uint64_t key_of(FAR const struct cxd56_pvtlog_data_s *log)
+{
+  return pvtlog_track_key(&log->date, &log->time);
+}
+
+static uint32_t lower_bound(FAR const struct cxd56_pvtlog_data_s *logs,
+                            uint32_t num, uint64_t key)
+{
+  uint32_t lo = 0;
+  uint32_t hi = num;
+  uint32_t mid;
+
+  while (lo < hi)
+    {
+      mid = lo + (hi - lo) / 2;
+      if (key_of(&logs[mid]) < key)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  return lo;
+}
+
+/* Query [start, start + QUERY_WINDOW] QUERY_COUNT times and compare the
+ * results with a search in the original records.
+ */
+
+static int range_queries(FAR const struct cxd56_pvtlog_data_s *logs,
+                         uint32_t num, FAR double *usec)
+{
+  struct cxd56_pvtlog_data_s log;
+  uint64_t start;
+  uint64_t end;
+  uint32_t first;
+  uint32_t count;
+  double elapsed = 0;
+  double t;
+  int errors = 0;
+  int ret;
+  int q;
+
+  ret = pvtlog_track_open(&g_reader, g_path);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (q = 0; q < QUERY_COUNT; q++)
+    {
+      start = key_of(&logs[(uint32_t)(rnd() * num)]) + 37;
+      end   = start + QUERY_WINDOW;
+      count = 0;
+
+      t = now();
+      ret = pvtlog_track_seek(&g_reader, start);
+      while (ret == OK && pvtlog_track_next(&g_reader, &log) > 0 &&
+             key_of(&log) <= end)
+        {
+          count++;
+        }
+
+      elapsed += now() - t;
+
+      first = lower_bound(logs, num, start);
+      if (ret < 0 || lower_bound(logs, num, end + 1) - first != count)
+        {
+          errors++;
+        }
+    }
+
+  pvtlog_track_rclose(&g_reader);
+  *usec = elapsed * 1e6 / QUERY_COUNT;
+  return errors ? -EINVAL : OK;
+}
+
+static int report(FAR const char *name,
+                  FAR const struct cxd56_pvtlog_data_s *logs, uint32_t num)
+{
+  double elapsed;
+  double query = 0;
+  double rawsize = (double)num * sizeof(struct cxd56_pvtlog_data_s);
+  double datsize = (double)((num + NOTIFY_UNIT - 1) / NOTIFY_UNIT) *
+                   DATFILE_SIZE;
+  off_t size;
+  int fd;
+  int ret;
+
+  ret = encode(logs, num, &elapsed);
+  if (ret == OK)
+    {
+      ret = verify(logs, num);
+    }
+
+  if (ret == OK)
+    {
+      ret = range_queries(logs, num, &query);
+    }
+
+  if (ret < 0)
+    {
+      printf("%-8s: FAILED %d\n", name, ret);
+      return ret;
+    }
+
+  fd = open(g_path, O_RDONLY);
+  size = lseek(fd, 0, SEEK_END);
+  close(fd);
+
+  printf("%-8s: %u fixes, %ld bytes, %.2f B/fix, ratio %.1fx raw / "
+         "%.1fx .dat, %u raw escapes, encode %.2f us/fix, "
+         "1 min query %.1f us\n", name, num, (long)size, (double)size / num,
+         rawsize / size, datsize / size, g_track.rawrecords,
+         elapsed * 1e6 / num, query);
+  return OK;
+}
+
+static int test(void)
+{
+  FAR struct cxd56_pvtlog_data_s *logs;
+  struct cxd56_pvtlog_data_s log;
+  const uint32_t num = 10000;
+  int errors = 0;
+  int ret;
+  int sc;
+  uint32_t i;
+
+  logs = malloc(num * sizeof(struct cxd56_pvtlog_data_s));
+  if (logs == NULL)
+    {
+      return 1;
+    }
+
+  for (sc = 0; sc < SCENARIO_NUM; sc++)
+    {
+      double elapsed;
+
+      generate(sc, logs, num);
+      ret = encode(logs, num, &elapsed);
+      if (ret == OK)
+        {
+          ret = verify(logs, num);
+        }
+
+      printf("roundtrip %-6s: %s\n", g_scenario[sc], ret == OK ? "OK" :
+             "FAILED");
+      errors += ret != OK;
+    }
+
+  /* Records that need the raw escape: reserved bits, fields out of the
+   * range of the conversion, invalid dates.
+   */
+
+  generate(SCENARIO_DRIVE, logs, num);
+  for (i = 0; i < num; i += 97)
+    {
+      switch ((i / 97) % 5)
+        {
+          case 0:
+            logs[i].latitude.rsv = 5;
+            break;
+
+          case 1:
+            logs[i].longitude.frac = 12345;
+            break;
+
+          case 2:
+            logs[i].time.sec = 63;
+            break;
+
+          case 3:
+            memset(&logs[i].date, 0, sizeof(logs[i].date));
+            break;
+
+          default:
+            logs[i].altitude.sign = 1;
+            logs[i].altitude.meter = 0;
+            logs[i].altitude.frac = 0;
+            break;
+        }
+    }
+
+  ret = pvtlog_track_create(&g_track, g_path);
+  for (i = 0; i < num && ret == OK; i++)
+    {
+      ret = pvtlog_track_append(&g_track, &logs[i]);
+    }
+
+  if (ret == OK)
+    {
+      ret = pvtlog_track_close(&g_track);
+    }
+
+  if (ret == OK)
+    {
+      ret = verify(logs, num);
+    }
+
+  printf("roundtrip escape: %s (%u raw records)\n",
+         ret == OK && g_track.rawrecords > 0 ? "OK" : "FAILED",
+         g_track.rawrecords);
+  errors += ret != OK || g_track.rawrecords == 0;
+
+  /* Seek corner cases on a clean track */
+
+  generate(SCENARIO_WALK, logs, num);
+  {
+    double elapsed;
+
+    ret = encode(logs, num, &elapsed);
+  }
+
+  if (ret == OK)
+    {
+      ret = pvtlog_track_open(&g_reader, g_path);
+    }
+
+  if (ret == OK)
+    {
+      bool ok;
+
+      ok  = pvtlog_track_seek(&g_reader, 0) == OK &&
+            pvtlog_track_next(&g_reader, &log) == 1 &&
+            memcmp(&log, &logs[0], sizeof(log)) == 0;
+      ok &= pvtlog_track_seek(&g_reader, key_of(&logs[num - 1])) == OK &&
+            pvtlog_track_next(&g_reader, &log) == 1 &&
+            memcmp(&log, &logs[num - 1], sizeof(log)) == 0 &&
+            pvtlog_track_next(&g_reader, &log) == 0;
+      ok &= pvtlog_track_seek(&g_reader, key_of(&logs[num - 1]) + 1) == OK &&
+            pvtlog_track_next(&g_reader, &log) == 0;
+      ok &= pvtlog_track_seek(&g_reader, key_of(&logs[5000])) == OK &&
+            pvtlog_track_next(&g_reader, &log) == 1 &&
+            memcmp(&log, &logs[5000], sizeof(log)) == 0;
+
+      pvtlog_track_rclose(&g_reader);
+      ret = ok ? OK : -EINVAL;
+    }
+
+  /* An empty track */
+
+  if (ret == OK)
+    {
+      ret = pvtlog_track_create(&g_track, g_path);
+      if (ret == OK)
+        {
+          pvtlog_track_close(&g_track);
+          ret = pvtlog_track_open(&g_reader, g_path);
+        }
+
+      if (ret == OK)
+        {
+          ret = pvtlog_track_next(&g_reader, &log) == 0 ? OK : -EINVAL;
+          pvtlog_track_rclose(&g_reader);
+        }
+    }
+
+  printf("seek: %s\n", ret == OK ? "OK" : "FAILED");
+  errors += ret != OK;
+
+  free(logs);
+  return errors;
+}
+
+static int bench(uint32_t num)
+{
+  FAR struct cxd56_pvtlog_data_s *logs;
+  int errors = 0;
+  int sc;
+
+  logs = malloc(num * sizeof(struct cxd56_pvtlog_data_s));
+  if (logs == NULL)
+    {
+      return 1;
+    }
+
+  for (sc = 0; sc < SCENARIO_NUM; sc++)
+    {
+      generate(sc, logs, num);
+      errors += report(g_scenario[sc], logs, num) != OK;
+    }
+
+  free(logs);
+  return errors;
+}
+
+static int replay(int argc, FAR char **argv)
+{
+  FAR struct cxd56_pvtlog_data_s *logs;
+  FAR struct cxd56_pvtlog_s *dat;
+  uint32_t num = 0;
+  int errors;
+  int fd;
+  int i;
+
+  logs = malloc((size_t)argc * CXD56_GNSS_PVTLOG_MAXNUM *
+                sizeof(struct cxd56_pvtlog_data_s));
+  dat  = malloc(sizeof(struct cxd56_pvtlog_s));
+  if (logs == NULL || dat == NULL)
+    {
+      free(logs);
+      free(dat);
+      return 1;
+    }
+
+  for (i = 0; i < argc; i++)
+    {
+      fd = open(argv[i], O_RDONLY);
+      if (fd < 0 || read(fd, dat, DATFILE_SIZE) != DATFILE_SIZE ||
+          dat->log_count > CXD56_GNSS_PVTLOG_MAXNUM)
+        {
+          fprintf(stderr, "ERROR: %s is not a PVTLOG file\n", argv[i]);
+          if (fd >= 0)
+            {
+              close(fd);
+            }
+
+          continue;
+        }
+
+      close(fd);
+      memcpy(&logs[num], dat->log_data,
+             dat->log_count * sizeof(struct cxd56_pvtlog_data_s));
+      num += dat->log_count;
+    }
+
+  errors = num > 0 ? report("replay", logs, num) != OK : 1;
+
+  free(logs);
+  free(dat);
+  return errors;
+}
+
+static void show_usage(FAR const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-t] [-b <fixes>] [-r <file> ...] [-h]\n",
+                  progname);
+  fprintf(stderr, "\t-t: Round trip and seek tests\n");
+  fprintf(stderr, "\t-b <fixes>: Benchmark generated tracks\n");
+  fprintf(stderr, "\t-r <file> ...: Benchmark PVTLOG<n>.dat files\n");
+  fprintf(stderr, "\t-h: Show this text and exit\n");
+  exit(errcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, FAR char **argv)
+{
+  int errors = 0;
+  int option;
+
+  if (argc < 2)
+    {
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+
+  snprintf(g_path, sizeof(g_path), "/tmp/pvtlogbench-%d.trk", (int)getpid());
+
+  while ((option = getopt(argc, argv, ":tb:rh")) != ERROR)
+    {
+      switch (option)
+        {
+          case 't':
+            errors += test();
+            printf("test: %s\n", errors ? "FAILED" : "OK");
+            break;
+
+          case 'b':
+            errors += bench((uint32_t)strtoul(optarg, NULL, 0));
+            break;
+
+          case 'r':
+            errors += replay(argc - optind, &argv[optind]);
+            optind = argc;
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  unlink(g_path);
+  return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,680 @@
+/****************************************************************************
+ * gnss_pvtlog/pvtlog_track.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include "pvtlog_track.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef O_BINARY
+#  define O_BINARY 0
+#endif
+
+#define TRACK_VERSION      1
+
+#define TRACK_F_DKEY       0x01
+#define TRACK_F_LAT        0x02
+#define TRACK_F_LON        0x04
+#define TRACK_F_ALT        0x08
+#define TRACK_F_VEL        0x10
+#define TRACK_F_DIR        0x20
+#define TRACK_F_RAW        0x80
+
+/* Mask byte, six varints of at most 10 bytes, or the raw record */
+
+#define TRACK_RECORD_MAX   (1 + 6 * 10)
+
+#define TRACK_RAWSIZE      sizeof(struct cxd56_pvtlog_data_s)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A log record as integers */
+
+struct track_fields_s
+{
+  uint64_t key;
+  int32_t  lat;
+  int32_t  lon;
+  int32_t  alt;
+  int32_t  vel;
+  int32_t  dir;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void put16(FAR uint8_t *p, uint16_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t get16(FAR const uint8_t *p)
+{
+  return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static void put64(FAR uint8_t *p, uint64_t v)
+{
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      p[i] = (uint8_t)(v >> (i * 8));
+    }
+}
+
+static uint64_t get64(FAR const uint8_t *p)
+{
+  uint64_t v = 0;
+  int i;
+
+  for (i = 7; i >= 0; i--)
+    {
+      v = v << 8 | p[i];
+    }
+
+  return v;
+}
+
+static int putvarint(FAR uint8_t *p, int64_t sv)
+{
+  uint64_t v = ((uint64_t)sv << 1) ^ (uint64_t)(sv >> 63);
+  int n = 0;
+
+  while (v >= 0x80)
+    {
+      p[n++] = (uint8_t)(v | 0x80);
+      v >>= 7;
+    }
+
+  p[n++] = (uint8_t)v;
+  return n;
+}
+
+static int getvarint(FAR const uint8_t *p, FAR const uint8_t *end,
+                     FAR int64_t *sv)
+{
+  uint64_t v = 0;
+  int shift = 0;
+  int n = 0;
+
+  do
+    {
+      if (p + n >= end || shift > 63)
+        {
+          return -EINVAL;
+        }
+
+      v |= (uint64_t)(p[n] & 0x7f) << shift;
+      shift += 7;
+    }
+  while (p[n++] & 0x80);
+
+  *sv = (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+  return n;
+}
+
+static int32_t dms_value(uint32_t sign, uint32_t degree, uint32_t minute,
+                         uint32_t frac)
+{
+  int32_t v = ((int32_t)degree * 60 + (int32_t)minute) * 10000 +
+              (int32_t)frac;
+
+  return sign ? -v : v;
+}
+
+static void to_fields(FAR const struct cxd56_pvtlog_data_s *log,
+                      FAR struct track_fields_s *f)
+{
+  f->key = pvtlog_track_key(&log->date, &log->time);
+  f->lat = dms_value(log->latitude.sign, log->latitude.degree,
+                     log->latitude.minute, log->latitude.frac);
+  f->lon = dms_value(log->longitude.sign, log->longitude.degree,
+                     log->longitude.minute, log->longitude.frac);
+  f->alt = (int32_t)(log->altitude.meter * 16 + log->altitude.frac);
+  f->alt = log->altitude.sign ? -f->alt : f->alt;
+  f->vel = log->velocity.knot;
+  f->dir = (int32_t)(log->direction.degree * 16 + log->direction.frac);
+}
+
+static void from_fields(FAR const struct track_fields_s *f,
+                        FAR struct cxd56_pvtlog_data_s *log)
+{
+  uint64_t k = f->key;
+  uint32_t a;
+
+  memset(log, 0, sizeof(struct cxd56_pvtlog_data_s));
+
+  log->time.msec   = k % 100;
+  k /= 100;
+  log->time.sec    = k % 60;
+  k /= 60;
+  log->time.minute = k % 60;
+  k /= 60;
+  log->time.hour   = k % 24;
+  k /= 24;
+  log->date.day    = k % 32;
+  k /= 32;
+  log->date.month  = k % 13;
+  log->date.year   = k / 13;
+
+  a = f->lat < 0 ? -f->lat : f->lat;
+  log->latitude.sign   = f->lat < 0;
+  log->latitude.frac   = a % 10000;
+  log->latitude.minute = (a / 10000) % 60;
+  log->latitude.degree = a / 600000;
+
+  a = f->lon < 0 ? -f->lon : f->lon;
+  log->longitude.sign   = f->lon < 0;
+  log->longitude.frac   = a % 10000;
+  log->longitude.minute = (a / 10000) % 60;
+  log->longitude.degree = a / 600000;
+
+  a = f->alt < 0 ? -f->alt : f->alt;
+  log->altitude.sign  = f->alt < 0;
+  log->altitude.frac  = a & 15;
+  log->altitude.meter = a >> 4;
+
+  log->velocity.knot      = f->vel;
+  log->direction.frac     = f->dir & 15;
+  log->direction.degree   = f->dir >> 4;
+}
+
+/* Advance the delta state to 'f'.  The time delta is carried to predict
+ * the next one, except after the first record of a block whose "delta"
+ * is the absolute key.
+ */
+
+static void update_state(FAR struct pvtlog_track_state_s *s,
+                         FAR const struct track_fields_s *f, bool first)
+{
+  s->dkey = first ? 0 : (int64_t)(f->key - s->key);
+  s->key  = f->key;
+  s->lat  = f->lat;
+  s->lon  = f->lon;
+  s->alt  = f->alt;
+  s->vel  = f->vel;
+  s->dir  = f->dir;
+}
+
+static int encode_record(FAR struct pvtlog_track_state_s *s, bool first,
+                         FAR const struct cxd56_pvtlog_data_s *log,
+                         FAR uint8_t *p, FAR uint64_t *key)
+{
+  struct cxd56_pvtlog_data_s check;
+  struct track_fields_s f;
+  int64_t d[6];
+  int n = 1;
+  int i;
+
+  to_fields(log, &f);
+  *key = f.key;
+
+  /* Records which do not convert back exactly are stored as they are */
+
+  from_fields(&f, &check);
+  if (memcmp(&check, log, sizeof(check)) != 0)
+    {
+      p[0] = TRACK_F_RAW;
+      memcpy(&p[1], log, TRACK_RAWSIZE);
+      update_state(s, &f, first);
+      return 1 + TRACK_RAWSIZE;
+    }
+
+  d[0] = (int64_t)(f.key - s->key) - s->dkey;
+  d[1] = (int64_t)f.lat - s->lat;
+  d[2] = (int64_t)f.lon - s->lon;
+  d[3] = (int64_t)f.alt - s->alt;
+  d[4] = (int64_t)f.vel - s->vel;
+  d[5] = (int64_t)f.dir - s->dir;
+
+  p[0] = 0;
+  for (i = 0; i < 6; i++)
+    {
+      if (d[i] != 0)
+        {
+          p[0] |= 1 << i;
+          n += putvarint(&p[n], d[i]);
+        }
+    }
+
+  update_state(s, &f, first);
+  return n;
+}
+
+static int decode_record(FAR struct pvtlog_track_reader_s *rd,
+                         FAR struct cxd56_pvtlog_data_s *log,
+                         FAR uint64_t *key)
+{
+  FAR struct pvtlog_track_state_s *s = &rd->state;
+  FAR const uint8_t *p   = &rd->block[rd->pos];
+  FAR const uint8_t *end = &rd->block[rd->used];
+  bool first = rd->pos == PVTLOG_TRACK_BLKHDRSIZE;
+  struct track_fields_s f;
+  int64_t d[6];
+  uint8_t mask;
+  int n = 1;
+  int ret;
+  int i;
+
+  if (p >= end)
+    {
+      return -EINVAL;
+    }
+
+  mask = p[0];
+  if (mask & TRACK_F_RAW)
+    {
+      if (end - p < 1 + (int)TRACK_RAWSIZE)
+        {
+          return -EINVAL;
+        }
+
+      memcpy(log, &p[1], TRACK_RAWSIZE);
+      to_fields(log, &f);
+      n += TRACK_RAWSIZE;
+    }
+  else
+    {
+      for (i = 0; i < 6; i++)
+        {
+          d[i] = 0;
+          if (mask & (1 << i))
+            {
+              ret = getvarint(&p[n], end, &d[i]);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              n += ret;
+            }
+        }
+
+      f.key = s->key + (uint64_t)(s->dkey + d[0]);
+      f.lat = (int32_t)(s->lat + d[1]);
+      f.lon = (int32_t)(s->lon + d[2]);
+      f.alt = (int32_t)(s->alt + d[3]);
+      f.vel = (int32_t)(s->vel + d[4]);
+      f.dir = (int32_t)(s->dir + d[5]);
+      from_fields(&f, log);
+    }
+
+  update_state(s, &f, first);
+  rd->pos += n;
+  rd->remain--;
+  *key = f.key;
+  return OK;
+}
+
+static int write_block(FAR struct pvtlog_track_s *trk)
+{
+  off_t offset;
+
+  trk->block[0] = 'T';
+  trk->block[1] = 'B';
+  put16(&trk->block[2], trk->count);
+  put16(&trk->block[4], trk->used);
+  put16(&trk->block[6], 0);
+  put64(&trk->block[8], trk->firstkey);
+  put64(&trk->block[16], trk->state.key);
+
+  offset = PVTLOG_TRACK_HDRSIZE +
+           (off_t)trk->nblocks * PVTLOG_TRACK_BLOCKSIZE;
+  if (lseek(trk->fd, offset, SEEK_SET) != offset)
+    {
+      return -errno;
+    }
+
+  if (write(trk->fd, trk->block, PVTLOG_TRACK_BLOCKSIZE) !=
+      PVTLOG_TRACK_BLOCKSIZE)
+    {
+      return -EIO;
+    }
+
+  return OK;
+}
+
+static void reset_block(FAR struct pvtlog_track_s *trk)
+{
+  memset(trk->block, 0, sizeof(trk->block));
+  memset(&trk->state, 0, sizeof(trk->state));
+  trk->used  = PVTLOG_TRACK_BLKHDRSIZE;
+  trk->count = 0;
+}
+
+static int read_at(int fd, off_t offset, FAR void *buf, size_t len)
+{
+  if (lseek(fd, offset, SEEK_SET) != offset)
+    {
+      return -errno;
+    }
+
+  if (read(fd, buf, len) != (ssize_t)len)
+    {
+      return -EIO;
+    }
+
+  return OK;
+}
+
+static off_t block_offset(FAR struct pvtlog_track_reader_s *rd,
+                          uint32_t index)
+{
+  return PVTLOG_TRACK_HDRSIZE + (off_t)index * rd->blocksize;
+}
+
+static int load_block(FAR struct pvtlog_track_reader_s *rd, uint32_t index)
+{
+  int ret;
+
+  ret = read_at(rd->fd, block_offset(rd, index), rd->block, rd->blocksize);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (rd->block[0] != 'T' || rd->block[1] != 'B' ||
+      get16(&rd->block[4]) < PVTLOG_TRACK_BLKHDRSIZE ||
+      get16(&rd->block[4]) > rd->blocksize)
+    {
+      return -EINVAL;
+    }
+
+  memset(&rd->state, 0, sizeof(rd->state));
+  rd->curblock = index;
+  rd->remain   = get16(&rd->block[2]);
+  rd->used     = get16(&rd->block[4]);
+  rd->pos      = PVTLOG_TRACK_BLKHDRSIZE;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+uint64_t pvtlog_track_key(FAR const struct cxd56_pvtlog_date_s *date,
+                          FAR const struct cxd56_pvtlog_time_s *time)
+{
+  uint64_t k;
+
+  k = (uint64_t)date->year * 13 + date->month;
+  k = k * 32 + date->day;
+  k = k * 24 + time->hour;
+  k = k * 60 + time->minute;
+  k = k * 60 + time->sec;
+  return k * 100 + time->msec;
+}
+
+int pvtlog_track_create(FAR struct pvtlog_track_s *trk, FAR const char *path)
+{
+  uint8_t hdr[PVTLOG_TRACK_HDRSIZE];
+
+  memset(trk, 0, sizeof(struct pvtlog_track_s));
+
+  trk->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0666);
+  if (trk->fd < 0)
+    {
+      return -errno;
+    }
+
+  memset(hdr, 0, sizeof(hdr));
+  memcpy(hdr, "PVTK", 4);
+  hdr[4] = TRACK_VERSION;
+  put16(&hdr[6], PVTLOG_TRACK_BLOCKSIZE);
+
+  if (write(trk->fd, hdr, sizeof(hdr)) != sizeof(hdr))
+    {
+      close(trk->fd);
+      return -EIO;
+    }
+
+  reset_block(trk);
+  return OK;
+}
+
+int pvtlog_track_append(FAR struct pvtlog_track_s *trk,
+                        FAR const struct cxd56_pvtlog_data_s *log)
+{
+  uint8_t record[TRACK_RECORD_MAX];
+  struct pvtlog_track_state_s saved;
+  uint64_t key;
+  int ret;
+  int n;
+
+  saved = trk->state;
+  n = encode_record(&trk->state, trk->count == 0, log, record, &key);
+
+  if (trk->used + n > PVTLOG_TRACK_BLOCKSIZE)
+    {
+      /* Close this block and restart the delta coding in the next one */
+
+      trk->state = saved;
+      ret = write_block(trk);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      trk->nblocks++;
+      reset_block(trk);
+      n = encode_record(&trk->state, true, log, record, &key);
+    }
+
+  if (trk->count == 0)
+    {
+      trk->firstkey = key;
+    }
+
+  memcpy(&trk->block[trk->used], record, n);
+  trk->used += n;
+  trk->count++;
+  trk->records++;
+  if (record[0] & TRACK_F_RAW)
+    {
+      trk->rawrecords++;
+    }
+
+  return OK;
+}
+
+int pvtlog_track_flush(FAR struct pvtlog_track_s *trk)
+{
+  return trk->count > 0 ? write_block(trk) : OK;
+}
+
+int pvtlog_track_close(FAR struct pvtlog_track_s *trk)
+{
+  int ret;
+
+  ret = pvtlog_track_flush(trk);
+  close(trk->fd);
+  trk->fd = -1;
+  return ret;
+}
+
+int pvtlog_track_open(FAR struct pvtlog_track_reader_s *rd,
+                      FAR const char *path)
+{
+  uint8_t hdr[PVTLOG_TRACK_HDRSIZE];
+  off_t size;
+  int ret;
+
+  memset(rd, 0, sizeof(struct pvtlog_track_reader_s));
+
+  rd->fd = open(path, O_RDONLY | O_BINARY);
+  if (rd->fd < 0)
+    {
+      return -errno;
+    }
+
+  ret  = read_at(rd->fd, 0, hdr, sizeof(hdr));
+  size = lseek(rd->fd, 0, SEEK_END);
+
+  rd->blocksize = get16(&hdr[6]);
+  if (ret < 0 || memcmp(hdr, "PVTK", 4) != 0 || hdr[4] != TRACK_VERSION ||
+      rd->blocksize <= PVTLOG_TRACK_BLKHDRSIZE ||
+      rd->blocksize > PVTLOG_TRACK_BLOCKSIZE || size < PVTLOG_TRACK_HDRSIZE)
+    {
+      close(rd->fd);
+      return ret < 0 ? ret : -EINVAL;
+    }
+
+  rd->nblocks = (size - PVTLOG_TRACK_HDRSIZE) / rd->blocksize;
+
+  /* Nothing is loaded yet, pvtlog_track_next() starts with block 0 */
+
+  rd->curblock = (uint32_t)-1;
+  return OK;
+}
+
+int pvtlog_track_seek(FAR struct pvtlog_track_reader_s *rd, uint64_t key)
+{
+  struct pvtlog_track_state_s state;
+  struct cxd56_pvtlog_data_s log;
+  uint8_t blkhdr[PVTLOG_TRACK_BLKHDRSIZE];
+  uint64_t reckey;
+  uint32_t lo = 0;
+  uint32_t hi = rd->nblocks;
+  uint32_t mid;
+  uint16_t remain;
+  uint16_t pos;
+  int ret;
+
+  /* Find the first block whose last key is not less than 'key' */
+
+  while (lo < hi)
+    {
+      mid = lo + (hi - lo) / 2;
+      ret = read_at(rd->fd, block_offset(rd, mid), blkhdr, sizeof(blkhdr));
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (get64(&blkhdr[16]) < key)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  if (lo >= rd->nblocks)
+    {
+      rd->curblock = rd->nblocks;
+      rd->remain   = 0;
+      return OK;
+    }
+
+  ret = load_block(rd, lo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Skip the records before 'key' inside the block */
+
+  while (rd->remain > 0)
+    {
+      pos    = rd->pos;
+      remain = rd->remain;
+      state  = rd->state;
+
+      ret = decode_record(rd, &log, &reckey);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (reckey >= key)
+        {
+          rd->pos    = pos;
+          rd->remain = remain;
+          rd->state  = state;
+          break;
+        }
+    }
+
+  return OK;
+}
+
+int pvtlog_track_next(FAR struct pvtlog_track_reader_s *rd,
+                      FAR struct cxd56_pvtlog_data_s *log)
+{
+  uint64_t key;
+  int ret;
+
+  while (rd->remain == 0)
+    {
+      if (rd->curblock + 1 >= rd->nblocks)
+        {
+          return 0;
+        }
+
+      ret = load_block(rd, rd->curblock + 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ret = decode_record(rd, log, &key);
+  return ret < 0 ? ret : 1;
+}
+
+void pvtlog_track_rclose(FAR struct pvtlog_track_reader_s *rd)
+{
+  close(rd->fd);
+  rd->fd = -1;
+}
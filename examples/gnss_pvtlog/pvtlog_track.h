@@ -0,0 +1,173 @@
+/****************************************************************************
+ * gnss_pvtlog/pvtlog_track.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __EXAMPLES_GNSS_PVTLOG_PVTLOG_TRACK_H
+#define __EXAMPLES_GNSS_PVTLOG_PVTLOG_TRACK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <stdint.h>
+#include <arch/chip/gnss.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_PVTLOG_TRACK_BLOCKSIZE
+#  define CONFIG_EXAMPLES_PVTLOG_TRACK_BLOCKSIZE 512
+#endif
+
+#define PVTLOG_TRACK_BLOCKSIZE   CONFIG_EXAMPLES_PVTLOG_TRACK_BLOCKSIZE
+
+/* Track file layout
+ *
+ *   file header (16 bytes)
+ *     "PVTK", version, reserved, block size (LE16), reserved (8 bytes)
+ *   block 0, block 1, ...      each exactly PVTLOG_TRACK_BLOCKSIZE bytes
+ *
+ *   block header (24 bytes)
+ *     'T', 'B', record count (LE16), used bytes (LE16), reserved (LE16),
+ *     first key (LE64), last key (LE64)
+ *   records                    'used' bytes including the header
+ *
+ * Every block starts from a zero state, so a block decodes on its own and
+ * a range query reads only the block headers visited by a binary search
+ * over the time keys plus the blocks that hold the result.
+ *
+ * A record is a field mask followed by the zigzag varints of the fields
+ * that changed:
+ *
+ *   bit 0  time key delta-of-delta (10 ms units)
+ *   bit 1  latitude delta          (1/10000 minute)
+ *   bit 2  longitude delta         (1/10000 minute)
+ *   bit 3  altitude delta          (1/16 m)
+ *   bit 4  velocity delta          (knot)
+ *   bit 5  direction delta         (1/16 degree)
+ *   bit 7  raw: the struct cxd56_pvtlog_data_s follows verbatim, used for
+ *          records that do not survive the conversion (out of range or
+ *          reserved bits set), so that decoding is always exact.
+ */
+
+#define PVTLOG_TRACK_HDRSIZE     16
+#define PVTLOG_TRACK_BLKHDRSIZE  24
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Delta coding state, reset at the start of each block */
+
+struct pvtlog_track_state_s
+{
+  uint64_t key;
+  int64_t  dkey;
+  int32_t  lat;
+  int32_t  lon;
+  int32_t  alt;
+  int32_t  vel;
+  int32_t  dir;
+};
+
+/* Incremental encoder.  Records are gathered in 'block' which is written
+ * in place each time it is flushed or full, so a power loss costs at most
+ * the records appended since the last flush.
+ */
+
+struct pvtlog_track_s
+{
+  int                         fd;
+  uint32_t                    nblocks;   /* Completed blocks */
+  uint16_t                    used;      /* Bytes used in 'block' */
+  uint16_t                    count;     /* Records in 'block' */
+  uint64_t                    firstkey;
+  struct pvtlog_track_state_s state;
+  uint32_t                    records;   /* Statistics */
+  uint32_t                    rawrecords;
+  uint8_t                     block[PVTLOG_TRACK_BLOCKSIZE];
+};
+
+/* Streaming decoder, holds one block */
+
+struct pvtlog_track_reader_s
+{
+  int                         fd;
+  uint16_t                    blocksize;
+  uint32_t                    nblocks;
+  uint32_t                    curblock;  /* Block in 'block' */
+  uint16_t                    pos;       /* Decode offset in 'block' */
+  uint16_t                    used;
+  uint16_t                    remain;    /* Records left in 'block' */
+  struct pvtlog_track_state_s state;
+  uint8_t                     block[PVTLOG_TRACK_BLOCKSIZE];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Time key of a log record: the UTC date and time in 10 ms units, in a
+ * form that increases with time and can be compared directly.
+ */
+
+uint64_t pvtlog_track_key(FAR const struct cxd56_pvtlog_date_s *date,
+                          FAR const struct cxd56_pvtlog_time_s *time);
+
+/* Encoder: create (truncate) a track file, append records, write the
+ * current block, and finish.  Return OK or a negated errno value.
+ */
+
+int pvtlog_track_create(FAR struct pvtlog_track_s *trk, FAR const char *path);
+int pvtlog_track_append(FAR struct pvtlog_track_s *trk,
+                        FAR const struct cxd56_pvtlog_data_s *log);
+int pvtlog_track_flush(FAR struct pvtlog_track_s *trk);
+int pvtlog_track_close(FAR struct pvtlog_track_s *trk);
+
+/* Decoder: open a track file, position at the first record whose key is
+ * not less than 'key', and read records in order.  pvtlog_track_next()
+ * returns 1 when a record was stored in 'log', 0 at the end of the track
+ * or a negated errno value.
+ */
+
+int pvtlog_track_open(FAR struct pvtlog_track_reader_s *rd,
+                      FAR const char *path);
+int pvtlog_track_seek(FAR struct pvtlog_track_reader_s *rd, uint64_t key);
+int pvtlog_track_next(FAR struct pvtlog_track_reader_s *rd,
+                      FAR struct cxd56_pvtlog_data_s *log);
+void pvtlog_track_rclose(FAR struct pvtlog_track_reader_s *rd);
+
+#endif /* __EXAMPLES_GNSS_PVTLOG_PVTLOG_TRACK_H */
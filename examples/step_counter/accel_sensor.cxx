@@ -45,6 +45,7 @@
 #include <fcntl.h>
 #include <nuttx/sensors/bmi160.h>
 
+#include "sensing/sensor_preproc.h"
 #include "accel_sensor.h"
 
 /****************************************************************************
@@ -313,12 +314,10 @@ void AccelSensorClass::convert_data(FAR accel_t *p_src,
                                     FAR accel_float_t *p_dst,
                                     int sample_num)
 {
-  for (int i = 0; i < sample_num; i++, p_src++, p_dst++)
-    {
-      p_dst->x = (float)p_src->x * 2 / 32768;
-      p_dst->y = (float)p_src->y * 2 / 32768;
-      p_dst->z = (float)p_src->z * 2 / 32768;
-    }
+  /* Same block conversion as the tap library, [G] in the 2G range. */
+
+  sensor_preproc_convert(&p_src->x, &p_dst->x, sample_num,
+                         2.0f / 32768.0f);
 }
 
 /*--------------------------------------------------------------------------*/
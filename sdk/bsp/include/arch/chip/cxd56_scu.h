@@ -209,6 +209,37 @@
 
 #define SCUIOC_DELFIFODATA _SCUIOC(0x0013)
 
+/**
+ * Start or stop streaming FIFO data into a ring of blocks
+ *
+ * Each time the FIFO reaches one block of samples, the driver transfers it
+ * by DMA into the next free block of the ring and stamps the block with
+ * the time of its first sample. read() is not available while streaming.
+ *
+ * @param Pointer of struct scufifo_stream_s, NULL to stop streaming
+ * @return ioctl return value provides success/failure indication
+ */
+
+#define SCUIOC_SETSTREAM   _SCUIOC(0x0014)
+
+/**
+ * Wait for completed stream blocks
+ *
+ * @param Pointer of struct scufifo_streamstat_s
+ * @return ioctl return value provides success/failure indication
+ */
+
+#define SCUIOC_WAITSTREAM  _SCUIOC(0x0015)
+
+/**
+ * Give back completed stream blocks to the driver
+ *
+ * @param unsigned long: Number of blocks from the oldest completed block
+ * @return ioctl return value provides success/failure indication
+ */
+
+#define SCUIOC_RELSTREAM   _SCUIOC(0x0016)
+
 /** @} scu_ioctl */
 
 /**
@@ -431,6 +462,39 @@ struct scufifo_wm_s
   uint16_t               watermark;
 };
 
+/** Stream block descriptor, filled in by the driver */
+
+struct scufifo_block_s
+{
+  struct scutimestamp_s ts;     /**< Timestamp of the first sample */
+  uint32_t              seqno;  /**< Block number counted from start.
+                                 *   Skipped numbers are lost blocks. */
+};
+
+/** Streaming setting */
+
+struct scufifo_stream_s
+{
+  FAR char *buffer;                   /**< Memory for nblocks * blocksize
+                                       *   bytes */
+  FAR struct scufifo_block_s *blocks; /**< nblocks block descriptors */
+  uint16_t blocksize;                 /**< Bytes per block, multiple of
+                                       *   sample size */
+  uint8_t  nblocks;                   /**< Number of blocks (2 - 255) */
+};
+
+/** Streaming status, returned by SCUIOC_WAITSTREAM */
+
+struct scufifo_streamstat_s
+{
+  uint8_t  index;        /**< Index of the oldest completed block */
+  uint8_t  count;        /**< Number of completed blocks from index */
+  uint32_t completed;    /**< Total number of completed blocks */
+  uint32_t overruns;     /**< Blocks dropped because the ring was full */
+  uint32_t errors;       /**< Blocks lost by DMA error */
+  uint32_t fifooverruns; /**< FIFO overrun errors */
+};
+
 struct seq_s;     /* The sequencer object */
 
 /** @} scu_datatypes */
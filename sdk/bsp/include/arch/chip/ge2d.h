@@ -36,12 +36,99 @@
 #ifndef __BSP_INCLUDE_ARCH_CHIP_GE2D_H
 #define __BSP_INCLUDE_ARCH_CHIP_GE2D_H
 
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define _GE2DIOCBASE      (0xa100)
+
+#define _GE2DIOCVALID(c)  (_IOC_TYPE(c)==_GE2DIOCBASE)
+#define _GE2DIOC(nr)      _IOC(_GE2DIOCBASE,nr)
+
+/* Queue a descriptor list and return without waiting for the engine.
+ * The list must be 16 byte aligned, end with a halt command and stay
+ * valid until it is completed.  Fails with EAGAIN when the file was opened
+ * with O_NONBLOCK and CONFIG_CXD56_GE2D_NJOBS lists are already queued.
+ * Arg: struct ge2d_submit_s*
+ */
+
+#define GE2DIOC_SUBMIT    _GE2DIOC(0x0001)
+
+/* Wait until the list of a fence is completed.  Fails with EIO when a list
+ * submitted through this file up to the fence hit an engine error since
+ * the last report, and with ECANCELED when it was stopped.
+ * Arg: uint32_t fence
+ */
+
+#define GE2DIOC_WAIT      _GE2DIOC(0x0002)
+
+/* Stop the engine and cancel all running and queued lists.
+ * Arg: none
+ */
+
+#define GE2DIOC_STOP      _GE2DIOC(0x0003)
+
+/* Get the engine and queue status.
+ * Arg: struct ge2d_status_s*
+ */
+
+#define GE2DIOC_STATUS    _GE2DIOC(0x0004)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
 #ifndef __ASSEMBLY__
 
+/* Argument of GE2DIOC_SUBMIT */
+
+struct ge2d_submit_s
+{
+  FAR const void *desc;     /* Descriptor list */
+  size_t len;               /* Length of the list, including the halt */
+  uint32_t fence;           /* [out] Fence to wait for this list */
+};
+
+/* Argument of GE2DIOC_STATUS */
+
+struct ge2d_status_s
+{
+  uint32_t hwstatus;        /* Engine status register */
+  uint32_t curdesc;         /* Address of the current descriptor */
+  uint32_t submitted;       /* Fence of the last submitted list */
+  uint32_t completed;       /* Fence of the last completed list */
+  uint32_t starts;          /* Number of times the engine was started */
+  uint32_t chained;         /* Lists run right behind another one */
+  uint32_t errors;          /* Lists failed by an engine error */
+  uint32_t canceled;        /* Lists canceled by GE2DIOC_STOP */
+};
+
+/* In-kernel submission.  The job is owned by the caller and must stay
+ * valid until the callback is called.  The callback is called from the
+ * interrupt handler with OK, -EIO or -ECANCELED, and may be NULL.
+ */
+
+struct ge2d_job_s;
+typedef void (*ge2d_callback_t)(FAR struct ge2d_job_s *job, int result);
+
+struct ge2d_job_s
+{
+  FAR struct ge2d_job_s *flink;     /* Queue link, used by the driver */
+  FAR const void *desc;             /* Descriptor list */
+  size_t len;                       /* Length of the list */
+  ge2d_callback_t callback;         /* Completion callback */
+  FAR void *arg;                    /* For use by the caller */
+  uint32_t fence;                   /* [out] Set on submission */
+};
+
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
@@ -58,6 +145,29 @@ extern "C"
 int cxd56_ge2dinitialize(FAR const char *devname);
 void cxd56_ge2duninitialize(FAR const char *devname);
 
+/****************************************************************************
+ * Name: cxd56_ge2dsubmit
+ *
+ * Description:
+ *   Queue a job without waiting.  Lists are run in submission order, lists
+ *   queued behind a running one are chained to run without a stop in
+ *   between as far as CONFIG_CXD56_GE2D_CHAINSIZE allows.
+ *
+ ****************************************************************************/
+
+int cxd56_ge2dsubmit(FAR struct ge2d_job_s *job);
+
+/****************************************************************************
+ * Name: cxd56_ge2dwait
+ *
+ * Description:
+ *   Wait until the job of a fence, and all jobs submitted before it, are
+ *   completed.
+ *
+ ****************************************************************************/
+
+int cxd56_ge2dwait(uint32_t fence);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
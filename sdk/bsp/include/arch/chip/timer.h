@@ -66,4 +66,31 @@ struct timer_sethandler_s
   CODE tccb_t handler;         /* The timer interrupt handler */
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_CXD56_SYSTICK_PCHOOK
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * System timer tick hook
+ *
+ * Called from the system timer interrupt, before the tick is processed,
+ * when CONFIG_CXD56_SYSTICK_PCHOOK is enabled.  To be provided by the user
+ * of the hook.
+ *
+ * @param pc The PC interrupted by the tick
+ */
+
+void board_systick_pchook(uint32_t pc);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 #endif  /* __ARCH_ARM_INCLUDE_CXD56XX_TIMER_H */
@@ -303,6 +303,28 @@ FAR struct lcd_dev_s *ili9340_initialize(FAR struct ili9340_lcd_s *lcd, int devn
 
 int ili9340_clear(FAR struct lcd_dev_s *dev, uint16_t color);
 
+/**************************************************************************************
+ * Name:  ili9340_flush
+ *
+ * Description:
+ *   This is a non-standard LCD interface.  With CONFIG_LCD_FBCACHE the pixels drawn
+ *   by putrun are held in a frame buffer and written to the panel by a flush task.
+ *   This writes the pending changes to the panel now and waits for completion.
+ *
+ * Parameter:
+ *   dev   - A reference to the lcd driver structure
+ *
+ * Returned Value:
+ *
+ *  On success - OK
+ *  On error   - -EINVAL
+ *
+ **************************************************************************************/
+
+#ifdef CONFIG_LCD_FBCACHE
+int ili9340_flush(FAR struct lcd_dev_s *dev);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -128,6 +128,29 @@ struct lpm013m091a_lcd_s
 
 FAR struct lcd_dev_s* lpm013m091a_initialize(struct lpm013m091a_lcd_s *lcd, int devno);
 
+/**************************************************************************************
+ * Name:  lpm013m091a_flush
+ *
+ * Description:
+ *   With CONFIG_LCD_FBCACHE the pixels drawn by putrun are held in a frame buffer
+ *   and written to the panel by a flush task.  This writes the pending changes to
+ *   the panel now and waits for completion.
+ *
+ * Input Parameters:
+ *
+ *   dev - A reference to the lcd driver structure
+ *
+ * Returned Value:
+ *
+ *   On success - OK
+ *   On error   - -EINVAL
+ *
+ **************************************************************************************/
+
+#ifdef CONFIG_LCD_FBCACHE
+int lpm013m091a_flush(FAR struct lcd_dev_s *dev);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
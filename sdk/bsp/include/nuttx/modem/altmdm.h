@@ -75,6 +75,7 @@
 #define MODEM_IOC_PM_GETWAKELOCKSTATE _MODEMIOC(12)
 #define MODEM_IOC_PM_ERR_REGISTERCB   _MODEMIOC(13)
 #define MODEM_IOC_PM_ERR_DEREGISTERCB _MODEMIOC(14)
+#define MODEM_IOC_GETSTATS            _MODEMIOC(15)
 
 #define MODEM_PM_CB_TYPE_NORMAL       0
 #define MODEM_PM_CB_TYPE_ERROR        1
@@ -94,6 +95,28 @@ struct altmdm_pm_wakelock_s
 
 typedef void (*altmdm_pm_cbfunc_t)(uint32_t state);
 
+/* Transfer statistics, returned by MODEM_IOC_GETSTATS.
+ * tx_packets / tx_frames is the average number of packets carried by
+ * one SPI frame.
+ */
+
+struct altmdm_stats_s
+{
+  uint32_t xfers;       /* Number of SPI transfers (header exchanges). */
+  uint32_t rx_packets;  /* Packets received into the receive buffers. */
+  uint32_t rx_nobuff;   /* Transfers the modem had data for while no
+                         * receive buffer was free. */
+  uint32_t rx_stalls;   /* Number of times the receive buffers ran out. */
+  uint64_t rx_stall_us; /* Total time the modem was held off because no
+                         * receive buffer was free, in microseconds. */
+  uint32_t tx_frames;   /* SPI frames that carried transmit data. */
+  uint32_t tx_packets;  /* Packets carried by those frames. */
+  uint32_t tx_retries;  /* Frames resent because the modem was buffer
+                         * full. */
+  uint32_t tx_lost;     /* Coalesced packets lost in failed frames. Their
+                         * writes had already returned. */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
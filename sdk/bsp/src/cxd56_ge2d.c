@@ -46,16 +46,66 @@
 #include <semaphore.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <debug.h>
 #include <errno.h>
 
+#include <arch/chip/ge2d.h>
+
 #include "up_arch.h"
 #include "chip.h"
 #include "cxd56_clock.h"
+#include "cxd56_ge2dqueue.h"
 
 #include "chip/cxd56_ge2d.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_CXD56_GE2D_NJOBS
+#  define CONFIG_CXD56_GE2D_NJOBS 8
+#endif
+
+#ifndef CONFIG_CXD56_GE2D_CHAINSIZE
+#  define CONFIG_CXD56_GE2D_CHAINSIZE 1024
+#endif
+
+#define GE2D_INTR_DONE (GE2D_INTR_WR_ERR | GE2D_INTR_RD_ERR | GE2D_INTR_NDE | \
+                        GE2D_INTR_DSD | GE2D_INTR_NDF)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Lists queued through one open file */
+
+struct ge2d_file_s
+{
+  struct ge2d_job_s jobs[CONFIG_CXD56_GE2D_NJOBS];
+  bool busy[CONFIG_CXD56_GE2D_NJOBS];
+  uint8_t nbusy;
+
+  uint32_t last;            /* Fence of the last submitted list */
+  uint32_t errfence;        /* First failed list not reported yet */
+  int errcode;              /* -EIO or -ECANCELED, 0 if none */
+
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds;
+#endif
+};
+
+/* Blocking write */
+
+struct ge2d_sync_s
+{
+  struct ge2d_job_s job;
+  int result;
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -65,9 +115,13 @@ static int ge2d_close(FAR struct file *filep);
 static ssize_t ge2d_read(FAR struct file *filep, FAR char *buffer, size_t len);
 static ssize_t ge2d_write(FAR struct file *filep, FAR const char *buffer, size_t len);
 static int ge2d_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
-static int ge2d_semtake(sem_t *id);
-static void ge2d_semgive(sem_t *id);
+#ifndef CONFIG_DISABLE_POLL
+static int ge2d_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                     bool setup);
+#endif
 static int ge2d_irqhandler(int irq, FAR void *context, FAR void *arg);
+static void ge2d_start(FAR void *arg, FAR const void *desc);
+static void ge2d_stop(FAR void *arg);
 
 /****************************************************************************
  * Private Data
@@ -81,35 +135,226 @@ static const struct file_operations g_ge2dfops =
   .write = ge2d_write,
   .seek  = 0,
   .ioctl = ge2d_ioctl,
+#ifndef CONFIG_DISABLE_POLL
+  .poll  = ge2d_poll,
+#endif
+};
+
+static const struct ge2dq_ops_s g_ge2dqops =
+{
+  .start = ge2d_start,
+  .stop  = ge2d_stop,
 };
 
-static sem_t g_wait;
-static sem_t g_lock;
+static struct ge2dq_s g_queue;
+
+#if CONFIG_CXD56_GE2D_CHAINSIZE > 0
+static uint8_t g_chain[CONFIG_CXD56_GE2D_CHAINSIZE] __attribute__((aligned(16)));
+#  define GE2D_CHAIN g_chain
+#else
+#  define GE2D_CHAIN NULL
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: ge2d_semtake
+ * Name: ge2d_start
+ ****************************************************************************/
+
+static void ge2d_start(FAR void *arg, FAR const void *desc)
+{
+  /* Set operation buffer and start processing.
+   * Descriptor start address bit 0 is select to bus, always 1 (memory),
+   * can't set except 1 in this chip.
+   */
+
+  putreg32((uint32_t)(uintptr_t)desc | 1, GE2D_ADDRESS_DESCRIPTOR_START);
+
+  /* Enable error and completion interrupts. */
+
+  putreg32(GE2D_INTR_DONE, GE2D_INTR_ENABLE);
+  putreg32(GE2D_EXEC, GE2D_CMD_DESCRIPTOR);
+}
+
+/****************************************************************************
+ * Name: ge2d_stop
  ****************************************************************************/
 
-static int ge2d_semtake(sem_t *id)
+static void ge2d_stop(FAR void *arg)
 {
-  while (sem_wait(id) != 0)
+  putreg32(GE2D_STOP, GE2D_CMD_DESCRIPTOR);
+
+  while (getreg32(GE2D_STATUS) & GE2D_STAT_NREQ)
     {
-      ASSERT(errno == EINTR);
     }
-  return OK;
+
+  /* Drop the completion of the stopped list.  An interrupt already
+   * pending finds no status bits and is ignored.
+   */
+
+  putreg32(0, GE2D_INTR_ENABLE);
+  putreg32(getreg32(GE2D_INTR_STAT), GE2D_INTR_STAT);
+}
+
+/****************************************************************************
+ * Name: ge2d_notify
+ ****************************************************************************/
+
+static void ge2d_notify(FAR struct ge2d_file_s *priv)
+{
+#ifndef CONFIG_DISABLE_POLL
+  pollevent_t events = POLLOUT;
+
+  if (priv->nbusy == 0)
+    {
+      events |= POLLIN;
+    }
+
+  if (priv->fds && (priv->fds->events & events))
+    {
+      priv->fds->revents |= priv->fds->events & events;
+      sem_post(priv->fds->sem);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: ge2d_jobdone
+ *
+ * Description:
+ *   Completion of a list submitted through a file, called from the
+ *   interrupt handler.
+ *
+ ****************************************************************************/
+
+static void ge2d_jobdone(FAR struct ge2d_job_s *job, int result)
+{
+  FAR struct ge2d_file_s *priv = (FAR struct ge2d_file_s *)job->arg;
+
+  priv->busy[job - priv->jobs] = false;
+  priv->nbusy--;
+
+  if (result < 0 && priv->errcode == 0)
+    {
+      priv->errfence = job->fence;
+      priv->errcode  = result;
+    }
+
+  ge2d_notify(priv);
+}
+
+/****************************************************************************
+ * Name: ge2d_syncdone
+ ****************************************************************************/
+
+static void ge2d_syncdone(FAR struct ge2d_job_s *job, int result)
+{
+  ((FAR struct ge2d_sync_s *)job)->result = result;
+}
+
+/****************************************************************************
+ * Name: ge2d_fwait
+ *
+ * Description:
+ *   Wait for a fence and report the first error of the lists submitted
+ *   through the file up to it.
+ *
+ ****************************************************************************/
+
+static int ge2d_fwait(FAR struct ge2d_file_s *priv, uint32_t fence)
+{
+  irqstate_t flags;
+  int ret;
+
+  ret = ge2dq_wait(&g_queue, fence);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  if (priv->errcode != 0 && (int32_t)(priv->errfence - fence) <= 0)
+    {
+      ret = priv->errcode;
+      priv->errcode = 0;
+    }
+
+  leave_critical_section(flags);
+  return ret;
 }
 
 /****************************************************************************
- * Name: ge2d_semgive
+ * Name: ge2d_fsubmit
  ****************************************************************************/
 
-static void ge2d_semgive(sem_t *id)
+static int ge2d_fsubmit(FAR struct file *filep,
+                        FAR struct ge2d_submit_s *submit)
 {
-  sem_post(id);
+  FAR struct ge2d_file_s *priv = (FAR struct ge2d_file_s *)filep->f_priv;
+  FAR struct ge2d_job_s *job;
+  irqstate_t flags;
+  uint32_t oldest;
+  int ret;
+  int i;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+
+      job    = NULL;
+      oldest = priv->last;
+      for (i = 0; i < CONFIG_CXD56_GE2D_NJOBS; i++)
+        {
+          if (!priv->busy[i])
+            {
+              job = &priv->jobs[i];
+              break;
+            }
+
+          if ((int32_t)(priv->jobs[i].fence - oldest) < 0)
+            {
+              oldest = priv->jobs[i].fence;
+            }
+        }
+
+      if (job)
+        {
+          break;
+        }
+
+      leave_critical_section(flags);
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      /* All slots in use, wait for the oldest one.  Its error is kept for
+       * GE2DIOC_WAIT.
+       */
+
+      ge2dq_wait(&g_queue, oldest);
+    }
+
+  job->desc     = submit->desc;
+  job->len      = submit->len;
+  job->callback = ge2d_jobdone;
+  job->arg      = priv;
+
+  ret = ge2dq_submit(&g_queue, job);
+  if (ret == OK)
+    {
+      priv->busy[job - priv->jobs] = true;
+      priv->nbusy++;
+      priv->last    = job->fence;
+      submit->fence = job->fence;
+    }
+
+  leave_critical_section(flags);
+  return ret;
 }
 
 /****************************************************************************
@@ -118,6 +363,19 @@ static void ge2d_semgive(sem_t *id)
 
 static int ge2d_open(FAR struct file *filep)
 {
+  FAR struct ge2d_file_s *priv;
+
+  priv = (FAR struct ge2d_file_s *)kmm_zalloc(sizeof(struct ge2d_file_s));
+  if (!priv)
+    {
+      return -ENOMEM;
+    }
+
+  /* No list before the current one belongs to this file */
+
+  priv->last = g_queue.submitted;
+
+  filep->f_priv = priv;
   return 0;
 }
 
@@ -127,6 +385,14 @@ static int ge2d_open(FAR struct file *filep)
 
 static int ge2d_close(FAR struct file *filep)
 {
+  FAR struct ge2d_file_s *priv = (FAR struct ge2d_file_s *)filep->f_priv;
+
+  /* Queued lists are owned by the file */
+
+  ge2dq_wait(&g_queue, priv->last);
+
+  filep->f_priv = NULL;
+  kmm_free(priv);
   return 0;
 }
 
@@ -145,70 +411,113 @@ static ssize_t ge2d_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
 static ssize_t ge2d_write(FAR struct file *filep, FAR const char *buffer, size_t len)
 {
-  uint32_t bits;
+  struct ge2d_sync_s sync;
+  int ret;
+
+  /* Submit and wait, lists queued by GE2DIOC_SUBMIT run first. */
 
-  /* GE2D wants 16 byte aligned address for operation buffer. */
+  sync.job.desc     = buffer;
+  sync.job.len      = len;
+  sync.job.callback = ge2d_syncdone;
+  sync.result       = OK;
 
-  if (((uintptr_t)buffer & 0xf) != 0)
+  ret = ge2dq_submit(&g_queue, &sync.job);
+  if (ret < 0)
     {
-      set_errno(EINVAL);
-      return 0;
+      return ret;
     }
 
-  /* Get exclusive access */
-
-  ge2d_semtake(&g_lock);
-
-  /* Set operation buffer and start processing.
-   * Descriptor start address bit 0 is select to bus, always 1 (memory),
-   * can't set except 1 in this chip.
-   */
+  ge2dq_wait(&g_queue, sync.job.fence);
 
-  putreg32((uint32_t)(uintptr_t)buffer | 1, GE2D_ADDRESS_DESCRIPTOR_START);
-  putreg32(GE2D_EXEC, GE2D_CMD_DESCRIPTOR);
+  return sync.result < 0 ? sync.result : len;
+}
 
-  /* Enable error and completion interrupts. */
+/****************************************************************************
+ * Name: ge2d_ioctl
+ ****************************************************************************/
 
-  bits = GE2D_INTR_WR_ERR | GE2D_INTR_RD_ERR | GE2D_INTR_NDE | GE2D_INTR_DSD |
-    GE2D_INTR_NDF;
-  putreg32(bits, GE2D_INTR_ENABLE);
+static int ge2d_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct ge2d_file_s *priv = (FAR struct ge2d_file_s *)filep->f_priv;
+  FAR struct ge2d_status_s *status;
+  int ret = -ENOTTY;
 
-  /* Wait for interrupts for processing done. */
+  switch (cmd)
+    {
+      case GE2DIOC_SUBMIT:
+        ret = ge2d_fsubmit(filep, (FAR struct ge2d_submit_s *)arg);
+        break;
 
-  ge2d_semtake(&g_wait);
+      case GE2DIOC_WAIT:
+        ret = ge2d_fwait(priv, (uint32_t)arg);
+        break;
 
-  /* Disable interrupts */
+      case GE2DIOC_STOP:
+        ge2dq_stop(&g_queue);
+        ret = OK;
+        break;
 
-  putreg32(0, GE2D_INTR_ENABLE);
+      case GE2DIOC_STATUS:
+        status = (FAR struct ge2d_status_s *)arg;
+        ge2dq_status(&g_queue, status);
+        status->hwstatus = getreg32(GE2D_STATUS);
+        status->curdesc  = getreg32(GE2D_STAT_CURRENT_DESCRIPTOR_ADDRESS);
+        ret = OK;
+        break;
 
-  ge2d_semgive(&g_lock);
+      default:
+        break;
+    }
 
-  return len;
+  return ret;
 }
 
 /****************************************************************************
- * Name: ge2d_ioctl
+ * Name: ge2d_poll
+ *
+ * Description:
+ *   POLLOUT when another list can be submitted without blocking, POLLIN
+ *   when all lists submitted through the file are completed.
+ *
  ****************************************************************************/
 
-static int ge2d_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+#ifndef CONFIG_DISABLE_POLL
+static int ge2d_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                     bool setup)
 {
-  int ret = -ENOTTY;
+  FAR struct ge2d_file_s *priv = (FAR struct ge2d_file_s *)filep->f_priv;
+  irqstate_t flags;
+  int ret = OK;
 
-  /*
-   * TODO: Should be implement features:
-   *
-   * - stop execution
-   * - debug for raster operation
-   */
+  flags = enter_critical_section();
 
-  switch (cmd)
+  if (setup)
     {
-      default:
-        break;
+      if (priv->fds)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          priv->fds = fds;
+          fds->priv = &priv->fds;
+
+          if (priv->nbusy < CONFIG_CXD56_GE2D_NJOBS)
+            {
+              ge2d_notify(priv);
+            }
+        }
+    }
+  else if (fds->priv)
+    {
+      priv->fds = NULL;
+      fds->priv = NULL;
     }
 
+  leave_critical_section(flags);
   return ret;
 }
+#endif
 
 /****************************************************************************
  * Name: ge2d_irqhandler
@@ -223,15 +532,49 @@ static int ge2d_irqhandler(int irq, FAR void *context, FAR void *arg)
   stat = getreg32(GE2D_INTR_STAT);
   putreg32(stat, GE2D_INTR_STAT);
 
-  /* TODO: output status to syslog */
+  if ((stat & GE2D_INTR_DONE) == 0)
+    {
+      return OK;
+    }
+
+  if (stat & (GE2D_INTR_WR_ERR | GE2D_INTR_RD_ERR))
+    {
+      _err("GE2D bus error: %08x at %08x\n", stat,
+           getreg32(GE2D_STAT_CURRENT_DESCRIPTOR_ADDRESS));
+    }
+
+  /* Enabled again by the next start, if any */
 
-  /* Release semaphore anyway */
+  putreg32(0, GE2D_INTR_ENABLE);
 
-  ge2d_semgive(&g_wait);
+  ge2dq_complete(&g_queue, stat & (GE2D_INTR_WR_ERR | GE2D_INTR_RD_ERR) ?
+                 -EIO : OK);
 
   return OK;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cxd56_ge2dsubmit
+ ****************************************************************************/
+
+int cxd56_ge2dsubmit(FAR struct ge2d_job_s *job)
+{
+  return ge2dq_submit(&g_queue, job);
+}
+
+/****************************************************************************
+ * Name: cxd56_ge2dwait
+ ****************************************************************************/
+
+int cxd56_ge2dwait(uint32_t fence)
+{
+  return ge2dq_wait(&g_queue, fence);
+}
+
 /****************************************************************************
  * Name: cxd56_ge2dinitialize
  ****************************************************************************/
@@ -240,13 +583,13 @@ int cxd56_ge2dinitialize(FAR const char *devname)
 {
   int ret;
 
-  sem_init(&g_lock, 0, 1);
-  sem_init(&g_wait, 0, 0);
-  sem_setprotocol(&g_wait, SEM_PRIO_NONE);
+  ge2dq_initialize(&g_queue, &g_ge2dqops, NULL, GE2D_CHAIN,
+                   CONFIG_CXD56_GE2D_CHAINSIZE);
 
   ret = register_driver(devname, &g_ge2dfops, 0666, NULL);
   if (ret != 0)
     {
+      ge2dq_uninitialize(&g_queue);
       return ERROR;
     }
 
@@ -268,13 +611,14 @@ int cxd56_ge2dinitialize(FAR const char *devname)
 
 void cxd56_ge2duninitialize(FAR const char *devname)
 {
+  ge2dq_stop(&g_queue);
+
   up_disable_irq(CXD56_IRQ_GE2D);
   irq_detach(CXD56_IRQ_GE2D);
 
   cxd56_img_ge2d_clock_disable();
 
-  sem_destroy(&g_lock);
-  sem_destroy(&g_wait);
+  ge2dq_uninitialize(&g_queue);
 
   unregister_driver(devname);
 }
@@ -0,0 +1,361 @@
+/****************************************************************************
+ * bsp/src/cxd56_ge2dqueue.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <nuttx/irq.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <queue.h>
+#include <semaphore.h>
+#include <debug.h>
+#include <errno.h>
+
+#include "cxd56_ge2dqueue.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ge2dq_halted
+ *
+ * Description:
+ *   Whether the list ends with a halt command and can be chained.
+ *
+ ****************************************************************************/
+
+static bool ge2dq_halted(FAR struct ge2d_job_s *job)
+{
+  FAR const uint32_t *halt;
+
+  if (job->len < 2 * GE2DQ_HALTSIZE)
+    {
+      return false;
+    }
+
+  halt = (FAR const uint32_t *)((uintptr_t)job->desc + job->len -
+                                GE2DQ_HALTSIZE);
+
+  return (halt[0] | halt[1] | halt[2] | halt[3]) == 0;
+}
+
+/****************************************************************************
+ * Name: ge2dq_startnext
+ *
+ * Description:
+ *   Start the pending jobs.  When more than one is pending, as many as fit
+ *   are copied into the chain buffer without their halt commands, so the
+ *   engine runs them as one list.  Must be called in a critical section
+ *   with the engine idle.
+ *
+ ****************************************************************************/
+
+static void ge2dq_startnext(FAR struct ge2dq_s *q)
+{
+  FAR struct ge2d_job_s *job;
+  FAR uint8_t *p;
+  size_t used = GE2DQ_HALTSIZE;
+  int n = 0;
+
+  job = (FAR struct ge2d_job_s *)sq_peek(&q->pending);
+  if (!job)
+    {
+      return;
+    }
+
+  if (q->chain)
+    {
+      for (; job; job = (FAR struct ge2d_job_s *)sq_next((sq_entry_t *)job))
+        {
+          if (!ge2dq_halted(job) ||
+              used + job->len - GE2DQ_HALTSIZE > q->chainsize)
+            {
+              break;
+            }
+
+          used += job->len - GE2DQ_HALTSIZE;
+          n++;
+        }
+    }
+
+  q->starts++;
+
+  if (n < 2)
+    {
+      job = (FAR struct ge2d_job_s *)sq_remfirst(&q->pending);
+      sq_addlast((sq_entry_t *)job, &q->running);
+      q->ops->start(q->arg, job->desc);
+      return;
+    }
+
+  for (p = q->chain; n > 0; n--)
+    {
+      job = (FAR struct ge2d_job_s *)sq_remfirst(&q->pending);
+      sq_addlast((sq_entry_t *)job, &q->running);
+
+      memcpy(p, job->desc, job->len - GE2DQ_HALTSIZE);
+      p += job->len - GE2DQ_HALTSIZE;
+      q->chained++;
+    }
+
+  q->chained--;
+  memset(p, 0, GE2DQ_HALTSIZE);
+  q->ops->start(q->arg, q->chain);
+}
+
+/****************************************************************************
+ * Name: ge2dq_finish
+ *
+ * Description:
+ *   Call back a list of jobs taken out of the queue, and wake up the
+ *   waiters.  Must be called in a critical section.
+ *
+ ****************************************************************************/
+
+static void ge2dq_finish(FAR struct ge2dq_s *q, FAR sq_queue_t *jobs,
+                         int result)
+{
+  FAR struct ge2d_job_s *job;
+
+  while ((job = (FAR struct ge2d_job_s *)sq_remfirst(jobs)) != NULL)
+    {
+      q->completed = job->fence;
+      if (job->callback)
+        {
+          job->callback(job, result);
+        }
+    }
+
+  while (q->nwaiters > 0)
+    {
+      q->nwaiters--;
+      sem_post(&q->done);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ge2dq_initialize
+ ****************************************************************************/
+
+void ge2dq_initialize(FAR struct ge2dq_s *q, FAR const struct ge2dq_ops_s *ops,
+                      FAR void *arg, FAR uint8_t *chain, size_t chainsize)
+{
+  memset(q, 0, sizeof(struct ge2dq_s));
+
+  DEBUGASSERT(((uintptr_t)chain & 0xf) == 0);
+
+  q->ops       = ops;
+  q->arg       = arg;
+  q->chain     = chainsize >= 2 * GE2DQ_HALTSIZE ? chain : NULL;
+  q->chainsize = chainsize;
+
+  sq_init(&q->pending);
+  sq_init(&q->running);
+
+  sem_init(&q->done, 0, 0);
+  sem_setprotocol(&q->done, SEM_PRIO_NONE);
+}
+
+/****************************************************************************
+ * Name: ge2dq_uninitialize
+ ****************************************************************************/
+
+void ge2dq_uninitialize(FAR struct ge2dq_s *q)
+{
+  DEBUGASSERT(sq_empty(&q->pending) && sq_empty(&q->running));
+
+  sem_destroy(&q->done);
+}
+
+/****************************************************************************
+ * Name: ge2dq_submit
+ ****************************************************************************/
+
+int ge2dq_submit(FAR struct ge2dq_s *q, FAR struct ge2d_job_s *job)
+{
+  irqstate_t flags;
+
+  /* GE2D wants 16 byte aligned address for operation buffer. */
+
+  if (((uintptr_t)job->desc & 0xf) != 0 || job->len < GE2DQ_HALTSIZE ||
+      (job->len & 0xf) != 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  job->fence = ++q->submitted;
+  sq_addlast((sq_entry_t *)job, &q->pending);
+
+  if (sq_empty(&q->running))
+    {
+      ge2dq_startnext(q);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ge2dq_complete
+ ****************************************************************************/
+
+void ge2dq_complete(FAR struct ge2dq_s *q, int result)
+{
+  sq_queue_t done;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  /* Keep the engine busy before anything else */
+
+  done = q->running;
+  sq_init(&q->running);
+  ge2dq_startnext(q);
+
+  if (result < 0)
+    {
+      FAR sq_entry_t *e;
+
+      for (e = sq_peek(&done); e; e = sq_next(e))
+        {
+          q->errors++;
+        }
+    }
+
+  ge2dq_finish(q, &done, result);
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: ge2dq_stop
+ ****************************************************************************/
+
+void ge2dq_stop(FAR struct ge2dq_s *q)
+{
+  sq_queue_t canceled;
+  FAR sq_entry_t *e;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (!sq_empty(&q->running))
+    {
+      q->ops->stop(q->arg);
+    }
+
+  canceled = q->running;
+  sq_init(&q->running);
+
+  while ((e = sq_remfirst(&q->pending)) != NULL)
+    {
+      sq_addlast(e, &canceled);
+    }
+
+  for (e = sq_peek(&canceled); e; e = sq_next(e))
+    {
+      q->canceled++;
+    }
+
+  ge2dq_finish(q, &canceled, -ECANCELED);
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: ge2dq_wait
+ ****************************************************************************/
+
+int ge2dq_wait(FAR struct ge2dq_s *q, uint32_t fence)
+{
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+
+      if ((int32_t)(fence - q->submitted) > 0)
+        {
+          leave_critical_section(flags);
+          return -EINVAL;
+        }
+
+      if ((int32_t)(q->completed - fence) >= 0)
+        {
+          leave_critical_section(flags);
+          return OK;
+        }
+
+      q->nwaiters++;
+      leave_critical_section(flags);
+
+      while (sem_wait(&q->done) != 0)
+        {
+          DEBUGASSERT(errno == EINTR);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: ge2dq_status
+ ****************************************************************************/
+
+void ge2dq_status(FAR struct ge2dq_s *q, FAR struct ge2d_status_s *status)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  status->submitted = q->submitted;
+  status->completed = q->completed;
+  status->starts    = q->starts;
+  status->chained   = q->chained;
+  status->errors    = q->errors;
+  status->canceled  = q->canceled;
+
+  leave_critical_section(flags);
+}
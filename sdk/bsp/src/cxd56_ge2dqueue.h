@@ -0,0 +1,188 @@
+/****************************************************************************
+ * bsp/src/cxd56_ge2dqueue.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_CXD56XX_CXD56_GE2DQUEUE_H
+#define __ARCH_ARM_SRC_CXD56XX_CXD56_GE2DQUEUE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+#include <semaphore.h>
+
+#include <arch/chip/ge2d.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A descriptor list ends with a halt command of 16 zero bytes */
+
+#define GE2DQ_HALTSIZE 16
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Engine access used by the queue.  All operations are called in a
+ * critical section.
+ */
+
+struct ge2dq_ops_s
+{
+  /* Start processing the descriptor list at desc.  ge2dq_complete() must
+   * be called when the engine halts.
+   */
+
+  void (*start)(FAR void *arg, FAR const void *desc);
+
+  /* Stop the engine and discard its pending completion */
+
+  void (*stop)(FAR void *arg);
+};
+
+/* Queue instance */
+
+struct ge2dq_s
+{
+  FAR const struct ge2dq_ops_s *ops;
+  FAR void *arg;                      /* Argument for ops */
+
+  sq_queue_t pending;                 /* Submitted, not started */
+  sq_queue_t running;                 /* Started as one list */
+
+  FAR uint8_t *chain;                 /* Lists run back to back */
+  size_t chainsize;
+
+  uint32_t submitted;                 /* Fence of the last submitted job */
+  uint32_t completed;                 /* Fence of the last completed job */
+  uint8_t nwaiters;                   /* Tasks waiting in ge2dq_wait() */
+
+  uint32_t starts;                    /* Statistics */
+  uint32_t chained;
+  uint32_t errors;
+  uint32_t canceled;
+
+  sem_t done;                         /* Wait for completion */
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ge2dq_initialize
+ *
+ * Description:
+ *   Initialize queue instance.  chain is a 16 byte aligned buffer of
+ *   chainsize bytes to run queued lists back to back, or NULL.
+ *
+ ****************************************************************************/
+
+void ge2dq_initialize(FAR struct ge2dq_s *q, FAR const struct ge2dq_ops_s *ops,
+                      FAR void *arg, FAR uint8_t *chain, size_t chainsize);
+
+/****************************************************************************
+ * Name: ge2dq_uninitialize
+ *
+ * Description:
+ *   Uninitialize queue instance.  Queue must be empty.
+ *
+ ****************************************************************************/
+
+void ge2dq_uninitialize(FAR struct ge2dq_s *q);
+
+/****************************************************************************
+ * Name: ge2dq_submit
+ *
+ * Description:
+ *   Queue a job and start the engine if it is idle.
+ *
+ * Returned Value:
+ *   OK, or -EINVAL for a misaligned list.
+ *
+ ****************************************************************************/
+
+int ge2dq_submit(FAR struct ge2dq_s *q, FAR struct ge2d_job_s *job);
+
+/****************************************************************************
+ * Name: ge2dq_complete
+ *
+ * Description:
+ *   Engine halted.  Called from the interrupt handler, starts the next
+ *   lists before calling back the completed jobs.
+ *
+ * Input Parameters:
+ *   q      - Queue instance
+ *   result - OK or -EIO
+ *
+ ****************************************************************************/
+
+void ge2dq_complete(FAR struct ge2dq_s *q, int result);
+
+/****************************************************************************
+ * Name: ge2dq_stop
+ *
+ * Description:
+ *   Stop the engine and cancel all running and pending jobs.
+ *
+ ****************************************************************************/
+
+void ge2dq_stop(FAR struct ge2dq_s *q);
+
+/****************************************************************************
+ * Name: ge2dq_wait
+ *
+ * Description:
+ *   Wait until the job of a fence is completed.
+ *
+ ****************************************************************************/
+
+int ge2dq_wait(FAR struct ge2dq_s *q, uint32_t fence);
+
+/****************************************************************************
+ * Name: ge2dq_status
+ *
+ * Description:
+ *   Get the queue part of the status.
+ *
+ ****************************************************************************/
+
+void ge2dq_status(FAR struct ge2dq_s *q, FAR struct ge2d_status_s *status);
+
+#endif /* __ARCH_ARM_SRC_CXD56XX_CXD56_GE2DQUEUE_H */
@@ -60,6 +60,9 @@
 #  include "cxd56_udmac.h"
 #  include <arch/chip/pm.h>
 #endif
+#ifdef CONFIG_CXD56_SCU_STREAM
+#  include "cxd56_scustream.h"
+#endif
 
 #include "chip/cxd56_scu.h"
 #include "chip/cxd56_scuseq.h"
@@ -153,6 +156,14 @@ struct scufifo_s
   sem_t dmawait;  /* Wait semaphore for DMA complete */
   int dmaresult;  /* DMA result */
 #endif
+
+#ifdef CONFIG_CXD56_SCU_STREAM
+  struct scustream_s stream;      /* Streaming into application blocks */
+  uint32_t streamxfer;            /* DMA transfer size for streaming */
+  uint32_t discard;               /* DMA destination for dropped data */
+  struct pm_cpu_wakelock_s wlock; /* Keep CPU awake while streaming */
+  bool wakelock;                  /* wlock is acquired */
+#endif
 };
 
 /* Sequencer */
@@ -294,6 +305,17 @@ static void seq_fifodmadone(DMA_HANDLE handle, uint8_t status, void *arg);
 #endif
 static uint16_t seq_remakeinstruction(int bustype, uint16_t inst);
 
+/* FIFO streaming ***********************************************************/
+
+#ifdef CONFIG_CXD56_SCU_STREAM
+static uint16_t seq_streamavail(FAR void *arg);
+static void seq_streamtimestamp(FAR void *arg, FAR struct scutimestamp_s *ts);
+static void seq_streamdmastart(FAR void *arg, FAR char *dst, uint16_t len);
+static void seq_streamdmastop(FAR void *arg);
+static void seq_streamdmadone(DMA_HANDLE handle, uint8_t status, void *arg);
+static void seq_streamstop(FAR struct scufifo_s *fifo);
+#endif
+
 /* Mathfunction *************************************************************/
 
 static void mathf_enable(int8_t mid, uint8_t wid);
@@ -315,6 +337,16 @@ static void seq_handleisopdoneintr(FAR struct cxd56_scudev_s *priv, uint32_t int
 
 struct cxd56_scudev_s g_scudev;
 
+#ifdef CONFIG_CXD56_SCU_STREAM
+static const struct scustream_ops_s g_streamops =
+{
+  .available    = seq_streamavail,
+  .gettimestamp = seq_streamtimestamp,
+  .dmastart     = seq_streamdmastart,
+  .dmastop      = seq_streamdmastop,
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -1489,6 +1521,16 @@ static void seq_handlefifointr(FAR struct cxd56_scudev_s *priv, uint32_t intr)
 #ifndef CONFIG_DISABLE_SIGNAL
           notify = &priv->wm[i];
 
+#  ifdef CONFIG_CXD56_SCU_STREAM
+          if (notify->fifo && notify->fifo->stream.active)
+            {
+              /* Chain the transfer of next block */
+
+              scustream_kick(&notify->fifo->stream);
+              continue;
+            }
+#  endif
+
           if (notify->ts)
             {
               seq_gettimestamp(notify->fifo, notify->ts);
@@ -1697,6 +1739,13 @@ static int seq_scuirqhandler(int irq, FAR void *context, FAR void *arg)
 
               putreg32(getreg32(SCUFIFO_R_CTRL1(i)) | SCUFIFO_OVERRUNCLR,
                        SCUFIFO_R_CTRL1(i));
+
+#ifdef CONFIG_CXD56_SCU_STREAM
+              if (priv->wm[i].fifo && priv->wm[i].fifo->stream.active)
+                {
+                  scustream_fifooverrun(&priv->wm[i].fifo->stream);
+                }
+#endif
             }
         }
     }
@@ -1985,6 +2034,10 @@ static int seq_fifoinit(FAR struct seq_s *seq, int fifoid, uint16_t fsize)
   fifo->dmaresult = -1;
 #endif
 
+#ifdef CONFIG_CXD56_SCU_STREAM
+  scustream_initialize(&fifo->stream, &g_streamops, fifo);
+#endif
+
   if (seq->type & SEQ_TYPE_DECI)
     {
       FAR struct decimation_fifo_s *dec = &deci->dfifo[fifoid];
@@ -2033,6 +2086,13 @@ static void seq_fifofree(FAR struct scufifo_s *fifo)
       return;
     }
 
+#ifdef CONFIG_CXD56_SCU_STREAM
+  /* Stop streaming before DMA freed */
+
+  seq_streamstop(fifo);
+  scustream_uninitialize(&fifo->stream);
+#endif
+
 #ifdef CONFIG_CXD56_UDMAC
   /* Free DMA */
 
@@ -2891,6 +2951,277 @@ static inline void seq_read32(uint32_t addr, FAR uint32_t *buffer, int length)
 }
 #endif
 
+#ifdef CONFIG_CXD56_SCU_STREAM
+/****************************************************************************
+ * Name: seq_streamavail
+ *
+ * Description:
+ *   Number of samples in FIFO, for stream
+ *
+ ****************************************************************************/
+
+static uint16_t seq_streamavail(FAR void *arg)
+{
+  FAR struct scufifo_s *fifo = (FAR struct scufifo_s *)arg;
+
+  return getreg32(SCUFIFO_R_STATUS0(fifo->rid)) & 0xffff;
+}
+
+/****************************************************************************
+ * Name: seq_streamtimestamp
+ *
+ * Description:
+ *   Timestamp of the head of FIFO, for stream
+ *
+ ****************************************************************************/
+
+static void seq_streamtimestamp(FAR void *arg, FAR struct scutimestamp_s *ts)
+{
+  seq_gettimestamp((FAR struct scufifo_s *)arg, ts);
+}
+
+/****************************************************************************
+ * Name: seq_streamdmastart
+ *
+ * Description:
+ *   Start transfer of one block from FIFO, for stream
+ *
+ ****************************************************************************/
+
+static void seq_streamdmastart(FAR void *arg, FAR char *dst, uint16_t len)
+{
+  FAR struct scufifo_s *fifo = (FAR struct scufifo_s *)arg;
+  dma_config_t config;
+
+  config.channel_cfg = CXD56_UDMA_SINGLE | fifo->streamxfer;
+  if (dst != NULL)
+    {
+      config.channel_cfg |= CXD56_UDMA_MEMINCR;
+    }
+  else
+    {
+      config.channel_cfg |= CXD56_UDMA_NOINCR;
+      dst = (FAR char *)&fifo->discard;
+    }
+
+  cxd56_rxudmasetup(fifo->dma, SCUFIFO_FIFO_DATA(fifo->rid), (uintptr_t)dst,
+                    len, config);
+  cxd56_udmastart(fifo->dma, seq_streamdmadone, fifo);
+}
+
+/****************************************************************************
+ * Name: seq_streamdmastop
+ *
+ * Description:
+ *   Cancel transfer in progress, for stream
+ *
+ ****************************************************************************/
+
+static void seq_streamdmastop(FAR void *arg)
+{
+  FAR struct scufifo_s *fifo = (FAR struct scufifo_s *)arg;
+
+  cxd56_udmastop(fifo->dma);
+}
+
+/****************************************************************************
+ * Name: seq_streamdmadone
+ *
+ * Description:
+ *   Callback function for stream DMA done
+ *
+ ****************************************************************************/
+
+static void seq_streamdmadone(DMA_HANDLE handle, uint8_t status, void *arg)
+{
+  FAR struct scufifo_s *fifo = (FAR struct scufifo_s *)arg;
+
+  scustream_dmadone(&fifo->stream, status);
+}
+
+/****************************************************************************
+ * Name: seq_streamstop
+ *
+ * Description:
+ *   Stop FIFO streaming
+ *
+ ****************************************************************************/
+
+static void seq_streamstop(FAR struct scufifo_s *fifo)
+{
+  FAR struct cxd56_scudev_s *priv = &g_scudev;
+  irqstate_t flags;
+  int rid = fifo->rid;
+
+  if (!fifo->stream.active)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  /* Disable FIFO almost full interrupt and reset watermark */
+
+  putreg32(1 << (rid + 9), SCU_INT_DISABLE_MAIN);
+  putreg32(0xffff, SCUFIFO_R_CTRL0(rid));
+  priv->wm[rid].fifo = NULL;
+
+  scustream_stop(&fifo->stream);
+
+  leave_critical_section(flags);
+
+  if (fifo->wakelock)
+    {
+      up_pm_release_wakelock(&fifo->wlock);
+      fifo->wakelock = false;
+    }
+}
+
+/****************************************************************************
+ * Name: seq_setstream
+ *
+ * Description:
+ *   Start or stop FIFO streaming. The watermark is set to one block and each
+ *   watermark interrupt chains DMA transfer into the next free block.
+ *
+ ****************************************************************************/
+
+static int seq_setstream(FAR struct seq_s *seq, int fifoid,
+                         FAR struct scufifo_stream_s *st)
+{
+  FAR struct cxd56_scudev_s *priv = &g_scudev;
+  FAR struct scufifo_s *fifo = seq_getfifo(seq, fifoid);
+  FAR struct wm_notify_s *notify;
+  irqstate_t flags;
+  uint32_t align;
+  int maxlen;
+  int rid;
+  int ret;
+
+  DEBUGASSERT(fifo);
+
+  if (st == NULL)
+    {
+      seq_streamstop(fifo);
+      return OK;
+    }
+
+  if (fifo->stream.active)
+    {
+      return -EBUSY;
+    }
+
+  /* One block must be done by one DMA transfer, select transfer size same
+   * as seq_read().
+   */
+
+  align = st->blocksize | (uint32_t)(uintptr_t)st->buffer;
+  if (align & 1)
+    {
+      fifo->streamxfer = CXD56_UDMA_XFERSIZE_BYTE;
+      maxlen = 1024;
+    }
+  else if (align & 2)
+    {
+      fifo->streamxfer = CXD56_UDMA_XFERSIZE_HWORD;
+      maxlen = 2048;
+    }
+  else
+    {
+      fifo->streamxfer = CXD56_UDMA_XFERSIZE_WORD;
+      maxlen = 4096;
+    }
+
+  if (st->blocksize > maxlen || st->blocksize > fifo->size)
+    {
+      return -EINVAL;
+    }
+
+  /* Keep CPU awake while streaming, instead of every read */
+
+  if (((uint32_t)st->buffer >= CXD56_RAM_BASE)
+   && ((uint32_t)st->buffer <= (CXD56_RAM_BASE + CXD56_RAM_SIZE)))
+    {
+      fifo->wlock.info = PM_CPUWAKELOCK_TAG('S', 'C', 0);
+      fifo->wlock.count = 0;
+      up_pm_acquire_wakelock(&fifo->wlock);
+      fifo->wakelock = true;
+    }
+
+  ret = scustream_start(&fifo->stream, st, seq->sample);
+  if (ret < 0)
+    {
+      if (fifo->wakelock)
+        {
+          up_pm_release_wakelock(&fifo->wlock);
+          fifo->wakelock = false;
+        }
+
+      return ret;
+    }
+
+  rid = fifo->rid;
+  notify = &priv->wm[rid];
+
+  flags = enter_critical_section();
+  notify->signo = 0;
+  notify->pid = 0;
+  notify->ts = NULL;
+  notify->fifo = fifo;
+
+  /* Set watermark to one block and enable FIFO almost full interrupt */
+
+  putreg32(st->blocksize / seq->sample, SCUFIFO_R_CTRL0(rid));
+  putreg32(1 << (rid + 9), SCU_INT_ENABLE_MAIN);
+
+  leave_critical_section(flags);
+
+  scuinfo("stream %d x %d bytes, rid = %d\n", st->nblocks, st->blocksize,
+          rid);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: seq_waitstream
+ *
+ * Description:
+ *   Wait for completed stream blocks
+ *
+ ****************************************************************************/
+
+static int seq_waitstream(FAR struct seq_s *seq, int fifoid,
+                          FAR struct scufifo_streamstat_s *stat)
+{
+  FAR struct scufifo_s *fifo = seq_getfifo(seq, fifoid);
+
+  DEBUGASSERT(fifo);
+
+  return scustream_wait(&fifo->stream, stat);
+}
+
+/****************************************************************************
+ * Name: seq_relstream
+ *
+ * Description:
+ *   Give back completed stream blocks
+ *
+ ****************************************************************************/
+
+static int seq_relstream(FAR struct seq_s *seq, int fifoid, int nblocks)
+{
+  FAR struct scufifo_s *fifo = seq_getfifo(seq, fifoid);
+
+  DEBUGASSERT(fifo);
+
+  return scustream_release(&fifo->stream, nblocks);
+}
+#else
+#  define seq_setstream(seq, fifoid, st) (-ENOSYS)
+#  define seq_waitstream(seq, fifoid, stat) (-ENOSYS)
+#  define seq_relstream(seq, fifoid, nblocks) (-ENOSYS)
+#endif
+
 /****************************************************************************
  * Name: seq_read
  *
@@ -2938,6 +3269,15 @@ int seq_read(FAR struct seq_s *seq, int fifoid, FAR char *buffer, int length)
 
   DEBUGASSERT(fifo);
 
+#ifdef CONFIG_CXD56_SCU_STREAM
+  /* FIFO data is owned by the stream */
+
+  if (fifo->stream.active)
+    {
+      return -EBUSY;
+    }
+#endif
+
   outlet = SCUFIFO_FIFO_DATA(fifo->rid);
 
   avail = getreg32(SCUFIFO_R_STATUS0(fifo->rid));
@@ -3310,6 +3650,39 @@ int seq_ioctl(FAR struct seq_s *seq, int fifoid, int cmd, unsigned long arg)
         }
         break;
 
+      /* Start or stop FIFO streaming
+       * Arg: Pointer of struct scufifo_stream_s, NULL to stop */
+
+      case SCUIOC_SETSTREAM:
+        {
+          FAR struct scufifo_stream_s *st =
+            (FAR struct scufifo_stream_s *)(uintptr_t)arg;
+
+          ret = seq_setstream(seq, fifoid, st);
+        }
+        break;
+
+      /* Wait for completed stream blocks
+       * Arg: Pointer of struct scufifo_streamstat_s */
+
+      case SCUIOC_WAITSTREAM:
+        {
+          FAR struct scufifo_streamstat_s *stat =
+            (FAR struct scufifo_streamstat_s *)(uintptr_t)arg;
+
+          ret = seq_waitstream(seq, fifoid, stat);
+        }
+        break;
+
+      /* Give back completed stream blocks
+       * Arg: Number of blocks */
+
+      case SCUIOC_RELSTREAM:
+        {
+          ret = seq_relstream(seq, fifoid, (int)arg);
+        }
+        break;
+
       default:
         scuerr("Unrecognized cmd: %d\n", cmd);
         ret = -EIO;
@@ -0,0 +1,355 @@
+/****************************************************************************
+ * bsp/src/cxd56_scustream.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/*-----------------------------------------------------------------------------
+ * include files
+ *---------------------------------------------------------------------------*/
+
+#include <sdk/config.h>
+#include <nuttx/irq.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <arch/chip/cxd56_scu.h>
+
+#include "cxd56_scustream.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Transfer state */
+
+#define STREAM_IDLE    0
+#define STREAM_FILL    1 /* Filling head block */
+#define STREAM_DISCARD 2 /* Ring is full, dropping one block from FIFO */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: scustream_initialize
+ ****************************************************************************/
+
+void scustream_initialize(FAR struct scustream_s *stream,
+                          FAR const struct scustream_ops_s *ops,
+                          FAR void *arg)
+{
+  memset(stream, 0, sizeof(struct scustream_s));
+
+  stream->ops = ops;
+  stream->arg = arg;
+
+  sem_init(&stream->wait, 0, 0);
+}
+
+/****************************************************************************
+ * Name: scustream_uninitialize
+ ****************************************************************************/
+
+void scustream_uninitialize(FAR struct scustream_s *stream)
+{
+  DEBUGASSERT(!stream->active);
+
+  sem_destroy(&stream->wait);
+}
+
+/****************************************************************************
+ * Name: scustream_start
+ ****************************************************************************/
+
+int scustream_start(FAR struct scustream_s *stream,
+                    FAR const struct scufifo_stream_s *cfg, uint8_t sample)
+{
+  irqstate_t flags;
+
+  if (!cfg->buffer || !cfg->blocks || cfg->nblocks < 2 || sample == 0 ||
+      cfg->blocksize == 0 || (cfg->blocksize % sample) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if (stream->active)
+    {
+      return -EBUSY;
+    }
+
+  flags = enter_critical_section();
+
+  stream->buffer = cfg->buffer;
+  stream->blocks = cfg->blocks;
+  stream->blocksize = cfg->blocksize;
+  stream->wmsamples = cfg->blocksize / sample;
+  stream->nblocks = cfg->nblocks;
+
+  stream->head = 0;
+  stream->tail = 0;
+  stream->count = 0;
+  stream->state = STREAM_IDLE;
+  stream->waiting = false;
+
+  stream->seqno = 0;
+  stream->completed = 0;
+  stream->overruns = 0;
+  stream->errors = 0;
+  stream->fifooverruns = 0;
+
+  stream->active = true;
+
+  leave_critical_section(flags);
+
+  /* FIFO may already hold a block before the watermark interrupt enabled */
+
+  scustream_kick(stream);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: scustream_stop
+ ****************************************************************************/
+
+void scustream_stop(FAR struct scustream_s *stream)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (stream->state != STREAM_IDLE)
+    {
+      stream->ops->dmastop(stream->arg);
+      stream->state = STREAM_IDLE;
+    }
+
+  stream->active = false;
+
+  if (stream->waiting)
+    {
+      stream->waiting = false;
+      sem_post(&stream->wait);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: scustream_kick
+ ****************************************************************************/
+
+void scustream_kick(FAR struct scustream_s *stream)
+{
+  FAR struct scufifo_block_s *blk;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (!stream->active || stream->state != STREAM_IDLE ||
+      stream->ops->available(stream->arg) < stream->wmsamples)
+    {
+      leave_critical_section(flags);
+      return;
+    }
+
+  if (stream->count < stream->nblocks)
+    {
+      /* The head of FIFO becomes the first sample of the block */
+
+      blk = &stream->blocks[stream->head];
+      stream->ops->gettimestamp(stream->arg, &blk->ts);
+      blk->seqno = stream->seqno;
+
+      stream->state = STREAM_FILL;
+      stream->ops->dmastart(stream->arg,
+                            stream->buffer +
+                            stream->head * stream->blocksize,
+                            stream->blocksize);
+    }
+  else
+    {
+      /* No free block, drop one block of samples to keep FIFO from
+       * overrun. The reader finds the lost block by skipped seqno.
+       */
+
+      stream->state = STREAM_DISCARD;
+      stream->ops->dmastart(stream->arg, NULL, stream->blocksize);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: scustream_dmadone
+ ****************************************************************************/
+
+void scustream_dmadone(FAR struct scustream_s *stream, int result)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (stream->state == STREAM_FILL)
+    {
+      if (result == 0)
+        {
+          stream->head = (stream->head + 1) % stream->nblocks;
+          stream->count++;
+          stream->completed++;
+
+          if (stream->waiting)
+            {
+              stream->waiting = false;
+              sem_post(&stream->wait);
+            }
+        }
+      else
+        {
+          stream->errors++;
+        }
+    }
+  else if (stream->state == STREAM_DISCARD)
+    {
+      stream->overruns++;
+    }
+  else
+    {
+      /* Stopped while transfer in progress */
+
+      leave_critical_section(flags);
+      return;
+    }
+
+  stream->seqno++;
+  stream->state = STREAM_IDLE;
+
+  leave_critical_section(flags);
+
+  /* Next block may be already in FIFO, its watermark interrupt has been
+   * raised while this transfer was in progress.
+   */
+
+  scustream_kick(stream);
+}
+
+/****************************************************************************
+ * Name: scustream_fifooverrun
+ ****************************************************************************/
+
+void scustream_fifooverrun(FAR struct scustream_s *stream)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (stream->active)
+    {
+      stream->fifooverruns++;
+    }
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: scustream_wait
+ ****************************************************************************/
+
+int scustream_wait(FAR struct scustream_s *stream,
+                   FAR struct scufifo_streamstat_s *stat)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+
+  while (stream->active && stream->count == 0)
+    {
+      stream->waiting = true;
+      leave_critical_section(flags);
+
+      while (sem_wait(&stream->wait) != 0)
+        {
+          DEBUGASSERT(errno == EINTR);
+        }
+
+      flags = enter_critical_section();
+    }
+
+  if (stream->count == 0)
+    {
+      ret = -ECANCELED;
+    }
+
+  if (stat)
+    {
+      stat->index = stream->tail;
+      stat->count = stream->count;
+      stat->completed = stream->completed;
+      stat->overruns = stream->overruns;
+      stat->errors = stream->errors;
+      stat->fifooverruns = stream->fifooverruns;
+    }
+
+  leave_critical_section(flags);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: scustream_release
+ ****************************************************************************/
+
+int scustream_release(FAR struct scustream_s *stream, int nblocks)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (nblocks < 0 || nblocks > stream->count)
+    {
+      leave_critical_section(flags);
+      return -EINVAL;
+    }
+
+  stream->tail = (stream->tail + nblocks) % stream->nblocks;
+  stream->count -= nblocks;
+
+  leave_critical_section(flags);
+
+  return OK;
+}
@@ -0,0 +1,220 @@
+/****************************************************************************
+ * bsp/src/cxd56_scustream.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_CXD56XX_CXD56_SCUSTREAM_H
+#define __ARCH_ARM_SRC_CXD56XX_CXD56_SCUSTREAM_H
+
+/*-----------------------------------------------------------------------------
+ * include files
+ *---------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+
+#include <arch/chip/cxd56_scu.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* FIFO and DMA access used by the stream. All operations are called in a
+ * critical section, dmastart() must not wait for the transfer.
+ */
+
+struct scustream_ops_s
+{
+  /* Number of samples in FIFO */
+
+  uint16_t (*available)(FAR void *arg);
+
+  /* Timestamp of the head of FIFO */
+
+  void (*gettimestamp)(FAR void *arg, FAR struct scutimestamp_s *ts);
+
+  /* Start transfer of len bytes from FIFO to dst. If dst is NULL, the data
+   * is discarded. scustream_dmadone() must be called when it is done.
+   */
+
+  void (*dmastart)(FAR void *arg, FAR char *dst, uint16_t len);
+
+  /* Cancel the transfer in progress */
+
+  void (*dmastop)(FAR void *arg);
+};
+
+/* Stream instance */
+
+struct scustream_s
+{
+  FAR const struct scustream_ops_s *ops;
+  FAR void *arg;                      /* Argument for ops */
+
+  FAR char *buffer;                   /* Block memory */
+  FAR struct scufifo_block_s *blocks; /* Block descriptors */
+  uint16_t blocksize;                 /* Bytes per block */
+  uint16_t wmsamples;                 /* Samples per block */
+  uint8_t nblocks;                    /* Number of blocks */
+
+  uint8_t head;                       /* Next block to be filled */
+  uint8_t tail;                       /* Oldest completed block */
+  uint8_t count;                      /* Completed and not released */
+  uint8_t state;                      /* Transfer in progress */
+  bool active;                        /* Streaming */
+  bool waiting;                       /* Reader waits for wait semaphore */
+
+  uint32_t seqno;                     /* Sequence number of next block */
+  uint32_t completed;                 /* Statistics */
+  uint32_t overruns;
+  uint32_t errors;
+  uint32_t fifooverruns;
+
+  sem_t wait;                         /* Wait for completed block */
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: scustream_initialize
+ *
+ * Description:
+ *   Initialize stream instance
+ *
+ ****************************************************************************/
+
+void scustream_initialize(FAR struct scustream_s *stream,
+                          FAR const struct scustream_ops_s *ops,
+                          FAR void *arg);
+
+/****************************************************************************
+ * Name: scustream_uninitialize
+ *
+ * Description:
+ *   Uninitialize stream instance. Stream must be stopped.
+ *
+ ****************************************************************************/
+
+void scustream_uninitialize(FAR struct scustream_s *stream);
+
+/****************************************************************************
+ * Name: scustream_start
+ *
+ * Description:
+ *   Start streaming into the ring of blocks.
+ *
+ * Input Parameters:
+ *   stream - Stream instance
+ *   cfg    - Application supplied blocks
+ *   sample - Bytes per sample
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success. A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int scustream_start(FAR struct scustream_s *stream,
+                    FAR const struct scufifo_stream_s *cfg, uint8_t sample);
+
+/****************************************************************************
+ * Name: scustream_stop
+ *
+ * Description:
+ *   Stop streaming, cancel the transfer in progress and wake up the reader.
+ *
+ ****************************************************************************/
+
+void scustream_stop(FAR struct scustream_s *stream);
+
+/****************************************************************************
+ * Name: scustream_kick
+ *
+ * Description:
+ *   Start the transfer of next block if FIFO holds one and no transfer is in
+ *   progress. Called from FIFO watermark interrupt.
+ *
+ ****************************************************************************/
+
+void scustream_kick(FAR struct scustream_s *stream);
+
+/****************************************************************************
+ * Name: scustream_dmadone
+ *
+ * Description:
+ *   Complete the transfer in progress and chain the next one. Called from
+ *   DMA done interrupt.
+ *
+ ****************************************************************************/
+
+void scustream_dmadone(FAR struct scustream_s *stream, int result);
+
+/****************************************************************************
+ * Name: scustream_fifooverrun
+ *
+ * Description:
+ *   Count FIFO overrun error. Called from FIFO error interrupt.
+ *
+ ****************************************************************************/
+
+void scustream_fifooverrun(FAR struct scustream_s *stream);
+
+/****************************************************************************
+ * Name: scustream_wait
+ *
+ * Description:
+ *   Wait for at least one completed block.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success. -ECANCELED is returned when the stream
+ *   has been stopped.
+ *
+ ****************************************************************************/
+
+int scustream_wait(FAR struct scustream_s *stream,
+                   FAR struct scufifo_streamstat_s *stat);
+
+/****************************************************************************
+ * Name: scustream_release
+ *
+ * Description:
+ *   Give back the oldest nblocks completed blocks.
+ *
+ ****************************************************************************/
+
+int scustream_release(FAR struct scustream_s *stream, int nblocks);
+
+#endif /* __ARCH_ARM_SRC_CXD56XX_CXD56_SCUSTREAM_H */
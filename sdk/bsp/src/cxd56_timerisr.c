@@ -57,6 +57,10 @@
 
 #include "chip.h"
 
+#ifdef CONFIG_CXD56_SYSTICK_PCHOOK
+#  include <arch/chip/timer.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -145,6 +149,12 @@ static int cxd56_changeclock(uint8_t id)
 
 static int cxd56_timerisr(int irq, uint32_t *regs, FAR void *arg)
 {
+#ifdef CONFIG_CXD56_SYSTICK_PCHOOK
+  /* Report the PC saved on the interrupt entry */
+
+  board_systick_pchook(regs[REG_PC]);
+#endif
+
   /* Process timer interrupt */
 
   sched_process_timer();
@@ -0,0 +1,585 @@
+/****************************************************************************
+ * bsp/src/host/ge2dbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark for the GE2D command queue.  An engine thread walks the
+ *   descriptor lists started by cxd56_ge2dqueue.c with a fixed cost per
+ *   start and per command, and completes them as the interrupt handler
+ *   does.  The application builds small lists with a given CPU cost and
+ *   submits them.
+ *
+ *   With -m sync every list is submitted and waited for, as write() did
+ *   before.  With -m queue up to -r lists are in flight, lists queued
+ *   behind a running one are chained.  -m nochain is the same without the
+ *   chain buffer.
+ *
+ *   Each command carries the number of its list, the execution order and
+ *   the completion callbacks are verified.  -e injects a bus error into a
+ *   list and -x stops the engine after submitting a list.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <nuttx/irq.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <debug.h>
+
+#include <arch/chip/ge2d.h>
+
+#include "cxd56_ge2dqueue.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SIM_COPYCMD   0x4     /* Command codes of imageproc.c */
+#define SIM_ROPCMD    0x8
+#define SIM_ABCMD     0xa
+
+#define SIM_CMDSIZE   32
+#define SIM_BUSERR    1       /* Command flag to raise a bus error */
+
+#define MODE_SYNC     0
+#define MODE_QUEUE    1
+#define MODE_NOCHAIN  2
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct simge2d_s
+{
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  const uint8_t *desc;        /* Started list, NULL if idle */
+  uint32_t gen;               /* Incremented by stop */
+  bool quit;
+  uint64_t busyns;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static pthread_mutex_t g_critsect = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+static struct simge2d_s g_engine =
+{
+  PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER
+};
+
+static struct ge2dq_s g_queue;
+static uint8_t g_chain[1024] __attribute__((aligned(16)));
+
+static int g_mode = MODE_QUEUE;
+static uint32_t g_njobs = 20000;
+static uint32_t g_ring = 8;
+static uint32_t g_ncmds = 1;
+static uint32_t g_startus = 20;
+static uint32_t g_cmdus = 10;
+static uint32_t g_prepus = 5;
+static int32_t g_errjob = -1;
+static int32_t g_stopjob = -1;
+
+/* Verification, written by the engine and the callbacks */
+
+static uint32_t *g_exec;
+static uint32_t g_nexec;
+static int *g_result;
+static uint8_t *g_ncalls;
+static uint32_t g_nextdone;
+static uint32_t g_orderr;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void spin_us(uint32_t us)
+{
+  uint64_t end = now_ns() + us * 1000ull;
+
+  while (now_ns() < end);
+}
+
+static uint32_t cmd_size(const uint8_t *p)
+{
+  switch (*(const uint16_t *)p & 0xf)
+    {
+      case SIM_COPYCMD:
+      case SIM_ABCMD:
+        return 32;
+
+      case SIM_ROPCMD:
+        return 48;
+
+      default:
+        return 0;
+    }
+}
+
+static void *engine_thread(void *arg)
+{
+  const uint8_t *p;
+  uint32_t size;
+  uint32_t gen;
+  uint64_t t0;
+  bool stopped;
+  int result;
+
+  for (; ; )
+    {
+      pthread_mutex_lock(&g_engine.lock);
+      while (!g_engine.desc && !g_engine.quit)
+        {
+          pthread_cond_wait(&g_engine.cond, &g_engine.lock);
+        }
+
+      if (g_engine.quit)
+        {
+          pthread_mutex_unlock(&g_engine.lock);
+          break;
+        }
+
+      p   = g_engine.desc;
+      gen = g_engine.gen;
+      pthread_mutex_unlock(&g_engine.lock);
+
+      t0 = now_ns();
+      spin_us(g_startus);
+      result  = OK;
+      stopped = false;
+
+      /* Commands are fetched under the lock, stop waits for the fetch */
+
+      for (; ; )
+        {
+          pthread_mutex_lock(&g_engine.lock);
+          stopped = gen != g_engine.gen;
+          size    = stopped ? 0 : cmd_size(p);
+          if (size > 0)
+            {
+              g_exec[g_nexec++] = *(const uint32_t *)(p + 4);
+              if (*(const uint32_t *)(p + 8) & SIM_BUSERR)
+                {
+                  result = -EIO;
+                }
+            }
+
+          pthread_mutex_unlock(&g_engine.lock);
+
+          if (size == 0)
+            {
+              break;
+            }
+
+          spin_us(g_cmdus);
+          p += size;
+        }
+
+      /* Interrupt */
+
+      enter_critical_section();
+      pthread_mutex_lock(&g_engine.lock);
+      g_engine.busyns += now_ns() - t0;
+      if (!stopped && gen == g_engine.gen)
+        {
+          g_engine.desc = NULL;
+        }
+      else
+        {
+          stopped = true;
+        }
+
+      pthread_mutex_unlock(&g_engine.lock);
+
+      if (!stopped)
+        {
+          ge2dq_complete(&g_queue, result);
+        }
+
+      leave_critical_section(0);
+    }
+
+  return NULL;
+}
+
+static void sim_start(FAR void *arg, FAR const void *desc)
+{
+  pthread_mutex_lock(&g_engine.lock);
+  DEBUGASSERT(g_engine.desc == NULL);
+  g_engine.desc = (const uint8_t *)desc;
+  pthread_cond_signal(&g_engine.cond);
+  pthread_mutex_unlock(&g_engine.lock);
+}
+
+static void sim_stop(FAR void *arg)
+{
+  pthread_mutex_lock(&g_engine.lock);
+  g_engine.gen++;
+  g_engine.desc = NULL;
+  pthread_mutex_unlock(&g_engine.lock);
+}
+
+static const struct ge2dq_ops_s g_simops =
+{
+  .start = sim_start,
+  .stop  = sim_stop,
+};
+
+static void job_done(FAR struct ge2d_job_s *job, int result)
+{
+  uint32_t no = (uint32_t)(uintptr_t)job->arg;
+
+  if (no != g_nextdone++)
+    {
+      g_orderr++;
+    }
+
+  g_ncalls[no]++;
+  g_result[no] = result;
+}
+
+static void build_list(uint8_t *desc, uint32_t no)
+{
+  uint32_t i;
+
+  memset(desc, 0, g_ncmds * SIM_CMDSIZE + GE2DQ_HALTSIZE);
+  for (i = 0; i < g_ncmds; i++, desc += SIM_CMDSIZE)
+    {
+      *(uint16_t *)desc = SIM_COPYCMD;
+      *(uint32_t *)(desc + 4) = no;
+      if ((int32_t)no == g_errjob)
+        {
+          *(uint32_t *)(desc + 8) = SIM_BUSERR;
+        }
+    }
+}
+
+static int verify(void)
+{
+  uint32_t ok = 0;
+  uint32_t eio = 0;
+  uint32_t canceled = 0;
+  uint32_t lasteio = 0;
+  uint32_t i;
+  int ret = OK;
+
+  for (i = 0; i < g_njobs; i++)
+    {
+      if (g_ncalls[i] != 1)
+        {
+          printf("verify: list %u called back %u times\n", i, g_ncalls[i]);
+          return ERROR;
+        }
+
+      switch (g_result[i])
+        {
+          case OK:
+            ok++;
+            break;
+
+          case -EIO:
+            if (eio > 0 && lasteio != i - 1)
+              {
+                printf("verify: failed lists are not contiguous\n");
+                ret = ERROR;
+              }
+
+            eio++;
+            lasteio = i;
+            break;
+
+          case -ECANCELED:
+            if ((int32_t)i > g_stopjob ||
+                (i > 0 && g_result[i - 1] == OK && canceled > 0))
+              {
+                printf("verify: list %u canceled out of order\n", i);
+                ret = ERROR;
+              }
+
+            canceled++;
+            break;
+        }
+    }
+
+  if (g_orderr > 0)
+    {
+      printf("verify: %u callbacks out of order\n", g_orderr);
+      ret = ERROR;
+    }
+
+  if (g_errjob >= 0 && (eio == 0 || g_result[g_errjob] != -EIO))
+    {
+      printf("verify: injected error not reported\n");
+      ret = ERROR;
+    }
+
+  /* Commands run in submission order, every command of a completed list */
+
+  for (i = 1; i < g_nexec; i++)
+    {
+      if (g_exec[i] < g_exec[i - 1])
+        {
+          printf("verify: list %u run after %u\n", g_exec[i], g_exec[i - 1]);
+          ret = ERROR;
+          break;
+        }
+    }
+
+  if (g_stopjob < 0 && g_nexec != g_njobs * g_ncmds)
+    {
+      printf("verify: %u commands run, expected %u\n", g_nexec,
+             g_njobs * g_ncmds);
+      ret = ERROR;
+    }
+
+  printf("verify: %s, %u ok, %u failed, %u canceled\n",
+         ret == OK ? "OK" : "FAILED", ok, eio, canceled);
+  return ret;
+}
+
+static void show_usage(FAR const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-m sync|queue|nochain] [-n <lists>] "
+                  "[-r <inflight>] [-k <cmds>] [-s <us>] [-c <us>] "
+                  "[-p <us>] [-e <list>] [-x <list>]\n", progname);
+  fprintf(stderr, "\t-m: Submission mode. Default: queue\n");
+  fprintf(stderr, "\t-n: Number of lists. Default: %u\n", g_njobs);
+  fprintf(stderr, "\t-r: Lists in flight. Default: %u\n", g_ring);
+  fprintf(stderr, "\t-k: Commands per list. Default: %u\n", g_ncmds);
+  fprintf(stderr, "\t-s: Engine start cost in us. Default: %u\n",
+                  g_startus);
+  fprintf(stderr, "\t-c: Engine cost per command in us. Default: %u\n",
+                  g_cmdus);
+  fprintf(stderr, "\t-p: CPU cost to build a list in us. Default: %u\n",
+                  g_prepus);
+  fprintf(stderr, "\t-e: Inject a bus error into a list\n");
+  fprintf(stderr, "\t-x: Stop the engine after submitting a list\n");
+  exit(errcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+irqstate_t enter_critical_section(void)
+{
+  pthread_mutex_lock(&g_critsect);
+  return 0;
+}
+
+void leave_critical_section(irqstate_t flags)
+{
+  pthread_mutex_unlock(&g_critsect);
+}
+
+int main(int argc, FAR char **argv)
+{
+  struct ge2d_status_s status;
+  struct ge2d_job_s *jobs;
+  pthread_t engine;
+  uint8_t *descs;
+  uint32_t listsize;
+  uint32_t i;
+  uint64_t t0;
+  double elapsed;
+  int option;
+  int ret;
+
+  while ((option = getopt(argc, argv, ":m:n:r:k:s:c:p:e:x:h")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'm':
+            g_mode = strcmp(optarg, "sync") == 0 ? MODE_SYNC :
+                     strcmp(optarg, "nochain") == 0 ? MODE_NOCHAIN :
+                     MODE_QUEUE;
+            break;
+
+          case 'n':
+            g_njobs = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'r':
+            g_ring = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'k':
+            g_ncmds = strtoul(optarg, NULL, 0);
+            break;
+
+          case 's':
+            g_startus = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'c':
+            g_cmdus = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'p':
+            g_prepus = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'e':
+            g_errjob = strtol(optarg, NULL, 0);
+            break;
+
+          case 'x':
+            g_stopjob = strtol(optarg, NULL, 0);
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (g_njobs == 0 || g_ring == 0 || g_ncmds == 0)
+    {
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+
+  if (g_mode == MODE_SYNC)
+    {
+      g_ring = 1;
+    }
+
+  listsize = g_ncmds * SIM_CMDSIZE + GE2DQ_HALTSIZE;
+  descs    = (uint8_t *)aligned_alloc(16, g_ring * listsize);
+  jobs     = (struct ge2d_job_s *)calloc(g_ring, sizeof(struct ge2d_job_s));
+  g_exec   = (uint32_t *)calloc(g_njobs * g_ncmds, sizeof(uint32_t));
+  g_result = (int *)calloc(g_njobs, sizeof(int));
+  g_ncalls = (uint8_t *)calloc(g_njobs, 1);
+
+  ge2dq_initialize(&g_queue, &g_simops, NULL,
+                   g_mode == MODE_NOCHAIN ? NULL : g_chain,
+                   g_mode == MODE_NOCHAIN ? 0 : sizeof(g_chain));
+
+  pthread_create(&engine, NULL, engine_thread, NULL);
+
+  t0 = now_ns();
+
+  for (i = 0; i < g_njobs; i++)
+    {
+      struct ge2d_job_s *job = &jobs[i % g_ring];
+      uint8_t *desc = descs + (i % g_ring) * listsize;
+
+      /* Reuse the list of the oldest job in flight */
+
+      if (i >= g_ring)
+        {
+          ge2dq_wait(&g_queue, job->fence);
+        }
+
+      spin_us(g_prepus);
+      build_list(desc, i);
+
+      job->desc     = desc;
+      job->len      = listsize;
+      job->callback = job_done;
+      job->arg      = (FAR void *)(uintptr_t)i;
+
+      ret = ge2dq_submit(&g_queue, job);
+      if (ret < 0)
+        {
+          fprintf(stderr, "ERROR: ge2dq_submit: %d\n", ret);
+          return EXIT_FAILURE;
+        }
+
+      if (g_mode == MODE_SYNC)
+        {
+          ge2dq_wait(&g_queue, job->fence);
+        }
+
+      if ((int32_t)i == g_stopjob)
+        {
+          ge2dq_stop(&g_queue);
+        }
+    }
+
+  ge2dq_wait(&g_queue, g_queue.submitted);
+  elapsed = (double)(now_ns() - t0) / 1e9;
+
+  pthread_mutex_lock(&g_engine.lock);
+  g_engine.quit = true;
+  pthread_cond_signal(&g_engine.cond);
+  pthread_mutex_unlock(&g_engine.lock);
+  pthread_join(engine, NULL);
+
+  ge2dq_status(&g_queue, &status);
+
+  printf("%s: %u lists of %u commands in %.3f sec: %.0f lists/sec\n",
+         g_mode == MODE_SYNC ? "sync" :
+         g_mode == MODE_QUEUE ? "queue" : "nochain",
+         g_njobs, g_ncmds, elapsed, g_njobs / elapsed);
+  printf("engine: %u starts, %u chained, %.1f%% busy, %u errors, "
+         "%u canceled\n", status.starts, status.chained,
+         100.0 * g_engine.busyns / 1e9 / elapsed, status.errors,
+         status.canceled);
+
+  ret = verify();
+
+  ge2dq_uninitialize(&g_queue);
+  free(descs);
+  free(jobs);
+  free(g_exec);
+  free(g_result);
+  free(g_ncalls);
+
+  return ret == OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
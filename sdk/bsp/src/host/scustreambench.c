@@ -0,0 +1,754 @@
+/****************************************************************************
+ * bsp/src/host/scustreambench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark for the SCU FIFO stream.  A sensor thread pushes samples
+ *   into a simulated FIFO at a fixed rate and raises the watermark
+ *   interrupt, a DMA thread moves data out of the FIFO at a fixed bandwidth
+ *   and calls the DMA done callback.  The application thread stores each
+ *   block with a given cost and stalls periodically, as logging to a SD
+ *   card does.
+ *
+ *   With -m read the application waits for the watermark and reads by the
+ *   blocking DMA loop of seq_read().  With -m stream cxd56_scustream.c
+ *   chains the transfers into a ring of blocks.  Each sample carries its
+ *   number, so that lost samples, block sequence numbers and timestamps
+ *   are verified.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <nuttx/irq.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <debug.h>
+
+#include <arch/chip/cxd56_scu.h>
+
+#include "cxd56_scustream.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SIM_TICK_US      500     /* Sensor thread period */
+#define SIM_DMAMAXLEN    4096    /* One uDMA transfer in words */
+
+#ifndef MIN
+#  define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct simfifo_s
+{
+  uint8_t *mem;
+  uint32_t size;      /* Bytes */
+  uint32_t rd;
+  uint32_t level;     /* Bytes */
+  uint32_t nextno;    /* Number of the next sample to be pushed */
+  uint32_t lost;      /* Samples dropped for FIFO full */
+  uint32_t errors;    /* FIFO overrun errors */
+  bool overrun;
+};
+
+struct simdma_s
+{
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  char *dst;
+  uint16_t len;
+  bool pending;
+  bool cancel;
+  void (*done)(int result);
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static pthread_mutex_t g_critsect = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+static struct simfifo_s g_fifo;
+static struct simdma_s g_dma =
+{
+  PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER
+};
+
+static struct scustream_s g_stream;
+static sem_t g_wmsignal;   /* Watermark signal for read mode */
+static sem_t g_dmawait;    /* DMA done for read mode */
+static volatile bool g_running;
+static bool g_streammode = true;
+
+static uint32_t g_rate = 1600;          /* Samples per second */
+static uint32_t g_sample = 6;           /* Bytes per sample */
+static uint32_t g_blocksize = 1200;     /* Bytes per block (watermark) */
+static uint32_t g_nblocks = 8;
+static uint32_t g_fifosize = 1920;
+static uint32_t g_bandwidth = 8000000;  /* DMA bytes per second */
+static uint32_t g_writeus = 2000;       /* Store cost per block */
+static uint32_t g_stallus = 300000;     /* Store stall */
+static uint32_t g_stallevery = 16;      /* Blocks between stalls */
+
+/* Application side results */
+
+static uint32_t g_delivered;
+static uint32_t g_expectno;
+static uint32_t g_gaps;
+static uint32_t g_badsamples;
+static uint32_t g_badts;
+static uint32_t g_badseqno;
+static uint64_t g_waitns;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void sleep_ns(uint64_t ns)
+{
+  struct timespec ts;
+
+  ts.tv_sec = ns / 1000000000ull;
+  ts.tv_nsec = ns % 1000000000ull;
+  nanosleep(&ts, NULL);
+}
+
+static void sample_timestamp(uint32_t no, FAR struct scutimestamp_s *ts)
+{
+  uint64_t ticks = (uint64_t)no * 32768 / g_rate;
+
+  ts->sec = ticks >> 15;
+  ts->tick = ticks & 0x7fff;
+}
+
+/* Simulated FIFO *********************************************************/
+
+static void fifo_push(uint32_t no)
+{
+  uint32_t wr;
+  uint32_t i;
+
+  if (g_fifo.level + g_sample > g_fifo.size)
+    {
+      g_fifo.lost++;
+      g_fifo.overrun = true;
+      return;
+    }
+
+  wr = (g_fifo.rd + g_fifo.level) % g_fifo.size;
+  for (i = 0; i < g_sample; i++)
+    {
+      g_fifo.mem[(wr + i) % g_fifo.size] =
+        i < 4 ? (uint8_t)(no >> (i * 8)) : (uint8_t)(no + i);
+    }
+
+  g_fifo.level += g_sample;
+}
+
+static void fifo_pop(FAR char *dst, uint32_t len)
+{
+  uint32_t i;
+
+  for (i = 0; i < len; i++)
+    {
+      if (dst)
+        {
+          dst[i] = g_fifo.mem[g_fifo.rd];
+        }
+
+      g_fifo.rd = (g_fifo.rd + 1) % g_fifo.size;
+    }
+
+  g_fifo.level -= len;
+}
+
+static uint32_t fifo_headno(void)
+{
+  uint32_t no = 0;
+  int i;
+
+  for (i = 3; i >= 0; i--)
+    {
+      no = no << 8 | g_fifo.mem[(g_fifo.rd + i) % g_fifo.size];
+    }
+
+  return no;
+}
+
+static void *sensor_thread(void *arg)
+{
+  uint64_t start = now_ns();
+  uint32_t wm = g_blocksize / g_sample;
+  uint32_t due;
+  uint32_t prev;
+
+  while (g_running)
+    {
+      sleep_ns(SIM_TICK_US * 1000ull);
+
+      due = (uint32_t)((now_ns() - start) * g_rate / 1000000000ull);
+
+      enter_critical_section();
+
+      prev = g_fifo.level / g_sample;
+      while (g_fifo.nextno < due)
+        {
+          fifo_push(g_fifo.nextno++);
+        }
+
+      if (g_fifo.overrun)
+        {
+          g_fifo.overrun = false;
+          g_fifo.errors++;
+          if (g_streammode)
+            {
+              scustream_fifooverrun(&g_stream);
+            }
+        }
+
+      /* FIFO almost full interrupt */
+
+      if (prev < wm && g_fifo.level / g_sample >= wm)
+        {
+          if (g_streammode)
+            {
+              scustream_kick(&g_stream);
+            }
+          else
+            {
+              sem_post(&g_wmsignal);
+            }
+        }
+
+      leave_critical_section(0);
+    }
+
+  return NULL;
+}
+
+/* Simulated DMA **********************************************************/
+
+static void dma_start(FAR char *dst, uint16_t len, void (*done)(int result))
+{
+  pthread_mutex_lock(&g_dma.lock);
+  g_dma.dst = dst;
+  g_dma.len = len;
+  g_dma.done = done;
+  g_dma.cancel = false;
+  g_dma.pending = true;
+  pthread_cond_signal(&g_dma.cond);
+  pthread_mutex_unlock(&g_dma.lock);
+}
+
+static void *dma_thread(void *arg)
+{
+  void (*done)(int result);
+  FAR char *dst;
+  uint16_t len;
+
+  for (; ; )
+    {
+      pthread_mutex_lock(&g_dma.lock);
+      while (!g_dma.pending)
+        {
+          pthread_cond_wait(&g_dma.cond, &g_dma.lock);
+        }
+
+      dst = g_dma.dst;
+      len = g_dma.len;
+      done = g_dma.done;
+      pthread_mutex_unlock(&g_dma.lock);
+
+      if (done == NULL)
+        {
+          break;
+        }
+
+      sleep_ns((uint64_t)len * 1000000000ull / g_bandwidth);
+
+      enter_critical_section();
+      pthread_mutex_lock(&g_dma.lock);
+      g_dma.pending = false;
+      if (g_dma.cancel)
+        {
+          done = NULL;
+        }
+      pthread_mutex_unlock(&g_dma.lock);
+
+      if (done)
+        {
+          DEBUGASSERT(g_fifo.level >= len);
+          fifo_pop(dst, len);
+        }
+      leave_critical_section(0);
+
+      /* Done interrupt */
+
+      if (done)
+        {
+          done(0);
+        }
+    }
+
+  return NULL;
+}
+
+/* Stream backend *********************************************************/
+
+static void stream_dmadone(int result)
+{
+  scustream_dmadone(&g_stream, result);
+}
+
+static uint16_t stream_available(FAR void *arg)
+{
+  uint16_t n;
+
+  enter_critical_section();
+  n = g_fifo.level / g_sample;
+  leave_critical_section(0);
+  return n;
+}
+
+static void stream_gettimestamp(FAR void *arg, FAR struct scutimestamp_s *ts)
+{
+  sample_timestamp(fifo_headno(), ts);
+}
+
+static void stream_dmastart(FAR void *arg, FAR char *dst, uint16_t len)
+{
+  dma_start(dst, len, stream_dmadone);
+}
+
+static void stream_dmastop(FAR void *arg)
+{
+  pthread_mutex_lock(&g_dma.lock);
+  g_dma.cancel = true;
+  pthread_mutex_unlock(&g_dma.lock);
+}
+
+static const struct scustream_ops_s g_simops =
+{
+  .available    = stream_available,
+  .gettimestamp = stream_gettimestamp,
+  .dmastart     = stream_dmastart,
+  .dmastop      = stream_dmastop,
+};
+
+/* seq_read() of the read mode ********************************************/
+
+static void read_dmadone(int result)
+{
+  sem_post(&g_dmawait);
+}
+
+static int sim_read(FAR char *buffer, int length)
+{
+  uint64_t start;
+  int avail;
+  int dmalen;
+  int rest;
+
+  enter_critical_section();
+  avail = g_fifo.level / g_sample * g_sample;
+  leave_critical_section(0);
+
+  length = MIN(avail, length);
+
+  start = now_ns();
+  for (rest = length; rest > 0; rest -= dmalen)
+    {
+      dmalen = MIN(rest, SIM_DMAMAXLEN);
+      dma_start(buffer, dmalen, read_dmadone);
+      while (sem_wait(&g_dmawait) != 0);
+      buffer += dmalen;
+    }
+
+  g_waitns += now_ns() - start;
+  return length;
+}
+
+/* Application ************************************************************/
+
+static uint32_t sample_no(FAR const char *p)
+{
+  FAR const uint8_t *s = (FAR const uint8_t *)p;
+
+  return s[0] | s[1] << 8 | s[2] << 16 | (uint32_t)s[3] << 24;
+}
+
+static void store_block(FAR const char *data, int len,
+                        FAR const struct scufifo_block_s *blk)
+{
+  static uint32_t nblocks;
+  static uint32_t seqno;
+  struct scutimestamp_s ts;
+  uint32_t first = sample_no(data);
+  uint32_t no;
+  uint32_t i;
+  uint32_t j;
+
+  /* Sample numbers must increase, skipped numbers are lost samples */
+
+  for (i = 0, no = g_expectno; i < len / g_sample; i++, no++)
+    {
+      FAR const char *s = data + i * g_sample;
+
+      if (sample_no(s) < no)
+        {
+          g_badsamples++;
+          continue;
+        }
+
+      g_gaps += sample_no(s) - no;
+      no = sample_no(s);
+
+      for (j = 4; j < g_sample; j++)
+        {
+          if ((uint8_t)s[j] != (uint8_t)(no + j))
+            {
+              g_badsamples++;
+            }
+        }
+    }
+
+  if (blk)
+    {
+      sample_timestamp(first, &ts);
+      if (ts.sec != blk->ts.sec || ts.tick != blk->ts.tick)
+        {
+          g_badts++;
+        }
+
+      /* Each skipped seqno is one block of lost samples */
+
+      if (blk->seqno < seqno ||
+          (blk->seqno - seqno) * (g_blocksize / g_sample) >
+          first - g_expectno)
+        {
+          g_badseqno++;
+        }
+
+      seqno = blk->seqno + 1;
+    }
+
+  g_expectno = no;
+  g_delivered += len / g_sample;
+
+  /* Storing cost */
+
+  sleep_ns(g_writeus * 1000ull);
+  if (g_stallevery && ++nblocks % g_stallevery == 0)
+    {
+      sleep_ns(g_stallus * 1000ull);
+    }
+}
+
+static void *app_thread(void *arg)
+{
+  struct scufifo_streamstat_s stat;
+  struct timespec abstime;
+  FAR char *buffer;
+  uint32_t avail;
+  int len;
+
+  if (g_streammode)
+    {
+      /* Stream is stopped at the end of benchmark */
+
+      while (scustream_wait(&g_stream, &stat) == OK)
+        {
+          store_block(g_stream.buffer + stat.index * g_blocksize,
+                      g_blocksize, &g_stream.blocks[stat.index]);
+          scustream_release(&g_stream, 1);
+        }
+
+      return NULL;
+    }
+
+  buffer = (FAR char *)malloc(g_blocksize);
+
+  while (g_running)
+    {
+      clock_gettime(CLOCK_REALTIME, &abstime);
+      abstime.tv_nsec += 100000000;
+      if (abstime.tv_nsec >= 1000000000)
+        {
+          abstime.tv_sec++;
+          abstime.tv_nsec -= 1000000000;
+        }
+
+      if (sem_timedwait(&g_wmsignal, &abstime) != 0)
+        {
+          continue;
+        }
+
+      for (; ; )
+        {
+          enter_critical_section();
+          avail = g_fifo.level;
+          leave_critical_section(0);
+
+          if (avail < g_blocksize)
+            {
+              break;
+            }
+
+          len = sim_read(buffer, g_blocksize);
+          store_block(buffer, len, NULL);
+        }
+    }
+
+  free(buffer);
+  return NULL;
+}
+
+static void show_usage(FAR const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-m read|stream] [-r <rate>] [-z <sample>] "
+                  "[-b <blocksize>] [-n <nblocks>] [-f <fifosize>] "
+                  "[-w <us>] [-s <us>] [-e <blocks>] [-d <sec>]\n",
+                  progname);
+  fprintf(stderr, "\t-m: Blocking read or stream. Default: stream\n");
+  fprintf(stderr, "\t-r: Samples per second. Default: %u\n", g_rate);
+  fprintf(stderr, "\t-z: Bytes per sample (>= 4). Default: %u\n", g_sample);
+  fprintf(stderr, "\t-b: Bytes per block. Default: %u\n", g_blocksize);
+  fprintf(stderr, "\t-n: Blocks in ring. Default: %u\n", g_nblocks);
+  fprintf(stderr, "\t-f: FIFO size in bytes. Default: %u\n", g_fifosize);
+  fprintf(stderr, "\t-w: Store cost per block in us. Default: %u\n",
+                  g_writeus);
+  fprintf(stderr, "\t-s: Store stall in us. Default: %u\n", g_stallus);
+  fprintf(stderr, "\t-e: Blocks between stalls, 0 for none. Default: %u\n",
+                  g_stallevery);
+  fprintf(stderr, "\t-d: Duration in seconds. Default: 3\n");
+  exit(errcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+irqstate_t enter_critical_section(void)
+{
+  pthread_mutex_lock(&g_critsect);
+  return 0;
+}
+
+void leave_critical_section(irqstate_t flags)
+{
+  pthread_mutex_unlock(&g_critsect);
+}
+
+int main(int argc, FAR char **argv)
+{
+  struct scufifo_streamstat_s stat;
+  struct scufifo_stream_s cfg;
+  pthread_t sensor;
+  pthread_t dma;
+  pthread_t app;
+  uint32_t duration = 3;
+  uint32_t produced;
+  uint32_t inflight;
+  int option;
+  int ret;
+
+  while ((option = getopt(argc, argv, ":m:r:z:b:n:f:w:s:e:d:h")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'm':
+            g_streammode = strcmp(optarg, "read") != 0;
+            break;
+
+          case 'r':
+            g_rate = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'z':
+            g_sample = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'b':
+            g_blocksize = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'n':
+            g_nblocks = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'f':
+            g_fifosize = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'w':
+            g_writeus = strtoul(optarg, NULL, 0);
+            break;
+
+          case 's':
+            g_stallus = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'e':
+            g_stallevery = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'd':
+            duration = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (g_sample < 4 || g_rate == 0 || g_blocksize > SIM_DMAMAXLEN ||
+      g_blocksize > g_fifosize)
+    {
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+
+  g_fifo.size = g_fifosize / g_sample * g_sample;
+  g_fifo.mem = (uint8_t *)malloc(g_fifo.size);
+  sem_init(&g_wmsignal, 0, 0);
+  sem_init(&g_dmawait, 0, 0);
+
+  scustream_initialize(&g_stream, &g_simops, NULL);
+
+  if (g_streammode)
+    {
+      cfg.buffer = (FAR char *)malloc(g_nblocks * g_blocksize);
+      cfg.blocks = (FAR struct scufifo_block_s *)
+        calloc(g_nblocks, sizeof(struct scufifo_block_s));
+      cfg.blocksize = g_blocksize;
+      cfg.nblocks = g_nblocks;
+
+      ret = scustream_start(&g_stream, &cfg, g_sample);
+      if (ret < 0)
+        {
+          fprintf(stderr, "ERROR: scustream_start: %d\n", ret);
+          return EXIT_FAILURE;
+        }
+    }
+
+  g_running = true;
+  pthread_create(&dma, NULL, dma_thread, NULL);
+  pthread_create(&app, NULL, app_thread, NULL);
+  pthread_create(&sensor, NULL, sensor_thread, NULL);
+
+  sleep(duration);
+
+  g_running = false;
+  pthread_join(sensor, NULL);
+
+  if (g_streammode)
+    {
+      /* Let the application store the completed blocks, then stop */
+
+      do
+        {
+          sleep_ns(10000000);
+          enter_critical_section();
+          inflight = g_stream.count;
+          leave_critical_section(0);
+        }
+      while (inflight > 0);
+
+      scustream_stop(&g_stream);
+    }
+
+  pthread_join(app, NULL);
+
+  dma_start(NULL, 0, NULL);
+  pthread_join(dma, NULL);
+
+  produced = g_fifo.nextno;
+  inflight = produced - g_delivered - g_gaps;
+
+  printf("%s: %u Hz x %u bytes, block %u bytes, %s%u blocks, "
+         "store %u us, stall %u us / %u blocks\n",
+         g_streammode ? "stream" : "read", g_rate, g_sample, g_blocksize,
+         g_streammode ? "ring " : "", g_streammode ? g_nblocks : 1,
+         g_writeus, g_stallus, g_stallevery);
+  printf("  produced %u, delivered %u (%.1f KiB/s), lost %u "
+         "(FIFO overflow %u in %u overruns)\n",
+         produced, g_delivered,
+         (double)g_delivered * g_sample / 1024.0 / duration,
+         g_gaps, g_fifo.lost, g_fifo.errors);
+
+  if (g_streammode)
+    {
+      scustream_wait(&g_stream, &stat);
+      printf("  blocks %u, dropped %u, DMA errors %u, FIFO overruns %u\n",
+             stat.completed, stat.overruns, stat.errors, stat.fifooverruns);
+    }
+  else
+    {
+      printf("  application blocked in read %.1f ms\n", g_waitns / 1e6);
+    }
+
+  ret = g_badsamples || g_badts || g_badseqno ? EXIT_FAILURE : EXIT_SUCCESS;
+  printf("  verify: %s (samples %u, timestamps %u, seqno %u, "
+         "not delivered %u)\n", ret == EXIT_SUCCESS ? "OK" : "NG",
+         g_badsamples, g_badts, g_badseqno, inflight);
+
+  scustream_uninitialize(&g_stream);
+  return ret;
+}
@@ -0,0 +1,612 @@
+/****************************************************************************
+ * drivers/lcd/host/lcdfbbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark for the ILI9340 driver with and without the frame buffer
+ *   of CONFIG_LCD_FBCACHE.  The driver runs against a panel which records
+ *   the command and pixel stream and keeps a model of the GRAM.  Typical UI
+ *   update patterns are drawn with putrun() one row at a time as NX does,
+ *   and the commands, bytes and DMA bursts per frame are reported together
+ *   with the resulting SPI time.  The GRAM model is compared with the drawn
+ *   image after each pattern.
+ *
+ *   With -t the widget pattern is drawn as fast as possible for the given
+ *   time while the panel consumes the SPI time in real time, to show the
+ *   update rate of the drawing side and of the panel.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <nuttx/lcd/lcd.h>
+#include <nuttx/lcd/ili9340.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define XRES            240
+#define YRES            320
+#define NFRAMES         30
+
+/* SPI time model: one byte per command or parameter, two bytes per pixel,
+ * plus the D/C switching of each command and the setup and completion of
+ * each DMA transfer.
+ */
+
+#define CMD_OVERHEAD_NS 1000
+#define DMA_OVERHEAD_NS 10000
+
+#ifdef CONFIG_LCD_FBCACHE
+#  ifdef CONFIG_LCD_FBCACHE_DOUBLEBUF
+#    define MODE_NAME   "fbcache-double"
+#  else
+#    define MODE_NAME   "fbcache"
+#  endif
+#else
+#  define MODE_NAME     "direct"
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct fakelcd_s
+{
+  struct ili9340_lcd_s dev;
+
+  uint8_t  cmd;
+  uint8_t  nparam;
+  uint8_t  param[4];
+  uint16_t x0;
+  uint16_t x1;
+  uint16_t y0;
+  uint16_t y1;
+  uint16_t cx;
+  uint16_t cy;
+
+  uint32_t cmds;
+  uint32_t params;
+  uint32_t pixels;
+  uint32_t bursts;
+  uint32_t areas;
+  uint64_t busyns;
+  uint64_t debtns;
+};
+
+struct pattern_s
+{
+  const char *name;
+  void (*draw)(int frame);
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct fakelcd_s g_fakelcd;
+static uint16_t g_gram[YRES][XRES];
+static uint16_t g_image[YRES][XRES];
+static struct lcd_planeinfo_s g_pinfo;
+static uint32_t g_spihz = 20000000;
+static bool g_realtime;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Recording panel */
+
+static void fake_spend(struct fakelcd_s *priv, uint32_t bytes,
+                       uint32_t overhead)
+{
+  uint64_t ns = (uint64_t)bytes * 8 * 1000000000 / g_spihz + overhead;
+  struct timespec ts;
+
+  priv->busyns += ns;
+  if (g_realtime)
+    {
+      priv->debtns += ns;
+      if (priv->debtns >= 200000)
+        {
+          ts.tv_sec  = 0;
+          ts.tv_nsec = priv->debtns;
+          nanosleep(&ts, NULL);
+          priv->debtns = 0;
+        }
+    }
+}
+
+static void fake_select(struct ili9340_lcd_s *lcd)
+{
+}
+
+static void fake_deselect(struct ili9340_lcd_s *lcd)
+{
+}
+
+static int fake_sendcmd(struct ili9340_lcd_s *lcd, const uint8_t cmd)
+{
+  struct fakelcd_s *priv = (struct fakelcd_s *)lcd;
+
+  priv->cmd    = cmd;
+  priv->nparam = 0;
+  priv->cmds++;
+
+  if (cmd == ILI9340_MEMORY_WRITE || cmd == ILI9340_MEMORY_READ)
+    {
+      priv->cx = priv->x0;
+      priv->cy = priv->y0;
+      priv->areas++;
+    }
+
+  fake_spend(priv, 1, CMD_OVERHEAD_NS);
+  return OK;
+}
+
+static int fake_sendparam(struct ili9340_lcd_s *lcd, const uint8_t param)
+{
+  struct fakelcd_s *priv = (struct fakelcd_s *)lcd;
+
+  priv->params++;
+  if (priv->nparam < 4)
+    {
+      priv->param[priv->nparam++] = param;
+      if (priv->nparam == 4)
+        {
+          uint16_t a = priv->param[0] << 8 | priv->param[1];
+          uint16_t b = priv->param[2] << 8 | priv->param[3];
+
+          if (priv->cmd == ILI9340_COLUMN_ADDRESS_SET)
+            {
+              priv->x0 = a;
+              priv->x1 = b;
+            }
+          else if (priv->cmd == ILI9340_PAGE_ADDRESS_SET)
+            {
+              priv->y0 = a;
+              priv->y1 = b;
+            }
+        }
+    }
+
+  fake_spend(priv, 1, 0);
+  return OK;
+}
+
+static int fake_recvparam(struct ili9340_lcd_s *lcd, uint8_t *param)
+{
+  *param = 0;
+  return OK;
+}
+
+static uint16_t *fake_next(struct fakelcd_s *priv)
+{
+  uint16_t *p = NULL;
+
+  if (priv->cx < XRES && priv->cy < YRES && priv->cy <= priv->y1)
+    {
+      p = &g_gram[priv->cy][priv->cx];
+    }
+
+  if (++priv->cx > priv->x1)
+    {
+      priv->cx = priv->x0;
+      priv->cy++;
+    }
+
+  return p;
+}
+
+static int fake_sendgram(struct ili9340_lcd_s *lcd, const uint16_t *wd,
+                         uint32_t nwords)
+{
+  struct fakelcd_s *priv = (struct fakelcd_s *)lcd;
+  uint16_t *p;
+  uint32_t i;
+
+  if (priv->cmd == ILI9340_MEMORY_WRITE)
+    {
+      for (i = 0; i < nwords; i++)
+        {
+          if ((p = fake_next(priv)) != NULL)
+            {
+              *p = wd[i];
+            }
+        }
+    }
+
+  priv->pixels += nwords;
+  priv->bursts++;
+  fake_spend(priv, nwords * 2, DMA_OVERHEAD_NS);
+  return OK;
+}
+
+static int fake_recvgram(struct ili9340_lcd_s *lcd, uint16_t *wd,
+                         uint32_t nwords)
+{
+  struct fakelcd_s *priv = (struct fakelcd_s *)lcd;
+  uint16_t *p;
+  uint32_t i;
+
+  for (i = 0; i < nwords; i++)
+    {
+      p = fake_next(priv);
+      wd[i] = p ? *p : 0;
+    }
+
+  fake_spend(priv, nwords * 2, DMA_OVERHEAD_NS);
+  return OK;
+}
+
+static int fake_backlight(struct ili9340_lcd_s *lcd, int level)
+{
+  return OK;
+}
+
+/* Drawing, one putrun() per row like NX */
+
+static uint16_t pixel(int x, int y, int frame)
+{
+  uint32_t v = (uint32_t)x * 2654435761u ^ (uint32_t)y * 40503u ^
+               (uint32_t)frame * 2246822519u;
+
+  return (uint16_t)(v >> 16);
+}
+
+static void fillrect(int x, int y, int w, int h, int frame)
+{
+  uint16_t run[XRES];
+  int i;
+  int j;
+
+  for (j = y; j < y + h; j++)
+    {
+      for (i = 0; i < w; i++)
+        {
+          run[i] = pixel(x + i, j, frame);
+          g_image[j][x + i] = run[i];
+        }
+
+      g_pinfo.putrun(j, x, (const uint8_t *)run, w);
+    }
+}
+
+static void draw_fullscreen(int frame)
+{
+  fillrect(0, 0, XRES, YRES, frame);
+}
+
+static void draw_list(int frame)
+{
+  fillrect(0, 40, XRES, 240, frame);
+}
+
+static void draw_widget(int frame)
+{
+  /* Button and its label */
+
+  fillrect(20, 100, 80, 32, frame);
+  fillrect(110, 108, 120, 16, frame);
+}
+
+static void draw_statusbar(int frame)
+{
+  int i;
+
+  /* Clock digits and battery icon */
+
+  for (i = 0; i < 5; i++)
+    {
+      fillrect(4 + i * 8, 2, 8, 16, frame);
+    }
+
+  fillrect(216, 6, 16, 8, frame);
+}
+
+static void draw_text(int frame)
+{
+  int y = 16 + (frame % 18) * 16;
+  int i;
+
+  /* One line of text, glyph by glyph */
+
+  for (i = 0; i < 28; i++)
+    {
+      fillrect(8 + i * 8, y, 8, 16, frame);
+    }
+}
+
+static void draw_scattered(int frame)
+{
+  uint32_t seed = 12345 + frame;
+  int i;
+
+  /* Sprites or cursors all over the screen */
+
+  for (i = 0; i < 12; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      fillrect((seed >> 8) % (XRES - 8), (seed >> 20) % (YRES - 8), 8, 8,
+               frame);
+    }
+}
+
+static const struct pattern_s g_patterns[] =
+{
+  { "fullscreen", draw_fullscreen },
+  { "list",       draw_list       },
+  { "widget",     draw_widget     },
+  { "statusbar",  draw_statusbar  },
+  { "text",       draw_text       },
+  { "scattered",  draw_scattered  },
+};
+
+#define NPATTERNS (sizeof(g_patterns) / sizeof(g_patterns[0]))
+
+static void reset_counters(void)
+{
+  g_fakelcd.cmds   = 0;
+  g_fakelcd.params = 0;
+  g_fakelcd.pixels = 0;
+  g_fakelcd.bursts = 0;
+  g_fakelcd.areas  = 0;
+  g_fakelcd.busyns = 0;
+}
+
+static void flush(struct lcd_dev_s *dev)
+{
+#ifdef CONFIG_LCD_FBCACHE
+  ili9340_flush(dev);
+#endif
+}
+
+static double elapsed(const struct timespec *start)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)(now.tv_sec - start->tv_sec) +
+         (double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int verify(struct lcd_dev_s *dev)
+{
+  uint16_t run[XRES];
+  int y;
+
+  if (memcmp(g_gram, g_image, sizeof(g_gram)) != 0)
+    {
+      return ERROR;
+    }
+
+  /* getrun() returns what was drawn, from the panel or the frame buffer */
+
+  for (y = 0; y < YRES; y++)
+    {
+      if (g_pinfo.getrun(y, 0, (uint8_t *)run, XRES) != OK ||
+          memcmp(run, g_image[y], sizeof(run)) != 0)
+        {
+          return ERROR;
+        }
+    }
+
+  return OK;
+}
+
+static void show_usage(const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-f <MHz>] [-t <sec>] [-h]\n", progname);
+  fprintf(stderr, "\t-f <MHz>: SPI clock. Default: 20\n");
+  fprintf(stderr, "\t-t <sec>: Draw the widget pattern as fast as possible "
+                  "with the panel\n\t          running in real time\n");
+  fprintf(stderr, "\t-h: Show this text and exit\n");
+  exit(errcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* NuttX tasks on pthreads.  The arguments are copied as task_create()
+ * does, argv[0] of the task is its name.
+ */
+
+struct task_s
+{
+  int (*entry)(int argc, char *argv[]);
+  int argc;
+  char *argv[4];
+};
+
+static void *task_trampoline(void *arg)
+{
+  struct task_s *task = (struct task_s *)arg;
+
+  task->entry(task->argc, task->argv);
+  return NULL;
+}
+
+int task_create(const char *name, int priority, int stack_size,
+                int (*entry)(int argc, char *argv[]), char * const argv[])
+{
+  struct task_s *task;
+  pthread_t id;
+
+  task = calloc(1, sizeof(struct task_s));
+  task->entry   = entry;
+  task->argv[0] = strdup(name);
+  for (task->argc = 1; argv && argv[task->argc - 1] && task->argc < 3;
+       task->argc++)
+    {
+      task->argv[task->argc] = strdup(argv[task->argc - 1]);
+    }
+
+  if (pthread_create(&id, NULL, task_trampoline, task) != 0)
+    {
+      return ERROR;
+    }
+
+  pthread_detach(id);
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  struct lcd_dev_s *dev;
+  struct timespec start;
+  double runtime = 0;
+  double secs;
+  size_t i;
+  int option;
+  int frames;
+  int ret = OK;
+
+  while ((option = getopt(argc, argv, ":f:t:h")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'f':
+            g_spihz = strtoul(optarg, NULL, 0) * 1000000;
+            break;
+
+          case 't':
+            runtime = strtod(optarg, NULL);
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  g_fakelcd.dev.select    = fake_select;
+  g_fakelcd.dev.deselect  = fake_deselect;
+  g_fakelcd.dev.sendcmd   = fake_sendcmd;
+  g_fakelcd.dev.sendparam = fake_sendparam;
+  g_fakelcd.dev.recvparam = fake_recvparam;
+  g_fakelcd.dev.sendgram  = fake_sendgram;
+  g_fakelcd.dev.recvgram  = fake_recvgram;
+  g_fakelcd.dev.backlight = fake_backlight;
+
+  dev = ili9340_initialize(&g_fakelcd.dev, 0);
+  if (!dev || dev->getplaneinfo(dev, 0, &g_pinfo) != OK)
+    {
+      fprintf(stderr, "ERROR: Failed to initialize the driver\n");
+      return EXIT_FAILURE;
+    }
+
+  /* Start from a black screen on both sides */
+
+  for (i = 0; i < YRES; i++)
+    {
+      fillrect(0, i, XRES, 1, -1);
+    }
+
+  flush(dev);
+
+  if (runtime > 0)
+    {
+      reset_counters();
+      g_realtime = true;
+
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      for (frames = 0; (secs = elapsed(&start)) < runtime; frames++)
+        {
+          draw_widget(frames);
+        }
+
+      printf("%-14s freerun: %6.0f updates/s drawn, %5.0f area writes/s, "
+             "SPI busy %3.0f%%\n", MODE_NAME, frames / secs,
+             g_fakelcd.areas / secs, g_fakelcd.busyns / 1e7 / secs);
+
+      g_realtime = false;
+      flush(dev);
+      ret = verify(dev);
+      printf("verify: %s\n", ret == OK ? "OK" : "MISMATCH");
+      return ret == OK ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+  printf("%-14s %-10s %8s %8s %8s %8s %9s\n", MODE_NAME, "pattern",
+         "areas/f", "cmds/f", "bursts/f", "KiB/f", "SPI ms/f");
+
+  for (i = 0; i < NPATTERNS; i++)
+    {
+      struct fakelcd_s stat;
+      int check;
+
+      reset_counters();
+
+      for (frames = 0; frames < NFRAMES; frames++)
+        {
+          g_patterns[i].draw(frames);
+          flush(dev);
+        }
+
+      stat  = g_fakelcd;
+      check = verify(dev);
+      if (check != OK)
+        {
+          ret = ERROR;
+        }
+
+      printf("%-14s %-10s %8.1f %8.1f %8.1f %8.1f %9.2f %s\n", "",
+             g_patterns[i].name,
+             (double)stat.areas / NFRAMES,
+             (double)stat.cmds / NFRAMES,
+             (double)stat.bursts / NFRAMES,
+             (double)(stat.cmds + stat.params + stat.pixels * 2) / 1024 /
+             NFRAMES,
+             (double)stat.busyns / 1e6 / NFRAMES,
+             check == OK ? "OK" : "MISMATCH");
+    }
+
+  return ret == OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,67 @@
+/****************************************************************************
+ * drivers/lcd/host/nuttx/lcd/lcd.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* The subset of the NuttX LCD driver interface used by the LCD drivers. */
+
+#ifndef __DRIVERS_LCD_HOST_NUTTX_LCD_LCD_H
+#define __DRIVERS_LCD_HOST_NUTTX_LCD_LCD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nuttx/video/fb.h>
+
+struct lcd_planeinfo_s
+{
+  int (*putrun)(fb_coord_t row, fb_coord_t col, const uint8_t *buffer,
+                size_t npixels);
+  int (*getrun)(fb_coord_t row, fb_coord_t col, uint8_t *buffer,
+                size_t npixels);
+  uint8_t *buffer;
+  uint8_t  bpp;
+};
+
+struct lcd_dev_s
+{
+  int (*getvideoinfo)(struct lcd_dev_s *dev, struct fb_videoinfo_s *vinfo);
+  int (*getplaneinfo)(struct lcd_dev_s *dev, unsigned int planeno,
+                      struct lcd_planeinfo_s *pinfo);
+  int (*getpower)(struct lcd_dev_s *dev);
+  int (*setpower)(struct lcd_dev_s *dev, int power);
+  int (*getcontrast)(struct lcd_dev_s *dev);
+  int (*setcontrast)(struct lcd_dev_s *dev, unsigned int contrast);
+};
+
+#endif /* __DRIVERS_LCD_HOST_NUTTX_LCD_LCD_H */
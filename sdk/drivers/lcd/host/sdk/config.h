@@ -0,0 +1,70 @@
+/****************************************************************************
+ * drivers/lcd/host/sdk/config.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Minimal configuration for building the ILI9340 driver on the host.  The
+ * frame buffer options are given by the Makefile for each variant of the
+ * benchmark.
+ */
+
+#ifndef __DRIVERS_LCD_HOST_SDK_CONFIG_H
+#define __DRIVERS_LCD_HOST_SDK_CONFIG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+
+#define OK    0
+#define ERROR -1
+#define FAR
+
+#define CONFIG_LCD                          1
+#define CONFIG_LCD_MAXCONTRAST              255
+#define CONFIG_LCD_MAXPOWER                 1
+#define CONFIG_LCD_ILI9340                  1
+#define CONFIG_LCD_ILI9340_NINTERFACES      1
+#define CONFIG_LCD_ILI9340_IFACE0           1
+#define CONFIG_LCD_ILI9340_IFACE0_PORTRAIT  1
+#define CONFIG_LCD_ILI9340_IFACE0_RGB565    1
+
+/* NuttX task interface, run on a pthread by the benchmark */
+
+int task_create(const char *name, int priority, int stack_size,
+                int (*entry)(int argc, char *argv[]), char * const argv[]);
+
+#define SEM_PRIO_NONE           0
+#define sem_setprotocol(s, p)   ((void)(s), (void)(p))
+
+#endif /* __DRIVERS_LCD_HOST_SDK_CONFIG_H */
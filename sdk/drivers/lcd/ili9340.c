@@ -58,6 +58,8 @@
 
 #include <arch/irq.h>
 
+#include "lcd_fbcache.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -414,6 +416,12 @@ struct ili9340_dev_s
   /* Current power state of the device */
 
   uint8_t power;
+
+#ifdef CONFIG_LCD_FBCACHE
+  /* Frame buffer in front of the panel */
+
+  struct lcd_fbcache_s fbcache;
+#endif
 };
 
 
@@ -613,6 +621,48 @@ static void ili9340_selectarea(FAR struct ili9340_lcd_s *lcd,
   lcd->sendparam(lcd, (y1 & 0xff));
 }
 
+#ifdef CONFIG_LCD_FBCACHE
+/****************************************************************************
+ * Name:  ili9340_fbbegin, ili9340_fbsend, ili9340_fbend
+ *
+ * Description:
+ *   Panel access for the frame buffer flush task.  A rectangle is written
+ *   by one area select and memory write command followed by the pixels.
+ *
+ ****************************************************************************/
+
+static void ili9340_fbbegin(FAR void *arg, FAR const struct lcd_fbrect_s *rect)
+{
+  FAR struct ili9340_lcd_s *lcd = ((FAR struct ili9340_dev_s *)arg)->lcd;
+
+  lcd->select(lcd);
+  ili9340_selectarea(lcd, rect->x0, rect->y0, rect->x1, rect->y1);
+  lcd->sendcmd(lcd, ILI9340_MEMORY_WRITE);
+}
+
+static void ili9340_fbsend(FAR void *arg, FAR const uint16_t *wd,
+                           uint32_t nwords)
+{
+  FAR struct ili9340_lcd_s *lcd = ((FAR struct ili9340_dev_s *)arg)->lcd;
+
+  lcd->sendgram(lcd, wd, nwords);
+}
+
+static void ili9340_fbend(FAR void *arg)
+{
+  FAR struct ili9340_lcd_s *lcd = ((FAR struct ili9340_dev_s *)arg)->lcd;
+
+  lcd->deselect(lcd);
+}
+
+static const struct lcd_fbcache_ops_s g_fbcacheops =
+{
+  .begin = ili9340_fbbegin,
+  .send  = ili9340_fbsend,
+  .end   = ili9340_fbend,
+};
+#endif
+
 
 /****************************************************************************
  * Name:  ili9340_putrun
@@ -639,8 +689,10 @@ static int ili9340_putrun(int devno, fb_coord_t row, fb_coord_t col,
                             FAR const uint8_t * buffer, size_t npixels)
 {
   FAR struct ili9340_dev_s *dev = &g_lcddev[devno];
+#ifndef CONFIG_LCD_FBCACHE
   FAR struct ili9340_lcd_s *lcd = dev->lcd;
   FAR const uint16_t *src = (FAR const uint16_t *)buffer;
+#endif
 
   DEBUGASSERT(buffer && ((uintptr_t)buffer & 1) == 0);
 
@@ -650,6 +702,11 @@ static int ili9340_putrun(int devno, fb_coord_t row, fb_coord_t col,
       return -EINVAL;
     }
 
+#ifdef CONFIG_LCD_FBCACHE
+  /* Draw into the frame buffer, the flush task updates the panel */
+
+  return lcd_fbcache_putrun(&dev->fbcache, row, col, buffer, npixels);
+#else
   /* Select lcd driver */
 
   lcd->select(lcd);
@@ -671,6 +728,7 @@ static int ili9340_putrun(int devno, fb_coord_t row, fb_coord_t col,
   lcd->deselect(lcd);
 
   return OK;
+#endif
 }
 
 
@@ -700,8 +758,10 @@ static int ili9340_getrun(int devno, fb_coord_t row, fb_coord_t col,
                             FAR uint8_t * buffer, size_t npixels)
 {
   FAR struct ili9340_dev_s *dev = &g_lcddev[devno];
+#ifndef CONFIG_LCD_FBCACHE
   FAR struct ili9340_lcd_s *lcd = dev->lcd;
   FAR uint16_t *dest = (FAR uint16_t *)buffer;
+#endif
 
   DEBUGASSERT(buffer && ((uintptr_t)buffer & 1) == 0);
 
@@ -711,6 +771,11 @@ static int ili9340_getrun(int devno, fb_coord_t row, fb_coord_t col,
       return -EINVAL;
     }
 
+#ifdef CONFIG_LCD_FBCACHE
+  /* The frame buffer may be ahead of the panel */
+
+  return lcd_fbcache_getrun(&dev->fbcache, row, col, buffer, npixels);
+#else
   /* Select lcd driver */
 
   lcd->select(lcd);
@@ -732,6 +797,7 @@ static int ili9340_getrun(int devno, fb_coord_t row, fb_coord_t col,
   lcd->deselect(lcd);
 
   return OK;
+#endif
 }
 #endif
 
@@ -1171,6 +1237,17 @@ FAR struct lcd_dev_s *ili9340_initialize(
 
           ret = ili9340_hwinitialize(priv);
 
+#ifdef CONFIG_LCD_FBCACHE
+          if (ret == OK)
+            {
+              /* Put the frame buffer in front of the panel */
+
+              ret = lcd_fbcache_initialize(&priv->fbcache, &g_fbcacheops,
+                                           priv, ili9340_getxres(priv),
+                                           ili9340_getyres(priv));
+            }
+#endif
+
           if (ret == OK)
             {
               return &priv->dev;
@@ -1208,15 +1285,20 @@ int ili9340_clear(FAR struct lcd_dev_s *dev, uint16_t color)
 {
   FAR struct ili9340_dev_s *priv = (FAR struct ili9340_dev_s *)dev;
   FAR struct ili9340_lcd_s *lcd = priv->lcd;
+#ifndef CONFIG_LCD_FBCACHE
   uint16_t xres = ili9340_getxres(priv);
   uint16_t yres = ili9340_getyres(priv);
   uint32_t n;
+#endif
 
   if (!lcd)
     {
       return -EINVAL;
     }
 
+#ifdef CONFIG_LCD_FBCACHE
+  return lcd_fbcache_fill(&priv->fbcache, color);
+#else
   /* Select lcd driver */
 
   lcd->select(lcd);
@@ -1243,4 +1325,37 @@ int ili9340_clear(FAR struct lcd_dev_s *dev, uint16_t color)
   lcd->deselect(lcd);
 
   return OK;
+#endif
 }
+
+
+/****************************************************************************
+ * Name:  ili9340_flush
+ *
+ * Description:
+ *   This is a non-standard LCD interface.  Write the changes held in the
+ *   frame buffer to the panel now and wait for completion.
+ *
+ * Parameter:
+ *   dev   - A reference to the lcd driver structure
+ *
+ * Returned Value:
+ *
+ *  On success - OK
+ *  On error   - -EINVAL
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LCD_FBCACHE
+int ili9340_flush(FAR struct lcd_dev_s *dev)
+{
+  FAR struct ili9340_dev_s *priv = (FAR struct ili9340_dev_s *)dev;
+
+  if (!priv->lcd)
+    {
+      return -EINVAL;
+    }
+
+  return lcd_fbcache_flush(&priv->fbcache);
+}
+#endif
@@ -0,0 +1,717 @@
+/****************************************************************************
+ * drivers/lcd/lcd_fbcache.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "lcd_fbcache.h"
+
+#ifdef CONFIG_LCD_FBCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_LCD_FBCACHE_PRIORITY
+#  define CONFIG_LCD_FBCACHE_PRIORITY 100
+#endif
+
+#ifndef CONFIG_LCD_FBCACHE_STACKSIZE
+#  define CONFIG_LCD_FBCACHE_STACKSIZE 1024
+#endif
+
+/* Two dirty rectangles are merged into their bounding box when the box
+ * has at most this many pixels more than the two of them.  Sending a few
+ * clean pixels again costs less than another area select and DMA setup.
+ */
+
+#define LCD_FBCACHE_MERGESLACK 64
+
+#define RECT_WIDTH(r)  ((uint32_t)(r)->x1 - (r)->x0 + 1)
+#define RECT_HEIGHT(r) ((uint32_t)(r)->y1 - (r)->y0 + 1)
+#define RECT_AREA(r)   (RECT_WIDTH(r) * RECT_HEIGHT(r))
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+#ifndef MAX
+#  define MAX(a,b) ((a) > (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lcd_fbcache_semtake
+ ****************************************************************************/
+
+static void lcd_fbcache_semtake(FAR sem_t *sem)
+{
+  while (sem_wait(sem) != 0)
+    {
+      DEBUGASSERT(errno == EINTR);
+    }
+}
+
+/****************************************************************************
+ * Name: lcd_fbcache_union
+ *
+ * Description:
+ *   Get the bounding box of two rectangles and the number of pixels in it
+ *   which are covered by neither of them.
+ *
+ ****************************************************************************/
+
+static uint32_t lcd_fbcache_union(FAR const struct lcd_fbrect_s *a,
+                                  FAR const struct lcd_fbrect_s *b,
+                                  FAR struct lcd_fbrect_s *u)
+{
+  struct lcd_fbrect_s i;
+  uint32_t overlap = 0;
+
+  u->x0 = MIN(a->x0, b->x0);
+  u->y0 = MIN(a->y0, b->y0);
+  u->x1 = MAX(a->x1, b->x1);
+  u->y1 = MAX(a->y1, b->y1);
+
+  i.x0 = MAX(a->x0, b->x0);
+  i.y0 = MAX(a->y0, b->y0);
+  i.x1 = MIN(a->x1, b->x1);
+  i.y1 = MIN(a->y1, b->y1);
+
+  if (i.x0 <= i.x1 && i.y0 <= i.y1)
+    {
+      overlap = RECT_AREA(&i);
+    }
+
+  return RECT_AREA(u) - RECT_AREA(a) - RECT_AREA(b) + overlap;
+}
+
+/****************************************************************************
+ * Name: lcd_fbcache_adddirty
+ *
+ * Description:
+ *   Add a rectangle to the dirty list.  It is merged with the rectangle
+ *   which wastes the fewest pixels when that is within
+ *   LCD_FBCACHE_MERGESLACK, and the merged rectangle is tried against the
+ *   others again.  When the list is full, the pair of rectangles which
+ *   wastes the fewest pixels is merged to make room.  Must be called with
+ *   exclsem held.
+ *
+ ****************************************************************************/
+
+static void lcd_fbcache_adddirty(FAR struct lcd_fbcache_s *fb,
+                                 FAR const struct lcd_fbrect_s *rect)
+{
+  FAR struct lcd_fbrect_s *d = fb->dirty;
+  struct lcd_fbrect_s r = *rect;
+  struct lcd_fbrect_s u;
+  uint32_t waste;
+  uint32_t best;
+  int besti;
+  int bestj;
+  int i;
+  int j;
+
+  for (; ; )
+    {
+      besti = -1;
+      best  = UINT32_MAX;
+
+      for (i = 0; i < fb->ndirty; i++)
+        {
+          if (d[i].x0 <= r.x0 && d[i].y0 <= r.y0 &&
+              d[i].x1 >= r.x1 && d[i].y1 >= r.y1)
+            {
+              return;
+            }
+
+          waste = lcd_fbcache_union(&d[i], &r, &u);
+          if (waste < best)
+            {
+              best  = waste;
+              besti = i;
+            }
+        }
+
+      if (besti >= 0 && best <= LCD_FBCACHE_MERGESLACK)
+        {
+          /* Take the candidate out of the list and retry with the union */
+
+          (void)lcd_fbcache_union(&d[besti], &r, &r);
+          d[besti] = d[--fb->ndirty];
+          continue;
+        }
+
+      if (fb->ndirty < CONFIG_LCD_FBCACHE_NRECTS)
+        {
+          d[fb->ndirty++] = r;
+          return;
+        }
+
+      /* The list is full, find the cheapest pair within the list */
+
+      bestj = -1;
+      for (i = 0; i < fb->ndirty; i++)
+        {
+          for (j = i + 1; j < fb->ndirty; j++)
+            {
+              waste = lcd_fbcache_union(&d[i], &d[j], &u);
+              if (waste < best)
+                {
+                  best  = waste;
+                  besti = i;
+                  bestj = j;
+                }
+            }
+        }
+
+      if (bestj < 0)
+        {
+          (void)lcd_fbcache_union(&d[besti], &r, &r);
+          d[besti] = d[--fb->ndirty];
+        }
+      else
+        {
+          (void)lcd_fbcache_union(&d[besti], &d[bestj], &d[besti]);
+          d[bestj] = d[--fb->ndirty];
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: lcd_fbcache_kick
+ *
+ * Description:
+ *   Wake up the flush task for new dirty rectangles.  Must be called with
+ *   exclsem held.
+ *
+ ****************************************************************************/
+
+static void lcd_fbcache_kick(FAR struct lcd_fbcache_s *fb)
+{
+  if (!fb->pending)
+    {
+      fb->pending = true;
+      sem_post(&fb->kicksem);
+    }
+}
+
+#ifdef CONFIG_LCD_FBCACHE_DOUBLEBUF
+/****************************************************************************
+ * Name: lcd_fbcache_copyrect
+ ****************************************************************************/
+
+static void lcd_fbcache_copyrect(FAR struct lcd_fbcache_s *fb,
+                                 FAR uint16_t *dst, FAR const uint16_t *src,
+                                 FAR const struct lcd_fbrect_s *rect)
+{
+  uint32_t offset = (uint32_t)rect->y0 * fb->xres + rect->x0;
+  uint32_t width  = RECT_WIDTH(rect);
+  uint32_t y;
+
+  for (y = rect->y0; y <= rect->y1; y++, offset += fb->xres)
+    {
+      memcpy(&dst[offset], &src[offset], width * sizeof(uint16_t));
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: lcd_fbcache_sendrect
+ *
+ * Description:
+ *   Write one rectangle of the frame buffer to the panel with a single
+ *   area select.  Full width rectangles are contiguous in the frame buffer
+ *   and are sent in one burst, the rows of other rectangles are packed
+ *   into the staging buffer to send as many rows as fit at a time.
+ *
+ ****************************************************************************/
+
+static void lcd_fbcache_sendrect(FAR struct lcd_fbcache_s *fb,
+                                 FAR const uint16_t *src,
+                                 FAR const struct lcd_fbrect_s *rect)
+{
+  FAR const uint16_t *row;
+  uint32_t width  = RECT_WIDTH(rect);
+  uint32_t height = RECT_HEIGHT(rect);
+  uint32_t nrows;
+  uint32_t n;
+  uint32_t i;
+
+  row = &src[(uint32_t)rect->y0 * fb->xres + rect->x0];
+  nrows = fb->stage ? fb->stagelen / width : 0;
+
+  fb->ops->begin(fb->arg, rect);
+
+  if (width == fb->xres)
+    {
+      fb->ops->send(fb->arg, row, width * height);
+      fb->stat.bursts++;
+    }
+  else if (nrows <= 1)
+    {
+      for (i = 0; i < height; i++, row += fb->xres)
+        {
+          fb->ops->send(fb->arg, row, width);
+          fb->stat.bursts++;
+        }
+    }
+  else
+    {
+      while (height > 0)
+        {
+          n = MIN(nrows, height);
+          for (i = 0; i < n; i++, row += fb->xres)
+            {
+              memcpy(&fb->stage[i * width], row, width * sizeof(uint16_t));
+            }
+
+          fb->ops->send(fb->arg, fb->stage, width * n);
+          fb->stat.bursts++;
+          height -= n;
+        }
+    }
+
+  fb->ops->end(fb->arg);
+
+  fb->stat.rects++;
+  fb->stat.pixels += RECT_AREA(rect);
+}
+
+/****************************************************************************
+ * Name: lcd_fbcache_thread
+ *
+ * Description:
+ *   Flush task.  After being kicked it waits for the frame interval, so
+ *   that the drawing side can complete the frame and the panel is updated
+ *   at most once per interval, then takes the dirty list and writes the
+ *   rectangles from top to bottom, following the scan direction of the
+ *   panel.  With double buffering the drawing side continues on the other
+ *   buffer during the transfer and the panel never shows a half drawn
+ *   frame.
+ *
+ ****************************************************************************/
+
+static int lcd_fbcache_thread(int argc, FAR char *argv[])
+{
+  FAR struct lcd_fbcache_s *fb;
+  FAR const uint16_t *front;
+  struct lcd_fbrect_s rects[CONFIG_LCD_FBCACHE_NRECTS];
+  struct lcd_fbrect_s tmp;
+  struct timespec deadline;
+  uint32_t gen;
+  bool wait;
+  int nrects;
+  int i;
+  int j;
+
+  DEBUGASSERT(argc == 2);
+  fb = (FAR struct lcd_fbcache_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+
+  for (; ; )
+    {
+      lcd_fbcache_semtake(&fb->kicksem);
+
+      clock_gettime(CLOCK_REALTIME, &deadline);
+      deadline.tv_nsec += CONFIG_LCD_FBCACHE_INTERVAL * 1000000;
+      deadline.tv_sec  += deadline.tv_nsec / 1000000000;
+      deadline.tv_nsec %= 1000000000;
+
+      /* Further kicks only come from lcd_fbcache_flush() and
+       * lcd_fbcache_uninitialize() to cut the wait short.
+       */
+
+      for (; ; )
+        {
+          lcd_fbcache_semtake(&fb->exclsem);
+          wait = !fb->urgent && !fb->stop;
+          sem_post(&fb->exclsem);
+
+          if (!wait || (sem_timedwait(&fb->kicksem, &deadline) != 0 &&
+                        errno == ETIMEDOUT))
+            {
+              break;
+            }
+        }
+
+      /* Take the dirty list */
+
+      lcd_fbcache_semtake(&fb->exclsem);
+
+      if (fb->stop)
+        {
+          sem_post(&fb->exclsem);
+          break;
+        }
+
+      nrects = fb->ndirty;
+      memcpy(rects, fb->dirty, nrects * sizeof(struct lcd_fbrect_s));
+      fb->ndirty  = 0;
+      fb->pending = false;
+      fb->urgent  = false;
+      gen         = ++fb->gen;
+
+#ifdef CONFIG_LCD_FBCACHE_DOUBLEBUF
+      /* Swap the buffers and bring the new back buffer up to date, both
+       * are identical outside of the dirty rectangles.
+       */
+
+      front    = fb->fb[fb->back];
+      fb->back ^= 1;
+
+      for (i = 0; i < nrects; i++)
+        {
+          lcd_fbcache_copyrect(fb, fb->fb[fb->back], front, &rects[i]);
+        }
+#else
+      front = fb->fb[0];
+#endif
+
+      sem_post(&fb->exclsem);
+
+      /* Sort by the top row */
+
+      for (i = 1; i < nrects; i++)
+        {
+          tmp = rects[i];
+          for (j = i; j > 0 && rects[j - 1].y0 > tmp.y0; j--)
+            {
+              rects[j] = rects[j - 1];
+            }
+
+          rects[j] = tmp;
+        }
+
+      for (i = 0; i < nrects; i++)
+        {
+          lcd_fbcache_sendrect(fb, front, &rects[i]);
+        }
+
+      /* Release the tasks waiting for this frame */
+
+      lcd_fbcache_semtake(&fb->exclsem);
+
+      fb->flushed = gen;
+      if (nrects > 0)
+        {
+          fb->stat.flushes++;
+        }
+
+      while (fb->nwaiters > 0)
+        {
+          fb->nwaiters--;
+          sem_post(&fb->donesem);
+        }
+
+      sem_post(&fb->exclsem);
+    }
+
+  sem_post(&fb->donesem);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lcd_fbcache_initialize
+ ****************************************************************************/
+
+int lcd_fbcache_initialize(FAR struct lcd_fbcache_s *fb,
+                           FAR const struct lcd_fbcache_ops_s *ops,
+                           FAR void *arg, fb_coord_t xres, fb_coord_t yres)
+{
+  struct lcd_fbrect_s all;
+  FAR char *argv[2];
+  char argstr[2 + 2 * sizeof(uintptr_t) + 1];
+  size_t size = (size_t)xres * yres * sizeof(uint16_t);
+  int i;
+
+  DEBUGASSERT(fb && ops && xres > 0 && yres > 0);
+
+  memset(fb, 0, sizeof(struct lcd_fbcache_s));
+  fb->ops  = ops;
+  fb->arg  = arg;
+  fb->xres = xres;
+  fb->yres = yres;
+
+  for (i = 0; i < LCD_FBCACHE_NBUFFERS; i++)
+    {
+      fb->fb[i] = (FAR uint16_t *)kmm_zalloc(size);
+      if (!fb->fb[i])
+        {
+          goto errout;
+        }
+    }
+
+  fb->stagelen = CONFIG_LCD_FBCACHE_STAGESIZE / sizeof(uint16_t);
+  if (fb->stagelen > 0)
+    {
+      fb->stage = (FAR uint16_t *)kmm_malloc(fb->stagelen *
+                                             sizeof(uint16_t));
+      if (!fb->stage)
+        {
+          goto errout;
+        }
+    }
+
+  sem_init(&fb->exclsem, 0, 1);
+  sem_init(&fb->kicksem, 0, 0);
+  sem_init(&fb->donesem, 0, 0);
+
+  /* The kick and done semaphores are used for signaling */
+
+  sem_setprotocol(&fb->kicksem, SEM_PRIO_NONE);
+  sem_setprotocol(&fb->donesem, SEM_PRIO_NONE);
+
+  /* The frame buffer starts out black, make the panel match it */
+
+  all.x0 = 0;
+  all.y0 = 0;
+  all.x1 = xres - 1;
+  all.y1 = yres - 1;
+  lcd_fbcache_adddirty(fb, &all);
+  lcd_fbcache_kick(fb);
+
+  snprintf(argstr, sizeof(argstr), "%" PRIxPTR, (uintptr_t)fb);
+  argv[0] = argstr;
+  argv[1] = NULL;
+
+  fb->pid = task_create("lcd_fbcache", CONFIG_LCD_FBCACHE_PRIORITY,
+                        CONFIG_LCD_FBCACHE_STACKSIZE, lcd_fbcache_thread,
+                        argv);
+  if (fb->pid < 0)
+    {
+      lcderr("ERROR: Failed to create the flush task\n");
+      sem_destroy(&fb->exclsem);
+      sem_destroy(&fb->kicksem);
+      sem_destroy(&fb->donesem);
+      goto errout;
+    }
+
+  return OK;
+
+errout:
+  for (i = 0; i < LCD_FBCACHE_NBUFFERS; i++)
+    {
+      if (fb->fb[i])
+        {
+          kmm_free(fb->fb[i]);
+          fb->fb[i] = NULL;
+        }
+    }
+
+  if (fb->stage)
+    {
+      kmm_free(fb->stage);
+      fb->stage = NULL;
+    }
+
+  return -ENOMEM;
+}
+
+/****************************************************************************
+ * Name: lcd_fbcache_uninitialize
+ ****************************************************************************/
+
+void lcd_fbcache_uninitialize(FAR struct lcd_fbcache_s *fb)
+{
+  int i;
+
+  lcd_fbcache_semtake(&fb->exclsem);
+  fb->stop = true;
+  sem_post(&fb->kicksem);
+  sem_post(&fb->exclsem);
+
+  /* The flush task posts donesem on exit */
+
+  lcd_fbcache_semtake(&fb->donesem);
+
+  for (i = 0; i < LCD_FBCACHE_NBUFFERS; i++)
+    {
+      kmm_free(fb->fb[i]);
+      fb->fb[i] = NULL;
+    }
+
+  if (fb->stage)
+    {
+      kmm_free(fb->stage);
+      fb->stage = NULL;
+    }
+
+  sem_destroy(&fb->exclsem);
+  sem_destroy(&fb->kicksem);
+  sem_destroy(&fb->donesem);
+}
+
+/****************************************************************************
+ * Name: lcd_fbcache_putrun
+ ****************************************************************************/
+
+int lcd_fbcache_putrun(FAR struct lcd_fbcache_s *fb, fb_coord_t row,
+                       fb_coord_t col, FAR const uint8_t *buffer,
+                       size_t npixels)
+{
+  struct lcd_fbrect_s rect;
+
+  if (npixels == 0 || row >= fb->yres || col + npixels > fb->xres)
+    {
+      return -EINVAL;
+    }
+
+  rect.x0 = col;
+  rect.y0 = row;
+  rect.x1 = col + npixels - 1;
+  rect.y1 = row;
+
+  lcd_fbcache_semtake(&fb->exclsem);
+
+  memcpy(&fb->fb[fb->back][(uint32_t)row * fb->xres + col], buffer,
+         npixels * sizeof(uint16_t));
+  lcd_fbcache_adddirty(fb, &rect);
+  lcd_fbcache_kick(fb);
+
+  sem_post(&fb->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lcd_fbcache_getrun
+ ****************************************************************************/
+
+int lcd_fbcache_getrun(FAR struct lcd_fbcache_s *fb, fb_coord_t row,
+                       fb_coord_t col, FAR uint8_t *buffer, size_t npixels)
+{
+  if (npixels == 0 || row >= fb->yres || col + npixels > fb->xres)
+    {
+      return -EINVAL;
+    }
+
+  lcd_fbcache_semtake(&fb->exclsem);
+  memcpy(buffer, &fb->fb[fb->back][(uint32_t)row * fb->xres + col],
+         npixels * sizeof(uint16_t));
+  sem_post(&fb->exclsem);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lcd_fbcache_fill
+ ****************************************************************************/
+
+int lcd_fbcache_fill(FAR struct lcd_fbcache_s *fb, uint16_t color)
+{
+  struct lcd_fbrect_s all;
+  FAR uint16_t *p;
+  uint32_t n;
+
+  all.x0 = 0;
+  all.y0 = 0;
+  all.x1 = fb->xres - 1;
+  all.y1 = fb->yres - 1;
+
+  lcd_fbcache_semtake(&fb->exclsem);
+
+  p = fb->fb[fb->back];
+  for (n = (uint32_t)fb->xres * fb->yres; n > 0; n--)
+    {
+      *p++ = color;
+    }
+
+  fb->ndirty = 0;
+  lcd_fbcache_adddirty(fb, &all);
+  lcd_fbcache_kick(fb);
+
+  sem_post(&fb->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lcd_fbcache_flush
+ ****************************************************************************/
+
+int lcd_fbcache_flush(FAR struct lcd_fbcache_s *fb)
+{
+  uint32_t target;
+
+  lcd_fbcache_semtake(&fb->exclsem);
+
+  /* Changes still in the dirty list go with the next frame, otherwise the
+   * frame being written, if any, is the last one to wait for.
+   */
+
+  target = fb->gen;
+  if (fb->ndirty > 0)
+    {
+      target++;
+      fb->urgent = true;
+      sem_post(&fb->kicksem);
+    }
+
+  while ((int32_t)(fb->flushed - target) < 0)
+    {
+      fb->nwaiters++;
+      sem_post(&fb->exclsem);
+      lcd_fbcache_semtake(&fb->donesem);
+      lcd_fbcache_semtake(&fb->exclsem);
+    }
+
+  sem_post(&fb->exclsem);
+  return OK;
+}
+
+#endif /* CONFIG_LCD_FBCACHE */
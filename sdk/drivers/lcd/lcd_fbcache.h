@@ -0,0 +1,240 @@
+/****************************************************************************
+ * drivers/lcd/lcd_fbcache.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __DRIVERS_LCD_LCD_FBCACHE_H
+#define __DRIVERS_LCD_LCD_FBCACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+
+#include <nuttx/video/fb.h>
+
+#ifdef CONFIG_LCD_FBCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_LCD_FBCACHE_NRECTS
+#  define CONFIG_LCD_FBCACHE_NRECTS 16
+#endif
+
+#ifndef CONFIG_LCD_FBCACHE_INTERVAL
+#  define CONFIG_LCD_FBCACHE_INTERVAL 16
+#endif
+
+#ifndef CONFIG_LCD_FBCACHE_STAGESIZE
+#  define CONFIG_LCD_FBCACHE_STAGESIZE 8192
+#endif
+
+#ifdef CONFIG_LCD_FBCACHE_DOUBLEBUF
+#  define LCD_FBCACHE_NBUFFERS 2
+#else
+#  define LCD_FBCACHE_NBUFFERS 1
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Dirty rectangle, both corners inclusive */
+
+struct lcd_fbrect_s
+{
+  fb_coord_t x0;
+  fb_coord_t y0;
+  fb_coord_t x1;
+  fb_coord_t y1;
+};
+
+/* Panel access provided by the LCD driver.  A rectangle is written by one
+ * call of begin(), which selects the device, sets the column and page
+ * address and issues the memory write command, one or more calls of
+ * send() with the pixels in raster order, and one call of end().
+ */
+
+struct lcd_fbcache_ops_s
+{
+  void (*begin)(FAR void *arg, FAR const struct lcd_fbrect_s *rect);
+  void (*send)(FAR void *arg, FAR const uint16_t *wd, uint32_t nwords);
+  void (*end)(FAR void *arg);
+};
+
+/* Flush statistics */
+
+struct lcd_fbcache_stat_s
+{
+  uint32_t flushes;   /* Number of flushed frames */
+  uint32_t rects;     /* Number of rectangles written to the panel */
+  uint32_t bursts;    /* Number of send() calls */
+  uint32_t pixels;    /* Number of pixels written to the panel */
+};
+
+struct lcd_fbcache_s
+{
+  FAR const struct lcd_fbcache_ops_s *ops;
+  FAR void *arg;
+  fb_coord_t xres;
+  fb_coord_t yres;
+
+  /* Frame buffers.  The drawing side writes fb[back], the flush task reads
+   * the other one when double buffering.
+   */
+
+  FAR uint16_t *fb[LCD_FBCACHE_NBUFFERS];
+  uint8_t back;
+
+  /* Staging buffer to pack the rows of a partial width rectangle */
+
+  FAR uint16_t *stage;
+  uint32_t stagelen;
+
+  /* Dirty rectangles not yet taken by the flush task */
+
+  struct lcd_fbrect_s dirty[CONFIG_LCD_FBCACHE_NRECTS];
+  uint8_t ndirty;
+
+  bool pending;              /* The flush task has been kicked */
+  bool urgent;               /* Skip the frame interval */
+  bool stop;                 /* Terminate the flush task */
+  uint8_t nwaiters;          /* Number of tasks in lcd_fbcache_flush() */
+  uint32_t gen;              /* Number of frames taken for flushing */
+  uint32_t flushed;          /* Number of frames written to the panel */
+
+  sem_t exclsem;             /* Protects the back buffer and the above */
+  sem_t kicksem;             /* Wakes up the flush task */
+  sem_t donesem;             /* Wakes up lcd_fbcache_flush() */
+  pid_t pid;                 /* Flush task */
+
+  struct lcd_fbcache_stat_s stat;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: lcd_fbcache_initialize
+ *
+ * Description:
+ *   Allocate the frame buffers of a 16bpp panel of xres x yres pixels and
+ *   start the flush task.  The whole frame is flushed once so that the
+ *   panel and the frame buffer start out identical.
+ *
+ ****************************************************************************/
+
+int lcd_fbcache_initialize(FAR struct lcd_fbcache_s *fb,
+                           FAR const struct lcd_fbcache_ops_s *ops,
+                           FAR void *arg, fb_coord_t xres, fb_coord_t yres);
+
+/****************************************************************************
+ * Name: lcd_fbcache_uninitialize
+ *
+ * Description:
+ *   Stop the flush task and free the frame buffers.  Pending changes are
+ *   discarded.
+ *
+ ****************************************************************************/
+
+void lcd_fbcache_uninitialize(FAR struct lcd_fbcache_s *fb);
+
+/****************************************************************************
+ * Name: lcd_fbcache_putrun
+ *
+ * Description:
+ *   Write a partial raster line to the frame buffer and mark it dirty.
+ *   Returns without waiting for the panel.
+ *
+ ****************************************************************************/
+
+int lcd_fbcache_putrun(FAR struct lcd_fbcache_s *fb, fb_coord_t row,
+                       fb_coord_t col, FAR const uint8_t *buffer,
+                       size_t npixels);
+
+/****************************************************************************
+ * Name: lcd_fbcache_getrun
+ *
+ * Description:
+ *   Read a partial raster line back from the frame buffer.
+ *
+ ****************************************************************************/
+
+int lcd_fbcache_getrun(FAR struct lcd_fbcache_s *fb, fb_coord_t row,
+                       fb_coord_t col, FAR uint8_t *buffer, size_t npixels);
+
+/****************************************************************************
+ * Name: lcd_fbcache_fill
+ *
+ * Description:
+ *   Fill the whole frame buffer with one color and mark it dirty.
+ *
+ ****************************************************************************/
+
+int lcd_fbcache_fill(FAR struct lcd_fbcache_s *fb, uint16_t color);
+
+/****************************************************************************
+ * Name: lcd_fbcache_flush
+ *
+ * Description:
+ *   Flush without waiting for the frame interval and wait until everything
+ *   drawn before the call has been written to the panel.
+ *
+ ****************************************************************************/
+
+int lcd_fbcache_flush(FAR struct lcd_fbcache_s *fb);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_LCD_FBCACHE */
+#endif /* __DRIVERS_LCD_LCD_FBCACHE_H */
@@ -54,6 +54,8 @@
 #include <nuttx/lcd/lcd.h>
 #include <nuttx/lcd/lpm013m091a.h>
 
+#include "lcd_fbcache.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -87,6 +89,10 @@ struct lpm013m091a_dev_s
   struct lpm013m091a_lcd_s* lcd;
 
   uint8_t power;                  /* Current power setting */
+
+#ifdef CONFIG_LCD_FBCACHE
+  struct lcd_fbcache_s fbcache;   /* Frame buffer in front of the panel */
+#endif
 };
 
 /****************************************************************************
@@ -198,6 +204,51 @@ static void lpm013m091a_selectarea(FAR struct lpm013m091a_lcd_s *lcd,
   lcd->sendparam(lcd, y1 & 0xFF);
 }
 
+#ifdef CONFIG_LCD_FBCACHE
+/****************************************************************************
+ * Name:  lpm013m091a_fbbegin, lpm013m091a_fbsend, lpm013m091a_fbend
+ *
+ * Description:
+ *   Panel access for the frame buffer flush task.
+ *
+ ****************************************************************************/
+
+static void lpm013m091a_fbbegin(FAR void *arg,
+                                FAR const struct lcd_fbrect_s *rect)
+{
+  FAR struct lpm013m091a_lcd_s *lcd =
+    ((FAR struct lpm013m091a_dev_s *)arg)->lcd;
+
+  lcd->select(lcd);
+  lpm013m091a_selectarea(lcd, rect->x0, rect->y0, rect->x1, rect->y1);
+  lcd->sendcmd(lcd, LPM013M091A_RAMWR);
+}
+
+static void lpm013m091a_fbsend(FAR void *arg, FAR const uint16_t *wd,
+                               uint32_t nwords)
+{
+  FAR struct lpm013m091a_lcd_s *lcd =
+    ((FAR struct lpm013m091a_dev_s *)arg)->lcd;
+
+  lcd->sendgram(lcd, wd, nwords);
+}
+
+static void lpm013m091a_fbend(FAR void *arg)
+{
+  FAR struct lpm013m091a_lcd_s *lcd =
+    ((FAR struct lpm013m091a_dev_s *)arg)->lcd;
+
+  lcd->deselect(lcd);
+}
+
+static const struct lcd_fbcache_ops_s g_fbcacheops =
+{
+  .begin = lpm013m091a_fbbegin,
+  .send  = lpm013m091a_fbsend,
+  .end   = lpm013m091a_fbend,
+};
+#endif
+
 /****************************************************************************
  * Name:  lpm013m091a_hwinitialize
  *
@@ -303,8 +354,10 @@ static int lpm013m091a_putrun(fb_coord_t row, fb_coord_t col,
                               FAR const uint8_t *buffer, size_t npixels)
 {
   FAR struct lpm013m091a_dev_s *dev = (FAR struct lpm013m091a_dev_s *)&g_lpm013m091a_dev;
+#ifndef CONFIG_LCD_FBCACHE
   FAR struct lpm013m091a_lcd_s *lcd = dev->lcd;
   FAR const uint16_t *src = (FAR const uint16_t *)buffer;
+#endif
 
   DEBUGASSERT(buffer && ((uintptr_t)buffer & 1) == 0);
 
@@ -314,6 +367,11 @@ static int lpm013m091a_putrun(fb_coord_t row, fb_coord_t col,
       return -EINVAL;
     }
 
+#ifdef CONFIG_LCD_FBCACHE
+  /* Draw into the frame buffer, the flush task updates the panel */
+
+  return lcd_fbcache_putrun(&dev->fbcache, row, col, buffer, npixels);
+#else
   /* Select lcd driver */
 
   lcd->select(lcd);
@@ -335,6 +393,7 @@ static int lpm013m091a_putrun(fb_coord_t row, fb_coord_t col,
   lcd->deselect(lcd);
 
   return OK;
+#endif
 }
 
 /****************************************************************************
@@ -362,8 +421,13 @@ static int lpm013m091a_putrun(fb_coord_t row, fb_coord_t col,
 int lpm013m091a_getrun(fb_coord_t row, fb_coord_t col, FAR uint8_t * buffer,
                        size_t npixels)
 {
+#ifdef CONFIG_LCD_FBCACHE
+  return lcd_fbcache_getrun(&g_lpm013m091a_dev.fbcache, row, col, buffer,
+                            npixels);
+#else
   lcderr("getrun is not supported for now.\n");
   return -ENOSYS;
+#endif
 }
 #endif
 
@@ -588,6 +652,17 @@ FAR struct lcd_dev_s* lpm013m091a_initialize(FAR struct lpm013m091a_lcd_s *lcd,
 
           ret = lpm013m091a_hwinitialize(priv);
 
+#ifdef CONFIG_LCD_FBCACHE
+          if (ret == OK)
+            {
+              /* Put the frame buffer in front of the panel */
+
+              ret = lcd_fbcache_initialize(&priv->fbcache, &g_fbcacheops,
+                                           priv, LPM013M091A_XRES,
+                                           LPM013M091A_YRES);
+            }
+#endif
+
           if (ret == OK)
             {
               return &priv->dev;
@@ -599,3 +674,26 @@ FAR struct lcd_dev_s* lpm013m091a_initialize(FAR struct lpm013m091a_lcd_s *lcd,
 
   return NULL;
 }
+
+/****************************************************************************
+ * Name:  lpm013m091a_flush
+ *
+ * Description:
+ *   Write the changes held in the frame buffer to the panel now and wait
+ *   for completion.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LCD_FBCACHE
+int lpm013m091a_flush(FAR struct lcd_dev_s *dev)
+{
+  FAR struct lpm013m091a_dev_s *priv = (FAR struct lpm013m091a_dev_s *)dev;
+
+  if (!priv->lcd)
+    {
+      return -EINVAL;
+    }
+
+  return lcd_fbcache_flush(&priv->fbcache);
+}
+#endif
@@ -369,6 +369,12 @@ static int altmdm_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      case MODEM_IOC_GETSTATS:  /* Get transfer statistics. */
+        {
+          ret = altmdm_spi_getstats(priv, (struct altmdm_stats_s *)arg);
+        }
+        break;
+
       default:
         m_err("Unrecognized cmd: 0x%08x\n", cmd);
         break;
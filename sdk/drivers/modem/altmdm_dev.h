@@ -136,6 +136,17 @@ ssize_t altmdm_spi_write(FAR struct altmdm_dev_s *priv,
 
 int altmdm_spi_readabort(FAR struct altmdm_dev_s *priv);
 
+/****************************************************************************
+ * Name: altmdm_spi_getstats
+ *
+ * Description:
+ *   Get the transfer statistics.
+ *
+ ****************************************************************************/
+
+int altmdm_spi_getstats(FAR struct altmdm_dev_s *priv,
+                        FAR struct altmdm_stats_s *stats);
+
 
 /****************************************************************************
  * Name: altmdm_spi_sleepmodem
@@ -84,6 +84,16 @@
 #  define MAX_PKT_SIZE     (2064)
 #endif
 #define UNIT_SIZE          (4)
+#if defined(CONFIG_MODEM_ALTMDM_RXBUFF_NUM)
+#  define RXBUFF_NUM       (CONFIG_MODEM_ALTMDM_RXBUFF_NUM)
+#else
+#  define RXBUFF_NUM       (4)
+#endif
+#if defined(CONFIG_MODEM_ALTMDM_TX_COALESCE_THRESHOLD)
+#  define TX_COALESCE_THRESHOLD (CONFIG_MODEM_ALTMDM_TX_COALESCE_THRESHOLD)
+#else
+#  define TX_COALESCE_THRESHOLD (256)
+#endif
 #define RX_ENABLE          (0)
 #define RX_DISABLE         (1)
 #define SLEEP_OK           (0)
@@ -102,6 +112,7 @@
 #  define SV_TIMER_TIMOUT_VAL (20)
 #endif
 #define WRITE_WAIT_TIMEOUT    (ALTMDM_SYS_FLAG_TMOFEVR)
+#define TX_RETRY_INTERVAL     (100) /* Counted in units of microsecond. */
 #define SREQ_WAIT_TIMEOUT     (ALTMDM_SYS_FLAG_TMOFEVR)
 
 #define SPI_MAXFREQUENCY            (13000000)      /* 13MHz. */
@@ -152,6 +163,9 @@
 static struct altmdm_dev_s *g_privdata = NULL;
 static char g_tmp_rxbuff[MAX_PKT_SIZE];
 static char g_tmp_txbuff[MAX_PKT_SIZE];
+#ifdef CONFIG_MODEM_ALTMDM_TX_COALESCE
+static char g_tx_stagebuff[2][MAX_PKT_SIZE];
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -356,67 +370,78 @@ static int notify_xferready(FAR struct altmdm_dev_s *priv)
  * Name: init_rxbuffer
  *
  * Description:
- *   Initialize the receive buffer used for data transfer.
+ *   Initialize the receive buffers used for data transfer. All buffers
+ *   are put on the free list.
  *
  ****************************************************************************/
 
 static void init_rxbuffer(FAR struct altmdm_dev_s *priv,
-                          FAR struct altmdm_spi_rxbuff_s **rxbuff,
-                          uint32_t unit_size)
+                          uint32_t unit_size, uint32_t num)
 {
-  FAR struct altmdm_spi_rxbuff_s *l_buff = NULL;
+  uint32_t                           i;
+  FAR char                           *l_data;
+  FAR struct altmdm_spi_rxbuff_s     *l_pool;
+  FAR struct altmdm_spi_rxbuffinfo_s *info = &priv->spidev.rxbuffinfo;
+
+  info->pool = NULL;
+  info->free_buff = NULL;
 
-  l_buff = (FAR struct altmdm_spi_rxbuff_s *)kmm_malloc
-             (sizeof(struct altmdm_spi_rxbuff_s));
-  if (l_buff == NULL)
+  l_pool = (FAR struct altmdm_spi_rxbuff_s *)kmm_malloc
+             (sizeof(struct altmdm_spi_rxbuff_s) * num);
+  if (l_pool == NULL)
     {
       m_err("cannot allocate memory for received buffer\n");
+      return;
     }
-  else
+
+  l_data = (FAR char *)kmm_malloc(unit_size * num);
+  if (l_data == NULL)
     {
-      memset(l_buff, 0x00, sizeof(struct altmdm_spi_rxbuff_s));
+      m_err("cannot allocate memory for received buffer\n");
+      kmm_free(l_pool);
+      return;
+    }
 
-      l_buff->buff_addr = (char *)kmm_malloc(unit_size);
-      if (l_buff->buff_addr == NULL)
-        {
-          m_err("cannot allocate memory for received buffer\n");
-          kmm_free(l_buff);
-          l_buff = NULL;
-        }
-      else
-        {
-          l_buff->buff_size = unit_size;
-        }
+  memset(l_pool, 0x00, sizeof(struct altmdm_spi_rxbuff_s) * num);
+
+  for (i = 0; i < num; i++)
+    {
+      l_pool[i].buff_addr = l_data + (unit_size * i);
+      l_pool[i].buff_size = unit_size;
+      l_pool[i].next = info->free_buff;
+      info->free_buff = &l_pool[i];
     }
-  *rxbuff = l_buff;
+
+  info->pool = l_pool;
 }
 
 /****************************************************************************
  * Name: uninit_rxbuffer
  *
  * Description:
- *   Uninitialize the receive buffer used for data transfer.
+ *   Uninitialize the receive buffers used for data transfer.
  *
  ****************************************************************************/
 
-static void uninit_rxbuffer(FAR struct altmdm_dev_s *priv,
-                            FAR struct altmdm_spi_rxbuff_s *rxbuff)
+static void uninit_rxbuffer(FAR struct altmdm_dev_s *priv)
 {
-  if (rxbuff != NULL)
+  FAR struct altmdm_spi_rxbuffinfo_s *info = &priv->spidev.rxbuffinfo;
+
+  if (info->pool != NULL)
     {
-      if (rxbuff->buff_addr != NULL)
-        {
-          kmm_free(rxbuff->buff_addr);
-        }
-      kmm_free(rxbuff);
+      kmm_free(info->pool[0].buff_addr);
+      kmm_free(info->pool);
     }
+
+  info->pool = NULL;
+  info->free_buff = NULL;
 }
 
 /****************************************************************************
  * Name: alloc_rxbuffer
  *
  * Description:
- *   Get the allocated receive buffer.
+ *   Get a receive buffer from the free list.
  *
  ****************************************************************************/
 
@@ -424,14 +449,23 @@ static void alloc_rxbuffer(FAR struct altmdm_dev_s *priv,
                            FAR struct altmdm_spi_rxbuff_s **rxbuff,
                            uint32_t size)
 {
-  if (priv->spidev.rxbuffinfo.free_buff == NULL)
+  FAR struct altmdm_spi_rxbuffinfo_s *info = &priv->spidev.rxbuffinfo;
+  irqstate_t                         flags;
+
+  flags = enter_critical_section();
+
+  *rxbuff = info->free_buff;
+  if (info->free_buff != NULL)
     {
-      m_err("cannot allocate free rx buffer\n");
+      info->free_buff = info->free_buff->next;
+      (*rxbuff)->next = NULL;
     }
-  else
+
+  leave_critical_section(flags);
+
+  if (*rxbuff == NULL)
     {
-      *rxbuff = priv->spidev.rxbuffinfo.free_buff;
-      priv->spidev.rxbuffinfo.free_buff = NULL;
+      m_info("no free rx buffer\n");
     }
 }
 
@@ -439,21 +473,63 @@ static void alloc_rxbuffer(FAR struct altmdm_dev_s *priv,
  * Name: free_rxbuffer
  *
  * Description:
- *   Release allocated receive buffer.
+ *   Return a receive buffer to the free list. If the modem was held off
+ *   because no buffer was free, the stall ends here.
  *
  ****************************************************************************/
 
 static void free_rxbuffer(FAR struct altmdm_dev_s *priv,
                           FAR struct altmdm_spi_rxbuff_s *rxbuff)
 {
-  if (priv->spidev.rxbuffinfo.free_buff != NULL)
+  FAR struct altmdm_spi_rxbuffinfo_s *info = &priv->spidev.rxbuffinfo;
+  struct timespec                    now;
+  irqstate_t                         flags;
+
+  flags = enter_critical_section();
+
+  rxbuff->next = info->free_buff;
+  info->free_buff = rxbuff;
+
+  if (info->is_stalled)
     {
-      m_err("cannot free rx buffer\n");
+      info->is_stalled = false;
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      priv->spidev.stats.rx_stall_us +=
+        (uint64_t)(now.tv_sec - info->stall_start.tv_sec) * 1000000 +
+        (now.tv_nsec - info->stall_start.tv_nsec) / 1000;
     }
-  else
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: stall_rxbuffer
+ *
+ * Description:
+ *   Record that the modem had data to send while no receive buffer was
+ *   free. The stall lasts until a buffer is returned to the free list.
+ *
+ ****************************************************************************/
+
+static void stall_rxbuffer(FAR struct altmdm_dev_s *priv)
+{
+  FAR struct altmdm_spi_rxbuffinfo_s *info = &priv->spidev.rxbuffinfo;
+  irqstate_t                         flags;
+
+  flags = enter_critical_section();
+
+  priv->spidev.stats.rx_nobuff++;
+
+  /* A buffer may have been freed since the header was sent. */
+
+  if ((info->free_buff == NULL) && (!info->is_stalled))
     {
-      priv->spidev.rxbuffinfo.free_buff = rxbuff;
+      info->is_stalled = true;
+      clock_gettime(CLOCK_MONOTONIC, &info->stall_start);
+      priv->spidev.stats.rx_stalls++;
     }
+
+  leave_critical_section(flags);
 }
 
 /****************************************************************************
@@ -469,7 +545,7 @@ static void create_rxbufffifo(FAR struct altmdm_dev_s *priv)
 {
   FAR struct altmdm_spi_rxbufffifo_s *fifo = &priv->spidev.rxbuffinfo.fifo;
 
-  init_rxbuffer(priv, &priv->spidev.rxbuffinfo.free_buff, MAX_PKT_SIZE);
+  init_rxbuffer(priv, MAX_PKT_SIZE, RXBUFF_NUM);
 
   fifo->head = NULL;
   fifo->tail = NULL;
@@ -489,7 +565,7 @@ static void destroy_rxbufffifo(FAR struct altmdm_dev_s *priv)
 {
   FAR struct altmdm_spi_rxbufffifo_s *fifo = &priv->spidev.rxbuffinfo.fifo;
 
-  uninit_rxbuffer(priv, priv->spidev.rxbuffinfo.free_buff);
+  uninit_rxbuffer(priv);
 
   altmdm_sys_deletecsem(&fifo->csem);
 }
@@ -822,6 +898,8 @@ static int do_xferheader(FAR struct altmdm_dev_s *priv,
 
   dma_xfer_size = get_dmasize(priv, sizeof(struct altmdm_spi_xferhdr_s));
 
+  spidev->stats.xfers++;
+
   ret = do_dmaxfer(priv, (void *)&spidev->tx_param.header,
                    (void *)&spidev->rx_param.header, dma_xfer_size);
   if (ret < 0)
@@ -1356,6 +1434,7 @@ static uint32_t decide_xfermode(FAR struct altmdm_dev_s *priv,
                   if (spidev->rx_param.rxbuff == NULL)
                     {
                       mode = MODE_TRXDATANOBUFF;
+                      stall_rxbuffer(priv);
                     }
                   else
                     {
@@ -1395,6 +1474,7 @@ static uint32_t decide_xfermode(FAR struct altmdm_dev_s *priv,
               if (spidev->rx_param.rxbuff == NULL)
                 {
                   mode = MODE_RXDATANOBUFF;
+                  stall_rxbuffer(priv);
                 }
               else
                 {
@@ -1414,6 +1494,198 @@ static uint32_t decide_xfermode(FAR struct altmdm_dev_s *priv,
   return mode;
 }
 
+/****************************************************************************
+ * Name: set_txframe
+ *
+ * Description:
+ *   Set the frame to be sent and its size in units of transfer.
+ *
+ ****************************************************************************/
+
+static void set_txframe(FAR struct altmdm_dev_s *priv, FAR char *buff,
+                        int32_t size, int32_t packets)
+{
+  FAR struct altmdm_spi_tx_s *tx = &priv->spidev.tx_param;
+
+  tx->buff_addr = buff;
+  tx->actual_size = size;
+  tx->total_size = ((size + UNIT_SIZE - 1) / UNIT_SIZE) * UNIT_SIZE;
+  tx->packets = packets;
+}
+
+/****************************************************************************
+ * Name: select_txframe
+ *
+ * Description:
+ *   Select the frame to be sent. Staged packets written before a waiting
+ *   write request are sent first, in one frame. Packets staged after the
+ *   request wait for it, so that it is not held off by a steady stream of
+ *   small packets. Returns false if there is nothing to send.
+ *
+ ****************************************************************************/
+
+static bool select_txframe(FAR struct altmdm_dev_s *priv)
+{
+  FAR struct altmdm_spi_tx_s *tx = &priv->spidev.tx_param;
+
+#ifdef CONFIG_MODEM_ALTMDM_TX_COALESCE
+  if (tx->is_staged)
+    {
+      /* Resend the staged frame the modem could not accept. */
+
+      return true;
+    }
+
+  altmdm_sys_lock(&tx->stage_lock);
+
+  if (tx->stage_num > 0 && (tx->req_addr == NULL || tx->is_reqbehind))
+    {
+      set_txframe(priv, tx->stage_buff, tx->stage_size, tx->stage_num);
+      tx->is_staged = true;
+      tx->is_reqbehind = false;
+
+      /* Writers fill the other buffer while this one is sent. */
+
+      if (tx->stage_buff == g_tx_stagebuff[0])
+        {
+          tx->stage_buff = g_tx_stagebuff[1];
+        }
+      else
+        {
+          tx->stage_buff = g_tx_stagebuff[0];
+        }
+      tx->stage_size = 0;
+      tx->stage_num = 0;
+    }
+
+  altmdm_sys_unlock(&tx->stage_lock);
+
+  if (tx->is_staged)
+    {
+      return true;
+    }
+#endif
+
+  if (tx->req_addr != NULL)
+    {
+      set_txframe(priv, (FAR char *)tx->req_addr, tx->req_size, 1);
+      tx->req_addr = NULL;
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: done_txdata
+ *
+ * Description:
+ *   Notify that the frame has been sent. A staged frame is resent here if
+ *   the modem was buffer full, since no writer is waiting for it. The
+ *   packets of a failed staged frame are counted as lost, their writers
+ *   have already returned.
+ *
+ ****************************************************************************/
+
+static void done_txdata(FAR struct altmdm_dev_s *priv, int ret)
+{
+  FAR struct altmdm_spi_dev_s *spidev = &priv->spidev;
+  FAR struct altmdm_spi_tx_s  *tx     = &spidev->tx_param;
+  int32_t                     result;
+
+  /* The frame was sent even if there was no buffer to receive into. */
+
+  if (ret == TRANS_OK_TRXDATANORXBUFF)
+    {
+      ret = TRANS_OK;
+    }
+
+  if (tx->is_bufful)
+    {
+      tx->is_bufful = 0;
+      result = (ret < 0) ? ret : TRANS_OK_RCVBUFFUL;
+    }
+  else
+    {
+      result = (ret < 0) ? ret : TRANS_OK;
+    }
+
+  if (result == TRANS_OK_RCVBUFFUL)
+    {
+      spidev->stats.tx_retries++;
+    }
+  else if (result == TRANS_OK)
+    {
+      spidev->stats.tx_frames++;
+      spidev->stats.tx_packets += tx->packets;
+    }
+
+#ifdef CONFIG_MODEM_ALTMDM_TX_COALESCE
+  if (tx->is_staged)
+    {
+      if (result == TRANS_OK_RCVBUFFUL)
+        {
+          usleep(TX_RETRY_INTERVAL);
+        }
+      else
+        {
+          tx->is_staged = false;
+          if (result != TRANS_OK)
+            {
+              m_err("staged frame failed:%d\n", result);
+              spidev->stats.tx_lost += tx->packets;
+            }
+        }
+
+      /* Continue with the packets staged or written in the meantime. */
+
+      altmdm_sys_setflag(&spidev->xfer_flag, EVENT_TXREQ);
+      return;
+    }
+#endif
+
+  tx->result = result;
+  altmdm_sys_setflag(&tx->done_flag, EVENT_TX_DONE);
+}
+
+#ifdef CONFIG_MODEM_ALTMDM_TX_COALESCE
+/****************************************************************************
+ * Name: stage_txdata
+ *
+ * Description:
+ *   Copy a small packet into the staging buffer. The packets staged while
+ *   a frame is on the wire are sent together in the next frame. Returns 0
+ *   if the staging buffer has no room for the packet.
+ *
+ ****************************************************************************/
+
+static ssize_t stage_txdata(FAR struct altmdm_dev_s *priv,
+                            FAR const char *buffer, size_t len)
+{
+  FAR struct altmdm_spi_tx_s *tx   = &priv->spidev.tx_param;
+  ssize_t                    wsize = 0;
+
+  altmdm_sys_lock(&tx->stage_lock);
+
+  if (tx->stage_size + len <= MAX_PKT_SIZE)
+    {
+      memcpy(tx->stage_buff + tx->stage_size, buffer, len);
+      tx->stage_size += len;
+      tx->stage_num++;
+      wsize = len;
+    }
+
+  altmdm_sys_unlock(&tx->stage_lock);
+
+  if (wsize > 0)
+    {
+      altmdm_sys_setflag(&priv->spidev.xfer_flag, EVENT_TXREQ);
+    }
+
+  return wsize;
+}
+#endif
+
 /****************************************************************************
  * Name: done_xfer
  *
@@ -1437,35 +1709,18 @@ static void done_xfer(FAR struct altmdm_dev_s *priv, uint32_t xfer_mode,
           }
         else
           {
+            spidev->stats.rx_packets++;
             put_rxbufffifo(priv, spidev->rx_param.rxbuff);
             spidev->rx_param.rxbuff = NULL;
           }
         break;
 
       case MODE_TXDATA:
-        if (spidev->tx_param.is_bufful)
-          {
-            spidev->tx_param.is_bufful = 0;
-            spidev->tx_param.result = (ret < 0) ? ret : TRANS_OK_RCVBUFFUL;
-          }
-        else
-          {
-            spidev->tx_param.result = (ret < 0) ? ret : TRANS_OK;
-          }
-        altmdm_sys_setflag(&spidev->tx_param.done_flag, EVENT_TX_DONE);
+        done_txdata(priv, ret);
         break;
 
       case MODE_TRXDATA:
-        if (spidev->tx_param.is_bufful)
-          {
-            spidev->tx_param.is_bufful = 0;
-            spidev->tx_param.result = (ret < 0) ? ret : TRANS_OK_RCVBUFFUL;
-          }
-        else
-          {
-            spidev->tx_param.result = (ret < 0) ? ret : TRANS_OK;
-          }
-        altmdm_sys_setflag(&spidev->tx_param.done_flag, EVENT_TX_DONE);
+        done_txdata(priv, ret);
 
         if (ret < 0)
           {
@@ -1474,27 +1729,18 @@ static void done_xfer(FAR struct altmdm_dev_s *priv, uint32_t xfer_mode,
           }
         else
           {
+            spidev->stats.rx_packets++;
             put_rxbufffifo(priv, spidev->rx_param.rxbuff);
             spidev->rx_param.rxbuff = NULL;
           }
         break;
 
       case MODE_TRXDATANOBUFF:
-        if (spidev->tx_param.is_bufful)
-          {
-            spidev->tx_param.is_bufful = 0;
-            spidev->tx_param.result = (ret < 0) ? ret : TRANS_OK_RCVBUFFUL;
-          }
-        else
-          {
-            spidev->tx_param.result = (ret < 0) ? ret : TRANS_OK;
-          }
-        altmdm_sys_setflag(&spidev->tx_param.done_flag, EVENT_TX_DONE);
+        done_txdata(priv, ret);
         break;
 
       case MODE_TRXHEADERFAILTXREQ:
-        spidev->tx_param.result = ret;
-        altmdm_sys_setflag(&spidev->tx_param.done_flag, EVENT_TX_DONE);
+        done_txdata(priv, ret);
         break;
 
       case MODE_RXRESET:
@@ -1515,16 +1761,7 @@ static void done_xfer(FAR struct altmdm_dev_s *priv, uint32_t xfer_mode,
             notify_xferready(priv);
           }
         altmdm_pm_notify_reset(priv);
-        if (spidev->tx_param.is_bufful)
-          {
-            spidev->tx_param.is_bufful = 0;
-            spidev->tx_param.result = (ret < 0) ? ret : TRANS_OK_RCVBUFFUL;
-          }
-        else
-          {
-            spidev->tx_param.result = (ret < 0) ? ret : TRANS_OK;
-          }
-        altmdm_sys_setflag(&spidev->tx_param.done_flag, EVENT_TX_DONE);
+        done_txdata(priv, ret);
         break;
 
       case MODE_TRXHEADERFAILRXREQ:
@@ -1620,6 +1857,13 @@ static int xfer_task(int argc, char *argv[])
           do_sleep = 0;
           sleep_result = SLEEP_NG;
 
+          /* The request may have been sent with an earlier frame. */
+
+          if (is_txreq && !select_txframe(priv))
+            {
+              is_txreq = 0;
+            }
+
           /* Sleep transition event received. Check if it can sleep. */
 
           if (is_sleepreq || is_timerexp)
@@ -1836,6 +2080,10 @@ int altmdm_spi_init(FAR struct altmdm_dev_s *priv)
   altmdm_sys_initlock(&priv->spidev.tx_param.lock);
   altmdm_sys_initlock(&priv->spidev.rx_param.lock);
   altmdm_sys_initlock(&priv->spidev.sleep_param.lock);
+#ifdef CONFIG_MODEM_ALTMDM_TX_COALESCE
+  altmdm_sys_initlock(&priv->spidev.tx_param.stage_lock);
+  priv->spidev.tx_param.stage_buff = g_tx_stagebuff[0];
+#endif
 
   altmdm_sys_initflag(&priv->spidev.xfer_flag);
   altmdm_sys_initflag(&priv->spidev.xferready_flag);
@@ -1895,6 +2143,9 @@ int altmdm_spi_uninit(FAR struct altmdm_dev_s *priv)
   altmdm_sys_deletelock(&priv->spidev.tx_param.lock);
   altmdm_sys_deletelock(&priv->spidev.rx_param.lock);
   altmdm_sys_deletelock(&priv->spidev.sleep_param.lock);
+#ifdef CONFIG_MODEM_ALTMDM_TX_COALESCE
+  altmdm_sys_deletelock(&priv->spidev.tx_param.stage_lock);
+#endif
 
   altmdm_sys_deleteflag(&priv->spidev.xfer_flag);
   altmdm_sys_deleteflag(&priv->spidev.tx_param.done_flag);
@@ -1945,6 +2196,16 @@ int altmdm_spi_disable(FAR struct altmdm_dev_s *priv)
 
   spidev->is_xferready = false;
 
+#ifdef CONFIG_MODEM_ALTMDM_TX_COALESCE
+  /* Packets not yet sent are dropped with the modem power. */
+
+  altmdm_sys_lock(&spidev->tx_param.stage_lock);
+  spidev->tx_param.stage_size = 0;
+  spidev->tx_param.stage_num = 0;
+  spidev->tx_param.is_reqbehind = false;
+  altmdm_sys_unlock(&spidev->tx_param.stage_lock);
+#endif
+
   return 0;
 }
 
@@ -2032,7 +2293,6 @@ ssize_t altmdm_spi_write(FAR struct altmdm_dev_s *priv,
                          FAR const char *buffer, size_t witelen)
 {
   int                         ret;
-  int                         remainder;
   uint32_t                    ptn;
   FAR struct altmdm_spi_dev_s *spidev;
   ssize_t                     wsize = witelen;
@@ -2057,24 +2317,39 @@ ssize_t altmdm_spi_write(FAR struct altmdm_dev_s *priv,
       wait_xferready(priv);
     }
 
-  altmdm_sys_lock(&spidev->tx_param.lock);
+#ifdef CONFIG_MODEM_ALTMDM_TX_COALESCE
+  if (witelen <= TX_COALESCE_THRESHOLD)
+    {
+      /* Small packets return as soon as they are staged. A staged frame
+       * that fails is counted in the tx_lost statistics.
+       */
 
-again:
-  spidev->tx_param.buff_addr = (void *)buffer;
-  spidev->tx_param.actual_size = witelen;
+      wsize = stage_txdata(priv, buffer, witelen);
+      if (wsize != 0)
+        {
+          return wsize;
+        }
 
-  remainder = witelen % UNIT_SIZE;
-  if (remainder == 0)
-    {
-      spidev->tx_param.total_size = spidev->tx_param.actual_size;
-    }
-  else
-    {
-      spidev->tx_param.total_size =
-        ((spidev->tx_param.actual_size / UNIT_SIZE) + 1) * UNIT_SIZE;
+      wsize = witelen;
     }
+#endif
+
+  altmdm_sys_lock(&spidev->tx_param.lock);
+
+#ifdef CONFIG_MODEM_ALTMDM_TX_COALESCE
+  /* The packets staged so far go out before this request, the ones staged
+   * later after it.
+   */
 
+  altmdm_sys_lock(&spidev->tx_param.stage_lock);
+  spidev->tx_param.is_reqbehind = (spidev->tx_param.stage_num > 0);
+  altmdm_sys_unlock(&spidev->tx_param.stage_lock);
+#endif
+
+again:
   spidev->tx_param.result = 0;
+  spidev->tx_param.req_size = witelen;
+  spidev->tx_param.req_addr = buffer;
 
   altmdm_sys_setflag(&spidev->xfer_flag, EVENT_TXREQ);
 
@@ -2091,7 +2366,6 @@ again:
       switch (spidev->tx_param.result)
         {
         case TRANS_OK:
-        case TRANS_OK_TRXDATANORXBUFF:
           wsize = witelen;
           break;
 
@@ -2101,7 +2375,7 @@ again:
           break;
 
         case TRANS_OK_RCVBUFFUL:
-          usleep(100);
+          usleep(TX_RETRY_INTERVAL);
           goto again;
           break;
 
@@ -2143,6 +2417,33 @@ int altmdm_spi_readabort(FAR struct altmdm_dev_s *priv)
   return OK;
 }
 
+/****************************************************************************
+ * Name: altmdm_spi_getstats
+ *
+ * Description:
+ *   Get the transfer statistics.
+ *
+ ****************************************************************************/
+
+int altmdm_spi_getstats(FAR struct altmdm_dev_s *priv,
+                        FAR struct altmdm_stats_s *stats)
+{
+  irqstate_t flags;
+
+  /* Check argument */
+
+  if ((priv == NULL) || (stats == NULL))
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  memcpy(stats, &priv->spidev.stats, sizeof(struct altmdm_stats_s));
+  leave_critical_section(flags);
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: altmdm_spi_sleepmodem
  *
@@ -42,6 +42,8 @@
 
 #include <sdk/config.h>
 #include <semaphore.h>
+#include <time.h>
+#include <nuttx/modem/altmdm.h>
 #include "altmdm_dev.h"
 #include "altmdm_sys.h"
 
@@ -86,9 +88,14 @@ struct altmdm_spi_rxbufffifo_s
 
 struct altmdm_spi_rxbuffinfo_s
 {
-  struct altmdm_spi_rxbuff_s     *free_buff;  /* Free receive buffer
-                                               * address. */
-  struct altmdm_spi_rxbufffifo_s fifo;        /* Receive buffer fifo. */
+  struct altmdm_spi_rxbuff_s     *pool;        /* Receive buffer pool. */
+  struct altmdm_spi_rxbuff_s     *free_buff;   /* List of free receive
+                                                * buffers. */
+  bool                           is_stalled;   /* Indicates the modem has
+                                                * data but no receive
+                                                * buffer is free. */
+  struct timespec                stall_start;  /* Time the stall started. */
+  struct altmdm_spi_rxbufffifo_s fifo;         /* Receive buffer fifo. */
 };
 
 /* This structure describes the parameters for send data. */
@@ -99,16 +106,36 @@ struct altmdm_spi_tx_s
                                             * following parameters. */
   struct altmdm_sys_flag_s    done_flag;   /* Notify that tx request
                                             * has been completed. */
+  const char                  *req_addr;   /* Buffer address of the write
+                                            * request waiting to be sent. */
+  int32_t                     req_size;    /* Size of the write request. */
   struct altmdm_spi_xferhdr_s header;      /* Tx header. */
-  char                        *buff_addr;  /* Buffer address for data
-                                            * transmission speceified by
-                                            * the user. */
+  char                        *buff_addr;  /* Buffer address of the frame
+                                            * being sent. */
   int32_t                     actual_size; /* Actual data size. */
   int32_t                     total_size;  /* Data size of 4byte
                                             * alignment. */
+  int32_t                     packets;     /* Number of packets in the
+                                            * frame being sent. */
   int32_t                     result;      /* Result of transfer. */
   int32_t                     is_bufful;   /* Indicates the slave is buffer
                                             * full status. */
+#ifdef CONFIG_MODEM_ALTMDM_TX_COALESCE
+  struct altmdm_sys_lock_s    stage_lock;  /* Lock on accessing the
+                                            * following stage parameters. */
+  char                        *stage_buff; /* Staging buffer being filled
+                                            * by the writers. */
+  int32_t                     stage_size;  /* Data size in staging
+                                            * buffer. */
+  int32_t                     stage_num;   /* Number of packets in staging
+                                            * buffer. */
+  bool                        is_reqbehind; /* Indicates the waiting
+                                             * write request was made
+                                             * after the packets in the
+                                             * staging buffer. */
+  bool                        is_staged;   /* Indicates the frame being
+                                            * sent is a staged frame. */
+#endif
 };
 
 /* This structure describes the parameters for receive data. */
@@ -174,6 +201,10 @@ struct altmdm_spi_dev_s
   /* Parameters for sleep modem */
 
   struct altmdm_spi_sleepmodem_s sleep_param;
+
+  /* Transfer statistics */
+
+  struct altmdm_stats_s          stats;
 };
 
 #endif
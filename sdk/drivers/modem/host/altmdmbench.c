@@ -0,0 +1,888 @@
+/****************************************************************************
+ * drivers/modem/host/altmdmbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark for the ALTMDM SPI driver.  altmdm_spi.c runs against a
+ *   fake modem which answers SPI_EXCHANGE() with the header and data phase
+ *   of the SPI protocol, drives the slave request interrupt and takes the
+ *   time a 13MHz SPI bus needs for each exchange, plus a turnaround for
+ *   the request handshake of each phase.  When the driver reports
+ *   that it cannot receive, the modem keeps the packet and requests again
+ *   after the retry interval.
+ *
+ *   -d: The modem sends downlink packets as fast as the driver takes them.
+ *       A reader thread consumes them with altmdm_spi_read() and stalls
+ *       now and then, like an application writing to flash.  The
+ *       throughput and the time the modem was held off are reported.
+ *   -u: Writer threads send small packets with altmdm_spi_write() and the
+ *       modem parses them from the frames.  The throughput and the packets
+ *       per frame are reported.  With -f the modem reports buffer full
+ *       now and then, so that frames are resent.  With -L the last writer
+ *       sends a tenth as many packets of the given size, too large to be
+ *       coalesced, and the time its writes take is reported.
+ *
+ *   The number of receive buffers and the transmit coalescing are build
+ *   options of the driver, the Makefile builds one binary for each.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <arch/board/common/cxd56_altmdm.h>
+#include "altmdm_dev.h"
+#include "altmdm_pm.h"
+#include "altmdm_pm_state.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_SPI_FREQUENCY   13000000
+#define BENCH_MAX_PKT_SIZE    2064
+#define BENCH_MAX_WRITERS     8
+#define BENCH_UL_MAGIC        0xa5
+#define BENCH_UL_HDRSIZE      8
+#define BENCH_SPIN_NSEC       50000
+
+#ifdef CONFIG_MODEM_ALTMDM_RXBUFF_NUM
+#  define BENCH_RXBUFF_NUM    CONFIG_MODEM_ALTMDM_RXBUFF_NUM
+#else
+#  define BENCH_RXBUFF_NUM    4
+#endif
+
+#ifdef CONFIG_MODEM_ALTMDM_TX_COALESCE
+#  define BENCH_COALESCE      "on"
+#else
+#  define BENCH_COALESCE      "off"
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct fake_modem_s
+{
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
+  xcpt_t          sreq_handler;   /* Slave request interrupt */
+  bool            sreq_enabled;
+  bool            in_data;        /* Next exchange is the data phase */
+  bool            reset_pending;  /* Reset packet not sent yet */
+  bool            offered;        /* Modem put a packet in the header */
+  bool            accepted;       /* Master could receive it */
+  int             master_size;    /* Master data size in the header */
+  bool            refused;        /* Modem was buffer full for it */
+  uint32_t        headers;        /* Headers carrying master data */
+  bool            retry;          /* Request again after the interval */
+  bool            stop;
+  uint32_t        dl_seq;         /* Next downlink packet */
+  uint32_t        dl_count;       /* Downlink packets to send */
+  int             dl_size;
+  uint8_t         ul_buff[2 * BENCH_MAX_PKT_SIZE];
+  int             ul_len;         /* Bytes waiting to be parsed */
+  uint32_t        ul_seq[BENCH_MAX_WRITERS];
+  uint32_t        ul_packets;
+  uint32_t        ul_bytes;
+  uint32_t        ul_errors;
+  uint64_t        bus_ns;         /* Time the SPI bus was busy */
+};
+
+struct bench_writer_s
+{
+  pthread_t id;
+  int       index;
+  uint32_t  count;
+  int       size;
+  int       errors;
+  uint64_t  total_ns;     /* Time spent in altmdm_spi_write() */
+  uint64_t  max_ns;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static pthread_mutex_t     g_critsect;
+static struct fake_modem_s g_modem;
+static struct altmdm_dev_s g_dev;
+static int                 g_retry_us   = 500;
+static int                 g_turnaround_us = 50;
+static int                 g_full_every = 0;
+static int                 g_consume_us = 100;
+static int                 g_burst_every = 8;
+static int                 g_burst_us   = 4000;
+static int                 g_large_size = 0;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void sleep_us(int usec)
+{
+  struct timespec ts;
+
+  if (usec > 0)
+    {
+      ts.tv_sec  = usec / 1000000;
+      ts.tv_nsec = (usec % 1000000) * 1000;
+      nanosleep(&ts, NULL);
+    }
+}
+
+/* Spend the time the bus needs for nwords bytes.  Short exchanges spin,
+ * long ones sleep so that the other threads run as they do during DMA.
+ */
+
+static void bus_delay(size_t nwords)
+{
+  uint64_t ns = (uint64_t)nwords * 8 * 1000000000ull / BENCH_SPI_FREQUENCY;
+  uint64_t end = now_ns() + ns;
+
+  g_modem.bus_ns += ns;
+
+  if (ns >= BENCH_SPIN_NSEC)
+    {
+      sleep_us(ns / 1000);
+    }
+
+  while (now_ns() < end)
+    {
+    }
+}
+
+static void raise_sreq(void)
+{
+  if (g_modem.sreq_enabled && g_modem.sreq_handler != NULL)
+    {
+      g_modem.sreq_handler(0, NULL, NULL);
+    }
+}
+
+static void set_header(uint8_t *hdr, int size, bool reset)
+{
+  int total = (size + 3) & ~3;
+
+  hdr[0] = (reset ? 0x40 : 0x00) | ((total >> 10) & 0x0f);
+  hdr[1] = (total >> 2) & 0xff;
+  hdr[2] = ((total & 0x03) << 6) | ((size >> 8) & 0x3f);
+  hdr[3] = size & 0xff;
+}
+
+static void fill_dlpacket(uint8_t *buff, uint32_t seq, int size)
+{
+  int i;
+
+  memcpy(buff, &seq, sizeof(seq));
+  for (i = sizeof(seq); i < size; i++)
+    {
+      buff[i] = (uint8_t)(seq + i);
+    }
+}
+
+static int check_dlpacket(const uint8_t *buff, uint32_t seq, int size)
+{
+  uint32_t got;
+  int i;
+
+  memcpy(&got, buff, sizeof(got));
+  if (got != seq)
+    {
+      return ERROR;
+    }
+
+  for (i = sizeof(seq); i < size; i++)
+    {
+      if (buff[i] != (uint8_t)(seq + i))
+        {
+          return ERROR;
+        }
+    }
+
+  return OK;
+}
+
+static void fill_ulpacket(uint8_t *buff, int writer, uint32_t seq, int size)
+{
+  int i;
+
+  buff[0] = BENCH_UL_MAGIC;
+  buff[1] = writer;
+  buff[2] = size & 0xff;
+  buff[3] = size >> 8;
+  memcpy(&buff[4], &seq, sizeof(seq));
+  for (i = BENCH_UL_HDRSIZE; i < size; i++)
+    {
+      buff[i] = (uint8_t)(seq ^ i);
+    }
+}
+
+/* Parse the uplink packets out of the frames.  Like the ALTCOM stream
+ * parser, packets may span frames and a frame may carry several packets.
+ */
+
+static void parse_ulframe(const uint8_t *data, int len)
+{
+  struct fake_modem_s *m = &g_modem;
+  uint32_t seq;
+  int size;
+  int i;
+
+  memcpy(&m->ul_buff[m->ul_len], data, len);
+  m->ul_len += len;
+
+  while (m->ul_len >= BENCH_UL_HDRSIZE)
+    {
+      size = m->ul_buff[2] | (m->ul_buff[3] << 8);
+      if (m->ul_buff[0] != BENCH_UL_MAGIC ||
+          m->ul_buff[1] >= BENCH_MAX_WRITERS ||
+          size < BENCH_UL_HDRSIZE || size > BENCH_MAX_PKT_SIZE)
+        {
+          m->ul_errors++;
+          m->ul_len--;
+          memmove(m->ul_buff, &m->ul_buff[1], m->ul_len);
+          continue;
+        }
+
+      if (m->ul_len < size)
+        {
+          break;
+        }
+
+      memcpy(&seq, &m->ul_buff[4], sizeof(seq));
+      if (seq != m->ul_seq[m->ul_buff[1]])
+        {
+          m->ul_errors++;
+        }
+
+      m->ul_seq[m->ul_buff[1]] = seq + 1;
+
+      for (i = BENCH_UL_HDRSIZE; i < size; i++)
+        {
+          if (m->ul_buff[i] != (uint8_t)(seq ^ i))
+            {
+              m->ul_errors++;
+              break;
+            }
+        }
+
+      pthread_mutex_lock(&m->lock);
+      m->ul_packets++;
+      m->ul_bytes += size;
+      pthread_mutex_unlock(&m->lock);
+
+      m->ul_len -= size;
+      memmove(m->ul_buff, &m->ul_buff[size], m->ul_len);
+    }
+}
+
+static void header_phase(const uint8_t *tx, uint8_t *rx)
+{
+  struct fake_modem_s *m = &g_modem;
+  int size = 0;
+
+  m->master_size = ((tx[2] & 0x3f) << 8) | tx[3];
+  m->accepted = (tx[0] & 0x80) == 0;
+
+  if (m->reset_pending)
+    {
+      size = 4;
+    }
+  else if (m->dl_seq < m->dl_count)
+    {
+      size = m->dl_size;
+    }
+
+  set_header(rx, size, m->reset_pending);
+  m->offered = size > 0;
+
+  m->refused = false;
+  if (m->master_size > 0 && g_full_every > 0 &&
+      ++m->headers % g_full_every == 0)
+    {
+      rx[0] |= 0x80;
+      m->refused = true;
+    }
+
+  /* The master goes on with the data phase when either side has data and
+   * waits for the modem to be ready for it.
+   */
+
+  if (m->master_size > 0 || m->offered)
+    {
+      m->in_data = true;
+      raise_sreq();
+    }
+}
+
+static void data_phase(const uint8_t *tx, uint8_t *rx)
+{
+  struct fake_modem_s *m = &g_modem;
+  bool again = false;
+
+  m->in_data = false;
+
+  if (m->master_size > 0 && !m->refused)
+    {
+      parse_ulframe(tx, m->master_size);
+    }
+
+  if (m->reset_pending)
+    {
+      memset(rx, 0, 4);
+      m->reset_pending = false;
+      again = true;
+    }
+  else if (m->offered)
+    {
+      fill_dlpacket(rx, m->dl_seq, m->dl_size);
+      if (m->accepted)
+        {
+          m->dl_seq++;
+          again = true;
+        }
+    }
+
+  if (m->dl_seq < m->dl_count)
+    {
+      if (again)
+        {
+          raise_sreq();
+        }
+      else
+        {
+          pthread_mutex_lock(&m->lock);
+          m->retry = true;
+          pthread_cond_signal(&m->cond);
+          pthread_mutex_unlock(&m->lock);
+        }
+    }
+}
+
+static void *retry_thread(void *arg)
+{
+  struct fake_modem_s *m = &g_modem;
+
+  pthread_mutex_lock(&m->lock);
+  while (!m->stop)
+    {
+      if (!m->retry)
+        {
+          pthread_cond_wait(&m->cond, &m->lock);
+          continue;
+        }
+
+      m->retry = false;
+      pthread_mutex_unlock(&m->lock);
+
+      sleep_us(g_retry_us);
+      raise_sreq();
+
+      pthread_mutex_lock(&m->lock);
+    }
+
+  pthread_mutex_unlock(&m->lock);
+  return NULL;
+}
+
+static void *task_trampoline(void *arg)
+{
+  int (*entry)(int argc, char *argv[]) = (int (*)(int, char *[]))arg;
+
+  entry(0, NULL);
+  return NULL;
+}
+
+static void *reader_thread(void *arg)
+{
+  static char buff[BENCH_MAX_PKT_SIZE];
+  uint32_t count = *(uint32_t *)arg;
+  uint32_t seq;
+  ssize_t n;
+  int errors = 0;
+
+  for (seq = 0; seq < count; seq++)
+    {
+      n = altmdm_spi_read(&g_dev, buff, sizeof(buff));
+      if (n != g_modem.dl_size ||
+          check_dlpacket((uint8_t *)buff, seq, n) != OK)
+        {
+          errors++;
+        }
+
+      sleep_us(g_consume_us);
+      if (g_burst_every > 0 && (seq + 1) % g_burst_every == 0)
+        {
+          sleep_us(g_burst_us);
+        }
+    }
+
+  *(uint32_t *)arg = errors;
+  return NULL;
+}
+
+static void *writer_thread(void *arg)
+{
+  struct bench_writer_s *w = (struct bench_writer_s *)arg;
+  static char buff[BENCH_MAX_WRITERS][BENCH_MAX_PKT_SIZE];
+  uint64_t start;
+  uint64_t elapsed;
+  uint32_t seq;
+
+  for (seq = 0; seq < w->count; seq++)
+    {
+      fill_ulpacket((uint8_t *)buff[w->index], w->index, seq, w->size);
+      start = now_ns();
+      if (altmdm_spi_write(&g_dev, buff[w->index], w->size) != w->size)
+        {
+          w->errors++;
+        }
+
+      elapsed = now_ns() - start;
+      w->total_ns += elapsed;
+      if (elapsed > w->max_ns)
+        {
+          w->max_ns = elapsed;
+        }
+    }
+
+  return NULL;
+}
+
+static void show_usage(const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-d|-u] [-n <count>] [-s <size>] "
+                  "[-w <writers>] [-f <every>] [-r <usec>] [-t <usec>] "
+                  "[-c <usec>] [-b <every>] [-B <usec>] [-L <size>]\n",
+                  progname);
+  fprintf(stderr, "\t-d: Downlink test (default)\n");
+  fprintf(stderr, "\t-u: Uplink test\n");
+  fprintf(stderr, "\t-n <count>: Number of packets. Default: 4000\n");
+  fprintf(stderr, "\t-s <size>: Packet size. Default: 1500 (-d), 64 (-u)\n");
+  fprintf(stderr, "\t-w <writers>: Writer threads (-u). Default: 1\n");
+  fprintf(stderr, "\t-f <every>: Modem is buffer full for every <every>"
+                  " frames (-u). Default: never\n");
+  fprintf(stderr, "\t-r <usec>: Modem retry interval. Default: %d\n",
+                  g_retry_us);
+  fprintf(stderr, "\t-t <usec>: Turnaround per phase. Default: %d\n",
+                  g_turnaround_us);
+  fprintf(stderr, "\t-c <usec>: Reader time per packet. Default: %d\n",
+                  g_consume_us);
+  fprintf(stderr, "\t-b <every>: Reader stalls every <every> packets. "
+                  "Default: %d\n", g_burst_every);
+  fprintf(stderr, "\t-B <usec>: Length of a reader stall. Default: %d\n",
+                  g_burst_us);
+  fprintf(stderr, "\t-L <size>: Last writer sends packets of <size>"
+                  " (-u, -w 2 or more). Default: off\n");
+  exit(errcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* NuttX and board interfaces used by the driver */
+
+irqstate_t enter_critical_section(void)
+{
+  pthread_mutex_lock(&g_critsect);
+  return 0;
+}
+
+void leave_critical_section(irqstate_t flags)
+{
+  pthread_mutex_unlock(&g_critsect);
+}
+
+int task_create(const char *name, int priority, int stack_size,
+                int (*entry)(int argc, char *argv[]), char * const argv[])
+{
+  pthread_t id;
+
+  if (pthread_create(&id, NULL, task_trampoline, (void *)entry) != 0)
+    {
+      return ERROR;
+    }
+
+  pthread_detach(id);
+  return 1;
+}
+
+int task_delete(pid_t pid)
+{
+  pthread_exit(NULL);
+  return OK;
+}
+
+void board_altmdm_gpio_write(uint32_t pin, bool value)
+{
+  /* The modem answers the master request with the slave request. */
+
+  if (pin == ALTMDM_GPIO_MASTER_REQ && value)
+    {
+      raise_sreq();
+    }
+}
+
+void board_altmdm_gpio_irq(uint32_t pin, uint32_t polarity,
+                           uint32_t noise_filter, xcpt_t irqhandler)
+{
+  g_modem.sreq_handler = irqhandler;
+}
+
+void board_altmdm_gpio_int_control(uint32_t pin, bool en)
+{
+  g_modem.sreq_enabled = en;
+}
+
+void bench_spi_exchange(struct spi_dev_s *dev, const void *txbuffer,
+                        void *rxbuffer, size_t nwords)
+{
+  sleep_us(g_turnaround_us);
+  bus_delay(nwords);
+
+  if (g_modem.in_data)
+    {
+      data_phase(txbuffer, rxbuffer);
+    }
+  else
+    {
+      header_phase(txbuffer, rxbuffer);
+    }
+}
+
+/* The supervisory timer only drives the sleep of the modem, which stays
+ * awake here.
+ */
+
+timer_t __wrap_altmdm_sys_starttimer(int first_ms, int interval_ms,
+                                     void *handler, int int_param,
+                                     void *ptr_param)
+{
+  return (timer_t)&g_modem;
+}
+
+void __wrap_altmdm_sys_stoptimer(timer_t timerid)
+{
+}
+
+/* Power management of the modem, always awake */
+
+int altmdm_pm_init(struct altmdm_dev_s *priv)
+{
+  return OK;
+}
+
+int altmdm_pm_uninit(struct altmdm_dev_s *priv)
+{
+  return OK;
+}
+
+int altmdm_pm_wakeup(struct altmdm_dev_s *priv)
+{
+  return MODEM_PM_WAKEUP_ALREADY;
+}
+
+int altmdm_pm_notify_reset(struct altmdm_dev_s *priv)
+{
+  return OK;
+}
+
+int altmdm_pm_callgpiohandler(struct altmdm_dev_s *priv)
+{
+  return OK;
+}
+
+int altmdm_pm_sleepmodem(struct altmdm_dev_s *priv)
+{
+  return OK;
+}
+
+int altmdm_pm_cansleep(struct altmdm_dev_s *priv)
+{
+  return 0;
+}
+
+uint32_t altmdm_pm_getinternalstate(void)
+{
+  return MODEM_PM_INTERNAL_STATE_WAKE;
+}
+
+int main(int argc, char **argv)
+{
+  struct bench_writer_s writers[BENCH_MAX_WRITERS];
+  struct altmdm_stats_s stats;
+  pthread_mutexattr_t attr;
+  pthread_t retry;
+  pthread_t reader;
+  uint32_t count = 4000;
+  uint32_t errors = 0;
+  uint64_t start;
+  uint64_t total;
+  uint64_t bus_start;
+  double elapsed;
+  bool uplink = false;
+  int nwriters = 1;
+  int size = 0;
+  int option;
+  int i;
+
+  while ((option = getopt(argc, argv, ":dun:s:w:f:r:t:c:b:B:L:h")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'd':
+            uplink = false;
+            break;
+
+          case 'u':
+            uplink = true;
+            break;
+
+          case 'n':
+            count = strtoul(optarg, NULL, 0);
+            break;
+
+          case 's':
+            size = atoi(optarg);
+            break;
+
+          case 'w':
+            nwriters = atoi(optarg);
+            break;
+
+          case 'f':
+            g_full_every = atoi(optarg);
+            break;
+
+          case 'r':
+            g_retry_us = atoi(optarg);
+            break;
+
+          case 't':
+            g_turnaround_us = atoi(optarg);
+            break;
+
+          case 'c':
+            g_consume_us = atoi(optarg);
+            break;
+
+          case 'b':
+            g_burst_every = atoi(optarg);
+            break;
+
+          case 'B':
+            g_burst_us = atoi(optarg);
+            break;
+
+          case 'L':
+            g_large_size = atoi(optarg);
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (size == 0)
+    {
+      size = uplink ? 64 : 1500;
+    }
+
+  if (size < BENCH_UL_HDRSIZE || size > BENCH_MAX_PKT_SIZE ||
+      nwriters < 1 || nwriters > BENCH_MAX_WRITERS ||
+      (g_large_size != 0 && (nwriters < 2 ||
+                             g_large_size < BENCH_UL_HDRSIZE ||
+                             g_large_size > BENCH_MAX_PKT_SIZE)))
+    {
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&g_critsect, &attr);
+
+  pthread_mutex_init(&g_modem.lock, NULL);
+  pthread_cond_init(&g_modem.cond, NULL);
+  g_modem.reset_pending = true;
+  g_modem.dl_size = size;
+
+  altmdm_spi_init(&g_dev);
+  altmdm_spi_enable(&g_dev);
+  pthread_create(&retry, NULL, retry_thread, NULL);
+
+  /* The modem announces itself with a reset packet. */
+
+  raise_sreq();
+  while (!g_dev.spidev.is_xferready)
+    {
+      sleep_us(100);
+    }
+
+  start = now_ns();
+  bus_start = g_modem.bus_ns;
+
+  if (!uplink)
+    {
+      errors = count;
+      g_modem.dl_count = count;
+      raise_sreq();
+
+      pthread_create(&reader, NULL, reader_thread, &errors);
+      pthread_join(reader, NULL);
+    }
+  else
+    {
+      memset(writers, 0, sizeof(writers));
+      for (i = 0; i < nwriters; i++)
+        {
+          writers[i].index  = i;
+          writers[i].count  = count / nwriters;
+          writers[i].size   = size;
+        }
+
+      if (g_large_size != 0)
+        {
+          writers[nwriters - 1].count /= 10;
+          writers[nwriters - 1].size = g_large_size;
+        }
+
+      for (i = 0; i < nwriters; i++)
+        {
+          pthread_create(&writers[i].id, NULL, writer_thread, &writers[i]);
+        }
+
+      count = 0;
+      for (i = 0; i < nwriters; i++)
+        {
+          pthread_join(writers[i].id, NULL);
+          errors += writers[i].errors;
+          count += writers[i].count;
+        }
+
+      /* Staged packets may still be on their way. */
+
+      for (i = 0; i < 10000; i++)
+        {
+          pthread_mutex_lock(&g_modem.lock);
+          total = g_modem.ul_packets;
+          pthread_mutex_unlock(&g_modem.lock);
+          if (total >= count)
+            {
+              break;
+            }
+
+          sleep_us(100);
+        }
+
+      if (total != count)
+        {
+          errors++;
+        }
+
+      errors += g_modem.ul_errors;
+    }
+
+  total = now_ns() - start;
+  elapsed = (double)total / 1e9;
+
+  altmdm_spi_getstats(&g_dev, &stats);
+
+  if (!uplink)
+    {
+      printf("rxbuffers %d: %u x %d bytes in %.3f sec: %.1f KiB/sec, "
+             "bus %.0f%%, nobuff %u, stalls %u, stalled %.1f ms, "
+             "errors %u\n",
+             BENCH_RXBUFF_NUM, count, size, elapsed,
+             (double)count * size / 1024.0 / elapsed,
+             100.0 * (g_modem.bus_ns - bus_start) / total,
+             stats.rx_nobuff, stats.rx_stalls,
+             stats.rx_stall_us / 1000.0, errors);
+    }
+  else
+    {
+      printf("coalesce %s: %u x %d bytes from %d writer(s) in %.3f sec: "
+             "%.1f KiB/sec, %.0f packets/sec, frames %u, "
+             "packets/frame %.2f, retries %u, lost %u, errors %u\n",
+             BENCH_COALESCE, count, size, nwriters, elapsed,
+             (double)g_modem.ul_bytes / 1024.0 / elapsed, count / elapsed,
+             stats.tx_frames,
+             stats.tx_frames ? (double)stats.tx_packets / stats.tx_frames :
+             0.0, stats.tx_retries, stats.tx_lost, errors);
+
+      if (g_large_size != 0)
+        {
+          struct bench_writer_s *w = &writers[nwriters - 1];
+
+          printf("%u writes of %d bytes: avg %.2f ms, max %.2f ms\n",
+                 w->count, w->size, w->total_ns / 1e6 / w->count,
+                 w->max_ns / 1e6);
+        }
+    }
+
+  pthread_mutex_lock(&g_modem.lock);
+  g_modem.stop = true;
+  pthread_cond_signal(&g_modem.cond);
+  pthread_mutex_unlock(&g_modem.lock);
+  pthread_join(retry, NULL);
+
+  altmdm_spi_disable(&g_dev);
+  altmdm_spi_uninit(&g_dev);
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
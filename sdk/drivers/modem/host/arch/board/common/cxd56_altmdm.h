@@ -0,0 +1,59 @@
+/****************************************************************************
+ * drivers/modem/host/arch/board/common/cxd56_altmdm.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Board interface of the driver.  The master request line and the slave
+ * request interrupt are wired to the fake modem of the benchmark.
+ */
+
+#ifndef __DRIVERS_MODEM_HOST_ARCH_BOARD_COMMON_CXD56_ALTMDM_H
+#define __DRIVERS_MODEM_HOST_ARCH_BOARD_COMMON_CXD56_ALTMDM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <nuttx/irq.h>
+
+#define ALTMDM_GPIO_MODEM_WAKEUP            (0)
+#define ALTMDM_GPIO_MASTER_REQ              (1)
+#define ALTMDM_GPIO_SLAVE_REQ               (2)
+
+#define ALTMDM_GPIOINT_LEVEL_HIGH           (0)
+#define ALTMDM_GPIOINT_NOISE_FILTER_DISABLE (1)
+
+void board_altmdm_gpio_write(uint32_t pin, bool value);
+void board_altmdm_gpio_irq(uint32_t pin, uint32_t polarity,
+                           uint32_t noise_filter, xcpt_t irqhandler);
+void board_altmdm_gpio_int_control(uint32_t pin, bool en);
+
+#endif /* __DRIVERS_MODEM_HOST_ARCH_BOARD_COMMON_CXD56_ALTMDM_H */
@@ -0,0 +1,59 @@
+/****************************************************************************
+ * drivers/modem/host/nuttx/spi/spi.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* SPI interface of the driver.  SPI_EXCHANGE() is answered by the fake
+ * modem of the benchmark, the other methods do nothing.
+ */
+
+#ifndef __DRIVERS_MODEM_HOST_NUTTX_SPI_SPI_H
+#define __DRIVERS_MODEM_HOST_NUTTX_SPI_SPI_H
+
+#include <stddef.h>
+#include <nuttx/irq.h>
+
+#define SPIDEV_MODE0                0
+
+#define SPI_LOCK(d,l)               (0)
+#define SPI_SETMODE(d,m)
+#define SPI_SETBITS(d,b)
+#define SPI_SETFREQUENCY(d,f)       (f)
+#define SPI_EXCHANGE(d,t,r,n)       bench_spi_exchange(d,t,r,n)
+
+struct spi_dev_s;
+
+void bench_spi_exchange(struct spi_dev_s *dev, const void *txbuffer,
+                        void *rxbuffer, size_t nwords);
+
+#endif /* __DRIVERS_MODEM_HOST_NUTTX_SPI_SPI_H */
@@ -0,0 +1,64 @@
+/****************************************************************************
+ * drivers/modem/host/sdk/config.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Minimal configuration for building the ALTMDM SPI driver on the host.
+ * The number of receive buffers and the transmit coalescing are given by
+ * the Makefile for each variant of the benchmark.
+ */
+
+#ifndef __DRIVERS_MODEM_HOST_SDK_CONFIG_H
+#define __DRIVERS_MODEM_HOST_SDK_CONFIG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <unistd.h>
+#include <errno.h>
+
+#define OK    0
+#define ERROR -1
+#define FAR
+
+#define CONFIG_MODEM                    1
+#define CONFIG_MODEM_ALTMDM             1
+#define CONFIG_MODEM_ALTMDM_PROTCOL_V2_1 1
+
+/* NuttX task interface, run on a pthread by the benchmark */
+
+int task_create(const char *name, int priority, int stack_size,
+                int (*entry)(int argc, char *argv[]), char * const argv[]);
+int task_delete(pid_t pid);
+
+#endif /* __DRIVERS_MODEM_HOST_SDK_CONFIG_H */
@@ -0,0 +1,326 @@
+/****************************************************************************
+ * modules/asmp/mpchan/host/mpchanbench.c
+ *
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark of MP channel against one MP message queue message per
+ *   data word.  A producer thread stands for the worker and a consumer
+ *   thread for the supervisor, the shared memory is plain heap memory and
+ *   the MP message queue is emulated with pipes (see mpmq.c).  Each message
+ *   carries the time it was sent, the report shows the throughput, the
+ *   mean and maximum latency and the number of notifications, i.e. of
+ *   inter-CPU interrupts on the target.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <asmp/types.h>
+#include <asmp/mpmq.h>
+#include <asmp/mpchan.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_SUPERVISOR  2
+#define BENCH_WORKER      3
+#define BENCH_MSGID       1
+#define BENCH_RXBATCH     64
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static unsigned long g_nmsgs = 1000000;
+static int g_batch = 16;
+static int g_pace;
+static size_t g_ringsize = 16 * 1024;
+static bool g_usechan;
+
+static void *g_shm;
+
+static unsigned long long g_latsum;
+static uint32_t g_latmax;
+static uint32_t g_laststamp;
+static bool g_disordered;
+
+extern unsigned long g_mpmq_nsent;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t bench_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+static void bench_latency(uint32_t stamp)
+{
+  uint32_t lat = bench_now() - stamp;
+
+  /* Messages must arrive in the order they were sent */
+
+  if ((int32_t)(stamp - g_laststamp) < 0)
+    {
+      g_disordered = true;
+    }
+
+  g_laststamp = stamp;
+  g_latsum += lat;
+  if (lat > g_latmax)
+    {
+      g_latmax = lat;
+    }
+}
+
+static void *producer(void *arg)
+{
+  uint32_t msgs[256];
+  mpchan_t ch;
+  mpmq_t mq;
+  unsigned long i;
+  int sent;
+  int ret;
+  int j;
+
+  mpmq_init(&mq, BENCH_WORKER + 1, BENCH_SUPERVISOR);
+  if (g_usechan)
+    {
+      mpchan_init(&ch, g_shm, g_ringsize, sizeof(uint32_t), &mq,
+                  BENCH_MSGID, 0);
+    }
+
+  for (i = 0; i < g_nmsgs; i += g_batch)
+    {
+      int n = g_nmsgs - i < (unsigned long)g_batch ? g_nmsgs - i : g_batch;
+
+      if (g_usechan)
+        {
+          uint32_t stamp = bench_now();
+
+          for (j = 0; j < n; j++)
+            {
+              msgs[j] = stamp;
+            }
+
+          for (sent = 0; sent < n; sent += ret)
+            {
+              ret = mpchan_send(&ch, &msgs[sent], n - sent);
+              if (ret == 0)
+                {
+                  sched_yield();
+                }
+            }
+        }
+      else
+        {
+          for (j = 0; j < n; j++)
+            {
+              mpmq_send(&mq, BENCH_MSGID, bench_now());
+            }
+        }
+
+      if (g_pace > 0)
+        {
+          usleep(g_pace);
+        }
+    }
+
+  return NULL;
+}
+
+static void consumer(void)
+{
+  uint32_t msgs[BENCH_RXBATCH];
+  unsigned long i;
+  mpchan_t ch;
+  mpmq_t mq;
+  int ret;
+  int j;
+
+  mpmq_init(&mq, BENCH_SUPERVISOR + 1, BENCH_WORKER);
+  if (g_usechan)
+    {
+      mpchan_init(&ch, g_shm, g_ringsize, sizeof(uint32_t), &mq,
+                  BENCH_MSGID, 0);
+    }
+
+  for (i = 0; i < g_nmsgs; i += ret)
+    {
+      if (g_usechan)
+        {
+          ret = mpchan_receive(&ch, msgs, BENCH_RXBATCH);
+        }
+      else
+        {
+          ret = mpmq_receive(&mq, &msgs[0]) < 0 ? -1 : 1;
+        }
+
+      if (ret < 0)
+        {
+          fprintf(stderr, "ERROR: receive failed\n");
+          exit(EXIT_FAILURE);
+        }
+
+      for (j = 0; j < ret; j++)
+        {
+          bench_latency(msgs[j]);
+        }
+    }
+}
+
+static void show_usage(const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-c] [-n <count>] [-b <batch>] [-p <usec>] "
+                  "[-s <size>]\n", progname);
+  fprintf(stderr, "\t-c: Use MP channel instead of one MP message queue "
+                  "message per word\n");
+  fprintf(stderr, "\t-n <count>: Number of messages. Default: %lu\n",
+                  g_nmsgs);
+  fprintf(stderr, "\t-b <batch>: Messages sent at once (max 256). "
+                  "Default: %d\n", g_batch);
+  fprintf(stderr, "\t-p <usec>: Pause after each batch. Default: none\n");
+  fprintf(stderr, "\t-s <size>: Ring size in bytes. Default: %lu\n",
+                  (unsigned long)g_ringsize);
+  exit(errcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  struct timespec start;
+  struct timespec end;
+  pthread_t thread;
+  mpchan_t ch;
+  mpmq_t mq;
+  double elapsed;
+  int option;
+
+  while ((option = getopt(argc, argv, "cn:b:p:s:h")) != -1)
+    {
+      switch (option)
+        {
+          case 'c':
+            g_usechan = true;
+            break;
+
+          case 'n':
+            g_nmsgs = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'b':
+            g_batch = atoi(optarg);
+            break;
+
+          case 'p':
+            g_pace = atoi(optarg);
+            break;
+
+          case 's':
+            g_ringsize = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (g_batch < 1 || g_batch > 256)
+    {
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+
+  /* The supervisor formats the ring before the worker starts */
+
+  if (g_usechan)
+    {
+      g_shm = aligned_alloc(MPCHAN_CACHELINE, g_ringsize);
+      mpmq_init(&mq, BENCH_SUPERVISOR + 1, BENCH_WORKER);
+      if (!g_shm ||
+          mpchan_init(&ch, g_shm, g_ringsize, sizeof(uint32_t), &mq,
+                      BENCH_MSGID, MPCHAN_CREATE) < 0)
+        {
+          fprintf(stderr, "ERROR: Failed to create the channel\n");
+          return EXIT_FAILURE;
+        }
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  g_laststamp = bench_now();
+  pthread_create(&thread, NULL, producer, NULL);
+  consumer();
+  pthread_join(thread, NULL);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  elapsed = (double)(end.tv_sec - start.tv_sec) +
+            (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+  printf("%-6s batch %3d: %lu msgs in %.3f sec: %.0f msgs/sec, "
+         "latency mean %.1f us max %.1f us, %lu notifications%s\n",
+         g_usechan ? "mpchan" : "mpmq", g_batch, g_nmsgs, elapsed,
+         (double)g_nmsgs / elapsed, (double)g_latsum / g_nmsgs / 1000.0,
+         (double)g_latmax / 1000.0, g_mpmq_nsent,
+         g_disordered ? ", ORDER BROKEN" : "");
+
+  free(g_shm);
+  return g_disordered ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+/****************************************************************************
+ * modules/asmp/mpchan/host/mpmq.c
+ *
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host emulation of the MP message queue for mpchanbench.  CPUs are
+ *   threads, and every CPU has a pipe which receives the messages sent to
+ *   it, so that sending a message costs a system call and wakes up the
+ *   receiving thread like the ICC interrupt does on the target.  The key
+ *   given to mpmq_init() is the CPU ID of the calling thread plus one.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <asmp/types.h>
+#include <asmp/mpmq.h>
+
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NCPUS 8
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static int g_pipe[NCPUS][2] =
+{
+  { -1, -1 }, { -1, -1 }, { -1, -1 }, { -1, -1 },
+  { -1, -1 }, { -1, -1 }, { -1, -1 }, { -1, -1 }
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Number of messages sent, for the benchmark report */
+
+unsigned long g_mpmq_nsent;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int mpmq_init(mpmq_t *mq, key_t key, cpuid_t cpuid)
+{
+  int self = key - 1;
+
+  if (!mq || self < 0 || self >= NCPUS || cpuid < 0 || cpuid >= NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  memset(mq, 0, sizeof(mpmq_t));
+  mpobj_init(mq, MQ, key);
+  mq->cpuid = cpuid;
+
+  if (g_pipe[self][0] < 0 && pipe(g_pipe[self]) < 0)
+    {
+      return -errno;
+    }
+
+  if (g_pipe[cpuid][0] < 0 && pipe(g_pipe[cpuid]) < 0)
+    {
+      return -errno;
+    }
+
+  return OK;
+}
+
+int mpmq_destroy(mpmq_t *mq)
+{
+  return OK;
+}
+
+int mpmq_send(mpmq_t *mq, int8_t msgid, uint32_t data)
+{
+  uint32_t msg[2];
+
+  msg[0] = (uint32_t)msgid;
+  msg[1] = data;
+
+  __sync_fetch_and_add(&g_mpmq_nsent, 1);
+  return write(g_pipe[mq->cpuid][1], msg, sizeof(msg)) == sizeof(msg) ?
+         OK : -EIO;
+}
+
+int mpmq_timedsend(mpmq_t *mq, int8_t msgid, uint32_t data, uint32_t ms)
+{
+  return mpmq_send(mq, msgid, data);
+}
+
+int mpmq_timedreceive(mpmq_t *mq, uint32_t *data, uint32_t ms)
+{
+  struct pollfd fds;
+  uint32_t msg[2];
+  int fd = g_pipe[mq->super.key - 1][0];
+
+  fds.fd     = fd;
+  fds.events = POLLIN;
+
+  if (poll(&fds, 1, ms == MPMQ_NONBLOCK ? 0 : ms == 0 ? -1 : (int)ms) <= 0)
+    {
+      return ms == MPMQ_NONBLOCK ? -EAGAIN : -ETIMEDOUT;
+    }
+
+  if (read(fd, msg, sizeof(msg)) != sizeof(msg))
+    {
+      return -EIO;
+    }
+
+  if (data)
+    {
+      *data = msg[1];
+    }
+
+  return (int)msg[0];
+}
+
+int mpmq_receive(mpmq_t *mq, uint32_t *data)
+{
+  return mpmq_timedreceive(mq, data, 0);
+}
+
+int mpmq_notify(mpmq_t *mq, int signo, void *sigdata)
+{
+  return -ENOSYS;
+}
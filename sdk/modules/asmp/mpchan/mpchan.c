@@ -0,0 +1,347 @@
+/****************************************************************************
+ * modules/asmp/mpchan/mpchan.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <asmp/types.h>
+#include <asmp/mpmq.h>
+#include <asmp/mpchan.h>
+
+#include <stddef.h>
+#include <errno.h>
+
+/* This file is shared by the supervisor and the worker library, so it only
+ * uses the MP message queue API, which both of them provide.
+ */
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MPCHAN_MAGIC     0x4843504d  /* "MPCH" */
+
+/* Memory barrier between the data and the index accesses of the ring. The
+ * other side runs on another CPU, so a compiler barrier is not enough.
+ */
+
+#if defined(__arm__)
+#  define mpchan_barrier() __asm__ __volatile__ ("dmb" : : : "memory")
+#else
+#  define mpchan_barrier() __sync_synchronize()
+#endif
+
+#define MPCHAN_WORDS(s)  (((s) + 3) / 4)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Ring header in the shared memory. Each index is written by one side only
+ * and lives on its own cache line, so that the producer and the consumer
+ * don't invalidate each other's line on every message.
+ */
+
+struct mpchan_ring
+{
+  volatile uint32_t head;       /* Written by the producer */
+  uint32_t reserved0[MPCHAN_CACHELINE / 4 - 1];
+  volatile uint32_t tail;       /* Written by the consumer */
+  uint32_t reserved1[MPCHAN_CACHELINE / 4 - 1];
+  uint32_t magic;               /* Written once by MPCHAN_CREATE */
+  uint32_t depth;
+  uint32_t msgsize;
+  uint32_t reserved2[MPCHAN_CACHELINE / 4 - 3];
+  uint32_t data[0];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline struct mpchan_ring *mpchan_ring(mpchan_t *ch)
+{
+  return (struct mpchan_ring *)ch->ring;
+}
+
+/* Copy messages in words, the worker has no C library */
+
+static void mpchan_copy(uint32_t *dst, const uint32_t *src, uint32_t nwords)
+{
+  while (nwords-- > 0)
+    {
+      *dst++ = *src++;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/**
+ * Initialize MP channel
+ */
+
+int mpchan_init(mpchan_t *ch, void *buf, size_t size, size_t msgsize,
+                mpmq_t *mq, int8_t msgid, int flags)
+{
+  struct mpchan_ring *ring = (struct mpchan_ring *)buf;
+  uint32_t depth;
+
+  if (!ch || !buf || !mq || msgsize == 0 || msgsize > UINT16_MAX ||
+      ((uintptr_t)buf & (MPCHAN_CACHELINE - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  msgsize = MPCHAN_WORDS(msgsize) * 4;
+
+  if (size < MPCHAN_HDRSIZE + 2 * msgsize)
+    {
+      return -ENOMEM;
+    }
+
+  /* Power of two number of messages, so that the free running indices
+   * can be masked.
+   */
+
+  for (depth = 2; depth * 2 <= (size - MPCHAN_HDRSIZE) / msgsize;
+       depth *= 2);
+
+  if (flags & MPCHAN_CREATE)
+    {
+      ring->head    = 0;
+      ring->tail    = 0;
+      ring->depth   = depth;
+      ring->msgsize = msgsize;
+      mpchan_barrier();
+      ring->magic   = MPCHAN_MAGIC;
+      mpchan_barrier();
+    }
+  else if (ring->magic != MPCHAN_MAGIC || ring->msgsize != msgsize ||
+           ring->depth > depth)
+    {
+      return -ENOENT;
+    }
+
+  ch->ring    = ring;
+  ch->mq      = mq;
+  ch->msgid   = msgid;
+  ch->flags   = flags;
+  ch->msgsize = msgsize;
+  ch->depth   = ring->depth;
+  ch->head    = ring->head;
+  ch->tail    = ring->tail;
+
+  return OK;
+}
+
+/**
+ * Destroy MP channel
+ */
+
+int mpchan_destroy(mpchan_t *ch)
+{
+  if (!ch)
+    {
+      return -EINVAL;
+    }
+
+  ch->ring = NULL;
+  ch->mq   = NULL;
+
+  return OK;
+}
+
+/**
+ * Send messages via MP channel
+ */
+
+int mpchan_send(mpchan_t *ch, const void *msgs, int nmsgs)
+{
+  struct mpchan_ring *ring;
+  const uint32_t *src = (const uint32_t *)msgs;
+  uint32_t msgwords;
+  uint32_t head;
+  uint32_t space;
+  uint32_t index;
+  uint32_t n;
+  uint32_t i;
+
+  if (!ch || !ch->ring || !msgs || nmsgs < 0)
+    {
+      return -EINVAL;
+    }
+
+  ring     = mpchan_ring(ch);
+  msgwords = ch->msgsize / 4;
+  head     = ch->head;
+
+  /* Only look at the consumer index when the cached one shows too little
+   * space, this keeps the consumer's cache line out of the fast path.
+   */
+
+  space = ch->depth - (head - ch->tail);
+  if (space < (uint32_t)nmsgs)
+    {
+      ch->tail = ring->tail;
+      space    = ch->depth - (head - ch->tail);
+    }
+
+  n = space < (uint32_t)nmsgs ? space : (uint32_t)nmsgs;
+  if (n == 0)
+    {
+      return 0;
+    }
+
+  /* Copy the messages in at most two chunks around the end of the ring */
+
+  index = head & (ch->depth - 1);
+  i     = ch->depth - index < n ? ch->depth - index : n;
+
+  mpchan_copy(&ring->data[index * msgwords], src, i * msgwords);
+  mpchan_copy(&ring->data[0], src + i * msgwords, (n - i) * msgwords);
+
+  /* Publish the messages, then check whether the consumer had emptied the
+   * ring. The second barrier pairs with the one in mpchan_timedreceive(), so
+   * that either the consumer sees the new head, or we see its final tail and
+   * ring the doorbell.
+   */
+
+  mpchan_barrier();
+  ring->head = head + n;
+  ch->head   = head + n;
+  mpchan_barrier();
+
+  ch->tail = ring->tail;
+  if (ch->tail == head)
+    {
+      (void)mpmq_send(ch->mq, ch->msgid, head + n);
+    }
+
+  return (int)n;
+}
+
+/**
+ * Receive messages via MP channel
+ */
+
+int mpchan_receive(mpchan_t *ch, void *msgs, int nmsgs)
+{
+  return mpchan_timedreceive(ch, msgs, nmsgs, 0);
+}
+
+/**
+ * Receive messages via MP channel with timeout
+ */
+
+int mpchan_timedreceive(mpchan_t *ch, void *msgs, int nmsgs, uint32_t ms)
+{
+  struct mpchan_ring *ring;
+  uint32_t *dst = (uint32_t *)msgs;
+  uint32_t msgwords;
+  uint32_t avail;
+  uint32_t index;
+  uint32_t tail;
+  uint32_t data;
+  uint32_t n;
+  uint32_t i;
+  int ret;
+
+  if (!ch || !ch->ring || !msgs || nmsgs <= 0)
+    {
+      return -EINVAL;
+    }
+
+  ring     = mpchan_ring(ch);
+  msgwords = ch->msgsize / 4;
+  tail     = ch->tail;
+
+  for (; ; )
+    {
+      avail = ch->head - tail;
+      if (avail == 0)
+        {
+          /* Order our last tail update before reading the head, see
+           * mpchan_send().
+           */
+
+          mpchan_barrier();
+          ch->head = ring->head;
+          mpchan_barrier();
+          avail = ch->head - tail;
+        }
+
+      if (avail > 0)
+        {
+          break;
+        }
+
+      if (ms == MPMQ_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      /* The ring is empty. The producer rings the doorbell for the next
+       * message, a stale doorbell just causes another round.
+       */
+
+      ret = mpmq_timedreceive(ch->mq, &data, ms);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  n = avail < (uint32_t)nmsgs ? avail : (uint32_t)nmsgs;
+
+  index = tail & (ch->depth - 1);
+  i     = ch->depth - index < n ? ch->depth - index : n;
+
+  mpchan_copy(dst, &ring->data[index * msgwords], i * msgwords);
+  mpchan_copy(dst + i * msgwords, &ring->data[0], (n - i) * msgwords);
+
+  /* Release the slots only after they have been read */
+
+  mpchan_barrier();
+  ring->tail = tail + n;
+  ch->tail   = tail + n;
+
+  return (int)n;
+}
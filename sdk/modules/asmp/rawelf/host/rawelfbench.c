@@ -0,0 +1,511 @@
+/****************************************************************************
+ * modules/asmp/rawelf/host/rawelfbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark for the worker ELF loader.  A worker-like ELF file is
+ *   generated and loaded repeatedly with the same calls as mptask_exec():
+ *   rawelf_init(), rawelf_load(), a lookup of the bind data symbol and
+ *   rawelf_uninit().  The loaded image and the symbol are verified, and the
+ *   time and the number of read() and lseek() calls of the first and of the
+ *   following loads are reported.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <utime.h>
+#include <errno.h>
+
+#include "../rawelf.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_SYMNAME   "mpframework_reserved"
+#define BENCH_TEXTSIZE  (96 * 1024)
+#define BENCH_DATASIZE  (8 * 1024)
+#define BENCH_BSSSIZE   (16 * 1024)
+#define BENCH_BINDOFF   256
+
+/* Section indexes of the generated file */
+
+enum
+{
+  SECT_NULL = 0,
+  SECT_TEXT,
+  SECT_DATA,
+  SECT_BSS,
+  SECT_SYMTAB,
+  SECT_STRTAB,
+  SECT_SHSTRTAB,
+  SECT_NUM
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static unsigned long g_nreads;
+static unsigned long g_nseeks;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+ssize_t __real_read(int fd, void *buf, size_t count);
+off_t __real_lseek(int fd, off_t offset, int whence);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint8_t pattern(uint32_t offset, uint32_t seed)
+{
+  return (uint8_t)((offset * 2654435761u + seed) >> 13);
+}
+
+static int make_elf(FAR const char *path, int nsyms, uint32_t seed)
+{
+  static const char shstrtab[] =
+    "\0.text\0.data\0.bss\0.symtab\0.strtab\0.shstrtab";
+  Elf32_Shdr shdr[SECT_NUM];
+  Elf32_Ehdr ehdr;
+  FAR Elf32_Sym *syms;
+  FAR uint8_t *file;
+  FAR char *strtab;
+  size_t strsize;
+  size_t off;
+  size_t len;
+  uint32_t sp;
+  int fd;
+  int i;
+
+  /* The names are "sym_0000" ... and the bind data symbol is the last */
+
+  strsize = 1 + nsyms * 9 + sizeof(BENCH_SYMNAME);
+  strtab  = calloc(1, strsize);
+  syms    = calloc(nsyms + 2, sizeof(Elf32_Sym));
+  file    = calloc(1, BENCH_TEXTSIZE + BENCH_DATASIZE + strsize +
+                      (nsyms + 2) * sizeof(Elf32_Sym) + 4096);
+  if (!strtab || !syms || !file)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0, len = 1; i < nsyms; i++)
+    {
+      syms[i + 1].st_name  = len;
+      syms[i + 1].st_value = (i * 64) % BENCH_TEXTSIZE;
+      syms[i + 1].st_info  = ELF32_ST_INFO(STB_GLOBAL, STT_FUNC);
+      syms[i + 1].st_shndx = SECT_TEXT;
+      len += sprintf(&strtab[len], "sym_%04d", i) + 1;
+    }
+
+  syms[nsyms + 1].st_name  = len;
+  syms[nsyms + 1].st_value = BENCH_TEXTSIZE + BENCH_BINDOFF;
+  syms[nsyms + 1].st_size  = 64;
+  syms[nsyms + 1].st_info  = ELF32_ST_INFO(STB_GLOBAL, STT_OBJECT);
+  syms[nsyms + 1].st_shndx = SECT_DATA;
+  strcpy(&strtab[len], BENCH_SYMNAME);
+
+  memset(shdr, 0, sizeof(shdr));
+  off = 0x100;
+
+  shdr[SECT_TEXT].sh_name      = 1;
+  shdr[SECT_TEXT].sh_type      = SHT_PROGBITS;
+  shdr[SECT_TEXT].sh_flags     = SHF_ALLOC | SHF_EXECINSTR;
+  shdr[SECT_TEXT].sh_addr      = 0;
+  shdr[SECT_TEXT].sh_offset    = off;
+  shdr[SECT_TEXT].sh_size      = BENCH_TEXTSIZE;
+  off += BENCH_TEXTSIZE;
+
+  shdr[SECT_DATA].sh_name      = 7;
+  shdr[SECT_DATA].sh_type      = SHT_PROGBITS;
+  shdr[SECT_DATA].sh_flags     = SHF_ALLOC | SHF_WRITE;
+  shdr[SECT_DATA].sh_addr      = BENCH_TEXTSIZE;
+  shdr[SECT_DATA].sh_offset    = off;
+  shdr[SECT_DATA].sh_size      = BENCH_DATASIZE;
+  off += BENCH_DATASIZE;
+
+  shdr[SECT_BSS].sh_name       = 13;
+  shdr[SECT_BSS].sh_type       = SHT_NOBITS;
+  shdr[SECT_BSS].sh_flags      = SHF_ALLOC | SHF_WRITE;
+  shdr[SECT_BSS].sh_addr       = BENCH_TEXTSIZE + BENCH_DATASIZE;
+  shdr[SECT_BSS].sh_offset     = off;
+  shdr[SECT_BSS].sh_size       = BENCH_BSSSIZE;
+
+  shdr[SECT_SYMTAB].sh_name    = 18;
+  shdr[SECT_SYMTAB].sh_type    = SHT_SYMTAB;
+  shdr[SECT_SYMTAB].sh_offset  = off;
+  shdr[SECT_SYMTAB].sh_size    = (nsyms + 2) * sizeof(Elf32_Sym);
+  shdr[SECT_SYMTAB].sh_link    = SECT_STRTAB;
+  shdr[SECT_SYMTAB].sh_entsize = sizeof(Elf32_Sym);
+  off += shdr[SECT_SYMTAB].sh_size;
+
+  shdr[SECT_STRTAB].sh_name    = 26;
+  shdr[SECT_STRTAB].sh_type    = SHT_STRTAB;
+  shdr[SECT_STRTAB].sh_offset  = off;
+  shdr[SECT_STRTAB].sh_size    = strsize;
+  off += strsize;
+
+  shdr[SECT_SHSTRTAB].sh_name   = 34;
+  shdr[SECT_SHSTRTAB].sh_type   = SHT_STRTAB;
+  shdr[SECT_SHSTRTAB].sh_offset = off;
+  shdr[SECT_SHSTRTAB].sh_size   = sizeof(shstrtab);
+  off += sizeof(shstrtab);
+  off  = (off + 3) & ~3;
+
+  memset(&ehdr, 0, sizeof(ehdr));
+  memcpy(ehdr.e_ident, ELFMAG, SELFMAG);
+  ehdr.e_ident[EI_CLASS]   = ELFCLASS32;
+  ehdr.e_ident[EI_DATA]    = ELFDATA2LSB;
+  ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+  ehdr.e_type      = ET_EXEC;
+  ehdr.e_machine   = EM_ARM;
+  ehdr.e_version   = EV_CURRENT;
+  ehdr.e_ehsize    = sizeof(Elf32_Ehdr);
+  ehdr.e_shoff     = off;
+  ehdr.e_shentsize = sizeof(Elf32_Shdr);
+  ehdr.e_shnum     = SECT_NUM;
+  ehdr.e_shstrndx  = SECT_SHSTRTAB;
+
+  /* Section contents.  The first word of .text is the initial stack
+   * pointer, at the top of the memory of the worker.
+   */
+
+  memcpy(file, &ehdr, sizeof(ehdr));
+  for (i = 0; i < BENCH_TEXTSIZE + BENCH_DATASIZE; i++)
+    {
+      file[0x100 + i] = pattern(i, seed);
+    }
+
+  sp = BENCH_TEXTSIZE + BENCH_DATASIZE + BENCH_BSSSIZE + 1024;
+  memcpy(&file[0x100], &sp, sizeof(sp));
+  memcpy(&file[shdr[SECT_SYMTAB].sh_offset], syms, shdr[SECT_SYMTAB].sh_size);
+  memcpy(&file[shdr[SECT_STRTAB].sh_offset], strtab, strsize);
+  memcpy(&file[shdr[SECT_SHSTRTAB].sh_offset], shstrtab, sizeof(shstrtab));
+
+  fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0 ||
+      write(fd, file, off) != (ssize_t)off ||
+      write(fd, shdr, sizeof(shdr)) != (ssize_t)sizeof(shdr))
+    {
+      return -EIO;
+    }
+
+  close(fd);
+  free(file);
+  free(syms);
+  free(strtab);
+  return OK;
+}
+
+static int verify_image(FAR const uint8_t *image, uint32_t seed)
+{
+  uint32_t sp;
+  int i;
+
+  memcpy(&sp, image, sizeof(sp));
+  if (sp != BENCH_TEXTSIZE + BENCH_DATASIZE + BENCH_BSSSIZE + 1024)
+    {
+      return ERROR;
+    }
+
+  for (i = sizeof(sp); i < BENCH_TEXTSIZE + BENCH_DATASIZE; i++)
+    {
+      if (image[i] != pattern(i, seed))
+        {
+          return ERROR;
+        }
+    }
+
+  for (; i < BENCH_TEXTSIZE + BENCH_DATASIZE + BENCH_BSSSIZE; i++)
+    {
+      if (image[i] != 0)
+        {
+          return ERROR;
+        }
+    }
+
+  return OK;
+}
+
+/* Load the file as mptask_exec() does, and return the image */
+
+static int load_worker(FAR const char *path, FAR uint8_t **image,
+                       FAR uint32_t *binddata)
+{
+  struct rawelf_loadinfo_s loadinfo;
+  struct stat buf;
+  Elf32_Sym sym;
+  int ret;
+
+  memset(&loadinfo, 0, sizeof(struct rawelf_loadinfo_s));
+
+  loadinfo.filfd = open(path, O_RDONLY);
+  if (loadinfo.filfd < 0 || fstat(loadinfo.filfd, &buf) < 0)
+    {
+      return -errno;
+    }
+
+  loadinfo.filelen = buf.st_size;
+  ret = rawelf_init(&loadinfo);
+  if (ret < 0)
+    {
+      close(loadinfo.filfd);
+      return ret;
+    }
+
+  ret = rawelf_load(&loadinfo);
+  if (ret < 0)
+    {
+      rawelf_uninit(&loadinfo);
+      return ret;
+    }
+
+  ret = rawelf_findsymtab(&loadinfo);
+  if (ret == OK)
+    {
+      ret = rawelf_allocbuffer(&loadinfo);
+    }
+
+  if (ret == OK)
+    {
+      ret = rawelf_getsymbolbyname(&loadinfo, BENCH_SYMNAME,
+                                   strlen(BENCH_SYMNAME), &sym);
+    }
+
+  if (ret < 0)
+    {
+      rawelf_unload(&loadinfo);
+      rawelf_uninit(&loadinfo);
+      return ret;
+    }
+
+  *image    = (FAR uint8_t *)loadinfo.textalloc;
+  *binddata = sym.st_value;
+
+  rawelf_uninit(&loadinfo);
+  return OK;
+}
+
+static double now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static int run(FAR const char *path, FAR const char *label, int nloads,
+               uint32_t seed)
+{
+  FAR uint8_t *image;
+  uint32_t binddata;
+  unsigned long nreads = 0;
+  unsigned long nseeks = 0;
+  double total = 0.0;
+  double start;
+  double elapsed;
+  int ret;
+  int i;
+
+  for (i = 0; i < nloads; i++)
+    {
+      g_nreads = 0;
+      g_nseeks = 0;
+
+      start = now();
+      ret = load_worker(path, &image, &binddata);
+      elapsed = now() - start;
+
+      if (ret < 0)
+        {
+          fprintf(stderr, "ERROR: load failed: %d\n", ret);
+          return ret;
+        }
+
+      if (verify_image(image, seed) < 0 ||
+          binddata != BENCH_TEXTSIZE + BENCH_BINDOFF)
+        {
+          fprintf(stderr, "ERROR: %s load %d: image mismatch\n", label, i);
+          free(image);
+          return ERROR;
+        }
+
+      free(image);
+
+      if (i == 0)
+        {
+          printf("%-8s first load: %8.1f us, %4lu reads, %4lu seeks\n",
+                 label, elapsed, g_nreads, g_nseeks);
+        }
+      else
+        {
+          total  += elapsed;
+          nreads += g_nreads;
+          nseeks += g_nseeks;
+        }
+    }
+
+  if (nloads > 1)
+    {
+      printf("%-8s next loads: %8.1f us, %4lu reads, %4lu seeks (mean)\n",
+             label, total / (nloads - 1), nreads / (nloads - 1),
+             nseeks / (nloads - 1));
+    }
+
+  return OK;
+}
+
+static void show_usage(FAR const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-n <loads>] [-s <symbols>] [-h]\n", progname);
+  fprintf(stderr, "\t-n <loads>: Number of loads. Default: 100\n");
+  fprintf(stderr, "\t-s <symbols>: Number of symbols. Default: 600\n");
+  fprintf(stderr, "\t-h: Show this text and exit\n");
+  exit(errcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+ssize_t __wrap_read(int fd, void *buf, size_t count)
+{
+  g_nreads++;
+  return __real_read(fd, buf, count);
+}
+
+off_t __wrap_lseek(int fd, off_t offset, int whence)
+{
+  g_nseeks++;
+  return __real_lseek(fd, offset, whence);
+}
+
+int main(int argc, FAR char **argv)
+{
+  struct utimbuf times;
+  char path[64];
+  int nloads = 100;
+  int nsyms = 600;
+  uint32_t seed;
+  int option;
+  int ret;
+
+  while ((option = getopt(argc, argv, "n:s:h")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'n':
+            nloads = atoi(optarg);
+            break;
+
+          case 's':
+            nsyms = atoi(optarg);
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  snprintf(path, sizeof(path), "/tmp/rawelfbench-%d.elf", (int)getpid());
+
+  ret = make_elf(path, nsyms, 1);
+  if (ret == OK)
+    {
+      ret = run(path, "worker", nloads, 1);
+    }
+
+  /* Replace the file with different contents of the same layout, as a
+   * rebuilt worker would be.  The new contents must be loaded.
+   */
+
+  if (ret == OK)
+    {
+      ret = make_elf(path, nsyms, 2);
+      times.actime  = time(NULL) + 10;
+      times.modtime = times.actime;
+      utime(path, &times);
+    }
+
+  if (ret == OK)
+    {
+      ret = run(path, "rebuilt", 2, 2);
+    }
+
+  /* Rebuild it twice on a file system without modification times, as
+   * smartfs is.  Both contents must be loaded.
+   */
+
+  for (seed = 3; ret == OK && seed <= 4; seed++)
+    {
+      ret = make_elf(path, nsyms, seed);
+      times.actime  = 0;
+      times.modtime = 0;
+      utime(path, &times);
+
+      if (ret == OK)
+        {
+          ret = run(path, "no mtime", 2, seed);
+        }
+    }
+
+  unlink(path);
+  printf("verify: %s\n", ret == OK ? "OK" : "FAILED");
+  return ret == OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
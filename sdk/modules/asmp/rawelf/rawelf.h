@@ -70,6 +70,14 @@
 #  define CONFIG_RAWELF_BUFFERINCR 32
 #endif
 
+#ifndef CONFIG_RAWELF_READBUFSIZE
+#  define CONFIG_RAWELF_READBUFSIZE 2048
+#endif
+
+#ifndef CONFIG_RAWELF_CACHE_SIZE
+#  define CONFIG_RAWELF_CACHE_SIZE 262144
+#endif
+
 /* Allocation array size and indices */
 
 #define LIBRAWELF_RAWELF_ALLOC     0
@@ -85,6 +93,36 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_RAWELF_CACHE
+/* A symbol which has been looked up in a cached ELF image */
+
+struct rawelf_cachesym_s
+{
+  FAR struct rawelf_cachesym_s *next;
+  Elf32_Sym         sym;         /* Symbol table entry */
+  size_t            namelen;     /* Length of the name used for the lookup */
+  char              name[1];     /* Name used for the lookup */
+};
+
+/* A loaded ELF image kept for the next load of the same file.  The image
+ * is the memory contents right after rawelf_load(), so a warm load is a
+ * single copy.
+ */
+
+struct rawelf_cache_s
+{
+  FAR struct rawelf_cache_s *next;
+  uint32_t          crc;         /* CRC32 of the ELF and section headers */
+  off_t             filelen;     /* Length of the ELF file */
+  time_t            mtime;       /* Modification time of the ELF file */
+  size_t            textsize;    /* Size of the .text memory allocation */
+  size_t            datasize;    /* Size of the .bss/.data memory allocation */
+  int               refs;        /* Number of loads using the entry */
+  FAR struct rawelf_cachesym_s *syms; /* Symbols looked up in the image */
+  FAR uint8_t       *image;      /* Copy of the loaded image */
+};
+#endif
+
 /* This struct provides a description of the currently loaded instantiation
  * of an ELF binary.
  */
@@ -124,6 +162,27 @@ struct rawelf_loadinfo_s
   uint16_t           strtabidx;  /* String table section index */
   uint16_t           buflen;     /* size of iobuffer[] */
   int                filfd;      /* Descriptor for the file being loaded */
+
+  /* Block read buffer.  Small reads (headers, symbols, names) are served
+   * from a block of CONFIG_RAWELF_READBUFSIZE bytes, and lseek() is only
+   * called when the file position is not the one needed.
+   */
+
+  off_t             filpos;      /* Current file position, -1 if unknown */
+  FAR uint8_t       *rdbuffer;   /* Block read buffer */
+  off_t             rdoffset;    /* File offset of rdbuffer[0] */
+  size_t            rdlen;       /* Valid bytes in rdbuffer[] */
+
+  /* Symbol and string tables read in one piece for symbol lookups */
+
+  FAR Elf32_Sym     *symtab;
+  FAR char          *strtab;
+
+#ifdef CONFIG_RAWELF_CACHE
+  FAR struct rawelf_cache_s *cache; /* Cache entry of the image, if any */
+  uint32_t          crc;         /* Cache key of the file */
+  time_t            mtime;
+#endif
 };
 
 /****************************************************************************
@@ -375,4 +434,77 @@ int rawelf_getsymbolbyname(FAR struct rawelf_loadinfo_s *loadinfo,
                            FAR const char *name, size_t namelen,
                            FAR Elf32_Sym *sym);
 
+#ifdef CONFIG_RAWELF_CACHE
+/****************************************************************************
+ * Name: rawelf_cache_lookup
+ *
+ * Description:
+ *   Look for a cached image of the ELF file whose section headers have been
+ *   loaded.  On success, the entry is referenced by loadinfo->cache and the
+ *   memory sizes are set.  Otherwise the key for rawelf_cache_store() is
+ *   kept in loadinfo.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int rawelf_cache_lookup(FAR struct rawelf_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: rawelf_cache_store
+ *
+ * Description:
+ *   Keep a copy of the image just loaded, evicting the least recently used
+ *   images which are not in use to stay within CONFIG_RAWELF_CACHE_SIZE.
+ *   A file without a modification time is not cached.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int rawelf_cache_store(FAR struct rawelf_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: rawelf_cache_release
+ *
+ * Description:
+ *   Drop the reference of loadinfo to its cache entry.
+ *
+ ****************************************************************************/
+
+void rawelf_cache_release(FAR struct rawelf_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: rawelf_cache_getsym
+ *
+ * Description:
+ *   Get a symbol looked up by an earlier load of the cached image.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int rawelf_cache_getsym(FAR struct rawelf_loadinfo_s *loadinfo,
+                        FAR const char *name, size_t namelen,
+                        FAR Elf32_Sym *sym);
+
+/****************************************************************************
+ * Name: rawelf_cache_putsym
+ *
+ * Description:
+ *   Remember a symbol looked up in the cached image.
+ *
+ ****************************************************************************/
+
+void rawelf_cache_putsym(FAR struct rawelf_loadinfo_s *loadinfo,
+                         FAR const char *name, size_t namelen,
+                         FAR const Elf32_Sym *sym);
+#endif
+
 #endif /* __ASMP_SUPERVISOR_RAWELF_RAWELF_H */
@@ -0,0 +1,432 @@
+/****************************************************************************
+ * modules/asmp/rawelf/rawelf_cache.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <crc32.h>
+#include <elf32.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "rawelf.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Cached images, the most recently used first */
+
+static FAR struct rawelf_cache_s *g_cache;
+
+/* Number of bytes used by the cached images and symbols */
+
+static size_t g_cachesize;
+
+static sem_t g_cachesem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void rawelf_cache_semtake(void)
+{
+  while (sem_wait(&g_cachesem) != 0)
+    {
+      ASSERT(errno == EINTR);
+    }
+}
+
+static void rawelf_cache_semgive(void)
+{
+  sem_post(&g_cachesem);
+}
+
+/****************************************************************************
+ * Name: rawelf_cache_free
+ *
+ * Description:
+ *   Free a cache entry which has been removed from the list.
+ *
+ ****************************************************************************/
+
+static void rawelf_cache_free(FAR struct rawelf_cache_s *entry)
+{
+  FAR struct rawelf_cachesym_s *cs;
+
+  while ((cs = entry->syms) != NULL)
+    {
+      entry->syms  = cs->next;
+      g_cachesize -= sizeof(struct rawelf_cachesym_s) + cs->namelen;
+      kmm_free(cs);
+    }
+
+  g_cachesize -= entry->textsize + entry->datasize;
+  kmm_free(entry->image);
+  kmm_free(entry);
+}
+
+/****************************************************************************
+ * Name: rawelf_cache_evict
+ *
+ * Description:
+ *   Drop the least recently used entries which are not in use until 'size'
+ *   more bytes fit in the cache.
+ *
+ ****************************************************************************/
+
+static bool rawelf_cache_evict(size_t size)
+{
+  FAR struct rawelf_cache_s *entry;
+  FAR struct rawelf_cache_s *prev;
+  FAR struct rawelf_cache_s *victim;
+  FAR struct rawelf_cache_s *vprev;
+
+  while (g_cachesize + size > CONFIG_RAWELF_CACHE_SIZE)
+    {
+      victim = NULL;
+      vprev  = NULL;
+
+      for (prev = NULL, entry = g_cache; entry;
+           prev = entry, entry = entry->next)
+        {
+          if (entry->refs == 0)
+            {
+              victim = entry;
+              vprev  = prev;
+            }
+        }
+
+      if (!victim)
+        {
+          return false;
+        }
+
+      if (vprev)
+        {
+          vprev->next = victim->next;
+        }
+      else
+        {
+          g_cache = victim->next;
+        }
+
+      binfo("Evict image crc=%08lx\n", (unsigned long)victim->crc);
+      rawelf_cache_free(victim);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rawelf_cache_lookup
+ *
+ * Description:
+ *   Look for a cached image of the ELF file whose section headers have been
+ *   loaded.  On success, the entry is referenced by loadinfo->cache and the
+ *   memory sizes are set.  Otherwise the key for rawelf_cache_store() is
+ *   kept in loadinfo.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int rawelf_cache_lookup(FAR struct rawelf_loadinfo_s *loadinfo)
+{
+  FAR struct rawelf_cache_s *entry;
+  FAR struct rawelf_cache_s *prev;
+  struct stat buf;
+  uint32_t crc;
+
+  DEBUGASSERT(loadinfo->shdr != NULL);
+
+  loadinfo->cache = NULL;
+
+  /* The key is made of the file length and modification time, and of the
+   * headers which describe every section of the image.  The headers must
+   * be taken before their addresses are updated by rawelf_load().
+   */
+
+  loadinfo->mtime = 0;
+  if (fstat(loadinfo->filfd, &buf) == 0)
+    {
+      loadinfo->mtime = buf.st_mtime;
+    }
+
+  /* Some file systems (e.g. smartfs) do not keep the modification time.
+   * A file rewritten there with the same length and headers could not be
+   * told from the cached one, so such a file is never cached.
+   */
+
+  if (loadinfo->mtime == 0)
+    {
+      return -ENOENT;
+    }
+
+  crc = crc32part((FAR const uint8_t *)&loadinfo->ehdr, sizeof(Elf32_Ehdr),
+                  0);
+  crc = crc32part((FAR const uint8_t *)loadinfo->shdr,
+                  loadinfo->ehdr.e_shnum * sizeof(Elf32_Shdr), crc);
+  loadinfo->crc = crc;
+
+  rawelf_cache_semtake();
+
+  for (prev = NULL, entry = g_cache; entry;
+       prev = entry, entry = entry->next)
+    {
+      if (entry->crc == crc && entry->filelen == loadinfo->filelen &&
+          entry->mtime == loadinfo->mtime)
+        {
+          /* Move the entry to the head of the list */
+
+          if (prev)
+            {
+              prev->next  = entry->next;
+              entry->next = g_cache;
+              g_cache     = entry;
+            }
+
+          entry->refs++;
+          loadinfo->cache    = entry;
+          loadinfo->textsize = entry->textsize;
+          loadinfo->datasize = entry->datasize;
+
+          rawelf_cache_semgive();
+
+          binfo("Cached image crc=%08lx size=%lu\n", (unsigned long)crc,
+                (unsigned long)(entry->textsize + entry->datasize));
+          return OK;
+        }
+    }
+
+  rawelf_cache_semgive();
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: rawelf_cache_store
+ *
+ * Description:
+ *   Keep a copy of the image just loaded, evicting the least recently used
+ *   images which are not in use to stay within CONFIG_RAWELF_CACHE_SIZE.
+ *   A file without a modification time is not cached.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int rawelf_cache_store(FAR struct rawelf_loadinfo_s *loadinfo)
+{
+  FAR struct rawelf_cache_s *entry;
+  size_t size = loadinfo->textsize + loadinfo->datasize;
+
+  if (loadinfo->cache || size > CONFIG_RAWELF_CACHE_SIZE)
+    {
+      return -ENOSPC;
+    }
+
+  if (loadinfo->mtime == 0)
+    {
+      return -ENOSYS;
+    }
+
+  entry = (FAR struct rawelf_cache_s *)
+    kmm_zalloc(sizeof(struct rawelf_cache_s));
+  if (!entry)
+    {
+      return -ENOMEM;
+    }
+
+  entry->crc      = loadinfo->crc;
+  entry->filelen  = loadinfo->filelen;
+  entry->mtime    = loadinfo->mtime;
+  entry->textsize = loadinfo->textsize;
+  entry->datasize = loadinfo->datasize;
+  entry->refs     = 1;
+
+  rawelf_cache_semtake();
+
+  /* Make room before allocating the copy, so that the heap used by the
+   * evicted images can be reused.
+   */
+
+  if (!rawelf_cache_evict(size))
+    {
+      rawelf_cache_semgive();
+      kmm_free(entry);
+      return -ENOSPC;
+    }
+
+  entry->image = (FAR uint8_t *)kmm_malloc(size);
+  if (!entry->image)
+    {
+      rawelf_cache_semgive();
+      kmm_free(entry);
+      return -ENOMEM;
+    }
+
+  memcpy(entry->image, (FAR const void *)loadinfo->textalloc, size);
+
+  entry->next  = g_cache;
+  g_cache      = entry;
+  g_cachesize += size;
+
+  rawelf_cache_semgive();
+
+  loadinfo->cache = entry;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rawelf_cache_release
+ *
+ * Description:
+ *   Drop the reference of loadinfo to its cache entry.
+ *
+ ****************************************************************************/
+
+void rawelf_cache_release(FAR struct rawelf_loadinfo_s *loadinfo)
+{
+  if (loadinfo->cache)
+    {
+      rawelf_cache_semtake();
+      DEBUGASSERT(loadinfo->cache->refs > 0);
+      loadinfo->cache->refs--;
+      rawelf_cache_semgive();
+
+      loadinfo->cache = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: rawelf_cache_getsym
+ *
+ * Description:
+ *   Get a symbol looked up by an earlier load of the cached image.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int rawelf_cache_getsym(FAR struct rawelf_loadinfo_s *loadinfo,
+                        FAR const char *name, size_t namelen,
+                        FAR Elf32_Sym *sym)
+{
+  FAR struct rawelf_cachesym_s *cs;
+  int ret = -ENOENT;
+
+  if (!loadinfo->cache)
+    {
+      return -ENOENT;
+    }
+
+  rawelf_cache_semtake();
+
+  for (cs = loadinfo->cache->syms; cs; cs = cs->next)
+    {
+      if (cs->namelen == namelen && memcmp(cs->name, name, namelen) == 0)
+        {
+          *sym = cs->sym;
+          ret  = OK;
+          break;
+        }
+    }
+
+  rawelf_cache_semgive();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: rawelf_cache_putsym
+ *
+ * Description:
+ *   Remember a symbol looked up in the cached image.
+ *
+ ****************************************************************************/
+
+void rawelf_cache_putsym(FAR struct rawelf_loadinfo_s *loadinfo,
+                         FAR const char *name, size_t namelen,
+                         FAR const Elf32_Sym *sym)
+{
+  FAR struct rawelf_cachesym_s *cs;
+
+  if (!loadinfo->cache)
+    {
+      return;
+    }
+
+  cs = (FAR struct rawelf_cachesym_s *)
+    kmm_malloc(sizeof(struct rawelf_cachesym_s) + namelen);
+  if (!cs)
+    {
+      return;
+    }
+
+  cs->sym     = *sym;
+  cs->namelen = namelen;
+  memcpy(cs->name, name, namelen);
+  cs->name[namelen] = '\0';
+
+  rawelf_cache_semtake();
+
+  cs->next    = loadinfo->cache->syms;
+  loadinfo->cache->syms = cs;
+  g_cachesize += sizeof(struct rawelf_cachesym_s) + namelen;
+
+  rawelf_cache_semgive();
+}
@@ -101,10 +101,16 @@ int rawelf_init(FAR struct rawelf_loadinfo_s *loadinfo)
 {
   int ret;
 
+  /* The file position is not known yet and the read buffer is empty */
+
+  loadinfo->filpos = -1;
+  loadinfo->rdlen  = 0;
+
   ret = rawelf_read(loadinfo, (FAR uint8_t *)&loadinfo->ehdr, sizeof(Elf32_Ehdr), 0);
   if (ret < 0)
     {
       berr("Failed to read ELF header: %d\n", ret);
+      rawelf_freebuffers(loadinfo);
       return ret;
     }
 
@@ -123,6 +129,7 @@ int rawelf_init(FAR struct rawelf_loadinfo_s *loadinfo)
        */
 
       berr("Bad ELF header: %d\n", ret);
+      rawelf_freebuffers(loadinfo);
       return ret;
     }
 
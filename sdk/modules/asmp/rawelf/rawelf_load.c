@@ -143,6 +143,36 @@ static int rawelf_elfsize(struct rawelf_loadinfo_s *loadinfo)
   return OK;
 }
 
+/****************************************************************************
+ * Name: rawelf_sectaddrs
+ *
+ * Description:
+ *   Update the section addresses in the shdr[] to point to the
+ *   corresponding position in the memory.
+ *
+ ****************************************************************************/
+
+static void rawelf_sectaddrs(FAR struct rawelf_loadinfo_s *loadinfo)
+{
+  FAR uint8_t *base = (FAR uint8_t *)loadinfo->textalloc;
+  int i;
+
+  binfo("Loaded sections:\n");
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf32_Shdr *shdr = &loadinfo->shdr[i];
+
+      if ((shdr->sh_flags & SHF_ALLOC) != 0)
+        {
+          binfo("%d. %08lx->%08lx\n", i, (unsigned long)shdr->sh_addr,
+                (unsigned long)(base + shdr->sh_addr));
+
+          shdr->sh_addr = (uintptr_t)(base + shdr->sh_addr);
+        }
+    }
+}
+
 /****************************************************************************
  * Name: rawelf_loadfile
  *
@@ -150,6 +180,9 @@ static int rawelf_elfsize(struct rawelf_loadinfo_s *loadinfo)
  *   Read the section data into memory. Section addresses in the shdr[] are
  *   updated to point to the corresponding position in the memory.
  *
+ *   The sections are read in the order of their file offsets, so that the
+ *   file is read sequentially without seeking back and forth.
+ *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
  *   failure.
@@ -158,28 +191,54 @@ static int rawelf_elfsize(struct rawelf_loadinfo_s *loadinfo)
 
 static inline int rawelf_loadfile(FAR struct rawelf_loadinfo_s *loadinfo)
 {
-  FAR uint8_t *base, *mem;
+  FAR uint8_t *base;
+  FAR uint8_t *mem;
+  FAR Elf32_Shdr *shdr;
+  Elf32_Off prevoff = 0;
+  int prev = -1;
+  int next;
   int ret;
   int i;
 
-  /* Read each section into memory that is marked SHF_ALLOC + SHT_NOBITS */
-
-  binfo("Loaded sections:\n");
   base = (FAR uint8_t *)loadinfo->textalloc;
 
-  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+  for (; ; )
     {
-      FAR Elf32_Shdr *shdr = &loadinfo->shdr[i];
+      /* Find the section marked SHF_ALLOC which follows the previous one
+       * in the file.  Sections at the same offset are taken in index order.
+       */
 
-      /* SHF_ALLOC indicates that the section requires memory during
-       * execution */
+      next = -1;
+      for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+        {
+          shdr = &loadinfo->shdr[i];
+
+          if ((shdr->sh_flags & SHF_ALLOC) == 0)
+            {
+              continue;
+            }
+
+          if (prev >= 0 && (shdr->sh_offset < prevoff ||
+                            (shdr->sh_offset == prevoff && i <= prev)))
+            {
+              continue;
+            }
 
-      if ((shdr->sh_flags & SHF_ALLOC) == 0)
+          if (next < 0 || shdr->sh_offset < loadinfo->shdr[next].sh_offset)
+            {
+              next = i;
+            }
+        }
+
+      if (next < 0)
         {
-          continue;
+          break;
         }
 
-      mem = base + shdr->sh_addr;
+      shdr    = &loadinfo->shdr[next];
+      mem     = base + shdr->sh_addr;
+      prev    = next;
+      prevoff = shdr->sh_offset;
 
       /* SHT_NOBITS indicates that there is no data in the file for the
        * section.
@@ -192,7 +251,7 @@ static inline int rawelf_loadfile(FAR struct rawelf_loadinfo_s *loadinfo)
           ret = rawelf_read(loadinfo, mem, shdr->sh_size, shdr->sh_offset);
           if (ret < 0)
             {
-              berr("ERROR: Failed to read section %d: %d\n", i, ret);
+              berr("ERROR: Failed to read section %d: %d\n", next, ret);
               return ret;
             }
         }
@@ -205,15 +264,11 @@ static inline int rawelf_loadfile(FAR struct rawelf_loadinfo_s *loadinfo)
         {
           memset(mem, 0, shdr->sh_size);
         }
-
-      /* Update sh_addr to point to copy in memory */
-
-      binfo("%d. %08lx->%08lx\n", i,
-            (unsigned long)shdr->sh_addr, (unsigned long)mem);
-
-      shdr->sh_addr = (uintptr_t)mem;
     }
 
+  /* Update sh_addr to point to copy in memory */
+
+  rawelf_sectaddrs(loadinfo);
   return OK;
 }
 
@@ -253,6 +308,29 @@ int rawelf_load(FAR struct rawelf_loadinfo_s *loadinfo)
       goto errout_with_buffers;
     }
 
+#ifdef CONFIG_RAWELF_CACHE
+  /* If the same file has been loaded before, copy the cached image */
+
+  if (rawelf_cache_lookup(loadinfo) == OK)
+    {
+      loadinfo->textalloc =
+        (uintptr_t)tile_alloc(loadinfo->textsize + loadinfo->datasize);
+      if (!loadinfo->textalloc)
+        {
+          berr("ERROR: tile_alloc() failed\n");
+          ret = -ENOMEM;
+          goto errout_with_buffers;
+        }
+
+      memcpy((FAR void *)loadinfo->textalloc, loadinfo->cache->image,
+             loadinfo->textsize + loadinfo->datasize);
+
+      loadinfo->dataalloc = loadinfo->textalloc + loadinfo->textsize;
+      rawelf_sectaddrs(loadinfo);
+      goto load_exidx;
+    }
+#endif
+
   /* Determine total size to allocate */
 
   ret = rawelf_elfsize(loadinfo);
@@ -284,6 +362,16 @@ int rawelf_load(FAR struct rawelf_loadinfo_s *loadinfo)
       goto errout_with_addrenv;
     }
 
+#ifdef CONFIG_RAWELF_CACHE
+  /* Keep a copy of the image for the next load of the same file.  The
+   * image is not relocated, so the copy does not depend on textalloc.
+   */
+
+  (void)rawelf_cache_store(loadinfo);
+
+load_exidx:
+#endif
+
   /* Load static constructors and destructors. */
 
 #ifdef CONFIG_UCLIBCXX_EXCEPTION
@@ -49,6 +49,8 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/kmalloc.h>
+
 #include "rawelf.h"
 
 /****************************************************************************
@@ -57,6 +59,14 @@
 
 #undef RAWELF_DUMP_READDATA       /* Define to dump all file data read */
 
+#ifndef MAX
+#  define MAX(x,y) ((x) > (y) ? (x) : (y))
+#endif
+
+#ifndef MIN
+#  define MIN(x,y) ((x) < (y) ? (x) : (y))
+#endif
+
 /****************************************************************************
  * Private Constant Data
  ****************************************************************************/
@@ -91,6 +101,88 @@ static inline void rawelf_dumpreaddata(FAR char *buffer, int buflen)
 #  define rawelf_dumpreaddata(b,n)
 #endif
 
+/****************************************************************************
+ * Name: rawelf_fileread
+ *
+ * Description:
+ *   Read at least 'minsize' and at most 'readsize' bytes from the object
+ *   file at 'offset'.  lseek() is only called when the file position is not
+ *   already at 'offset'.
+ *
+ * Returned Value:
+ *   The number of bytes read is returned on success and a negated errno is
+ *   returned on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t rawelf_fileread(FAR struct rawelf_loadinfo_s *loadinfo,
+                               FAR uint8_t *buffer, size_t minsize,
+                               size_t readsize, off_t offset)
+{
+  ssize_t nbytes;      /* Number of bytes read */
+  off_t   rpos;        /* Position returned by lseek */
+  size_t  total = 0;
+
+  /* Loop until all of the requested data has been read. */
+
+  while (total < readsize)
+    {
+      /* Seek to the next read position if needed */
+
+      if (loadinfo->filpos != offset)
+        {
+          rpos = lseek(loadinfo->filfd, offset, SEEK_SET);
+          if (rpos != offset)
+            {
+              int errval = errno;
+              berr("Failed to seek to position %lu: %d\n",
+                   (unsigned long)offset, errval);
+              loadinfo->filpos = -1;
+              return -errval;
+            }
+
+          loadinfo->filpos = offset;
+        }
+
+      /* Read the file data at offset into the user buffer */
+
+      nbytes = read(loadinfo->filfd, buffer, readsize - total);
+      if (nbytes < 0)
+        {
+          int errval = errno;
+
+          /* EINTR just means that we received a signal */
+
+          loadinfo->filpos = -1;
+          if (errval != EINTR)
+            {
+              berr("Read from offset %lu failed: %d\n",
+                   (unsigned long)offset, errval);
+              return -errval;
+            }
+        }
+      else if (nbytes == 0)
+        {
+          if (total >= minsize)
+            {
+              break;
+            }
+
+          berr("Unexpected end of file\n");
+          return -ENODATA;
+        }
+      else
+        {
+          total            += nbytes;
+          buffer           += nbytes;
+          offset           += nbytes;
+          loadinfo->filpos  = offset;
+        }
+    }
+
+  return total;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,6 +197,9 @@ static inline void rawelf_dumpreaddata(FAR char *buffer, int buflen)
  *   environment is in place before calling this function (i.e., that
  *   rawelf_addrenv_select() has been called if CONFIG_ARCH_ADDRENV=y).
  *
+ *   Reads smaller than CONFIG_RAWELF_READBUFSIZE are served from the block
+ *   read buffer.  Larger reads go directly to 'buffer'.
+ *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
  *   failure.
@@ -114,55 +209,79 @@ static inline void rawelf_dumpreaddata(FAR char *buffer, int buflen)
 int rawelf_read(FAR struct rawelf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
              size_t readsize, off_t offset)
 {
-  ssize_t nbytes;      /* Number of bytes read */
-  off_t   rpos;        /* Position returned by lseek */
+#if defined(RAWELF_DUMP_READDATA)
+  FAR uint8_t *start = buffer;
+  size_t  total = readsize;
+#endif
+  ssize_t nbytes;
 
   binfo("Read %ld bytes from offset %ld\n", (long)readsize, (long)offset);
 
-  /* Loop until all of the requested data has been read. */
+#if CONFIG_RAWELF_READBUFSIZE > 0
+  /* Take what the block buffer already holds */
 
-  while (readsize > 0)
+  if (loadinfo->rdlen > 0 && offset >= loadinfo->rdoffset &&
+      offset < loadinfo->rdoffset + (off_t)loadinfo->rdlen)
     {
-      /* Seek to the next read position */
+      nbytes = MIN(readsize,
+                   loadinfo->rdoffset + loadinfo->rdlen - offset);
+      memcpy(buffer, &loadinfo->rdbuffer[offset - loadinfo->rdoffset],
+             nbytes);
+
+      readsize -= nbytes;
+      buffer   += nbytes;
+      offset   += nbytes;
+    }
+
+  /* Refill the block buffer for a small read */
 
-      rpos = lseek(loadinfo->filfd, offset, SEEK_SET);
-      if (rpos != offset)
+  if (readsize > 0 && readsize < CONFIG_RAWELF_READBUFSIZE)
+    {
+      if (!loadinfo->rdbuffer)
         {
-          int errval = errno;
-          berr("Failed to seek to position %lu: %d\n",
-               (unsigned long)offset, errval);
-          return -errval;
+          loadinfo->rdbuffer =
+            (FAR uint8_t *)kmm_malloc(CONFIG_RAWELF_READBUFSIZE);
         }
 
-      /* Read the file data at offset into the user buffer */
+      if (loadinfo->rdbuffer)
+        {
+          /* Do not try to read past the end of the file */
+
+          nbytes = CONFIG_RAWELF_READBUFSIZE;
+          if (loadinfo->filelen > offset &&
+              loadinfo->filelen - offset < nbytes)
+            {
+              nbytes = loadinfo->filelen - offset;
+            }
+
+          loadinfo->rdlen = 0;
+          nbytes = rawelf_fileread(loadinfo, loadinfo->rdbuffer, readsize,
+                                   MAX(nbytes, (ssize_t)readsize), offset);
+          if (nbytes < 0)
+            {
+              return (int)nbytes;
+            }
+
+          loadinfo->rdoffset = offset;
+          loadinfo->rdlen    = nbytes;
+
+          memcpy(buffer, loadinfo->rdbuffer, readsize);
+          readsize = 0;
+        }
+    }
+#endif
 
-       nbytes = read(loadinfo->filfd, buffer, readsize);
-       if (nbytes < 0)
-         {
-           int errval = errno;
-
-           /* EINTR just means that we received a signal */
-
-           if (errval != EINTR)
-             {
-               berr("Read from offset %lu failed: %d\n",
-                    (unsigned long)offset, errval);
-               return -errval;
-             }
-         }
-       else if (nbytes == 0)
-         {
-           berr("Unexpected end of file\n");
-           return -ENODATA;
-         }
-       else
-         {
-           readsize -= nbytes;
-           buffer   += nbytes;
-           offset   += nbytes;
-         }
+  if (readsize > 0)
+    {
+      nbytes = rawelf_fileread(loadinfo, buffer, readsize, readsize, offset);
+      if (nbytes < 0)
+        {
+          return (int)nbytes;
+        }
     }
 
-  rawelf_dumpreaddata(buffer, readsize);
+#if defined(RAWELF_DUMP_READDATA)
+  rawelf_dumpreaddata((FAR char *)start, total);
+#endif
   return OK;
 }
@@ -46,6 +46,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/symtab.h>
 
 #include "rawelf.h"
@@ -160,6 +161,117 @@ static int rawelf_symname(FAR struct rawelf_loadinfo_s *loadinfo,
   return OK;
 }
 
+/****************************************************************************
+ * Name: rawelf_loadsymtab
+ *
+ * Description:
+ *   Read the whole symbol table and its string table into memory, so that
+ *   a symbol lookup does not read the file once per symbol and name.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+static int rawelf_loadsymtab(FAR struct rawelf_loadinfo_s *loadinfo)
+{
+  FAR Elf32_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  FAR Elf32_Shdr *strtab = &loadinfo->shdr[loadinfo->strtabidx];
+  int ret;
+
+  if (loadinfo->symtab && loadinfo->strtab)
+    {
+      return OK;
+    }
+
+  if (loadinfo->strtabidx == 0 ||
+      loadinfo->strtabidx >= loadinfo->ehdr.e_shnum)
+    {
+      return -EINVAL;
+    }
+
+  loadinfo->symtab = (FAR Elf32_Sym *)kmm_malloc(symtab->sh_size);
+  loadinfo->strtab = (FAR char *)kmm_malloc(strtab->sh_size + 1);
+  if (!loadinfo->symtab || !loadinfo->strtab)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ret = rawelf_read(loadinfo, (FAR uint8_t *)loadinfo->symtab,
+                    symtab->sh_size, symtab->sh_offset);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = rawelf_read(loadinfo, (FAR uint8_t *)loadinfo->strtab,
+                    strtab->sh_size, strtab->sh_offset);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  /* Terminate the last name in case the table is malformed */
+
+  loadinfo->strtab[strtab->sh_size] = '\0';
+  return OK;
+
+errout:
+  if (loadinfo->symtab)
+    {
+      kmm_free(loadinfo->symtab);
+      loadinfo->symtab = NULL;
+    }
+
+  if (loadinfo->strtab)
+    {
+      kmm_free(loadinfo->strtab);
+      loadinfo->strtab = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: rawelf_findsymbol
+ *
+ * Description:
+ *   Search the symbol table in memory.
+ *
+ ****************************************************************************/
+
+static int rawelf_findsymbol(FAR struct rawelf_loadinfo_s *loadinfo,
+                             FAR const char *name, size_t namelen,
+                             FAR Elf32_Sym *sym)
+{
+  FAR Elf32_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  FAR Elf32_Shdr *strtab = &loadinfo->shdr[loadinfo->strtabidx];
+  int nents = symtab->sh_size / sizeof(Elf32_Sym);
+  int i;
+
+  for (i = 0; i < nents; i++)
+    {
+      FAR const Elf32_Sym *ent = &loadinfo->symtab[i];
+
+      /* Skip the symbols without a name */
+
+      if (ent->st_name == 0 || ent->st_name >= strtab->sh_size)
+        {
+          continue;
+        }
+
+      if (strncmp(name, &loadinfo->strtab[ent->st_name], namelen) == 0)
+        {
+          *sym = *ent;
+          return OK;
+        }
+    }
+
+  return -ENOENT;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -321,6 +433,32 @@ int rawelf_getsymbolbyname(struct rawelf_loadinfo_s *loadinfo,
   int ret;
   int i;
 
+#ifdef CONFIG_RAWELF_CACHE
+  /* The symbol may have been looked up in an earlier load of the image */
+
+  if (rawelf_cache_getsym(loadinfo, name, namelen, sym) == OK)
+    {
+      return OK;
+    }
+#endif
+
+  /* Search the tables in memory if they can be read at once */
+
+  if (rawelf_loadsymtab(loadinfo) == OK)
+    {
+      ret = rawelf_findsymbol(loadinfo, name, namelen, sym);
+#ifdef CONFIG_RAWELF_CACHE
+      if (ret == OK)
+        {
+          rawelf_cache_putsym(loadinfo, name, namelen, sym);
+        }
+#endif
+
+      return ret;
+    }
+
+  /* Otherwise read the symbols and names one by one */
+
   for (i = 0; i < nents; i++)
     {
       ret = rawelf_readsym(loadinfo, i, sym);
@@ -338,6 +476,9 @@ int rawelf_getsymbolbyname(struct rawelf_loadinfo_s *loadinfo,
 
       if (strncmp(name, (FAR char *)loadinfo->iobuffer, namelen) == 0)
         {
+#ifdef CONFIG_RAWELF_CACHE
+          rawelf_cache_putsym(loadinfo, name, namelen, sym);
+#endif
           return OK;
         }
     }
@@ -123,5 +123,28 @@ int rawelf_freebuffers(struct rawelf_loadinfo_s *loadinfo)
       loadinfo->buflen    = 0;
     }
 
+  if (loadinfo->rdbuffer)
+    {
+      kmm_free((FAR void *)loadinfo->rdbuffer);
+      loadinfo->rdbuffer  = NULL;
+      loadinfo->rdlen     = 0;
+    }
+
+  if (loadinfo->symtab)
+    {
+      kmm_free((FAR void *)loadinfo->symtab);
+      loadinfo->symtab    = NULL;
+    }
+
+  if (loadinfo->strtab)
+    {
+      kmm_free((FAR void *)loadinfo->strtab);
+      loadinfo->strtab    = NULL;
+    }
+
+#ifdef CONFIG_RAWELF_CACHE
+  rawelf_cache_release(loadinfo);
+#endif
+
   return OK;
 }
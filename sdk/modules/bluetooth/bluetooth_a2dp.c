@@ -40,44 +40,12 @@
 #include <bluetooth/bt_a2dp.h>
 #include <bluetooth/hal/bt_if.h>
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-/**
- * @defgroup bt_defs Defines
- * @{
- */
-
-/**
- *@name BT success code
- *@{
- */
-#define BT_A2DP_SCHED_EXEC_MEDIA_DATA SCHED_FIFO
-/** @} */
-
-/**
- *@name BT success code
- *@{
- */
-#define BT_A2DP_SCHED_THREAD_NAME "bt_a2dp_media"
-/** @} */
+#include "bluetooth_rxq.h"
 
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-#ifdef CONFIG_BLUETOOTH_A2DP_USE_THREAD
-/** Bluetooth A2DP application callbacks
- */
-struct bt_a2dp_media_thread_s
-{
-  struct sched_param param;
-  pthread_mutex_t mutex;
-  pthread_attr_t attr;
-  pthread_t thread;
-};
-#endif /* CONFIG_BLUETOOTH_A2DP_USE_THREAD */
-
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -87,10 +55,6 @@ static struct bt_a2dp_state_s g_bt_a2dp_state =
   .bt_a2dp_connection = BT_DISCONNECTED
 };
 
-#ifdef CONFIG_BLUETOOTH_A2DP_USE_THREAD
-static struct bt_a2dp_media_thread_s g_bt_a2dp_media_thread;
-#endif /* CONFIG_BLUETOOTH_A2DP_USE_THREAD */
-
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -156,11 +120,15 @@ static int event_disconnect(struct bt_a2dp_event_connect_t *event_connect)
   return ret;
 }
 
-static pthread_addr_t receive_thread(pthread_addr_t arg)
+/* Media packets are handed over in the receive buffer, without copying.
+ * With CONFIG_BLUETOOTH_A2DP_USE_THREAD the receive queue thread runs
+ * SCHED_FIFO.
+ */
+
+static int event_recv_data(struct bt_a2dp_event_recv_t *event_recv)
 {
   int ret = BT_SUCCESS;
   struct bt_a2dp_ops_s *bt_a2dp_ops = g_bt_a2dp_state.bt_a2dp_ops;
-  struct bt_a2dp_event_recv_t *event_recv = (struct bt_a2dp_event_recv_t *) arg;
 
   if (bt_a2dp_ops && bt_a2dp_ops->receive_media_pkt)
     {
@@ -171,34 +139,33 @@ static pthread_addr_t receive_thread(pthread_addr_t arg)
   else
     {
       _err("%s [BT][A2DP] A2DP receive media packet callback failed(CB not registered).\n", __func__);
-      return (pthread_addr_t) BT_FAIL;
+      return BT_FAIL;
     }
-  return (pthread_addr_t) ret;
+  return ret;
 }
 
-static int event_recv_data(struct bt_a2dp_event_recv_t *event_recv)
-{
-  int ret = BT_SUCCESS;
+/* Called from the receive queue thread */
 
-#ifdef CONFIG_BLUETOOTH_A2DP_USE_THREAD
-  if (!g_bt_a2dp_media_thread.mutex.pid)
+static int event_dispatch(struct bt_event_t *bt_event)
+{
+  switch (bt_event->event_id)
     {
-      pthread_mutex_init(&g_bt_a2dp_media_thread.mutex, NULL);
-      sched_getparam(0, &g_bt_a2dp_media_thread.param);
-      pthread_attr_init(&g_bt_a2dp_media_thread.attr);
-      pthread_attr_setschedpolicy(&g_bt_a2dp_media_thread.attr,
-                                  BT_A2DP_SCHED_EXEC_MEDIA_DATA);
-      pthread_attr_setschedparam(&g_bt_a2dp_media_thread.attr,
-                                 &g_bt_a2dp_media_thread.param);
-    }
-  pthread_create(&g_bt_a2dp_media_thread.thread, &g_bt_a2dp_media_thread.attr,
-                 receive_thread, (pthread_addr_t)event_recv);
-  pthread_setname_np(g_bt_a2dp_media_thread.thread, BT_A2DP_SCHED_THREAD_NAME);
-#else
-  receive_thread((pthread_addr_t) event_recv);
-#endif /* CONFIG_BLUETOOTH_A2DP_USE_THREAD */
+      case BT_A2DP_EVENT_CMD_STATUS:
+        return event_cmd_status((struct bt_event_cmd_stat_t *) bt_event);
 
-  return ret;
+      case BT_A2DP_EVENT_CONNECT:
+        return event_connect((struct bt_a2dp_event_connect_t *) bt_event);
+
+      case BT_A2DP_EVENT_DISCONNECT:
+        return event_disconnect((struct bt_a2dp_event_connect_t *) bt_event);
+
+      case BT_A2DP_EVENT_MEDIA_PACKET:
+        return event_recv_data((struct bt_a2dp_event_recv_t *) bt_event);
+
+      default:
+        break;
+    }
+  return BT_SUCCESS;
 }
 
 /****************************************************************************
@@ -381,29 +348,30 @@ int bt_a2dp_register_hal(struct bt_hal_a2dp_ops_s *bt_hal_a2dp_ops)
  *
  * Description:
  *   Handler of A2DP event.
- *   Receive A2DP event from HAL and dispatch event for application.
+ *   Receive A2DP event from HAL and queue it for dispatching to application.
  *
  ****************************************************************************/
 
 int bt_a2dp_event_handler(struct bt_event_t *bt_event)
 {
+  size_t size;
+
   switch (bt_event->event_id)
     {
       case BT_A2DP_EVENT_CMD_STATUS:
-        return event_cmd_status((struct bt_event_cmd_stat_t *) bt_event);
-
-      case BT_A2DP_EVENT_CONNECT:
-        return event_connect((struct bt_a2dp_event_connect_t *) bt_event);
-
-      case BT_A2DP_EVENT_DISCONNECT:
-        return event_disconnect((struct bt_a2dp_event_connect_t *) bt_event);
+        size = sizeof(struct bt_event_cmd_stat_t);
+        break;
 
       case BT_A2DP_EVENT_MEDIA_PACKET:
-        return event_recv_data((struct bt_a2dp_event_recv_t *) bt_event);
+        size = sizeof(struct bt_a2dp_event_recv_t);
+        break;
 
       default:
+        size = sizeof(struct bt_a2dp_event_connect_t);
         break;
     }
-  return BT_SUCCESS;
-}
 
+  return bt_rxq_post(bt_event, size,
+                     bt_event->event_id == BT_A2DP_EVENT_MEDIA_PACKET,
+                     event_dispatch);
+}
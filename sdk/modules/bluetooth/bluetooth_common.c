@@ -42,6 +42,7 @@
 #include <bluetooth/hal/bt_if.h>
 
 #include "bluetooth_hal_init.h"
+#include "bluetooth_rxq.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -322,7 +323,20 @@ int bt_init(void)
 
   if (bt_hal_common_ops && bt_hal_common_ops->init)
     {
+      /* Start the receive queue before HAL starts receiving */
+
+      ret = bt_rxq_initialize();
+      if (ret != BT_SUCCESS)
+        {
+          _err("%s [BT][Common] Initialization failed(Receive queue).\n", __func__);
+          return ret;
+        }
+
       ret = bt_hal_common_ops->init();
+      if (ret != BT_SUCCESS)
+        {
+          bt_rxq_finalize();
+        }
     }
   else
     {
@@ -349,6 +363,10 @@ int bt_finalize(void)
   if (bt_hal_common_ops && bt_hal_common_ops->finalize)
     {
       ret = bt_hal_common_ops->finalize();
+
+      /* HAL stopped receiving, deliver the rest and stop the queue */
+
+      bt_rxq_finalize();
     }
   else
     {
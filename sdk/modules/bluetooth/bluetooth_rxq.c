@@ -0,0 +1,578 @@
+/****************************************************************************
+ * modules/bluetooth/bluetooth_rxq.c
+ *
+ *   Copyright 2018 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <string.h>
+#include <time.h>
+#include <bluetooth/bt_common.h>
+#include <bluetooth/hal/bt_if.h>
+
+#include "bluetooth_rxq.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_BLUETOOTH_RXQ_NBUFFERS
+#define CONFIG_BLUETOOTH_RXQ_NBUFFERS    8
+#endif
+
+#ifndef CONFIG_BLUETOOTH_RXQ_SPP_TIMEOUT
+#define CONFIG_BLUETOOTH_RXQ_SPP_TIMEOUT  1000
+#endif
+
+#ifndef CONFIG_BLUETOOTH_RXQ_A2DP_TIMEOUT
+#define CONFIG_BLUETOOTH_RXQ_A2DP_TIMEOUT 0
+#endif
+
+#ifndef CONFIG_BLUETOOTH_RXQ_STACKSIZE
+#define CONFIG_BLUETOOTH_RXQ_STACKSIZE    2048
+#endif
+
+#define BT_RXQ_THREAD_NAME "bt_rxq"
+
+/* Wait without limit, used for the events which must not be lost */
+
+#define BT_RXQ_WAIT_FOREVER (-1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One pool buffer.  The event is built in place by the HAL, queued and
+ * handed to the application without copying; the application may keep
+ * the data beyond the callback with bt_rxbuf_hold().
+ */
+
+struct bt_rxq_buf_s
+{
+  struct bt_rxq_buf_s *next;     /* Free list or queue link */
+  bt_rxq_dispatch_t   dispatch;  /* Profile handler of the event */
+  int                 refs;      /* 0 while in the free list */
+  union
+  {
+    struct bt_event_t               event;
+    struct bt_spp_event_recv_data_t spp;
+    struct bt_a2dp_event_recv_t     a2dp;
+  } u;
+};
+
+struct bt_rxq_s
+{
+  pthread_mutex_t       lock;    /* Lists, reference counts and stats */
+  sem_t                 nfree;   /* Buffers in the free list */
+  sem_t                 nqueued; /* Events in the queue */
+  struct bt_rxq_buf_s   *free;
+  struct bt_rxq_buf_s   *head;
+  struct bt_rxq_buf_s   *tail;
+  uint32_t              depth;
+  bool                  running;
+  pthread_t             thread;
+  struct bt_rxq_stats_s stats;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct bt_rxq_buf_s g_bt_rxq_pool[CONFIG_BLUETOOTH_RXQ_NBUFFERS];
+
+static struct bt_rxq_s g_bt_rxq =
+{
+  .lock = PTHREAD_MUTEX_INITIALIZER
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static struct bt_rxq_buf_s *bt_rxq_buf_of(const void *p)
+{
+  uintptr_t addr = (uintptr_t)p;
+  uintptr_t base = (uintptr_t)g_bt_rxq_pool;
+
+  if (addr < base || addr >= base + sizeof(g_bt_rxq_pool))
+    {
+      return NULL;
+    }
+
+  return &g_bt_rxq_pool[(addr - base) / sizeof(g_bt_rxq_pool[0])];
+}
+
+static int bt_rxq_timeout(uint8_t group_id)
+{
+  switch (group_id)
+    {
+      case BT_GROUP_SPP:
+        return CONFIG_BLUETOOTH_RXQ_SPP_TIMEOUT;
+
+      case BT_GROUP_A2DP:
+        return CONFIG_BLUETOOTH_RXQ_A2DP_TIMEOUT;
+
+      default:
+        break;
+    }
+
+  return BT_RXQ_WAIT_FOREVER;
+}
+
+static struct bt_rxq_buf_s *bt_rxq_get(int timeout)
+{
+  struct bt_rxq_buf_s *buf;
+  struct timespec abstime;
+  int ret;
+
+  ret = sem_trywait(&g_bt_rxq.nfree);
+  if (ret < 0 && timeout != 0)
+    {
+      /* The pool is empty: hold the receiver until the application gives
+       * a buffer back.
+       */
+
+      pthread_mutex_lock(&g_bt_rxq.lock);
+      g_bt_rxq.stats.waits++;
+      pthread_mutex_unlock(&g_bt_rxq.lock);
+
+      if (timeout == BT_RXQ_WAIT_FOREVER)
+        {
+          while ((ret = sem_wait(&g_bt_rxq.nfree)) < 0 && errno == EINTR);
+        }
+      else
+        {
+          clock_gettime(CLOCK_REALTIME, &abstime);
+          abstime.tv_sec  += timeout / 1000;
+          abstime.tv_nsec += (timeout % 1000) * 1000000;
+          if (abstime.tv_nsec >= 1000000000)
+            {
+              abstime.tv_sec++;
+              abstime.tv_nsec -= 1000000000;
+            }
+
+          while ((ret = sem_timedwait(&g_bt_rxq.nfree, &abstime)) < 0 &&
+                 errno == EINTR);
+        }
+    }
+
+  if (ret < 0)
+    {
+      return NULL;
+    }
+
+  pthread_mutex_lock(&g_bt_rxq.lock);
+  buf           = g_bt_rxq.free;
+  g_bt_rxq.free = buf->next;
+  buf->next     = NULL;
+  buf->refs     = 1;
+  pthread_mutex_unlock(&g_bt_rxq.lock);
+
+  return buf;
+}
+
+static int bt_rxq_put(struct bt_rxq_buf_s *buf)
+{
+  bool freed = false;
+
+  pthread_mutex_lock(&g_bt_rxq.lock);
+  if (buf->refs <= 0)
+    {
+      pthread_mutex_unlock(&g_bt_rxq.lock);
+      return -EINVAL;
+    }
+
+  if (--buf->refs == 0)
+    {
+      buf->next     = g_bt_rxq.free;
+      g_bt_rxq.free = buf;
+      freed         = true;
+    }
+
+  pthread_mutex_unlock(&g_bt_rxq.lock);
+
+  if (freed)
+    {
+      sem_post(&g_bt_rxq.nfree);
+    }
+
+  return BT_SUCCESS;
+}
+
+static void *bt_rxq_thread(void *arg)
+{
+  struct bt_rxq_buf_s *buf;
+
+  while (true)
+    {
+      while (sem_wait(&g_bt_rxq.nqueued) < 0 && errno == EINTR);
+
+      pthread_mutex_lock(&g_bt_rxq.lock);
+      buf = g_bt_rxq.head;
+      if (buf)
+        {
+          g_bt_rxq.head = buf->next;
+          if (!g_bt_rxq.head)
+            {
+              g_bt_rxq.tail = NULL;
+            }
+
+          g_bt_rxq.depth--;
+        }
+
+      pthread_mutex_unlock(&g_bt_rxq.lock);
+
+      /* An empty queue is the stop request from bt_rxq_finalize(), which
+       * is posted behind all the events queued before it.
+       */
+
+      if (!buf)
+        {
+          break;
+        }
+
+      buf->dispatch(&buf->u.event);
+      bt_rxq_put(buf);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bt_rxq_initialize
+ *
+ * Description:
+ *   Set up the receive buffer pool and start the receive queue thread.
+ *
+ ****************************************************************************/
+
+int bt_rxq_initialize(void)
+{
+  struct sched_param param;
+  pthread_attr_t attr;
+  int ret;
+  int i;
+
+  if (g_bt_rxq.running)
+    {
+      return BT_SUCCESS;
+    }
+
+  g_bt_rxq.free  = NULL;
+  g_bt_rxq.head  = NULL;
+  g_bt_rxq.tail  = NULL;
+  g_bt_rxq.depth = 0;
+  memset(&g_bt_rxq.stats, 0, sizeof(g_bt_rxq.stats));
+
+  for (i = 0; i < CONFIG_BLUETOOTH_RXQ_NBUFFERS; i++)
+    {
+      g_bt_rxq_pool[i].refs = 0;
+      g_bt_rxq_pool[i].next = g_bt_rxq.free;
+      g_bt_rxq.free         = &g_bt_rxq_pool[i];
+    }
+
+  sem_init(&g_bt_rxq.nfree, 0, CONFIG_BLUETOOTH_RXQ_NBUFFERS);
+  sem_init(&g_bt_rxq.nqueued, 0, 0);
+
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, CONFIG_BLUETOOTH_RXQ_STACKSIZE);
+
+#ifdef CONFIG_BLUETOOTH_A2DP_USE_THREAD
+  /* A2DP media packets are delivered from this thread */
+
+  sched_getparam(0, &param);
+  pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+  pthread_attr_setschedparam(&attr, &param);
+#else
+  (void)param;
+#endif
+
+  g_bt_rxq.running = true;
+
+  ret = pthread_create(&g_bt_rxq.thread, &attr, bt_rxq_thread, NULL);
+  pthread_attr_destroy(&attr);
+  if (ret != 0)
+    {
+      _err("%s [BT][RXQ] Thread create failed(%d).\n", __func__, ret);
+      g_bt_rxq.running = false;
+      sem_destroy(&g_bt_rxq.nfree);
+      sem_destroy(&g_bt_rxq.nqueued);
+      return -ret;
+    }
+
+  pthread_setname_np(g_bt_rxq.thread, BT_RXQ_THREAD_NAME);
+
+  return BT_SUCCESS;
+}
+
+/****************************************************************************
+ * Name: bt_rxq_finalize
+ *
+ * Description:
+ *   Deliver the events still queued and stop the receive queue thread.
+ *
+ ****************************************************************************/
+
+int bt_rxq_finalize(void)
+{
+  int ret;
+
+  pthread_mutex_lock(&g_bt_rxq.lock);
+  if (!g_bt_rxq.running)
+    {
+      pthread_mutex_unlock(&g_bt_rxq.lock);
+      return BT_SUCCESS;
+    }
+
+  g_bt_rxq.running = false;
+  pthread_mutex_unlock(&g_bt_rxq.lock);
+
+  sem_post(&g_bt_rxq.nqueued);
+
+  ret = pthread_join(g_bt_rxq.thread, NULL);
+  if (ret != 0)
+    {
+      _err("%s [BT][RXQ] Thread join failed(%d).\n", __func__, ret);
+    }
+
+  sem_destroy(&g_bt_rxq.nfree);
+  sem_destroy(&g_bt_rxq.nqueued);
+
+  return -ret;
+}
+
+/****************************************************************************
+ * Name: bt_rxq_post
+ *
+ * Description:
+ *   Queue an event from the HAL for the receive queue thread.
+ *
+ ****************************************************************************/
+
+int bt_rxq_post(struct bt_event_t *bt_event, size_t size, bool droppable,
+                bt_rxq_dispatch_t dispatch)
+{
+  struct bt_rxq_buf_s *buf = bt_rxq_buf_of(bt_event);
+  bool copied = false;
+  int ret;
+
+  pthread_mutex_lock(&g_bt_rxq.lock);
+  if (!g_bt_rxq.running)
+    {
+      pthread_mutex_unlock(&g_bt_rxq.lock);
+      goto dispatch_now;
+    }
+
+  pthread_mutex_unlock(&g_bt_rxq.lock);
+
+  if (!buf)
+    {
+      /* Not built in a pool buffer, copy it into one */
+
+      buf = bt_rxq_get(droppable ? bt_rxq_timeout(bt_event->group_id) :
+                                   BT_RXQ_WAIT_FOREVER);
+      if (!buf)
+        {
+          pthread_mutex_lock(&g_bt_rxq.lock);
+          g_bt_rxq.stats.dropped++;
+          pthread_mutex_unlock(&g_bt_rxq.lock);
+          return -ENOMEM;
+        }
+
+      memcpy(&buf->u, bt_event,
+             size < sizeof(buf->u) ? size : sizeof(buf->u));
+      bt_event = &buf->u.event;
+      copied   = true;
+    }
+
+  buf->dispatch = dispatch;
+  buf->next     = NULL;
+
+  pthread_mutex_lock(&g_bt_rxq.lock);
+  if (!g_bt_rxq.running)
+    {
+      pthread_mutex_unlock(&g_bt_rxq.lock);
+      goto dispatch_now;
+    }
+
+  if (g_bt_rxq.tail)
+    {
+      g_bt_rxq.tail->next = buf;
+    }
+  else
+    {
+      g_bt_rxq.head = buf;
+    }
+
+  g_bt_rxq.tail = buf;
+  g_bt_rxq.depth++;
+  g_bt_rxq.stats.posted++;
+  g_bt_rxq.stats.copied += copied ? 1 : 0;
+  if (g_bt_rxq.depth > g_bt_rxq.stats.max_depth)
+    {
+      g_bt_rxq.stats.max_depth = g_bt_rxq.depth;
+    }
+
+  pthread_mutex_unlock(&g_bt_rxq.lock);
+
+  sem_post(&g_bt_rxq.nqueued);
+  return BT_SUCCESS;
+
+dispatch_now:
+
+  /* No queue thread: deliver from the caller as before */
+
+  ret = dispatch(bt_event);
+  if (buf)
+    {
+      bt_rxq_put(buf);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bt_rxq_alloc
+ *
+ * Description:
+ *   Get a pool buffer for a receive event of 'group_id'.
+ *
+ ****************************************************************************/
+
+struct bt_event_t *bt_rxq_alloc(uint8_t group_id)
+{
+  struct bt_rxq_buf_s *buf;
+  bool running;
+
+  pthread_mutex_lock(&g_bt_rxq.lock);
+  running = g_bt_rxq.running;
+  pthread_mutex_unlock(&g_bt_rxq.lock);
+
+  if (!running)
+    {
+      return NULL;
+    }
+
+  buf = bt_rxq_get(bt_rxq_timeout(group_id));
+  if (!buf)
+    {
+      pthread_mutex_lock(&g_bt_rxq.lock);
+      g_bt_rxq.stats.dropped++;
+      pthread_mutex_unlock(&g_bt_rxq.lock);
+      return NULL;
+    }
+
+  buf->u.event.group_id = group_id;
+  return &buf->u.event;
+}
+
+/****************************************************************************
+ * Name: bt_rxbuf_hold
+ *
+ * Description:
+ *   Keep received data beyond the receive callback.
+ *
+ ****************************************************************************/
+
+int bt_rxbuf_hold(uint8_t *data)
+{
+  struct bt_rxq_buf_s *buf = bt_rxq_buf_of(data);
+  int ret = -EINVAL;
+
+  if (!buf)
+    {
+      return ret;
+    }
+
+  pthread_mutex_lock(&g_bt_rxq.lock);
+  if (buf->refs > 0)
+    {
+      buf->refs++;
+      ret = BT_SUCCESS;
+    }
+
+  pthread_mutex_unlock(&g_bt_rxq.lock);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bt_rxbuf_release
+ *
+ * Description:
+ *   Give back received data kept with bt_rxbuf_hold().
+ *
+ ****************************************************************************/
+
+int bt_rxbuf_release(uint8_t *data)
+{
+  struct bt_rxq_buf_s *buf = bt_rxq_buf_of(data);
+
+  if (!buf)
+    {
+      return -EINVAL;
+    }
+
+  return bt_rxq_put(buf);
+}
+
+/****************************************************************************
+ * Name: bt_rxq_get_stats
+ *
+ * Description:
+ *   Get the receive queue statistics.
+ *
+ ****************************************************************************/
+
+int bt_rxq_get_stats(struct bt_rxq_stats_s *stats)
+{
+  if (!stats)
+    {
+      return -EINVAL;
+    }
+
+  pthread_mutex_lock(&g_bt_rxq.lock);
+  *stats = g_bt_rxq.stats;
+  pthread_mutex_unlock(&g_bt_rxq.lock);
+
+  return BT_SUCCESS;
+}
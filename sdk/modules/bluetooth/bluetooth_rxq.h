@@ -0,0 +1,94 @@
+/****************************************************************************
+ * modules/bluetooth/bluetooth_rxq.h
+ *
+ *   Copyright 2018 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __MODULES_BLUETOOTH_BLUETOOTH_RXQ_H
+#define __MODULES_BLUETOOTH_BLUETOOTH_RXQ_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <bluetooth/hal/bt_event.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Profile side event handler, called from the receive queue thread */
+
+typedef int (*bt_rxq_dispatch_t)(struct bt_event_t *bt_event);
+
+/****************************************************************************
+ * Public Function prototype
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bt_rxq_initialize
+ *
+ * Description:
+ *   Set up the receive buffer pool and start the receive queue thread.
+ *
+ ****************************************************************************/
+
+int bt_rxq_initialize(void);
+
+/****************************************************************************
+ * Name: bt_rxq_finalize
+ *
+ * Description:
+ *   Deliver the events still queued and stop the receive queue thread.
+ *
+ ****************************************************************************/
+
+int bt_rxq_finalize(void);
+
+/****************************************************************************
+ * Name: bt_rxq_post
+ *
+ * Description:
+ *   Queue an event from the HAL for 'dispatch'.  An event in a buffer from
+ *   bt_rxq_alloc() is queued as is, any other event is copied ('size'
+ *   bytes) into a pool buffer first.  When the pool is empty the caller
+ *   waits; a 'droppable' data event waits at most the timeout of its
+ *   group and is dropped after that.
+ *
+ ****************************************************************************/
+
+int bt_rxq_post(struct bt_event_t *bt_event, size_t size, bool droppable,
+                bt_rxq_dispatch_t dispatch);
+
+#endif  /* __MODULES_BLUETOOTH_BLUETOOTH_RXQ_H */
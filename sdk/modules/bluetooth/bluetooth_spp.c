@@ -41,6 +41,8 @@
 #include <bluetooth/bt_spp.h>
 #include <bluetooth/hal/bt_if.h>
 
+#include "bluetooth_rxq.h"
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -144,6 +146,30 @@ static int event_receive_data(struct bt_spp_event_recv_data_t *event_rx)
   return ret;
 }
 
+/* Called from the receive queue thread */
+
+static int event_dispatch(struct bt_event_t *bt_event)
+{
+  switch (bt_event->event_id)
+    {
+      case BT_SPP_EVENT_CONNECT:
+        return event_connect((struct bt_spp_event_connect_t *) bt_event);
+
+      case BT_SPP_EVENT_DISCONNECT:
+        return event_disconnect((struct bt_spp_event_connect_t *) bt_event);
+
+      case BT_SPP_EVENT_CONNECT_FAIL:
+        return event_connect_fail((struct bt_spp_event_connect_t *) bt_event);
+
+      case BT_SPP_EVENT_RX_DATA:
+        return event_receive_data((struct bt_spp_event_recv_data_t *) bt_event);
+
+      default:
+        break;
+    }
+  return BT_SUCCESS;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -375,29 +401,16 @@ int bt_spp_register_hal(struct bt_hal_spp_ops_s *bt_hal_spp_ops)
  *
  * Description:
  *   Handler of SPP event.
- *   Receive SPP event from HAL and dispatch event for application.
+ *   Receive SPP event from HAL and queue it for dispatching to application.
  *
  ****************************************************************************/
 
 int bt_spp_event_handler(struct bt_event_t *bt_event)
 {
-  switch (bt_event->event_id)
-    {
-      case BT_SPP_EVENT_CONNECT:
-        return event_connect((struct bt_spp_event_connect_t *) bt_event);
-
-      case BT_SPP_EVENT_DISCONNECT:
-        return event_disconnect((struct bt_spp_event_connect_t *) bt_event);
-
-      case BT_SPP_EVENT_CONNECT_FAIL:
-        return event_connect_fail((struct bt_spp_event_connect_t *) bt_event);
-
-      case BT_SPP_EVENT_RX_DATA:
-        return event_receive_data((struct bt_spp_event_recv_data_t *) bt_event);
+  bool rx_data = (bt_event->event_id == BT_SPP_EVENT_RX_DATA);
 
-      default:
-        break;
-    }
-  return BT_SUCCESS;
+  return bt_rxq_post(bt_event, rx_data ?
+                     sizeof(struct bt_spp_event_recv_data_t) :
+                     sizeof(struct bt_spp_event_connect_t),
+                     rx_data, event_dispatch);
 }
-
@@ -86,13 +86,11 @@ static int sppSendData(uint16_t handle,uint8_t *data,uint16_t len)
 {
   uint8_t buff[BT_SHORT_COMMAND_LEN] = {0};
   uint8_t *p = buff;
-  int ret = 0;
   UINT8_TO_STREAM(p, PACKET_CONTROL);
   UINT16_TO_STREAM(p, BT_CONTROL_SPP_COMMAND_DATA);
   UINT16_TO_STREAM(p, 2 + len);
   UINT16_TO_STREAM(p, handle);
-  ret = btUartSendData(buff, p - buff);
-  return (ret | btUartSendData(data, len));
+  return btUartSendPacket(buff, p - buff, data, len);
 }
 
 /****************************************************************************
@@ -0,0 +1,512 @@
+/****************************************************************************
+ * modules/bluetooth/hal/bcm20706/host/btuartbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark for the BCM20706 UART transport.  A pseudo terminal pair
+ *   stands in for the UART: bt_uart_manager.c opens the slave side and a
+ *   child process plays the controller on the master side.  The controller
+ *   streams a mix of HCI, control and media packets which are received with
+ *   btUartGetCompleteBuff() and compared with the expected ones, then it
+ *   checks the packets sent back with btUartSendData() and
+ *   btUartSendPacket().
+ *
+ *   read(), write(), poll() and ioctl() are wrapped (-Wl,--wrap) to count
+ *   the system calls made per packet.  ioctl(FIONSPACE) always reports an
+ *   empty TX buffer and ioctl(TCFLSH) is ignored, the pty has neither.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <signal.h>
+#include <errno.h>
+
+#include "manager/bt_uart_manager.h"
+#include "bt_util.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_DEFPACKETS  20000
+#define BENCH_MAXPACKET   1005        /* BT_EVT_DATA_LEN + 5 byte header */
+#define BENCH_TXPACKETS   2000
+#define BENCH_TXSEED      0x80000000u
+#define BENCH_OVERSIZE    1500        /* Discarded by the receiver */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+const char *g_uartpath;
+
+static unsigned long g_reads;
+static unsigned long g_writes;
+static unsigned long g_polls;
+static unsigned long g_ioctls;
+
+/****************************************************************************
+ * Wrappers
+ ****************************************************************************/
+
+ssize_t __real_read(int fd, void *buf, size_t count);
+ssize_t __real_write(int fd, const void *buf, size_t count);
+int __real_poll(struct pollfd *fds, nfds_t nfds, int timeout);
+int __real_ioctl(int fd, unsigned long request, ...);
+
+ssize_t __wrap_read(int fd, void *buf, size_t count)
+{
+  g_reads++;
+  return __real_read(fd, buf, count);
+}
+
+ssize_t __wrap_write(int fd, const void *buf, size_t count)
+{
+  g_writes++;
+  return __real_write(fd, buf, count);
+}
+
+int __wrap_poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+  g_polls++;
+  return __real_poll(fds, nfds, timeout);
+}
+
+int __wrap_ioctl(int fd, unsigned long request, ...)
+{
+  va_list ap;
+  void *arg;
+
+  va_start(ap, request);
+  arg = va_arg(ap, void *);
+  va_end(ap);
+
+  g_ioctls++;
+  if (request == FIONSPACE)
+    {
+      *(uint32_t *)arg = CONFIG_UART2_TXBUFSIZE - 1;
+      return 0;
+    }
+
+  if (request == TCFLSH)
+    {
+      return 0;
+    }
+
+  return __real_ioctl(fd, request, arg);
+}
+
+/* Called by the exit path of btUartGetCompleteBuff() */
+
+int btChangeFreLock(uint32_t baudrate)
+{
+  return 0;
+}
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(FAR const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-b <packets>] [-t] [-h]\n", progname);
+  fprintf(stderr, "\t-b <packets>: Number of packets to receive. "
+                  "Default: %d\n", BENCH_DEFPACKETS);
+  fprintf(stderr, "\t-t: Split the stream at random points and insert "
+                  "unknown bytes and oversized packets\n");
+  fprintf(stderr, "\t-h: Show this text and exit\n");
+  exit(errcode);
+}
+
+static uint32_t next_rand(FAR uint32_t *seed)
+{
+  *seed = *seed * 1103515245 + 12345;
+  return *seed >> 16;
+}
+
+/* Build packet number 'index': a quarter are HCI events, half are control
+ * packets and the rest are media packets, the payload is pseudo random.
+ */
+
+static uint16_t make_packet(uint32_t index, FAR uint8_t *buf)
+{
+  uint32_t seed = index * 2654435761u + 1;
+  uint16_t payload;
+  uint16_t head;
+  uint16_t i;
+  uint32_t kind = next_rand(&seed) % 4;
+
+  if (kind == 0)
+    {
+      payload = next_rand(&seed) % 256;
+      buf[0]  = PACKET_HCI;
+      buf[1]  = 0x0e;
+      buf[2]  = (uint8_t)payload;
+      head    = 3;
+    }
+  else
+    {
+      payload = kind == 3 ? 200 + next_rand(&seed) % 791 :
+                            next_rand(&seed) % 101;
+      buf[0]  = kind == 3 ? PACKET_MEDIA : PACKET_CONTROL;
+      buf[1]  = (uint8_t)next_rand(&seed);
+      buf[2]  = (uint8_t)next_rand(&seed);
+      buf[3]  = (uint8_t)(payload & 0xff);
+      buf[4]  = (uint8_t)(payload >> 8);
+      head    = 5;
+    }
+
+  for (i = 0; i < payload; i++)
+    {
+      buf[head + i] = (uint8_t)next_rand(&seed);
+    }
+
+  return head + payload;
+}
+
+static int write_all(int fd, FAR const uint8_t *buf, size_t len)
+{
+  ssize_t n;
+
+  while (len > 0)
+    {
+      n = write(fd, buf, len);
+      if (n < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          return -errno;
+        }
+
+      buf += n;
+      len -= n;
+    }
+
+  return OK;
+}
+
+static int read_all(int fd, FAR uint8_t *buf, size_t len)
+{
+  ssize_t n;
+
+  while (len > 0)
+    {
+      n = read(fd, buf, len);
+      if (n <= 0)
+        {
+          if (n < 0 && errno == EINTR)
+            {
+              continue;
+            }
+
+          return n < 0 ? -errno : -EIO;
+        }
+
+      buf += n;
+      len -= n;
+    }
+
+  return OK;
+}
+
+/* The controller side: stream 'count' packets to the host, then receive
+ * and check BENCH_TXPACKETS packets from it.
+ */
+
+static int controller(int master, uint32_t count, bool torture)
+{
+  static uint8_t stream[8192];
+  uint8_t expect[BENCH_MAXPACKET];
+  uint8_t actual[BENCH_MAXPACKET];
+  uint32_t seed = 0xc0ffee;
+  size_t fill = 0;
+  size_t chunk;
+  size_t off;
+  uint16_t len;
+  uint32_t i;
+
+  for (i = 0; i < count; i++)
+    {
+      if (torture && i % 97 == 1)
+        {
+          /* Unknown packet types are dropped one byte at a time */
+
+          stream[fill++] = 0xff;
+          stream[fill++] = 0x7e;
+        }
+
+      if (torture && i % 251 == 2)
+        {
+          /* A control packet longer than the receive buffer, skipped */
+
+          stream[fill++] = PACKET_CONTROL;
+          stream[fill++] = 0;
+          stream[fill++] = 0;
+          stream[fill++] = BENCH_OVERSIZE & 0xff;
+          stream[fill++] = BENCH_OVERSIZE >> 8;
+          if (write_all(master, stream, fill) < 0)
+            {
+              return EXIT_FAILURE;
+            }
+
+          memset(stream, PACKET_HCI, BENCH_OVERSIZE);
+          if (write_all(master, stream, BENCH_OVERSIZE) < 0)
+            {
+              return EXIT_FAILURE;
+            }
+
+          fill = 0;
+        }
+
+      fill += make_packet(i, &stream[fill]);
+
+      if (fill >= sizeof(stream) - BENCH_MAXPACKET - 8 || i == count - 1)
+        {
+          /* In torture mode the stream arrives in random pieces, headers
+           * and payloads are split at any point.
+           */
+
+          for (off = 0; off < fill; off += chunk)
+            {
+              chunk = torture ? 1 + next_rand(&seed) % 300 : fill;
+              chunk = chunk < fill - off ? chunk : fill - off;
+              if (write_all(master, &stream[off], chunk) < 0)
+                {
+                  return EXIT_FAILURE;
+                }
+            }
+
+          fill = 0;
+        }
+    }
+
+  for (i = 0; i < BENCH_TXPACKETS; i++)
+    {
+      len = make_packet(BENCH_TXSEED + i, expect);
+      if (read_all(master, actual, len) < 0 ||
+          memcmp(actual, expect, len) != 0)
+        {
+          fprintf(stderr, "ERROR: TX packet %u mismatch\n", (unsigned)i);
+          return EXIT_FAILURE;
+        }
+    }
+
+  return EXIT_SUCCESS;
+}
+
+static double elapsed(FAR const struct timespec *start,
+                      FAR const struct timespec *end)
+{
+  return (double)(end->tv_sec - start->tv_sec) +
+         (double)(end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, FAR char **argv)
+{
+  uint8_t expect[BENCH_MAXPACKET];
+  struct timespec start;
+  struct timespec end;
+  struct termios tio;
+  unsigned long reads;
+  unsigned long polls;
+  unsigned long writes;
+  unsigned long ioctls;
+  unsigned long long bytes = 0;
+  uint32_t count = BENCH_DEFPACKETS;
+  bool torture = false;
+  uint16_t elen;
+  uint16_t len;
+  FAR uint8_t *p;
+  uint32_t i;
+  double sec;
+  pid_t pid;
+  int status;
+  int master;
+  int option;
+  int ret = OK;
+
+  while ((option = getopt(argc, argv, ":b:th")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'b':
+            count = strtoul(optarg, NULL, 0);
+            break;
+
+          case 't':
+            torture = true;
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0 ||
+      (g_uartpath = ptsname(master)) == NULL)
+    {
+      fprintf(stderr, "ERROR: Failed to create a pty pair: %d\n", errno);
+      return EXIT_FAILURE;
+    }
+
+  tcgetattr(master, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(master, TCSANOW, &tio);
+
+  if (btUartInitialization() != 0)
+    {
+      fprintf(stderr, "ERROR: btUartInitialization failed\n");
+      return EXIT_FAILURE;
+    }
+
+  pid = fork();
+  if (pid == 0)
+    {
+      exit(controller(master, count, torture));
+    }
+
+  /* Receive */
+
+  g_reads  = 0;
+  g_polls  = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (i = 0; i < count; i++)
+    {
+      p = btUartGetCompleteBuff(&len);
+      elen = make_packet(i, expect);
+      if (p == NULL || len != elen || memcmp(p, expect, len) != 0)
+        {
+          fprintf(stderr, "ERROR: RX packet %u mismatch\n", (unsigned)i);
+          ret = ERROR;
+          break;
+        }
+
+      bytes += len;
+      btUartReleaseCompleteBuff();
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  reads = g_reads;
+  polls = g_polls;
+  sec   = elapsed(&start, &end);
+
+  printf("rx: %u packets, %llu bytes in %.3f sec: %.1f KiB/sec\n",
+         (unsigned)i, bytes, sec, (double)bytes / 1024.0 / sec);
+  printf("rx: %.2f read + %.2f poll calls per packet\n",
+         (double)reads / i, (double)polls / i);
+
+  /* Send, alternating between whole packets and header + payload */
+
+  g_writes = 0;
+  g_ioctls = 0;
+  bytes    = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (i = 0; ret == OK && i < BENCH_TXPACKETS; i++)
+    {
+      elen = make_packet(BENCH_TXSEED + i, expect);
+      if (i % 2 == 0)
+        {
+          ret = btUartSendData(expect, elen);
+        }
+      else
+        {
+          len = expect[0] == PACKET_HCI ? 3 : 5;
+          ret = btUartSendPacket(expect, len, expect + len, elen - len);
+        }
+
+      bytes += elen;
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  writes = g_writes;
+  ioctls = g_ioctls;
+  sec    = elapsed(&start, &end);
+
+  waitpid(pid, &status, 0);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+    {
+      ret = ERROR;
+    }
+
+  printf("tx: %u packets, %llu bytes in %.3f sec: %.1f KiB/sec\n",
+         (unsigned)i, bytes, sec, (double)bytes / 1024.0 / sec);
+  printf("tx: %.2f write + %.2f ioctl calls per packet\n",
+         (double)writes / i, (double)ioctls / i);
+
+  /* The receive loop returns NULL once finalization is requested */
+
+  btUartFinalization();
+  if (btUartGetCompleteBuff(&len) != NULL)
+    {
+      ret = ERROR;
+    }
+
+  printf("verify: %s\n", ret == OK ? "OK" : "MISMATCH");
+  close(master);
+  return ret == OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,633 @@
+/****************************************************************************
+ * modules/bluetooth/hal/bcm20706/host/rxqbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark for the SPP receive path: UART manager, receive task,
+ *   receive queue and SPP profile.  A child process plays the controller
+ *   on the master side of a pseudo terminal and replays a stream of
+ *   controller packets at UART line rate, either generated (SPP connect,
+ *   data packets of random length, disconnect) or read from a capture file
+ *   of raw UART bytes.  The SPP receive callback simulates an application
+ *   which stalls now and then, e.g. for a flash write.
+ *
+ *   Reported are the delivered throughput, the latency from the controller
+ *   writing an SPP data packet to its receive callback, the longest time
+ *   the receive task spent away from the UART between a read() and the
+ *   next poll() (the UART driver has to buffer that much line time) and
+ *   the receive queue statistics.
+ *
+ *   Only the SPP path of bt_recv_task.c runs, the handlers of the other
+ *   profiles are stubs (rxqstubs.c).
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <errno.h>
+
+#include <bluetooth/bt_common.h>
+#include <bluetooth/bt_spp.h>
+
+#include "manager/bt_uart_manager.h"
+#include "bt_util.h"
+#include "bluetooth_rxq.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_DEFPACKETS   2000
+#define BENCH_DEFRATE      293       /* KiB/s, 3 Mbps UART */
+#define BENCH_DEFSTALLN    50
+#define BENCH_DEFSTALLMS   20
+#define BENCH_MAXPAYLOAD   998       /* Largest SPP data with the handle */
+#define BENCH_MAXSTREAM    (16 * 1024 * 1024)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+const char *g_uartpath;
+
+static uint8_t *g_stream;          /* Controller to host byte stream */
+static size_t   g_streamlen;
+static uint32_t *g_pktoff;         /* Offset of each packet */
+static bool     *g_pktdata;        /* Packet is SPP data */
+static uint32_t g_npkts;
+static uint32_t g_ndata;
+
+static volatile uint64_t *g_written; /* Shared: write time of SPP data */
+static uint64_t *g_latency;
+static volatile uint32_t g_received;
+static uint64_t g_bytes;
+static uint32_t g_held;
+static uint32_t g_stallevery = BENCH_DEFSTALLN;
+static uint32_t g_stallms    = BENCH_DEFSTALLMS;
+static uint32_t g_connects;
+static uint32_t g_disconnects;
+static uint64_t g_lastdelivery;
+static uint64_t g_readdone;
+static uint64_t g_maxstall;
+
+/****************************************************************************
+ * Wrappers
+ ****************************************************************************/
+
+ssize_t __real_read(int fd, void *buf, size_t count);
+int __real_poll(struct pollfd *fds, nfds_t nfds, int timeout);
+
+static uint64_t now_ns(void);
+
+/* The receive task is away from the UART from the return of a read() of
+ * it until the next poll().
+ */
+
+ssize_t __wrap_read(int fd, void *buf, size_t count)
+{
+  ssize_t ret = __real_read(fd, buf, count);
+
+  if (ret > 0 && isatty(fd))
+    {
+      g_readdone = now_ns();
+    }
+
+  return ret;
+}
+
+int __wrap_poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+  uint64_t stall;
+
+  if (g_readdone != 0)
+    {
+      stall = now_ns() - g_readdone;
+      if (stall > g_maxstall)
+        {
+          g_maxstall = stall;
+        }
+
+      g_readdone = 0;
+    }
+
+  return __real_poll(fds, nfds, timeout);
+}
+
+/* Called by the exit path of btUartGetCompleteBuff() */
+
+int btChangeFreLock(uint32_t baudrate)
+{
+  (void)baudrate;
+  return 0;
+}
+
+int btRecvTaskEntry(void);
+int btRecvTaskEnd(void);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(FAR const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-n <packets>] [-r <KiB/s>] "
+                  "[-s <every>:<msec>] [-f <capture>] [-w <capture>] [-h]\n",
+                  progname);
+  fprintf(stderr, "\t-n <packets>: SPP data packets to generate. "
+                  "Default: %d\n", BENCH_DEFPACKETS);
+  fprintf(stderr, "\t-r <KiB/s>: UART line rate. Default: %d\n",
+                  BENCH_DEFRATE);
+  fprintf(stderr, "\t-s <every>:<msec>: Stall the application for <msec> "
+                  "every <every> packets. Default: %d:%d\n",
+                  BENCH_DEFSTALLN, BENCH_DEFSTALLMS);
+  fprintf(stderr, "\t-f <capture>: Replay raw controller bytes from a file\n");
+  fprintf(stderr, "\t-w <capture>: Save the generated stream to a file\n");
+  fprintf(stderr, "\t-h: Show this text and exit\n");
+  exit(errcode);
+}
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint32_t next_rand(FAR uint32_t *seed)
+{
+  *seed = *seed * 1103515245 + 12345;
+  return *seed >> 16;
+}
+
+static void put_spp_event(uint8_t evtcode, FAR const uint8_t *payload,
+                          uint16_t len)
+{
+  uint8_t *p = &g_stream[g_streamlen];
+
+  p[0] = PACKET_CONTROL;
+  p[1] = evtcode;
+  p[2] = BT_CONTROL_GROUP_SPP;
+  p[3] = (uint8_t)(len & 0xff);
+  p[4] = (uint8_t)(len >> 8);
+  memcpy(&p[5], payload, len);
+  g_streamlen += 5 + len;
+}
+
+static void make_stream(uint32_t count)
+{
+  uint8_t payload[2 + BENCH_MAXPAYLOAD];
+  uint32_t seed = 0x5eed;
+  uint16_t len;
+  uint32_t i;
+  uint16_t j;
+
+  /* Connected: address and handle */
+
+  memset(payload, 0, 8);
+  payload[6] = 0x01;
+  put_spp_event(BT_CONTROL_SPP_EVENT_CONNECTED, payload, 8);
+
+  for (i = 0; i < count; i++)
+    {
+      len = 16 + next_rand(&seed) % (BENCH_MAXPAYLOAD - 15);
+      payload[0] = 0x01;
+      payload[1] = 0x00;
+      for (j = 0; j < len; j++)
+        {
+          payload[2 + j] = (uint8_t)(i + j);
+        }
+
+      put_spp_event(BT_CONTROL_SPP_EVENT_RX_DATA, payload, 2 + len);
+    }
+
+  put_spp_event(BT_CONTROL_SPP_EVENT_DISCONNECTED, payload, 2);
+}
+
+/* Split the stream into packets with the framing of the UART manager */
+
+static int index_stream(void)
+{
+  size_t off = 0;
+  size_t len;
+  uint8_t *p;
+
+  g_npkts = 0;
+  g_ndata = 0;
+
+  while (off < g_streamlen)
+    {
+      p = &g_stream[off];
+      switch (p[0])
+        {
+          case PACKET_HCI:
+            len = 3 + p[2];
+            break;
+
+          case PACKET_CONTROL:
+          case PACKET_MEDIA:
+            len = 5 + (p[3] | (p[4] << 8));
+            break;
+
+          default:
+            len = 1;
+            break;
+        }
+
+      if (off + len > g_streamlen)
+        {
+          break;
+        }
+
+      g_pktoff[g_npkts]  = off;
+      g_pktdata[g_npkts] = p[0] == PACKET_CONTROL &&
+                           p[1] == BT_CONTROL_SPP_EVENT_RX_DATA &&
+                           p[2] == BT_CONTROL_GROUP_SPP && len > 7;
+      g_ndata += g_pktdata[g_npkts] ? 1 : 0;
+      g_npkts++;
+      off += len;
+    }
+
+  g_pktoff[g_npkts] = off;
+  return g_npkts > 0 ? OK : ERROR;
+}
+
+static int write_all(int fd, FAR const uint8_t *buf, size_t len)
+{
+  ssize_t n;
+
+  while (len > 0)
+    {
+      n = write(fd, buf, len);
+      if (n < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          return -errno;
+        }
+
+      buf += n;
+      len -= n;
+    }
+
+  return OK;
+}
+
+/* The controller side: send the packets paced at the line rate */
+
+static int controller(int master, uint32_t rate)
+{
+  struct timespec ts;
+  uint64_t start = now_ns();
+  uint64_t sent  = 0;
+  uint64_t due;
+  uint32_t data  = 0;
+  uint32_t i;
+  size_t len;
+
+  for (i = 0; i < g_npkts; i++)
+    {
+      due = start + sent * 1000000000ull / ((uint64_t)rate * 1024);
+      ts.tv_sec  = due / 1000000000ull;
+      ts.tv_nsec = due % 1000000000ull;
+      clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+
+      len = g_pktoff[i + 1] - g_pktoff[i];
+      if (g_pktdata[i])
+        {
+          g_written[data++] = now_ns();
+        }
+
+      if (write_all(master, &g_stream[g_pktoff[i]], len) < 0)
+        {
+          return EXIT_FAILURE;
+        }
+
+      sent += len;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+static void spp_connect(struct bt_acl_state_s *bt_acl_state)
+{
+  g_connects++;
+}
+
+static void spp_disconnect(struct bt_acl_state_s *bt_acl_state)
+{
+  g_disconnects++;
+}
+
+static void spp_receive(struct bt_acl_state_s *bt_acl_state,
+                        uint8_t *data, int len)
+{
+  uint32_t index = g_received;
+  uint64_t now   = now_ns();
+
+  g_latency[index] = now - g_written[index];
+  g_bytes         += len;
+
+  /* The data stays valid while held */
+
+  if (bt_rxbuf_hold(data) == 0)
+    {
+      g_held++;
+      bt_rxbuf_release(data);
+    }
+
+  if (g_stallevery > 0 && index % g_stallevery == g_stallevery - 1)
+    {
+      usleep(g_stallms * 1000);
+    }
+
+  g_lastdelivery = now_ns();
+  g_received     = index + 1;
+}
+
+static int compare_u64(FAR const void *a, FAR const void *b)
+{
+  uint64_t x = *(FAR const uint64_t *)a;
+  uint64_t y = *(FAR const uint64_t *)b;
+
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static int load_file(FAR const char *path)
+{
+  ssize_t n;
+  int fd;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0)
+    {
+      return -errno;
+    }
+
+  while ((n = read(fd, g_stream + g_streamlen,
+                   BENCH_MAXSTREAM - g_streamlen)) > 0)
+    {
+      g_streamlen += n;
+    }
+
+  close(fd);
+  return n < 0 ? -EIO : OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, FAR char **argv)
+{
+  static struct bt_spp_ops_s ops =
+  {
+    .connect      = spp_connect,
+    .disconnect   = spp_disconnect,
+    .receive_data = spp_receive
+  };
+
+  FAR const char *capture = NULL;
+  FAR const char *save = NULL;
+  struct bt_rxq_stats_s stats;
+  struct termios tio;
+  uint32_t count = BENCH_DEFPACKETS;
+  uint32_t rate  = BENCH_DEFRATE;
+  uint64_t deadline;
+  uint64_t sum = 0;
+  double sec;
+  pid_t pid;
+  int status;
+  int master;
+  int option;
+  int ret = OK;
+  int fd;
+  uint32_t i;
+
+  while ((option = getopt(argc, argv, ":n:r:s:f:w:h")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'n':
+            count = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'r':
+            rate = strtoul(optarg, NULL, 0);
+            break;
+
+          case 's':
+            if (sscanf(optarg, "%u:%u", &g_stallevery, &g_stallms) != 2)
+              {
+                show_usage(argv[0], EXIT_FAILURE);
+              }
+            break;
+
+          case 'f':
+            capture = optarg;
+            break;
+
+          case 'w':
+            save = optarg;
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (rate == 0)
+    {
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+
+  g_stream = malloc(BENCH_MAXSTREAM);
+  if (!g_stream)
+    {
+      return EXIT_FAILURE;
+    }
+
+  if (capture)
+    {
+      if (load_file(capture) < 0)
+        {
+          fprintf(stderr, "ERROR: Failed to read %s\n", capture);
+          return EXIT_FAILURE;
+        }
+    }
+  else
+    {
+      count = count < BENCH_MAXSTREAM / 1024 ? count : BENCH_MAXSTREAM / 1024;
+      make_stream(count);
+    }
+
+  if (save)
+    {
+      fd = open(save, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0 || write_all(fd, g_stream, g_streamlen) < 0)
+        {
+          fprintf(stderr, "ERROR: Failed to write %s\n", save);
+          return EXIT_FAILURE;
+        }
+
+      close(fd);
+    }
+
+  g_pktoff  = malloc((g_streamlen + 1) * sizeof(uint32_t));
+  g_pktdata = malloc(g_streamlen * sizeof(bool));
+  if (!g_pktoff || !g_pktdata || index_stream() < 0 || g_ndata == 0)
+    {
+      fprintf(stderr, "ERROR: No SPP data in the stream\n");
+      return EXIT_FAILURE;
+    }
+
+  g_written = mmap(NULL, g_ndata * sizeof(uint64_t),
+                   PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  g_latency = malloc(g_ndata * sizeof(uint64_t));
+  if (g_written == MAP_FAILED || !g_latency)
+    {
+      return EXIT_FAILURE;
+    }
+
+  /* The pty stands in for the UART */
+
+  master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0 ||
+      (g_uartpath = ptsname(master)) == NULL)
+    {
+      fprintf(stderr, "ERROR: Failed to create a pty pair: %d\n", errno);
+      return EXIT_FAILURE;
+    }
+
+  tcgetattr(master, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(master, TCSANOW, &tio);
+
+  bt_spp_register_cb(&ops);
+  if (btUartInitialization() != 0 || bt_rxq_initialize() != 0 ||
+      btRecvTaskEntry() != 0)
+    {
+      fprintf(stderr, "ERROR: Failed to start the receive path\n");
+      return EXIT_FAILURE;
+    }
+
+  pid = fork();
+  if (pid == 0)
+    {
+      _exit(controller(master, rate));
+    }
+
+  waitpid(pid, &status, 0);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+    {
+      ret = ERROR;
+    }
+
+  /* Wait for the application to see everything the controller sent */
+
+  deadline = now_ns() + 10000000000ull;
+  while (g_received < g_ndata && now_ns() < deadline)
+    {
+      usleep(1000);
+    }
+
+  btUartFinalization();
+  btRecvTaskEnd();
+  bt_rxq_finalize();
+
+  memset(&stats, 0, sizeof(stats));
+  bt_rxq_get_stats(&stats);
+
+  sec = (double)(g_lastdelivery - g_written[0]) / 1e9;
+  printf("spp: %u/%u packets, %llu bytes in %.3f sec: %.1f KiB/sec\n",
+         (unsigned)g_received, (unsigned)g_ndata,
+         (unsigned long long)g_bytes, sec, (double)g_bytes / 1024.0 / sec);
+
+  for (i = 0; i < g_received; i++)
+    {
+      sum += g_latency[i];
+    }
+
+  qsort(g_latency, g_received, sizeof(uint64_t), compare_u64);
+  if (g_received > 0)
+    {
+      printf("latency: avg %.2f ms, p99 %.2f ms, max %.2f ms\n",
+             (double)sum / g_received / 1e6,
+             (double)g_latency[(g_received * 99) / 100] / 1e6,
+             (double)g_latency[g_received - 1] / 1e6);
+    }
+
+  printf("receiver: max %.2f ms away from the UART (%.0f bytes of line "
+         "time)\n", (double)g_maxstall / 1e6,
+         (double)g_maxstall / 1e9 * rate * 1024);
+  printf("rxq: posted %u, copied %u, dropped %u, waits %u, max depth %u, "
+         "held %u\n", (unsigned)stats.posted, (unsigned)stats.copied,
+         (unsigned)stats.dropped, (unsigned)stats.waits,
+         (unsigned)stats.max_depth, (unsigned)g_held);
+
+  if (g_received != g_ndata || g_connects != 1 || g_disconnects != 1)
+    {
+      ret = ERROR;
+    }
+
+  printf("verify: %s\n", ret == OK ? "OK" : "FAILED");
+  close(master);
+  return ret == OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
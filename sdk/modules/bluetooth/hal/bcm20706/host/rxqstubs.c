@@ -0,0 +1,78 @@
+/****************************************************************************
+ * modules/bluetooth/hal/bcm20706/host/rxqstubs.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   The receive task references the handlers of every profile, rxqbench
+ *   only links the SPP one.  The others must never be reached.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RXQ_STUB(name) \
+  void name(void) \
+  { \
+    fprintf(stderr, "ERROR: %s is not linked\n", #name); \
+    abort(); \
+  }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+RXQ_STUB(BLE_GapSaveBondInfo)
+RXQ_STUB(bleGapReplySecurity)
+RXQ_STUB(bleRecvAuthStatus)
+RXQ_STUB(bleRecvGattCharDiscovered)
+RXQ_STUB(bleRecvGattCompleteDiscovered)
+RXQ_STUB(bleRecvGattDescriptorDiscovered)
+RXQ_STUB(bleRecvGattServiceDiscovered)
+RXQ_STUB(bleRecvNvramData)
+RXQ_STUB(ble_common_event_handler)
+RXQ_STUB(ble_gatt_event_handler)
+RXQ_STUB(bt_a2dp_event_handler)
+RXQ_STUB(bt_avrcp_event_handler)
+RXQ_STUB(bt_common_event_handler)
+RXQ_STUB(bt_hfp_event_handler)
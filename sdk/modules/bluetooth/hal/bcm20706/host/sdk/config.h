@@ -0,0 +1,62 @@
+/****************************************************************************
+ * modules/bluetooth/hal/bcm20706/host/sdk/config.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Minimal configuration for building the BCM20706 UART manager and the
+ * receive task on the host.  The UART device path is chosen at run time by
+ * the benchmarks.
+ */
+
+#ifndef __MODULES_BLUETOOTH_HAL_BCM20706_HOST_SDK_CONFIG_H
+#define __MODULES_BLUETOOTH_HAL_BCM20706_HOST_SDK_CONFIG_H
+
+#include <stdint.h>
+#include <assert.h>
+
+#define OK    0
+#define ERROR -1
+#define FAR
+
+#define ASSERT(f)                       assert(f)
+
+#define CONFIG_BCM20706_UART_DEV_PATH   g_uartpath
+#define CONFIG_UART2_TXBUFSIZE          256
+
+/* NuttX serial ioctl, answered by the benchmark's ioctl() wrapper */
+
+#define FIONSPACE                       0x7f01
+
+extern const char *g_uartpath;
+
+#endif /* __MODULES_BLUETOOTH_HAL_BCM20706_HOST_SDK_CONFIG_H */
@@ -52,6 +52,8 @@ int btWaitTxSem(void);
 int btPostTxSem(void);
 int btUartSendRawData(uint8_t *p, uint16_t len);
 int btUartSendData(uint8_t *p, uint16_t len);
+int btUartSendPacket(uint8_t *head, uint16_t headLen,
+                     uint8_t *data, uint16_t dataLen);
 uint8_t* btUartGetCompleteBuff(uint16_t *len);
 uint8_t* btUartGetCompleteBuffSingle(uint16_t *len);
 void btUartReleaseCompleteBuff(void);
@@ -437,25 +437,41 @@ static void btRecvSppEvtDisconnect(uint8_t *p)
 
 static void btRecvSppEvtRxData(uint8_t *p, uint16_t len)
 {
-  struct bt_spp_event_recv_data_t recv_evt;
+  struct bt_spp_event_recv_data_t *recv_evt;
   uint16_t handle = 0;
 
+  if (len < HANDLE_SIZE)
+    {
+      return;
+    }
+
+  /* Build the event in a receive buffer, it is handed to the application
+   * without another copy.  NULL if the application holds all of them for
+   * longer than the SPP timeout, the data is dropped then.
+   */
+
+  recv_evt = (struct bt_spp_event_recv_data_t *) bt_rxq_alloc(BT_GROUP_SPP);
+  if (!recv_evt)
+    {
+      DBG_LOG_ERROR("spp rx data dropped, len = %d\n", len);
+      return;
+    }
+
   /* Get handle ID */
 
   STREAM_TO_UINT16(handle, p);
   (void) handle;
 
   /* Get data length */
-  len = MIN(len, BT_EVT_DATA_LEN);
-  recv_evt.len = len - HANDLE_SIZE;
+  recv_evt->len = MIN(len - HANDLE_SIZE, BT_MAX_EVENT_DATA_LEN);
 
   /* Get data body */
-  memcpy(recv_evt.data, p, recv_evt.len);
+  memcpy(recv_evt->data, p, recv_evt->len);
 
-  recv_evt.group_id = BT_GROUP_SPP;
-  recv_evt.event_id = BT_SPP_EVENT_RX_DATA;
+  recv_evt->group_id = BT_GROUP_SPP;
+  recv_evt->event_id = BT_SPP_EVENT_RX_DATA;
 
-  bt_spp_event_handler((struct bt_event_t *) &recv_evt);
+  bt_spp_event_handler((struct bt_event_t *) recv_evt);
 }
 
 static void btRecvHfpCommandStatus(uint8_t *p)
@@ -75,10 +75,23 @@
 #define BT_PACKET_HEADER_LEN      5
 #define BT_BUF_MAX_LEN            BT_EVT_DATA_LEN + BT_PACKET_HEADER_LEN
 
+/* Receive ring, the UART is drained into it with as few reads as the
+ * driver allows and the packets are parsed in place.
+ */
+
+#ifndef CONFIG_BCM20706_UART_RXBUFSIZE
+#define CONFIG_BCM20706_UART_RXBUFSIZE 2048
+#endif
+
+#define BT_RX_RING_SIZE           CONFIG_BCM20706_UART_RXBUFSIZE
+
+#if BT_RX_RING_SIZE < (BT_BUF_MAX_LEN) || BT_RX_RING_SIZE > 32768
+#  error "CONFIG_BCM20706_UART_RXBUFSIZE out of range"
+#endif
+
 #define PKT_TYPE_IDX 0
 
 #define HCI_PRE_RECV_BYTES 3
-#define CTL_PRE_RECV_BYTES 2
 
 #define PKT_HCI_DATA_LEN_IDX 2
 #define PKT_HCI_HEAD_LEN 2
@@ -116,7 +129,19 @@ typedef struct
 
 typedef struct
 {
-  UART_BUFF inputData;
+  uint16_t head;     /* Next byte to be written by read() */
+  uint16_t tail;     /* First byte not yet released */
+  uint16_t count;    /* Bytes held in the ring */
+  uint16_t pktLen;   /* Length of the packet handed out, 0 if none */
+  uint32_t discard;  /* Bytes of an oversized packet still to drop */
+  uint8_t buff[BT_RX_RING_SIZE];
+} UART_RING;
+
+typedef struct
+{
+  UART_BUFF inputData; /* Packets which wrap around the end of rxRing */
+  UART_BUFF txData;    /* Packets sent in two parts are joined here */
+  UART_RING rxRing;
   int uartFd;
   int ctrlFd[CTL_MAX];
   sem_t uartTxSem;
@@ -132,57 +157,159 @@ static UART_MGR_CONTEXT gCtx;
  * Private Functions
  ****************************************************************************/
 
-static void btUartRecvBytes(UART_BUFF *inputData, uint16_t len)
+static uint8_t btUartPeek(UART_RING *ring, uint16_t offset)
 {
-  UART_MGR_CONTEXT *ctx = &gCtx;
-  uint8_t *buff = inputData->buff + inputData->dataLen;
-  ssize_t readLen = 0;
-  uint16_t recvLen = 0;
+  return ring->buff[(ring->tail + offset) % BT_RX_RING_SIZE];
+}
+
+static void btUartDrop(UART_RING *ring, uint16_t len)
+{
+  ring->tail = (ring->tail + len) % BT_RX_RING_SIZE;
+  ring->count -= len;
 
-  while (recvLen != len)
+  /* Restart from the top when empty, so that the next packets are more
+   * likely to be contiguous.
+   */
+
+  if (ring->count == 0)
+    {
+      ring->head = 0;
+      ring->tail = 0;
+    }
+}
+
+static int btUartFillRing(UART_MGR_CONTEXT *ctx)
+{
+  UART_RING *ring = &ctx->rxRing;
+  uint16_t space = BT_RX_RING_SIZE - ring->count;
+  ssize_t readLen;
+
+  /* Take everything the driver holds, up to the end of the ring */
+
+  space = MIN(space, BT_RX_RING_SIZE - ring->head);
+
+  readLen = read(ctx->uartFd, &ring->buff[ring->head], space);
+  if (readLen < 0)
     {
-      readLen = read(ctx->uartFd, buff, 1);
-      if (readLen < 0)
+      DBG_LOG_ERROR("read %s error: %d\n", BT_UART_FILE, errno);
+      return -errno;
+    }
+
+  ring->head   = (ring->head + readLen) % BT_RX_RING_SIZE;
+  ring->count += readLen;
+
+  return readLen;
+}
+
+static uint8_t *btUartParsePacket(UART_MGR_CONTEXT *ctx, uint16_t *len)
+{
+  UART_RING *ring = &ctx->rxRing;
+  uint32_t pktLen;
+  uint16_t dropLen;
+  uint16_t first;
+
+  while (true)
+    {
+      if (ring->discard > 0)
         {
-          DBG_LOG_ERROR("read %s error: %d\n", BT_UART_FILE, errno);
-          break;
+          dropLen = MIN(ring->discard, ring->count);
+          btUartDrop(ring, dropLen);
+          ring->discard -= dropLen;
+          if (ring->discard > 0)
+            {
+              return NULL;
+            }
+        }
+
+      if (ring->count == 0)
+        {
+          return NULL;
         }
-      else
+
+      switch (btUartPeek(ring, PKT_TYPE_IDX))
         {
-          recvLen += (uint16_t)readLen;
-          ++buff;
+          case PACKET_HCI:
+            if (ring->count < HCI_PRE_RECV_BYTES)
+              {
+                return NULL;
+              }
+
+            pktLen = HCI_PRE_RECV_BYTES +
+                     btUartPeek(ring, PKT_HCI_DATA_LEN_IDX);
+            break;
+
+          case PACKET_MEDIA:
+          case PACKET_CONTROL:
+            if (ring->count < BT_PACKET_HEADER_LEN)
+              {
+                return NULL;
+              }
+
+            pktLen = BT_PACKET_HEADER_LEN +
+                     (btUartPeek(ring, PKT_CTL_DATA_LEN_L_IDX) |
+                      (btUartPeek(ring, PKT_CTL_DATA_LEN_H_IDX) << 8));
+            break;
+
+          default:
+            DBG_LOG_ERROR("unknown packet, type: %02x.\n",
+                          btUartPeek(ring, PKT_TYPE_IDX));
+            btUartDrop(ring, 1);
+            continue;
         }
+
+      if (pktLen > BT_BUF_MAX_LEN)
+        {
+          DBG_LOG_ERROR("packet too long: %d\n", (int)pktLen);
+          ring->discard = pktLen;
+          continue;
+        }
+
+      if (ring->count < pktLen)
+        {
+          return NULL;
+        }
+
+      break;
+    }
+
+  ring->pktLen = (uint16_t)pktLen;
+  *len = (uint16_t)pktLen;
+
+  first = BT_RX_RING_SIZE - ring->tail;
+  if (pktLen <= first)
+    {
+      return &ring->buff[ring->tail];
     }
 
-  inputData->dataLen += len;
+  memcpy(ctx->inputData.buff, &ring->buff[ring->tail], first);
+  memcpy(ctx->inputData.buff + first, ring->buff, pktLen - first);
+
+  return ctx->inputData.buff;
 }
 
-static void btUartRecvPacket(UART_BUFF *inputData)
+static int btUartWriteAll(UART_MGR_CONTEXT *ctx, uint8_t *p, uint16_t len)
 {
-  uint8_t *buff = inputData->buff;
-  uint16_t rxLen = HCI_PRE_RECV_BYTES;
-
-  btUartRecvBytes(inputData, rxLen);
+  ssize_t writtenLen = 0;
+  uint16_t sentLen   = 0;
 
-  switch (buff[PKT_TYPE_IDX])
+  while (sentLen != len)
     {
-      case PACKET_HCI:
-        rxLen = buff[PKT_HCI_DATA_LEN_IDX];
-        btUartRecvBytes(inputData, rxLen);
-        break;
-
-      case PACKET_MEDIA:
-      case PACKET_CONTROL:
-        btUartRecvBytes(inputData, CTL_PRE_RECV_BYTES);
-        rxLen = (buff[PKT_CTL_DATA_LEN_L_IDX] | (buff[PKT_CTL_DATA_LEN_H_IDX] << 8));
-        btUartRecvBytes(inputData, rxLen);
-        break;
-
-      default:
-        DBG_LOG_ERROR("unknown packet, type: %02x.\n", buff[PKT_TYPE_IDX]);
-        break;
+      writtenLen = write(ctx->uartFd, p + sentLen, len - sentLen);
+      if (writtenLen < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
 
+          DBG_LOG_ERROR("write %s error: %d\n", BT_UART_FILE, errno);
+          return -EIO;
+        }
+
+      sentLen += (uint16_t)writtenLen;
     }
+
+  return 0;
 }
 
 static int btIsUartDataReady(UART_MGR_CONTEXT *ctx)
@@ -332,6 +459,23 @@ int btPostTxSem(void)
 
 int btUartSendData(uint8_t *p, uint16_t len)
 {
+  return btUartSendPacket(p, len, NULL, 0);
+}
+
+/****************************************************************************
+ * Name: btUartSendPacket
+ *
+ * Description:
+ *   Send one packet given as a header and a payload.  Both parts are sent
+ *   under one hold of the TX semaphore, joined into a single write when
+ *   they fit in the TX buffer.
+ *
+ ****************************************************************************/
+
+int btUartSendPacket(uint8_t *head, uint16_t headLen,
+                     uint8_t *data, uint16_t dataLen)
+{
+  UART_MGR_CONTEXT *ctx = &gCtx;
   int ret = 0;
   ret = btWaitTxSem();
   if (ret)
@@ -341,13 +485,33 @@ int btUartSendData(uint8_t *p, uint16_t len)
     }
   board_bluetooth_enable_sleep(false);
 
-  ret = btUartSendRawData(p, len);
+  if (dataLen == 0)
+    {
+      ret = btUartSendRawData(head, headLen);
+    }
+  else if (headLen + dataLen <= sizeof(ctx->txData.buff))
+    {
+      memcpy(ctx->txData.buff, head, headLen);
+      memcpy(ctx->txData.buff + headLen, data, dataLen);
+      ret = btUartSendRawData(ctx->txData.buff, headLen + dataLen);
+    }
+  else
+    {
+      ret = btUartWriteAll(ctx, head, headLen);
+      if (ret == 0)
+        {
+          ret = btUartSendRawData(data, dataLen);
+        }
+    }
+
+  board_bluetooth_enable_sleep(true);
+
   if (ret)
     {
       btdbg("uart send data failed\n");
-      return btPostTxSem();
+      btPostTxSem();
+      return ret;
     }
-  board_bluetooth_enable_sleep(true);
   ret = btPostTxSem();
   if (ret)
     {
@@ -360,30 +524,11 @@ int btUartSendData(uint8_t *p, uint16_t len)
 int btUartSendRawData(uint8_t *p, uint16_t len)
 {
   UART_MGR_CONTEXT *ctx = &gCtx;
-  ssize_t writtenLen    = 0;
-  uint16_t sentLen      = 0;
   int ret               = 0;
 
-  do
-    {
-      writtenLen = write(ctx->uartFd, p, 1);
-      if (writtenLen < 0)
-        {
-          ret = writtenLen;
-          DBG_LOG_ERROR("write %s error: %d\n", BT_UART_FILE, errno);
-          break;
-        }
-      else
-        {
-          sentLen += (uint16_t)writtenLen;
-          ++p;
-        }
-    }
-  while (sentLen != len);
-
+  ret = btUartWriteAll(ctx, p, len);
   if (ret)
     {
-      ret = -EIO;
       return ret;
     }
 
@@ -400,17 +545,29 @@ int btUartSendRawData(uint8_t *p, uint16_t len)
 uint8_t *btUartGetCompleteBuff(uint16_t *len)
 {
   UART_MGR_CONTEXT *ctx = &gCtx;
-  UART_BUFF *inputData = &ctx->inputData;
   uint8_t *buff = NULL;
-  int ret = btIsUartDataReady(ctx);
+  int ret = 0;
 
-  if (ret > 0)
+  btUartReleaseCompleteBuff();
+
+  /* Parse from the ring, read more only when no packet is complete */
+
+  while ((buff = btUartParsePacket(ctx, len)) == NULL)
     {
-      btUartRecvPacket(inputData);
-      buff = inputData->buff;
-      *len = inputData->dataLen;
+      ret = btIsUartDataReady(ctx);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      ret = btUartFillRing(ctx);
+      if (ret == 0 || (ret < 0 && ret != -EINTR && ret != -EAGAIN))
+        {
+          return NULL;
+        }
     }
-  else if (0 == ret)
+
+  if (buff == NULL && 0 == ret)
     {
       if (CTL_CMD_EXIT == btGetCtrlCmd(ctx))
         {
@@ -449,7 +606,13 @@ uint8_t *btUartGetCompleteBuff(uint16_t *len)
 
 void btUartReleaseCompleteBuff(void)
 {
-  gCtx.inputData.dataLen = 0;
+  UART_RING *ring = &gCtx.rxRing;
+
+  if (ring->pktLen > 0)
+    {
+      btUartDrop(ring, ring->pktLen);
+      ring->pktLen = 0;
+    }
 }
 
 uint8_t *btUartGetCompleteBuffSingle(uint16_t *len)
@@ -0,0 +1,107 @@
+/****************************************************************************
+ * modules/dnnrt/host/dnnrt/nnablart/network.h
+ *
+ *   Copyright 2019 Sony Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __MODULES_DNNRT_HOST_NNABLART_NETWORK_H
+#define __MODULES_DNNRT_HOST_NNABLART_NETWORK_H
+
+/* Subset of nnabla-c-runtime's network.h used by the host harnesses.
+ * The real header is copied from externals/nnabla-c-runtime at build
+ * time; only the members referenced by dnnrt are reproduced here.
+ */
+
+#include <stdint.h>
+
+#define NN_BINARY_FORMAT_VERSION (3)
+
+/* convert an offset in the network into an address */
+
+#define NN_GET(N, X) ((void *)((uint8_t *)(N) + (X)))
+
+typedef int32_t nn_list_offset_t;
+
+typedef struct
+{
+  int32_t size;
+  nn_list_offset_t list;
+} nn_list_t;
+
+typedef enum
+{
+  NN_DATA_TYPE_FLOAT,
+  NN_DATA_TYPE_INT16,
+  NN_DATA_TYPE_INT8,
+  NN_DATA_TYPE_SIGN
+} nn_data_type_t;
+
+typedef enum
+{
+  NN_FUNCTION_AFFINE = 0,
+  NN_FUNCTION_CONVOLUTION = 1,
+  NN_FUNCTION_MAX_POOLING = 4,
+  NN_FUNCTION_SIGMOID = 8,
+  NN_FUNCTION_TANH = 10,
+  NN_FUNCTION_RELU = 11,
+  NN_FUNCTION_SOFTMAX = 17,
+  NN_FUNCTION_ADD2 = 38
+} nn_function_type_t;
+
+typedef struct
+{
+  int32_t version;
+  int32_t api_level;
+  nn_list_t buffers;
+  nn_list_t variables;
+  nn_list_t functions;
+  nn_list_t inputs;
+  nn_list_t outputs;
+  nn_list_t memory_data;
+} nn_network_t;
+
+typedef struct
+{
+  nn_list_t shape;
+  int32_t type;
+  int32_t fp_pos;
+  int32_t data_index;  /* >= 0: parameter, < 0: -1 - buffer index */
+} nn_variable_t;
+
+typedef struct
+{
+  uint16_t type;       /* nn_function_type_t */
+  uint16_t impl;
+  nn_list_t inputs;
+  nn_list_t outputs;
+} nn_function_t;
+
+#endif /* __MODULES_DNNRT_HOST_NNABLART_NETWORK_H */
@@ -0,0 +1,251 @@
+/****************************************************************************
+ * modules/dnnrt/host/fakert.c
+ *
+ *   Copyright 2019 Sony Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host stand-in of nnabla-c-runtime for runtime_nnabla.c.  Variable
+ * buffers are taken through the callbacks set by rt_set_variable_malloc()
+ * in buffer order as the real runtime does, and rt_forward() evaluates the
+ * network with hostnet_forward() and then sleeps for g_fakert_forward_us to
+ * model the compute time on the target.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "runtime_common.h"
+#include "runtime_internal.h"
+#include "hostnet.h"
+#include "fakert.h"
+
+unsigned int g_fakert_forward_us;
+
+static void *(*g_malloc)(size_t size) = malloc;
+static void (*g_free)(void *ptr) = free;
+
+static nn_variable_t *fakert_var(const nn_network_t * n, int idx)
+{
+  int32_t *list = (int32_t *) NN_GET(n, n->variables.list);
+  return (nn_variable_t *) NN_GET(n, list[idx]);
+}
+
+static int fakert_elems(const nn_network_t * n, int idx)
+{
+  return *(int32_t *) NN_GET(n, fakert_var(n, idx)->shape.list);
+}
+
+void rt_set_variable_malloc(void *(*user_malloc)(size_t size))
+{
+  g_malloc = user_malloc;
+}
+
+void rt_set_variable_free(void (*user_free)(void *ptr))
+{
+  g_free = user_free;
+}
+
+rt_return_value_t rt_allocate_context(rt_context_pointer * context)
+{
+  *context = calloc(1, sizeof(rt_context_t));
+  return *context ? RT_RET_NOERROR : RT_RET_ERROR_ALLOCATE_CONTEXT;
+}
+
+rt_return_value_t rt_add_callback(rt_context_pointer context,
+                                  nn_function_type_t type,
+                                  rt_function_callback_t allocate)
+{
+  return RT_RET_NOERROR;
+}
+
+rt_return_value_t rt_initialize_context(rt_context_pointer context,
+                                        nn_network_t * n)
+{
+  rt_context_t *c = (rt_context_t *) context;
+  int32_t *bsize = (int32_t *) NN_GET(n, n->buffers.list);
+  int i;
+
+  c->network = n;
+  c->variable_num = n->variables.size;
+  c->variables = calloc(n->variables.size, sizeof(rt_variable_t));
+  c->buffers = calloc(n->buffers.size, sizeof(void *));
+  c->input_variable_ids = (int *)NN_GET(n, n->inputs.list);
+  c->output_variable_ids = (int *)NN_GET(n, n->outputs.list);
+
+  for (i = 0; i < n->buffers.size; i++)
+    {
+      c->buffers[i] = g_malloc(bsize[i]);
+    }
+
+  for (i = 0; i < n->variables.size; i++)
+    {
+      nn_variable_t *var = fakert_var(n, i);
+
+      if (var->data_index < 0)
+        {
+          c->variables[i].data = c->buffers[-1 - var->data_index];
+        }
+    }
+
+  return RT_RET_NOERROR;
+}
+
+rt_return_value_t rt_free_context(rt_context_pointer * context)
+{
+  rt_context_t *c = (rt_context_t *) * context;
+  int i;
+
+  if (c == NULL)
+    {
+      return RT_RET_NOERROR;
+    }
+
+  for (i = 0; c->buffers != NULL && i < c->network->buffers.size; i++)
+    {
+      g_free(c->buffers[i]);
+    }
+
+  free(c->buffers);
+  free(c->variables);
+  free(c);
+  *context = NULL;
+  return RT_RET_NOERROR;
+}
+
+rt_return_value_t rt_forward(rt_context_pointer context)
+{
+  rt_context_t *c = (rt_context_t *) context;
+  nn_network_t *n = c->network;
+  void *bufaddr[HOSTNET_MAX_VARS];
+  struct timespec ts;
+  int i;
+
+  /* fed inputs replace the buffers of the input variables */
+
+  memcpy(bufaddr, c->buffers, n->buffers.size * sizeof(void *));
+  for (i = 0; i < n->inputs.size; i++)
+    {
+      int id = c->input_variable_ids[i];
+
+      bufaddr[-1 - fakert_var(n, id)->data_index] = c->variables[id].data;
+    }
+
+  hostnet_forward(n, bufaddr);
+
+  ts.tv_sec = g_fakert_forward_us / 1000000u;
+  ts.tv_nsec = (g_fakert_forward_us % 1000000u) * 1000u;
+  nanosleep(&ts, NULL);
+
+  return RT_RET_NOERROR;
+}
+
+int rt_num_of_input(rt_context_pointer context)
+{
+  return ((rt_context_t *) context)->network->inputs.size;
+}
+
+int rt_input_size(rt_context_pointer context, size_t index)
+{
+  rt_context_t *c = (rt_context_t *) context;
+  return fakert_elems(c->network, c->input_variable_ids[index]);
+}
+
+int rt_input_dimension(rt_context_pointer context, size_t index)
+{
+  return 1;
+}
+
+int rt_input_shape(rt_context_pointer context, size_t index,
+                   size_t shape_index)
+{
+  return rt_input_size(context, index);
+}
+
+void *rt_input_buffer(rt_context_pointer context, size_t index)
+{
+  rt_context_t *c = (rt_context_t *) context;
+  return c->variables[c->input_variable_ids[index]].data;
+}
+
+nn_variable_t *rt_input_variable(rt_context_pointer context, size_t index)
+{
+  rt_context_t *c = (rt_context_t *) context;
+  return fakert_var(c->network, c->input_variable_ids[index]);
+}
+
+int rt_num_of_output(rt_context_pointer context)
+{
+  return ((rt_context_t *) context)->network->outputs.size;
+}
+
+int rt_output_size(rt_context_pointer context, size_t index)
+{
+  rt_context_t *c = (rt_context_t *) context;
+  return fakert_elems(c->network, c->output_variable_ids[index]);
+}
+
+int rt_output_dimension(rt_context_pointer context, size_t index)
+{
+  return 1;
+}
+
+int rt_output_shape(rt_context_pointer context, size_t index,
+                    size_t shape_index)
+{
+  return rt_output_size(context, index);
+}
+
+void *rt_output_buffer(rt_context_pointer context, size_t index)
+{
+  rt_context_t *c = (rt_context_t *) context;
+  return c->variables[c->output_variable_ids[index]].data;
+}
+
+nn_variable_t *rt_output_variable(rt_context_pointer context, size_t index)
+{
+  rt_context_t *c = (rt_context_t *) context;
+  return fakert_var(c->network, c->output_variable_ids[index]);
+}
+
+/* the CMSIS-NN based functions are not built on the host */
+
+rt_return_value_t dnnrt_convolution_alloc(nn_network_t * net,
+                                          void *function_context)
+{
+  return RT_RET_FUNCTION_DONT_MATCH;
+}
+
+rt_return_value_t dnnrt_affine_alloc(nn_network_t * net,
+                                     void *function_context)
+{
+  return RT_RET_FUNCTION_DONT_MATCH;
+}
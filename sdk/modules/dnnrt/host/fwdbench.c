@@ -0,0 +1,218 @@
+/****************************************************************************
+ * modules/dnnrt/host/fwdbench.c
+ *
+ *   Copyright 2019 Sony Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host benchmark of dnn_runtime_forward_async().  runtime_nnabla.c runs on
+ * top of fakert.c with a LeNet-5 shaped network.  Each frame is prepared
+ * (modeled capture and pre-processing time) and then evaluated (modeled
+ * forward time), first one after another with dnn_runtime_forward(), then
+ * with the next frame prepared while the previous one is evaluated.  The
+ * outputs of both runs are compared, and dnn_runtime_initialize() must
+ * refuse to run while a forward is in flight.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "runtime_common.h"
+#include "hostnet.h"
+#include "fakert.h"
+
+#define FWD_INPUT_ELEMS  (28 * 28)
+#define FWD_OUTPUT_ELEMS (10)
+
+static unsigned int g_prepare_us = 20000;
+
+static uint64_t now_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000u;
+}
+
+/* capture and pre-process frame k into buf */
+
+static void prepare(float *buf, int k)
+{
+  struct timespec ts;
+  int i;
+
+  for (i = 0; i < FWD_INPUT_ELEMS; i++)
+    {
+      uint32_t h = (uint32_t)k * 2654435761u + (uint32_t)i * 40503u;
+      buf[i] = (float)((h >> 16) & 0xffu) / 255.0f - 0.5f;
+    }
+
+  ts.tv_sec = g_prepare_us / 1000000u;
+  ts.tv_nsec = (g_prepare_us % 1000000u) * 1000u;
+  nanosleep(&ts, NULL);
+}
+
+static void show_usage(const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-n <frames>] [-p <us>] [-f <us>]\n",
+                  progname);
+  fprintf(stderr, "\t-n: Number of frames. Default: 60\n");
+  fprintf(stderr, "\t-p: Modeled preparation time per frame. "
+                  "Default: 20000\n");
+  fprintf(stderr, "\t-f: Modeled forward time per frame. Default: 25000\n");
+  exit(errcode);
+}
+
+int main(int argc, char **argv)
+{
+  static float input[2][FWD_INPUT_ELEMS];
+  hostnet_builder_t b;
+  dnn_runtime_t rt;
+  dnn_runtime_t rt2;
+  nn_network_t *n;
+  float *expect;
+  float *out;
+  const void *inputs[1];
+  uint64_t t_sync;
+  uint64_t t_async;
+  unsigned int max_us;
+  int frames = 60;
+  int mismatch = 0;
+  int busy = 0;
+  int option;
+  int ret;
+  int k;
+
+  g_fakert_forward_us = 25000;
+  while ((option = getopt(argc, argv, "n:p:f:h")) != -1)
+    {
+      switch (option)
+        {
+          case 'n':
+            frames = atoi(optarg);
+            break;
+
+          case 'p':
+            g_prepare_us = (unsigned int)atoi(optarg);
+            break;
+
+          case 'f':
+            g_fakert_forward_us = (unsigned int)atoi(optarg);
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  hostnet_init(&b);
+  hostnet_lenet(&b);
+  n = hostnet_build(&b);
+
+  ret = dnn_initialize(NULL);
+  if (ret == 0)
+    {
+      ret = dnn_runtime_initialize(&rt, n);
+    }
+  if (ret != 0)
+    {
+      printf("ERROR: initialization failed: %d\n", ret);
+      return EXIT_FAILURE;
+    }
+
+  expect = malloc(frames * FWD_OUTPUT_ELEMS * sizeof(float));
+  out = (float *)dnn_runtime_output_buffer(&rt, 0);
+
+  /* one frame after another */
+
+  t_sync = now_us();
+  for (k = 0; k < frames; k++)
+    {
+      prepare(input[0], k);
+      inputs[0] = input[0];
+      dnn_runtime_forward(&rt, inputs, 1);
+      memcpy(&expect[k * FWD_OUTPUT_ELEMS], out,
+             FWD_OUTPUT_ELEMS * sizeof(float));
+    }
+  t_sync = now_us() - t_sync;
+
+  /* frame k + 1 is prepared while frame k is evaluated */
+
+  t_async = now_us();
+  prepare(input[0], 0);
+  for (k = 0; k < frames; k++)
+    {
+      inputs[0] = input[k & 1];
+      dnn_runtime_forward_async(&rt, inputs, 1);
+
+      if (k == 0)
+        {
+          busy = dnn_runtime_initialize(&rt2, n) == -EBUSY;
+        }
+
+      if (k + 1 < frames)
+        {
+          prepare(input[(k + 1) & 1], k + 1);
+        }
+
+      dnn_runtime_forward_wait(&rt);
+      mismatch += memcmp(&expect[k * FWD_OUTPUT_ELEMS], out,
+                         FWD_OUTPUT_ELEMS * sizeof(float)) != 0;
+    }
+  t_async = now_us() - t_async;
+
+  max_us = g_prepare_us > g_fakert_forward_us ?
+           g_prepare_us : g_fakert_forward_us;
+
+  printf("%d frames, %u us preparation, %u us forward\n", frames,
+         g_prepare_us, g_fakert_forward_us);
+  printf("forward:       %6.2f frames/s\n", frames * 1e6 / t_sync);
+  printf("forward_async: %6.2f frames/s, %.2fx (ideal %.2fx)\n",
+         frames * 1e6 / t_async, (double)t_sync / t_async,
+         (double)(g_prepare_us + g_fakert_forward_us) / max_us);
+  printf("outputs: %s, initialize during forward: %s\n",
+         mismatch ? "MISMATCH" : "identical", busy ? "-EBUSY" : "ACCEPTED");
+
+  dnn_runtime_finalize(&rt);
+  dnn_finalize();
+  free(expect);
+  free(n);
+
+  return mismatch == 0 && busy ? EXIT_SUCCESS : EXIT_FAILURE;
+}
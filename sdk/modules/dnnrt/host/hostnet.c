@@ -0,0 +1,387 @@
+/****************************************************************************
+ * modules/dnnrt/host/hostnet.c
+ *
+ *   Copyright 2019 Sony Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hostnet.h"
+
+#define HOSTNET_TAPS (4)
+
+void hostnet_init(hostnet_builder_t * b)
+{
+  memset(b, 0, sizeof(*b));
+}
+
+static int hostnet_add_var(hostnet_builder_t * b, int elems, int32_t index)
+{
+  assert(b->var_num < HOSTNET_MAX_VARS);
+  b->var_elems[b->var_num] = elems;
+  b->var_index[b->var_num] = index;
+  return b->var_num++;
+}
+
+int hostnet_tensor(hostnet_builder_t * b, int elems)
+{
+  assert(b->buffer_num < HOSTNET_MAX_VARS);
+  b->buffer_bsize[b->buffer_num] = elems * (int32_t) sizeof(float);
+  return hostnet_add_var(b, elems, -1 - b->buffer_num++);
+}
+
+int hostnet_alias(hostnet_builder_t * b, int var, int elems)
+{
+  int buf = -1 - b->var_index[var];
+  int32_t bsize = elems * (int32_t) sizeof(float);
+
+  assert(b->var_index[var] < 0);
+  if (bsize > b->buffer_bsize[buf])
+    {
+      b->buffer_bsize[buf] = bsize;
+    }
+  return hostnet_add_var(b, elems, b->var_index[var]);
+}
+
+int hostnet_param(hostnet_builder_t * b, int elems)
+{
+  return hostnet_add_var(b, elems, b->param_num++);
+}
+
+void hostnet_func(hostnet_builder_t * b, nn_function_type_t type,
+                  int in0, int in1, int in2, int out)
+{
+  int ins[3] = { in0, in1, in2 };
+  int i;
+
+  assert(b->func_num < HOSTNET_MAX_FUNCS);
+  b->func[b->func_num].type = (uint16_t) type;
+  for (i = 0; i < 3 && ins[i] >= 0; i++)
+    {
+      b->func[b->func_num].in[i] = ins[i];
+    }
+  b->func[b->func_num].in_num = i;
+  b->func[b->func_num].out[0] = out;
+  b->func[b->func_num].out_num = 1;
+  b->func_num++;
+}
+
+void hostnet_input(hostnet_builder_t * b, int var)
+{
+  assert(b->in_num < HOSTNET_MAX_IO);
+  b->in[b->in_num++] = var;
+}
+
+void hostnet_output(hostnet_builder_t * b, int var)
+{
+  assert(b->out_num < HOSTNET_MAX_IO);
+  b->out[b->out_num++] = var;
+}
+
+int hostnet_conv(hostnet_builder_t * b, int x, int in_ch, int out_ch,
+                 int ksize, int out_hw)
+{
+  int w = hostnet_param(b, out_ch * in_ch * ksize * ksize);
+  int bias = hostnet_param(b, out_ch);
+  int y = hostnet_tensor(b, out_ch * out_hw * out_hw);
+
+  hostnet_func(b, NN_FUNCTION_CONVOLUTION, x, w, bias, y);
+  return y;
+}
+
+int hostnet_affine(hostnet_builder_t * b, int x, int in_num, int out_num)
+{
+  int w = hostnet_param(b, in_num * out_num);
+  int bias = hostnet_param(b, out_num);
+  int y = hostnet_tensor(b, out_num);
+
+  hostnet_func(b, NN_FUNCTION_AFFINE, x, w, bias, y);
+  return y;
+}
+
+int hostnet_unary(hostnet_builder_t * b, nn_function_type_t type, int x,
+                  int elems)
+{
+  int y = hostnet_tensor(b, elems);
+
+  hostnet_func(b, type, x, -1, -1, y);
+  return y;
+}
+
+int hostnet_add2(hostnet_builder_t * b, int x0, int x1, int elems)
+{
+  int y = hostnet_tensor(b, elems);
+
+  hostnet_func(b, NN_FUNCTION_ADD2, x0, x1, -1, y);
+  return y;
+}
+
+/* LeNet-5 as in examples/dnnrt_lenet: 1x28x28 -> 10 */
+
+void hostnet_lenet(hostnet_builder_t * b)
+{
+  int x = hostnet_tensor(b, 1 * 28 * 28);
+  int h;
+
+  hostnet_input(b, x);
+  h = hostnet_conv(b, x, 1, 16, 5, 24);
+  h = hostnet_unary(b, NN_FUNCTION_MAX_POOLING, h, 16 * 12 * 12);
+  h = hostnet_unary(b, NN_FUNCTION_TANH, h, 16 * 12 * 12);
+  h = hostnet_conv(b, h, 16, 30, 5, 8);
+  h = hostnet_unary(b, NN_FUNCTION_MAX_POOLING, h, 30 * 4 * 4);
+  h = hostnet_unary(b, NN_FUNCTION_TANH, h, 30 * 4 * 4);
+  h = hostnet_affine(b, h, 480, 150);
+  h = hostnet_unary(b, NN_FUNCTION_TANH, h, 150);
+  h = hostnet_affine(b, h, 150, 10);
+  h = hostnet_unary(b, NN_FUNCTION_SOFTMAX, h, 10);
+  hostnet_output(b, h);
+}
+
+/* append len bytes to the network image and return their offset */
+
+static int32_t hostnet_put(uint8_t * image, size_t * used, size_t cap,
+                           const void *data, size_t len)
+{
+  int32_t off = (int32_t) * used;
+
+  assert(*used + len <= cap);
+  memcpy(image + *used, data, len);
+  *used += (len + 3u) & ~3u;
+  return off;
+}
+
+static void hostnet_put_list(uint8_t * image, size_t * used, size_t cap,
+                             nn_list_t * list, const int32_t * items, int num)
+{
+  list->size = num;
+  list->list = hostnet_put(image, used, cap, items, num * sizeof(int32_t));
+}
+
+nn_network_t *hostnet_build(const hostnet_builder_t * b)
+{
+  size_t cap = 16384u;
+  size_t used = sizeof(nn_network_t);
+  uint8_t *image = calloc(1, cap);
+  nn_network_t *n = (nn_network_t *) image;
+  int32_t offsets[HOSTNET_MAX_VARS];
+  int i;
+
+  assert(image != NULL);
+  n->version = NN_BINARY_FORMAT_VERSION;
+  n->api_level = 1;
+
+  hostnet_put_list(image, &used, cap, &n->buffers, b->buffer_bsize,
+                   b->buffer_num);
+
+  for (i = 0; i < b->var_num; i++)
+    {
+      nn_variable_t var;
+
+      memset(&var, 0, sizeof(var));
+      var.type = NN_DATA_TYPE_FLOAT;
+      var.data_index = b->var_index[i];
+      hostnet_put_list(image, &used, cap, &var.shape, &b->var_elems[i], 1);
+      offsets[i] = hostnet_put(image, &used, cap, &var, sizeof(var));
+    }
+  hostnet_put_list(image, &used, cap, &n->variables, offsets, b->var_num);
+
+  for (i = 0; i < b->func_num; i++)
+    {
+      nn_function_t func;
+      int32_t io[HOSTNET_MAX_IO];
+      int j;
+
+      memset(&func, 0, sizeof(func));
+      func.type = b->func[i].type;
+      for (j = 0; j < b->func[i].in_num; j++)
+        {
+          io[j] = b->func[i].in[j];
+        }
+      hostnet_put_list(image, &used, cap, &func.inputs, io,
+                       b->func[i].in_num);
+      for (j = 0; j < b->func[i].out_num; j++)
+        {
+          io[j] = b->func[i].out[j];
+        }
+      hostnet_put_list(image, &used, cap, &func.outputs, io,
+                       b->func[i].out_num);
+      offsets[i] = hostnet_put(image, &used, cap, &func, sizeof(func));
+    }
+  hostnet_put_list(image, &used, cap, &n->functions, offsets, b->func_num);
+
+  hostnet_put_list(image, &used, cap, &n->inputs, b->in, b->in_num);
+  hostnet_put_list(image, &used, cap, &n->outputs, b->out, b->out_num);
+
+  return n;
+}
+
+static nn_variable_t *hostnet_var(const nn_network_t * n, int idx)
+{
+  int32_t *list = (int32_t *) NN_GET(n, n->variables.list);
+  return (nn_variable_t *) NN_GET(n, list[idx]);
+}
+
+static int hostnet_elems(const nn_network_t * n, const nn_variable_t * var)
+{
+  return *(int32_t *) NN_GET(n, var->shape.list);
+}
+
+static float *hostnet_data(const nn_variable_t * var, void *const *bufaddr)
+{
+  return var->data_index < 0 ? (float *)bufaddr[-1 - var->data_index] : NULL;
+}
+
+static float hostnet_read(const nn_variable_t * var, const float *data,
+                          int j)
+{
+  if (data == NULL)
+    {
+      return (float)((var->data_index * 131 + j * 7) % 17 - 8) * 0.0625f;
+    }
+  return data[j];
+}
+
+static void hostnet_exec(const nn_network_t * n, const nn_function_t * func,
+                         void *const *bufaddr)
+{
+  int32_t *ins = (int32_t *) NN_GET(n, func->inputs.list);
+  int32_t *outs = (int32_t *) NN_GET(n, func->outputs.list);
+  nn_variable_t *yv = hostnet_var(n, outs[0]);
+  float *y = hostnet_data(yv, bufaddr);
+  int ny = hostnet_elems(n, yv);
+  int i, k, t;
+
+  if (func->type == NN_FUNCTION_RELU || func->type == NN_FUNCTION_SIGMOID ||
+      func->type == NN_FUNCTION_TANH)
+    {
+      nn_variable_t *xv = hostnet_var(n, ins[0]);
+      float *x = hostnet_data(xv, bufaddr);
+
+      for (i = 0; i < ny; i++)
+        {
+          float v = hostnet_read(xv, x, i);
+
+          if (func->type == NN_FUNCTION_RELU)
+            {
+              y[i] = v > 0.0f ? v : 0.0f;
+            }
+          else if (func->type == NN_FUNCTION_SIGMOID)
+            {
+              y[i] = 1.0f / (1.0f + expf(-v));
+            }
+          else
+            {
+              y[i] = tanhf(v);
+            }
+        }
+      return;
+    }
+
+  for (i = 0; i < ny; i++)
+    {
+      float acc = 0.0f;
+
+      for (k = 0; k < func->inputs.size; k++)
+        {
+          nn_variable_t *xv = hostnet_var(n, ins[k]);
+          float *x = hostnet_data(xv, bufaddr);
+          int nx = hostnet_elems(n, xv);
+
+          for (t = 0; t < HOSTNET_TAPS; t++)
+            {
+              int j = (int)(((uint32_t) i * 31u + t * 97u + k * 13u) % nx);
+              acc += hostnet_read(xv, x, j) * (float)(t + 1) * 0.25f;
+            }
+        }
+
+      y[i] = acc / (1.0f + fabsf(acc));
+    }
+}
+
+void hostnet_forward_range(const nn_network_t * n, void *const *bufaddr,
+                           int first, int last)
+{
+  int32_t *list = (int32_t *) NN_GET(n, n->functions.list);
+  int f;
+
+  for (f = first; f < last; f++)
+    {
+      hostnet_exec(n, (nn_function_t *) NN_GET(n, list[f]), bufaddr);
+    }
+}
+
+void hostnet_forward(const nn_network_t * n, void *const *bufaddr)
+{
+  hostnet_forward_range(n, bufaddr, 0, n->functions.size);
+}
+
+void hostnet_fill_inputs(const nn_network_t * n, void *const *bufaddr,
+                         uint32_t seed)
+{
+  int32_t *list = (int32_t *) NN_GET(n, n->inputs.list);
+  int i, j;
+
+  for (i = 0; i < n->inputs.size; i++)
+    {
+      nn_variable_t *var = hostnet_var(n, list[i]);
+      float *x = hostnet_data(var, bufaddr);
+      int nx = hostnet_elems(n, var);
+
+      for (j = 0; j < nx; j++)
+        {
+          uint32_t h = (seed + (uint32_t) i) * 2654435761u + j * 40503u;
+          x[j] = (float)((h >> 16) & 0xffu) / 255.0f - 0.5f;
+        }
+    }
+}
+
+int hostnet_compare_outputs(const nn_network_t * n, void *const *a,
+                            void *const *b)
+{
+  int32_t *list = (int32_t *) NN_GET(n, n->outputs.list);
+  int i;
+
+  for (i = 0; i < n->outputs.size; i++)
+    {
+      nn_variable_t *var = hostnet_var(n, list[i]);
+      size_t bsize = hostnet_elems(n, var) * sizeof(float);
+
+      if (memcmp(hostnet_data(var, a), hostnet_data(var, b), bsize) != 0)
+        {
+          return -1;
+        }
+    }
+
+  return 0;
+}
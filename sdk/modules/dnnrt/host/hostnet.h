@@ -0,0 +1,131 @@
+/****************************************************************************
+ * modules/dnnrt/host/hostnet.h
+ *
+ *   Copyright 2019 Sony Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __MODULES_DNNRT_HOST_HOSTNET_H
+#define __MODULES_DNNRT_HOST_HOSTNET_H
+
+/* Synthetic networks for the host harnesses.  A network is described with
+ * the builder below and serialized into the nnb layout of network.h.
+ * hostnet_forward() evaluates it with a deterministic stand-in for each
+ * function: element-wise functions map x[i] to y[i], every other function
+ * writes y[i] while it still reads values spread over all of its inputs, so
+ * a buffer placed over a live one changes the outputs.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <nnablart/network.h>
+
+#define HOSTNET_MAX_VARS   (48)
+#define HOSTNET_MAX_FUNCS  (32)
+#define HOSTNET_MAX_IO     (4)
+
+typedef struct hostnet_builder
+{
+  int buffer_num;
+  int var_num;
+  int func_num;
+  int param_num;
+  int32_t buffer_bsize[HOSTNET_MAX_VARS];
+  int32_t var_elems[HOSTNET_MAX_VARS];
+  int32_t var_index[HOSTNET_MAX_VARS];  /* nn_variable_t::data_index */
+  struct
+  {
+    uint16_t type;
+    int in_num;
+    int out_num;
+    int in[HOSTNET_MAX_IO];
+    int out[HOSTNET_MAX_IO];
+  } func[HOSTNET_MAX_FUNCS];
+  int in_num;
+  int out_num;
+  int in[HOSTNET_MAX_IO];
+  int out[HOSTNET_MAX_IO];
+} hostnet_builder_t;
+
+void hostnet_init(hostnet_builder_t * b);
+
+/* a float variable with a buffer of its own */
+
+int hostnet_tensor(hostnet_builder_t * b, int elems);
+
+/* a float variable stored in the buffer of an existing variable, as the
+ * nnb converter does when it shares buffers between layers */
+
+int hostnet_alias(hostnet_builder_t * b, int var, int elems);
+
+/* a parameter (weight, bias) */
+
+int hostnet_param(hostnet_builder_t * b, int elems);
+
+void hostnet_func(hostnet_builder_t * b, nn_function_type_t type,
+                  int in0, int in1, int in2, int out);
+void hostnet_input(hostnet_builder_t * b, int var);
+void hostnet_output(hostnet_builder_t * b, int var);
+
+/* functions which create their output variable, and return it */
+
+int hostnet_conv(hostnet_builder_t * b, int x, int in_ch, int out_ch,
+                 int ksize, int out_hw);
+int hostnet_affine(hostnet_builder_t * b, int x, int in_num, int out_num);
+int hostnet_unary(hostnet_builder_t * b, nn_function_type_t type, int x,
+                  int elems);
+int hostnet_add2(hostnet_builder_t * b, int x0, int x1, int elems);
+
+/* LeNet-5 as in examples/dnnrt_lenet: 1x28x28 -> 10 */
+
+void hostnet_lenet(hostnet_builder_t * b);
+
+/* serialize the network, release it with free() */
+
+nn_network_t *hostnet_build(const hostnet_builder_t * b);
+
+/* evaluate the functions [first, last) with the variable buffers at
+ * bufaddr[0 .. buffers.size - 1] */
+
+void hostnet_forward_range(const nn_network_t * n, void *const *bufaddr,
+                           int first, int last);
+void hostnet_forward(const nn_network_t * n, void *const *bufaddr);
+
+/* fill the network inputs with data derived from seed */
+
+void hostnet_fill_inputs(const nn_network_t * n, void *const *bufaddr,
+                         uint32_t seed);
+
+/* 0 if all the network outputs are bitwise identical */
+
+int hostnet_compare_outputs(const nn_network_t * n, void *const *a,
+                            void *const *b);
+
+#endif /* __MODULES_DNNRT_HOST_HOSTNET_H */
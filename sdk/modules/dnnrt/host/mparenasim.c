@@ -0,0 +1,488 @@
+/****************************************************************************
+ * modules/dnnrt/host/mparenasim.c
+ *
+ *   Copyright 2019 Sony Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Threaded host simulation of the worker memory requests of dnnrt-mp.
+ * Each thread stands in for an ASMP worker CPU and runs LeNet-5 shaped
+ * forwards which allocate an output and a workspace per layer.  The main
+ * thread stands in for the main CPU.  Three ways of serving the requests
+ * are compared:
+ *
+ *   heap:   MP_MSG_MALLOC/FREE/REALLOC round-trips, served from the heap
+ *   served: the same round-trips, served from the worker's arena
+ *   local:  the worker allocates from its own arena by mp_arena_alloc(),
+ *           and only falls back to a round-trip when the arena is full
+ *
+ * The compute time of a layer is modeled by sleeping, so that the workers
+ * overlap even on a host with fewer CPUs.  -l adds a modeled mailbox
+ * latency to every message.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mp_arena.h"
+
+/* message IDs as in runtime_client.h */
+
+#define MP_MSG_MALLOC   (0x03)
+#define MP_MSG_FREE     (0x04)
+#define MP_MSG_REALLOC  (0x05)
+
+#define SIM_MAX_WORKERS (4)
+#define SIM_QUEUE_LEN   (8)
+
+enum sim_mode
+{
+  SIM_HEAP,
+  SIM_SERVED,
+  SIM_LOCAL
+};
+
+static const char *const g_modename[] =
+{
+  "heap", "served", "local"
+};
+
+/* LeNet-5 layers: output, workspace and modeled compute time */
+
+static const struct
+{
+  uint32_t out_bsize;
+  uint32_t ws_bsize;
+  uint32_t compute_us;
+} g_layers[] =
+{
+  { 16 * 24 * 24 * 4, 25 * 4,       900 },  /* convolution */
+  { 16 * 12 * 12 * 4, 0,            120 },  /* max pooling */
+  { 16 * 12 * 12 * 4, 0,             60 },  /* tanh */
+  { 30 * 8 * 8 * 4,   16 * 25 * 4, 1500 },  /* convolution */
+  { 30 * 4 * 4 * 4,   0,             30 },  /* max pooling */
+  { 30 * 4 * 4 * 4,   0,             15 },  /* tanh */
+  { 150 * 4,          480 * 4,      360 },  /* affine */
+  { 150 * 4,          0,              5 },  /* tanh */
+  { 10 * 4,           150 * 4,       10 },  /* affine */
+};
+
+#define SIM_LAYERS (sizeof(g_layers) / sizeof(g_layers[0]))
+
+struct sim_request
+{
+  int msg;
+  size_t bsize;
+  void *addr;
+  bool done;
+};
+
+struct sim_worker
+{
+  pthread_t thread;
+  int index;
+  mp_arena_t *arena;
+  struct sim_request req;
+  pthread_cond_t ack;
+  uint32_t round_trips;
+};
+
+struct sim_main
+{
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  struct sim_worker *queue[SIM_QUEUE_LEN];
+  int head;
+  int count;
+  int running;
+};
+
+static struct sim_main g_main =
+{
+  PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER
+};
+
+static struct sim_worker g_workers[SIM_MAX_WORKERS];
+static enum sim_mode g_mode;
+static uint32_t g_latency_us;
+static uint32_t g_arena_bsize = 64 * 1024;
+static pthread_barrier_t g_start;
+static volatile bool g_quit;
+
+static uint64_t now_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000u;
+}
+
+static void spin_us(uint32_t us)
+{
+  uint64_t end = now_us() + us;
+
+  while (now_us() < end);
+}
+
+static void sleep_until(uint64_t us)
+{
+  struct timespec ts;
+
+  ts.tv_sec = us / 1000000u;
+  ts.tv_nsec = (us % 1000000u) * 1000u;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+}
+
+/* worker side of a round-trip: post the request and wait for the ACK */
+
+static void *sim_request(struct sim_worker *w, int msg, void *addr,
+                         size_t bsize)
+{
+  pthread_mutex_lock(&g_main.lock);
+  w->req.msg = msg;
+  w->req.addr = addr;
+  w->req.bsize = bsize;
+  w->req.done = false;
+  g_main.queue[(g_main.head + g_main.count++) % SIM_QUEUE_LEN] = w;
+  pthread_cond_signal(&g_main.cond);
+  while (!w->req.done)
+    {
+      pthread_cond_wait(&w->ack, &g_main.lock);
+    }
+  pthread_mutex_unlock(&g_main.lock);
+
+  w->round_trips++;
+  return w->req.addr;
+}
+
+/* main side, the counterpart of dnn_mpmgr_process_msg() */
+
+static void sim_serve(struct sim_worker *w)
+{
+  struct sim_request *req = &w->req;
+  bool arena = g_mode != SIM_HEAP;
+  void *p;
+
+  spin_us(g_latency_us);
+  switch (req->msg)
+    {
+      case MP_MSG_MALLOC:
+        p = arena ? mp_arena_alloc(w->arena, req->bsize) : NULL;
+        req->addr = p ? p : malloc(req->bsize);
+        break;
+
+      case MP_MSG_FREE:
+        if (arena && mp_arena_contains(w->arena, req->addr))
+          {
+            mp_arena_free(w->arena, req->addr);
+          }
+        else
+          {
+            free(req->addr);
+          }
+        break;
+
+      case MP_MSG_REALLOC:
+        if (arena && mp_arena_contains(w->arena, req->addr))
+          {
+            p = mp_arena_realloc(w->arena, req->addr, req->bsize);
+            if (p == NULL)
+              {
+                p = malloc(req->bsize);
+                memcpy(p, req->addr, mp_arena_usable_size(req->addr));
+                mp_arena_free(w->arena, req->addr);
+              }
+            req->addr = p;
+          }
+        else
+          {
+            req->addr = realloc(req->addr, req->bsize);
+          }
+        break;
+    }
+}
+
+static void *sim_malloc(struct sim_worker *w, size_t bsize)
+{
+  void *p;
+
+  if (g_mode == SIM_LOCAL)
+    {
+      p = mp_arena_alloc(w->arena, bsize);
+      if (p != NULL)
+        {
+          return p;
+        }
+    }
+  return sim_request(w, MP_MSG_MALLOC, NULL, bsize);
+}
+
+static void sim_free(struct sim_worker *w, void *p)
+{
+  if (g_mode == SIM_LOCAL && mp_arena_contains(w->arena, p))
+    {
+      mp_arena_free(w->arena, p);
+      return;
+    }
+  sim_request(w, MP_MSG_FREE, p, 0);
+}
+
+/* one forward: allocate each layer's output and workspace, compute, and
+ * release what the next layer does not read */
+
+static void sim_forward(struct sim_worker *w)
+{
+  uint64_t deadline;
+  void *in = NULL;
+  unsigned int i;
+
+  for (i = 0; i < SIM_LAYERS; i++)
+    {
+      void *out = sim_malloc(w, g_layers[i].out_bsize);
+      void *ws = NULL;
+
+      if (g_layers[i].ws_bsize > 0)
+        {
+          ws = sim_malloc(w, g_layers[i].ws_bsize);
+          memset(ws, 0, g_layers[i].ws_bsize);
+        }
+
+      /* the layer takes compute_us once its memory is available */
+
+      memset(out, (int)i, g_layers[i].out_bsize);
+      deadline = now_us() + g_layers[i].compute_us;
+      sleep_until(deadline);
+
+      if (ws != NULL)
+        {
+          sim_free(w, ws);
+        }
+      if (in != NULL)
+        {
+          sim_free(w, in);
+        }
+      in = out;
+    }
+
+  sim_free(w, in);
+}
+
+static void *sim_worker_main(void *arg)
+{
+  struct sim_worker *w = (struct sim_worker *)arg;
+
+  for (;;)
+    {
+      pthread_barrier_wait(&g_start);
+      if (g_quit)
+        {
+          break;
+        }
+      sim_forward(w);
+
+      pthread_mutex_lock(&g_main.lock);
+      g_main.running--;
+      pthread_cond_signal(&g_main.cond);
+      pthread_mutex_unlock(&g_main.lock);
+    }
+
+  return NULL;
+}
+
+/* run forwards on all workers and serve their requests until they finish */
+
+static uint64_t sim_round(int workers)
+{
+  uint64_t start = now_us();
+
+  pthread_mutex_lock(&g_main.lock);
+  g_main.running = workers;
+  pthread_mutex_unlock(&g_main.lock);
+  pthread_barrier_wait(&g_start);
+
+  pthread_mutex_lock(&g_main.lock);
+  while (g_main.running > 0 || g_main.count > 0)
+    {
+      if (g_main.count == 0)
+        {
+          pthread_cond_wait(&g_main.cond, &g_main.lock);
+          continue;
+        }
+
+      struct sim_worker *w = g_main.queue[g_main.head];
+      g_main.head = (g_main.head + 1) % SIM_QUEUE_LEN;
+      g_main.count--;
+
+      pthread_mutex_unlock(&g_main.lock);
+      sim_serve(w);
+      pthread_mutex_lock(&g_main.lock);
+
+      w->req.done = true;
+      pthread_cond_signal(&w->ack);
+    }
+  pthread_mutex_unlock(&g_main.lock);
+
+  return now_us() - start;
+}
+
+static void show_usage(const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-n <forwards>] [-l <us>] [-a <bytes>]\n",
+                  progname);
+  fprintf(stderr, "\t-n: Forwards per configuration. Default: 50\n");
+  fprintf(stderr, "\t-l: Modeled mailbox latency per message in us. "
+                  "Default: 0\n");
+  fprintf(stderr, "\t-a: Arena size per worker. Default: 65536\n");
+  exit(errcode);
+}
+
+int main(int argc, char **argv)
+{
+  void *arenas[SIM_MAX_WORKERS];
+  int forwards = 50;
+  int option;
+  int workers;
+  int mode;
+  int i;
+  int n;
+
+  while ((option = getopt(argc, argv, "n:l:a:h")) != -1)
+    {
+      switch (option)
+        {
+          case 'n':
+            forwards = atoi(optarg);
+            break;
+
+          case 'l':
+            g_latency_us = (uint32_t)atoi(optarg);
+            break;
+
+          case 'a':
+            g_arena_bsize = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  for (i = 0, n = 0; i < (int)SIM_LAYERS; i++)
+    {
+      n += g_layers[i].compute_us;
+    }
+
+  printf("LeNet-5 forwards, %d us compute, %u us mailbox latency, "
+         "%u byte arenas, %ld host CPUs\n", n, g_latency_us, g_arena_bsize,
+         sysconf(_SC_NPROCESSORS_ONLN));
+  printf("%-7s %7s %12s %12s %12s\n", "mode", "workers", "forward us",
+         "round-trips", "arena peak");
+
+  for (i = 0; i < SIM_MAX_WORKERS; i++)
+    {
+      arenas[i] = malloc(g_arena_bsize);
+      pthread_cond_init(&g_workers[i].ack, NULL);
+    }
+
+  for (mode = SIM_HEAP; mode <= SIM_LOCAL; mode++)
+    {
+      g_mode = (enum sim_mode)mode;
+      for (workers = 1; workers <= SIM_MAX_WORKERS; workers++)
+        {
+          uint64_t total = 0;
+          uint32_t trips = 0;
+          uint32_t peak = 0;
+
+          pthread_barrier_init(&g_start, NULL, workers + 1);
+          g_quit = false;
+          for (i = 0; i < workers; i++)
+            {
+              g_workers[i].index = i;
+              g_workers[i].round_trips = 0;
+              g_workers[i].arena = mp_arena_init(arenas[i], g_arena_bsize);
+              pthread_create(&g_workers[i].thread, NULL, sim_worker_main,
+                             &g_workers[i]);
+            }
+
+          sim_round(workers);           /* warm up */
+          for (i = 0; i < workers; i++)
+            {
+              g_workers[i].round_trips = 0;
+            }
+
+          for (n = 0; n < forwards; n++)
+            {
+              total += sim_round(workers);
+            }
+
+          g_quit = true;
+          pthread_barrier_wait(&g_start);
+          for (i = 0; i < workers; i++)
+            {
+              pthread_join(g_workers[i].thread, NULL);
+              trips += g_workers[i].round_trips;
+              if (g_workers[i].arena->used_bsize != 0)
+                {
+                  printf("ERROR: worker %d leaks %u bytes\n", i,
+                         g_workers[i].arena->used_bsize);
+                  return EXIT_FAILURE;
+                }
+              if (g_workers[i].arena->peak_bsize > peak)
+                {
+                  peak = g_workers[i].arena->peak_bsize;
+                }
+            }
+          pthread_barrier_destroy(&g_start);
+
+          printf("%-7s %7d %12.1f %12.1f %12u\n", g_modename[mode], workers,
+                 (double)total / forwards,
+                 (double)trips / forwards / workers, peak);
+        }
+    }
+
+  for (i = 0; i < SIM_MAX_WORKERS; i++)
+    {
+      free(arenas[i]);
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,286 @@
+/****************************************************************************
+ * modules/dnnrt/host/planbench.c
+ *
+ *   Copyright 2019 Sony Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host check of the variable buffer placement.  Synthetic networks shaped
+ * like LeNet-5 and some larger graphs are placed with dnn_peek_vbuffers()
+ * and dnn_preallocate_chunks(), evaluated in the placed buffers and in
+ * separately allocated ones, and the memory and outputs are compared.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "runtime_common.h"
+#include "hostnet.h"
+
+static dnn_global_context_t g_ctx;
+
+dnn_global_context_t *dnn_get_global_context(void)
+{
+  return &g_ctx;
+}
+
+/* LeNet-5 with two buffers shared alternately between the layers, as the
+ * nnb converter emits it */
+
+static void build_lenet_shared(hostnet_builder_t * b)
+{
+  static const int elems[] =
+  {
+    16 * 24 * 24, 16 * 12 * 12, 16 * 12 * 12, 30 * 8 * 8, 30 * 4 * 4,
+    30 * 4 * 4, 150, 150, 10
+  };
+  static const nn_function_type_t types[] =
+  {
+    NN_FUNCTION_CONVOLUTION, NN_FUNCTION_MAX_POOLING, NN_FUNCTION_TANH,
+    NN_FUNCTION_CONVOLUTION, NN_FUNCTION_MAX_POOLING, NN_FUNCTION_TANH,
+    NN_FUNCTION_AFFINE, NN_FUNCTION_TANH, NN_FUNCTION_AFFINE
+  };
+  int x = hostnet_tensor(b, 1 * 28 * 28);
+  int ping = hostnet_tensor(b, elems[0]);
+  int pong = hostnet_tensor(b, elems[1]);
+  int h = x;
+  int y;
+  int i;
+
+  hostnet_input(b, x);
+  for (i = 0; i < 9; i++)
+    {
+      int w = -1;
+      int bias = -1;
+
+      y = (i == 0) ? ping : (i == 1) ? pong :
+          hostnet_alias(b, (i & 1) ? pong : ping, elems[i]);
+      if (types[i] == NN_FUNCTION_CONVOLUTION ||
+          types[i] == NN_FUNCTION_AFFINE)
+        {
+          w = hostnet_param(b, elems[i]);
+          bias = hostnet_param(b, 16);
+        }
+      hostnet_func(b, types[i], h, w, bias, y);
+      h = y;
+    }
+
+  y = hostnet_tensor(b, 10);
+  hostnet_func(b, NN_FUNCTION_SOFTMAX, h, -1, -1, y);
+  hostnet_output(b, y);
+}
+
+/* VGG-like: three conv/relu/pool stages on 3x32x32 and two affines */
+
+static void build_vgg(hostnet_builder_t * b)
+{
+  int x = hostnet_tensor(b, 3 * 32 * 32);
+  int h = x;
+  int ch = 3;
+  int hw = 32;
+  int s;
+
+  hostnet_input(b, x);
+  for (s = 0; s < 3; s++)
+    {
+      h = hostnet_conv(b, h, ch, ch < 16 ? 16 : ch * 2, 3, hw);
+      ch = ch < 16 ? 16 : ch * 2;
+      h = hostnet_unary(b, NN_FUNCTION_RELU, h, ch * hw * hw);
+      hw /= 2;
+      h = hostnet_unary(b, NN_FUNCTION_MAX_POOLING, h, ch * hw * hw);
+    }
+
+  h = hostnet_affine(b, h, ch * hw * hw, 64);
+  h = hostnet_unary(b, NN_FUNCTION_RELU, h, 64);
+  h = hostnet_affine(b, h, 64, 10);
+  hostnet_output(b, h);
+}
+
+/* ResNet-like: a stem and two residual blocks, the block input stays live
+ * across the block until Add2 */
+
+static void build_resnet(hostnet_builder_t * b)
+{
+  const int elems = 16 * 16 * 16;
+  int x = hostnet_tensor(b, 3 * 16 * 16);
+  int h;
+  int r;
+  int i;
+
+  hostnet_input(b, x);
+  h = hostnet_conv(b, x, 3, 16, 3, 16);
+  h = hostnet_unary(b, NN_FUNCTION_RELU, h, elems);
+  for (i = 0; i < 2; i++)
+    {
+      r = hostnet_conv(b, h, 16, 16, 3, 16);
+      r = hostnet_unary(b, NN_FUNCTION_RELU, r, elems);
+      r = hostnet_conv(b, r, 16, 16, 3, 16);
+      r = hostnet_add2(b, h, r, elems);
+      h = hostnet_unary(b, NN_FUNCTION_RELU, r, elems);
+    }
+
+  h = hostnet_affine(b, h, elems, 10);
+  hostnet_output(b, h);
+}
+
+/* two inputs merged in the middle and two outputs */
+
+static void build_twoheads(hostnet_builder_t * b)
+{
+  int x0 = hostnet_tensor(b, 2048);
+  int x1 = hostnet_tensor(b, 512);
+  int a;
+  int c;
+  int h;
+
+  hostnet_input(b, x0);
+  hostnet_input(b, x1);
+  a = hostnet_affine(b, x0, 2048, 1024);
+  a = hostnet_unary(b, NN_FUNCTION_SIGMOID, a, 1024);
+  c = hostnet_affine(b, x1, 512, 1024);
+  h = hostnet_add2(b, a, c, 1024);
+  a = hostnet_affine(b, h, 1024, 256);
+  c = hostnet_affine(b, h, 1024, 32);
+  c = hostnet_unary(b, NN_FUNCTION_SOFTMAX, c, 32);
+  hostnet_output(b, a);
+  hostnet_output(b, c);
+}
+
+static size_t chunk_bsize(dnn_global_context_t * ctx)
+{
+  dnn_shared_chunk_t *chunk;
+  size_t bsize = 0u;
+
+  for (chunk = ctx->chunks; chunk != NULL; chunk = chunk->next)
+    {
+      bsize += chunk->allocated_bsize;
+    }
+  return bsize;
+}
+
+static int run(const char *name, void (*build)(hostnet_builder_t * b))
+{
+  hostnet_builder_t b;
+  dnn_vbuffer_alloc_info_t info;
+  nn_network_t *n;
+  void *ref[MAX_VBUFFER_NUM];
+  size_t unplanned = 0u;
+  char lower[16] = "-";
+  size_t bsize;
+  int same = 1;
+  int ret;
+  int i;
+
+  hostnet_init(&b);
+  build(&b);
+  n = hostnet_build(&b);
+
+  ret = dnn_peek_vbuffers(n, &info);
+  if (ret == 0)
+    {
+      memset(&g_ctx, 0, sizeof(g_ctx));
+      g_ctx.alloc_info = &info;
+      ret = dnn_preallocate_chunks(&g_ctx, &info);
+    }
+
+  if (ret != 0)
+    {
+      printf("%-14s placement failed: %d\n", name, ret);
+      free(n);
+      return -1;
+    }
+
+  /* reference: every buffer in a region of its own */
+
+  for (i = 0; i < (int)info.vbuffer_num; i++)
+    {
+      unplanned += (info.bsize_list[i] + 3u) & ~3u;
+      ref[i] = malloc(info.bsize_list[i]);
+    }
+
+  bsize = chunk_bsize(&g_ctx);
+  memset(g_ctx.chunks->data, 0xa5, bsize);
+#ifdef CONFIG_DNN_RT_MEMORY_PLANNER
+  snprintf(lower, sizeof(lower), "%u", (unsigned int)info.lower_bsize);
+#endif
+
+  /* a few inputs, so that stale data left by a previous run is noticed */
+
+  for (i = 0; i < 3; i++)
+    {
+      hostnet_fill_inputs(n, ref, (uint32_t) i);
+      hostnet_fill_inputs(n, info.addr_list, (uint32_t) i);
+      hostnet_forward(n, ref);
+      hostnet_forward(n, info.addr_list);
+      same &= hostnet_compare_outputs(n, ref, info.addr_list) == 0;
+    }
+
+  printf("%-14s %7d %6d %10u %10u %10s %8.1f%%  %s\n", name,
+         (int)info.vbuffer_num, n->functions.size, (unsigned int)unplanned,
+         (unsigned int)bsize, lower,
+         100.0 * (double)bsize / (double)unplanned,
+         same ? "identical" : "MISMATCH");
+
+  for (i = 0; i < (int)info.vbuffer_num; i++)
+    {
+      free(ref[i]);
+    }
+
+  /* no variable was handed out, so no chunk is referenced */
+
+  dnn_destroy_unused_chunks(&g_ctx);
+  free(n);
+
+  return same ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+  int ret = 0;
+
+#if defined(CONFIG_DNN_RT_MEMORY_PLANNER_INPLACE)
+  printf("liveness planner, in-place element-wise functions\n");
+#elif defined(CONFIG_DNN_RT_MEMORY_PLANNER)
+  printf("liveness planner\n");
+#else
+  printf("first-fit chunks (no planner)\n");
+#endif
+  printf("%-14s %7s %6s %10s %10s %10s %9s  %s\n", "network", "buffers",
+         "funcs", "unplanned", "allocated", "peak", "ratio", "outputs");
+
+  ret |= run("lenet-5", hostnet_lenet);
+  ret |= run("lenet-5/nnb", build_lenet_shared);
+  ret |= run("vgg-3", build_vgg);
+  ret |= run("resnet-2", build_resnet);
+  ret |= run("two-heads", build_twoheads);
+
+  return ret == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
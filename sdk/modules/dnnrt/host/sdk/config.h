@@ -0,0 +1,70 @@
+/****************************************************************************
+ * modules/dnnrt/host/sdk/config.h
+ *
+ *   Copyright 2019 Sony Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __MODULES_DNNRT_HOST_SDK_CONFIG_H
+#define __MODULES_DNNRT_HOST_SDK_CONFIG_H
+
+/* Minimal configuration for building the dnnrt runtime on the host.
+ * The CONFIG_DNN_RT_* options are given on the command line.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define OK    0
+#define ERROR -1
+#define FAR
+
+/* NuttX declares mallinfo() in stdlib.h, with the largest free block */
+
+struct mallinfo
+{
+  int arena;
+  int ordblks;
+  int mxordblk;
+  int uordblks;
+  int fordblks;
+};
+
+static inline struct mallinfo mallinfo(void)
+{
+  struct mallinfo info =
+  {
+    0
+  };
+
+  return info;
+}
+
+#endif /* __MODULES_DNNRT_HOST_SDK_CONFIG_H */
@@ -0,0 +1,227 @@
+/****************************************************************************
+ * modules/dnnrt/src-mp/runtime/mp_arena.c
+ *
+ *   Copyright 2019 Sony Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <string.h>
+#include "mp_arena.h"
+
+#define MP_ARENA_ALIGN      (8u)
+#define MP_ARENA_USED       (0xffffffffu)
+#define MP_ARENA_MIN_SPLIT  (16u)
+
+/* header of each block in the arena */
+typedef struct mp_arena_block
+{
+  uint32_t bsize;               /* size of this block including header */
+  uint32_t next;                /* offset of next free block, or
+                                 * MP_ARENA_USED if allocated */
+} mp_arena_block_t;
+
+#define HDR_BSIZE \
+  ((sizeof(mp_arena_t) + MP_ARENA_ALIGN - 1) & ~(MP_ARENA_ALIGN - 1))
+
+static inline mp_arena_block_t *mp_arena_at(mp_arena_t * arena,
+                                            uint32_t offset)
+{
+  return (mp_arena_block_t *) ((uint8_t *) arena + offset);
+}
+
+static inline uint32_t mp_arena_offset(mp_arena_t * arena, void *p)
+{
+  return (uint32_t) ((uint8_t *) p - (uint8_t *) arena);
+}
+
+mp_arena_t *mp_arena_init(void *base, size_t bsize)
+{
+  mp_arena_t *arena = (mp_arena_t *) base;
+  mp_arena_block_t *first;
+
+  if (base == NULL || bsize < HDR_BSIZE + sizeof(mp_arena_block_t))
+    {
+      return NULL;
+    }
+
+  bsize &= ~(MP_ARENA_ALIGN - 1);
+  memset(arena, 0, sizeof(*arena));
+  arena->bsize = (uint32_t) bsize;
+  arena->free_head = HDR_BSIZE;
+
+  first = mp_arena_at(arena, HDR_BSIZE);
+  first->bsize = (uint32_t) (bsize - HDR_BSIZE);
+  first->next = 0u;
+
+  arena->magic = MP_ARENA_MAGIC;
+  return arena;
+}
+
+int mp_arena_contains(const mp_arena_t * arena, const void *p)
+{
+  const uint8_t *begin = (const uint8_t *)arena;
+
+  return arena != NULL && begin < (const uint8_t *)p &&
+    (const uint8_t *)p < begin + arena->bsize;
+}
+
+/* first-fit allocation from the address-ordered free list */
+void *mp_arena_alloc(mp_arena_t * arena, size_t bsize)
+{
+  uint32_t need, prev = 0u, cur;
+  mp_arena_block_t *blk;
+
+  if (arena == NULL || arena->magic != MP_ARENA_MAGIC || bsize == 0u)
+    {
+      return NULL;
+    }
+
+  need = (uint32_t) ((bsize + sizeof(mp_arena_block_t) + MP_ARENA_ALIGN - 1) &
+                     ~(MP_ARENA_ALIGN - 1));
+
+  for (cur = arena->free_head; cur != 0u; prev = cur, cur = blk->next)
+    {
+      blk = mp_arena_at(arena, cur);
+      if (blk->bsize < need)
+        {
+          continue;
+        }
+
+      if (blk->bsize - need >= MP_ARENA_MIN_SPLIT)
+        {
+          /* split, and keep the tail in the free list */
+          mp_arena_block_t *tail = mp_arena_at(arena, cur + need);
+          tail->bsize = blk->bsize - need;
+          tail->next = blk->next;
+          blk->bsize = need;
+          blk->next = cur + need;
+        }
+
+      if (prev)
+        {
+          mp_arena_at(arena, prev)->next = blk->next;
+        }
+      else
+        {
+          arena->free_head = blk->next;
+        }
+
+      blk->next = MP_ARENA_USED;
+      arena->used_bsize += blk->bsize;
+      if (arena->used_bsize > arena->peak_bsize)
+        {
+          arena->peak_bsize = arena->used_bsize;
+        }
+      return blk + 1;
+    }
+
+  return NULL;
+}
+
+/* return a block to the free list, merging it with adjacent free blocks */
+void mp_arena_free(mp_arena_t * arena, void *p)
+{
+  mp_arena_block_t *blk, *prev_blk = NULL;
+  uint32_t off, prev = 0u, cur;
+
+  if (p == NULL || !mp_arena_contains(arena, p))
+    {
+      return;
+    }
+
+  blk = (mp_arena_block_t *) p - 1;
+  if (blk->next != MP_ARENA_USED)
+    {
+      return;                   /* double free */
+    }
+
+  off = mp_arena_offset(arena, blk);
+  arena->used_bsize -= blk->bsize;
+
+  for (cur = arena->free_head; cur != 0u && cur < off;
+       prev = cur, cur = mp_arena_at(arena, cur)->next);
+
+  blk->next = cur;
+  if (cur != 0u && off + blk->bsize == cur)
+    {
+      mp_arena_block_t *next_blk = mp_arena_at(arena, cur);
+      blk->bsize += next_blk->bsize;
+      blk->next = next_blk->next;
+    }
+
+  if (prev)
+    {
+      prev_blk = mp_arena_at(arena, prev);
+      if (prev + prev_blk->bsize == off)
+        {
+          prev_blk->bsize += blk->bsize;
+          prev_blk->next = blk->next;
+        }
+      else
+        {
+          prev_blk->next = off;
+        }
+    }
+  else
+    {
+      arena->free_head = off;
+    }
+}
+
+size_t mp_arena_usable_size(const void *p)
+{
+  const mp_arena_block_t *blk = (const mp_arena_block_t *)p - 1;
+  return blk->bsize - sizeof(mp_arena_block_t);
+}
+
+void *mp_arena_realloc(mp_arena_t * arena, void *p, size_t bsize)
+{
+  size_t old_bsize;
+  void *newp;
+
+  if (p == NULL)
+    {
+      return mp_arena_alloc(arena, bsize);
+    }
+
+  old_bsize = mp_arena_usable_size(p);
+  if (bsize <= old_bsize)
+    {
+      return p;
+    }
+
+  newp = mp_arena_alloc(arena, bsize);
+  if (newp != NULL)
+    {
+      memcpy(newp, p, old_bsize);
+      mp_arena_free(arena, p);
+    }
+  return newp;
+}
@@ -0,0 +1,72 @@
+/****************************************************************************
+ * modules/dnnrt/src-mp/runtime/mp_arena.h
+ *
+ *   Copyright 2019 Sony Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef MP_ARENA_H
+#  define MP_ARENA_H
+
+#  include <stddef.h>
+#  include <stdint.h>
+
+#  ifdef __cplusplus
+extern "C"
+{
+#  endif
+
+#  define MP_ARENA_MAGIC (0x444e4e41u)  /* "DNNA" */
+
+  /* header placed at the beginning of a worker-local arena.
+   * All the links are offsets from the header, so that the main core
+   * (virtual address of mpshm) and a worker core (physical address) can
+   * walk the same arena. */
+  typedef struct mp_arena
+  {
+    uint32_t magic;             /* MP_ARENA_MAGIC once initialized */
+    uint32_t bsize;             /* total size including this header */
+    uint32_t free_head;         /* offset of the first free block, or 0 */
+    uint32_t used_bsize;        /* bytes currently handed out */
+    uint32_t peak_bsize;        /* largest used_bsize ever observed */
+  } mp_arena_t;
+
+  mp_arena_t *mp_arena_init(void *base, size_t bsize);
+  void *mp_arena_alloc(mp_arena_t * arena, size_t bsize);
+  void mp_arena_free(mp_arena_t * arena, void *p);
+  void *mp_arena_realloc(mp_arena_t * arena, void *p, size_t bsize);
+  size_t mp_arena_usable_size(const void *p);
+  int mp_arena_contains(const mp_arena_t * arena, const void *p);
+
+#  ifdef __cplusplus
+}
+#  endif
+
+#endif                          /* MP_ARENA_H */
@@ -36,6 +36,7 @@
 #include <string.h>
 #include <limits.h>
 #include "runtime_client.h"
+#include "mp_arena.h"
 
 #define DNNRT_BINCLONE_WORKER_IMAGE "dnnrt-mp"
 
@@ -43,6 +44,12 @@ typedef struct dnn_mptask
 {
   mpmq_t mq;                    /* between nuttx core and target ASMP core */
   int8_t in_use;
+#if CONFIG_DNN_RT_MP_ARENA_SIZE > 0
+  mpshm_t shm;                  /* backing store of the worker-local arena */
+  mp_arena_t *arena;            /* worker-local arena (main core address) */
+#endif
+  uint32_t alloc_msgs;          /* malloc/free/realloc requests served for
+                                 * this worker, i.e. cross-core round-trips */
 } dnn_mptask_t;
 
 typedef struct lib_global_context
@@ -52,6 +59,8 @@ typedef struct lib_global_context
   mp_message_buffer_t msg_buf;  /* messages send from master to library must be 
                                  * placed on Nuttx memory, * so reallocate
                                  * buffer here */
+  mp_api_call_t posted_call;    /* API call posted by dnn_mpmgr_post_api() */
+  int8_t call_posted;           /* posted_call is waiting for its ACK */
 } lib_global_context_t;
 
 static lib_global_context_t s_mp_gctx;
@@ -66,6 +75,92 @@ static int dnn_mpmgr_post_msg(dnn_mptask_t * task, int8_t msgid, void *data)
   return mpmq_send(&task->mq, msgid, (uint32_t) data);
 }
 
+#if CONFIG_DNN_RT_MP_ARENA_SIZE > 0
+/* workers see the arena by its physical address, the main core by the
+ * virtual address returned from mpshm_attach() */
+
+static void *dnn_mpmgr_arena_to_worker(dnn_mptask_t * task, void *addr)
+{
+  if (addr == NULL || !mp_arena_contains(task->arena, addr))
+    {
+      return addr;
+    }
+  return (void *)(task->shm.paddr +
+                  ((uint8_t *) addr - (uint8_t *) task->arena));
+}
+
+static void *dnn_mpmgr_arena_to_local(dnn_mptask_t * task, void *addr)
+{
+  uintptr_t paddr = (uintptr_t) addr;
+
+  if (task->arena == NULL || paddr <= task->shm.paddr ||
+      paddr >= task->shm.paddr + task->arena->bsize)
+    {
+      return NULL;
+    }
+  return (uint8_t *) task->arena + (paddr - task->shm.paddr);
+}
+#endif
+
+/* the requesting worker is blocked until it receives the ACK, so the main
+ * core can safely operate on the worker-local arena here */
+
+static void *dnn_mpmgr_malloc(dnn_mptask_t * task, size_t bsize)
+{
+#if CONFIG_DNN_RT_MP_ARENA_SIZE > 0
+  void *p = mp_arena_alloc(task->arena, bsize);
+  if (p != NULL)
+    {
+      return dnn_mpmgr_arena_to_worker(task, p);
+    }
+#endif
+  return malloc(bsize);
+}
+
+static void dnn_mpmgr_free(dnn_mptask_t * task, void *addr)
+{
+#if CONFIG_DNN_RT_MP_ARENA_SIZE > 0
+  void *p = dnn_mpmgr_arena_to_local(task, addr);
+  if (p != NULL)
+    {
+      mp_arena_free(task->arena, p);
+      return;
+    }
+#endif
+  free(addr);
+}
+
+static void *dnn_mpmgr_realloc(dnn_mptask_t * task, void *addr, size_t bsize)
+{
+#if CONFIG_DNN_RT_MP_ARENA_SIZE > 0
+  void *p = dnn_mpmgr_arena_to_local(task, addr);
+  void *newp;
+
+  if (addr == NULL || p != NULL)
+    {
+      newp = mp_arena_realloc(task->arena, p, bsize);
+      if (newp != NULL)
+        {
+          return dnn_mpmgr_arena_to_worker(task, newp);
+        }
+      if (p == NULL)
+        {
+          return malloc(bsize);
+        }
+
+      /* arena exhausted, move the block onto the kernel heap */
+      newp = malloc(bsize);
+      if (newp != NULL)
+        {
+          memcpy(newp, p, mp_arena_usable_size(p));
+          mp_arena_free(task->arena, p);
+        }
+      return newp;
+    }
+#endif
+  return realloc(addr, bsize);
+}
+
 static void dnn_mpmgr_process_msg(dnn_mptask_t * task, int msg, uint32_t data)
 {
   switch (msg)
@@ -73,7 +168,8 @@ static void dnn_mpmgr_process_msg(dnn_mptask_t * task, int msg, uint32_t data)
     case MP_MSG_MALLOC:
       {
         mp_alloc_memory_t *alloc = (mp_alloc_memory_t *) data;
-        alloc->addr = malloc(alloc->bsize);
+        task->alloc_msgs++;
+        alloc->addr = dnn_mpmgr_malloc(task, alloc->bsize);
         dnn_mpmgr_post_msg(task, MP_MSG_MALLOC | MP_MSG_ACK_BIT, alloc);
         break;
       }
@@ -81,7 +177,8 @@ static void dnn_mpmgr_process_msg(dnn_mptask_t * task, int msg, uint32_t data)
     case MP_MSG_FREE:
       {
         mp_free_memory_t *freemem = (mp_free_memory_t *) data;
-        free(freemem->addr);
+        task->alloc_msgs++;
+        dnn_mpmgr_free(task, freemem->addr);
         dnn_mpmgr_post_msg(task, MP_MSG_FREE | MP_MSG_ACK_BIT, freemem);
         break;
       }
@@ -89,7 +186,8 @@ static void dnn_mpmgr_process_msg(dnn_mptask_t * task, int msg, uint32_t data)
     case MP_MSG_REALLOC:
       {
         mp_alloc_memory_t *alloc = (mp_alloc_memory_t *) data;
-        alloc->addr = realloc(alloc->addr, alloc->bsize);
+        task->alloc_msgs++;
+        alloc->addr = dnn_mpmgr_realloc(task, alloc->addr, alloc->bsize);
         dnn_mpmgr_post_msg(task, MP_MSG_REALLOC | MP_MSG_ACK_BIT, alloc);
         break;
       }
@@ -102,16 +200,8 @@ static void dnn_mpmgr_process_msg(dnn_mptask_t * task, int msg, uint32_t data)
     }
 }
 
-static int
-dnn_mpmgr_send_msg(dnn_mptask_t * task, int8_t msgid, void *data, uint32_t ms)
+static int dnn_mpmgr_wait_ack(dnn_mptask_t * task, int8_t msgid, uint32_t ms)
 {
-  int ret = mpmq_send(&task->mq, msgid, (uint32_t) data);
-
-  if (ret < 0)
-    {
-      return ret;
-    }
-
   int resp;
   uint32_t rdata;
   for (;;)
@@ -144,9 +234,40 @@ dnn_mpmgr_send_msg(dnn_mptask_t * task, int8_t msgid, void *data, uint32_t ms)
   return 0;
 }
 
+static int
+dnn_mpmgr_send_msg(dnn_mptask_t * task, int8_t msgid, void *data, uint32_t ms)
+{
+  int ret = mpmq_send(&task->mq, msgid, (uint32_t) data);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return dnn_mpmgr_wait_ack(task, msgid, ms);
+}
+
+static void dnn_mpmgr_pack_api(mp_api_call_t * api_call, int api,
+                               int num_args, va_list vl)
+{
+  int i;
+  int max_args = _S(api_call->arg);
+  if (num_args > max_args)
+    {
+      num_args = max_args;
+    }
+
+  memset(api_call, 0, sizeof(*api_call));
+  api_call->api = api;
+  for (i = 0; i < num_args; ++i)
+    {
+      api_call->arg[i] = va_arg(vl, int);
+    }
+}
+
 int dnn_mpmgr_call_api(int api, int num_args, ...)
 {
-  int i, ret;
+  int ret;
   mp_api_call_t api_call;
   lib_global_context_t *ctx = dnn_mpmgr_global_context();
   dnn_mptask_t *master = &ctx->mptask[0];
@@ -157,20 +278,15 @@ int dnn_mpmgr_call_api(int api, int num_args, ...)
       ret = -EPERM;
       goto bye;
     }
-
-  int max_args = _S(api_call.arg);
-  if (num_args > max_args)
+  if (ctx->call_posted)
     {
-      num_args = max_args;
+      ret = -EBUSY;
+      goto bye;
     }
 
-  memset(&api_call, 0, sizeof(api_call));
-  api_call.api = api;
   va_start(vl, num_args);
-  for (i = 0; i < num_args; ++i)
-    {
-      api_call.arg[i] = va_arg(vl, int);
-    }
+  dnn_mpmgr_pack_api(&api_call, api, num_args, vl);
+  va_end(vl);
 
   ret = dnn_mpmgr_send_msg(master, MP_MSG_CALL_API, &api_call, 0);
   if (ret)
@@ -182,6 +298,113 @@ bye:
   return ret;
 }
 
+int dnn_mpmgr_post_api(int api, int num_args, ...)
+{
+  lib_global_context_t *ctx = dnn_mpmgr_global_context();
+  dnn_mptask_t *master = &ctx->mptask[0];
+  va_list vl;
+  int ret;
+
+  if (!master->in_use)
+    {
+      return -EPERM;
+    }
+  if (ctx->call_posted)
+    {
+      return -EBUSY;
+    }
+
+  va_start(vl, num_args);
+  dnn_mpmgr_pack_api(&ctx->posted_call, api, num_args, vl);
+  va_end(vl);
+
+  ret = mpmq_send(&master->mq, MP_MSG_CALL_API, (uint32_t) & ctx->posted_call);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ctx->call_posted = true;
+  return 0;
+}
+
+int dnn_mpmgr_wait_api(void)
+{
+  lib_global_context_t *ctx = dnn_mpmgr_global_context();
+  int ret;
+
+  if (!ctx->call_posted)
+    {
+      return -EPERM;
+    }
+
+  ret = dnn_mpmgr_wait_ack(&ctx->mptask[0], MP_MSG_CALL_API, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ctx->call_posted = false;
+  return ctx->posted_call.ret;
+}
+
+int dnn_mpmgr_posted_arg(int arg_index)
+{
+  lib_global_context_t *ctx = dnn_mpmgr_global_context();
+
+  if (!ctx->call_posted)
+    {
+      return 0;
+    }
+  return ctx->posted_call.arg[arg_index];
+}
+
+#if CONFIG_DNN_RT_MP_ARENA_SIZE > 0
+/* carve a worker-local arena out of MP shared memory */
+static int dnn_mpmgr_create_arena(dnn_mptask_t * task, int idx)
+{
+  void *base;
+  int ret;
+
+  ret = mpshm_init(&task->shm, MP_ARENA_SHM_KEY + idx,
+                   CONFIG_DNN_RT_MP_ARENA_SIZE);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  base = mpshm_attach(&task->shm, 0);
+  if (base == NULL)
+    {
+      mpshm_destroy(&task->shm);
+      return -ENOMEM;
+    }
+
+  task->arena = mp_arena_init(base, CONFIG_DNN_RT_MP_ARENA_SIZE);
+  if (task->arena == NULL)
+    {
+      mpshm_detach(&task->shm);
+      mpshm_destroy(&task->shm);
+      return -EINVAL;
+    }
+
+  return 0;
+}
+
+static void dnn_mpmgr_destroy_arena(dnn_mptask_t * task)
+{
+  if (task->arena)
+    {
+      dnn_info("dnnrt: arena peak %u/%u bytes\n",
+               (unsigned int)task->arena->peak_bsize,
+               (unsigned int)task->arena->bsize);
+      mpshm_detach(&task->shm);
+      mpshm_destroy(&task->shm);
+      task->arena = NULL;
+    }
+}
+#endif
+
 static int dnn_mpmgr_start_task(lib_global_context_t * ctx, int slave_num)
 {
   int i, ret = 0;
@@ -243,8 +466,18 @@ static int dnn_mpmgr_start_task(lib_global_context_t * ctx, int slave_num)
         .load_addr = 0,
         .msg_buf = &ctx->msg_buf,
         .ret = 0,
+        .arena = NULL,
       };
 
+#if CONFIG_DNN_RT_MP_ARENA_SIZE > 0
+      ret = dnn_mpmgr_create_arena(task, i);
+      if (ret < 0)
+        {
+          goto bye;
+        }
+      init.arena = (void *)task->shm.paddr;
+#endif
+
       if (slave_num == 0)
         {
           init.load_addr = (void *)ctx->bin_clone_task.loadaddr;
@@ -303,9 +536,15 @@ int dnn_mpmgr_unload(void)
         {
           dnn_mpmgr_send_msg(task, MP_MSG_QUIT, 0, 10);
           mpmq_destroy(&task->mq);
+          dnn_info("dnnrt: task %d served %u allocation requests\n", i,
+                   (unsigned int)task->alloc_msgs);
         }
+#if CONFIG_DNN_RT_MP_ARENA_SIZE > 0
+      dnn_mpmgr_destroy_arena(task);
+#endif
       memset(task, 0, sizeof(*task));
     }
+  ctx->call_posted = false;
 
   return mptask_destroy(&ctx->bin_clone_task, true /* force */ , 0);
 }
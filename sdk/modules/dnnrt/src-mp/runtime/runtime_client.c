@@ -90,6 +90,22 @@ dnn_runtime_forward(dnn_runtime_t * rt, const void *inputs[],
   return dnn_mpmgr_call_api(DNNRT_API_RT_FOWARD, 3, rt, inputs, input_num);
 }
 
+int
+dnn_runtime_forward_async(dnn_runtime_t * rt, const void *inputs[],
+                          unsigned char input_num)
+{
+  return dnn_mpmgr_post_api(DNNRT_API_RT_FOWARD, 3, rt, inputs, input_num);
+}
+
+int dnn_runtime_forward_wait(dnn_runtime_t * rt)
+{
+  if (dnn_mpmgr_posted_arg(0) != (int)rt)
+    {
+      return -EPERM;
+    }
+  return dnn_mpmgr_wait_api();
+}
+
 int dnn_runtime_input_num(dnn_runtime_t * rt)
 {
   return dnn_mpmgr_call_api(DNNRT_API_RT_INPUT_NUM, 1, rt);
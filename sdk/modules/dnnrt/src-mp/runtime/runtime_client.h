@@ -45,6 +45,7 @@
 #    include <asmp/asmp.h>
 #    include <asmp/mpmq.h>
 #    include <asmp/mptask.h>
+#    include <asmp/mpshm.h>
 #  endif
 
 #  ifdef __cplusplus
@@ -67,6 +68,11 @@ extern "C"
 #  define MP_CPUID_MAX (8)
 #  define MAX_MP_CORE (5)       /* only 5 cores available as CPUAFMASK=0x3eu */
 #  define MP_MQ_KEY (1)
+#  define MP_ARENA_SHM_KEY (0x10)       /* MP_ARENA_SHM_KEY + task index */
+
+#  ifndef CONFIG_DNN_RT_MP_ARENA_SIZE
+#    define CONFIG_DNN_RT_MP_ARENA_SIZE 0
+#  endif
 
 /* all messages must be acknowledged by set ACK to 1 */
 #  define MP_MSG_INIT (0x01)    /* L -> M/S: initialize master/slave */
@@ -108,6 +114,10 @@ extern "C"
     void *load_addr;            /* start physical address of each ASMP bank */
     mp_message_buffer_t *msg_buf;       /* buffers for messages sent by master */
     int ret;                    /* return code */
+    void *arena;                /* physical address of the worker-local
+                                 * mp_arena_t, or NULL. A worker which knows
+                                 * it may allocate from there by itself
+                                 * instead of sending MP_MSG_MALLOC */
   } mp_task_init_t;
 
   typedef enum
@@ -143,6 +153,12 @@ extern "C"
   int dnn_mpmgr_unload(void);   /* unload MP image */
   int dnn_mpmgr_call_api(int api, int num_args, ...);   /* send API call *
                                                          * request */
+  int dnn_mpmgr_post_api(int api, int num_args, ...);   /* send API call *
+                                                         * request without
+                                                         * waiting */
+  int dnn_mpmgr_wait_api(void); /* wait for the posted API call */
+  int dnn_mpmgr_posted_arg(int arg_index);      /* argument of the posted
+                                                 * API call */
 
 #  ifdef __cplusplus
 }
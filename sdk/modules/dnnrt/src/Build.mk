@@ -49,6 +49,9 @@ INCLUDES += -Isrc
 
 CSRCS +=  runtime_nnabla.c
 CSRCS +=  shared_chunk.c
+ifeq ($(CONFIG_DNN_RT_MEMORY_PLANNER),y)
+CSRCS +=  mem_planner.c
+endif
 CSRCS +=  affine.c
 CSRCS +=  convolution.c
 CSRC_PATH += src/functions
@@ -0,0 +1,340 @@
+/****************************************************************************
+ * modules/dnnrt/src/runtime/mem_planner.c
+ *
+ *   Copyright 2019 Sony Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <dnnrt/runtime.h>
+
+#include "nnablart/runtime.h"
+#include "runtime_internal.h"
+#include "runtime_common.h"
+
+/* lifetime of a variable buffer, measured in function indices.
+ * network inputs are live from step 0, and network outputs are live
+ * until step functions.size (i.e. after the last function). */
+typedef struct dnn_vbuffer_lifetime
+{
+  int first;
+  int last;
+} dnn_vbuffer_lifetime_t;
+
+static inline uint32_t dnn_planner_round_up(uint32_t num, uint32_t multiple)
+{
+  uint32_t remain = num % multiple;
+  return remain == 0 ? num : num + multiple - remain;
+}
+
+static int dnn_planner_buffer_of(const nn_network_t * n, int var_idx)
+{
+  int *var_list = (int *)NN_GET(n, n->variables.list);
+  nn_variable_t *var = (nn_variable_t *) NN_GET(n, var_list[var_idx]);
+
+  /* negative data_index refers to a variable buffer,
+   * otherwise to a parameter stored in the network */
+  return var->data_index < 0 ? -1 - var->data_index : -1;
+}
+
+static void dnn_planner_touch(dnn_vbuffer_lifetime_t * life, int buf_idx,
+                              int step)
+{
+  if (buf_idx < 0)
+    {
+      return;
+    }
+  if (step < life[buf_idx].first)
+    {
+      life[buf_idx].first = step;
+    }
+  if (step > life[buf_idx].last)
+    {
+      life[buf_idx].last = step;
+    }
+}
+
+static int dnn_planner_root(const uint8_t * alias, int buf_idx)
+{
+  while (alias[buf_idx] != buf_idx)
+    {
+      buf_idx = alias[buf_idx];
+    }
+  return buf_idx;
+}
+
+#ifdef CONFIG_DNN_RT_MEMORY_PLANNER_INPLACE
+static int dnn_planner_inplace_capable(const nn_function_t * func)
+{
+  /* element-wise unary functions read x[i] before writing y[i],
+   * so y may safely overwrite x when both have the same layout */
+  switch (func->type)
+    {
+    case NN_FUNCTION_RELU:
+    case NN_FUNCTION_SIGMOID:
+    case NN_FUNCTION_TANH:
+      return func->inputs.size == 1 && func->outputs.size == 1;
+    default:
+      return 0;
+    }
+}
+
+static int dnn_planner_is_io(const nn_network_t * n, int buf_idx)
+{
+  int i;
+  int *in_list = (int *)NN_GET(n, n->inputs.list);
+  int *out_list = (int *)NN_GET(n, n->outputs.list);
+
+  for (i = 0; i < n->inputs.size; i++)
+    {
+      if (dnn_planner_buffer_of(n, in_list[i]) == buf_idx)
+        {
+          return 1;
+        }
+    }
+  for (i = 0; i < n->outputs.size; i++)
+    {
+      if (dnn_planner_buffer_of(n, out_list[i]) == buf_idx)
+        {
+          return 1;
+        }
+    }
+  return 0;
+}
+
+/*
+ * let the output buffer of an in-place capable function share the storage
+ * of its input buffer when the input buffer dies at that function.
+ */
+static void dnn_planner_merge_inplace(const nn_network_t * n,
+                                      dnn_vbuffer_lifetime_t * life,
+                                      uint8_t * alias,
+                                      dnn_vbuffer_alloc_info_t * alloc_info)
+{
+  int f;
+  int *func_list = (int *)NN_GET(n, n->functions.list);
+
+  for (f = 0; f < n->functions.size; f++)
+    {
+      nn_function_t *func = (nn_function_t *) NN_GET(n, func_list[f]);
+      int in_buf, out_buf, root;
+
+      if (!dnn_planner_inplace_capable(func))
+        {
+          continue;
+        }
+
+      in_buf = dnn_planner_buffer_of(n, *(int *)NN_GET(n, func->inputs.list));
+      out_buf =
+        dnn_planner_buffer_of(n, *(int *)NN_GET(n, func->outputs.list));
+      if (in_buf < 0 || out_buf < 0 || in_buf == out_buf)
+        {
+          continue;
+        }
+
+      root = dnn_planner_root(alias, in_buf);
+      if (life[root].last != f || life[out_buf].first != f ||
+          alias[out_buf] != out_buf ||
+          alloc_info->bsize_list[in_buf] != alloc_info->bsize_list[out_buf] ||
+          dnn_planner_is_io(n, in_buf) || dnn_planner_is_io(n, out_buf))
+        {
+          continue;
+        }
+
+      alias[out_buf] = (uint8_t) root;
+      life[root].last = life[out_buf].last;
+    }
+}
+#endif /* CONFIG_DNN_RT_MEMORY_PLANNER_INPLACE */
+
+static int dnn_planner_overlap(const dnn_vbuffer_lifetime_t * a,
+                               const dnn_vbuffer_lifetime_t * b)
+{
+  return a->first <= b->last && b->first <= a->last;
+}
+
+/*
+ * compute the lifetime of each variable buffer from the function order of
+ * the network, and assign each buffer an offset in a single arena so that
+ * buffers alive at the same time never overlap.
+ * This algorithm is composed of these 3 steps:
+ *  1. walk the functions in execution order and record the first and last
+ *     step each variable buffer is referenced
+ *  2. (optional) let an in-place capable function write its output into
+ *     the storage of its dying input buffer
+ *  3. place buffers greedily from the largest one, each at the lowest offset
+ *     which doesn't collide with already placed, simultaneously live buffers
+ * The result is stored into dnn_vbuffer_alloc_info_t::offset_list and
+ * dnn_vbuffer_alloc_info_t::arena_bsize.
+ */
+int dnn_plan_vbuffers(const nn_network_t * n,
+                      dnn_vbuffer_alloc_info_t * alloc_info)
+{
+  dnn_vbuffer_lifetime_t life[MAX_VBUFFER_NUM];
+  uint8_t alias[MAX_VBUFFER_NUM];
+  uint8_t order[MAX_VBUFFER_NUM];
+  size_t bsize[MAX_VBUFFER_NUM];
+  int *func_list = (int *)NN_GET(n, n->functions.list);
+  int *in_list = (int *)NN_GET(n, n->inputs.list);
+  int *out_list = (int *)NN_GET(n, n->outputs.list);
+  int num = (int)alloc_info->vbuffer_num;
+  int placed_num = 0;
+  int i, j, f;
+  size_t unplanned_bsize = 0u;
+
+  for (i = 0; i < num; i++)
+    {
+      life[i].first = INT_MAX;
+      life[i].last = -1;
+      alias[i] = (uint8_t) i;
+      bsize[i] = dnn_planner_round_up(alloc_info->bsize_list[i], 4u);
+      unplanned_bsize += bsize[i];
+    }
+
+  /* step 1 */
+  for (i = 0; i < n->inputs.size; i++)
+    {
+      dnn_planner_touch(life, dnn_planner_buffer_of(n, in_list[i]), 0);
+    }
+  for (f = 0; f < n->functions.size; f++)
+    {
+      nn_function_t *func = (nn_function_t *) NN_GET(n, func_list[f]);
+      int *vars = (int *)NN_GET(n, func->inputs.list);
+
+      for (i = 0; i < func->inputs.size; i++)
+        {
+          dnn_planner_touch(life, dnn_planner_buffer_of(n, vars[i]), f);
+        }
+      vars = (int *)NN_GET(n, func->outputs.list);
+      for (i = 0; i < func->outputs.size; i++)
+        {
+          dnn_planner_touch(life, dnn_planner_buffer_of(n, vars[i]), f);
+        }
+    }
+  for (i = 0; i < n->outputs.size; i++)
+    {
+      dnn_planner_touch(life, dnn_planner_buffer_of(n, out_list[i]),
+                        n->functions.size);
+    }
+
+  /* step 2 */
+#ifdef CONFIG_DNN_RT_MEMORY_PLANNER_INPLACE
+  dnn_planner_merge_inplace(n, life, alias, alloc_info);
+#endif
+
+  /* step 3: sort root buffers by size in descending order */
+  for (i = 0; i < num; i++)
+    {
+      int root = dnn_planner_root(alias, i);
+      if (bsize[i] > bsize[root])
+        {
+          bsize[root] = bsize[i];
+        }
+    }
+  for (i = 0; i < num; i++)
+    {
+      if (alias[i] != i)
+        {
+          continue;
+        }
+      for (j = placed_num; j > 0 && bsize[order[j - 1]] < bsize[i]; j--)
+        {
+          order[j] = order[j - 1];
+        }
+      order[j] = (uint8_t) i;
+      placed_num++;
+    }
+
+  alloc_info->arena_bsize = 0u;
+  for (i = 0; i < placed_num; i++)
+    {
+      int cur = order[i];
+      size_t offset = 0u;
+      int moved;
+
+      do
+        {
+          moved = 0;
+          for (j = 0; j < i; j++)
+            {
+              int other = order[j];
+              size_t other_end = alloc_info->offset_list[other] + bsize[other];
+
+              if (dnn_planner_overlap(&life[cur], &life[other]) &&
+                  offset < other_end &&
+                  alloc_info->offset_list[other] < offset + bsize[cur])
+                {
+                  offset = other_end;
+                  moved = 1;
+                }
+            }
+        }
+      while (moved);
+
+      alloc_info->offset_list[cur] = offset;
+      if (offset + bsize[cur] > alloc_info->arena_bsize)
+        {
+          alloc_info->arena_bsize = offset + bsize[cur];
+        }
+    }
+
+  for (i = 0; i < num; i++)
+    {
+      alloc_info->offset_list[i] =
+        alloc_info->offset_list[dnn_planner_root(alias, i)];
+    }
+
+  /* the theoretical peak is the largest sum of live buffers at any step */
+  alloc_info->lower_bsize = 0u;
+  for (f = 0; f <= n->functions.size; f++)
+    {
+      size_t live_bsize = 0u;
+      for (i = 0; i < num; i++)
+        {
+          if (alias[i] == i && life[i].first <= f && f <= life[i].last)
+            {
+              live_bsize += bsize[i];
+            }
+        }
+      if (live_bsize > alloc_info->lower_bsize)
+        {
+          alloc_info->lower_bsize = live_bsize;
+        }
+    }
+
+  dnn_info("vbuffer plan: %u bytes (theoretical peak %u, unplanned %u)\n",
+           (unsigned int)alloc_info->arena_bsize,
+           (unsigned int)alloc_info->lower_bsize,
+           (unsigned int)unplanned_bsize);
+
+  return RT_RET_NOERROR;
+}
@@ -37,6 +37,10 @@
 
 #  include <sdk/config.h>
 #  include <errno.h>
+#  include <stdbool.h>
+#  include <pthread.h>
+#  include <semaphore.h>
+#  include <dnnrt/runtime.h>
 #  include <sdk/debug.h>
 #  include <nnablart/functions.h>
 #  include <nnablart/runtime.h>
@@ -87,6 +91,14 @@ extern "C"
     size_t vbuffer_num;         /* length of bsize_list/addr_list */
     uint8_t actual_alloc_count; /* how many times to allocate a shared_chunk to
                                  * variable buffers in rt_initialize_context() */
+#  ifdef CONFIG_DNN_RT_MEMORY_PLANNER
+    size_t offset_list[MAX_VBUFFER_NUM];        /* offset of each variable
+                                                 * buffer in the arena */
+    size_t arena_bsize;         /* size of the arena holding all the variable
+                                 * buffers, computed by dnn_plan_vbuffers() */
+    size_t lower_bsize;         /* largest sum of simultaneously live
+                                 * variable buffers (theoretical peak) */
+#  endif
   };
 
   typedef struct dnn_global_context
@@ -104,6 +116,13 @@ extern "C"
                                                  * shouldn't be access after
                                                  * dnn_runtime_initialize()
                                                  * stack frame inactive */
+    pthread_t fwd_thread;       /* thread for dnn_runtime_forward_async() */
+    bool fwd_thread_alive;      /* fwd_thread has been created */
+    bool fwd_quit;              /* request fwd_thread to exit */
+    sem_t fwd_req;              /* posted to start a forward propagation */
+    sem_t fwd_done;             /* posted when it has completed */
+    dnn_runtime_t *fwd_rt;      /* runtime in flight, or NULL */
+    int fwd_ret;                /* result of the forward in flight */
   } dnn_global_context_t;
 
   dnn_global_context_t *dnn_get_global_context(void);
@@ -119,6 +138,10 @@ extern "C"
 
   int dnn_peek_vbuffers(const nn_network_t * net,
                         dnn_vbuffer_alloc_info_t * alloc_info);
+#  ifdef CONFIG_DNN_RT_MEMORY_PLANNER
+  int dnn_plan_vbuffers(const nn_network_t * net,
+                        dnn_vbuffer_alloc_info_t * alloc_info);
+#  endif
   void dnn_reset_chunk_usage(dnn_global_context_t * ctx);
   int dnn_preallocate_chunks(dnn_global_context_t * ctx,
                              dnn_vbuffer_alloc_info_t * alloc_info);
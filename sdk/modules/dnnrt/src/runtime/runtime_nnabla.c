@@ -33,7 +33,9 @@
  ****************************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sched.h>
 #include <dnnrt/runtime.h>
 
 /* header inclusion under $(SDKDIR)/../externals/nnabla-c-runtime/include */
@@ -58,8 +60,69 @@ int dnn_initialize(dnn_config_t * config)
   return RT_RET_NOERROR;
 }
 
+static void *dnn_forward_thread(void *arg)
+{
+  dnn_global_context_t *g = (dnn_global_context_t *) arg;
+
+  for (;;)
+    {
+      while (sem_wait(&g->fwd_req) != 0);
+      if (g->fwd_quit)
+        {
+          break;
+        }
+      g->fwd_ret = (int)rt_forward((rt_context_pointer) g->fwd_rt->impl_ctx);
+      sem_post(&g->fwd_done);
+    }
+
+  return NULL;
+}
+
+static int dnn_start_forward_thread(void)
+{
+  pthread_attr_t attr;
+  struct sched_param param;
+  int err;
+
+  if (s_dnn_gctx.fwd_thread_alive)
+    {
+      return RT_RET_NOERROR;
+    }
+
+  sem_init(&s_dnn_gctx.fwd_req, 0, 0);
+  sem_init(&s_dnn_gctx.fwd_done, 0, 0);
+  s_dnn_gctx.fwd_quit = false;
+
+  pthread_attr_init(&attr);
+  param.sched_priority = CONFIG_DNN_RT_FORWARD_THREAD_PRIORITY;
+  pthread_attr_setschedparam(&attr, &param);
+  pthread_attr_setstacksize(&attr, CONFIG_DNN_RT_FORWARD_THREAD_STACKSIZE);
+  err = pthread_create(&s_dnn_gctx.fwd_thread, &attr, dnn_forward_thread,
+                       &s_dnn_gctx);
+  pthread_attr_destroy(&attr);
+  if (err != 0)
+    {
+      sem_destroy(&s_dnn_gctx.fwd_req);
+      sem_destroy(&s_dnn_gctx.fwd_done);
+      return -err;
+    }
+  pthread_setname_np(s_dnn_gctx.fwd_thread, "dnnrt_forward");
+
+  s_dnn_gctx.fwd_thread_alive = true;
+  return RT_RET_NOERROR;
+}
+
 int dnn_finalize(void)
 {
+  if (s_dnn_gctx.fwd_thread_alive)
+    {
+      s_dnn_gctx.fwd_quit = true;
+      sem_post(&s_dnn_gctx.fwd_req);
+      pthread_join(s_dnn_gctx.fwd_thread, NULL);
+      sem_destroy(&s_dnn_gctx.fwd_req);
+      sem_destroy(&s_dnn_gctx.fwd_done);
+      s_dnn_gctx.fwd_thread_alive = false;
+    }
   return RT_RET_NOERROR;
 }
 
@@ -71,6 +134,12 @@ int dnn_runtime_initialize(dnn_runtime_t * rt, const nn_network_t * network)
   dnn_vbuffer_alloc_info_t alloc_info = { 0 };
   int err;
 
+  /* the shared chunks and scratch_buf are in use by the forward thread */
+  if (s_dnn_gctx.fwd_rt != NULL)
+    {
+      return -EBUSY;
+    }
+
   /* for memory saving a stack varible alloc_info is used */
   s_dnn_gctx.alloc_info = &alloc_info;
   rt->impl_ctx = NULL;
@@ -150,6 +219,11 @@ int dnn_runtime_finalize(dnn_runtime_t * rt)
 {
   DNN_CHECK_NULL_RET(rt, -EINVAL);
 
+  if (s_dnn_gctx.fwd_rt == rt)
+    {
+      dnn_runtime_forward_wait(rt);
+    }
+
   if (--s_dnn_gctx.rt_count == 0)
     {
       free(s_dnn_gctx.scratch_buf);
@@ -161,15 +235,18 @@ int dnn_runtime_finalize(dnn_runtime_t * rt)
   return (int)rt_free_context((rt_context_pointer *) & (rt->impl_ctx));
 }
 
-int dnn_runtime_forward(dnn_runtime_t * rt, const void *inputs[],
-                        unsigned char input_num)
+static int dnn_runtime_feed_inputs(dnn_runtime_t * rt, const void *inputs[],
+                                   unsigned char input_num)
 {
-  DNN_CHECK_NULL_RET(rt, -EINVAL);
   rt_context_pointer ctx = (rt_context_pointer) rt->impl_ctx;
   if (rt_num_of_input(ctx) != input_num)
     {
       return -EINVAL;
     }
+  if (s_dnn_gctx.fwd_rt != NULL)
+    {
+      return -EBUSY;
+    }
   rt_context_t *c = (rt_context_t *) ctx;
 
   for (int i = 0; i < input_num; ++i)
@@ -177,7 +254,56 @@ int dnn_runtime_forward(dnn_runtime_t * rt, const void *inputs[],
       c->variables[c->input_variable_ids[i]].data = (void *)inputs[i];
     }
 
-  return (int)rt_forward(ctx);
+  return RT_RET_NOERROR;
+}
+
+int dnn_runtime_forward(dnn_runtime_t * rt, const void *inputs[],
+                        unsigned char input_num)
+{
+  DNN_CHECK_NULL_RET(rt, -EINVAL);
+  int err = dnn_runtime_feed_inputs(rt, inputs, input_num);
+  if (err != RT_RET_NOERROR)
+    {
+      return err;
+    }
+
+  return (int)rt_forward((rt_context_pointer) rt->impl_ctx);
+}
+
+int dnn_runtime_forward_async(dnn_runtime_t * rt, const void *inputs[],
+                              unsigned char input_num)
+{
+  DNN_CHECK_NULL_RET(rt, -EINVAL);
+  int err = dnn_runtime_feed_inputs(rt, inputs, input_num);
+  if (err != RT_RET_NOERROR)
+    {
+      return err;
+    }
+
+  err = dnn_start_forward_thread();
+  if (err != RT_RET_NOERROR)
+    {
+      return err;
+    }
+
+  s_dnn_gctx.fwd_rt = rt;
+  sem_post(&s_dnn_gctx.fwd_req);
+
+  return RT_RET_NOERROR;
+}
+
+int dnn_runtime_forward_wait(dnn_runtime_t * rt)
+{
+  DNN_CHECK_NULL_RET(rt, -EINVAL);
+  if (s_dnn_gctx.fwd_rt != rt)
+    {
+      return -EPERM;
+    }
+
+  while (sem_wait(&s_dnn_gctx.fwd_done) != 0);
+  s_dnn_gctx.fwd_rt = NULL;
+
+  return s_dnn_gctx.fwd_ret;
 }
 
 int dnn_runtime_input_num(dnn_runtime_t * rt)
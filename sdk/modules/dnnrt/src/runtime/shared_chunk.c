@@ -42,7 +42,7 @@
 #include "runtime_internal.h"
 #include "runtime_common.h"
 
-#define ALIGN(x, s) ((void*)((unsigned int)(((void*)(x)) + ((s) - 1)) & ~((s) - 1)))
+#define ALIGN(x, s) ((void*)((uintptr_t)(((void*)(x)) + ((s) - 1)) & ~((uintptr_t)(s) - 1)))
 
 inline uint32_t round_up(uint32_t num, uint32_t multiple)
 {
@@ -147,7 +147,11 @@ int dnn_peek_vbuffers(const nn_network_t * n,
         }
     }
 
+#ifdef CONFIG_DNN_RT_MEMORY_PLANNER
+  return dnn_plan_vbuffers(n, alloc_info);
+#else
   return RT_RET_NOERROR;
+#endif
 }
 
 static int dnn_shared_chunk_accommodate(dnn_shared_chunk_t * self,
@@ -178,6 +182,7 @@ static inline
   return ret;
 }
 
+#ifndef CONFIG_DNN_RT_MEMORY_PLANNER
 static
   size_t dnn_vbuffer_alloc_info_remaining_bsize(dnn_vbuffer_alloc_info_t * info)
 {
@@ -191,16 +196,17 @@ static
     }
   return ret;
 }
+#endif
 
 static inline
   dnn_shared_chunk_t * dnn_create_chunk(dnn_global_context_t * ctx,
-                                        dnn_vbuffer_alloc_info_t * alloc_info)
+                                        size_t data_bsize)
 {
   /* reserve memory for new_chunk */
   dnn_shared_chunk_t *new_chunk = NULL, *last;
   size_t chunk_bsize = 0u;
   chunk_bsize += sizeof(dnn_shared_chunk_t);
-  chunk_bsize += dnn_vbuffer_alloc_info_remaining_bsize(alloc_info);
+  chunk_bsize += data_bsize;
   chunk_bsize += (4u - 1u);     // padding to 4-byte align new_chunk->data
   new_chunk = (dnn_shared_chunk_t *) malloc(chunk_bsize);
   if (new_chunk != NULL)
@@ -247,6 +253,48 @@ void dnn_deallocate_chunks(dnn_global_context_t * ctx,
     }
 }
 
+#ifdef CONFIG_DNN_RT_MEMORY_PLANNER
+/*
+ * place the arena planned by dnn_plan_vbuffers() into a shared_chunk,
+ * and store the address of each variable buffer into
+ * dnn_vbuffer_alloc_info_t::addr_list.
+ * The arena is put into the first existing shared_chunk which can
+ * accommodate it, otherwise a new shared_chunk is created for it.
+ */
+int dnn_preallocate_chunks(dnn_global_context_t * ctx,
+                           dnn_vbuffer_alloc_info_t * alloc_info)
+{
+  dnn_shared_chunk_t *chunk;
+  void *arena = NULL;
+
+  for (chunk = ctx->chunks; chunk != NULL; chunk = chunk->next)
+    {
+      if (dnn_shared_chunk_accommodate(chunk, alloc_info->arena_bsize))
+        {
+          break;
+        }
+    }
+
+  if (chunk == NULL)
+    {
+      chunk = dnn_create_chunk(ctx, alloc_info->arena_bsize);
+      if (chunk == NULL)
+        {
+          dnn_err("no enough memory to create variable buffer\n");
+          return -ENOMEM;
+        }
+    }
+
+  arena = chunk->data + chunk->used_bsize;
+  chunk->used_bsize += round_up((uint32_t) alloc_info->arena_bsize, 4u);
+  for (uint8_t idx = 0; idx < alloc_info->vbuffer_num; idx++)
+    {
+      alloc_info->addr_list[idx] = arena + alloc_info->offset_list[idx];
+    }
+
+  return RT_RET_NOERROR;
+}
+#else
 /*
  * determine how to allocate shared_chunk to variable buffers (preallocate),
  * and store the result into dnn_vbuffer_alloc_info_t::addr_list.
@@ -280,7 +328,9 @@ int dnn_preallocate_chunks(dnn_global_context_t * ctx,
   /* count the total size of variable buffers that preallocation is NOT done */
   if (dnn_vbuffer_alloc_info_remaining_bsize(alloc_info) != 0u)
     {
-      new_chunk = dnn_create_chunk(ctx, alloc_info);    // step 2
+      new_chunk =
+        dnn_create_chunk(ctx,
+                         dnn_vbuffer_alloc_info_remaining_bsize(alloc_info));   // step 2
       if (new_chunk != NULL)
         {
           // step 3
@@ -302,3 +352,4 @@ int dnn_preallocate_chunks(dnn_global_context_t * ctx,
 
   return ret;
 }
+#endif /* CONFIG_DNN_RT_MEMORY_PLANNER */
@@ -0,0 +1,229 @@
+/****************************************************************************
+ * modules/include/asmp/mpchan.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file mpchan.h
+ */
+
+#ifndef __INCLUDE_ASMP_MPCHAN_H
+#define __INCLUDE_ASMP_MPCHAN_H
+
+/**
+ * @defgroup mpchan MP channel
+ *
+ * MP channel provides a single producer/single consumer message ring in MP
+ * shared memory. Messages of a fixed size are copied through the ring in
+ * batches, and the consumer is notified with a doorbell message over an MP
+ * message queue only when the ring becomes non-empty. So bulk messages don't
+ * need manual handshakes over MP message queue, and a burst of messages costs
+ * one inter-CPU interrupt instead of one per message.
+ *
+ * Both sides initialize a channel object on the same shared memory: the side
+ * which runs first (typically the supervisor, before mptask_exec()) with
+ * #MPCHAN_CREATE, the other side without it. A channel carries messages in
+ * one direction only, use two channels for requests and responses.
+ *
+ * @{
+ */
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <asmp/types.h>
+#include <asmp/mpmq.h>
+
+/********************************************************************************
+ * Pre-processor Definitions
+ ********************************************************************************/
+
+/* Flags for mpchan_init() */
+
+#define MPCHAN_CREATE     (1 << 0)  /**< Format the ring in the shared memory */
+
+/** Size of the ring header in the shared memory. The ring indices written by
+ * the producer and the consumer are placed on separate cache lines.
+ */
+
+#define MPCHAN_CACHELINE  32
+#define MPCHAN_HDRSIZE    (3 * MPCHAN_CACHELINE)
+
+/********************************************************************************
+ * Public Type Declarations
+ ********************************************************************************/
+/**
+ * @defgroup mpchan_datatypes Data types
+ * @{
+ */
+
+/**
+ * @typedef mpchan_t
+ * MP channel object
+ */
+
+typedef struct mpchan
+{
+  void       *ring;             /**< Ring in the shared memory */
+  mpmq_t     *mq;               /**< Message queue for the doorbell */
+  int8_t      msgid;            /**< Message ID of the doorbell */
+  uint8_t     flags;            /**< Flags */
+  uint16_t    msgsize;          /**< Size of one message */
+  uint32_t    depth;            /**< Number of messages in the ring */
+  uint32_t    head;             /**< Producer index (local copy) */
+  uint32_t    tail;             /**< Consumer index (local copy) */
+} mpchan_t;
+
+/** @} mpchan_datatypes */
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/********************************************************************************
+ * Public Function Prototypes
+ ********************************************************************************/
+/**
+ * @defgroup mpchan_funcs Functions
+ * @{
+ */
+
+/**
+ * Initialize MP channel
+ *
+ * mpchan_init() initializes MP channel object on the memory @a buf, which must
+ * be in MP shared memory attached by mpshm_attach() and aligned to
+ * #MPCHAN_CACHELINE. The ring holds the largest power of two number of
+ * messages which fits into @a size bytes after #MPCHAN_HDRSIZE.
+ *
+ * The doorbell is sent with mpmq_send() as message @a msgid over @a mq, which
+ * must target the CPU of the consumer. The consumer waits for it on its own
+ * message queue, which must not be used for other messages while
+ * mpchan_receive() waits.
+ *
+ * @param [in,out] ch: MP channel object
+ * @param [in] buf: Ring memory in MP shared memory
+ * @param [in] size: Size of @a buf
+ * @param [in] msgsize: Size of one message, rounded up to a multiple of 4
+ * @param [in] mq: MP message queue for the doorbell
+ * @param [in] msgid: Message ID of the doorbell (0-127)
+ * @param [in] flags: #MPCHAN_CREATE on the side which formats the ring
+ *
+ * @return On success, mpchan_init() returns 0. On error, it returns an error
+ * number.
+ * @retval -EINVAL: Invalid argument
+ * @retval -ENOMEM: @a size is too small for two messages
+ * @retval -ENOENT: The ring is not formatted or differs in @a msgsize
+ */
+
+int mpchan_init(mpchan_t *ch, void *buf, size_t size, size_t msgsize,
+                mpmq_t *mq, int8_t msgid, int flags);
+
+/**
+ * Destroy MP channel
+ *
+ * @param [in,out] ch: MP channel object
+ *
+ * @return On success, mpchan_destroy() returns 0. On error, it returns an
+ * error number.
+ * @retval -EINVAL: Invalid argument
+ */
+
+int mpchan_destroy(mpchan_t *ch);
+
+/**
+ * Send messages via MP channel
+ *
+ * mpchan_send() copies up to @a nmsgs messages into the ring without blocking
+ * and rings the doorbell if the consumer had emptied the ring.
+ *
+ * @param [in,out] ch: MP channel object
+ * @param [in] msgs: Messages, @a nmsgs times the message size
+ * @param [in] nmsgs: Number of messages
+ *
+ * @return On success, mpchan_send() returns the number of messages sent, which
+ * is less than @a nmsgs (possibly 0) if the ring is full. On error, it returns
+ * an error number.
+ * @retval -EINVAL: Invalid argument
+ */
+
+int mpchan_send(mpchan_t *ch, const void *msgs, int nmsgs);
+
+/**
+ * Receive messages via MP channel
+ *
+ * mpchan_receive() copies up to @a nmsgs messages out of the ring. It waits
+ * for the doorbell if the ring is empty.
+ *
+ * @param [in,out] ch: MP channel object
+ * @param [out] msgs: Buffer for @a nmsgs messages
+ * @param [in] nmsgs: Number of messages
+ *
+ * @return On success, mpchan_receive() returns the number of messages
+ * received. On error, it returns an error number.
+ * @retval -EINVAL: Invalid argument
+ */
+
+int mpchan_receive(mpchan_t *ch, void *msgs, int nmsgs);
+
+/**
+ * Receive messages via MP channel with timeout
+ *
+ * @param [in,out] ch: MP channel object
+ * @param [out] msgs: Buffer for @a nmsgs messages
+ * @param [in] nmsgs: Number of messages
+ * @param [in] ms: Time out (milliseconds) for each wait of the doorbell. If ms
+ * is zero, then it waits forever. If ms is MPMQ_NONBLOCK, then it returns
+ * without waiting.
+ *
+ * @return On success, mpchan_timedreceive() returns the number of messages
+ * received. On error, it returns an error number.
+ * @retval -EINVAL: Invalid argument
+ * @retval -ETIMEDOUT: Timed out
+ * @retval -EAGAIN: The ring is empty in non-blocking mode
+ */
+
+int mpchan_timedreceive(mpchan_t *ch, void *msgs, int nmsgs, uint32_t ms);
+
+/** @} mpchan_funcs */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+/** @} mpchan */
+
+#endif
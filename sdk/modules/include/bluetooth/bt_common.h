@@ -107,6 +107,19 @@ struct ble_state_s
   char                       bt_target_name[BT_NAME_LEN]; /**< BT target device name */
 };
 
+/**
+ * @struct bt_rxq_stats_s
+ * @brief Bluetooth receive queue statistics
+ */
+struct bt_rxq_stats_s
+{
+  uint32_t posted;    /**< Events queued for the application */
+  uint32_t copied;    /**< Events copied into a receive buffer by the queue */
+  uint32_t dropped;   /**< Data events dropped, no receive buffer within the timeout */
+  uint32_t waits;     /**< Times the receiver waited for a free receive buffer */
+  uint32_t max_depth; /**< Most events queued at once */
+};
+
 /**
  * @struct bt_common_ops_s
  * @brief Bluetooth Common application callbacks
@@ -420,4 +433,39 @@ int ble_cancel_scan(void);
 
 int ble_register_common_cb(struct ble_common_ops_s *ble_common_ops);
 
+/**
+ * @brief Bluetooth hold received data
+ *        Data passed to a receive callback(e.g. SPP receive_data) is only
+ *        valid during the callback. Hold it to use it later without copying,
+ *        and release it with @ref bt_rxbuf_release when done. Held data keeps
+ *        a receive buffer busy, so further data waits for it.
+ *
+ * @param[in] data: Data pointer given to the receive callback
+ *
+ * @retval error code
+ */
+
+int bt_rxbuf_hold(uint8_t *data);
+
+/**
+ * @brief Bluetooth release received data
+ *        Release data held by @ref bt_rxbuf_hold.
+ *
+ * @param[in] data: Data pointer given to the receive callback
+ *
+ * @retval error code
+ */
+
+int bt_rxbuf_release(uint8_t *data);
+
+/**
+ * @brief Bluetooth get receive queue statistics
+ *
+ * @param[out] stats: Statistics @ref bt_rxq_stats_s
+ *
+ * @retval error code
+ */
+
+int bt_rxq_get_stats(struct bt_rxq_stats_s *stats);
+
 #endif /* __MODULES_INCLUDE_BLUETOOTH_BT_COMMON_H */
@@ -291,6 +291,21 @@ int bt_spp_register_hal(struct bt_hal_spp_ops_s *bt_hal_spp_ops);
 
 int bt_spp_event_handler(struct bt_event_t *bt_event);
 
+/**
+ * @brief Get a receive event buffer
+ *        The buffer is large enough for any receive event, e.g.
+ *        @ref bt_spp_event_recv_data_t. An event built in it and passed to
+ *        @ref bt_spp_event_handler or @ref bt_a2dp_event_handler is queued
+ *        and reaches the application without being copied.
+ *        When no buffer is free, waits up to the timeout of the group.
+ *
+ * @param[in] group_id: Event group ID @ref BT_GROUP_ID
+ *
+ * @retval Event buffer, NULL if none became free (the event is counted as dropped)
+ */
+
+struct bt_event_t *bt_rxq_alloc(uint8_t group_id);
+
 /**
  * @brief Bluetooth LE common function HAL register
  *
@@ -130,7 +130,9 @@ int dnn_finalize(void);
   * @param [in,out] rt:      dnnrt_runtime_t object
   * @param [in]     network: pointer to a memory into which .nnb file is loaded
   *
-  * @return 0 on success, otherwise returns error code in rt_return_value_t or errno_t.
+  * @return 0 on success, -EBUSY while a forward propagation started by
+  *         dnn_runtime_forward_async() is in flight,
+  *         otherwise returns error code in rt_return_value_t or errno_t.
   *
   * @note This function binds dnn_runtime_t and nn_network_t, <br>
   *       so applications don't have to give the network object to the other functions except this. <br>
@@ -166,6 +168,41 @@ int dnn_runtime_finalize(dnn_runtime_t * rt);
 int dnn_runtime_forward(dnn_runtime_t * rt, const void *inputs[],
                         unsigned char input_num);
 
+/**
+ * Start forward propagation and return without waiting for its completion.
+ * While the network is being evaluated, the caller can prepare the next
+ * input (e.g. capture and pre-process the next camera frame), so that
+ * pre-processing and forward propagation run as a two-stage pipeline.
+ *
+ * @param [in,out] rt:        dnnrt_runtime_t object
+ * @param [in]     inputs:    an array of pointers to input buffers
+ * @param [in]     input_num: length of inputs
+ *
+ * @return 0 on success, -EBUSY if another forward propagation is in flight,
+ *         otherwise returns error code in rt_return_value_t or errno_t.
+ * @note only one forward propagation can be in flight in the whole dnnrt subsystem. <br>
+ *       inputs and the input buffers must be kept unchanged,
+ *       and the outputs of rt must not be read until dnn_runtime_forward_wait() returns. <br>
+ *       If CONFIG_DNN_RT_MP=y, memory requests from the ASMP workers are
+ *       served only inside dnn_runtime_forward_wait(). <br>
+ *       The evaluation of one input is not split any further: without
+ *       CONFIG_DNN_RT_MP the whole network runs on one thread, with it the
+ *       work is distributed by the ASMP worker image.
+ */
+int dnn_runtime_forward_async(dnn_runtime_t * rt, const void *inputs[],
+                              unsigned char input_num);
+
+/**
+ * Wait for completion of forward propagation started by dnn_runtime_forward_async().
+ *
+ * @param [in,out] rt:        dnnrt_runtime_t object
+ *
+ * @return result of the forward propagation, i.e. 0 on success,
+ *         otherwise returns error code in rt_return_value_t or errno_t. <br>
+ *         -EPERM if no forward propagation of rt is in flight.
+ */
+int dnn_runtime_forward_wait(dnn_runtime_t * rt);
+
 /**
  * Return the number of inputs which this network needs.
  *
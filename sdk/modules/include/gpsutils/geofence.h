@@ -0,0 +1,261 @@
+/****************************************************************************
+ * modules/include/gpsutils/geofence.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file geofence.h
+ */
+
+#ifndef __SDK_MODULES_INCLUDE_GPSUTILS_GEOFENCE_H
+#define __SDK_MODULES_INCLUDE_GPSUTILS_GEOFENCE_H
+
+/**
+ * @defgroup geofence_sw Software geofence
+ *
+ * Software geofence checks position fixes against circular and polygonal
+ * regions on the application processor. The regions are indexed with a
+ * hashed grid, so one update only tests the regions near the position, and
+ * thousands of regions can be checked at the GNSS update rate.
+ *
+ * A region is entered when the position is inside it, and exited when the
+ * position is farther than the hysteresis distance from it. The dwell
+ * transition is reported once per stay, when the position has been inside
+ * for the dwell time. Transitions are reported with the callback function
+ * given in the configuration, from geofence_update() and its variants.
+ *
+ * All the memory is allocated at geofence_create() from the limits of the
+ * configuration, geofence_memsize() tells how much it is.
+ *
+ * Regions must not cross the 180th meridian, and their size should stay
+ * below about 100 km, since the distances are computed with a local flat
+ * earth approximation around each region.
+ *
+ * @{
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Transitions */
+
+#define GEOFENCE_TRANSITION_ENTER 0  /**< The position entered the region */
+#define GEOFENCE_TRANSITION_EXIT  1  /**< The position left the region */
+#define GEOFENCE_TRANSITION_DWELL 2  /**< The position stayed in the region */
+
+/* Region states returned by geofence_getstate() */
+
+#define GEOFENCE_STATE_OUTSIDE    0
+#define GEOFENCE_STATE_INSIDE     1
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/** Transition callback.
+ * @param[in] arg   : Argument given in the configuration
+ * @param[in] id    : Region ID
+ * @param[in] trans : Transition, GEOFENCE_TRANSITION_*
+ */
+
+typedef void (*geofence_callback_t)(void *arg, uint32_t id, int trans);
+
+/** Geofence configuration */
+
+struct geofence_config_s
+{
+  uint16_t maxregions;   /**< Maximum number of regions */
+  uint32_t maxvertices;  /**< Maximum number of polygon vertices in total */
+  uint32_t maxrefs;      /**< Size of the grid index reference table. Each
+                          * region uses one reference per grid cell it
+                          * overlaps. The grid cells are enlarged until
+                          * the references fit. 0 means 4 * maxregions */
+  uint32_t nbuckets;     /**< Number of hash buckets of the grid index.
+                          * 0 means maxregions */
+  uint32_t cellsize;     /**< Initial grid cell size [m]. 0 means
+                          * CONFIG_SENSING_GEOFENCE_CELLSIZE */
+  float    hysteresis;   /**< Distance [m] outside a region before the exit
+                          * transition is reported */
+  uint32_t dwelltime;    /**< Time [ms] inside a region before the dwell
+                          * transition is reported. 0 disables it */
+  geofence_callback_t callback; /**< Transition callback */
+  void     *arg;         /**< Argument of the callback */
+};
+
+/** Polygon vertex */
+
+struct geofence_point_s
+{
+  double latitude;       /**< Latitude [degree] */
+  double longitude;      /**< Longitude [degree] */
+};
+
+/** Geofence handle */
+
+typedef struct geofence_s *GEOFENCEHANDLE;
+
+struct cxd56_gnss_positiondata_s;
+struct cxd56_pvtlog_data_s;
+struct nmea_raw_s;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/** Get the memory size used by a geofence with a configuration.
+ * @param[in] config : Configuration
+ * @retval Number of bytes
+ */
+
+size_t geofence_memsize(const struct geofence_config_s *config);
+
+/** Create a geofence without regions.
+ * @param[in] config : Configuration
+ * @retval Geofence handle, NULL if out of memory
+ */
+
+GEOFENCEHANDLE geofence_create(const struct geofence_config_s *config);
+
+/** Destroy a geofence.
+ * @param[in] handle : Geofence handle
+ */
+
+void geofence_destroy(GEOFENCEHANDLE handle);
+
+/** Add a circular region. Region IDs should be unique.
+ * @param[in] handle    : Geofence handle
+ * @param[in] id        : Region ID
+ * @param[in] latitude  : Latitude of the center [degree]
+ * @param[in] longitude : Longitude of the center [degree]
+ * @param[in] radius    : Radius [m]
+ * @retval 0 : success
+ * @retval -ENOSPC : too many regions
+ * @retval -EINVAL : invalid parameter
+ */
+
+int geofence_add_circle(GEOFENCEHANDLE handle, uint32_t id,
+                        double latitude, double longitude, float radius);
+
+/** Add a polygonal region. Region IDs should be unique.
+ * @param[in] handle    : Geofence handle
+ * @param[in] id        : Region ID
+ * @param[in] points    : Vertices, in either winding order
+ * @param[in] npoints   : Number of vertices, 3 or more
+ * @retval 0 : success
+ * @retval -ENOSPC : too many regions or vertices
+ * @retval -EINVAL : invalid parameter
+ */
+
+int geofence_add_polygon(GEOFENCEHANDLE handle, uint32_t id,
+                         const struct geofence_point_s *points,
+                         int npoints);
+
+/** Delete a region. No transition is reported.
+ * @param[in] handle    : Geofence handle
+ * @param[in] id        : Region ID
+ * @retval 0 : success
+ * @retval -ENOENT : no such region
+ */
+
+int geofence_delete(GEOFENCEHANDLE handle, uint32_t id);
+
+/** Get the state of a region.
+ * @param[in] handle    : Geofence handle
+ * @param[in] id        : Region ID
+ * @retval GEOFENCE_STATE_OUTSIDE or GEOFENCE_STATE_INSIDE
+ * @retval -ENOENT : no such region
+ */
+
+int geofence_getstate(GEOFENCEHANDLE handle, uint32_t id);
+
+/** Check a position fix and report the transitions.
+ * @param[in] handle    : Geofence handle
+ * @param[in] latitude  : Latitude [degree]
+ * @param[in] longitude : Longitude [degree]
+ * @param[in] msec      : Time of the fix [ms]
+ * @retval Number of transitions reported
+ */
+
+int geofence_update(GEOFENCEHANDLE handle, double latitude,
+                    double longitude, uint64_t msec);
+
+/** Check a fix of the CXD56 GNSS. Fixes without a position are ignored.
+ * The time of the fix is taken from data_timestamp.
+ * @param[in] handle    : Geofence handle
+ * @param[in] posdat    : Position data read from the GNSS device
+ * @retval Number of transitions reported
+ * @retval -EAGAIN : no position
+ */
+
+int geofence_update_gnss(GEOFENCEHANDLE handle,
+                         const struct cxd56_gnss_positiondata_s *posdat);
+
+/** Check a fix extracted with NMEA_ExtractRawData().
+ * @param[in] handle    : Geofence handle
+ * @param[in] raw       : Raw position data
+ * @param[in] msec      : Time of the fix [ms]
+ * @retval Number of transitions reported
+ */
+
+int geofence_update_nmea(GEOFENCEHANDLE handle,
+                         const struct nmea_raw_s *raw, uint64_t msec);
+
+/** Check a fix of a recorded GNSS PVT log. The time of the fix is the UTC
+ * date and time of the log entry.
+ * @param[in] handle    : Geofence handle
+ * @param[in] log       : PVT log entry
+ * @retval Number of transitions reported
+ */
+
+int geofence_update_pvtlog(GEOFENCEHANDLE handle,
+                           const struct cxd56_pvtlog_data_s *log);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+/** @} geofence_sw */
+
+#endif /* __SDK_MODULES_INCLUDE_GPSUTILS_GEOFENCE_H */
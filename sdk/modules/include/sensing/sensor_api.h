@@ -297,6 +297,60 @@ typedef struct
 
 #endif /* CONFIG_SENSING_MANAGER_POWERCTRL */
 
+/*--------------------------------------------------------------------------*/
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+/**
+ * @struct sensor_command_delivery_t
+ * @brief  The command of setting how published data is delivered to
+ *         the client.
+ *         With depth 0, callbacks are called on the sensor manager thread
+ *         as before. Otherwise the client gets its own delivery thread
+ *         and a queue of depth entries, so that a slow callback doesn't
+ *         delay the other clients. When the queue is full, the oldest
+ *         entry is dropped. Data sent with SS_SendSensorDataMH() is queued
+ *         by reference to the MemHandle; data sent with
+ *         SS_SendSensorData() with is_ptr set can't outlive the call and
+ *         is still delivered on the manager thread.
+ */
+typedef struct
+{
+  sensor_command_header_t header;         /**< command header                  */
+
+  unsigned int self       : 8;            /**< client sensor ID                */
+  unsigned int decimation : 8;            /**< deliver 1 of N publications of
+                                           *   each sensor (0 or 1: all)      */
+  unsigned int depth      : 8;            /**< queue depth (0: synchronous)    */
+  unsigned int priority   : 8;            /**< delivery thread priority
+                                           *   (0: default)                   */
+  unsigned int stacksize;                 /**< delivery thread stack size
+                                           *   (0: default)                   */
+
+  unsigned int get_self(void)
+  {
+    return self;
+  }
+
+} sensor_command_delivery_t;
+
+/**
+ * @struct sensor_delivery_stats_t
+ * @brief  Delivery statistics of a client.
+ *         Latencies are measured from the dispatch on the sensor manager
+ *         thread to the call of the client callback.
+ */
+typedef struct
+{
+  uint32_t delivered;    /**< number of callbacks called               */
+  uint32_t decimated;    /**< publications skipped by decimation       */
+  uint32_t dropped;      /**< publications dropped on a full queue     */
+  uint32_t queued;       /**< publications waiting in the queue        */
+  uint32_t max_queued;   /**< highest number of waiting publications   */
+  uint32_t latency_avg;  /**< average latency [us]                     */
+  uint32_t latency_max;  /**< maximum latency [us]                     */
+} sensor_delivery_stats_t;
+
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
+
 /*--------------------------------------------------------------------------*/
 /*--------------------------------------------------------------------
     Command(Evant) Code.
@@ -333,6 +387,12 @@ enum SensorCommandCode
 
   SendResult,
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+  /*! Set delivery mode */
+
+  SetDelivery,
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
+
   /*! Number of sensor commands */
 
   SensorCommandMum
@@ -420,6 +480,27 @@ extern void SS_SendSensorRelease(FAR sensor_command_release_t *packet);
  */
 extern void SS_SendSensorChangeSubscription(FAR sensor_command_change_subscription_t *packet);
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+/**
+ * @brief     Set the decimation and the delivery mode of a client.
+ *            (If you enable CONFIG_SENSING_MANAGER_ASYNC.)
+ * @note      Effective to registered sensors. Releasing the client
+ *            stops its delivery thread.
+ * @param[in] packet
+ * @return    void
+ */
+extern void SS_SendSensorSetDelivery(FAR sensor_command_delivery_t *packet);
+
+/**
+ * @brief      Get the delivery statistics of a client.
+ * @param[in]  id    client sensor ID
+ * @param[out] stats statistics
+ * @return     true: success, false: no delivery set for the client
+ */
+extern bool SS_GetSensorDeliveryStats(unsigned int id,
+                                      FAR sensor_delivery_stats_t *stats);
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
+
 #ifdef __cplusplus
 
 /**
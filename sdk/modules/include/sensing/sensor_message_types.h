@@ -79,7 +79,8 @@
 #define MSG_SENSOR_MGR_CMD_SEND_DATA        (MSG_SENSOR_MNG_REQ | MSG_SET_SUBTYPE(0x05))
 #define MSG_SENSOR_MGR_CMD_SEND_DATA_MH     (MSG_SENSOR_MNG_REQ | MSG_SET_SUBTYPE(0x06))
 #define MSG_SENSOR_MGR_CMD_SEND_RESULT      (MSG_SENSOR_MNG_REQ | MSG_SET_SUBTYPE(0x07))
-#define MSG_SENSOR_MGR_CMD_INVALID          (MSG_SENSOR_MNG_REQ | MSG_SET_SUBTYPE(0x08))
+#define MSG_SENSOR_MGR_CMD_SET_DELIVERY     (MSG_SENSOR_MNG_REQ | MSG_SET_SUBTYPE(0x08))
+#define MSG_SENSOR_MGR_CMD_INVALID          (MSG_SENSOR_MNG_REQ | MSG_SET_SUBTYPE(0x09))
 
 #define LAST_SENSOR_MNG_MSG                 (MSG_SENSOR_MGR_CMD_INVALID + 1)
 #define SENSOR_MNG_MSG_NUM                  (LAST_SENSOR_MNG_MSG & MSG_TYPE_SUBTYPE)
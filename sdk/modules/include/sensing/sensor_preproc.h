@@ -0,0 +1,107 @@
+/****************************************************************************
+ * modules/include/sensing/sensor_preproc.h
+ *
+ *   Copyright 2018 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SENSING_SENSOR_PREPROC_H
+#define __INCLUDE_SENSING_SENSOR_PREPROC_H
+
+/**
+ * @defgroup sensor_preproc Sensor block preprocessing
+ * @{
+ *
+ * Helpers to process a whole FIFO block of three axis samples at once,
+ * shared by the tap manager and the accelerometer input of the step
+ * counter.  Samples are interleaved x, y, z, either as int16_t read from
+ * the SCU or as float (ThreeAxisSample, ST_TAP_ACCEL).
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <stdint.h>
+
+#ifdef CONFIG_EXTERNALS_CMSIS_DSP
+#  include <arm_math.h>
+#endif
+
+/**
+ * @file sensor_preproc.h
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/*--------------------------------------------------------------------------*/
+/**
+ * @brief     Convert a block of raw three axis samples to float.
+ *            dst[i] = src[i] * scale.  For an accelerometer in the 2G
+ *            range, scale is 2.0f / 32768.0f and the result is in [G].
+ * @param[in] src : num samples of int16_t x, y, z
+ * @param[out] dst : num samples of float x, y, z
+ * @param[in] num : number of samples
+ * @param[in] scale : unit of one LSB
+ */
+static inline void sensor_preproc_convert(FAR const int16_t *src,
+                                          FAR float *dst, int num,
+                                          float scale)
+{
+#ifdef CONFIG_EXTERNALS_CMSIS_DSP
+  /* q15 is x / 32768, so scale the result back by 32768 * scale */
+
+  arm_q15_to_float((FAR q15_t *)src, dst, 3 * num);
+  arm_scale_f32(dst, scale * 32768.0f, dst, 3 * num);
+#else
+  int i;
+
+  for (i = 0; i < 3 * num; i++)
+    {
+      dst[i] = (float)src[i] * scale;
+    }
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+/** @} sensor_preproc */
+
+#endif /* __INCLUDE_SENSING_SENSOR_PREPROC_H */
@@ -172,6 +172,7 @@ public:
   int close(void);
   int write(ST_TAP_ACCEL*);
   int write(ST_TAP_ACCEL*, uint64_t);
+  int write(ST_TAP_ACCEL*, int, uint64_t, uint32_t, int*);
 
   TapClass();
   ~TapClass(){};
@@ -187,6 +188,8 @@ private:
   float       mLongThres;  /* (G) The maximum vibration indicates that 
                        *   vibration of the tap. range 0.0 - 4.0
                        */
+  float       mPeakThres2; /* mPeakThres squared */
+  float       mLongThres2; /* mLongThres squared */
   int         mStabFrame;  /* (64Hz frame num) time of PEAK_THRES -> LONG_THRES. 
                        *   range 0 - 32
                        */
@@ -194,7 +197,7 @@ private:
   int          mTapCnt;          /**< Detect tap Count. */
   E_TAP_STATE  mState;           /**< Holds IDLE or TAP state */
 
-  float        mR[TAP_BUF_LEN];  /**< Set sqrt value */
+  float        mR[TAP_BUF_LEN];  /**< Set squared magnitude */
   float        mX[TAP_BUF_LEN];  /**< Accel Data(x)  */
   float        mY[TAP_BUF_LEN];  /**< Accel Data(y)  */
   float        mZ[TAP_BUF_LEN];  /**< Accel Data(z)  */
@@ -208,9 +211,10 @@ private:
   uint64_t     mStartTime;        /**< Time to use for continuous tap detection. */
 
   /* private methods */
-  float calcR(int i0, int j0);
+  float calcR2(int i0, int j0);
   bool detect(float x, float y, float z);
-  float getIndex(int idx);
+  int judge(bool detectflg, uint64_t endTime);
+  int getIndex(int idx);
 
 };
 
@@ -258,6 +262,19 @@ int TapWrite(FAR TapClass *ins, FAR ST_TAP_ACCEL *accelData);
 int TapWrite_timestamp(FAR TapClass *ins, FAR ST_TAP_ACCEL *accelData, 
                        uint64_t time_stamp);
 
+/**
+ * @brief     Detect tap in a block of samples, e.g. a FIFO read from SCU
+ * @param[in] ins : instance address of TapClass
+ * @param[in] accelData : num Accel Data
+ * @param[in] num : number of samples
+ * @param[in] time_stamp : Time Stamp of accelData[0]
+ * @param[in] interval : (microsec) sampling interval
+ * @param[out] tapcnt : num results, each as the return value of TapWrite
+ * @return    D_SA_STATUS_OK or error code
+ */
+int TapWrite_block(FAR TapClass *ins, FAR ST_TAP_ACCEL *accelData, int num,
+                   uint64_t time_stamp, uint32_t interval, FAR int *tapcnt);
+
 /** @} tap_lib_funcs */
 /** @} tap_lib */
 
@@ -218,6 +218,12 @@ int altcom_accept(int sockfd, struct altcom_sockaddr *addr,
       return -1;
     }
 
+#ifdef CONFIG_LTE_NET_SOCKREADY
+  /* After this call only the modem knows if another connection is pending */
+
+  altcom_sockready_consume(sockfd, ALTCOM_SOCKREADY_READ);
+#endif
+
   req.sockfd  = sockfd;
   req.addr    = addr;
   req.addrlen = addrlen;
@@ -303,5 +309,20 @@ int altcom_accept(int sockfd, struct altcom_sockaddr *addr,
         }
     }
 
+  /* The modem may reuse a descriptor of a closed socket */
+
+  fsock = altcom_sockfd_socket(result);
+  if (fsock)
+    {
+      memset(&fsock->stat, 0, sizeof(struct altcom_sockstat_s));
+#ifdef CONFIG_LTE_NET_SOCKBUF
+      altcom_sockbuf_free(fsock);
+      altcom_sockbuf_alloc(fsock);
+#endif
+#ifdef CONFIG_LTE_NET_SOCKREADY
+      altcom_sockready_reset(result);
+#endif
+    }
+
   return result;
 }
@@ -171,6 +171,17 @@ int altcom_close(int sockfd)
       return -1;
     }
 
+#ifdef CONFIG_LTE_NET_SOCKBUF
+  /* Send held data before the modem closes the socket */
+
+  (void)altcom_sockbuf_flush(sockfd, false);
+  altcom_sockbuf_free(fsock);
+#endif
+
+#ifdef CONFIG_LTE_NET_SOCKREADY
+  altcom_sockready_reset(sockfd);
+#endif
+
   memset(fsock, 0, sizeof(struct altcom_socket_s));
 
   req.sockfd = sockfd;
@@ -106,6 +106,7 @@ static int32_t fcntl_request(FAR struct altcom_socket_s *fsock,
 
   /* Send command and block until receive a response */
 
+  fsock->stat.rpc_count++;
   ret = apicmdgw_send((FAR uint8_t *)cmd, (FAR uint8_t *)res,
                       FCNTL_RES_DATALEN, &reslen,
                       SYS_TIMEO_FEVR);
@@ -184,6 +185,17 @@ int altcom_fcntl(int sockfd, int cmd, int val)
       case ALTCOM_SETFL:
         if ((val & ~ALTCOM_O_NONBLOCK) == 0)
           {
+            /* The caller sets the mode before every transfer,
+             * so do not ask the modem again for the current mode.
+             */
+
+            if ((val & ALTCOM_O_NONBLOCK) ==
+                (fsock->flags & ALTCOM_O_NONBLOCK))
+              {
+                ret = 0;
+                break;
+              }
+
             if (val & ALTCOM_O_NONBLOCK)
               {
                 fsock->flags |= ALTCOM_O_NONBLOCK;
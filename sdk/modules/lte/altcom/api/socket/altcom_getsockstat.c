@@ -0,0 +1,89 @@
+/****************************************************************************
+ * modules/lte/altcom/api/socket/altcom_getsockstat.c
+ *
+ *   Copyright 2018 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <string.h>
+
+#include "dbg_if.h"
+#include "altcom_sock.h"
+#include "altcom_socket.h"
+#include "altcom_seterrno.h"
+#include "altcom_errno.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: altcom_getsockstat
+ *
+ * Description:
+ *   Get the transfer counters of a socket. The counters show how many
+ *   modem commands the data transfers of the socket took.
+ *
+ * Input Parameters:
+ *   sockfd - Socket descriptor
+ *   stat   - Buffer to store the counters
+ *
+ * Returned Value:
+ *   0 on success. On failure, -1 is returned and the error is set.
+ *
+ ****************************************************************************/
+
+int altcom_getsockstat(int sockfd, FAR struct altcom_sockstat_s *stat)
+{
+  FAR struct altcom_socket_s *fsock;
+
+  if (!stat)
+    {
+      DBGIF_LOG_ERROR("Invalid parameter\n");
+      altcom_seterrno(ALTCOM_EINVAL);
+      return -1;
+    }
+
+  fsock = altcom_sockfd_socket(sockfd);
+  if (!fsock)
+    {
+      altcom_seterrno(ALTCOM_EINVAL);
+      return -1;
+    }
+
+  memcpy(stat, &fsock->stat, sizeof(struct altcom_sockstat_s));
+
+  return 0;
+}
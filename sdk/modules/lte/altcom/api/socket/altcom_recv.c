@@ -112,6 +112,7 @@ static int32_t recv_request(FAR struct altcom_socket_s *fsock,
 
   /* Send command and block until receive a response */
 
+  fsock->stat.rpc_count++;
   ret = apicmdgw_send((FAR uint8_t *)cmd, (FAR uint8_t *)res,
                       RECV_RES_DATALEN, &reslen, SYS_TIMEO_FEVR);
 
@@ -194,6 +195,21 @@ int altcom_recv(int sockfd, void *buf, size_t len, int flags)
       return -1;
     }
 
+#ifdef CONFIG_LTE_NET_SOCKREADY
+  /* After this call only the modem knows if more data is readable */
+
+  altcom_sockready_consume(sockfd, ALTCOM_SOCKREADY_READ);
+#endif
+
+#ifdef CONFIG_LTE_NET_SOCKBUF
+  if (fsock->sockbuf)
+    {
+      /* Share the receive cache with the buffered path */
+
+      return altcom_recvfrom(sockfd, buf, len, flags, NULL, NULL);
+    }
+#endif
+
   /* Check length of data to recv */
 
   if (len > APICMD_RECV_RES_RECVDATA_LENGTH)
@@ -224,6 +240,7 @@ int altcom_recv(int sockfd, void *buf, size_t len, int flags)
       ALTCOM_FD_ZERO(&readset);
       ALTCOM_FD_SET(sockfd, &readset);
 
+      fsock->stat.rpc_count++;
       ret = altcom_select_nonblock((sockfd + 1), &readset, NULL, NULL);
       if (ret > 0)
         {
@@ -268,6 +285,7 @@ int altcom_recv(int sockfd, void *buf, size_t len, int flags)
         recvtimeo = NULL;
       }
 
+      fsock->stat.rpc_count++;
       ret = altcom_select_block((sockfd + 1), &readset, NULL, NULL, recvtimeo);
       if (ret <= 0)
         {
@@ -299,5 +317,7 @@ int altcom_recv(int sockfd, void *buf, size_t len, int flags)
        }
     }
 
+  fsock->stat.rx_bytes += result;
+
   return result;
 }
@@ -59,6 +59,10 @@
 
 #define RECVFROM_REQ_FAILURE -1
 
+#ifndef MIN
+#  define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -126,6 +130,7 @@ static int32_t recvfrom_request(FAR struct altcom_socket_s *fsock,
 
   /* Send command and block until receive a response */
 
+  fsock->stat.rpc_count++;
   ret = apicmdgw_send((FAR uint8_t *)cmd, (FAR uint8_t *)res,
                       resplen, &reslen, SYS_TIMEO_FEVR);
 
@@ -197,83 +202,148 @@ errout_with_cmdfree:
 }
 
 
+#ifdef CONFIG_LTE_NET_SOCKBUF
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: altcom_recvfrom
+ * Name: recvfrom_cached
+ *
+ * Description:
+ *   Return data from the read-ahead cache. ALTCOM_MSG_PEEK leaves it in
+ *   the cache.
+ *
  ****************************************************************************/
 
-int altcom_recvfrom(int sockfd, void *buf, size_t len, int flags,
-                    struct altcom_sockaddr *from, altcom_socklen_t *fromlen)
+static int32_t recvfrom_cached(FAR struct altcom_socket_s *fsock,
+                               FAR struct recvfrom_req_s *req)
 {
-  int32_t                    ret;
-  int32_t                    result;
-  struct altcom_fd_set_s     readset;
-  FAR struct altcom_socket_s *fsock;
-  struct recvfrom_req_s      req;
-  FAR struct altcom_timeval  *recvtimeo;
+  FAR struct altcom_sockbuf_s *sockbuf = fsock->sockbuf;
+  size_t                      len;
 
-  /* Check Lte library status */
+  len = MIN(req->len, sockbuf->rxlen);
+  memcpy(req->buf, &sockbuf->rxbuf[sockbuf->rxhead], len);
 
-  ret = altcombs_check_poweron_status();
-  if (0 > ret)
+  if (req->from)
     {
-      altcom_seterrno(-ret);
-      return -1;
+      memcpy(req->from, &sockbuf->from,
+             MIN(*req->fromlen, sizeof(struct altcom_sockaddr_storage)));
     }
 
-  fsock = altcom_sockfd_socket(sockfd);
-  if (!fsock)
+  if (req->fromlen)
     {
-      altcom_seterrno(ALTCOM_EINVAL);
-      return -1;
+      *req->fromlen = sockbuf->fromlen;
     }
 
-  /* Check length of data to recv */
+  if (!(req->flags & ALTCOM_MSG_PEEK))
+    {
+      sockbuf->rxhead += len;
+      sockbuf->rxlen  -= len;
+      if (sockbuf->rxlen == 0)
+        {
+          sockbuf->rxhead = 0;
+        }
+    }
 
-  if (len > APICMD_RECVFROM_RES_RECVDATA_LENGTH)
+  return len;
+}
+
+/****************************************************************************
+ * Name: recvfrom_readahead
+ *
+ * Description:
+ *   The modem reported the socket readable and the cache is empty.
+ *   Fill the cache up to the window, then return its head. Only the first
+ *   command may wait, the following ones take what the modem already has
+ *   and stop at the first short read.
+ *
+ ****************************************************************************/
+
+static int32_t recvfrom_readahead(FAR struct altcom_socket_s *fsock,
+                                  FAR struct recvfrom_req_s *req)
+{
+  FAR struct altcom_sockbuf_s *sockbuf = fsock->sockbuf;
+  struct recvfrom_req_s       fill;
+  int32_t                     ret;
+
+  fill.sockfd  = req->sockfd;
+  fill.flags   = req->flags & ~ALTCOM_MSG_PEEK;
+  fill.from    = (FAR struct altcom_sockaddr *)&sockbuf->from;
+  fill.fromlen = &sockbuf->fromlen;
+
+  do
     {
-      DBGIF_LOG2_WARNING("Truncate receive length:%d -> %d.\n", len, APICMD_RECVFROM_RES_RECVDATA_LENGTH);
+      fill.buf = &sockbuf->rxbuf[sockbuf->rxlen];
+      fill.len = MIN(sizeof(sockbuf->rxbuf) - sockbuf->rxlen,
+                     APICMD_RECVFROM_RES_RECVDATA_LENGTH);
 
-      /* Truncate the length to the maximum transfer size */
+      sockbuf->fromlen = sizeof(struct altcom_sockaddr_storage);
 
-      len = APICMD_RECVFROM_RES_RECVDATA_LENGTH;
+      ret = recvfrom_request(fsock, &fill);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      sockbuf->rxlen += ret;
+      fill.flags |= ALTCOM_MSG_DONTWAIT;
     }
+  while ((ret == fill.len) && (sockbuf->rxlen < sizeof(sockbuf->rxbuf)));
 
-  if (!buf)
+  if (sockbuf->rxlen == 0)
     {
-      DBGIF_LOG_ERROR("buf is NULL\n");
-      altcom_seterrno(ALTCOM_EINVAL);
-      return -1;
+      /* End of stream or error of the first command */
+
+      return ret;
     }
 
-  if (from && (!fromlen))
+  return recvfrom_cached(fsock, req);
+}
+#endif /* CONFIG_LTE_NET_SOCKBUF */
+
+/****************************************************************************
+ * Name: recvfrom_fetch
+ ****************************************************************************/
+
+static int32_t recvfrom_fetch(FAR struct altcom_socket_s *fsock,
+                              FAR struct recvfrom_req_s *req)
+{
+#ifdef CONFIG_LTE_NET_SOCKBUF
+  if (fsock->sockbuf &&
+      !(req->flags & (ALTCOM_MSG_OOB | ALTCOM_MSG_WAITALL)))
     {
-      DBGIF_LOG_ERROR("fromlen is NULL\n");
-      altcom_seterrno(ALTCOM_EINVAL);
-      return -1;
+      return recvfrom_readahead(fsock, req);
     }
+#endif
 
-  req.sockfd  = sockfd;
-  req.buf     = buf;
-  req.len     = len;
-  req.flags   = flags;
-  req.from    = from;
-  req.fromlen = fromlen;
+  return recvfrom_request(fsock, req);
+}
+
+/****************************************************************************
+ * Name: recvfrom_wait_request
+ *
+ * Description:
+ *   Wait until the socket is readable, then receive from the modem.
+ *
+ ****************************************************************************/
+
+static int32_t recvfrom_wait_request(FAR struct altcom_socket_s *fsock,
+                                     FAR struct recvfrom_req_s *req)
+{
+  int32_t                   ret;
+  int32_t                   result;
+  struct altcom_fd_set_s    readset;
+  FAR struct altcom_timeval *recvtimeo;
 
   if (fsock->flags & ALTCOM_O_NONBLOCK)
     {
       /* Check recv buffer is available */
 
       ALTCOM_FD_ZERO(&readset);
-      ALTCOM_FD_SET(sockfd, &readset);
+      ALTCOM_FD_SET(req->sockfd, &readset);
 
-      ret = altcom_select_nonblock((sockfd + 1), &readset, NULL, NULL);
+      fsock->stat.rpc_count++;
+      ret = altcom_select_nonblock((req->sockfd + 1), &readset, NULL, NULL);
       if (ret > 0)
         {
-          if (!ALTCOM_FD_ISSET(sockfd, &readset))
+          if (!ALTCOM_FD_ISSET(req->sockfd, &readset))
             {
               altcom_seterrno(ALTCOM_EFAULT);
               DBGIF_LOG1_ERROR("select failed: %d\n", altcom_errno());
@@ -282,7 +352,7 @@ int altcom_recvfrom(int sockfd, void *buf, size_t len, int flags,
 
           /* Send recvfrom request */
 
-          result = recvfrom_request(fsock, &req);
+          result = recvfrom_fetch(fsock, req);
           if (result == RECVFROM_REQ_FAILURE)
             {
               return -1;
@@ -306,7 +376,7 @@ int altcom_recvfrom(int sockfd, void *buf, size_t len, int flags,
       /* Wait until recv buffer is available */
 
       ALTCOM_FD_ZERO(&readset);
-      ALTCOM_FD_SET(sockfd, &readset);
+      ALTCOM_FD_SET(req->sockfd, &readset);
 
       recvtimeo = &fsock->recvtimeo;
       if ((fsock->recvtimeo.tv_sec == 0) && (fsock->recvtimeo.tv_usec == 0))
@@ -314,7 +384,8 @@ int altcom_recvfrom(int sockfd, void *buf, size_t len, int flags,
         recvtimeo = NULL;
       }
 
-      ret = altcom_select_block((sockfd + 1), &readset, NULL, NULL, recvtimeo);
+      fsock->stat.rpc_count++;
+      ret = altcom_select_block((req->sockfd + 1), &readset, NULL, NULL, recvtimeo);
       if (ret <= 0)
         {
           if (ret == 0)
@@ -330,14 +401,14 @@ int altcom_recvfrom(int sockfd, void *buf, size_t len, int flags,
           return -1;
         }
 
-      if (!ALTCOM_FD_ISSET(sockfd, &readset))
+      if (!ALTCOM_FD_ISSET(req->sockfd, &readset))
         {
           altcom_seterrno(ALTCOM_EFAULT);
           DBGIF_LOG1_ERROR("select failed: %d\n", altcom_errno());
           return -1;
         }
 
-      result = recvfrom_request(fsock, &req);
+      result = recvfrom_fetch(fsock, req);
 
       if (result == RECVFROM_REQ_FAILURE)
        {
@@ -347,3 +418,131 @@ int altcom_recvfrom(int sockfd, void *buf, size_t len, int flags,
 
   return result;
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: altcom_recvfrom
+ ****************************************************************************/
+
+int altcom_recvfrom(int sockfd, void *buf, size_t len, int flags,
+                    struct altcom_sockaddr *from, altcom_socklen_t *fromlen)
+{
+  int32_t                    ret;
+  int32_t                    result;
+  FAR struct altcom_socket_s *fsock;
+  struct recvfrom_req_s      req;
+#ifdef CONFIG_LTE_NET_SOCKBUF
+  int32_t                    cached;
+#endif
+
+  /* Check Lte library status */
+
+  ret = altcombs_check_poweron_status();
+  if (0 > ret)
+    {
+      altcom_seterrno(-ret);
+      return -1;
+    }
+
+  fsock = altcom_sockfd_socket(sockfd);
+  if (!fsock)
+    {
+      altcom_seterrno(ALTCOM_EINVAL);
+      return -1;
+    }
+
+#ifdef CONFIG_LTE_NET_SOCKREADY
+  /* After this call only the modem knows if more data is readable */
+
+  altcom_sockready_consume(sockfd, ALTCOM_SOCKREADY_READ);
+#endif
+
+  /* Check length of data to recv */
+
+  if (len > APICMD_RECVFROM_RES_RECVDATA_LENGTH)
+    {
+      DBGIF_LOG2_WARNING("Truncate receive length:%d -> %d.\n", len, APICMD_RECVFROM_RES_RECVDATA_LENGTH);
+
+      /* Truncate the length to the maximum transfer size */
+
+      len = APICMD_RECVFROM_RES_RECVDATA_LENGTH;
+    }
+
+  if (!buf)
+    {
+      DBGIF_LOG_ERROR("buf is NULL\n");
+      altcom_seterrno(ALTCOM_EINVAL);
+      return -1;
+    }
+
+  if (from && (!fromlen))
+    {
+      DBGIF_LOG_ERROR("fromlen is NULL\n");
+      altcom_seterrno(ALTCOM_EINVAL);
+      return -1;
+    }
+
+  req.sockfd  = sockfd;
+  req.buf     = buf;
+  req.len     = len;
+  req.flags   = flags;
+  req.from    = from;
+  req.fromlen = fromlen;
+
+#ifdef CONFIG_LTE_NET_SOCKBUF
+  if (fsock->sockbuf)
+    {
+      /* Held send data may be what the peer waits for before replying */
+
+      (void)altcom_sockbuf_flush(sockfd, false);
+
+      if ((fsock->sockbuf->rxlen > 0) && !(flags & ALTCOM_MSG_OOB))
+        {
+          /* Served without a modem command */
+
+          cached = recvfrom_cached(fsock, &req);
+          fsock->stat.rx_cached += cached;
+          fsock->stat.rx_bytes  += cached;
+
+          if (!(flags & ALTCOM_MSG_WAITALL) || (flags & ALTCOM_MSG_PEEK) ||
+              (cached == len))
+            {
+              return cached;
+            }
+
+          /* The cache is drained, the rest of a MSG_WAITALL receive comes
+           * from the modem without the cache. The data already taken from
+           * the cache is returned even if that fails.
+           */
+
+          req.buf     = (FAR uint8_t *)buf + cached;
+          req.len     = len - cached;
+          req.from    = NULL;
+          req.fromlen = NULL;
+
+          result = recvfrom_wait_request(fsock, &req);
+          if (result == RECVFROM_REQ_FAILURE)
+            {
+              return cached;
+            }
+
+          fsock->stat.rx_bytes += result;
+
+          return cached + result;
+        }
+    }
+#endif
+
+  result = recvfrom_wait_request(fsock, &req);
+  if (result == RECVFROM_REQ_FAILURE)
+    {
+      return -1;
+    }
+
+  fsock->stat.rx_bytes += result;
+
+  return result;
+}
@@ -305,6 +305,82 @@ errout:
   return SELECT_REQ_FAILURE;
 }
 
+#ifdef CONFIG_LTE_NET_SOCKBUF
+/****************************************************************************
+ * Name: select_sockbuf
+ *
+ * Description:
+ *   Send held data of the sockets being selected, and report sockets with
+ *   data in their read-ahead cache as readable without waiting for the
+ *   modem. Returns the number of ready sockets, or 0 if no socket of
+ *   readset has cached data.
+ *
+ ****************************************************************************/
+
+static int select_sockbuf(int maxfdp1, FAR altcom_fd_set *readset,
+                          FAR altcom_fd_set *writeset,
+                          FAR altcom_fd_set *exceptset)
+{
+  altcom_fd_set cached;
+  int           ncached = 0;
+  int           ret;
+  int           fd;
+
+  ALTCOM_FD_ZERO(&cached);
+
+  for (fd = 0; fd < maxfdp1; fd++)
+    {
+      if ((readset && ALTCOM_FD_ISSET(fd, readset)) ||
+          (writeset && ALTCOM_FD_ISSET(fd, writeset)))
+        {
+          (void)altcom_sockbuf_flush(fd, true);
+        }
+
+      if (readset && ALTCOM_FD_ISSET(fd, readset) &&
+          (altcom_sockbuf_readable(fd) > 0))
+        {
+          ALTCOM_FD_SET(fd, &cached);
+          ncached++;
+        }
+    }
+
+  if (ncached == 0)
+    {
+      return 0;
+    }
+
+  /* Do not wait, add what the modem reports ready now */
+
+  ret = altcom_select_nonblock(maxfdp1, readset, writeset, exceptset);
+  if (ret < 0)
+    {
+      if (writeset)
+        {
+          ALTCOM_FD_ZERO(writeset);
+        }
+
+      if (exceptset)
+        {
+          ALTCOM_FD_ZERO(exceptset);
+        }
+
+      memcpy(readset, &cached, sizeof(altcom_fd_set));
+      return ncached;
+    }
+
+  for (fd = 0; fd < maxfdp1; fd++)
+    {
+      if (ALTCOM_FD_ISSET(fd, &cached) && !ALTCOM_FD_ISSET(fd, readset))
+        {
+          ALTCOM_FD_SET(fd, readset);
+          ret++;
+        }
+    }
+
+  return ret;
+}
+#endif /* CONFIG_LTE_NET_SOCKBUF */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -481,6 +557,14 @@ int altcom_select(int maxfdp1, altcom_fd_set *readset,
 {
   int ret;
 
+#ifdef CONFIG_LTE_NET_SOCKBUF
+  ret = select_sockbuf(maxfdp1, readset, writeset, exceptset);
+  if (ret > 0)
+    {
+      return ret;
+    }
+#endif
+
   if (timeout && (timeout->tv_sec == 0) && (timeout->tv_usec == 0))
     {
       ret = altcom_select_nonblock(maxfdp1, readset, writeset, exceptset);
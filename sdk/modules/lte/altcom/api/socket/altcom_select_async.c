@@ -37,7 +37,10 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
+
 #include "dbg_if.h"
+#include "osal.h"
 #include "altcom_sock.h"
 #include "altcom_select_ext.h"
 #include "altcom_select.h"
@@ -58,11 +61,30 @@ struct select_asynccb_s
   FAR struct select_asynccb_s *next;
 };
 
+/* Response to a request whose callback is not registered yet. The modem
+ * can answer before altcom_select_async() has registered the callback.
+ */
+
+struct select_unclaimed_s
+{
+  bool          valid;
+  int32_t       select_id;
+  int32_t       ret_code;
+  int32_t       err_code;
+  bool          useread;
+  bool          usewrite;
+  bool          useexcept;
+  altcom_fd_set readset;
+  altcom_fd_set writeset;
+  altcom_fd_set exceptset;
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 static FAR struct select_asynccb_s *g_callbacklist_head = NULL;
+static struct select_unclaimed_s   g_unclaimed;
 
 /****************************************************************************
  * Private Functions
@@ -269,8 +291,29 @@ int altcom_select_async(int maxfdp1, altcom_fd_set *readset,
       return -1;
     }
 
+  sys_disable_dispatch();
+
   setup_callback(id, callback, priv);
 
+  if (g_unclaimed.valid && g_unclaimed.select_id == id)
+    {
+      struct select_unclaimed_s res = g_unclaimed;
+
+      g_unclaimed.valid = false;
+
+      sys_enable_dispatch();
+
+      (void)altcom_select_async_exec_callback(
+        id, res.ret_code, res.err_code,
+        res.useread ? &res.readset : NULL,
+        res.usewrite ? &res.writeset : NULL,
+        res.useexcept ? &res.exceptset : NULL);
+    }
+  else
+    {
+      sys_enable_dispatch();
+    }
+
   return id;
 }
 
@@ -288,7 +331,38 @@ int altcom_select_async_exec_callback(int32_t id, int32_t ret_code,
   int32_t                     ret = -1;
   FAR struct select_asynccb_s *list;
 
+  sys_disable_dispatch();
+
   list = search_callbacklist(id);
+  if (!list)
+    {
+      /* Keep the response for altcom_select_async() */
+
+      g_unclaimed.valid     = true;
+      g_unclaimed.select_id = id;
+      g_unclaimed.ret_code  = ret_code;
+      g_unclaimed.err_code  = err_code;
+      g_unclaimed.useread   = (readset != NULL);
+      g_unclaimed.usewrite  = (writeset != NULL);
+      g_unclaimed.useexcept = (exceptset != NULL);
+      if (readset)
+        {
+          g_unclaimed.readset = *readset;
+        }
+
+      if (writeset)
+        {
+          g_unclaimed.writeset = *writeset;
+        }
+
+      if (exceptset)
+        {
+          g_unclaimed.exceptset = *exceptset;
+        }
+    }
+
+  sys_enable_dispatch();
+
   if (list)
     {
       /* execute callback */
@@ -112,6 +112,7 @@ static int32_t send_request(FAR struct altcom_socket_s *fsock,
 
   /* Send command and block until receive a response */
 
+  fsock->stat.rpc_count++;
   ret = apicmdgw_send((FAR uint8_t *)cmd, (FAR uint8_t *)res,
                        SEND_RES_DATALEN, &reslen, SYS_TIMEO_FEVR);
 
@@ -183,6 +184,21 @@ int altcom_send(int sockfd, const void *buf, size_t len, int flags)
       return -1;
     }
 
+#ifdef CONFIG_LTE_NET_SOCKREADY
+  /* After this call only the modem knows if more data can be sent */
+
+  altcom_sockready_consume(sockfd, ALTCOM_SOCKREADY_WRITE);
+#endif
+
+#ifdef CONFIG_LTE_NET_SOCKBUF
+  if (fsock->sockbuf)
+    {
+      /* Share the send aggregation buffer with the buffered path */
+
+      return altcom_sendto(sockfd, buf, len, flags, NULL, 0);
+    }
+#endif
+
   /* Check length of data to send */
 
   if (len > APICMD_SEND_SENDDATA_LENGTH)
@@ -213,6 +229,7 @@ int altcom_send(int sockfd, const void *buf, size_t len, int flags)
       ALTCOM_FD_ZERO(&writeset);
       ALTCOM_FD_SET(sockfd, &writeset);
 
+      fsock->stat.rpc_count++;
       ret = altcom_select_nonblock((sockfd + 1), NULL, &writeset, NULL);
       if (ret > 0)
         {
@@ -257,6 +274,7 @@ int altcom_send(int sockfd, const void *buf, size_t len, int flags)
         sendtimeo = NULL;
       }
 
+      fsock->stat.rpc_count++;
       ret = altcom_select_block((sockfd + 1), NULL, &writeset, NULL, sendtimeo);
       if (ret <= 0)
         {
@@ -288,5 +306,7 @@ int altcom_send(int sockfd, const void *buf, size_t len, int flags)
        }
     }
 
+  fsock->stat.tx_bytes += result;
+
   return result;
 }
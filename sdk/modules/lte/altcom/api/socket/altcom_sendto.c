@@ -124,6 +124,7 @@ static int32_t sendto_request(FAR struct altcom_socket_s *fsock,
 
   /* Send command and block until receive a response */
 
+  fsock->stat.rpc_count++;
   ret = apicmdgw_send((FAR uint8_t *)cmd, (FAR uint8_t *)res,
                        SENDTO_RES_DATALEN, &reslen, SYS_TIMEO_FEVR);
 
@@ -162,6 +163,220 @@ errout_with_cmdfree:
   return SENDTO_REQ_FAILURE;
 }
 
+/****************************************************************************
+ * Name: sendto_wait_request
+ *
+ * Description:
+ *   Wait until the modem can take data on the socket, then send it.
+ *
+ ****************************************************************************/
+
+static int32_t sendto_wait_request(FAR struct altcom_socket_s *fsock,
+                                   FAR struct sendto_req_s *req,
+                                   bool nonblock)
+{
+  int32_t                   ret;
+  int32_t                   result;
+  struct altcom_fd_set_s    writeset;
+  FAR struct altcom_timeval *sendtimeo;
+
+  if (nonblock || (fsock->flags & ALTCOM_O_NONBLOCK))
+    {
+      /* Check send buffer is available */
+
+      ALTCOM_FD_ZERO(&writeset);
+      ALTCOM_FD_SET(req->sockfd, &writeset);
+
+      fsock->stat.rpc_count++;
+      ret = altcom_select_nonblock((req->sockfd + 1), NULL, &writeset, NULL);
+      if (ret > 0)
+        {
+          if (!ALTCOM_FD_ISSET(req->sockfd, &writeset))
+            {
+              altcom_seterrno(ALTCOM_EFAULT);
+              DBGIF_LOG1_ERROR("select failed: %d\n", altcom_errno());
+              return -1;
+            }
+
+          /* Send sendto request */
+
+          result = sendto_request(fsock, req);
+          if (result == SENDTO_REQ_FAILURE)
+            {
+              return -1;
+            }
+        }
+      else
+        {
+          if (ret == 0)
+            {
+              altcom_seterrno(ALTCOM_EAGAIN);
+            }
+          else
+            {
+              DBGIF_LOG1_ERROR("select failed: %d\n", altcom_errno());
+            }
+          return -1;
+        }
+    }
+  else
+    {
+      /* Wait until send buffer is available */
+
+      ALTCOM_FD_ZERO(&writeset);
+      ALTCOM_FD_SET(req->sockfd, &writeset);
+
+      sendtimeo = &fsock->sendtimeo;
+      if ((fsock->sendtimeo.tv_sec == 0) && (fsock->sendtimeo.tv_usec == 0))
+      {
+        sendtimeo = NULL;
+      }
+
+      fsock->stat.rpc_count++;
+      ret = altcom_select_block((req->sockfd + 1), NULL, &writeset, NULL, sendtimeo);
+      if (ret <= 0)
+        {
+          if (ret == 0)
+            {
+              altcom_seterrno(ALTCOM_EFAULT);
+            }
+
+          if (altcom_errno() == ALTCOM_ETIMEDOUT)
+            {
+              altcom_seterrno(ALTCOM_EAGAIN);
+            }
+          DBGIF_LOG1_ERROR("select failed: %d\n", altcom_errno());
+          return -1;
+        }
+
+      if (!ALTCOM_FD_ISSET(req->sockfd, &writeset))
+        {
+          altcom_seterrno(ALTCOM_EFAULT);
+          DBGIF_LOG1_ERROR("select failed: %d\n", altcom_errno());
+          return -1;
+        }
+
+      result = sendto_request(fsock, req);
+
+      if (result == SENDTO_REQ_FAILURE)
+       {
+         return -1;
+       }
+    }
+
+  return result;
+}
+
+#ifdef CONFIG_LTE_NET_SOCKBUF
+/****************************************************************************
+ * Name: sendto_flush_locked
+ *
+ * Description:
+ *   Send the data held in the send aggregation buffer. What the modem does
+ *   not take stays at the head of the buffer. The caller holds txlock.
+ *
+ ****************************************************************************/
+
+static int32_t sendto_flush_locked(FAR struct altcom_socket_s *fsock,
+                                   int sockfd, int flags, bool nonblock)
+{
+  FAR struct altcom_sockbuf_s *sockbuf = fsock->sockbuf;
+  struct sendto_req_s         req;
+  int32_t                     ret;
+
+  while (sockbuf->txlen > 0)
+    {
+      req.sockfd = sockfd;
+      req.buf    = sockbuf->txbuf;
+      req.len    = sockbuf->txlen;
+      req.flags  = flags & ~ALTCOM_MSG_MORE;
+      req.to     = NULL;
+      req.tolen  = 0;
+
+      ret = sendto_wait_request(fsock, &req, nonblock);
+      if (ret <= 0)
+        {
+          if (ret == 0)
+            {
+              altcom_seterrno(ALTCOM_EAGAIN);
+            }
+
+          return SENDTO_REQ_FAILURE;
+        }
+
+      sockbuf->txlen -= ret;
+      memmove(sockbuf->txbuf, &sockbuf->txbuf[ret], sockbuf->txlen);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: sendto_aggregate
+ *
+ * Description:
+ *   Hold writes flagged with ALTCOM_MSG_MORE and send them together with
+ *   the next write without it, so that small writes share one command.
+ *
+ ****************************************************************************/
+
+static int32_t sendto_aggregate(FAR struct altcom_socket_s *fsock,
+                                FAR struct sendto_req_s *req)
+{
+  FAR struct altcom_sockbuf_s *sockbuf = fsock->sockbuf;
+  int32_t                     ret;
+
+  sys_lock_mutex(&sockbuf->txlock);
+
+  if (sockbuf->txlen + req->len > sizeof(sockbuf->txbuf))
+    {
+      /* No room to merge, send the held data first */
+
+      ret = sendto_flush_locked(fsock, req->sockfd, req->flags, false);
+      if (ret < 0)
+        {
+          sys_unlock_mutex(&sockbuf->txlock);
+          return SENDTO_REQ_FAILURE;
+        }
+    }
+
+  if ((sockbuf->txlen == 0) && !(req->flags & ALTCOM_MSG_MORE))
+    {
+      /* Nothing to merge with */
+
+      sys_unlock_mutex(&sockbuf->txlock);
+      return sendto_wait_request(fsock, req, false);
+    }
+
+  memcpy(&sockbuf->txbuf[sockbuf->txlen], req->buf, req->len);
+  sockbuf->txlen += req->len;
+
+  if (req->flags & ALTCOM_MSG_MORE)
+    {
+      fsock->stat.tx_merged++;
+      sys_unlock_mutex(&sockbuf->txlock);
+      return req->len;
+    }
+
+  ret = sendto_flush_locked(fsock, req->sockfd, req->flags, false);
+  if ((ret < 0) && (sockbuf->txlen >= req->len))
+    {
+      /* None of this write reached the modem, give it back */
+
+      sockbuf->txlen -= req->len;
+      sys_unlock_mutex(&sockbuf->txlock);
+      return SENDTO_REQ_FAILURE;
+    }
+
+  /* The rest of a partly sent write stays held, and a later call
+   * reports the error.
+   */
+
+  sys_unlock_mutex(&sockbuf->txlock);
+  return req->len;
+}
+#endif /* CONFIG_LTE_NET_SOCKBUF */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -175,10 +390,8 @@ int altcom_sendto(int sockfd, const void *buf, size_t len, int flags,
 {
   int32_t                     ret;
   int32_t                     result;
-  struct altcom_fd_set_s      writeset;
   FAR struct altcom_socket_s  *fsock;
   struct sendto_req_s         req;
-  FAR struct altcom_timeval   *sendtimeo;
 
   /* Check Lte library status */
 
@@ -196,6 +409,12 @@ int altcom_sendto(int sockfd, const void *buf, size_t len, int flags,
       return -1;
     }
 
+#ifdef CONFIG_LTE_NET_SOCKREADY
+  /* After this call only the modem knows if more data can be sent */
+
+  altcom_sockready_consume(sockfd, ALTCOM_SOCKREADY_WRITE);
+#endif
+
   /* Check length of data to send */
 
   if (len > APICMD_SENDTO_SENDDATA_LENGTH)
@@ -228,87 +447,77 @@ int altcom_sendto(int sockfd, const void *buf, size_t len, int flags,
   req.to     = to;
   req.tolen  = tolen;
 
-  if (fsock->flags & ALTCOM_O_NONBLOCK)
+#ifdef CONFIG_LTE_NET_SOCKBUF
+  if (fsock->sockbuf)
     {
-      /* Check send buffer is available */
-
-      ALTCOM_FD_ZERO(&writeset);
-      ALTCOM_FD_SET(sockfd, &writeset);
-
-      ret = altcom_select_nonblock((sockfd + 1), NULL, &writeset, NULL);
-      if (ret > 0)
+      if (!to)
         {
-          if (!ALTCOM_FD_ISSET(sockfd, &writeset))
-            {
-              altcom_seterrno(ALTCOM_EFAULT);
-              DBGIF_LOG1_ERROR("select failed: %d\n", altcom_errno());
-              return -1;
-            }
-
-          /* Send sendto request */
-
-          result = sendto_request(fsock, &req);
-          if (result == SENDTO_REQ_FAILURE)
-            {
-              return -1;
-            }
+          result = sendto_aggregate(fsock, &req);
         }
       else
         {
-          if (ret == 0)
-            {
-              altcom_seterrno(ALTCOM_EAGAIN);
-            }
-          else
+          /* Keep the order with the held data */
+
+          result = altcom_sockbuf_flush(sockfd, false);
+          if (result == 0)
             {
-              DBGIF_LOG1_ERROR("select failed: %d\n", altcom_errno());
+              result = sendto_wait_request(fsock, &req, false);
             }
-          return -1;
         }
     }
   else
+#endif
     {
-      /* Wait until send buffer is available */
+      result = sendto_wait_request(fsock, &req, false);
+    }
 
-      ALTCOM_FD_ZERO(&writeset);
-      ALTCOM_FD_SET(sockfd, &writeset);
+  if (result == SENDTO_REQ_FAILURE)
+    {
+      return -1;
+    }
 
-      sendtimeo = &fsock->sendtimeo;
-      if ((fsock->sendtimeo.tv_sec == 0) && (fsock->sendtimeo.tv_usec == 0))
-      {
-        sendtimeo = NULL;
-      }
+  fsock->stat.tx_bytes += result;
 
-      ret = altcom_select_block((sockfd + 1), NULL, &writeset, NULL, sendtimeo);
-      if (ret <= 0)
-        {
-          if (ret == 0)
-            {
-              altcom_seterrno(ALTCOM_EFAULT);
-            }
+  return result;
+}
 
-          if (altcom_errno() == ALTCOM_ETIMEDOUT)
-            {
-              altcom_seterrno(ALTCOM_EAGAIN);
-            }
-          DBGIF_LOG1_ERROR("select failed: %d\n", altcom_errno());
-          return -1;
-        }
+#ifdef CONFIG_LTE_NET_SOCKBUF
+/****************************************************************************
+ * Name: altcom_sockbuf_flush
+ ****************************************************************************/
 
-      if (!ALTCOM_FD_ISSET(sockfd, &writeset))
-        {
-          altcom_seterrno(ALTCOM_EFAULT);
-          DBGIF_LOG1_ERROR("select failed: %d\n", altcom_errno());
-          return -1;
-        }
+int altcom_sockbuf_flush(int sockfd, bool nonblock)
+{
+  FAR struct altcom_socket_s  *fsock;
+  FAR struct altcom_sockbuf_s *sockbuf;
+  int32_t                     ret;
 
-      result = sendto_request(fsock, &req);
+  fsock = altcom_sockfd_socket(sockfd);
+  if (!fsock || !fsock->sockbuf || (fsock->sockbuf->txlen == 0))
+    {
+      return 0;
+    }
 
-      if (result == SENDTO_REQ_FAILURE)
-       {
-         return -1;
-       }
+  sockbuf = fsock->sockbuf;
+
+  if (nonblock)
+    {
+      /* A writer may hold the lock while it waits for the modem */
+
+      if (sys_trylock_mutex(&sockbuf->txlock) < 0)
+        {
+          altcom_seterrno(ALTCOM_EAGAIN);
+          return SENDTO_REQ_FAILURE;
+        }
+    }
+  else
+    {
+      sys_lock_mutex(&sockbuf->txlock);
     }
 
-  return result;
+  ret = sendto_flush_locked(fsock, sockfd, 0, nonblock);
+  sys_unlock_mutex(&sockbuf->txlock);
+
+  return ret;
 }
+#endif /* CONFIG_LTE_NET_SOCKBUF */
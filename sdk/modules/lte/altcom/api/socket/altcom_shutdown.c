@@ -173,6 +173,12 @@ int altcom_shutdown(int sockfd, int how)
       return -1;
     }
 
+#ifdef CONFIG_LTE_NET_SOCKBUF
+  /* Send held data before the modem shuts the socket down */
+
+  (void)altcom_sockbuf_flush(sockfd, false);
+#endif
+
   req.sockfd = sockfd;
   req.how    = how;
 
@@ -39,6 +39,7 @@
 #include <string.h>
 
 #include "dbg_if.h"
+#include "osal.h"
 #include "altcom_sock.h"
 #include "altcom_socket.h"
 #include "altcom_in.h"
@@ -68,6 +69,88 @@ FAR struct altcom_socket_s *altcom_sockfd_socket(int sockfd)
   return NULL;
 }
 
+#ifdef CONFIG_LTE_NET_SOCKBUF
+/****************************************************************************
+ * Name: altcom_sockbuf_alloc
+ ****************************************************************************/
+
+void altcom_sockbuf_alloc(FAR struct altcom_socket_s *fsock)
+{
+  FAR struct altcom_sockbuf_s *sockbuf;
+  sys_cremtx_s                 mtx_param = {0};
+
+  sockbuf = (FAR struct altcom_sockbuf_s *)
+    SYS_MALLOC(sizeof(struct altcom_sockbuf_s));
+  if (!sockbuf)
+    {
+      DBGIF_LOG_WARNING("No memory for socket buffer, run unbuffered\n");
+      return;
+    }
+
+  if (sys_create_mutex(&sockbuf->txlock, &mtx_param) != 0)
+    {
+      DBGIF_LOG_WARNING("sys_create_mutex() failed, run unbuffered\n");
+      SYS_FREE(sockbuf);
+      return;
+    }
+
+  sockbuf->txlen   = 0;
+  sockbuf->rxhead  = 0;
+  sockbuf->rxlen   = 0;
+  sockbuf->fromlen = 0;
+
+  fsock->sockbuf = sockbuf;
+}
+
+/****************************************************************************
+ * Name: altcom_sockbuf_free
+ ****************************************************************************/
+
+void altcom_sockbuf_free(FAR struct altcom_socket_s *fsock)
+{
+  FAR struct altcom_sockbuf_s *sockbuf = fsock->sockbuf;
+
+  if (sockbuf)
+    {
+      fsock->sockbuf = NULL;
+      sys_delete_mutex(&sockbuf->txlock);
+      SYS_FREE(sockbuf);
+    }
+}
+
+/****************************************************************************
+ * Name: altcom_sockbuf_readable
+ ****************************************************************************/
+
+int altcom_sockbuf_readable(int sockfd)
+{
+  FAR struct altcom_socket_s *fsock = altcom_sockfd_socket(sockfd);
+
+  if (!fsock || !fsock->sockbuf)
+    {
+      return 0;
+    }
+
+  return fsock->sockbuf->rxlen;
+}
+
+/****************************************************************************
+ * Name: altcom_sockbuf_pending
+ ****************************************************************************/
+
+int altcom_sockbuf_pending(int sockfd)
+{
+  FAR struct altcom_socket_s *fsock = altcom_sockfd_socket(sockfd);
+
+  if (!fsock || !fsock->sockbuf)
+    {
+      return 0;
+    }
+
+  return fsock->sockbuf->txlen;
+}
+#endif /* CONFIG_LTE_NET_SOCKBUF */
+
 /****************************************************************************
  * Name: altcom_sockaddr_to_sockstorage
  ****************************************************************************/
@@ -181,7 +181,19 @@ int altcom_socket(int domain, int type, int protocol)
 
       DBGIF_ASSERT(fsock != NULL, "altcom socket is NULL\n");
 
+#ifdef CONFIG_LTE_NET_SOCKBUF
+      altcom_sockbuf_free(fsock);
+#endif
       memset(fsock, 0, sizeof(struct altcom_socket_s));
+#ifdef CONFIG_LTE_NET_SOCKREADY
+      altcom_sockready_reset(result);
+#endif
+#ifdef CONFIG_LTE_NET_SOCKBUF
+      if (type == ALTCOM_SOCK_STREAM)
+        {
+          altcom_sockbuf_alloc(fsock);
+        }
+#endif
     }
 
   return result;
@@ -0,0 +1,617 @@
+/****************************************************************************
+ * modules/lte/altcom/api/socket/altcom_sockready.c
+ *
+ *   Copyright 2018 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dbg_if.h"
+#include "osal.h"
+#include "altcom_sock.h"
+#include "altcom_socket.h"
+#include "altcom_select.h"
+#include "altcom_select_ext.h"
+#include "altcom_errno.h"
+#include "altcom_seterrno.h"
+#include "cc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The table is updated by the polling tasks and by the task delivering
+ * the select response. The sections are short and never block.
+ */
+
+#define sockready_lock()   sys_disable_dispatch()
+#define sockready_unlock() sys_enable_dispatch()
+
+/* Failed requests in a row after which the waiters are woken up with
+ * ALTCOM_SOCKREADY_ERROR instead of sending another request
+ */
+
+#define SOCKREADY_MAXERRORS (2)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Readiness of all sockets. One asynchronous select request to the modem
+ * covers the events asked by poll that are not known to be ready. When it
+ * completes, the ready events are recorded, and they stay ready until a
+ * transfer on the socket consumes them.
+ */
+
+struct sockready_table_s
+{
+  uint8_t                       ready[ALTCOM_NSOCKET];
+  uint8_t                       interest[ALTCOM_NSOCKET];
+  altcom_fd_set                 armed_read;   /* Covered by the request */
+  altcom_fd_set                 armed_write;
+  bool                          live;         /* Request in the modem */
+  bool                          stale;        /* Covers a closed socket */
+  bool                          arming;
+  bool                          rearm;
+  uint8_t                       errors;       /* Failed requests in a row */
+  int32_t                       id;
+  uint32_t                      gen;
+  uint32_t                      legacy;       /* Cost of select per query */
+  FAR struct altcom_sockready_s *waiters;
+  struct altcom_pollstat_s      stat;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int sockready_arm(void);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct sockready_table_s g_sockready;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sockready_covered
+ ****************************************************************************/
+
+static bool sockready_covered(int sockfd, uint8_t events)
+{
+  if (!g_sockready.live || g_sockready.stale)
+    {
+      return false;
+    }
+
+  if ((events & ALTCOM_SOCKREADY_READ) &&
+      !ALTCOM_FD_ISSET(sockfd, &g_sockready.armed_read))
+    {
+      return false;
+    }
+
+  if ((events & ALTCOM_SOCKREADY_WRITE) &&
+      !ALTCOM_FD_ISSET(sockfd, &g_sockready.armed_write))
+    {
+      return false;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: sockready_remove
+ ****************************************************************************/
+
+static bool sockready_remove(FAR struct altcom_sockready_s *waiter)
+{
+  FAR struct altcom_sockready_s **pp;
+
+  for (pp = &g_sockready.waiters; *pp; pp = &(*pp)->next)
+    {
+      if (*pp == waiter)
+        {
+          *pp = waiter->next;
+          waiter->next = NULL;
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: sockready_wakeup
+ ****************************************************************************/
+
+static FAR void *sockready_wakeup(void)
+{
+  FAR struct altcom_sockready_s **pp = &g_sockready.waiters;
+  FAR struct altcom_sockready_s *waiter;
+  FAR void                      *group = NULL;
+  uint8_t                       ready;
+
+  while (*pp)
+    {
+      waiter = *pp;
+      ready  = g_sockready.ready[waiter->sockfd] & waiter->events;
+      if (ready)
+        {
+          *pp = waiter->next;
+          waiter->next = NULL;
+          group = waiter->group;
+          waiter->notify(waiter, ready);
+        }
+      else
+        {
+          pp = &waiter->next;
+        }
+    }
+
+  return group;
+}
+
+/****************************************************************************
+ * Name: sockready_fail
+ *
+ * Description:
+ *   Wake every waiter up with ALTCOM_SOCKREADY_ERROR, so that its poll
+ *   call returns and polls again instead of waiting for a request that
+ *   failed. Called with the table locked.
+ *
+ ****************************************************************************/
+
+static void sockready_fail(void)
+{
+  FAR struct altcom_sockready_s *waiter;
+
+  while (g_sockready.waiters)
+    {
+      waiter = g_sockready.waiters;
+      g_sockready.waiters = waiter->next;
+      waiter->next = NULL;
+      waiter->notify(waiter, ALTCOM_SOCKREADY_ERROR);
+    }
+
+  g_sockready.errors = 0;
+}
+
+/****************************************************************************
+ * Name: sockready_callback
+ ****************************************************************************/
+
+static void sockready_callback(int32_t ret_code, int32_t err_code,
+                               int32_t id, FAR altcom_fd_set *readset,
+                               FAR altcom_fd_set *writeset,
+                               FAR altcom_fd_set *exceptset, FAR void *priv)
+{
+  FAR struct altcom_sockready_s *waiter;
+  FAR void                      *group;
+  uint32_t                      gen = (uint32_t)(uintptr_t)priv;
+  bool                          pending = false;
+  int                           fd;
+
+  sockready_lock();
+
+  if (gen != g_sockready.gen || !g_sockready.live)
+    {
+      /* Result of a request replaced in the meantime */
+
+      sockready_unlock();
+      return;
+    }
+
+  g_sockready.live = false;
+
+  if (ret_code < 0)
+    {
+      DBGIF_LOG2_ERROR("select response failed: %d err_code: %d\n",
+                       ret_code, err_code);
+
+      /* The request is shared by every waiter. Send a new one for them,
+       * and stop trying if that keeps failing.
+       */
+
+      if (++g_sockready.errors >= SOCKREADY_MAXERRORS)
+        {
+          sockready_fail();
+          sockready_unlock();
+          return;
+        }
+
+      pending = (g_sockready.waiters != NULL);
+      sockready_unlock();
+
+      if (pending && sockready_arm() < 0)
+        {
+          sockready_lock();
+          sockready_fail();
+          sockready_unlock();
+        }
+
+      return;
+    }
+
+  g_sockready.errors = 0;
+
+  for (fd = 0; fd < ALTCOM_NSOCKET; fd++)
+    {
+      if (readset && ALTCOM_FD_ISSET(fd, readset) &&
+          ALTCOM_FD_ISSET(fd, &g_sockready.armed_read))
+        {
+          g_sockready.ready[fd] |= ALTCOM_SOCKREADY_READ;
+        }
+
+      if (writeset && ALTCOM_FD_ISSET(fd, writeset) &&
+          ALTCOM_FD_ISSET(fd, &g_sockready.armed_write))
+        {
+          g_sockready.ready[fd] |= ALTCOM_SOCKREADY_WRITE;
+        }
+    }
+
+  /* The poll call woken up tears its other waiters down and polls again,
+   * which sends the next request. Waiters of other poll calls are covered
+   * by a new request now.
+   */
+
+  group = sockready_wakeup();
+
+  for (waiter = g_sockready.waiters; waiter; waiter = waiter->next)
+    {
+      if (!group || waiter->group != group)
+        {
+          pending = true;
+          break;
+        }
+    }
+
+  sockready_unlock();
+
+  if (pending && sockready_arm() < 0)
+    {
+      sockready_lock();
+      sockready_fail();
+      sockready_unlock();
+    }
+}
+
+/****************************************************************************
+ * Name: sockready_arm
+ *
+ * Description:
+ *   Replace the select request if it does not cover every event asked by
+ *   poll and not known to be ready. Only one task sends requests at a time,
+ *   a task finding it busy leaves a note to check again.
+ *
+ ****************************************************************************/
+
+static int sockready_arm(void)
+{
+  altcom_fd_set readset;
+  altcom_fd_set writeset;
+  bool          doread;
+  bool          dowrite;
+  bool          covered;
+  int32_t       cancel_id;
+  int32_t       id;
+  uint32_t      gen;
+  uint8_t       want;
+  int           maxfdp1;
+  int           ret = 0;
+  int           fd;
+
+  sockready_lock();
+
+  if (g_sockready.arming)
+    {
+      g_sockready.rearm = true;
+      sockready_unlock();
+      return 0;
+    }
+
+  g_sockready.arming = true;
+
+  do
+    {
+      g_sockready.rearm = false;
+
+      ALTCOM_FD_ZERO(&readset);
+      ALTCOM_FD_ZERO(&writeset);
+      doread  = false;
+      dowrite = false;
+      covered = g_sockready.live;
+      maxfdp1 = 0;
+
+      for (fd = 0; fd < ALTCOM_NSOCKET; fd++)
+        {
+          want = g_sockready.interest[fd] & ~g_sockready.ready[fd];
+          if (want & ALTCOM_SOCKREADY_READ)
+            {
+              ALTCOM_FD_SET(fd, &readset);
+              doread = true;
+            }
+
+          if (want & ALTCOM_SOCKREADY_WRITE)
+            {
+              ALTCOM_FD_SET(fd, &writeset);
+              dowrite = true;
+            }
+
+          if (want)
+            {
+              maxfdp1 = fd + 1;
+              covered = covered && sockready_covered(fd, want);
+            }
+        }
+
+      if (maxfdp1 == 0 || covered)
+        {
+          break;
+        }
+
+      cancel_id = g_sockready.live ? g_sockready.id : -1;
+
+      g_sockready.armed_read  = readset;
+      g_sockready.armed_write = writeset;
+      g_sockready.live        = true;
+      g_sockready.stale       = false;
+      g_sockready.id          = -1;
+      gen                     = ++g_sockready.gen;
+
+      g_sockready.stat.rpc_count += (cancel_id >= 0) ? 2 : 1;
+
+      sockready_unlock();
+
+      if (cancel_id >= 0)
+        {
+          (void)altcom_select_async_cancel(cancel_id);
+        }
+
+      id = altcom_select_async(maxfdp1, doread ? &readset : NULL,
+                               dowrite ? &writeset : NULL, NULL,
+                               sockready_callback, (FAR void *)(uintptr_t)gen);
+
+      sockready_lock();
+
+      if (id < 0)
+        {
+          if (gen == g_sockready.gen)
+            {
+              g_sockready.live = false;
+            }
+
+          ret = -1;
+          break;
+        }
+
+      /* The response may have been delivered already */
+
+      if (gen == g_sockready.gen && g_sockready.live)
+        {
+          g_sockready.id = id;
+        }
+    }
+  while (g_sockready.rearm);
+
+  g_sockready.arming = false;
+
+  sockready_unlock();
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: altcom_sockready_poll
+ ****************************************************************************/
+
+int altcom_sockready_poll(FAR struct altcom_sockready_s *waiter)
+{
+  uint8_t ready;
+  bool    covered;
+  int     fd;
+
+  if (!waiter || !waiter->notify || !waiter->events ||
+      waiter->sockfd < 0 || waiter->sockfd >= ALTCOM_NSOCKET)
+    {
+      altcom_seterrno(ALTCOM_EINVAL);
+      return -1;
+    }
+
+  fd = waiter->sockfd;
+
+  sockready_lock();
+
+  /* Selecting per query costs a nonblocking select, then an asynchronous
+   * select and its cancel if nothing is ready.
+   */
+
+  g_sockready.stat.polls++;
+  g_sockready.legacy++;
+
+  g_sockready.interest[fd] |= waiter->events;
+
+  ready = g_sockready.ready[fd] & waiter->events;
+  if (ready)
+    {
+      g_sockready.stat.local++;
+      sockready_unlock();
+      return ready;
+    }
+
+  g_sockready.legacy++;
+
+  waiter->next = g_sockready.waiters;
+  g_sockready.waiters = waiter;
+
+  covered = sockready_covered(fd, waiter->events);
+  if (covered)
+    {
+      g_sockready.stat.local++;
+    }
+
+  sockready_unlock();
+
+  if (!covered && sockready_arm() < 0)
+    {
+      sockready_lock();
+      (void)sockready_remove(waiter);
+      sockready_unlock();
+      return -1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: altcom_sockready_unpoll
+ ****************************************************************************/
+
+void altcom_sockready_unpoll(FAR struct altcom_sockready_s *waiter)
+{
+  sockready_lock();
+
+  if (sockready_remove(waiter))
+    {
+      g_sockready.legacy++;
+    }
+
+  sockready_unlock();
+}
+
+/****************************************************************************
+ * Name: altcom_sockready_consume
+ ****************************************************************************/
+
+void altcom_sockready_consume(int sockfd, uint8_t events)
+{
+  if (sockfd < 0 || sockfd >= ALTCOM_NSOCKET)
+    {
+      return;
+    }
+
+  sockready_lock();
+  g_sockready.ready[sockfd] &= ~events;
+  sockready_unlock();
+}
+
+/****************************************************************************
+ * Name: altcom_sockready_reset
+ ****************************************************************************/
+
+void altcom_sockready_reset(int sockfd)
+{
+  bool stale;
+
+  if (sockfd < 0 || sockfd >= ALTCOM_NSOCKET)
+    {
+      return;
+    }
+
+  sockready_lock();
+
+  g_sockready.ready[sockfd]    = 0;
+  g_sockready.interest[sockfd] = 0;
+
+  /* The modem may fail a request naming a closed socket, and with it the
+   * waiters of every other socket. Replace it now if anyone waits, else
+   * at the next poll.
+   */
+
+  stale = g_sockready.live &&
+          (ALTCOM_FD_ISSET(sockfd, &g_sockready.armed_read) ||
+           ALTCOM_FD_ISSET(sockfd, &g_sockready.armed_write));
+  if (stale)
+    {
+      g_sockready.stale = true;
+      stale = (g_sockready.waiters != NULL);
+    }
+
+  ALTCOM_FD_CLR(sockfd, &g_sockready.armed_read);
+  ALTCOM_FD_CLR(sockfd, &g_sockready.armed_write);
+
+  sockready_unlock();
+
+  if (stale && sockready_arm() < 0)
+    {
+      sockready_lock();
+      sockready_fail();
+      sockready_unlock();
+    }
+}
+
+/****************************************************************************
+ * Name: altcom_getpollstat
+ *
+ * Description:
+ *   Get the counters of the socket readiness table.
+ *
+ * Input Parameters:
+ *   stat - Buffer to store the counters
+ *
+ * Returned Value:
+ *   0 on success. On failure, -1 is returned and the error is set.
+ *
+ ****************************************************************************/
+
+int altcom_getpollstat(FAR struct altcom_pollstat_s *stat)
+{
+  if (!stat)
+    {
+      DBGIF_LOG_ERROR("Invalid parameter\n");
+      altcom_seterrno(ALTCOM_EINVAL);
+      return -1;
+    }
+
+  sockready_lock();
+
+  *stat = g_sockready.stat;
+  stat->rpc_saved = (g_sockready.legacy > g_sockready.stat.rpc_count) ?
+    g_sockready.legacy - g_sockready.stat.rpc_count : 0;
+
+  sockready_unlock();
+
+  return 0;
+}
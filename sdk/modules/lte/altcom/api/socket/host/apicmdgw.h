@@ -0,0 +1,51 @@
+/****************************************************************************
+ * modules/lte/altcom/api/socket/host/apicmdgw.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* API command gateway of the host build. It is implemented by the
+ * simulated modem in fakemodem.c.
+ */
+
+#ifndef __MODULES_LTE_ALTCOM_API_SOCKET_HOST_APICMDGW_H
+#define __MODULES_LTE_ALTCOM_API_SOCKET_HOST_APICMDGW_H
+
+#include <stdint.h>
+
+int32_t apicmdgw_send(FAR uint8_t *cmd, FAR uint8_t *respbuff,
+                      uint16_t bufflen, FAR uint16_t *resplen,
+                      int32_t timeout_ms);
+FAR uint8_t *apicmdgw_cmd_allocbuff(uint16_t cmdid, uint16_t len);
+int32_t apicmdgw_freebuff(FAR uint8_t *buff);
+
+#endif /* __MODULES_LTE_ALTCOM_API_SOCKET_HOST_APICMDGW_H */
@@ -0,0 +1,98 @@
+/****************************************************************************
+ * modules/lte/altcom/api/socket/host/apiutil.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Helpers of the altcom API for the host build. The modem is always
+ * powered on.
+ */
+
+#ifndef __MODULES_LTE_ALTCOM_API_SOCKET_HOST_APIUTIL_H
+#define __MODULES_LTE_ALTCOM_API_SOCKET_HOST_APIUTIL_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <arpa/inet.h>
+
+#include "osal.h"
+#include "dbg_if.h"
+#include "apicmdgw.h"
+#include "altcom_errno.h"
+#include "altcom_seterrno.h"
+
+#define ALTCOM_SOCK_ALLOC_CMDBUFF(buff, id ,len) \
+  (((buff) = (FAR void *)apicmdgw_cmd_allocbuff(id, len)) != NULL)
+
+static inline int32_t altcombs_check_poweron_status(void)
+{
+  return 0;
+}
+
+static inline void altcom_free_cmd(FAR uint8_t *dat)
+{
+  (void)apicmdgw_freebuff(dat);
+}
+
+static inline void altcom_sock_free_cmdandresbuff(
+  FAR void *cmdbuff, FAR void *resbuff)
+{
+  if (cmdbuff)
+    {
+      altcom_free_cmd((FAR uint8_t *)cmdbuff);
+    }
+
+  free(resbuff);
+}
+
+static inline bool altcom_sock_alloc_cmdandresbuff(
+  FAR void **buff, int32_t id, uint16_t bufflen,
+  FAR void **res, uint16_t reslen)
+{
+  if (!ALTCOM_SOCK_ALLOC_CMDBUFF(*buff, id, bufflen))
+    {
+      altcom_seterrno((int32_t)ALTCOM_ENOMEM);
+      return false;
+    }
+
+  *res = malloc(reslen);
+  if (!*res)
+    {
+      altcom_free_cmd((FAR uint8_t *)*buff);
+      altcom_seterrno((int32_t)ALTCOM_ENOMEM);
+      return false;
+    }
+
+  return true;
+}
+
+#endif /* __MODULES_LTE_ALTCOM_API_SOCKET_HOST_APIUTIL_H */
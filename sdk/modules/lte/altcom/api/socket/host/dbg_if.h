@@ -0,0 +1,68 @@
+/****************************************************************************
+ * modules/lte/altcom/api/socket/host/dbg_if.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Debug interface of the LTE library for the host build. Logs are
+ * dropped, assertions abort.
+ */
+
+#ifndef __MODULES_LTE_ALTCOM_API_SOCKET_HOST_DBG_IF_H
+#define __MODULES_LTE_ALTCOM_API_SOCKET_HOST_DBG_IF_H
+
+#include <stddef.h>
+#include <errno.h>
+#include <assert.h>
+
+#define DBGIF_LOG(...)
+
+#define DBGIF_LOG_ERROR(...)    DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG1_ERROR(...)   DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG2_ERROR(...)   DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG3_ERROR(...)   DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG_WARNING(...)  DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG1_WARNING(...) DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG2_WARNING(...) DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG3_WARNING(...) DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG_INFO(...)     DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG1_INFO(...)    DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG2_INFO(...)    DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG3_INFO(...)    DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG_DEBUG(...)    DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG1_DEBUG(...)   DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG2_DEBUG(...)   DBGIF_LOG(__VA_ARGS__)
+#define DBGIF_LOG3_DEBUG(...)   DBGIF_LOG(__VA_ARGS__)
+
+#define DBGIF_ASSERT(asrt, msg) assert(asrt)
+
+#endif /* __MODULES_LTE_ALTCOM_API_SOCKET_HOST_DBG_IF_H */
@@ -0,0 +1,742 @@
+/****************************************************************************
+ * modules/lte/altcom/api/socket/host/fakemodem.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <arpa/inet.h>
+
+#include "apicmdgw.h"
+#include "apicmd.h"
+#include "apicmd_socket.h"
+#include "apicmd_close.h"
+#include "apicmd_fcntl.h"
+#include "apicmd_select.h"
+#include "apicmd_recv.h"
+#include "apicmd_recvfrom.h"
+#include "apicmd_send.h"
+#include "apicmd_sendto.h"
+#include "altcom_errno.h"
+#include "altcom_in.h"
+#include "altcom_select_ext.h"
+#include "fakemodem.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FAKEMODEM_WAIT_STEP_US 100
+#define FAKEMODEM_NASYNC       (2 * ALTCOM_NSOCKET)
+
+#ifndef MIN
+#  define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct fakesock_s
+{
+  bool   used;
+  size_t total;     /* Bytes the peer sends */
+  size_t arrived;   /* Bytes arrived in the modem */
+  size_t consumed;  /* Bytes read by the host */
+  double frac;      /* Partly arrived byte */
+  size_t received;  /* Bytes the peer received */
+  int    match;     /* Received bytes match the pattern */
+
+  /* Messages sent by the peer, msglen bytes every period usec */
+
+  uint32_t phase;
+  uint32_t period;
+  uint32_t msglen;
+  uint32_t nmsg;
+  uint32_t sent;
+};
+
+/* Asynchronous select request waiting in the modem */
+
+struct fakeasync_s
+{
+  bool                   armed;
+  struct apicmd_select_s cmd;
+};
+
+/* Common head of the responses */
+
+begin_packed_struct struct fakemodem_res_s
+{
+  int32_t ret_code;
+  int32_t err_code;
+} end_packed_struct;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct fakemodem_param_s g_param;
+static struct fakesock_s        g_socks[ALTCOM_NSOCKET];
+static struct fakeasync_s       g_async[FAKEMODEM_NASYNC];
+static double                   g_clock;
+static uint32_t                 g_commands;
+static uint32_t                 g_events;
+static uint64_t                 g_latency;
+static uint32_t                 g_latmsgs;
+static bool                     g_delivering;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void advance(double us)
+{
+  FAR struct fakesock_s *s;
+  size_t                 room;
+  size_t                 add;
+  int                    i;
+
+  g_clock += us;
+
+  for (i = 0; i < ALTCOM_NSOCKET; i++)
+    {
+      s = &g_socks[i];
+      if (!s->used || s->arrived == s->total)
+        {
+          continue;
+        }
+
+      if (s->period > 0)
+        {
+          while (s->sent < s->nmsg &&
+                 g_clock >= s->phase + (double)s->sent * s->period)
+            {
+              s->arrived += s->msglen;
+              s->sent++;
+            }
+
+          continue;
+        }
+
+      room = g_param.window - (s->arrived - s->consumed);
+
+      if (g_param.link_byte_us > 0)
+        {
+          s->frac += g_param.link_byte_us * us;
+          add      = (size_t)s->frac;
+          s->frac -= add;
+        }
+      else
+        {
+          add = room;
+        }
+
+      if (add >= room)
+        {
+          /* The window is full, the peer stops sending */
+
+          add     = room;
+          s->frac = 0;
+        }
+
+      s->arrived += MIN(add, s->total - s->arrived);
+    }
+}
+
+static bool readable(FAR struct fakesock_s *s)
+{
+  return s->arrived > s->consumed || s->arrived == s->total;
+}
+
+static bool wait_readable(FAR struct fakesock_s *s, int32_t timeout_ms)
+{
+  double waited = 0;
+
+  while (!readable(s))
+    {
+      if (g_param.link_byte_us <= 0 ||
+          (timeout_ms >= 0 && waited >= timeout_ms * 1000.0))
+        {
+          return false;
+        }
+
+      advance(FAKEMODEM_WAIT_STEP_US);
+      waited += FAKEMODEM_WAIT_STEP_US;
+    }
+
+  return true;
+}
+
+static FAR struct fakesock_s *getsock(int32_t fd)
+{
+  if (fd < 0 || fd >= ALTCOM_NSOCKET || !g_socks[fd].used)
+    {
+      return NULL;
+    }
+
+  return &g_socks[fd];
+}
+
+static int32_t do_socket(void)
+{
+  int i;
+
+  for (i = 0; i < ALTCOM_NSOCKET; i++)
+    {
+      if (!g_socks[i].used)
+        {
+          memset(&g_socks[i], 0, sizeof(struct fakesock_s));
+          g_socks[i].used  = true;
+          g_socks[i].match = 1;
+          return i;
+        }
+    }
+
+  return -ALTCOM_ENFILE;
+}
+
+static int32_t select_eval(FAR struct apicmd_select_s *cmd,
+                           FAR struct apicmd_selectres_s *res)
+{
+  uint16_t used = ntohs(cmd->used_setbit);
+  int32_t  maxfds = ntohl(cmd->maxfds);
+  int32_t  ready = 0;
+  int      fd;
+
+  memset(&res->readset, 0, sizeof(altcom_fd_set));
+  memset(&res->writeset, 0, sizeof(altcom_fd_set));
+  memset(&res->exceptset, 0, sizeof(altcom_fd_set));
+
+  for (fd = 0; fd < maxfds; fd++)
+    {
+      if (!getsock(fd))
+        {
+          continue;
+        }
+
+      if ((used & APICMD_SELECT_USED_BIT_READSET) &&
+          ALTCOM_FD_ISSET(fd, &cmd->readset) && readable(&g_socks[fd]))
+        {
+          ALTCOM_FD_SET(fd, &res->readset);
+          ready++;
+        }
+
+      if ((used & APICMD_SELECT_USED_BIT_WRITESET) &&
+          ALTCOM_FD_ISSET(fd, &cmd->writeset))
+        {
+          ALTCOM_FD_SET(fd, &res->writeset);
+          ready++;
+        }
+    }
+
+  return ready;
+}
+
+static int32_t do_select(FAR struct apicmd_select_s *cmd,
+                         FAR struct apicmd_selectres_s *res,
+                         int32_t timeout_ms)
+{
+  int32_t ready;
+  double  waited = 0;
+
+  for (; ; )
+    {
+      ready = select_eval(cmd, res);
+      if (ready > 0 || ntohl(cmd->request) != APICMD_SELECT_REQUEST_BLOCK)
+        {
+          return ready;
+        }
+
+      if (g_param.link_byte_us <= 0 ||
+          (timeout_ms >= 0 && waited >= timeout_ms * 1000.0))
+        {
+          return -ETIMEDOUT;
+        }
+
+      advance(FAKEMODEM_WAIT_STEP_US);
+      waited += FAKEMODEM_WAIT_STEP_US;
+    }
+}
+
+static void do_async(FAR struct apicmd_select_s *cmd)
+{
+  int i;
+
+  if (ntohl(cmd->request) == APICMD_SELECT_REQUEST_BLOCKCANCEL)
+    {
+      for (i = 0; i < FAKEMODEM_NASYNC; i++)
+        {
+          if (g_async[i].armed && g_async[i].cmd.id == cmd->id)
+            {
+              g_async[i].armed = false;
+            }
+        }
+
+      return;
+    }
+
+  for (i = 0; i < FAKEMODEM_NASYNC; i++)
+    {
+      if (!g_async[i].armed)
+        {
+          g_async[i].armed = true;
+          g_async[i].cmd   = *cmd;
+          return;
+        }
+    }
+}
+
+/* A select naming a socket that is not open fails */
+
+static bool select_badfd(FAR struct apicmd_select_s *cmd)
+{
+  uint16_t used = ntohs(cmd->used_setbit);
+  int32_t  maxfds = ntohl(cmd->maxfds);
+  int      fd;
+
+  for (fd = 0; fd < maxfds; fd++)
+    {
+      if (getsock(fd))
+        {
+          continue;
+        }
+
+      if (((used & APICMD_SELECT_USED_BIT_READSET) &&
+           ALTCOM_FD_ISSET(fd, &cmd->readset)) ||
+          ((used & APICMD_SELECT_USED_BIT_WRITESET) &&
+           ALTCOM_FD_ISSET(fd, &cmd->writeset)))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/* Send the response of every asynchronous select whose sockets became
+ * ready or that failed, as the event handler of the LTE library does.
+ */
+
+static bool deliver(void)
+{
+  struct apicmd_selectres_s res;
+  uint16_t                  used;
+  int32_t                   ready;
+  bool                      delivered = false;
+  int                       i;
+
+  if (g_delivering)
+    {
+      return false;
+    }
+
+  g_delivering = true;
+
+  for (i = 0; i < FAKEMODEM_NASYNC; i++)
+    {
+      if (!g_async[i].armed)
+        {
+          continue;
+        }
+
+      if (select_badfd(&g_async[i].cmd))
+        {
+          g_async[i].armed = false;
+          g_events++;
+          delivered = true;
+
+          advance(g_param.spi_us_byte * sizeof(struct apicmd_selectres_s));
+
+          (void)altcom_select_async_exec_callback(
+            ntohl(g_async[i].cmd.id), -1, ALTCOM_EBADF, NULL, NULL, NULL);
+
+          i = -1;
+          continue;
+        }
+
+      ready = select_eval(&g_async[i].cmd, &res);
+      if (ready == 0)
+        {
+          continue;
+        }
+
+      g_async[i].armed = false;
+      g_events++;
+      delivered = true;
+
+      advance(g_param.spi_us_byte * sizeof(struct apicmd_selectres_s));
+
+      used = ntohs(g_async[i].cmd.used_setbit);
+      (void)altcom_select_async_exec_callback(
+        ntohl(g_async[i].cmd.id), ready, 0,
+        (used & APICMD_SELECT_USED_BIT_READSET) ? &res.readset : NULL,
+        (used & APICMD_SELECT_USED_BIT_WRITESET) ? &res.writeset : NULL,
+        NULL);
+
+      /* The callback may have armed other requests */
+
+      i = -1;
+    }
+
+  g_delivering = false;
+
+  return delivered;
+}
+
+static int32_t do_recv(int32_t fd, int32_t len, int32_t flags,
+                       FAR int8_t *data, FAR int32_t *err)
+{
+  FAR struct fakesock_s *s = getsock(fd);
+  size_t                 n;
+  size_t                 i;
+
+  if (!s)
+    {
+      *err = ALTCOM_EBADF;
+      return -1;
+    }
+
+  if (!readable(s) &&
+      ((flags & ALTCOM_MSG_DONTWAIT) || !wait_readable(s, -1)))
+    {
+      *err = ALTCOM_EAGAIN;
+      return -1;
+    }
+
+  n = MIN((size_t)len, s->arrived - s->consumed);
+  for (i = 0; i < n; i++)
+    {
+      data[i] = (int8_t)fakemodem_pattern(s->consumed + i);
+    }
+
+  if (!(flags & ALTCOM_MSG_PEEK))
+    {
+      if (s->period > 0)
+        {
+          for (i = s->consumed / s->msglen; i < (s->consumed + n) / s->msglen;
+               i++)
+            {
+              g_latency += (uint64_t)(g_clock - s->phase -
+                                      (double)i * s->period);
+              g_latmsgs++;
+            }
+        }
+
+      s->consumed += n;
+    }
+
+  return n;
+}
+
+static int32_t do_send(int32_t fd, int32_t len, FAR const int8_t *data,
+                       FAR int32_t *err)
+{
+  FAR struct fakesock_s *s = getsock(fd);
+  int32_t                i;
+
+  if (!s)
+    {
+      *err = ALTCOM_EBADF;
+      return -1;
+    }
+
+  for (i = 0; i < len; i++)
+    {
+      if ((uint8_t)data[i] != fakemodem_pattern(s->received + i))
+        {
+          s->match = 0;
+        }
+    }
+
+  s->received += len;
+  return len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void fakemodem_init(FAR const struct fakemodem_param_s *param)
+{
+  g_param    = *param;
+  g_clock    = 0;
+  g_commands = 0;
+  g_events   = 0;
+  g_latency  = 0;
+  g_latmsgs  = 0;
+  memset(g_socks, 0, sizeof(g_socks));
+  memset(g_async, 0, sizeof(g_async));
+}
+
+void fakemodem_load(int fd, size_t total)
+{
+  FAR struct fakesock_s *s = getsock(fd);
+
+  if (s)
+    {
+      s->total = total;
+      advance(0);
+    }
+}
+
+void fakemodem_schedule(int fd, uint32_t phase_us, uint32_t period_us,
+                        uint32_t msglen, uint32_t count)
+{
+  FAR struct fakesock_s *s = getsock(fd);
+
+  if (s)
+    {
+      s->phase  = phase_us;
+      s->period = period_us;
+      s->msglen = msglen;
+      s->nmsg   = count;
+      s->total  = (size_t)msglen * count;
+    }
+}
+
+bool fakemodem_wait(uint32_t timeout_us)
+{
+  double waited = 0;
+
+  while (waited < timeout_us)
+    {
+      advance(FAKEMODEM_WAIT_STEP_US);
+      waited += FAKEMODEM_WAIT_STEP_US;
+
+      if (deliver())
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+void fakemodem_drop(int fd)
+{
+  if (getsock(fd))
+    {
+      g_socks[fd].used = false;
+    }
+}
+
+uint64_t fakemodem_latency(FAR uint32_t *msgs)
+{
+  *msgs = g_latmsgs;
+  return g_latency;
+}
+
+uint32_t fakemodem_events(void)
+{
+  return g_events;
+}
+
+size_t fakemodem_received(int fd, FAR int *match)
+{
+  *match = g_socks[fd].match;
+  return g_socks[fd].received;
+}
+
+uint64_t fakemodem_clock(void)
+{
+  return (uint64_t)g_clock;
+}
+
+uint32_t fakemodem_commands(void)
+{
+  return g_commands;
+}
+
+FAR uint8_t *apicmdgw_cmd_allocbuff(uint16_t cmdid, uint16_t len)
+{
+  FAR struct apicmd_cmdhdr_s *hdr;
+
+  hdr = (FAR struct apicmd_cmdhdr_s *)
+    malloc(sizeof(struct apicmd_cmdhdr_s) + len);
+  if (!hdr)
+    {
+      return NULL;
+    }
+
+  memset(hdr, 0, sizeof(struct apicmd_cmdhdr_s));
+  hdr->cmdid = cmdid;
+  hdr->dtlen = len;
+
+  return (FAR uint8_t *)(hdr + 1);
+}
+
+int32_t apicmdgw_freebuff(FAR uint8_t *buff)
+{
+  free((FAR struct apicmd_cmdhdr_s *)buff - 1);
+  return 0;
+}
+
+int32_t apicmdgw_send(FAR uint8_t *cmd, FAR uint8_t *respbuff,
+                      uint16_t bufflen, FAR uint16_t *resplen,
+                      int32_t timeout_ms)
+{
+  FAR struct apicmd_cmdhdr_s *hdr = (FAR struct apicmd_cmdhdr_s *)cmd - 1;
+  FAR struct fakemodem_res_s *res = (FAR struct fakemodem_res_s *)respbuff;
+  uint16_t                    reslen = sizeof(struct fakemodem_res_s);
+  size_t                      payload = hdr->dtlen;
+  int32_t                     ret = 0;
+  int32_t                     err = 0;
+
+  g_commands++;
+
+  if (!respbuff)
+    {
+      /* Asynchronous request or cancel, the response comes as an event */
+
+      if (hdr->cmdid == APICMDID_SOCK_SELECT)
+        {
+          do_async((FAR struct apicmd_select_s *)cmd);
+        }
+
+      advance(g_param.rpc_us + g_param.spi_us_byte * payload);
+      (void)deliver();
+      return hdr->dtlen;
+    }
+
+  switch (hdr->cmdid)
+    {
+      case APICMDID_SOCK_SOCKET:
+        ret = do_socket();
+        if (ret < 0)
+          {
+            err = -ret;
+            ret = -1;
+          }
+        break;
+
+      case APICMDID_SOCK_CLOSE:
+        {
+          FAR struct apicmd_close_s *c = (FAR struct apicmd_close_s *)cmd;
+          int32_t fd = ntohl(c->sockfd);
+
+          if (getsock(fd))
+            {
+              g_socks[fd].used = false;
+            }
+        }
+        break;
+
+      case APICMDID_SOCK_SELECT:
+        {
+          FAR struct apicmd_selectres_s *r =
+            (FAR struct apicmd_selectres_s *)respbuff;
+
+          ret = do_select((FAR struct apicmd_select_s *)cmd, r, timeout_ms);
+          if (ret == -ETIMEDOUT)
+            {
+              return ret;
+            }
+
+          r->id          = ((FAR struct apicmd_select_s *)cmd)->id;
+          r->used_setbit = ((FAR struct apicmd_select_s *)cmd)->used_setbit;
+          reslen         = sizeof(struct apicmd_selectres_s);
+        }
+        break;
+
+      case APICMDID_SOCK_RECV:
+        {
+          FAR struct apicmd_recv_s    *c = (FAR struct apicmd_recv_s *)cmd;
+          FAR struct apicmd_recvres_s *r =
+            (FAR struct apicmd_recvres_s *)respbuff;
+
+          ret = do_recv(ntohl(c->sockfd), ntohl(c->recvlen),
+                        ntohl(c->flags), r->recvdata, &err);
+          reslen   = bufflen;
+          payload += ret > 0 ? ret : 0;
+        }
+        break;
+
+      case APICMDID_SOCK_RECVFROM:
+        {
+          FAR struct apicmd_recvfrom_s    *c =
+            (FAR struct apicmd_recvfrom_s *)cmd;
+          FAR struct apicmd_recvfromres_s *r =
+            (FAR struct apicmd_recvfromres_s *)respbuff;
+
+          ret = do_recv(ntohl(c->sockfd), ntohl(c->recvlen),
+                        ntohl(c->flags), r->recvdata, &err);
+
+          memset(&r->from, 0, sizeof(r->from));
+          r->from.ss_family = ALTCOM_AF_INET;
+          r->fromlen = htonl(sizeof(struct altcom_sockaddr_in));
+          reslen     = bufflen;
+          payload   += ret > 0 ? ret : 0;
+        }
+        break;
+
+      case APICMDID_SOCK_SEND:
+        {
+          FAR struct apicmd_send_s *c = (FAR struct apicmd_send_s *)cmd;
+
+          ret = do_send(ntohl(c->sockfd), ntohl(c->datalen), c->senddata,
+                        &err);
+        }
+        break;
+
+      case APICMDID_SOCK_SENDTO:
+        {
+          FAR struct apicmd_sendto_s *c = (FAR struct apicmd_sendto_s *)cmd;
+
+          ret = do_send(ntohl(c->sockfd), ntohl(c->datalen), c->senddata,
+                        &err);
+        }
+        break;
+
+      default:
+        break;
+    }
+
+  advance(g_param.rpc_us + g_param.spi_us_byte * payload);
+
+  res->ret_code = htonl(ret);
+  res->err_code = htonl(err);
+  *resplen      = reslen;
+
+  (void)deliver();
+
+  return hdr->dtlen;
+}
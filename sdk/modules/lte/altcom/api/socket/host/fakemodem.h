@@ -0,0 +1,130 @@
+/****************************************************************************
+ * modules/lte/altcom/api/socket/host/fakemodem.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Simulated modem peer of the altcom socket API. It answers the socket
+ *   commands sent through apicmdgw_send() for stream sockets connected to
+ *   a generated data source and sink, and keeps a modeled clock: every
+ *   command costs a fixed round trip plus its payload on the SPI, and the
+ *   data arrives in the modem at the configured link rate or as scheduled
+ *   messages. Responses of asynchronous select requests are delivered to
+ *   altcom_select_async_exec_callback() as soon as the sockets are ready.
+ *
+ ****************************************************************************/
+
+#ifndef __MODULES_LTE_ALTCOM_API_SOCKET_HOST_FAKEMODEM_H
+#define __MODULES_LTE_ALTCOM_API_SOCKET_HOST_FAKEMODEM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct fakemodem_param_s
+{
+  uint32_t rpc_us;        /* Round trip of one command */
+  double   spi_us_byte;   /* SPI transfer time of one payload byte */
+  double   link_byte_us;  /* Link rate in bytes/usec, 0 for no limit */
+  uint32_t window;        /* Receive window of a modem socket */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Reset the modem with the given parameters */
+
+void fakemodem_init(FAR const struct fakemodem_param_s *param);
+
+/* Let the peer of socket fd send total bytes, then close its side */
+
+void fakemodem_load(int fd, size_t total);
+
+/* Let the peer of socket fd send count messages of msglen bytes, the
+ * first at phase_us and then every period_us.
+ */
+
+void fakemodem_schedule(int fd, uint32_t phase_us, uint32_t period_us,
+                        uint32_t msglen, uint32_t count);
+
+/* Let the time pass until the response of an asynchronous select is
+ * delivered, at most timeout_us. Returns false on timeout.
+ */
+
+bool fakemodem_wait(uint32_t timeout_us);
+
+/* Close socket fd in the modem only, as a reset by the peer does.  An
+ * asynchronous select naming it then fails with ALTCOM_EBADF.
+ */
+
+void fakemodem_drop(int fd);
+
+/* Sum of the delays in usec from the arrival of a scheduled message in the
+ * modem until it was received, and the number of messages received.
+ */
+
+uint64_t fakemodem_latency(FAR uint32_t *msgs);
+
+/* Number of asynchronous select responses delivered */
+
+uint32_t fakemodem_events(void);
+
+/* Number of bytes the peer of socket fd received, and whether they all
+ * matched the generated pattern.
+ */
+
+size_t fakemodem_received(int fd, FAR int *match);
+
+/* Modeled time in usec and number of commands since fakemodem_init() */
+
+uint64_t fakemodem_clock(void);
+uint32_t fakemodem_commands(void);
+
+/* Pattern byte at offset pos of a stream */
+
+static inline uint8_t fakemodem_pattern(size_t pos)
+{
+  return (uint8_t)((pos * 131) + (pos >> 9));
+}
+
+#endif /* __MODULES_LTE_ALTCOM_API_SOCKET_HOST_FAKEMODEM_H */
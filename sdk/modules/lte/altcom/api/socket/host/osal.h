@@ -0,0 +1,105 @@
+/****************************************************************************
+ * modules/lte/altcom/api/socket/host/osal.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* OS abstraction of the LTE library on top of pthreads */
+
+#ifndef __MODULES_LTE_ALTCOM_API_SOCKET_HOST_OSAL_H
+#define __MODULES_LTE_ALTCOM_API_SOCKET_HOST_OSAL_H
+
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define SYS_MALLOC(sz)   malloc(sz)
+#define SYS_FREE(ptr)    free(ptr)
+#define SYS_TIMEO_FEVR   (-1)
+
+typedef pthread_mutex_t sys_mutex_t;
+
+typedef struct
+{
+  int8_t dummy;
+} sys_cremtx_s;
+
+static inline int32_t sys_create_mutex(FAR sys_mutex_t *mutex,
+                                       FAR const sys_cremtx_s *params)
+{
+  return pthread_mutex_init(mutex, NULL) == 0 ? 0 : -1;
+}
+
+static inline int32_t sys_delete_mutex(FAR sys_mutex_t *mutex)
+{
+  return pthread_mutex_destroy(mutex) == 0 ? 0 : -1;
+}
+
+static inline int32_t sys_lock_mutex(FAR sys_mutex_t *mutex)
+{
+  return pthread_mutex_lock(mutex) == 0 ? 0 : -1;
+}
+
+static inline int32_t sys_trylock_mutex(FAR sys_mutex_t *mutex)
+{
+  int ret = pthread_mutex_trylock(mutex);
+
+  return ret == 0 ? 0 : -ret;
+}
+
+static inline int32_t sys_unlock_mutex(FAR sys_mutex_t *mutex)
+{
+  return pthread_mutex_unlock(mutex) == 0 ? 0 : -1;
+}
+
+/* The scheduler lock is a recursive mutex shared by all threads */
+
+static inline pthread_mutex_t *sys_dispatch_lock(void)
+{
+  static pthread_mutex_t lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+  return &lock;
+}
+
+static inline int32_t sys_disable_dispatch(void)
+{
+  return pthread_mutex_lock(sys_dispatch_lock()) == 0 ? 0 : -1;
+}
+
+static inline int32_t sys_enable_dispatch(void)
+{
+  return pthread_mutex_unlock(sys_dispatch_lock()) == 0 ? 0 : -1;
+}
+
+#endif /* __MODULES_LTE_ALTCOM_API_SOCKET_HOST_OSAL_H */
@@ -0,0 +1,461 @@
+/****************************************************************************
+ * modules/lte/altcom/api/socket/host/pollbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark of the socket readiness table against the simulated
+ *   modem of fakemodem.c.  An event loop polls N sockets for POLLIN the
+ *   way NuttX poll() calls the stubsock poll setup and teardown, then
+ *   receives from the ready sockets.  The peer of each socket sends short
+ *   messages periodically.  The loop is run with the select per query of
+ *   stubsock ("select") and with the readiness table ("table"), and the
+ *   modem commands per message and the modeled delay from the arrival of
+ *   a message in the modem until the loop received it are reported.
+ *
+ *   Then the table is checked with a socket closed while the shared
+ *   request covers it, which must not stall the waiters of the other
+ *   sockets, and with a request the modem keeps failing, after which the
+ *   waiters must be woken up with ALTCOM_SOCKREADY_ERROR.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "altcom_socket.h"
+#include "altcom_select.h"
+#include "altcom_select_ext.h"
+#include "altcom_errno.h"
+#include "altcom_sock.h"
+#include "fakemodem.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define POLLBENCH_MSGLEN   100
+#define POLLBENCH_NMSG     50
+#define POLLBENCH_PERIOD   200000  /* usec */
+#define POLLBENCH_TIMEOUT  (10 * POLLBENCH_PERIOD)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pollent_s
+{
+  int                       fd;
+  size_t                    received;
+  bool                      ready;
+  bool                      error;
+  int32_t                   select_id;
+  struct altcom_sockready_s waiter;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct fakemodem_param_s g_param =
+{
+  2000,   /* rpc_us */
+  0.4,    /* spi_us_byte */
+  0,      /* link_byte_us */
+  4096    /* window */
+};
+
+static uint32_t g_selects;
+static uint8_t  g_pollgroup;  /* Group of the waiters of the loop */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(FAR const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-l <usec>] [-n <count>] [-h]\n", progname);
+  fprintf(stderr, "\t-l <usec>: Round trip of one modem command. "
+                  "Default: %u\n", (unsigned)g_param.rpc_us);
+  fprintf(stderr, "\t-n <count>: Messages per socket. Default: %d\n",
+                  POLLBENCH_NMSG);
+  fprintf(stderr, "\t-h: Show this text and exit\n");
+  exit(errcode);
+}
+
+/* Select per query, as stubsock_pollsetup() without the readiness table */
+
+static void select_callback(int32_t ret_code, int32_t err_code, int32_t id,
+                            FAR altcom_fd_set *readset,
+                            FAR altcom_fd_set *writeset,
+                            FAR altcom_fd_set *exceptset, FAR void *priv)
+{
+  FAR struct pollent_s *ent = (FAR struct pollent_s *)priv;
+
+  ent->select_id = -1;
+  if (ret_code > 0 && readset && ALTCOM_FD_ISSET(ent->fd, readset))
+    {
+      ent->ready = true;
+    }
+}
+
+static void select_setup(FAR struct pollent_s *ent)
+{
+  altcom_fd_set readset;
+
+  ALTCOM_FD_ZERO(&readset);
+  ALTCOM_FD_SET(ent->fd, &readset);
+
+  g_selects++;
+  if (altcom_select_nonblock(ent->fd + 1, &readset, NULL, NULL) > 0 &&
+      ALTCOM_FD_ISSET(ent->fd, &readset))
+    {
+      ent->ready = true;
+      return;
+    }
+
+  ALTCOM_FD_ZERO(&readset);
+  ALTCOM_FD_SET(ent->fd, &readset);
+
+  g_selects++;
+  ent->select_id = altcom_select_async(ent->fd + 1, &readset, NULL, NULL,
+                                       select_callback, ent);
+}
+
+static void select_teardown(FAR struct pollent_s *ent)
+{
+  if (ent->select_id != -1)
+    {
+      g_selects++;
+      altcom_select_async_cancel(ent->select_id);
+      ent->select_id = -1;
+    }
+}
+
+/* Readiness table, as stubsock_pollsetup() with CONFIG_LTE_NET_SOCKREADY */
+
+static void table_notify(FAR struct altcom_sockready_s *waiter,
+                         uint8_t ready)
+{
+  FAR struct pollent_s *ent = (FAR struct pollent_s *)waiter->priv;
+
+  ent->ready = true;
+  ent->error = (ready & ALTCOM_SOCKREADY_ERROR) != 0;
+}
+
+static void table_setup(FAR struct pollent_s *ent)
+{
+  ent->waiter.sockfd = ent->fd;
+  ent->waiter.events = ALTCOM_SOCKREADY_READ;
+  ent->waiter.notify = table_notify;
+  ent->waiter.group  = &g_pollgroup;
+  ent->waiter.priv   = ent;
+
+  if (altcom_sockready_poll(&ent->waiter) > 0)
+    {
+      ent->ready = true;
+    }
+}
+
+static void table_teardown(FAR struct pollent_s *ent)
+{
+  altcom_sockready_unpoll(&ent->waiter);
+}
+
+static int run(int nsock, uint32_t nmsg, bool table)
+{
+  struct pollent_s         ent[ALTCOM_NSOCKET];
+  struct altcom_pollstat_s before;
+  struct altcom_pollstat_s after;
+  struct altcom_timeval    tv;
+  uint8_t                  buf[1500];
+  size_t                   total = (size_t)nsock * nmsg * POLLBENCH_MSGLEN;
+  size_t                   done = 0;
+  uint64_t                 latency;
+  uint32_t                 msgs;
+  uint32_t                 loops = 0;
+  uint32_t                 pollcmds;
+  bool                     any;
+  int                      ret;
+  int                      i;
+
+  fakemodem_init(&g_param);
+  g_selects = 0;
+  (void)altcom_getpollstat(&before);
+
+  for (i = 0; i < nsock; i++)
+    {
+      memset(&ent[i], 0, sizeof(struct pollent_s));
+      ent[i].fd        = altcom_socket(ALTCOM_AF_INET, ALTCOM_SOCK_STREAM, 0);
+      ent[i].select_id = -1;
+      if (ent[i].fd < 0)
+        {
+          fprintf(stderr, "ERROR: socket failed: %ld\n",
+                  (long)altcom_errno());
+          return ERROR;
+        }
+
+      fakemodem_schedule(ent[i].fd, 1000 + i * POLLBENCH_PERIOD / nsock,
+                         POLLBENCH_PERIOD, POLLBENCH_MSGLEN, nmsg);
+    }
+
+  while (done < total)
+    {
+      loops++;
+
+      /* poll(): set up every descriptor, wait if none is ready, then
+       * tear every descriptor down.
+       */
+
+      any = false;
+      for (i = 0; i < nsock; i++)
+        {
+          ent[i].ready = false;
+        }
+
+      for (i = 0; i < nsock; i++)
+        {
+          if (ent[i].received < (size_t)nmsg * POLLBENCH_MSGLEN)
+            {
+              table ? table_setup(&ent[i]) : select_setup(&ent[i]);
+            }
+        }
+
+      for (i = 0; i < nsock; i++)
+        {
+          any = any || ent[i].ready;
+        }
+
+      while (!any)
+        {
+          if (!fakemodem_wait(POLLBENCH_TIMEOUT))
+            {
+              fprintf(stderr, "ERROR: poll timed out\n");
+              return ERROR;
+            }
+
+          for (i = 0; i < nsock; i++)
+            {
+              any = any || ent[i].ready;
+            }
+        }
+
+      for (i = 0; i < nsock; i++)
+        {
+          table ? table_teardown(&ent[i]) : select_teardown(&ent[i]);
+        }
+
+      /* Receive from the ready sockets as stubsock does */
+
+      for (i = 0; i < nsock; i++)
+        {
+          if (!ent[i].ready)
+            {
+              continue;
+            }
+
+          altcom_fcntl(ent[i].fd, ALTCOM_SETFL, 0);
+
+          tv.tv_sec  = 0;
+          tv.tv_usec = 0;
+          altcom_setsockopt(ent[i].fd, ALTCOM_SOL_SOCKET, ALTCOM_SO_RCVTIMEO,
+                            &tv, sizeof(tv));
+
+          ret = altcom_recvfrom(ent[i].fd, buf, sizeof(buf), 0, NULL, NULL);
+          if (ret <= 0)
+            {
+              fprintf(stderr, "ERROR: recvfrom failed: %d\n", ret);
+              return ERROR;
+            }
+
+          ent[i].received += ret;
+          done            += ret;
+        }
+    }
+
+  latency = fakemodem_latency(&msgs);
+
+  if (table)
+    {
+      (void)altcom_getpollstat(&after);
+      pollcmds = after.rpc_count - before.rpc_count;
+    }
+  else
+    {
+      pollcmds = g_selects;
+    }
+
+  printf("%-6s %2d socks %6lu loops  poll %6.2f cmds/msg  "
+         "total %6.2f cmds/msg  delay %7.2f ms\n",
+         table ? "table" : "select", nsock, (unsigned long)loops,
+         (double)pollcmds / msgs, (double)fakemodem_commands() / msgs,
+         (double)latency / msgs / 1000.0);
+
+  for (i = 0; i < nsock; i++)
+    {
+      altcom_close(ent[i].fd);
+    }
+
+  return msgs == (uint32_t)nsock * nmsg ? OK : ERROR;
+}
+
+/* Two sockets wait in one request. The second one is closed, either by
+ * altcom_close() or by the modem alone (drop), then a message arrives on
+ * the first.
+ */
+
+static int check_close(bool drop)
+{
+  struct pollent_s ent[2];
+  bool             ok;
+  int              i;
+
+  fakemodem_init(&g_param);
+
+  for (i = 0; i < 2; i++)
+    {
+      memset(&ent[i], 0, sizeof(struct pollent_s));
+      ent[i].fd = altcom_socket(ALTCOM_AF_INET, ALTCOM_SOCK_STREAM, 0);
+      if (ent[i].fd < 0)
+        {
+          fprintf(stderr, "ERROR: socket failed: %ld\n",
+                  (long)altcom_errno());
+          return ERROR;
+        }
+
+      fakemodem_schedule(ent[i].fd,
+                         i == 0 ? POLLBENCH_PERIOD : 100 * POLLBENCH_TIMEOUT,
+                         POLLBENCH_PERIOD, POLLBENCH_MSGLEN, 1);
+      table_setup(&ent[i]);
+    }
+
+  if (drop)
+    {
+      fakemodem_drop(ent[1].fd);
+    }
+  else
+    {
+      table_teardown(&ent[1]);
+      altcom_close(ent[1].fd);
+    }
+
+  (void)fakemodem_wait(POLLBENCH_TIMEOUT);
+
+  if (drop)
+    {
+      /* Every waiter learns that its poll has to be set up again */
+
+      ok = ent[0].ready && ent[0].error && ent[1].ready && ent[1].error;
+      printf("request failing: waiters %s\n",
+             ok ? "woken up with error" : "NOT WOKEN UP");
+      table_teardown(&ent[1]);
+      altcom_close(ent[1].fd);
+    }
+  else
+    {
+      ok = ent[0].ready && !ent[0].error;
+      printf("socket closed while covered: other socket %s\n",
+             ok ? "woken up" : "NOT WOKEN UP");
+    }
+
+  table_teardown(&ent[0]);
+  altcom_close(ent[0].fd);
+
+  return ok ? OK : ERROR;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, FAR char **argv)
+{
+  static const int nsocks[] =
+  {
+    1, 2, 4, 8
+  };
+
+  struct altcom_pollstat_s stat;
+  uint32_t nmsg = POLLBENCH_NMSG;
+  int ret = OK;
+  int option;
+  int i;
+
+  while ((option = getopt(argc, argv, ":l:n:h")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'l':
+            g_param.rpc_us = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'n':
+            nmsg = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  for (i = 0; i < sizeof(nsocks) / sizeof(nsocks[0]); i++)
+    {
+      ret |= run(nsocks[i], nmsg, false);
+      ret |= run(nsocks[i], nmsg, true);
+    }
+
+  ret |= check_close(false);
+  ret |= check_close(true);
+
+  (void)altcom_getpollstat(&stat);
+  printf("table: %lu polls, %lu local, %lu cmds, %lu cmds saved\n",
+         (unsigned long)stat.polls, (unsigned long)stat.local,
+         (unsigned long)stat.rpc_count, (unsigned long)stat.rpc_saved);
+
+  return ret == OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,57 @@
+/****************************************************************************
+ * modules/lte/altcom/api/socket/host/sdk/config.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Minimal configuration for building the altcom socket API on the host.
+ * CONFIG_LTE_NET_SOCKBUF is given by the Makefile.
+ */
+
+#ifndef __MODULES_LTE_ALTCOM_API_SOCKET_HOST_SDK_CONFIG_H
+#define __MODULES_LTE_ALTCOM_API_SOCKET_HOST_SDK_CONFIG_H
+
+#include <nuttx/compiler.h>
+
+#include <stddef.h>
+
+#define OK    0
+#define ERROR -1
+
+#ifdef CONFIG_LTE_NET_SOCKBUF
+#  ifndef CONFIG_LTE_NET_SOCKBUF_RECVWINDOW
+#    define CONFIG_LTE_NET_SOCKBUF_RECVWINDOW 4500
+#  endif
+#  define CONFIG_LTE_NET_SOCKBUF_SENDDELAY 200
+#endif
+
+#endif /* __MODULES_LTE_ALTCOM_API_SOCKET_HOST_SDK_CONFIG_H */
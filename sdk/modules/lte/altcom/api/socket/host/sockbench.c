@@ -0,0 +1,408 @@
+/****************************************************************************
+ * modules/lte/altcom/api/socket/host/sockbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark of the altcom socket API against the simulated modem of
+ *   fakemodem.c.  Each workload calls the API in the same sequence as the
+ *   stubsock layer does (set the mode, set the timeout, then transfer) and
+ *   reports the number of modem commands, the modeled transfer rate and
+ *   the result of verifying the transferred data.
+ *
+ *   Built with CONFIG_LTE_NET_SOCKBUF as sockbench and without it as
+ *   sockbench-direct.  sockbench also checks that a non-blocking flush
+ *   does not wait for a writer holding the send buffer, and that a
+ *   MSG_WAITALL receive is not cut short by the read-ahead cache.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "altcom_socket.h"
+#include "altcom_sock.h"
+#include "altcom_errno.h"
+#include "fakemodem.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SOCKBENCH_DEFSIZE   (256 * 1024)
+#define SOCKBENCH_MAXPIECE  1500
+#define SOCKBENCH_MOREEVERY 8
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct fakemodem_param_s g_param =
+{
+  2000,   /* rpc_us */
+  0.4,    /* spi_us_byte */
+  0,      /* link_byte_us */
+  4096    /* window */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(FAR const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-s <size>] [-l <usec>] [-r <KB/sec>] [-h]\n",
+                  progname);
+  fprintf(stderr, "\t-s <size>: Number of bytes per workload. Default: %d\n",
+                  SOCKBENCH_DEFSIZE);
+  fprintf(stderr, "\t-l <usec>: Round trip of one modem command. "
+                  "Default: %u\n", (unsigned)g_param.rpc_us);
+  fprintf(stderr, "\t-r <KB/sec>: Link rate, 0 for no limit. Default: 0\n");
+  fprintf(stderr, "\t-h: Show this text and exit\n");
+  exit(errcode);
+}
+
+static void set_mode(int fd, int option)
+{
+  struct altcom_timeval tv;
+
+  /* Same calls as stubsock makes before every transfer */
+
+  altcom_fcntl(fd, ALTCOM_SETFL, 0);
+
+  tv.tv_sec  = 0;
+  tv.tv_usec = 0;
+  altcom_setsockopt(fd, ALTCOM_SOL_SOCKET, option, &tv, sizeof(tv));
+}
+
+static void report(FAR const char *name, int fd, size_t size, bool ok)
+{
+  struct altcom_sockstat_s stat;
+  double sec = (double)fakemodem_clock() / 1e6;
+
+  memset(&stat, 0, sizeof(stat));
+  (void)altcom_getsockstat(fd, &stat);
+
+  printf("%-18s %7lu cmds %8.1f cmds/MB %8.1f KB/s  cached %3lu%%  "
+         "merged %6lu  %s\n",
+         name, (unsigned long)fakemodem_commands(),
+         (double)fakemodem_commands() * 1024.0 * 1024.0 / (double)size,
+         (double)size / 1024.0 / sec,
+         stat.rx_bytes ?
+           (unsigned long)(100ull * stat.rx_cached / stat.rx_bytes) : 0ul,
+         (unsigned long)stat.tx_merged, ok ? "OK" : "MISMATCH");
+}
+
+static int download(size_t size, size_t readsz)
+{
+  uint8_t buf[SOCKBENCH_MAXPIECE];
+  char name[32];
+  size_t pos = 0;
+  bool ok = true;
+  int ret;
+  int fd;
+  int i;
+
+  fakemodem_init(&g_param);
+
+  fd = altcom_socket(ALTCOM_AF_INET, ALTCOM_SOCK_STREAM, 0);
+  if (fd < 0)
+    {
+      fprintf(stderr, "ERROR: socket failed: %ld\n", (long)altcom_errno());
+      return ERROR;
+    }
+
+  fakemodem_load(fd, size);
+
+  for (; ; )
+    {
+      set_mode(fd, ALTCOM_SO_RCVTIMEO);
+      ret = altcom_recvfrom(fd, buf, readsz, 0, NULL, NULL);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      for (i = 0; i < ret; i++)
+        {
+          if (buf[i] != fakemodem_pattern(pos + i))
+            {
+              ok = false;
+            }
+        }
+
+      pos += ret;
+    }
+
+  ok = ok && ret == 0 && pos == size;
+
+  snprintf(name, sizeof(name), "recv %4lu", (unsigned long)readsz);
+  report(name, fd, size, ok);
+
+  altcom_close(fd);
+  return ok ? OK : ERROR;
+}
+
+static int upload(size_t size, size_t piece, bool more)
+{
+  uint8_t buf[SOCKBENCH_MAXPIECE];
+  char name[32];
+  size_t pos = 0;
+  size_t n;
+  size_t received;
+  unsigned long count = 0;
+  int match;
+  int flags;
+  int ret;
+  int fd;
+  size_t i;
+
+  fakemodem_init(&g_param);
+
+  fd = altcom_socket(ALTCOM_AF_INET, ALTCOM_SOCK_STREAM, 0);
+  if (fd < 0)
+    {
+      fprintf(stderr, "ERROR: socket failed: %ld\n", (long)altcom_errno());
+      return ERROR;
+    }
+
+  while (pos < size)
+    {
+      n = size - pos < piece ? size - pos : piece;
+      for (i = 0; i < n; i++)
+        {
+          buf[i] = fakemodem_pattern(pos + i);
+        }
+
+      /* Small writes of one message are marked with MSG_MORE except for
+       * the last one.
+       */
+
+      flags = 0;
+      if (more && ++count % SOCKBENCH_MOREEVERY && pos + n < size)
+        {
+          flags = ALTCOM_MSG_MORE;
+        }
+
+      set_mode(fd, ALTCOM_SO_SNDTIMEO);
+      ret = altcom_send(fd, buf, n, flags);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pos += ret;
+    }
+
+  received = fakemodem_received(fd, &match);
+
+  snprintf(name, sizeof(name), "send %4lu%s", (unsigned long)piece,
+           more ? " more" : "");
+  report(name, fd, size, match && received == size);
+
+  altcom_close(fd);
+  return match && received == size ? OK : ERROR;
+}
+
+#ifdef CONFIG_LTE_NET_SOCKBUF
+static int recv_waitall(size_t size, size_t readsz)
+{
+  uint8_t buf[SOCKBENCH_MAXPIECE];
+  size_t pos = 0;
+  size_t want;
+  bool ok = true;
+  int flags = 0;
+  int ret;
+  int fd;
+  int i;
+
+  fakemodem_init(&g_param);
+
+  fd = altcom_socket(ALTCOM_AF_INET, ALTCOM_SOCK_STREAM, 0);
+  if (fd < 0)
+    {
+      fprintf(stderr, "ERROR: socket failed: %ld\n", (long)altcom_errno());
+      return ERROR;
+    }
+
+  fakemodem_load(fd, size);
+
+  /* A small read fills the cache, then MSG_WAITALL reads drain it and
+   * must each return the full size until the end of the stream.
+   */
+
+  for (want = 64; ; want = readsz, flags = ALTCOM_MSG_WAITALL)
+    {
+      set_mode(fd, ALTCOM_SO_RCVTIMEO);
+      ret = altcom_recvfrom(fd, buf, want, flags, NULL, NULL);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      if (ret != want && pos + ret != size)
+        {
+          ok = false;
+        }
+
+      for (i = 0; i < ret; i++)
+        {
+          if (buf[i] != fakemodem_pattern(pos + i))
+            {
+              ok = false;
+            }
+        }
+
+      pos += ret;
+    }
+
+  ok = ok && ret == 0 && pos == size;
+  printf("recv %lu waitall after the cache: %s\n", (unsigned long)readsz,
+         ok ? "OK" : "SHORT OR MISMATCH");
+
+  altcom_close(fd);
+  return ok ? OK : ERROR;
+}
+
+static int flush_busy(void)
+{
+  FAR struct altcom_socket_s *fsock;
+  uint8_t buf[64];
+  size_t received;
+  int match;
+  size_t i;
+  int busy;
+  int ret;
+  int fd;
+
+  fakemodem_init(&g_param);
+
+  fd = altcom_socket(ALTCOM_AF_INET, ALTCOM_SOCK_STREAM, 0);
+  if (fd < 0)
+    {
+      fprintf(stderr, "ERROR: socket failed: %ld\n", (long)altcom_errno());
+      return ERROR;
+    }
+
+  for (i = 0; i < sizeof(buf); i++)
+    {
+      buf[i] = fakemodem_pattern(i);
+    }
+
+  set_mode(fd, ALTCOM_SO_SNDTIMEO);
+  altcom_send(fd, buf, sizeof(buf), ALTCOM_MSG_MORE);
+
+  /* As if a writer waited for the modem with the buffer locked */
+
+  fsock = altcom_sockfd_socket(fd);
+  sys_lock_mutex(&fsock->sockbuf->txlock);
+  ret = altcom_sockbuf_flush(fd, true);
+  busy = (ret < 0) && (altcom_errno() == ALTCOM_EAGAIN);
+  sys_unlock_mutex(&fsock->sockbuf->txlock);
+
+  ret = altcom_sockbuf_flush(fd, true);
+  received = fakemodem_received(fd, &match);
+
+  printf("flush with the buffer locked: %s, then %s\n",
+         busy ? "EAGAIN" : "NOT EAGAIN",
+         ret == 0 && match && received == sizeof(buf) ? "sent" : "NOT SENT");
+
+  altcom_close(fd);
+  return busy && ret == 0 && match && received == sizeof(buf) ? OK : ERROR;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, FAR char **argv)
+{
+  size_t size = SOCKBENCH_DEFSIZE;
+  int ret = OK;
+  int option;
+
+  while ((option = getopt(argc, argv, ":s:l:r:h")) != ERROR)
+    {
+      switch (option)
+        {
+          case 's':
+            size = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'l':
+            g_param.rpc_us = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'r':
+            g_param.link_byte_us = strtod(optarg, NULL) * 1024.0 / 1e6;
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+#ifdef CONFIG_LTE_NET_SOCKBUF
+  printf("buffered, read window %d\n", CONFIG_LTE_NET_SOCKBUF_RECVWINDOW);
+#else
+  printf("direct\n");
+#endif
+
+  ret |= download(size, 64);
+  ret |= download(size, 512);
+  ret |= download(size, 1500);
+  ret |= upload(size, 64, true);
+  ret |= upload(size, 1500, false);
+#ifdef CONFIG_LTE_NET_SOCKBUF
+  ret |= recv_waitall(size, 1000);
+  ret |= flush_busy();
+#endif
+
+  return ret == OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
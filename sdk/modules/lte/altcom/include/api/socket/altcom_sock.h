@@ -40,8 +40,16 @@
  * Included Files
  ****************************************************************************/
 
+#include <sdk/config.h>
+
+#include <stdbool.h>
+
 #include "altcom_socket.h"
 #include "altcom_select.h"
+#ifdef CONFIG_LTE_NET_SOCKBUF
+#  include "osal.h"
+#  include "apicmd_sendto.h"
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -50,15 +58,66 @@
 #define ALTCOM_SOCK_TIMEVAL2MS(ptv) \
   ((ptv->tv_sec * 1000L) + (ptv->tv_usec / 1000L))
 
+#ifdef CONFIG_LTE_NET_SOCKREADY
+#  define ALTCOM_SOCKREADY_READ  (0x01)
+#  define ALTCOM_SOCKREADY_WRITE (0x02)
+#  define ALTCOM_SOCKREADY_ERROR (0x04) /* Notified only, poll again */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_LTE_NET_SOCKBUF
+/* Read-ahead cache and send aggregation buffer of a stream socket.
+ * The receive side is used by the receiving task only. The send side is
+ * also flushed by other tasks, so it is protected by txlock.
+ */
+
+struct altcom_sockbuf_s
+{
+  sys_mutex_t                    txlock;
+  uint16_t                       txlen;
+  uint16_t                       rxhead;
+  uint16_t                       rxlen;
+  altcom_socklen_t               fromlen;
+  struct altcom_sockaddr_storage from;
+  uint8_t                        txbuf[APICMD_SENDTO_SENDDATA_LENGTH];
+  uint8_t                        rxbuf[CONFIG_LTE_NET_SOCKBUF_RECVWINDOW];
+};
+#endif
+
+#ifdef CONFIG_LTE_NET_SOCKREADY
+/* Poll request waiting in the readiness table. notify is called once,
+ * from the task delivering the modem event, when one of the events
+ * becomes ready, unless altcom_sockready_unpoll() is called first.
+ * Waiters of one poll call share the same group.
+ */
+
+struct altcom_sockready_s;
+typedef void (*altcom_sockready_notify_t)(
+  FAR struct altcom_sockready_s *waiter, uint8_t ready);
+
+struct altcom_sockready_s
+{
+  FAR struct altcom_sockready_s *next;
+  int                           sockfd;
+  uint8_t                       events;  /* ALTCOM_SOCKREADY_* */
+  altcom_sockready_notify_t     notify;
+  FAR void                      *group;
+  FAR void                      *priv;
+};
+#endif
+
 struct altcom_socket_s
 {
-  uint8_t               flags;
-  struct altcom_timeval sendtimeo;
-  struct altcom_timeval recvtimeo;
+  uint8_t                      flags;
+  struct altcom_timeval        sendtimeo;
+  struct altcom_timeval        recvtimeo;
+  struct altcom_sockstat_s     stat;
+#ifdef CONFIG_LTE_NET_SOCKBUF
+  FAR struct altcom_sockbuf_s *sockbuf;
+#endif
 };
 
 /****************************************************************************
@@ -108,4 +167,112 @@ int altcom_select_block(int maxfdp1, altcom_fd_set *readset,
                         altcom_fd_set *writeset, altcom_fd_set *exceptset,
                         struct altcom_timeval *timeout);
 
+#ifdef CONFIG_LTE_NET_SOCKBUF
+/****************************************************************************
+ * Name: altcom_sockbuf_alloc
+ *
+ * Description:
+ *   Attach a read-ahead cache and a send aggregation buffer to a stream
+ *   socket. On allocation failure the socket works unbuffered.
+ *
+ ****************************************************************************/
+
+void altcom_sockbuf_alloc(FAR struct altcom_socket_s *fsock);
+
+/****************************************************************************
+ * Name: altcom_sockbuf_free
+ *
+ * Description:
+ *   Release the buffers of a socket. Cached and held data is discarded.
+ *
+ ****************************************************************************/
+
+void altcom_sockbuf_free(FAR struct altcom_socket_s *fsock);
+
+/****************************************************************************
+ * Name: altcom_sockbuf_readable
+ *
+ * Description:
+ *   Return the number of bytes in the read-ahead cache of a socket.
+ *
+ ****************************************************************************/
+
+int altcom_sockbuf_readable(int sockfd);
+
+/****************************************************************************
+ * Name: altcom_sockbuf_pending
+ *
+ * Description:
+ *   Return the number of bytes held in the send aggregation buffer.
+ *
+ ****************************************************************************/
+
+int altcom_sockbuf_pending(int sockfd);
+
+/****************************************************************************
+ * Name: altcom_sockbuf_flush
+ *
+ * Description:
+ *   Send the data held in the send aggregation buffer of a socket.
+ *   If nonblock is true, neither the modem nor a writer holding the
+ *   buffer is waited for, and -1 with ALTCOM_EAGAIN is returned when the
+ *   data cannot be sent now.
+ *
+ ****************************************************************************/
+
+int altcom_sockbuf_flush(int sockfd, bool nonblock);
+#endif
+
+#ifdef CONFIG_LTE_NET_SOCKREADY
+/****************************************************************************
+ * Name: altcom_sockready_poll
+ *
+ * Description:
+ *   Query the readiness of a socket in the readiness table. If none of
+ *   waiter->events is known to be ready, the waiter is registered and the
+ *   shared asynchronous select request is renewed only if it does not
+ *   cover the socket yet.
+ *
+ * Returned Value:
+ *   The ready events if some are ready now, 0 if the waiter is registered,
+ *   or -1 with the errno set on failure.
+ *
+ ****************************************************************************/
+
+int altcom_sockready_poll(FAR struct altcom_sockready_s *waiter);
+
+/****************************************************************************
+ * Name: altcom_sockready_unpoll
+ *
+ * Description:
+ *   Remove a waiter registered by altcom_sockready_poll(). No modem
+ *   command is sent, the shared select request stays for the next poll.
+ *
+ ****************************************************************************/
+
+void altcom_sockready_unpoll(FAR struct altcom_sockready_s *waiter);
+
+/****************************************************************************
+ * Name: altcom_sockready_consume
+ *
+ * Description:
+ *   Forget that the events of a socket are ready. Called by the transfer
+ *   functions, after which the readiness is known only from the modem.
+ *
+ ****************************************************************************/
+
+void altcom_sockready_consume(int sockfd, uint8_t events);
+
+/****************************************************************************
+ * Name: altcom_sockready_reset
+ *
+ * Description:
+ *   Clear the readiness state of a descriptor created or closed. The
+ *   select request is replaced if it covers the descriptor.
+ *
+ ****************************************************************************/
+
+void altcom_sockready_reset(int sockfd);
+#endif
+
 #endif /* __MODULES_LTE_ALTCOM_INCLUDE_API_SOCKET_ALTCOM_SOCK_H */
@@ -58,6 +58,16 @@ typedef void (*altcom_select_async_cb_t)(int32_t ret_code, int32_t err_code,
                                          altcom_fd_set *exceptset,
                                          void *priv);
 
+/* Counters of the socket readiness table (CONFIG_LTE_NET_SOCKREADY) */
+
+struct altcom_pollstat_s
+{
+  uint32_t polls;      /* Readiness queries of poll() */
+  uint32_t local;      /* Queries answered without a modem command */
+  uint32_t rpc_count;  /* Select commands sent for the queries */
+  uint32_t rpc_saved;  /* Commands saved compared with selecting per query */
+};
+
 
 #ifdef __cplusplus
 #define EXTERN extern "C"
@@ -95,6 +105,16 @@ int altcom_select_async_exec_callback(int32_t id, int32_t ret_code,
 
 int altcom_select_async_cancel(int id);
 
+/****************************************************************************
+ * Name: altcom_getpollstat
+ *
+ * Description:
+ *   Get the counters of the socket readiness table.
+ *
+ ****************************************************************************/
+
+int altcom_getpollstat(struct altcom_pollstat_s *stat);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -193,6 +193,19 @@ struct altcom_timeval
   long               tv_usec;
 };
 
+/* Per-socket transfer counters. These are cleared when the socket is
+ * created and read with altcom_getsockstat().
+ */
+
+struct altcom_sockstat_s
+{
+  uint32_t           rpc_count;   /* Modem commands issued by the data path */
+  uint32_t           rx_bytes;    /* Bytes returned to the receiver */
+  uint32_t           tx_bytes;    /* Bytes accepted from the sender */
+  uint32_t           rx_cached;   /* Bytes returned without a modem command */
+  uint32_t           tx_merged;   /* Writes merged into a later modem command */
+};
+
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C"
@@ -245,6 +258,12 @@ int altcom_fcntl(int sockfd, int cmd, int val);
 int altcom_getsockname(int sockfd, struct altcom_sockaddr *addr,
                        altcom_socklen_t *addrlen);
 
+/****************************************************************************
+ * Name: altcom_getsockstat
+ ****************************************************************************/
+
+int altcom_getsockstat(int sockfd, struct altcom_sockstat_s *stat);
+
 /****************************************************************************
  * Name: altcom_getsockopt
  ****************************************************************************/
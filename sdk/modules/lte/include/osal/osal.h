@@ -333,6 +333,24 @@ int32_t sys_delete_mutex(FAR sys_mutex_t *mutex);
 
 int32_t sys_lock_mutex(FAR sys_mutex_t *mutex);
 
+/****************************************************************************
+ * Name: sys_trylock_mutex
+ *
+ * Description:
+ *   Lock a mutex if it is not held by another task, without waiting.
+ *
+ * Input Parameters:
+ *   mutex The handle of the mutex to be locked.
+ *
+ * Returned Value:
+ *   If the mutex was locked successfully then 0 is returned.
+ *   If the mutex is held by another task then -EBUSY is returned.
+ *   Otherwise negative value is returned.
+ *
+ ****************************************************************************/
+
+int32_t sys_trylock_mutex(FAR sys_mutex_t *mutex);
+
 /****************************************************************************
  * Name: sys_unlock_mutex
  *
@@ -45,7 +45,11 @@
 
 #ifdef CONFIG_NET
 
+#include <stdbool.h>
 #include <netdb.h>
+#if defined(CONFIG_LTE_NET_SOCKBUF) && defined(CONFIG_SCHED_LPWORK)
+#  include <nuttx/wqueue.h>
+#endif
 #include "socket/socket.h"
 #include "stubsock_mem.h"
 #include "altcom_socket.h"
@@ -57,14 +61,22 @@
 
 #define SOCK_SUTBSOCK_TYPE  0x6f
 
+#if defined(CONFIG_LTE_NET_SOCKBUF) && defined(CONFIG_SCHED_LPWORK)
+#  define STUBSOCK_SENDDELAY_WORK 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
 struct stubsock_conn_s
 {
-  int32_t  stubsockid; /* Used for altcom socket */
-  uint16_t flags;      /* Socket state flags */
+  int32_t       stubsockid; /* Used for altcom socket */
+  uint16_t      flags;      /* Socket state flags */
+#ifdef STUBSOCK_SENDDELAY_WORK
+  struct work_s flushwork;  /* Sends data held by MSG_MORE */
+  volatile bool flushing;   /* The flush worker is sending */
+#endif
 };
 
 #ifdef __cplusplus
@@ -105,6 +117,37 @@ FAR struct stubsock_conn_s *stubsock_alloc(void);
 
 void stubsock_free(FAR struct stubsock_conn_s *conn);
 
+/****************************************************************************
+ * Name: stubsock_sched_flush()
+ *
+ * Description:
+ *   Send the data held in the send aggregation buffer of the socket after
+ *   CONFIG_LTE_NET_SOCKBUF_SENDDELAY msec.
+ *
+ ****************************************************************************/
+
+#ifdef STUBSOCK_SENDDELAY_WORK
+void stubsock_sched_flush(FAR struct stubsock_conn_s *conn);
+#else
+#  define stubsock_sched_flush(conn)
+#endif
+
+/****************************************************************************
+ * Name: stubsock_cancel_flush()
+ *
+ * Description:
+ *   Cancel the delayed send of the socket and wait for a flush worker
+ *   already running to finish, so that neither the connection nor its
+ *   send aggregation buffer is used by the worker afterwards.
+ *
+ ****************************************************************************/
+
+#ifdef STUBSOCK_SENDDELAY_WORK
+void stubsock_cancel_flush(FAR struct stubsock_conn_s *conn);
+#else
+#  define stubsock_cancel_flush(conn)
+#endif
+
 /****************************************************************************
  * Name: stubsock_convdomain_remote()
  ****************************************************************************/
@@ -74,6 +74,12 @@ int stubsock_close(FAR struct socket *psock)
   int                            ret;
   int                            err;
 
+  /* altcom_close() frees the send aggregation buffer the flush worker
+   * uses
+   */
+
+  stubsock_cancel_flush(conn);
+
   ret = altcom_close(conn->stubsockid);
 
   /* Free the connection structure */
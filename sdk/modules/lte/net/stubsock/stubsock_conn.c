@@ -49,20 +49,95 @@
 #include <errno.h>
 #include <debug.h>
 #include <string.h>
+#include <unistd.h>
+#include <sched.h>
 
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
 #include "devspecsock/devspecsock.h"
 #include "stubsock.h"
+#include "altcom_sock.h"
+#include "altcom_errno.h"
 #include "dbg_if.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef STUBSOCK_SENDDELAY_WORK
+#  define STUBSOCK_FLUSHWAIT_USEC  (1000)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 struct devspecsock_sockif_s g_ds_sockif;
 
+#ifdef STUBSOCK_SENDDELAY_WORK
+/* Connections with a flush worker queued or running. The worker only uses
+ * its connection while it is found here, so a worker that starts after
+ * stubsock_cancel_flush() never touches a freed connection.
+ */
+
+static FAR struct stubsock_conn_s *g_flushconn[ALTCOM_NSOCKET];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef STUBSOCK_SENDDELAY_WORK
+/****************************************************************************
+ * Name: stubsock_flush_worker()
+ ****************************************************************************/
+
+static void stubsock_flush_worker(FAR void *arg)
+{
+  FAR struct stubsock_conn_s *conn = (FAR struct stubsock_conn_s *)arg;
+  bool                       retry;
+  int                        i;
+
+  sched_lock();
+
+  for (i = 0; i < ALTCOM_NSOCKET; i++)
+    {
+      if (g_flushconn[i] == conn)
+        {
+          break;
+        }
+    }
+
+  if (i == ALTCOM_NSOCKET)
+    {
+      /* The socket has been closed */
+
+      sched_unlock();
+      return;
+    }
+
+  conn->flushing = true;
+  sched_unlock();
+
+  /* Do not block the work queue. Retry later if the modem or a writer
+   * holding the buffer is busy.
+   */
+
+  retry = (altcom_sockbuf_flush(conn->stubsockid, true) < 0) &&
+          (altcom_errno() == ALTCOM_EAGAIN);
+
+  sched_lock();
+  conn->flushing = false;
+  if (retry)
+    {
+      stubsock_sched_flush(conn);
+    }
+
+  sched_unlock();
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -96,6 +171,8 @@ FAR struct stubsock_conn_s *stubsock_alloc(void)
 
 void stubsock_free(FAR struct stubsock_conn_s *conn)
 {
+  stubsock_cancel_flush(conn);
+
   STUBSOCK_MEM_FREE(conn);
 }
 
@@ -123,4 +200,59 @@ void stubsock_finalize(void)
   STUBSOCK_MEM_FIN();
 }
 
+#ifdef STUBSOCK_SENDDELAY_WORK
+/****************************************************************************
+ * Name: stubsock_sched_flush()
+ ****************************************************************************/
+
+void stubsock_sched_flush(FAR struct stubsock_conn_s *conn)
+{
+  if ((conn->stubsockid < 0) || (conn->stubsockid >= ALTCOM_NSOCKET))
+    {
+      return;
+    }
+
+  sched_lock();
+
+  if ((altcom_sockbuf_pending(conn->stubsockid) > 0) &&
+      work_available(&conn->flushwork))
+    {
+      g_flushconn[conn->stubsockid] = conn;
+      (void)work_queue(LPWORK, &conn->flushwork, stubsock_flush_worker,
+                       conn, MSEC2TICK(CONFIG_LTE_NET_SOCKBUF_SENDDELAY));
+    }
+
+  sched_unlock();
+}
+
+/****************************************************************************
+ * Name: stubsock_cancel_flush()
+ ****************************************************************************/
+
+void stubsock_cancel_flush(FAR struct stubsock_conn_s *conn)
+{
+  int i;
+
+  sched_lock();
+
+  for (i = 0; i < ALTCOM_NSOCKET; i++)
+    {
+      if (g_flushconn[i] == conn)
+        {
+          g_flushconn[i] = NULL;
+        }
+    }
+
+  (void)work_cancel(LPWORK, &conn->flushwork);
+  sched_unlock();
+
+  /* A worker already sending keeps using the connection until it is done */
+
+  while (conn->flushing)
+    {
+      usleep(STUBSOCK_FLUSHWAIT_USEC);
+    }
+}
+#endif
+
 #endif /* CONFIG_NET && CONFIG_NET_DEV_SPEC_SOCK */
@@ -72,12 +72,16 @@ struct stubsock_poll_s
   FAR struct socket *psock;        /* Needed to handle loss of connection */
   FAR struct pollfd *fds;          /* Needed to handle poll events */
   int32_t           select_id;     /* Needed to handle select async */
+#ifdef CONFIG_LTE_NET_SOCKREADY
+  struct altcom_sockready_s waiter; /* Needed to wait in readiness table */
+#endif
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifndef CONFIG_LTE_NET_SOCKREADY
 static void select_async_callback(int32_t ret_code, int32_t err_code,
                                   int32_t id, FAR altcom_fd_set *readset,
                                   FAR altcom_fd_set *writeset,
@@ -140,6 +144,98 @@ static void select_async_callback(int32_t ret_code, int32_t err_code,
       sem_post(info->fds->sem);
     }
 }
+#endif
+
+#ifdef CONFIG_LTE_NET_SOCKREADY
+/****************************************************************************
+ * Name: sockready_notify
+ ****************************************************************************/
+
+static void sockready_notify(FAR struct altcom_sockready_s *waiter,
+                             uint8_t ready)
+{
+  FAR struct pollfd *fds = (FAR struct pollfd *)waiter->priv;
+
+  if (ready & ALTCOM_SOCKREADY_READ)
+    {
+      fds->revents |= POLLIN;
+    }
+
+  if (ready & ALTCOM_SOCKREADY_WRITE)
+    {
+      fds->revents |= POLLOUT;
+    }
+
+  if (ready & ALTCOM_SOCKREADY_ERROR)
+    {
+      fds->revents |= POLLERR;
+    }
+
+  sem_post(fds->sem);
+}
+
+/****************************************************************************
+ * Name: sockready_pollsetup
+ *
+ * Description:
+ *   Answer from the readiness table, or wait in it. A modem command is
+ *   sent only if the shared select request does not cover the socket.
+ *
+ ****************************************************************************/
+
+static int sockready_pollsetup(FAR struct socket *psock,
+                               FAR struct stubsock_conn_s *conn,
+                               FAR struct pollfd *fds)
+{
+  FAR struct stubsock_poll_s *info;
+  int32_t                     ret;
+
+  info = (FAR struct stubsock_poll_s*)stubsock_mem_alloc
+           (sizeof(struct stubsock_poll_s));
+  if (!info)
+    {
+      DBGIF_LOG_ERROR("Failed to allocate memory.\n");
+      return -ENOMEM;
+    }
+
+  info->psock         = psock;
+  info->fds           = fds;
+  info->select_id     = -1;
+  info->waiter.next   = NULL;
+  info->waiter.sockfd = conn->stubsockid;
+  info->waiter.events = 0;
+  info->waiter.notify = sockready_notify;
+  info->waiter.group  = (FAR void *)fds->sem;
+  info->waiter.priv   = (FAR void *)fds;
+
+  if (fds->events & POLLIN)
+    {
+      info->waiter.events |= ALTCOM_SOCKREADY_READ;
+    }
+
+  if (fds->events & POLLOUT)
+    {
+      info->waiter.events |= ALTCOM_SOCKREADY_WRITE;
+    }
+
+  fds->priv = (FAR void*)info;
+
+  ret = altcom_sockready_poll(&info->waiter);
+  if (ret < 0)
+    {
+      stubsock_mem_free(info);
+      fds->priv = NULL;
+      ret = altcom_errno();
+      return -ret;
+    }
+  else if (ret > 0)
+    {
+      sockready_notify(&info->waiter, (uint8_t)ret);
+    }
+
+  return OK;
+}
+#endif /* CONFIG_LTE_NET_SOCKREADY */
 
 /****************************************************************************
  * Name: stubsock_pollsetup
@@ -150,12 +246,14 @@ static int stubsock_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
   FAR struct devspecsock_conn_s *ds_conn =
     (FAR struct devspecsock_conn_s*)psock->s_conn;
   FAR struct stubsock_conn_s    *conn = ds_conn->devspec_conn;
+#ifndef CONFIG_LTE_NET_SOCKREADY
   FAR struct stubsock_poll_s    *info;
   altcom_fd_set                  readset;
   FAR altcom_fd_set             *preadset = NULL;
   altcom_fd_set                  writeset;
   FAR altcom_fd_set             *pwriteset = NULL;
   int32_t                        ret;
+#endif
 
   if (!conn || !fds)
     {
@@ -172,6 +270,25 @@ static int stubsock_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       return -EINVAL;
     }
 
+#ifdef CONFIG_LTE_NET_SOCKBUF
+  /* The peer may wait for held data before it sends anything */
+
+  (void)altcom_sockbuf_flush(conn->stubsockid, true);
+
+  /* Data in the read-ahead cache is readable without asking the modem */
+
+  if ((fds->events & POLLIN) &&
+      (altcom_sockbuf_readable(conn->stubsockid) > 0))
+    {
+      fds->revents |= POLLIN;
+      sem_post(fds->sem);
+      return OK;
+    }
+#endif
+
+#ifdef CONFIG_LTE_NET_SOCKREADY
+  return sockready_pollsetup(psock, conn, fds);
+#else
   if (fds->events & POLLIN)
     {
       ALTCOM_FD_ZERO(&readset);
@@ -262,6 +379,7 @@ static int stubsock_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
   info->select_id = ret;
 
   return ret;
+#endif /* CONFIG_LTE_NET_SOCKREADY */
 }
 
 /****************************************************************************
@@ -275,7 +393,9 @@ static int stubsock_pollteardown(FAR struct socket *psock,
     (FAR struct devspecsock_conn_s*)psock->s_conn;
   FAR struct stubsock_conn_s    *conn = ds_conn->devspec_conn;
   FAR struct stubsock_poll_s    *info;
+#ifndef CONFIG_LTE_NET_SOCKREADY
   int32_t                        select_id;
+#endif
 
   if (!conn)
     {
@@ -285,6 +405,16 @@ static int stubsock_pollteardown(FAR struct socket *psock,
   /* Recover the socket descriptor poll state info from the poll structure */
 
   info = (FAR struct stubsock_poll_s *)fds->priv;
+#ifdef CONFIG_LTE_NET_SOCKREADY
+  if (info)
+    {
+      /* The shared select request is left for the next poll */
+
+      altcom_sockready_unpoll(&info->waiter);
+      stubsock_mem_free(info);
+      fds->priv = NULL;
+    }
+#else
   if (info)
     {
       net_lock();
@@ -310,6 +440,7 @@ static int stubsock_pollteardown(FAR struct socket *psock,
 
       stubsock_mem_free(info);
     }
+#endif
 
   return OK;
 }
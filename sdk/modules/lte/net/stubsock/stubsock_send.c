@@ -108,6 +108,12 @@ ssize_t stubsock_send(FAR struct socket *psock, FAR const void *buf,
       ret = altcom_errno();
       ret = -ret;
     }
+  else
+    {
+      /* Data held by MSG_MORE must not wait for the next write forever */
+
+      stubsock_sched_flush(conn);
+    }
 
   return ret;
 }
@@ -604,6 +604,40 @@ int32_t sys_lock_mutex(FAR sys_mutex_t *mutex)
   return 0;
 }
 
+/****************************************************************************
+ * Name: sys_trylock_mutex
+ *
+ * Description:
+ *   Lock a mutex if it is not held by another task, without waiting.
+ *
+ * Input Parameters:
+ *   mutex The handle of the mutex to be locked.
+ *
+ * Returned Value:
+ *   If the mutex was locked successfully then 0 is returned.
+ *   If the mutex is held by another task then -EBUSY is returned.
+ *   Otherwise negative value is returned.
+ *
+ ****************************************************************************/
+
+int32_t sys_trylock_mutex(FAR sys_mutex_t *mutex)
+{
+  int32_t ret;
+
+  ret = pthread_mutex_trylock(mutex);
+  if (ret == EBUSY)
+    {
+      return -EBUSY;
+    }
+  else if (ret != 0)
+    {
+      DBGIF_LOG1_ERROR("Failed to try lock mutex:%d\n", ret);
+      return -ret;
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: sys_unlock_mutex
  *
@@ -0,0 +1,851 @@
+/****************************************************************************
+ * modules/sensing/geofence/geofence.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+
+#include "gpsutils/geofence.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SENSING_GEOFENCE_CELLSIZE
+#  define CONFIG_SENSING_GEOFENCE_CELLSIZE 500
+#endif
+
+#define GEOFENCE_CIRCLE     0
+#define GEOFENCE_POLYGON    1
+
+/* Region flags */
+
+#define GEOFENCE_FLAG_DWELL (1 << 0)  /* Dwell transition reported */
+
+#define GEOFENCE_NONE       0xffff
+
+/* Meters per degree of latitude, for the mean earth radius */
+
+#define GEOFENCE_MPERDEG    111194.93
+
+/* Coordinates of the grid index are in 1e-7 degree */
+
+#define GEOFENCE_E7         10000000.0
+#define GEOFENCE_MAXCELL    (360 * 10000000LL)
+
+#define GEOFENCE_ALIGN(s)   (((s) + 7) & ~7)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Polygon vertex in meters, relative to the reference point of its region */
+
+struct geofence_vertex_s
+{
+  float x;
+  float y;
+};
+
+struct geofence_region_s
+{
+  uint32_t id;
+  uint8_t  type;          /* GEOFENCE_CIRCLE or GEOFENCE_POLYGON */
+  uint8_t  state;         /* GEOFENCE_STATE_* */
+  uint8_t  flags;         /* GEOFENCE_FLAG_* */
+  uint16_t nvertices;     /* Number of polygon vertices */
+  uint16_t next;          /* Next region inside which the position is */
+  uint32_t visit;         /* Update in which the region was checked */
+  uint32_t vertex;        /* Index of the first polygon vertex */
+  float    radius;        /* Radius of a circle [m] */
+  float    mperlon;       /* Meters per degree of longitude at lat0 */
+  double   lat0;          /* Reference point [degree] */
+  double   lon0;
+  int32_t  minlat;        /* Bounding box [1e-7 degree] */
+  int32_t  maxlat;
+  int32_t  minlon;
+  int32_t  maxlon;
+  uint64_t entered;       /* Time of the enter transition [ms] */
+};
+
+struct geofence_s
+{
+  struct geofence_config_s config;
+  FAR struct geofence_region_s *regions;
+  FAR struct geofence_vertex_s *vertices;
+  FAR uint32_t *buckets;  /* First reference of each bucket, nbuckets + 1 */
+  FAR uint16_t *refs;     /* Region indexes of the cells of all buckets */
+  uint16_t nregions;
+  uint32_t nvertices;
+  uint16_t inside;        /* First region inside which the position is */
+  bool     dirty;         /* The grid index must be rebuilt */
+  bool     linear;        /* No grid index, check all the regions */
+  uint32_t visit;         /* Update count */
+  int64_t  cellsize;      /* Grid cell size [1e-7 degree] */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline int64_t geofence_floordiv(int64_t a, int64_t b)
+{
+  return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+static inline uint32_t geofence_hash(FAR struct geofence_s *gf,
+                                     int64_t clat, int64_t clon)
+{
+  return ((uint32_t)clat * 73856093u ^ (uint32_t)clon * 19349663u) %
+         gf->config.nbuckets;
+}
+
+/****************************************************************************
+ * Name: geofence_build
+ *
+ * Description:
+ *   Rebuild the grid index.  Each region is referenced from the bucket of
+ *   every grid cell its bounding box overlaps.  If the references do not
+ *   fit in the table, the cell size is doubled.
+ *
+ ****************************************************************************/
+
+static void geofence_build(FAR struct geofence_s *gf)
+{
+  FAR struct geofence_region_s *r;
+  uint32_t nbuckets = gf->config.nbuckets;
+  uint32_t total;
+  uint32_t b;
+  int64_t cs = (int64_t)(gf->config.cellsize * GEOFENCE_E7 /
+                         GEOFENCE_MPERDEG);
+  int64_t clat;
+  int64_t clon;
+  int i;
+
+  if (cs < 1)
+    {
+      cs = 1;
+    }
+
+  /* Count the references of each bucket in buckets[b + 1] */
+
+  for (; ; )
+    {
+      memset(gf->buckets, 0, (nbuckets + 1) * sizeof(uint32_t));
+      total = 0;
+
+      for (i = 0; i < gf->nregions && total <= gf->config.maxrefs; i++)
+        {
+          r = &gf->regions[i];
+          for (clat = geofence_floordiv(r->minlat, cs);
+               clat <= geofence_floordiv(r->maxlat, cs); clat++)
+            {
+              for (clon = geofence_floordiv(r->minlon, cs);
+                   clon <= geofence_floordiv(r->maxlon, cs); clon++)
+                {
+                  gf->buckets[geofence_hash(gf, clat, clon) + 1]++;
+                  total++;
+                }
+            }
+        }
+
+      if (total <= gf->config.maxrefs)
+        {
+          break;
+        }
+
+      if (cs >= GEOFENCE_MAXCELL)
+        {
+          /* Even cells of the size of the earth do not fit */
+
+          gf->linear = true;
+          gf->dirty  = false;
+          return;
+        }
+
+      cs *= 2;
+    }
+
+  /* Turn the counts into the first reference of each bucket, fill the
+   * references while advancing the first references to the ends, and
+   * shift them back.
+   */
+
+  for (b = 0; b < nbuckets; b++)
+    {
+      gf->buckets[b + 1] += gf->buckets[b];
+    }
+
+  for (i = 0; i < gf->nregions; i++)
+    {
+      r = &gf->regions[i];
+      for (clat = geofence_floordiv(r->minlat, cs);
+           clat <= geofence_floordiv(r->maxlat, cs); clat++)
+        {
+          for (clon = geofence_floordiv(r->minlon, cs);
+               clon <= geofence_floordiv(r->maxlon, cs); clon++)
+            {
+              gf->refs[gf->buckets[geofence_hash(gf, clat, clon)]++] = i;
+            }
+        }
+    }
+
+  for (b = nbuckets; b > 0; b--)
+    {
+      gf->buckets[b] = gf->buckets[b - 1];
+    }
+
+  gf->buckets[0] = 0;
+  gf->cellsize   = cs;
+  gf->linear     = false;
+  gf->dirty      = false;
+}
+
+/****************************************************************************
+ * Name: geofence_project
+ *
+ * Description:
+ *   Get the position in meters relative to the reference point of a region.
+ *
+ ****************************************************************************/
+
+static inline void geofence_project(FAR struct geofence_region_s *r,
+                                    double lat, double lon,
+                                    FAR float *x, FAR float *y)
+{
+  *x = (float)((lon - r->lon0) * r->mperlon);
+  *y = (float)((lat - r->lat0) * GEOFENCE_MPERDEG);
+}
+
+/****************************************************************************
+ * Name: geofence_inside
+ ****************************************************************************/
+
+static bool geofence_inside(FAR struct geofence_s *gf,
+                            FAR struct geofence_region_s *r,
+                            float x, float y)
+{
+  FAR struct geofence_vertex_s *v;
+  bool inside = false;
+  int i;
+  int j;
+
+  if (r->type == GEOFENCE_CIRCLE)
+    {
+      return x * x + y * y <= r->radius * r->radius;
+    }
+
+  /* Crossing number test */
+
+  v = &gf->vertices[r->vertex];
+  for (i = 0, j = r->nvertices - 1; i < r->nvertices; j = i++)
+    {
+      if ((v[i].y > y) != (v[j].y > y) &&
+          x < (v[j].x - v[i].x) * (y - v[i].y) / (v[j].y - v[i].y) + v[i].x)
+        {
+          inside = !inside;
+        }
+    }
+
+  return inside;
+}
+
+/****************************************************************************
+ * Name: geofence_distance
+ *
+ * Description:
+ *   Get the distance from a position outside a region to the region.
+ *
+ ****************************************************************************/
+
+static float geofence_distance(FAR struct geofence_s *gf,
+                               FAR struct geofence_region_s *r,
+                               float x, float y)
+{
+  FAR struct geofence_vertex_s *v;
+  float mindist2 = INFINITY;
+  float dx;
+  float dy;
+  float ex;
+  float ey;
+  float t;
+  int i;
+  int j;
+
+  if (r->type == GEOFENCE_CIRCLE)
+    {
+      return sqrtf(x * x + y * y) - r->radius;
+    }
+
+  /* Distance to the nearest edge */
+
+  v = &gf->vertices[r->vertex];
+  for (i = 0, j = r->nvertices - 1; i < r->nvertices; j = i++)
+    {
+      ex = v[i].x - v[j].x;
+      ey = v[i].y - v[j].y;
+      dx = x - v[j].x;
+      dy = y - v[j].y;
+
+      t = ex * ex + ey * ey;
+      t = t > 0.0f ? (dx * ex + dy * ey) / t : 0.0f;
+      t = t < 0.0f ? 0.0f : t > 1.0f ? 1.0f : t;
+
+      dx -= t * ex;
+      dy -= t * ey;
+      if (dx * dx + dy * dy < mindist2)
+        {
+          mindist2 = dx * dx + dy * dy;
+        }
+    }
+
+  return sqrtf(mindist2);
+}
+
+/****************************************************************************
+ * Name: geofence_report
+ ****************************************************************************/
+
+static inline void geofence_report(FAR struct geofence_s *gf,
+                                   FAR struct geofence_region_s *r,
+                                   int trans)
+{
+  if (gf->config.callback)
+    {
+      gf->config.callback(gf->config.arg, r->id, trans);
+    }
+}
+
+/****************************************************************************
+ * Name: geofence_check
+ *
+ * Description:
+ *   Check a region which the position was outside of.
+ *
+ ****************************************************************************/
+
+static int geofence_check(FAR struct geofence_s *gf, int index,
+                          double lat, double lon, int32_t lat7,
+                          int32_t lon7, uint64_t msec)
+{
+  FAR struct geofence_region_s *r = &gf->regions[index];
+  float x;
+  float y;
+
+  if (r->visit == gf->visit)
+    {
+      return 0;
+    }
+
+  r->visit = gf->visit;
+
+  if (lat7 < r->minlat || lat7 > r->maxlat ||
+      lon7 < r->minlon || lon7 > r->maxlon)
+    {
+      return 0;
+    }
+
+  geofence_project(r, lat, lon, &x, &y);
+  if (!geofence_inside(gf, r, x, y))
+    {
+      return 0;
+    }
+
+  r->state   = GEOFENCE_STATE_INSIDE;
+  r->flags  &= ~GEOFENCE_FLAG_DWELL;
+  r->entered = msec;
+  r->next    = gf->inside;
+  gf->inside = index;
+
+  geofence_report(gf, r, GEOFENCE_TRANSITION_ENTER);
+  return 1;
+}
+
+/****************************************************************************
+ * Name: geofence_relink
+ *
+ * Description:
+ *   Rebuild the list of the regions inside which the position is.
+ *
+ ****************************************************************************/
+
+static void geofence_relink(FAR struct geofence_s *gf)
+{
+  int i;
+
+  gf->inside = GEOFENCE_NONE;
+  for (i = gf->nregions - 1; i >= 0; i--)
+    {
+      if (gf->regions[i].state == GEOFENCE_STATE_INSIDE)
+        {
+          gf->regions[i].next = gf->inside;
+          gf->inside = i;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: geofence_newregion
+ ****************************************************************************/
+
+static FAR struct geofence_region_s *
+geofence_newregion(FAR struct geofence_s *gf, uint32_t id, int type,
+                   double lat0, double lon0)
+{
+  FAR struct geofence_region_s *r;
+
+  if (gf->nregions >= gf->config.maxregions)
+    {
+      return NULL;
+    }
+
+  r = &gf->regions[gf->nregions];
+  memset(r, 0, sizeof(struct geofence_region_s));
+
+  r->id      = id;
+  r->type    = type;
+  r->state   = GEOFENCE_STATE_OUTSIDE;
+  r->next    = GEOFENCE_NONE;
+  r->lat0    = lat0;
+  r->lon0    = lon0;
+  r->mperlon = (float)(GEOFENCE_MPERDEG * cos(lat0 * M_PI / 180.0));
+
+  /* Keep the longitude scale usable near the poles */
+
+  if (r->mperlon < 1.0f)
+    {
+      r->mperlon = 1.0f;
+    }
+
+  return r;
+}
+
+static inline bool geofence_validpoint(double lat, double lon)
+{
+  return lat >= -90.0 && lat <= 90.0 && lon >= -180.0 && lon <= 180.0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: geofence_memsize
+ ****************************************************************************/
+
+size_t geofence_memsize(FAR const struct geofence_config_s *config)
+{
+  uint32_t maxrefs  = config->maxrefs ? config->maxrefs :
+                      4 * (uint32_t)config->maxregions;
+  uint32_t nbuckets = config->nbuckets ? config->nbuckets :
+                      config->maxregions;
+
+  return GEOFENCE_ALIGN(sizeof(struct geofence_s)) +
+         GEOFENCE_ALIGN(config->maxregions *
+                        sizeof(struct geofence_region_s)) +
+         GEOFENCE_ALIGN(config->maxvertices *
+                        sizeof(struct geofence_vertex_s)) +
+         GEOFENCE_ALIGN((nbuckets + 1) * sizeof(uint32_t)) +
+         GEOFENCE_ALIGN(maxrefs * sizeof(uint16_t));
+}
+
+/****************************************************************************
+ * Name: geofence_create
+ ****************************************************************************/
+
+GEOFENCEHANDLE geofence_create(FAR const struct geofence_config_s *config)
+{
+  FAR struct geofence_s *gf;
+  FAR uint8_t *mem;
+
+  if (!config || config->maxregions == 0 ||
+      config->maxregions >= GEOFENCE_NONE)
+    {
+      return NULL;
+    }
+
+  mem = (FAR uint8_t *)malloc(geofence_memsize(config));
+  if (!mem)
+    {
+      return NULL;
+    }
+
+  gf = (FAR struct geofence_s *)mem;
+  memset(gf, 0, sizeof(struct geofence_s));
+
+  gf->config = *config;
+  if (gf->config.maxrefs == 0)
+    {
+      gf->config.maxrefs = 4 * (uint32_t)config->maxregions;
+    }
+
+  if (gf->config.nbuckets == 0)
+    {
+      gf->config.nbuckets = config->maxregions;
+    }
+
+  if (gf->config.cellsize == 0)
+    {
+      gf->config.cellsize = CONFIG_SENSING_GEOFENCE_CELLSIZE;
+    }
+
+  mem += GEOFENCE_ALIGN(sizeof(struct geofence_s));
+  gf->regions = (FAR struct geofence_region_s *)mem;
+  mem += GEOFENCE_ALIGN(config->maxregions *
+                        sizeof(struct geofence_region_s));
+  gf->vertices = (FAR struct geofence_vertex_s *)mem;
+  mem += GEOFENCE_ALIGN(config->maxvertices *
+                        sizeof(struct geofence_vertex_s));
+  gf->buckets = (FAR uint32_t *)mem;
+  mem += GEOFENCE_ALIGN((gf->config.nbuckets + 1) * sizeof(uint32_t));
+  gf->refs = (FAR uint16_t *)mem;
+
+  gf->inside = GEOFENCE_NONE;
+  gf->dirty  = true;
+
+  return gf;
+}
+
+/****************************************************************************
+ * Name: geofence_destroy
+ ****************************************************************************/
+
+void geofence_destroy(GEOFENCEHANDLE handle)
+{
+  free(handle);
+}
+
+/****************************************************************************
+ * Name: geofence_add_circle
+ ****************************************************************************/
+
+int geofence_add_circle(GEOFENCEHANDLE handle, uint32_t id,
+                        double latitude, double longitude, float radius)
+{
+  FAR struct geofence_s *gf = handle;
+  FAR struct geofence_region_s *r;
+  double dlat;
+  double dlon;
+
+  if (!gf || !geofence_validpoint(latitude, longitude) || !(radius > 0.0f))
+    {
+      return -EINVAL;
+    }
+
+  r = geofence_newregion(gf, id, GEOFENCE_CIRCLE, latitude, longitude);
+  if (!r)
+    {
+      return -ENOSPC;
+    }
+
+  dlat = radius / GEOFENCE_MPERDEG;
+  dlon = radius / r->mperlon;
+  if (dlon >= 90.0)
+    {
+      return -EINVAL;
+    }
+
+  r->radius = radius;
+  r->minlat = (int32_t)floor((latitude - dlat) * GEOFENCE_E7);
+  r->maxlat = (int32_t)ceil((latitude + dlat) * GEOFENCE_E7);
+  r->minlon = (int32_t)floor((longitude - dlon) * GEOFENCE_E7);
+  r->maxlon = (int32_t)ceil((longitude + dlon) * GEOFENCE_E7);
+
+  gf->nregions++;
+  gf->dirty = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: geofence_add_polygon
+ ****************************************************************************/
+
+int geofence_add_polygon(GEOFENCEHANDLE handle, uint32_t id,
+                         FAR const struct geofence_point_s *points,
+                         int npoints)
+{
+  FAR struct geofence_s *gf = handle;
+  FAR struct geofence_region_s *r;
+  FAR struct geofence_vertex_s *v;
+  double minlat = 90.0;
+  double maxlat = -90.0;
+  double minlon = 180.0;
+  double maxlon = -180.0;
+  int i;
+
+  if (!gf || !points || npoints < 3 || npoints >= GEOFENCE_NONE)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < npoints; i++)
+    {
+      if (!geofence_validpoint(points[i].latitude, points[i].longitude))
+        {
+          return -EINVAL;
+        }
+
+      minlat = fmin(minlat, points[i].latitude);
+      maxlat = fmax(maxlat, points[i].latitude);
+      minlon = fmin(minlon, points[i].longitude);
+      maxlon = fmax(maxlon, points[i].longitude);
+    }
+
+  /* Regions across the 180th meridian are not supported */
+
+  if (maxlon - minlon >= 180.0)
+    {
+      return -EINVAL;
+    }
+
+  if (gf->nvertices + npoints > gf->config.maxvertices)
+    {
+      return -ENOSPC;
+    }
+
+  r = geofence_newregion(gf, id, GEOFENCE_POLYGON, (minlat + maxlat) / 2,
+                         (minlon + maxlon) / 2);
+  if (!r)
+    {
+      return -ENOSPC;
+    }
+
+  r->vertex    = gf->nvertices;
+  r->nvertices = npoints;
+  r->minlat    = (int32_t)floor(minlat * GEOFENCE_E7);
+  r->maxlat    = (int32_t)ceil(maxlat * GEOFENCE_E7);
+  r->minlon    = (int32_t)floor(minlon * GEOFENCE_E7);
+  r->maxlon    = (int32_t)ceil(maxlon * GEOFENCE_E7);
+
+  v = &gf->vertices[r->vertex];
+  for (i = 0; i < npoints; i++)
+    {
+      geofence_project(r, points[i].latitude, points[i].longitude,
+                       &v[i].x, &v[i].y);
+    }
+
+  gf->nvertices += npoints;
+  gf->nregions++;
+  gf->dirty = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: geofence_delete
+ ****************************************************************************/
+
+int geofence_delete(GEOFENCEHANDLE handle, uint32_t id)
+{
+  FAR struct geofence_s *gf = handle;
+  FAR struct geofence_region_s *r;
+  uint32_t vertex;
+  uint16_t nvertices;
+  int i;
+
+  for (i = 0; i < gf->nregions; i++)
+    {
+      if (gf->regions[i].id == id)
+        {
+          break;
+        }
+    }
+
+  if (i == gf->nregions)
+    {
+      return -ENOENT;
+    }
+
+  /* Remove the vertices and the region */
+
+  r         = &gf->regions[i];
+  vertex    = r->vertex;
+  nvertices = r->type == GEOFENCE_POLYGON ? r->nvertices : 0;
+
+  if (nvertices > 0)
+    {
+      memmove(&gf->vertices[vertex], &gf->vertices[vertex + nvertices],
+              (gf->nvertices - vertex - nvertices) *
+              sizeof(struct geofence_vertex_s));
+      gf->nvertices -= nvertices;
+    }
+
+  *r = gf->regions[--gf->nregions];
+
+  for (i = 0; i < gf->nregions; i++)
+    {
+      r = &gf->regions[i];
+      if (r->type == GEOFENCE_POLYGON && r->vertex > vertex)
+        {
+          r->vertex -= nvertices;
+        }
+    }
+
+  geofence_relink(gf);
+  gf->dirty = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: geofence_getstate
+ ****************************************************************************/
+
+int geofence_getstate(GEOFENCEHANDLE handle, uint32_t id)
+{
+  FAR struct geofence_s *gf = handle;
+  int i;
+
+  for (i = 0; i < gf->nregions; i++)
+    {
+      if (gf->regions[i].id == id)
+        {
+          return gf->regions[i].state;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: geofence_update
+ ****************************************************************************/
+
+int geofence_update(GEOFENCEHANDLE handle, double latitude,
+                    double longitude, uint64_t msec)
+{
+  FAR struct geofence_s *gf = handle;
+  FAR struct geofence_region_s *r;
+  uint16_t *prev;
+  uint16_t index;
+  int32_t lat7;
+  int32_t lon7;
+  uint32_t b;
+  uint32_t i;
+  float x;
+  float y;
+  int count = 0;
+
+  if (!gf || !geofence_validpoint(latitude, longitude))
+    {
+      return -EINVAL;
+    }
+
+  if (gf->dirty)
+    {
+      geofence_build(gf);
+    }
+
+  /* Start a new visit, the regions checked in this update are marked with
+   * it.
+   */
+
+  if (++gf->visit == 0)
+    {
+      for (i = 0; i < gf->nregions; i++)
+        {
+          gf->regions[i].visit = 0;
+        }
+
+      gf->visit = 1;
+    }
+
+  /* Check the regions inside which the position was */
+
+  prev = &gf->inside;
+  while ((index = *prev) != GEOFENCE_NONE)
+    {
+      r = &gf->regions[index];
+      r->visit = gf->visit;
+
+      geofence_project(r, latitude, longitude, &x, &y);
+      if (!geofence_inside(gf, r, x, y) &&
+          geofence_distance(gf, r, x, y) > gf->config.hysteresis)
+        {
+          *prev    = r->next;
+          r->next  = GEOFENCE_NONE;
+          r->state = GEOFENCE_STATE_OUTSIDE;
+
+          geofence_report(gf, r, GEOFENCE_TRANSITION_EXIT);
+          count++;
+          continue;
+        }
+
+      if (gf->config.dwelltime > 0 &&
+          (r->flags & GEOFENCE_FLAG_DWELL) == 0 &&
+          msec - r->entered >= gf->config.dwelltime)
+        {
+          r->flags |= GEOFENCE_FLAG_DWELL;
+          geofence_report(gf, r, GEOFENCE_TRANSITION_DWELL);
+          count++;
+        }
+
+      prev = &r->next;
+    }
+
+  /* Check the regions of the grid cell of the position */
+
+  lat7 = (int32_t)floor(latitude * GEOFENCE_E7);
+  lon7 = (int32_t)floor(longitude * GEOFENCE_E7);
+
+  if (gf->linear)
+    {
+      for (i = 0; i < gf->nregions; i++)
+        {
+          count += geofence_check(gf, i, latitude, longitude, lat7, lon7,
+                                  msec);
+        }
+    }
+  else if (gf->nregions > 0)
+    {
+      b = geofence_hash(gf, geofence_floordiv(lat7, gf->cellsize),
+                        geofence_floordiv(lon7, gf->cellsize));
+
+      for (i = gf->buckets[b]; i < gf->buckets[b + 1]; i++)
+        {
+          count += geofence_check(gf, gf->refs[i], latitude, longitude,
+                                  lat7, lon7, msec);
+        }
+    }
+
+  return count;
+}
@@ -0,0 +1,151 @@
+/****************************************************************************
+ * modules/sensing/geofence/geofence_gnss.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+
+#include <arch/chip/gnss_type.h>
+
+#include "gpsutils/cxd56_gnss_nmea.h"
+#include "gpsutils/geofence.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MSEC_PER_DAY (24 * 60 * 60 * 1000ULL)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: geofence_days
+ *
+ * Description:
+ *   Get the number of days from 1970-01-01 to a date.
+ *
+ ****************************************************************************/
+
+static int32_t geofence_days(int year, int month, int day)
+{
+  int32_t era;
+  int32_t yoe;
+  int32_t doy;
+
+  year -= month <= 2;
+  era   = (year >= 0 ? year : year - 399) / 400;
+  yoe   = year - era * 400;
+  doy   = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+
+  return era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: geofence_update_gnss
+ ****************************************************************************/
+
+int geofence_update_gnss(GEOFENCEHANDLE handle,
+                         FAR const struct cxd56_gnss_positiondata_s *posdat)
+{
+  FAR const struct cxd56_gnss_receiver_s *receiver = &posdat->receiver;
+
+  if (posdat->status != 0 || receiver->pos_fixmode < 2 ||
+      !receiver->pos_dataexist)
+    {
+      return -EAGAIN;
+    }
+
+  return geofence_update(handle, receiver->latitude, receiver->longitude,
+                         posdat->data_timestamp);
+}
+
+/****************************************************************************
+ * Name: geofence_update_nmea
+ ****************************************************************************/
+
+int geofence_update_nmea(GEOFENCEHANDLE handle,
+                         FAR const struct nmea_raw_s *raw, uint64_t msec)
+{
+  return geofence_update(handle, raw->lat, raw->lon, msec);
+}
+
+/****************************************************************************
+ * Name: geofence_update_pvtlog
+ ****************************************************************************/
+
+int geofence_update_pvtlog(GEOFENCEHANDLE handle,
+                           FAR const struct cxd56_pvtlog_data_s *log)
+{
+  double lat;
+  double lon;
+  uint64_t msec;
+
+  /* Degree, minute and 1/10000 minute */
+
+  lat = log->latitude.degree +
+        (log->latitude.minute + log->latitude.frac / 10000.0) / 60.0;
+  lon = log->longitude.degree +
+        (log->longitude.minute + log->longitude.frac / 10000.0) / 60.0;
+
+  if (log->latitude.sign)
+    {
+      lat = -lat;
+    }
+
+  if (log->longitude.sign)
+    {
+      lon = -lon;
+    }
+
+  /* The year is stored from 2000, and msec is in 10 msec units */
+
+  msec = (uint64_t)geofence_days(2000 + log->date.year, log->date.month,
+                                 log->date.day) * MSEC_PER_DAY +
+         ((log->time.hour * 60 + log->time.minute) * 60 + log->time.sec) *
+         1000 + log->time.msec * 10;
+
+  return geofence_update(handle, lat, lon, msec);
+}
@@ -0,0 +1,787 @@
+/****************************************************************************
+ * modules/sensing/geofence/host/geofencebench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host test and benchmark of the software geofence.
+ *
+ *   -t: A vehicle track is generated over a set of regions and written as a
+ *       GNSS PVT log file, the file is replayed with and without the grid
+ *       index, and the transitions of both are compared.  The region states
+ *       are also compared with a direct double precision check.
+ *   -r <file>: Replay a recorded PVT log file over regions generated around
+ *       its first fix, and print the transitions.
+ *   -b <counts>: Measure the lookups per second with and without the grid
+ *       index for each comma separated region count.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+
+#include <arch/chip/gnss_type.h>
+
+#include "gpsutils/geofence.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_LAT0       35.68
+#define BENCH_LON0       139.76
+#define BENCH_AREA       20000.0     /* Side of the area of the regions [m] */
+#define BENCH_MPERDEG    111194.93
+#define BENCH_MAXVERTS   12
+#define BENCH_MAXEVENTS  200000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bench_region_s
+{
+  bool   circle;
+  double lat;
+  double lon;
+  double radius;
+  int    npoints;
+  struct geofence_point_s points[BENCH_MAXVERTS];
+};
+
+struct bench_event_s
+{
+  uint32_t fix;
+  uint32_t id;
+  int      trans;
+};
+
+struct bench_log_s
+{
+  uint32_t fix;
+  int      nevents;
+  struct bench_event_s events[BENCH_MAXEVENTS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint32_t g_seed = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static double frand(void)
+{
+  g_seed ^= g_seed << 13;
+  g_seed ^= g_seed >> 17;
+  g_seed ^= g_seed << 5;
+  return (double)g_seed / 4294967296.0;
+}
+
+static double now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Generate circles and star shaped polygons of 30 m to 300 m around
+ * (lat0, lon0).
+ */
+
+static FAR struct bench_region_s *make_regions(int n, double lat0,
+                                               double lon0)
+{
+  FAR struct bench_region_s *regions;
+  double mperlon = BENCH_MPERDEG * cos(lat0 * M_PI / 180.0);
+  double angle;
+  double r;
+  int i;
+  int j;
+
+  regions = calloc(n, sizeof(struct bench_region_s));
+  if (!regions)
+    {
+      return NULL;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      regions[i].circle = (i % 2) == 0;
+      regions[i].lat    = lat0 + (frand() - 0.5) * BENCH_AREA / BENCH_MPERDEG;
+      regions[i].lon    = lon0 + (frand() - 0.5) * BENCH_AREA / mperlon;
+      regions[i].radius = 30.0 + frand() * 270.0;
+
+      if (!regions[i].circle)
+        {
+          regions[i].npoints = 6 + (int)(frand() * (BENCH_MAXVERTS - 6));
+          for (j = 0; j < regions[i].npoints; j++)
+            {
+              angle = 2 * M_PI * (j + frand() * 0.8) / regions[i].npoints;
+              r     = regions[i].radius * (0.5 + frand() * 0.5);
+
+              regions[i].points[j].latitude  =
+                regions[i].lat + r * sin(angle) / BENCH_MPERDEG;
+              regions[i].points[j].longitude =
+                regions[i].lon + r * cos(angle) / mperlon;
+            }
+        }
+    }
+
+  return regions;
+}
+
+static int add_regions(GEOFENCEHANDLE gf,
+                       FAR const struct bench_region_s *regions, int n)
+{
+  int ret;
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      if (regions[i].circle)
+        {
+          ret = geofence_add_circle(gf, i, regions[i].lat, regions[i].lon,
+                                    regions[i].radius);
+        }
+      else
+        {
+          ret = geofence_add_polygon(gf, i, regions[i].points,
+                                     regions[i].npoints);
+        }
+
+      if (ret < 0)
+        {
+          fprintf(stderr, "ERROR: Failed to add region %d: %d\n", i, ret);
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/* Direct check in double precision, returns the signed distance to the
+ * boundary (negative inside), approximately for polygons.
+ */
+
+static double check_region(FAR const struct bench_region_s *region,
+                           double lat, double lon)
+{
+  double mperlon = BENCH_MPERDEG * cos(region->lat * M_PI / 180.0);
+  double x = (lon - region->lon) * mperlon;
+  double y = (lat - region->lat) * BENCH_MPERDEG;
+  double mind = INFINITY;
+  double xi;
+  double yi;
+  double xj;
+  double yj;
+  double t;
+  bool inside = false;
+  int i;
+  int j;
+
+  if (region->circle)
+    {
+      return sqrt(x * x + y * y) - region->radius;
+    }
+
+  for (i = 0, j = region->npoints - 1; i < region->npoints; j = i++)
+    {
+      xi = (region->points[i].longitude - region->lon) * mperlon;
+      yi = (region->points[i].latitude - region->lat) * BENCH_MPERDEG;
+      xj = (region->points[j].longitude - region->lon) * mperlon;
+      yj = (region->points[j].latitude - region->lat) * BENCH_MPERDEG;
+
+      if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi)
+        {
+          inside = !inside;
+        }
+
+      t = ((x - xj) * (xi - xj) + (y - yj) * (yi - yj)) /
+          ((xi - xj) * (xi - xj) + (yi - yj) * (yi - yj));
+      t = t < 0 ? 0 : t > 1 ? 1 : t;
+      t = hypot(x - xj - t * (xi - xj), y - yj - t * (yi - yj));
+      mind = t < mind ? t : mind;
+    }
+
+  return inside ? -mind : mind;
+}
+
+static void log_event(FAR void *arg, uint32_t id, int trans)
+{
+  FAR struct bench_log_s *log = arg;
+
+  if (log->nevents < BENCH_MAXEVENTS)
+    {
+      log->events[log->nevents].fix   = log->fix;
+      log->events[log->nevents].id    = id;
+      log->events[log->nevents].trans = trans;
+    }
+
+  log->nevents++;
+}
+
+static int compare_events(FAR const void *a, FAR const void *b)
+{
+  FAR const struct bench_event_s *ea = a;
+  FAR const struct bench_event_s *eb = b;
+
+  if (ea->fix != eb->fix)
+    {
+      return ea->fix < eb->fix ? -1 : 1;
+    }
+
+  if (ea->trans != eb->trans)
+    {
+      return ea->trans - eb->trans;
+    }
+
+  return ea->id < eb->id ? -1 : ea->id > eb->id;
+}
+
+static void encode_dmf(double x, FAR uint32_t *sign, FAR uint32_t *degree,
+                       FAR uint32_t *minute, FAR uint32_t *frac)
+{
+  double t;
+
+  *sign   = x < 0;
+  x       = fabs(x);
+  *degree = (uint32_t)x;
+  t       = (x - *degree) * 60;
+  *minute = (uint32_t)t;
+  *frac   = (uint32_t)((t - *minute) * 10000);
+}
+
+static double decode_dmf(uint32_t sign, uint32_t degree, uint32_t minute,
+                         uint32_t frac)
+{
+  double x = degree + (minute + frac / 10000.0) / 60.0;
+
+  return sign ? -x : x;
+}
+
+/* Write a 1 Hz track of a vehicle at 5 to 15 m/s as a PVT log file */
+
+static int make_pvtlog(FAR const char *path, int nfixes)
+{
+  static struct cxd56_pvtlog_s pvtlog;
+  FAR struct cxd56_pvtlog_data_s *d;
+  double mperlon = BENCH_MPERDEG * cos(BENCH_LAT0 * M_PI / 180.0);
+  double x = 0.0;
+  double y = 0.0;
+  double heading = 0.0;
+  double speed;
+  uint32_t sign;
+  uint32_t deg;
+  uint32_t min;
+  uint32_t frac;
+  int sec;
+  int fd;
+  int i;
+
+  fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    {
+      return -errno;
+    }
+
+  memset(&pvtlog, 0, sizeof(pvtlog));
+
+  for (i = 0; i < nfixes; i++)
+    {
+      heading += (frand() - 0.5) * 0.6;
+      speed    = 5.0 + frand() * 10.0;
+      x       += speed * cos(heading);
+      y       += speed * sin(heading);
+
+      /* Turn back at the edges of the area */
+
+      if (fabs(x) > BENCH_AREA / 2 || fabs(y) > BENCH_AREA / 2)
+        {
+          heading += M_PI;
+        }
+
+      d = &pvtlog.log_data[pvtlog.log_count++];
+
+      encode_dmf(BENCH_LAT0 + y / BENCH_MPERDEG, &sign, &deg, &min, &frac);
+      d->latitude.sign    = sign;
+      d->latitude.degree  = deg;
+      d->latitude.minute  = min;
+      d->latitude.frac    = frac;
+
+      encode_dmf(BENCH_LON0 + x / mperlon, &sign, &deg, &min, &frac);
+      d->longitude.sign   = sign;
+      d->longitude.degree = deg;
+      d->longitude.minute = min;
+      d->longitude.frac   = frac;
+
+      /* Start on 2019-12-31 at 22:00:00 UTC to cross the day */
+
+      sec = 22 * 3600 + i;
+      d->date.year   = sec < 86400 ? 19 : 20;
+      d->date.month  = sec < 86400 ? 12 : 1;
+      d->date.day    = sec < 86400 ? 31 : 1;
+      sec           %= 86400;
+      d->time.hour   = sec / 3600;
+      d->time.minute = (sec / 60) % 60;
+      d->time.sec    = sec % 60;
+
+      if (pvtlog.log_count == CXD56_GNSS_PVTLOG_MAXNUM || i == nfixes - 1)
+        {
+          if (write(fd, &pvtlog, sizeof(pvtlog)) != sizeof(pvtlog))
+            {
+              close(fd);
+              return -EIO;
+            }
+
+          memset(&pvtlog, 0, sizeof(pvtlog));
+        }
+    }
+
+  close(fd);
+  return OK;
+}
+
+/* Replay a PVT log file.  If 'regions' is given, the region states are
+ * compared with the direct check after each fix, and the number of
+ * mismatches is returned.
+ */
+
+static int replay(FAR const char *path, GEOFENCEHANDLE gf,
+                  FAR struct bench_log_s *log,
+                  FAR const struct bench_region_s *regions, int nregions)
+{
+  static struct cxd56_pvtlog_s pvtlog;
+  FAR struct cxd56_pvtlog_data_s *d;
+  double lat;
+  double lon;
+  double dist;
+  int mismatches = 0;
+  int state;
+  int fd;
+  int i;
+  int j;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0)
+    {
+      return -errno;
+    }
+
+  log->fix = 0;
+  while (read(fd, &pvtlog, sizeof(pvtlog)) == sizeof(pvtlog))
+    {
+      for (i = 0; i < (int)pvtlog.log_count && i < CXD56_GNSS_PVTLOG_MAXNUM; i++)
+        {
+          d = &pvtlog.log_data[i];
+          geofence_update_pvtlog(gf, d);
+
+          if (regions)
+            {
+              lat = decode_dmf(d->latitude.sign, d->latitude.degree,
+                               d->latitude.minute, d->latitude.frac);
+              lon = decode_dmf(d->longitude.sign, d->longitude.degree,
+                               d->longitude.minute, d->longitude.frac);
+
+              for (j = 0; j < nregions; j++)
+                {
+                  dist  = check_region(&regions[j], lat, lon);
+                  state = geofence_getstate(gf, j);
+
+                  /* Too close to the boundary for float precision */
+
+                  if (fabs(dist) < 0.01)
+                    {
+                      continue;
+                    }
+
+                  if ((dist < 0) != (state == GEOFENCE_STATE_INSIDE))
+                    {
+                      mismatches++;
+                    }
+                }
+            }
+
+          log->fix++;
+        }
+    }
+
+  close(fd);
+  return mismatches;
+}
+
+static GEOFENCEHANDLE create(int nregions, bool indexed, float hysteresis,
+                             uint32_t dwelltime,
+                             FAR struct bench_log_s *log)
+{
+  struct geofence_config_s config;
+
+  memset(&config, 0, sizeof(config));
+  config.maxregions  = nregions;
+  config.maxvertices = nregions * BENCH_MAXVERTS;
+  config.maxrefs     = indexed ? 0 : 1;  /* No room makes it linear */
+  config.hysteresis  = hysteresis;
+  config.dwelltime   = dwelltime;
+  config.callback    = log ? log_event : NULL;
+  config.arg         = log;
+
+  return geofence_create(&config);
+}
+
+static int test(void)
+{
+  FAR struct bench_region_s *regions;
+  FAR struct bench_log_s *log1;
+  FAR struct bench_log_s *log2;
+  FAR struct bench_log_s *log3;
+  GEOFENCEHANDLE gf1;
+  GEOFENCEHANDLE gf2;
+  GEOFENCEHANDLE gf3;
+  char path[64];
+  int counts[3] = { 0, 0, 0 };
+  int nregions = 2000;
+  int nfixes = 4 * 3600;
+  int mismatches;
+  int ret = OK;
+  int i;
+
+  snprintf(path, sizeof(path), "/tmp/geofencebench-%d.log", (int)getpid());
+
+  regions = make_regions(nregions, BENCH_LAT0, BENCH_LON0);
+  log1 = calloc(1, sizeof(struct bench_log_s));
+  log2 = calloc(1, sizeof(struct bench_log_s));
+  log3 = calloc(1, sizeof(struct bench_log_s));
+  gf1  = create(nregions, true, 10.0f, 60000, log1);
+  gf2  = create(nregions, false, 10.0f, 60000, log2);
+  gf3  = create(nregions, true, 0.0f, 0, log3);
+  if (!regions || !log1 || !log2 || !log3 || !gf1 || !gf2 || !gf3 ||
+      add_regions(gf1, regions, nregions) < 0 ||
+      add_regions(gf2, regions, nregions) < 0 ||
+      add_regions(gf3, regions, nregions) < 0 ||
+      make_pvtlog(path, nfixes) < 0)
+    {
+      fprintf(stderr, "ERROR: Failed to set up the test\n");
+      return ERROR;
+    }
+
+  /* Replay with and without the grid index */
+
+  replay(path, gf1, log1, NULL, 0);
+  replay(path, gf2, log2, NULL, 0);
+
+  qsort(log1->events, log1->nevents, sizeof(struct bench_event_s),
+        compare_events);
+  qsort(log2->events, log2->nevents, sizeof(struct bench_event_s),
+        compare_events);
+
+  for (i = 0; i < log1->nevents; i++)
+    {
+      counts[log1->events[i].trans]++;
+    }
+
+  printf("replay: %d fixes, %d regions: %d enter, %d exit, %d dwell\n",
+         log1->fix, nregions, counts[GEOFENCE_TRANSITION_ENTER],
+         counts[GEOFENCE_TRANSITION_EXIT], counts[GEOFENCE_TRANSITION_DWELL]);
+
+  if (log1->nevents != log2->nevents ||
+      memcmp(log1->events, log2->events,
+             log1->nevents * sizeof(struct bench_event_s)) != 0)
+    {
+      printf("indexed vs linear transitions: MISMATCH (%d vs %d)\n",
+             log1->nevents, log2->nevents);
+      ret = ERROR;
+    }
+  else
+    {
+      printf("indexed vs linear transitions: OK\n");
+    }
+
+  /* Without hysteresis, the states must match the direct check */
+
+  mismatches = replay(path, gf3, log3, regions, nregions);
+  printf("states vs direct check: %s (%d mismatches)\n",
+         mismatches == 0 ? "OK" : "MISMATCH", mismatches);
+  if (mismatches != 0)
+    {
+      ret = ERROR;
+    }
+
+  /* Deleting regions must keep the remaining ones working */
+
+  for (i = 0; i < nregions; i += 2)
+    {
+      geofence_delete(gf3, i);
+    }
+
+  for (i = 0; i < nregions; i += 2)
+    {
+      regions[i].circle  = true;
+      regions[i].lat     = 0;
+      regions[i].lon     = 0;
+      regions[i].radius  = 1;
+    }
+
+  log3->nevents = 0;
+  mismatches = replay(path, gf3, log3, regions, nregions);
+  printf("states after deletes: %s (%d mismatches)\n",
+         mismatches == 0 ? "OK" : "MISMATCH", mismatches);
+  if (mismatches != 0)
+    {
+      ret = ERROR;
+    }
+
+  geofence_destroy(gf1);
+  geofence_destroy(gf2);
+  geofence_destroy(gf3);
+  free(log1);
+  free(log2);
+  free(log3);
+  free(regions);
+  unlink(path);
+  return ret;
+}
+
+static void print_event(FAR void *arg, uint32_t id, int trans)
+{
+  static FAR const char *names[] =
+  {
+    "enter", "exit", "dwell"
+  };
+
+  printf("fix %u: region %u %s\n", ((FAR struct bench_log_s *)arg)->fix,
+         id, names[trans]);
+}
+
+static int replay_file(FAR const char *path, int nregions)
+{
+  static struct cxd56_pvtlog_s pvtlog;
+  FAR struct bench_region_s *regions;
+  static struct bench_log_s log;
+  struct geofence_config_s config;
+  GEOFENCEHANDLE gf;
+  double lat;
+  double lon;
+  int fd;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0 || read(fd, &pvtlog, sizeof(pvtlog)) != sizeof(pvtlog) ||
+      pvtlog.log_count == 0)
+    {
+      fprintf(stderr, "ERROR: Failed to read %s\n", path);
+      return ERROR;
+    }
+
+  close(fd);
+
+  lat = decode_dmf(pvtlog.log_data[0].latitude.sign,
+                   pvtlog.log_data[0].latitude.degree,
+                   pvtlog.log_data[0].latitude.minute,
+                   pvtlog.log_data[0].latitude.frac);
+  lon = decode_dmf(pvtlog.log_data[0].longitude.sign,
+                   pvtlog.log_data[0].longitude.degree,
+                   pvtlog.log_data[0].longitude.minute,
+                   pvtlog.log_data[0].longitude.frac);
+
+  memset(&config, 0, sizeof(config));
+  config.maxregions  = nregions;
+  config.maxvertices = nregions * BENCH_MAXVERTS;
+  config.hysteresis  = 10.0f;
+  config.dwelltime   = 60000;
+  config.callback    = print_event;
+  config.arg         = &log;
+
+  regions = make_regions(nregions, lat, lon);
+  gf = geofence_create(&config);
+  if (!regions || !gf || add_regions(gf, regions, nregions) < 0)
+    {
+      return ERROR;
+    }
+
+  replay(path, gf, &log, NULL, 0);
+  printf("%u fixes replayed\n", log.fix);
+
+  geofence_destroy(gf);
+  free(regions);
+  return OK;
+}
+
+static int bench(int nregions)
+{
+  FAR struct bench_region_s *regions;
+  struct geofence_config_s config;
+  GEOFENCEHANDLE gf[2];
+  double mperlon = BENCH_MPERDEG * cos(BENCH_LAT0 * M_PI / 180.0);
+  double rate[2];
+  double start;
+  double *points;
+  int npoints;
+  int n;
+  int i;
+  int j;
+
+  regions = make_regions(nregions, BENCH_LAT0, BENCH_LON0);
+  gf[0]   = create(nregions, true, 10.0f, 60000, NULL);
+  gf[1]   = create(nregions, false, 10.0f, 60000, NULL);
+  points  = malloc(2 * 100000 * sizeof(double));
+  if (!regions || !gf[0] || !gf[1] || !points ||
+      add_regions(gf[0], regions, nregions) < 0 ||
+      add_regions(gf[1], regions, nregions) < 0)
+    {
+      return ERROR;
+    }
+
+  for (i = 0; i < 100000; i++)
+    {
+      points[2 * i] = BENCH_LAT0 +
+                      (frand() - 0.5) * BENCH_AREA / BENCH_MPERDEG;
+      points[2 * i + 1] = BENCH_LON0 + (frand() - 0.5) * BENCH_AREA / mperlon;
+    }
+
+  for (j = 0; j < 2; j++)
+    {
+      /* Build the index before measuring */
+
+      geofence_update(gf[j], BENCH_LAT0, BENCH_LON0, 0);
+
+      npoints = j == 0 ? 100000 : (int)(2e7 / nregions);
+      npoints = npoints > 100000 ? 100000 : npoints < 100 ? 100 : npoints;
+
+      start = now();
+      for (i = 0, n = 0; i < npoints; i++)
+        {
+          n += geofence_update(gf[j], points[2 * i], points[2 * i + 1],
+                               i * 1000);
+        }
+
+      rate[j] = npoints / (now() - start);
+    }
+
+  memset(&config, 0, sizeof(config));
+  config.maxregions  = nregions;
+  config.maxvertices = nregions * BENCH_MAXVERTS;
+
+  printf("%6d regions: %9.0f lookups/s indexed, %9.0f lookups/s linear "
+         "(x%.0f), %zu bytes\n", nregions, rate[0], rate[1],
+         rate[0] / rate[1], geofence_memsize(&config));
+
+  geofence_destroy(gf[0]);
+  geofence_destroy(gf[1]);
+  free(points);
+  free(regions);
+  return OK;
+}
+
+static void show_usage(FAR const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-t] [-r <file>] [-b <counts>] [-h]\n",
+          progname);
+  fprintf(stderr, "\t-t: Replay a generated PVT log and check the "
+                  "transitions\n");
+  fprintf(stderr, "\t-r <file>: Replay a recorded PVT log file\n");
+  fprintf(stderr, "\t-b <counts>: Measure lookups/s for comma separated "
+                  "region counts\n");
+  fprintf(stderr, "\t-h: Show this text and exit\n");
+  exit(errcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, FAR char **argv)
+{
+  FAR char *counts;
+  FAR char *next;
+  int option;
+  int ret = OK;
+
+  if (argc < 2)
+    {
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+
+  while ((option = getopt(argc, argv, "tr:b:h")) != ERROR && ret == OK)
+    {
+      switch (option)
+        {
+          case 't':
+            ret = test();
+            break;
+
+          case 'r':
+            ret = replay_file(optarg, 2000);
+            break;
+
+          case 'b':
+            for (counts = optarg; counts && ret == OK; counts = next)
+              {
+                next = strchr(counts, ',');
+                if (next)
+                  {
+                    *next++ = '\0';
+                  }
+
+                ret = bench(atoi(counts));
+              }
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  return ret == OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,201 @@
+/****************************************************************************
+ * modules/sensing/manager/host/memutils/memory_manager/MemHandle.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __SENSING_MANAGER_HOST_MEMHANDLE_H
+#define __SENSING_MANAGER_HOST_MEMHANDLE_H
+
+/* Reference counted segments with the MemMgrLite::MemHandle interface.
+ * A pool is a fixed number of segments of a fixed size, so a subscriber
+ * holding on to its segments makes the allocations of the publisher fail
+ * as on the target.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "memutils/common_utils/common_errcode.h"
+
+namespace MemMgrLite {
+
+typedef uint8_t PoolId;
+
+#define HOST_MH_NUM_POOLS  4
+#define HOST_MH_MAX_SEGS   64
+
+struct HostPool
+{
+  size_t  seg_size;
+  int     num_segs;
+  int     used;
+  int     max_used;
+  uint8_t refcnt[HOST_MH_MAX_SEGS];
+  uint8_t *area;
+};
+
+struct HostPools
+{
+  pthread_mutex_t lock;
+  HostPool pool[HOST_MH_NUM_POOLS];
+};
+
+inline HostPools &host_pools(void)
+{
+  static HostPools pools = { PTHREAD_MUTEX_INITIALIZER };
+  return pools;
+}
+
+/* Create a pool of num_segs segments of seg_size bytes */
+
+inline void host_create_pool(PoolId id, size_t seg_size, int num_segs)
+{
+  HostPool &p = host_pools().pool[id];
+
+  p.seg_size = seg_size;
+  p.num_segs = num_segs < HOST_MH_MAX_SEGS ? num_segs : HOST_MH_MAX_SEGS;
+  p.used     = 0;
+  p.max_used = 0;
+  p.area     = (uint8_t *)calloc(p.num_segs, seg_size);
+}
+
+class MemHandle {
+public:
+  MemHandle() : m_pool(0), m_seg(-1) {}
+  MemHandle(const MemHandle &mh) : m_pool(mh.m_pool), m_seg(mh.m_seg)
+  {
+    ref(1);
+  }
+  ~MemHandle() { freeSeg(); }
+
+  MemHandle &operator=(const MemHandle &mh)
+  {
+    if (this != &mh)
+      {
+        MemHandle tmp(mh);
+
+        freeSeg();
+        m_pool     = tmp.m_pool;
+        m_seg      = tmp.m_seg;
+        tmp.m_seg  = -1;
+      }
+
+    return *this;
+  }
+
+  err_t allocSeg(PoolId id, size_t size_for_check)
+  {
+    HostPools &pools = host_pools();
+    HostPool &p = pools.pool[id];
+    err_t ret = ERR_MEM_EMPTY;
+    int i;
+
+    freeSeg();
+    if (size_for_check > p.seg_size)
+      {
+        return ERR_DATA_SIZE;
+      }
+
+    pthread_mutex_lock(&pools.lock);
+    for (i = 0; i < p.num_segs; i++)
+      {
+        if (p.refcnt[i] == 0)
+          {
+            p.refcnt[i] = 1;
+            if (++p.used > p.max_used)
+              {
+                p.max_used = p.used;
+              }
+
+            m_pool = id;
+            m_seg  = i;
+            ret    = ERR_OK;
+            break;
+          }
+      }
+
+    pthread_mutex_unlock(&pools.lock);
+    return ret;
+  }
+
+  void freeSeg()
+  {
+    if (isAvail())
+      {
+        ref(-1);
+        m_seg = -1;
+      }
+  }
+
+  bool  isAvail() const { return m_seg >= 0; }
+  bool  isNull() const { return !isAvail(); }
+  void *getPa() const { return getVa(); }
+  void *getVa() const
+  {
+    HostPool &p = host_pools().pool[m_pool];
+    return isAvail() ? p.area + m_seg * p.seg_size : NULL;
+  }
+
+  static int getUsed(PoolId id) { return host_pools().pool[id].used; }
+  static int getMaxUsed(PoolId id) { return host_pools().pool[id].max_used; }
+
+private:
+  void ref(int n)
+  {
+    HostPools &pools = host_pools();
+
+    if (!isAvail())
+      {
+        return;
+      }
+
+    pthread_mutex_lock(&pools.lock);
+    HostPool &p = pools.pool[m_pool];
+    p.refcnt[m_seg] += n;
+    if (p.refcnt[m_seg] == 0)
+      {
+        p.used--;
+      }
+
+    pthread_mutex_unlock(&pools.lock);
+  }
+
+  PoolId m_pool;
+  int    m_seg;
+};
+
+} /* namespace MemMgrLite */
+
+#endif /* __SENSING_MANAGER_HOST_MEMHANDLE_H */
@@ -0,0 +1,158 @@
+/****************************************************************************
+ * modules/sensing/manager/host/memutils/message/Message.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __SENSING_MANAGER_HOST_MESSAGE_H
+#define __SENSING_MANAGER_HOST_MESSAGE_H
+
+/* Unbounded message queues with the MsgLib interface used by the sensor
+ * manager.  recv() is a cancellation point as on the target.
+ */
+
+#include <assert.h>
+#include <pthread.h>
+
+#include "memutils/message/MsgPacket.h"
+
+#define TIME_FOREVER  (unsigned)-1
+#define F_ASSERT(c)   assert(c)
+
+#define HOST_MSG_NUM_QUES  4
+
+class MsgQueBlock
+{
+public:
+  MsgQueBlock() : m_head(NULL), m_tail(NULL)
+  {
+    pthread_mutex_init(&m_lock, NULL);
+    pthread_cond_init(&m_cond, NULL);
+  }
+
+  template<typename T>
+  err_t send(MsgPri pri, MsgType type, MsgQueId reply, const T &param)
+  {
+    MsgPacket *msg = new MsgPacket(type, param);
+
+    pthread_mutex_lock(&m_lock);
+    if (m_tail)
+      {
+        m_tail->m_next = msg;
+      }
+    else
+      {
+        m_head = msg;
+      }
+
+    m_tail = msg;
+    pthread_cond_signal(&m_cond);
+    pthread_mutex_unlock(&m_lock);
+    return ERR_OK;
+  }
+
+  err_t recv(unsigned ms, MsgPacket **msg)
+  {
+    pthread_mutex_lock(&m_lock);
+    pthread_cleanup_push(unlock, &m_lock);
+    while (m_head == NULL)
+      {
+        pthread_cond_wait(&m_cond, &m_lock);
+      }
+
+    *msg = m_head;
+    pthread_cleanup_pop(1);
+    return ERR_OK;
+  }
+
+  err_t pop()
+  {
+    MsgPacket *msg;
+
+    pthread_mutex_lock(&m_lock);
+    msg    = m_head;
+    m_head = msg->m_next;
+    if (m_head == NULL)
+      {
+        m_tail = NULL;
+      }
+
+    pthread_mutex_unlock(&m_lock);
+    delete msg;
+    return ERR_OK;
+  }
+
+private:
+  static void unlock(void *lock)
+  {
+    pthread_mutex_unlock(static_cast<pthread_mutex_t *>(lock));
+  }
+
+  pthread_mutex_t m_lock;
+  pthread_cond_t  m_cond;
+  MsgPacket      *m_head;
+  MsgPacket      *m_tail;
+};
+
+class MsgLib
+{
+public:
+  static err_t referMsgQueBlock(MsgQueId id, MsgQueBlock **que)
+  {
+    static MsgQueBlock ques[HOST_MSG_NUM_QUES];
+
+    if (id >= HOST_MSG_NUM_QUES)
+      {
+        return ERR_QUE_READ;
+      }
+
+    *que = &ques[id];
+    return ERR_OK;
+  }
+
+  template<typename T>
+  static err_t send(MsgQueId dest, MsgPri pri, MsgType type, MsgQueId reply,
+                    const T &param)
+  {
+    MsgQueBlock *que;
+    err_t err_code = referMsgQueBlock(dest, &que);
+
+    if (err_code == ERR_OK)
+      {
+        err_code = que->send(pri, type, reply, param);
+      }
+
+    return err_code;
+  }
+};
+
+#endif /* __SENSING_MANAGER_HOST_MESSAGE_H */
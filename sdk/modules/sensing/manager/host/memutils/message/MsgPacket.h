@@ -0,0 +1,94 @@
+/****************************************************************************
+ * modules/sensing/manager/host/memutils/message/MsgPacket.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __SENSING_MANAGER_HOST_MSGPACKET_H
+#define __SENSING_MANAGER_HOST_MSGPACKET_H
+
+/* A message carrying a copy of any object, as MsgLib does on the target */
+
+#include <stdint.h>
+
+#include "memutils/common_utils/common_errcode.h"
+#include "memutils/message/message_type.h"
+
+typedef uint8_t  MsgQueId;
+typedef uint16_t MsgType;
+
+enum MsgPri
+{
+  MsgPriNormal,
+  MsgPriHigh,
+  NumMsgPri
+};
+
+#define MSG_QUE_NULL  0xff
+
+class MsgPacket
+{
+public:
+  template<typename T>
+  MsgPacket(MsgType type, const T &param)
+    : m_type(type)
+    , m_next(NULL)
+    , m_param(new T(param))
+    , m_destroy(destroy<T>)
+  {
+  }
+
+  ~MsgPacket() { m_destroy(m_param); }
+
+  MsgType getType() const { return m_type; }
+
+  template<typename T>
+  T moveParam()
+  {
+    return *static_cast<T *>(m_param);
+  }
+
+  MsgType    m_type;
+  MsgPacket *m_next;
+
+private:
+  template<typename T>
+  static void destroy(void *param)
+  {
+    delete static_cast<T *>(param);
+  }
+
+  void *m_param;
+  void (*m_destroy)(void *);
+};
+
+#endif /* __SENSING_MANAGER_HOST_MSGPACKET_H */
@@ -0,0 +1,63 @@
+/****************************************************************************
+ * modules/sensing/manager/host/sdk/config.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __SENSING_MANAGER_HOST_SDK_CONFIG_H
+#define __SENSING_MANAGER_HOST_SDK_CONFIG_H
+
+/* Configuration for building the sensor manager on the host.  The
+ * synchronous variant of the benchmark is built with -DSENSORMGR_SYNC.
+ */
+
+#include <sys/types.h>
+#include <pthread.h>
+
+#define OK    0
+#define ERROR -1
+#define FAR
+
+#define CONFIG_SENSING_MANAGER 1
+#ifndef SENSORMGR_SYNC
+#  define CONFIG_SENSING_MANAGER_ASYNC 1
+#endif
+#define CONFIG_CLOCK_MONOTONIC 1
+
+/* NuttX pthread types */
+
+typedef void *pthread_addr_t;
+typedef pthread_addr_t (*pthread_startroutine_t)(pthread_addr_t);
+
+#define INVALID_PROCESS_ID ((pthread_t)-1)
+
+#endif /* __SENSING_MANAGER_HOST_SDK_CONFIG_H */
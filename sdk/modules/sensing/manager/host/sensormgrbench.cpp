@@ -0,0 +1,529 @@
+/****************************************************************************
+ * modules/sensing/manager/host/sensormgrbench.cpp
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark of the sensor manager fan-out.  An accelerometer
+ *   publishes samples in MemHandles at a fixed period to three clients: a
+ *   step counter and a gesture detector with short callbacks, and a logger
+ *   whose callback blocks as when writing to an SD card.  The end-to-end
+ *   latency from the publication to each callback is reported, with the
+ *   delivery statistics of the manager.
+ *
+ *   sensormgrbench-sync calls every callback on the manager thread.
+ *   sensormgrbench gives the logger its own delivery thread and queue.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <algorithm>
+
+#include "sensing/sensor_api.h"
+#include "sensing/sensor_id.h"
+#include "sensing/sensor_ecode.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SENSOR_MGR_QUE   0
+#define ACCEL_POOL       0
+#define ACCEL_NUM_SEGS   32
+
+#define DEF_SAMPLES      400
+#define DEF_PERIOD       2000   /* us */
+#define DEF_LOGGER_WORK  6000   /* us */
+#define DEF_DEPTH        8
+
+#define NCLIENTS         3
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct sample_s
+{
+  uint64_t stamp;     /* publication time [ns] */
+  int16_t  xyz[3 * 8];
+};
+
+struct client_s
+{
+  const char               *name;
+  unsigned int              id;
+  unsigned int              work;      /* callback time [us] */
+  bool                      blocking;  /* sleep rather than compute */
+  sensor_data_mh_callback_t callback;
+  uint32_t                 *latency;   /* [us] */
+  volatile unsigned int     received;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static bool step_callback(sensor_command_data_mh_t &data);
+static bool gesture_callback(sensor_command_data_mh_t &data);
+static bool logger_callback(sensor_command_data_mh_t &data);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct client_s g_clients[NCLIENTS] =
+{
+  { "stepcount", stepcounterID, 20,  false, step_callback    },
+  { "gesture",   gestureID,     50,  false, gesture_callback },
+  { "logger",    app0ID,        0,   true,  logger_callback  },
+};
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int g_responses;
+static unsigned int g_errors;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static bool on_data(struct client_s *client, sensor_command_data_mh_t &data)
+{
+  struct sample_s *sample = (struct sample_s *)data.mh.getPa();
+  uint64_t start = now_ns();
+
+  client->latency[client->received] = (start - sample->stamp) / 1000;
+
+  if (client->blocking)
+    {
+      usleep(client->work);
+    }
+  else
+    {
+      while (now_ns() - start < client->work * 1000ull)
+        {
+        }
+    }
+
+  pthread_mutex_lock(&g_lock);
+  client->received++;
+  pthread_mutex_unlock(&g_lock);
+  return true;
+}
+
+static bool step_callback(sensor_command_data_mh_t &data)
+{
+  return on_data(&g_clients[0], data);
+}
+
+static bool gesture_callback(sensor_command_data_mh_t &data)
+{
+  return on_data(&g_clients[1], data);
+}
+
+static bool logger_callback(sensor_command_data_mh_t &data)
+{
+  return on_data(&g_clients[2], data);
+}
+
+static void response_callback(unsigned int code, unsigned int ercd,
+                              unsigned int self)
+{
+  pthread_mutex_lock(&g_lock);
+  g_responses++;
+  if (ercd != SS_ECODE_OK)
+    {
+      fprintf(stderr, "ERROR: command %u of %u: %u\n", code, self, ercd);
+      g_errors++;
+    }
+
+  pthread_mutex_unlock(&g_lock);
+}
+
+static unsigned int read_locked(volatile unsigned int *value)
+{
+  unsigned int ret;
+
+  pthread_mutex_lock(&g_lock);
+  ret = *value;
+  pthread_mutex_unlock(&g_lock);
+  return ret;
+}
+
+static bool wait_responses(unsigned int n, unsigned int timeout_ms)
+{
+  while (read_locked(&g_responses) < n)
+    {
+      if (timeout_ms-- == 0)
+        {
+          return false;
+        }
+
+      usleep(1000);
+    }
+
+  return true;
+}
+
+/* All the publications are either delivered, or dropped or decimated by
+ * the delivery of the client.
+ */
+
+static unsigned int settled(struct client_s *client)
+{
+  unsigned int n = read_locked(&client->received);
+
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+  sensor_delivery_stats_t stats;
+
+  if (SS_GetSensorDeliveryStats(client->id, &stats))
+    {
+      n += stats.dropped + stats.decimated;
+    }
+#endif
+
+  return n;
+}
+
+static void register_client(unsigned int id, unsigned int subscriptions,
+                            sensor_data_mh_callback_t callback)
+{
+  sensor_command_register_t reg;
+
+  memset(&reg, 0, sizeof(reg));
+  reg.header.code   = ResisterClient;
+  reg.self          = id;
+  reg.subscriptions = subscriptions;
+  reg.callback_mh   = callback;
+  SS_SendSensorResister(&reg);
+}
+
+static void release_client(unsigned int id)
+{
+  sensor_command_release_t rel;
+
+  memset(&rel, 0, sizeof(rel));
+  rel.header.code = ReleaseClient;
+  rel.self        = id;
+  SS_SendSensorRelease(&rel);
+}
+
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+static void set_delivery(unsigned int id, unsigned int depth,
+                         unsigned int decimation)
+{
+  sensor_command_delivery_t dlv;
+
+  memset(&dlv, 0, sizeof(dlv));
+  dlv.header.code = SetDelivery;
+  dlv.self        = id;
+  dlv.depth       = depth;
+  dlv.decimation  = decimation;
+  SS_SendSensorSetDelivery(&dlv);
+}
+#endif
+
+static void show_usage(const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-n <samples>] [-p <period>] [-w <work>] "
+                  "[-d <depth>] [-D <decimation>]\n", progname);
+  fprintf(stderr, "\t-n <samples>: Number of publications. Default: %d\n",
+                  DEF_SAMPLES);
+  fprintf(stderr, "\t-p <period>: Publication period [us]. Default: %d\n",
+                  DEF_PERIOD);
+  fprintf(stderr, "\t-w <work>: Logger callback time [us]. Default: %d\n",
+                  DEF_LOGGER_WORK);
+  fprintf(stderr, "\t-d <depth>: Logger queue depth. Default: %d\n",
+                  DEF_DEPTH);
+  fprintf(stderr, "\t-D <decimation>: Logger decimation. Default: 1\n");
+  exit(errcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  unsigned int samples = DEF_SAMPLES;
+  unsigned int period = DEF_PERIOD;
+  unsigned int depth = DEF_DEPTH;
+  unsigned int decimation = 1;
+  unsigned int nresponses;
+  unsigned int allocfail = 0;
+  unsigned int sent = 0;
+  struct timespec next;
+  uint64_t elapsed;
+  bool failed = false;
+  int option;
+  int i;
+
+  g_clients[2].work = DEF_LOGGER_WORK;
+
+  while ((option = getopt(argc, argv, ":n:p:w:d:D:h")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'n':
+            samples = atoi(optarg);
+            break;
+
+          case 'p':
+            period = atoi(optarg);
+            break;
+
+          case 'w':
+            g_clients[2].work = atoi(optarg);
+            break;
+
+          case 'd':
+            depth = atoi(optarg);
+            break;
+
+          case 'D':
+            decimation = atoi(optarg);
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  MemMgrLite::host_create_pool(ACCEL_POOL, sizeof(struct sample_s),
+                               ACCEL_NUM_SEGS);
+
+  for (i = 0; i < NCLIENTS; i++)
+    {
+      g_clients[i].latency = new uint32_t[samples];
+    }
+
+  /* The publisher first, then its subscribers */
+
+  SS_ActivateSensorSubSystem(SENSOR_MGR_QUE, response_callback);
+
+  /* On the target the manager task preempts the caller and is ready on
+   * return.  The host ignores the priority, so give it time to start.
+   */
+
+  usleep(100 * 1000);
+
+  register_client(accelID, 0, NULL);
+  nresponses = 1;
+  wait_responses(nresponses, 1000);
+
+  for (i = 0; i < NCLIENTS; i++)
+    {
+      register_client(g_clients[i].id, 1 << accelID, g_clients[i].callback);
+      nresponses++;
+    }
+
+#ifndef CONFIG_SENSING_MANAGER_ASYNC
+  (void)depth;
+  (void)decimation;
+#else
+  set_delivery(g_clients[0].id, 0, 1);
+  set_delivery(g_clients[1].id, 0, 1);
+  set_delivery(g_clients[2].id, depth, decimation);
+  nresponses += 3;
+#endif
+
+  if (!wait_responses(nresponses, 1000) || g_errors)
+    {
+      fprintf(stderr, "ERROR: Failed to set up the clients\n");
+      return EXIT_FAILURE;
+    }
+
+  /* Publish at a fixed period */
+
+  clock_gettime(CLOCK_MONOTONIC, &next);
+  elapsed = now_ns();
+
+  for (unsigned int k = 0; k < samples; k++)
+    {
+      sensor_command_data_mh_t packet;
+      struct sample_s *sample;
+
+      next.tv_nsec += period * 1000;
+      while (next.tv_nsec >= 1000000000)
+        {
+          next.tv_nsec -= 1000000000;
+          next.tv_sec++;
+        }
+
+      clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+      if (packet.mh.allocSeg(ACCEL_POOL, sizeof(struct sample_s)) != ERR_OK)
+        {
+          allocfail++;
+          continue;
+        }
+
+      sample = (struct sample_s *)packet.mh.getPa();
+      sample->stamp = now_ns();
+
+      packet.header.code = SendDataMH;
+      packet.self        = accelID;
+      packet.time        = k;
+      packet.fs          = 1000000 / period;
+      packet.size        = 8;
+      SS_SendSensorDataMH(&packet);
+      sent++;
+    }
+
+  /* Wait for every publication to reach every client */
+
+  wait_responses(nresponses + sent, 60000);
+  for (i = 0; i < NCLIENTS; i++)
+    {
+      while (settled(&g_clients[i]) < sent)
+        {
+          usleep(1000);
+        }
+    }
+
+  elapsed = now_ns() - elapsed;
+
+  printf("%s, %u samples every %u us, logger %u us",
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+         "async",
+#else
+         "sync",
+#endif
+         samples, period, g_clients[2].work);
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+  printf(", depth %u, decimation %u", depth, decimation);
+#endif
+  printf("\n");
+  printf("%-10s %6s %8s %8s %8s %7s %7s %6s\n", "client", "recv",
+         "avg[us]", "p99[us]", "max[us]", "dropped", "decim", "maxq");
+
+  for (i = 0; i < NCLIENTS; i++)
+    {
+      struct client_s *client = &g_clients[i];
+      unsigned int n = client->received;
+      uint32_t dropped = 0;
+      uint32_t decimated = 0;
+      uint32_t maxq = 0;
+      uint64_t sum = 0;
+
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+      sensor_delivery_stats_t stats;
+
+      if (SS_GetSensorDeliveryStats(client->id, &stats))
+        {
+          dropped   = stats.dropped;
+          decimated = stats.decimated;
+          maxq      = stats.max_queued;
+          if (stats.delivered != n)
+            {
+              printf("ERROR: %s: %u delivered\n", client->name,
+                     stats.delivered);
+              failed = true;
+            }
+        }
+#endif
+
+      for (unsigned int k = 0; k < n; k++)
+        {
+          sum += client->latency[k];
+        }
+
+      std::sort(client->latency, client->latency + n);
+
+      printf("%-10s %6u %8.0f %8u %8u %7u %7u %6u\n", client->name, n,
+             n ? (double)sum / n : 0.0,
+             n ? client->latency[n * 99 / 100] : 0,
+             n ? client->latency[n - 1] : 0, dropped, decimated, maxq);
+    }
+
+  printf("run time %.3f s, %u allocation failures, max %d of %d "
+         "segments in use\n", elapsed / 1e9, allocfail,
+         MemMgrLite::MemHandle::getMaxUsed(ACCEL_POOL), ACCEL_NUM_SEGS);
+
+  /* Release the subscribers, then the publisher */
+
+  for (i = 0; i < NCLIENTS; i++)
+    {
+      release_client(g_clients[i].id);
+    }
+
+  release_client(accelID);
+  nresponses += sent + NCLIENTS + 1;
+
+  if (!wait_responses(nresponses, 1000) || g_errors)
+    {
+      printf("ERROR: %u command errors\n", g_errors);
+      failed = true;
+    }
+
+  SS_DeactivateSensorSubSystem();
+
+  if (MemMgrLite::MemHandle::getUsed(ACCEL_POOL) != 0)
+    {
+      printf("ERROR: %d segments leaked\n",
+             MemMgrLite::MemHandle::getUsed(ACCEL_POOL));
+      failed = true;
+    }
+
+  printf("verify: %s\n", failed ? "FAILED" : "OK");
+
+  for (i = 0; i < NCLIENTS; i++)
+    {
+      delete[] g_clients[i].latency;
+    }
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,379 @@
+/****************************************************************************
+ * modules/sensing/manager/sensor_delivery.cpp
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <sdk/debug.h>
+
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include "sensor_delivery.h"
+#include "sensing/sensor_ecode.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SENSING_MANAGER_ASYNC_PRIORITY
+#  define CONFIG_SENSING_MANAGER_ASYNC_PRIORITY  100
+#endif
+
+#ifndef CONFIG_SENSING_MANAGER_ASYNC_STACKSIZE
+#  define CONFIG_SENSING_MANAGER_ASYNC_STACKSIZE 2048
+#endif
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#  define DELIVERY_CLOCK CLOCK_MONOTONIC
+#else
+#  define DELIVERY_CLOCK CLOCK_REALTIME
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t delivery_time_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(DELIVERY_CLOCK, &ts);
+  return (uint32_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/*--------------------------------------------------------------------*/
+SensorDelivery::SensorDelivery(const sensor_command_delivery_t &cmd)
+  : m_decimation(cmd.decimation)
+  , m_queue(NULL)
+  , m_depth(cmd.depth)
+  , m_head(0)
+  , m_count(0)
+  , m_stop(false)
+  , m_latency_sum(0)
+{
+  memset(m_phase, 0, sizeof(m_phase));
+  memset(&m_stats, 0, sizeof(m_stats));
+
+  pthread_mutex_init(&m_lock, NULL);
+  sem_init(&m_items, 0, 0);
+}
+
+/*--------------------------------------------------------------------*/
+FAR void *SensorDelivery::thread_entry(FAR void *arg)
+{
+  static_cast<SensorDelivery *>(arg)->run();
+  return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+/* Called with m_lock held.  Returns the slot for a new publication; when
+ * the queue is full, the oldest one is dropped and its slot is reused.
+ */
+
+SensorDelivery::entry_t *SensorDelivery::push(void)
+{
+  entry_t *entry;
+
+  if (m_count == m_depth)
+    {
+      entry  = &m_queue[m_head];
+      m_head = (m_head + 1) % m_depth;
+      m_stats.dropped++;
+      return entry;
+    }
+
+  entry = &m_queue[(m_head + m_count) % m_depth];
+  m_count++;
+
+  if (m_count > m_stats.max_queued)
+    {
+      m_stats.max_queued = m_count;
+    }
+
+  return entry;
+}
+
+/*--------------------------------------------------------------------*/
+void SensorDelivery::account(uint32_t stamp)
+{
+  uint32_t latency = delivery_time_us() - stamp;
+
+  pthread_mutex_lock(&m_lock);
+
+  m_stats.delivered++;
+  m_latency_sum += latency;
+  if (latency > m_stats.latency_max)
+    {
+      m_stats.latency_max = latency;
+    }
+
+  pthread_mutex_unlock(&m_lock);
+}
+
+/*--------------------------------------------------------------------*/
+void SensorDelivery::run(void)
+{
+  while (1)
+    {
+      while (sem_wait(&m_items) != 0)
+        {
+          DEBUGASSERT(errno == EINTR);
+        }
+
+      pthread_mutex_lock(&m_lock);
+
+      if (m_stop)
+        {
+          pthread_mutex_unlock(&m_lock);
+          break;
+        }
+
+      /* Take the publication out of the queue, the copy keeps a reference
+       * to the MemHandle until the callback returns.
+       */
+
+      entry_t entry = m_queue[m_head];
+      m_queue[m_head].data_mh.mh = MemMgrLite::MemHandle();
+
+      m_head = (m_head + 1) % m_depth;
+      m_count--;
+
+      pthread_mutex_unlock(&m_lock);
+
+      account(entry.stamp);
+
+      if (entry.callback_mh)
+        {
+          entry.callback_mh(entry.data_mh);
+        }
+      else
+        {
+          entry.callback(entry.data);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+SensorDelivery *SensorDelivery::create(const sensor_command_delivery_t &cmd,
+                                       unsigned int *ercd)
+{
+  SensorDelivery     *delivery;
+  pthread_attr_t     attr;
+  struct sched_param sch_param;
+  int                ret;
+
+  delivery = new SensorDelivery(cmd);
+  if (!delivery)
+    {
+      *ercd = SS_ECODE_TASK_CREATE_ERROR;
+      return NULL;
+    }
+
+  if (delivery->m_depth == 0)
+    {
+      return delivery;
+    }
+
+  delivery->m_queue = new entry_t[delivery->m_depth];
+  if (!delivery->m_queue)
+    {
+      delivery->m_depth = 0;
+      delete delivery;
+      *ercd = SS_ECODE_TASK_CREATE_ERROR;
+      return NULL;
+    }
+
+  pthread_attr_init(&attr);
+  sch_param.sched_priority = cmd.priority ? cmd.priority :
+                             CONFIG_SENSING_MANAGER_ASYNC_PRIORITY;
+  pthread_attr_setschedparam(&attr, &sch_param);
+  pthread_attr_setstacksize(&attr, cmd.stacksize ? cmd.stacksize :
+                            CONFIG_SENSING_MANAGER_ASYNC_STACKSIZE);
+
+  ret = pthread_create(&delivery->m_thread, &attr,
+                       SensorDelivery::thread_entry,
+                       static_cast<pthread_addr_t>(delivery));
+  pthread_attr_destroy(&attr);
+
+  if (ret != 0)
+    {
+      delete[] delivery->m_queue;
+      delivery->m_queue = NULL;
+      delivery->m_depth = 0;
+      delete delivery;
+      *ercd = SS_ECODE_TASK_CREATE_ERROR;
+      return NULL;
+    }
+
+  return delivery;
+}
+
+/*--------------------------------------------------------------------*/
+SensorDelivery::~SensorDelivery()
+{
+  if (m_depth != 0)
+    {
+      /* Wait for the callback in progress, the rest of the queue is
+       * discarded and its MemHandles are released with the queue.
+       */
+
+      pthread_mutex_lock(&m_lock);
+      m_stop = true;
+      pthread_mutex_unlock(&m_lock);
+
+      sem_post(&m_items);
+      pthread_join(m_thread, NULL);
+
+      delete[] m_queue;
+    }
+
+  sem_destroy(&m_items);
+  pthread_mutex_destroy(&m_lock);
+}
+
+/*--------------------------------------------------------------------*/
+/* Decimation is counted for each publisher, so a client subscribing to
+ * several sensors gets 1 of N publications of each of them.
+ */
+
+bool SensorDelivery::decimate(unsigned int publisher)
+{
+  bool skip;
+
+  if (m_decimation <= 1 || publisher >= NumOfSensorClientID)
+    {
+      return false;
+    }
+
+  skip = (m_phase[publisher] != 0);
+  if (++m_phase[publisher] >= m_decimation)
+    {
+      m_phase[publisher] = 0;
+    }
+
+  if (skip)
+    {
+      pthread_mutex_lock(&m_lock);
+      m_stats.decimated++;
+      pthread_mutex_unlock(&m_lock);
+    }
+
+  return skip;
+}
+
+/*--------------------------------------------------------------------*/
+void SensorDelivery::deliver(sensor_data_callback_t callback,
+                             sensor_command_data_t &data)
+{
+  entry_t *entry;
+  bool     wake;
+
+  /* Data behind a plain pointer is only valid during the dispatch */
+
+  if (m_depth == 0 || data.is_ptr)
+    {
+      account(delivery_time_us());
+      callback(data);
+      return;
+    }
+
+  pthread_mutex_lock(&m_lock);
+
+  wake = (m_count < m_depth);
+  entry = push();
+  entry->stamp       = delivery_time_us();
+  entry->callback    = callback;
+  entry->callback_mh = NULL;
+  entry->data        = data;
+  entry->data_mh.mh  = MemMgrLite::MemHandle();
+
+  pthread_mutex_unlock(&m_lock);
+
+  if (wake)
+    {
+      sem_post(&m_items);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+void SensorDelivery::deliver(sensor_data_mh_callback_t callback,
+                             sensor_command_data_mh_t &data)
+{
+  entry_t *entry;
+  bool     wake;
+
+  if (m_depth == 0)
+    {
+      account(delivery_time_us());
+      callback(data);
+      return;
+    }
+
+  pthread_mutex_lock(&m_lock);
+
+  wake = (m_count < m_depth);
+  entry = push();
+  entry->stamp       = delivery_time_us();
+  entry->callback    = NULL;
+  entry->callback_mh = callback;
+  entry->data_mh     = data;
+
+  pthread_mutex_unlock(&m_lock);
+
+  if (wake)
+    {
+      sem_post(&m_items);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+void SensorDelivery::get_stats(sensor_delivery_stats_t *stats)
+{
+  pthread_mutex_lock(&m_lock);
+
+  *stats = m_stats;
+  stats->queued      = m_count;
+  stats->latency_avg = m_stats.delivered ?
+                       (uint32_t)(m_latency_sum / m_stats.delivered) : 0;
+
+  pthread_mutex_unlock(&m_lock);
+}
@@ -0,0 +1,118 @@
+/****************************************************************************
+ * modules/sensing/manager/sensor_delivery.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __SENSING_MANAGER_SENSOR_DELIVERY_H
+#define __SENSING_MANAGER_SENSOR_DELIVERY_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "sensing/sensor_id.h"
+#include "sensing/sensor_api.h"
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Delivery of the published data to one client: decimation, statistics
+ * and, when a queue depth is given, a bounded queue drained by a thread of
+ * the client.  Publications are queued by copying the command, so the
+ * data of a MemHandle is shared by reference count and never copied.
+ */
+
+class SensorDelivery
+{
+
+public:
+  static SensorDelivery *create(const sensor_command_delivery_t &cmd,
+                                unsigned int *ercd);
+
+  ~SensorDelivery();
+
+  bool decimate(unsigned int publisher);
+
+  void deliver(sensor_data_callback_t callback,
+               sensor_command_data_t &data);
+  void deliver(sensor_data_mh_callback_t callback,
+               sensor_command_data_mh_t &data);
+
+  void get_stats(sensor_delivery_stats_t *stats);
+
+private:
+  SensorDelivery(const sensor_command_delivery_t &cmd);
+
+  /*** private members ***/
+
+  /** queued publication */
+  typedef struct
+  {
+    uint32_t                  stamp;       /** dispatch time [us] */
+    sensor_data_callback_t    callback;
+    sensor_data_mh_callback_t callback_mh;
+    sensor_command_data_t     data;
+    sensor_command_data_mh_t  data_mh;
+  } entry_t;
+
+  unsigned int    m_decimation;
+  uint8_t         m_phase[NumOfSensorClientID]; /* per publisher */
+
+  entry_t        *m_queue;
+  unsigned int    m_depth;
+  unsigned int    m_head;
+  unsigned int    m_count;
+  bool            m_stop;
+
+  pthread_t       m_thread;
+  pthread_mutex_t m_lock;
+  sem_t           m_items;
+
+  sensor_delivery_stats_t m_stats;
+  uint64_t        m_latency_sum;
+
+  /*** private mathods ***/
+  entry_t *push(void);
+  void    account(uint32_t stamp);
+  void    run(void);
+
+  static FAR void *thread_entry(FAR void *arg);
+};
+
+#endif /* __SENSING_MANAGER_SENSOR_DELIVERY_H */
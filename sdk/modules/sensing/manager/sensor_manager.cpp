@@ -94,7 +94,12 @@ SensorManager::MsgProc SensorManager::MsgProcTbl[] =
 #else
     &SensorManager::ignore,
 #endif /* __cplusplus */
-    &SensorManager::send_result
+    &SensorManager::send_result,
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+    &SensorManager::set_delivery
+#else
+    &SensorManager::ignore
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
 };
 
 /****************************************************************************
@@ -114,6 +119,19 @@ void SensorManager::create(MsgQueId selfMId, api_response_callback_t callback)
     }
 }
 
+/*--------------------------------------------------------------------*/
+SensorManager::~SensorManager()
+{
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+  for (int i = 0; i < 24; i++)
+    {
+      replace_delivery(i, NULL);
+    }
+
+  pthread_mutex_destroy(&m_delivery_lock);
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
+}
+
 /*--------------------------------------------------------------------*/
 void SensorManager::run(void)
 {
@@ -221,6 +239,9 @@ void SensorManager::release_client(MsgPacket* packet)
   power_table[rel.get_self()].subscribers  = 0x00;
   power_table[rel.get_self()].callback     = 0x00;
 #endif /* CONFIG_SENSING_MANAGER_POWERCTRL */
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+  replace_delivery(rel.get_self(), NULL);
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
 
   response(rel.header.code, SS_ECODE_OK, rel.get_self());
 }
@@ -291,7 +312,20 @@ void SensorManager::send_data(MsgPacket* packet)
               return;
             }
 
-          client_table[i].callback(data);/* callback */
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+          if (delivery_table[i])
+            {
+              if (!delivery_table[i]->decimate(data.get_self()))
+                {
+                  delivery_table[i]->deliver(client_table[i].callback, data);
+                }
+            }
+          else
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
+            {
+              client_table[i].callback(data);/* callback */
+            }
+
           j &= ~(0x01 << i);
         }
     }
@@ -326,7 +360,21 @@ void SensorManager::send_data_mh(MsgPacket* packet)
               return;
             }
 
-          client_table[i].callback_mh(data);/* callback */
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+          if (delivery_table[i])
+            {
+              if (!delivery_table[i]->decimate(data.get_self()))
+                {
+                  delivery_table[i]->deliver(client_table[i].callback_mh,
+                                             data);
+                }
+            }
+          else
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
+            {
+              client_table[i].callback_mh(data);/* callback */
+            }
+
           j &= ~(0x01 << i);
         }
     }
@@ -439,6 +487,75 @@ void SensorManager::clear_power(MsgPacket* packet)
 }
 #endif /* CONFIG_SENSING_MANAGER_POWERCTRL */
 
+/*--------------------------------------------------------------------*/
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+void SensorManager::replace_delivery(unsigned int id,
+                                     SensorDelivery *delivery)
+{
+  SensorDelivery *old;
+
+  pthread_mutex_lock(&m_delivery_lock);
+  old = delivery_table[id];
+  delivery_table[id] = delivery;
+  pthread_mutex_unlock(&m_delivery_lock);
+
+  /* Stopping the delivery thread waits for its callback in progress */
+
+  delete old;
+}
+
+/*--------------------------------------------------------------------*/
+void SensorManager::set_delivery(MsgPacket* packet)
+{
+  sensor_command_delivery_t dlv =
+    packet->moveParam<sensor_command_delivery_t>();
+  SensorDelivery *delivery;
+  unsigned int    ercd = SS_ECODE_OK;
+
+  if ((dlv.get_self() >= 24) || (client_table[dlv.get_self()].status == 0))
+    {
+      response(dlv.header.code,
+               SS_ECODE_REQUIRED_SENSOR_NOT_ACTIVE,
+               dlv.get_self());
+      return;
+    }
+
+  delivery = SensorDelivery::create(dlv, &ercd);
+  if (!delivery)
+    {
+      sensor_err("ERROR set_delivery failed\n");
+      response(dlv.header.code, ercd, dlv.get_self());
+      return;
+    }
+
+  replace_delivery(dlv.get_self(), delivery);
+
+  response(dlv.header.code, SS_ECODE_OK, dlv.get_self());
+}
+
+/*--------------------------------------------------------------------*/
+bool SensorManager::get_delivery_stats(unsigned int id,
+                                       sensor_delivery_stats_t *stats)
+{
+  bool ret = false;
+
+  if (id >= 24)
+    {
+      return false;
+    }
+
+  pthread_mutex_lock(&m_delivery_lock);
+  if (delivery_table[id])
+    {
+      delivery_table[id]->get_stats(stats);
+      ret = true;
+    }
+  pthread_mutex_unlock(&m_delivery_lock);
+
+  return ret;
+}
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
+
 /*--------------------------------------------------------------------*/
 void SensorManager::ignore(MsgPacket* packet)
 {
@@ -481,8 +598,8 @@ bool SS_ActivateSensorSubSystem(MsgQueId selfMId,
   int                ret = 0;
   pthread_attr_init(&attr);
   sch_param.sched_priority = SS_TASK_PRIORITY;
-  attr.stacksize           = SS_TASK_MANAGER_STACK_SIZE;
   pthread_attr_setschedparam(&attr, &sch_param);
+  pthread_attr_setstacksize(&attr, SS_TASK_MANAGER_STACK_SIZE);
 
   ret = pthread_create(&s_smng_pid,
                        &attr,
@@ -606,6 +723,32 @@ void SS_SendSensorClearPower(FAR sensor_command_power_t *packet)
 }
 #endif /* CONFIG_SENSING_MANAGER_POWERCTRL */
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+/*--------------------------------------------------------------------*/
+void SS_SendSensorSetDelivery(FAR sensor_command_delivery_t *packet)
+{
+  err_t er = MsgLib::send<sensor_command_delivery_t>(
+               TheSensorManager->get_mid(),
+               MsgPriNormal,
+               MSG_SENSOR_MGR_CMD_SET_DELIVERY,
+               MSG_QUE_NULL,
+               *packet);
+  F_ASSERT(er == ERR_OK);
+}
+
+/*--------------------------------------------------------------------*/
+bool SS_GetSensorDeliveryStats(unsigned int id,
+                               FAR sensor_delivery_stats_t *stats)
+{
+  if (TheSensorManager == NULL)
+    {
+      return false;
+    }
+
+  return TheSensorManager->get_delivery_stats(id, stats);
+}
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
+
 }/* extern "C"  */
 
 #ifdef __cplusplus
@@ -48,6 +48,10 @@
 #include "sensing/sensor_api.h"
 #include "sensing/sensor_ecode.h"
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+#  include "sensor_delivery.h"
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -63,7 +67,11 @@ public:
     return m_selfMId;
   }
 
-  ~SensorManager(){};
+  ~SensorManager();
+
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+  bool get_delivery_stats(unsigned int id, sensor_delivery_stats_t *stats);
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
 
 private:
   SensorManager(MsgQueId selfMId, api_response_callback_t callback)
@@ -82,7 +90,15 @@ private:
         power_table[i].subscribers  = 0;
         power_table[i].callback     = NULL;
 #endif /* CONFIG_SENSING_MANAGER_POWERCTRL */ 
+
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+        delivery_table[i]           = NULL;
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
       }
+
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+    pthread_mutex_init(&m_delivery_lock, NULL);
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
   };
 
   /*** private members ***/
@@ -136,6 +152,18 @@ private:
 
 #endif /* CONFIG_SENSING_MANAGER_POWERCTRL */ 
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC
+  /** delivery of each client, NULL for synchronous delivery of all data */
+  SensorDelivery *delivery_table[24]; /* 24 must be config.*/
+
+  /** protects delivery_table from SS_GetSensorDeliveryStats() */
+  pthread_mutex_t m_delivery_lock;
+
+  void    set_delivery(MsgPacket*);
+  void    replace_delivery(unsigned int id, SensorDelivery *delivery);
+
+#endif /* CONFIG_SENSING_MANAGER_ASYNC */
+
 };
 
 /****************************************************************************
@@ -0,0 +1,605 @@
+/****************************************************************************
+ * modules/sensing/tap/host/tapbench.cpp
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host golden vector test and benchmark of the tap library.
+ *
+ *   A 64Hz accelerometer stream with gravity, noise and tap impulses is
+ *   quantized as read from SCU.  The reference is the previous per sample
+ *   algorithm with a square root per sample and calcR() using the Z axis.
+ *   The tap counts of TapClass::write() for blocks of TAP_FIFO samples,
+ *   converted with sensor_preproc_convert(), must equal the reference for
+ *   every sample and parameter set.  Then the samples/s of the reference
+ *   with clock_gettime() per sample, with given time stamps, and of the
+ *   block write are reported.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <time.h>
+
+#include "sensing/tap.h"
+#include "sensing/sensor_preproc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TAP_FS           64
+#define TAP_INTERVAL     (1000000 / TAP_FS)
+#define TAP_FIFO         4
+#define TAP_SCALE        (2.0F / 32768.0F)
+#define DEF_SAMPLES      (1024 * 1024)
+#define DETECTION_COUNT  8
+#define BENCH_REPEAT     5
+
+#define MODE_REF_CLOCK   0
+#define MODE_REF         1
+#define MODE_SAMPLE      2
+#define MODE_BLOCK       3
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct raw_s
+{
+  int16_t x;
+  int16_t y;
+  int16_t z;
+};
+
+/* The algorithm before the block write, kept as the golden reference */
+
+class RefTapClass
+{
+public:
+  RefTapClass(const ST_TAP_OPEN *param, bool ybug)
+  {
+    memset(this, 0, sizeof(*this));
+    mTapPeriod = param->tap_period;
+    mPeakThres = param->peak_thres;
+    mLongThres = param->long_thres;
+    mStabFrame = param->stab_frame;
+    mYBug      = ybug;
+  }
+
+  int write(const ST_TAP_ACCEL *a)
+  {
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+      {
+        return D_SA_STATUS_E_UNEXPECTED;
+      }
+
+    return write(a, (ts.tv_sec * SEC_PER_US) + (ts.tv_nsec / NS_PER_US));
+  }
+
+  /* Not inlined, as the library is called through TapWrite_timestamp() */
+
+  __attribute__((noinline)) int write(const ST_TAP_ACCEL *a,
+                                      uint64_t endTime)
+  {
+    bool detectflg = detect(a->accel_x, a->accel_y, a->accel_z);
+    int tapcnt = 0;
+
+    if (mState == E_TAP_STATE_IDLE)
+      {
+        if (detectflg)
+          {
+            mTapCnt++;
+            mState = E_TAP_STATE_TAP;
+            mStartTime = endTime;
+          }
+        else
+          {
+            tapcnt = mTapCnt;
+            mTapCnt = 0;
+          }
+      }
+    else if (detectflg)
+      {
+        if (endTime - mStartTime > mTapPeriod)
+          {
+            tapcnt = mTapCnt;
+            mTapCnt = 1;
+          }
+        else
+          {
+            mTapCnt++;
+          }
+
+        mStartTime = endTime;
+      }
+    else if (endTime - mStartTime > mTapPeriod)
+      {
+        tapcnt = mTapCnt;
+        mTapCnt = 0;
+        mState = E_TAP_STATE_IDLE;
+      }
+
+    return tapcnt;
+  }
+
+private:
+  uint64_t    mTapPeriod;
+  float       mPeakThres;
+  float       mLongThres;
+  int         mStabFrame;
+  bool        mYBug;
+  int         mTapCnt;
+  E_TAP_STATE mState;
+  float       mR[TAP_BUF_LEN];
+  float       mX[TAP_BUF_LEN];
+  float       mY[TAP_BUF_LEN];
+  float       mZ[TAP_BUF_LEN];
+  int         mIndex;
+  int         mDetectionCount;
+  int         mStab;
+  uint64_t    mStartTime;
+
+  int getIndex(int idx)
+  {
+    int i = mIndex - idx - 1;
+
+    return i < 0 ? i + TAP_BUF_LEN : i;
+  }
+
+  float calcR(int i0, int j0)
+  {
+    int i    = getIndex(i0);
+    int j    = getIndex(j0);
+    float dx = mX[i] - mX[j];
+    float dy = mY[i] - mY[j];
+    float dz = mYBug ? mY[i] - mY[j] : mZ[i] - mZ[j];
+
+    return sqrtf(dx * dx + dy * dy + dz * dz);
+  }
+
+  bool detect(float x, float y, float z)
+  {
+    int index = mIndex;
+
+    if (++mIndex == TAP_BUF_LEN)
+      {
+        mIndex = 0;
+      }
+
+    mX[index] = x;
+    mY[index] = y;
+    mZ[index] = z;
+    mR[index] = sqrtf(x * x + y * y + z * z);
+
+    if (mDetectionCount == 0)
+      {
+        if (mR[index] > mPeakThres)
+          {
+            mDetectionCount = DETECTION_COUNT;
+          }
+
+        return false;
+      }
+
+    mDetectionCount--;
+    if (mR[index] > mPeakThres)
+      {
+        return false;
+      }
+
+    if (calcR(0, DETECTION_COUNT - mDetectionCount) > mLongThres)
+      {
+        mStab = 0;
+        return false;
+      }
+
+    if (++mStab <= mStabFrame)
+      {
+        return false;
+      }
+
+    mDetectionCount = 0;
+    return true;
+  }
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const ST_TAP_OPEN g_params[] =
+{
+  /* tap_period, peak_thres, long_thres, stab_frame */
+
+  { 400000.0F, 1.5F,  0.3F,  2 },
+  { 300000.0F, 1.2F,  0.25F, 0 },
+  { 500000.0F, 2.0F,  0.5F,  4 },
+  { 250000.0F, 1.05F, 0.1F,  1 },
+};
+
+static uint32_t g_seed = 0x12345678;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static float frand(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return (float)((g_seed >> 8) & 0xffff) / 65536.0F;
+}
+
+static int16_t quantize(float g)
+{
+  float v = roundf(g / TAP_SCALE);
+
+  return v > 32767 ? 32767 : v < -32768 ? -32768 : (int16_t)v;
+}
+
+/* Gravity on a slowly turning axis, noise, and bursts of one to three taps
+ * about every second and a half.
+ */
+
+static void make_stream(struct raw_s *raw, int num)
+{
+  float impulse = 0.0F;
+  float decay = 0.0F;
+  int next = 40;
+  int burst = 0;
+  int i;
+
+  for (i = 0; i < num; i++)
+    {
+      float a = (float)i / (TAP_FS * 30);
+      float n = 0.02F;
+
+      /* A tap is a jump which settles at various rates */
+
+      if (i == next)
+        {
+          impulse = 0.3F + 1.5F * frand();
+          decay = 0.5F + 0.5F * frand();
+          if (burst == 0)
+            {
+              burst = 1 + (int)(3 * frand());
+            }
+
+          next += --burst > 0 ? 8 + (int)(8 * frand()) :
+                                60 + (int)(80 * frand());
+        }
+
+      raw[i].x = quantize(0.2F * sinf(a) + impulse * 0.5F +
+                          n * (frand() - 0.5F));
+      raw[i].y = quantize(0.2F * cosf(a) + impulse * 0.3F +
+                          n * (frand() - 0.5F));
+      raw[i].z = quantize(0.95F + impulse + n * (frand() - 0.5F));
+
+      impulse *= decay;
+
+      /* A dropped sample with a zero axis now and then, which the tap
+       * manager skips.
+       */
+
+      if (frand() < 0.002F)
+        {
+          raw[i].y = 0;
+        }
+    }
+}
+
+static uint64_t time_stamp(int icnt, int num)
+{
+  /* As the tap manager, relative to the clock read after the FIFO */
+
+  return (uint64_t)TAP_INTERVAL * 1000000 -
+         TAP_INTERVAL * (num - icnt + 1);
+}
+
+/* Feed the stream as the tap manager, one FIFO of TAP_FIFO samples at a
+ * time, skipping samples with a zero axis.
+ */
+
+static void run_block(TapClass *tap, const struct raw_s *raw, int num,
+                      int *result)
+{
+  ST_TAP_ACCEL accel[TAP_FIFO];
+  int base;
+  int icnt;
+  int run;
+
+  memset(result, 0, num * sizeof(int));
+
+  for (base = 0; base < num; base += TAP_FIFO)
+    {
+      int n = num - base < TAP_FIFO ? num - base : TAP_FIFO;
+
+      sensor_preproc_convert(&raw[base].x, &accel[0].accel_x, n, TAP_SCALE);
+
+      for (icnt = 0, run = 0; icnt <= n; icnt++)
+        {
+          const struct raw_s *r = &raw[base + icnt];
+
+          if (icnt < n && ((r->x != 0) & (r->y != 0) & (r->z != 0)))
+            {
+              run++;
+              continue;
+            }
+
+          if (run > 0)
+            {
+              TapWrite_block(tap, &accel[icnt - run], run,
+                             time_stamp(base + icnt - run, base + n),
+                             TAP_INTERVAL, &result[base + icnt - run]);
+              run = 0;
+            }
+        }
+    }
+}
+
+static void run_ref(RefTapClass *tap, const struct raw_s *raw, int num,
+                    int *result, bool clock)
+{
+  int base;
+  int i;
+
+  memset(result, 0, num * sizeof(int));
+
+  for (base = 0; base < num; base += TAP_FIFO)
+    {
+      int n = num - base < TAP_FIFO ? num - base : TAP_FIFO;
+
+      for (i = base; i < base + n; i++)
+        {
+          ST_TAP_ACCEL accel;
+
+          if (!(raw[i].x && raw[i].y && raw[i].z))
+            {
+              continue;
+            }
+
+          accel.accel_x = (float)((float)(raw[i].x * 2.0) / 32768.0);
+          accel.accel_y = (float)((float)(raw[i].y * 2.0) / 32768.0);
+          accel.accel_z = (float)((float)(raw[i].z * 2.0) / 32768.0);
+
+          result[i] = clock ? tap->write(&accel) :
+                              tap->write(&accel, time_stamp(i, base + n));
+        }
+    }
+}
+
+/* The library per sample, as the tap manager called it before */
+
+static void run_sample(TapClass *tap, const struct raw_s *raw, int num,
+                       int *result)
+{
+  int base;
+  int i;
+
+  memset(result, 0, num * sizeof(int));
+
+  for (base = 0; base < num; base += TAP_FIFO)
+    {
+      int n = num - base < TAP_FIFO ? num - base : TAP_FIFO;
+
+      for (i = base; i < base + n; i++)
+        {
+          ST_TAP_ACCEL accel;
+
+          if (!(raw[i].x && raw[i].y && raw[i].z))
+            {
+              continue;
+            }
+
+          accel.accel_x = (float)((float)(raw[i].x * 2.0) / 32768.0);
+          accel.accel_y = (float)((float)(raw[i].y * 2.0) / 32768.0);
+          accel.accel_z = (float)((float)(raw[i].z * 2.0) / 32768.0);
+
+          result[i] = TapWrite_timestamp(tap, &accel,
+                                         time_stamp(i, base + n));
+        }
+    }
+}
+
+static double now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double bench(int mode, const struct raw_s *raw, int num,
+                    int *result)
+{
+  double best = 0.0;
+  double t;
+  int i;
+
+  for (i = 0; i < BENCH_REPEAT; i++)
+    {
+      RefTapClass ref(&g_params[0], false);
+      TapClass tap;
+
+      TapOpen(&tap, (ST_TAP_OPEN *)&g_params[0]);
+
+      t = now();
+      switch (mode)
+        {
+          case MODE_REF_CLOCK:
+            run_ref(&ref, raw, num, result, true);
+            break;
+
+          case MODE_REF:
+            run_ref(&ref, raw, num, result, false);
+            break;
+
+          case MODE_SAMPLE:
+            run_sample(&tap, raw, num, result);
+            break;
+
+          default:
+            run_block(&tap, raw, num, result);
+            break;
+        }
+
+      t = now() - t;
+      if (i == 0 || t < best)
+        {
+          best = t;
+        }
+    }
+
+  return best;
+}
+
+static void show_usage(const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-n <samples>]\n", progname);
+  fprintf(stderr, "\t-n <samples>: Number of samples. Default: %d\n",
+                  DEF_SAMPLES);
+  exit(errcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  struct raw_s *raw;
+  int *expect;
+  int *result;
+  int num = DEF_SAMPLES;
+  bool failed = false;
+  unsigned int p;
+  int option;
+  int i;
+
+  while ((option = getopt(argc, argv, ":n:h")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'n':
+            num = atoi(optarg);
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  raw    = new struct raw_s[num];
+  expect = new int[num];
+  result = new int[num];
+
+  make_stream(raw, num);
+
+  /* Golden vectors */
+
+  for (p = 0; p < sizeof(g_params) / sizeof(g_params[0]); p++)
+    {
+      RefTapClass ref(&g_params[p], false);
+      RefTapClass ybug(&g_params[p], true);
+      TapClass tap;
+      int series = 0;
+      int taps = 0;
+      int diff = 0;
+      int bugdiff = 0;
+
+      TapOpen(&tap, (ST_TAP_OPEN *)&g_params[p]);
+      run_ref(&ref, raw, num, expect, false);
+      run_block(&tap, raw, num, result);
+
+      for (i = 0; i < num; i++)
+        {
+          if (expect[i] > 0)
+            {
+              series++;
+              taps += expect[i];
+            }
+
+          diff += result[i] != expect[i];
+        }
+
+      run_ref(&ybug, raw, num, result, false);
+      for (i = 0; i < num; i++)
+        {
+          bugdiff += result[i] != expect[i];
+        }
+
+      printf("params %u: %d series, %d taps, %d mismatches "
+             "(%d samples differ with calcR on Y)\n",
+             p, series, taps, diff, bugdiff);
+
+      if (diff != 0 || series == 0)
+        {
+          failed = true;
+        }
+    }
+
+  /* Throughput with the first parameter set, best of BENCH_REPEAT */
+
+  printf("per sample, sqrt, clock_gettime: %8.2f Msamples/s\n",
+         num / bench(MODE_REF_CLOCK, raw, num, result) / 1e6);
+  printf("per sample, sqrt, time stamp:    %8.2f Msamples/s\n",
+         num / bench(MODE_REF, raw, num, result) / 1e6);
+  printf("per sample, squared:             %8.2f Msamples/s\n",
+         num / bench(MODE_SAMPLE, raw, num, result) / 1e6);
+  printf("block of %d, squared:             %8.2f Msamples/s\n",
+         TAP_FIFO, num / bench(MODE_BLOCK, raw, num, result) / 1e6);
+
+  printf("verify: %s\n", failed ? "FAILED" : "OK");
+
+  delete[] raw;
+  delete[] expect;
+  delete[] result;
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -204,6 +204,39 @@ int TapWrite(FAR TapClass *ins, FAR ST_TAP_ACCEL *accelData)
   return ret;
 }
 
+/****************************************************************************
+ * Name: TapWrite_block
+ *
+ * Description:
+ *   TapClass::write() call for a block of samples.
+ *
+ * Input Parameters:
+ *   TapClass*           Object of TapClass.
+ *   ST_TAP_ACCEL*       num Accel Data(x,y,z)
+ *   num                 Number of samples
+ *   time_stamp          Time stamp of the first sample
+ *   interval            Sampling interval (Unit: microseconds)
+ *   tapcnt              Result for each sample
+ *
+ * Returned Value:
+ *   TapClass::write() result
+ *     D_SA_STATUS_E_INVALID_ARGS   Parameter error
+ *     D_SA_STATUS_OK               OK
+ *
+ * Assumptions/Limitations:
+ *   -
+ *
+ ****************************************************************************/
+int TapWrite_block(FAR TapClass *ins, FAR ST_TAP_ACCEL *accelData, int num,
+                   uint64_t time_stamp, uint32_t interval, FAR int *tapcnt)
+{
+  int ret = 0;
+
+  ret = ins->write(accelData, num, time_stamp, interval, tapcnt);
+
+  return ret;
+}
+
 /****************************************************************************
  *Tap Class
  ****************************************************************************/
@@ -290,6 +323,8 @@ int TapClass::open(ST_TAP_OPEN *OpenParam)
   mTapPeriod  = OpenParam->tap_period;
   mPeakThres  = OpenParam->peak_thres;
   mLongThres  = OpenParam->long_thres;
+  mPeakThres2 = mPeakThres * mPeakThres;
+  mLongThres2 = mLongThres * mLongThres;
   mStabFrame  = OpenParam->stab_frame;
   mTapCnt     = 0;
   mState      = E_TAP_STATE_IDLE;
@@ -356,8 +391,6 @@ int TapClass::write(ST_TAP_ACCEL* accelData)
   _info("TapClass::write(acc) called.\n");
   
   bool              detectflg     = false;
-  int               tapcnt        = 0;
-  uint64_t          elapsedTime   = 0;
   uint64_t          endTime       = 0;
   struct   timespec ts;
 
@@ -388,87 +421,8 @@ int TapClass::write(ST_TAP_ACCEL* accelData)
   detectflg = detect(accelData->accel_x, accelData->accel_y, accelData->accel_z);
 
   /* State determination */
-  
-  switch (mState){
-  case E_TAP_STATE_IDLE:
-    if(true == detectflg)
-      {
-
-        /* Detect Tap */
-
-        mTapCnt++;
-
-        /* Transition to tap state */
-
-        mState = E_TAP_STATE_TAP;
 
-        /* Time update */
-
-        mStartTime = endTime;
-      }
-    else
-      {
-
-        /* Notify number of taps */
-
-        tapcnt = mTapCnt;
-        mTapCnt = 0;
-      }
-    break;
-
-  case E_TAP_STATE_TAP:
-    
-    /* Calculate the time difference (Unit: microseconds) */
-
-    elapsedTime = endTime - mStartTime;
-    if (true == detectflg)
-      {
-
-        /* Detect Tap */
-
-        if (elapsedTime > mTapPeriod)
-          {
-
-            /* Notify the number of previous taps once and update it to 1 */
-
-            tapcnt = mTapCnt;
-            mTapCnt = 1;
-
-            /* Time update */
-
-            mStartTime = endTime;
-          } 
-        else
-          {
-
-            /* In time */
-            
-            mTapCnt++;
-
-            /* Time update */
-            
-            mStartTime = endTime;
-          }
-      }
-    else
-      {
-        if (elapsedTime > mTapPeriod)
-          {
-        
-            /* TimeOut */
-
-            tapcnt  = mTapCnt;
-            mTapCnt = 0;
-            mState  = E_TAP_STATE_IDLE;
-          }
-      }
-    break;
-  default:
-    break;
-  }
-
-  /* Return number of taps */
-  return tapcnt;
+  return judge(detectflg, endTime);
 }
 
 /****************************************************************************
@@ -494,8 +448,6 @@ int TapClass::write(ST_TAP_ACCEL* accelData)
 int TapClass::write(ST_TAP_ACCEL *accelData, uint64_t time_stamp)
 {
   bool detectflg         = false;
-  int tapcnt             = 0;
-  uint64_t elapsedTime   = 0;
   uint64_t endTime       = time_stamp;
 
   _info("accel_x %.3f accel_y %.3f accel_z %.3f timestamp %llu \n",
@@ -515,10 +467,84 @@ int TapClass::write(ST_TAP_ACCEL *accelData, uint64_t time_stamp)
   detectflg = detect(accelData->accel_x, accelData->accel_y, accelData->accel_z);
 
   /* State determination */
-  
+
+  return judge(detectflg, endTime);
+}
+
+/****************************************************************************
+ * Name: write
+ *
+ * Description:
+ *   TapClass::write() for a block of samples, such as a FIFO read from
+ *   SCU.  The time stamp of each sample is computed from the first one
+ *   and the sampling interval instead of reading the clock.
+ *
+ * Input Parameters:
+ *   ST_TAP_ACCEL*       num Accel Data(x,y,z)
+ *   num                 Number of samples
+ *   time_stamp          Time stamp of the first sample
+ *   interval            Sampling interval (Unit: microseconds)
+ *   tapcnt              Result for each sample, as returned by
+ *                       write(ST_TAP_ACCEL*, uint64_t)
+ *
+ * Returned Value:
+ *   D_SA_STATUS_E_INVALID_ARGS   Parameter error
+ *   D_SA_STATUS_OK               OK
+ *
+ * Assumptions/Limitations:
+ *   -
+ *
+ ****************************************************************************/
+int TapClass::write(ST_TAP_ACCEL *accelData, int num, uint64_t time_stamp,
+                    uint32_t interval, int *tapcnt)
+{
+  int i;
+
+  if (NULL == accelData || NULL == tapcnt || num < 0)
+    {
+      _err("accelData or tapcnt is NULL\n");
+      return D_SA_STATUS_E_INVALID_ARGS;
+    }
+
+  for (i = 0; i < num; i++, accelData++)
+    {
+      tapcnt[i] = judge(detect(accelData->accel_x, accelData->accel_y,
+                               accelData->accel_z),
+                        time_stamp);
+      time_stamp += interval;
+    }
+
+  return D_SA_STATUS_OK;
+}
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+/****************************************************************************
+ * Name: judge
+ *
+ * Description:
+ *   Update the tap state by the detection result of a sample.
+ *
+ * Input Parameters:
+ *   detectflg   - result of detect()
+ *   endTime     - time stamp of the sample
+ *
+ * Returned Value:
+ *   Number of taps of the series which ended, or 0.
+ *
+ * Assumptions/Limitations:
+ *   -
+ *
+ ****************************************************************************/
+int TapClass::judge(bool detectflg, uint64_t endTime)
+{
+  int      tapcnt      = 0;
+  uint64_t elapsedTime = 0;
+
   switch (mState){
   case E_TAP_STATE_IDLE:
-    if (true == detectflg)
+    if(true == detectflg)
       {
 
         /* Detect Tap */
@@ -526,11 +552,11 @@ int TapClass::write(ST_TAP_ACCEL *accelData, uint64_t time_stamp)
         mTapCnt++;
 
         /* Transition to tap state */
-        
+
         mState = E_TAP_STATE_TAP;
-        
+
         /* Time update */
-        
+
         mStartTime = endTime;
       }
     else
@@ -598,42 +624,39 @@ int TapClass::write(ST_TAP_ACCEL *accelData, uint64_t time_stamp)
 }
 
 /****************************************************************************
- * Private Functions
- ****************************************************************************/
-/****************************************************************************
- * Name: calcR
+ * Name: calcR2
  *
  * Description:
- *   
+ *   Squared distance between two samples in the buffer.
  *
  * Input Parameters:
  *   i0   - 0
  *   j0   - detection count
  *
  * Returned Value:
- *   Sqrt Result.
+ *   Squared distance.
  *
  * Assumptions/Limitations:
  *   -
  *
  ****************************************************************************/
-float TapClass::calcR(int i0, int j0)
+float TapClass::calcR2(int i0, int j0)
 {
   int i    = getIndex(i0);
   int j    = getIndex(j0);
   float dx = mX[i] - mX[j];
   float dy = mY[i] - mY[j];
-  float dz = mY[i] - mY[j];
-  float r  = sqrt(dx * dx + dy * dy + dz * dz);
+  float dz = mZ[i] - mZ[j];
 
-  return r;
+  return dx * dx + dy * dy + dz * dz;
 }
 
 /****************************************************************************
  * Name: detect
  *
  * Description:
- *   It judges whether it detects tap.
+ *   It judges whether it detects tap.  The magnitude is compared squared
+ *   with the squared thresholds, which avoids a square root per sample.
  *
  * Input Parameters:
  *   x   - accel data(x)
@@ -660,11 +683,11 @@ bool TapClass::detect(float x, float y, float z)
   mX[index] = x;
   mY[index] = y;
   mZ[index] = z;
-  mR[index] = sqrt(x * x + y * y + z * z);
+  mR[index] = x * x + y * y + z * z;
 
   if (mDetectionCount == 0)
     {
-      if (mR[index] > mPeakThres)
+      if (mR[index] > mPeakThres2)
         {
           mDetectionCount = TAP_DETECTION_COUNT;
         }
@@ -672,12 +695,12 @@ bool TapClass::detect(float x, float y, float z)
     }
 
   mDetectionCount--;
-  if (mR[index] > mPeakThres)
+  if (mR[index] > mPeakThres2)
     {
       return false;
     }
 
-  if (calcR(0, TAP_DETECTION_COUNT - mDetectionCount) > mLongThres)
+  if (calcR2(0, TAP_DETECTION_COUNT - mDetectionCount) > mLongThres2)
     {
       mStab = 0;
       return false;
@@ -707,7 +730,7 @@ bool TapClass::detect(float x, float y, float z)
  *   -
  *
  ****************************************************************************/
-float TapClass::getIndex(int idx)
+int TapClass::getIndex(int idx)
 {
   int i = mIndex - idx - 1;
 
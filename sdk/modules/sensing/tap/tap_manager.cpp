@@ -53,6 +53,7 @@
 #include <sched.h>
 #include <signal.h>
 #include "sensing/tap_manager.h"
+#include "sensing/sensor_preproc.h"
 #include <nuttx/sensors/bmi160.h>
 
 #ifdef CONFIG_CXD56_SCU
@@ -96,7 +97,10 @@
 #define TAP_MNG_ACC_START                  2
 #define TAP_MNG_ACC_STOP                   3
 #define TAP_MNG_ACC_CLOSE                  4
-#define TAP_MNG_ACCEL_CONVERT(func)        (float)((float)((func) * 2.0) / 32768.0)
+#define TAP_MNG_ACCEL_SCALE                (2.0F / 32768.0F)
+#define TAP_MNG_ACC_INTERVAL               (1000000 / TAP_MNG_ACC_SAMPLING_FREQ)
+#define TAP_MNG_ACC_VALID(ta)              (((ta)->x != 0) & ((ta)->y != 0) & \
+                                            ((ta)->z != 0))
 
 /****************************************************************************
  * Private Data
@@ -127,12 +131,8 @@ struct tap_mng_acc_data_buf
 {
   struct    tap_mng_three_axis_s acc_data[(TAP_MNG_ACC_SAMPLING_FREQ * TAP_MNG_FIFO_NUM)];
   uint64_t  time_stamp;
-};
-
-struct tap_mng_inlibdata
-{
-  ST_TAP_ACCEL  accel;
-  uint64_t      timestamp;
+  ST_TAP_ACCEL accel[(TAP_MNG_ACC_SAMPLING_FREQ * TAP_MNG_FIFO_NUM)];
+  int       tapcnt[(TAP_MNG_ACC_SAMPLING_FREQ * TAP_MNG_FIFO_NUM)];
 };
 
 static sem_t                 g_tap_mng_node_lock;
@@ -254,14 +254,15 @@ static void TapMngTapLibRun(void)
 {
   struct tap_mng_node         *p_node      = NULL;
   int                         fd           = -1;
-  int                         tapCnt       = 0;
   int                         icnt         = 0;
+  int                         run          = 0;
+  int                         start        = 0;
+  int                         i            = 0;
   int                         ret          = 0;
   int                         rsize        = 0;
   int                         acc_data_num = 0;
   struct tap_mng_acc_data_buf *data        = NULL;
   struct tap_mng_three_axis_s *ta          = NULL;
-  struct tap_mng_inlibdata    indata       = {0};
   sigset_t                    set          = {0};
   struct siginfo              siginfo      = {0};
   struct timespec             ts           = {0};
@@ -348,47 +349,70 @@ static void TapMngTapLibRun(void)
                 }
             }
 
-          /* set timestamp */
+          /* set timestamp, one clock read for the whole block */
 
           clock_gettime(CLOCK_MONOTONIC, &ts);
 
           data->time_stamp = (ts.tv_sec * SEC_PER_US) + (ts.tv_nsec / NS_PER_US);
 
+          /* convert the whole block at once */
+
+          sensor_preproc_convert((FAR const int16_t *)data->acc_data,
+                                 &data->accel[0].accel_x, acc_data_num,
+                                 TAP_MNG_ACCEL_SCALE);
+
+          /* Samples with a zero axis are skipped, so pass each run of
+           * valid samples to the tap library as a block.
+           */
+
           ta = (struct tap_mng_three_axis_s *)&data->acc_data;
-          for (icnt = 0; icnt < acc_data_num; icnt++, ta++)
+          for (icnt = 0, run = 0; icnt <= acc_data_num; icnt++, ta++)
             {
-              if (ta->x && ta->y && ta->z)
+              if (icnt < acc_data_num && TAP_MNG_ACC_VALID(ta))
                 {
-                  memset(&indata, 0, sizeof(struct tap_mng_inlibdata));
-                  indata.accel.accel_x = TAP_MNG_ACCEL_CONVERT(ta->x);
-                  indata.accel.accel_y = TAP_MNG_ACCEL_CONVERT(ta->y);
-                  indata.accel.accel_z = TAP_MNG_ACCEL_CONVERT(ta->z);
+                  run++;
+                  continue;
+                }
 
-                  indata.timestamp = data->time_stamp - (1000000 / TAP_MNG_ACC_SAMPLING_FREQ) * (acc_data_num - icnt + 1);
+              if (run == 0)
+                {
+                  continue;
+                }
 
-                  TAP_MNG_NODE_LOCK();
+              start = icnt - run;
+              run   = 0;
 
-                  if (NULL == g_head)
-                    {
-                      _err("L%d g_head is NULL \n", __LINE__);
-                      TAP_MNG_NODE_UNLOCK();
-                      continue;
-                    }
+              TAP_MNG_NODE_LOCK();
+
+              if (NULL == g_head)
+                {
+                  _err("L%d g_head is NULL \n", __LINE__);
+                  TAP_MNG_NODE_UNLOCK();
+                  continue;
+                }
 
-                  p_node = g_head;
-                  do
+              p_node = g_head;
+              do
+                {
+                  /* Tap Library call */
+
+                  TapWrite_block(p_node->tap, &data->accel[start],
+                                 icnt - start,
+                                 data->time_stamp - TAP_MNG_ACC_INTERVAL *
+                                 (acc_data_num - start + 1),
+                                 TAP_MNG_ACC_INTERVAL, data->tapcnt);
+                  for (i = 0; i < icnt - start; i++)
                     {
-                      /* Tap Library call */
-                      tapCnt = TapWrite_timestamp(p_node->tap, &indata.accel, indata.timestamp);
-                      if (tapCnt > 0)
+                      if (data->tapcnt[i] > 0)
                         {
-                          p_node->cbs(tapCnt);
+                          p_node->cbs(data->tapcnt[i]);
                         }
-                      p_node = p_node->next;
-                    } while (NULL != p_node);
+                    }
 
-                  TAP_MNG_NODE_UNLOCK();
-                }
+                  p_node = p_node->next;
+                } while (NULL != p_node);
+
+              TAP_MNG_NODE_UNLOCK();
             }
         }
       /* receive signal from tap manager api */
@@ -0,0 +1,211 @@
+/****************************************************************************
+ * system/fsutils/inifile/host/inibench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark of INI file lookups.  A file of sections of integer
+ *   variables, with comments, is generated, and the same lookups are run
+ *   through the streaming parser and through the cached index.  The time
+ *   per lookup includes inifile_initialize() and inifile_uninitialize(),
+ *   and, for the cached index, the stat() made by every lookup.  The sums
+ *   of the values read are compared.
+ *
+ *   Options:
+ *     -s <sections>  Number of sections (default 10)
+ *     -k <keys>      Variables per section (default 50)
+ *     -n <lookups>   Number of lookups (default 20000)
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "inistream.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define INI_PATH      "/tmp/inibench.ini"
+#define DEF_SECTIONS  10
+#define DEF_KEYS      50
+#define DEF_LOOKUPS   20000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct parser_s
+{
+  const char *name;
+  INIHANDLE (*initialize)(const char *inifile_name);
+  void (*uninitialize)(INIHANDLE handle);
+  long (*read_integer)(INIHANDLE handle, const char *section,
+                       const char *variable, long defvalue);
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct parser_s g_parsers[] =
+{
+  {
+    "streaming", inistream_initialize, inistream_uninitialize,
+    inistream_read_integer
+  },
+  {
+    "cached", inifile_initialize, inifile_uninitialize, inifile_read_integer
+  },
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int gen_file(int nsections, int nkeys)
+{
+  FILE *f = fopen(INI_PATH, "w");
+  int s;
+  int k;
+
+  if (!f)
+    {
+      perror(INI_PATH);
+      return -1;
+    }
+
+  for (s = 0; s < nsections; s++)
+    {
+      fprintf(f, "; settings of group %d\n[section%d]\n", s, s);
+      for (k = 0; k < nkeys; k++)
+        {
+          fprintf(f, "key%d=%d\n", k, s * 1000 + k);
+        }
+
+      fprintf(f, "\n");
+    }
+
+  fclose(f);
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  int nsections = DEF_SECTIONS;
+  int nkeys = DEF_KEYS;
+  int nlookups = DEF_LOOKUPS;
+  long sums[2];
+  int opt;
+  int p;
+
+  while ((opt = getopt(argc, argv, "s:k:n:")) != -1)
+    {
+      switch (opt)
+        {
+          case 's':
+            nsections = atoi(optarg);
+            break;
+
+          case 'k':
+            nkeys = atoi(optarg);
+            break;
+
+          case 'n':
+            nlookups = atoi(optarg);
+            break;
+
+          default:
+            fprintf(stderr, "usage: %s [-s sections] [-k keys] "
+                    "[-n lookups]\n", argv[0]);
+            return 2;
+        }
+    }
+
+  if (nsections < 1 || nkeys < 1 || nlookups < 1 || gen_file(nsections,
+                                                             nkeys) < 0)
+    {
+      return 2;
+    }
+
+  printf("%d sections x %d keys, %d lookups\n", nsections, nkeys, nlookups);
+
+  for (p = 0; p < 2; p++)
+    {
+      const struct parser_s *parser = &g_parsers[p];
+      struct timespec start;
+      struct timespec end;
+      char section[32];
+      char variable[32];
+      INIHANDLE handle;
+      double usec;
+      int i;
+
+      sums[p] = 0;
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      handle = parser->initialize(INI_PATH);
+      for (i = 0; i < nlookups; i++)
+        {
+          snprintf(section, sizeof(section), "section%d",
+                   (i * 7) % nsections);
+          snprintf(variable, sizeof(variable), "key%d", (i * 13) % nkeys);
+          sums[p] += parser->read_integer(handle, section, variable, -1);
+        }
+
+      parser->uninitialize(handle);
+      clock_gettime(CLOCK_MONOTONIC, &end);
+
+      usec = ((end.tv_sec - start.tv_sec) * 1e9 +
+              (end.tv_nsec - start.tv_nsec)) / 1e3;
+      printf("%-10s %8.2f us/lookup\n", parser->name, usec / nlookups);
+    }
+
+  unlink(INI_PATH);
+  printf("%s\n", sums[0] == sums[1] ? "PASS" : "FAIL (values differ)");
+  return sums[0] != sums[1];
+}
@@ -0,0 +1,490 @@
+/****************************************************************************
+ * system/fsutils/inifile/host/inifuzz.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Differential fuzzer of the cached INI index against the streaming
+ *   parser.  Random INI files (comments, CRs, blank lines, duplicate
+ *   sections and variables, malformed headers, over-long lines) are
+ *   generated, and random lookups must return the same strings through
+ *   both parsers.
+ *
+ *   A second pass makes random inifile_write_string() calls on the cached
+ *   handle, and checks that every variable reads the value last written
+ *   (or the default for an empty value), that inifile_commit() succeeds,
+ *   that the cached reads don't change after the commit, and that the
+ *   streaming parser reads the same values from the committed file.
+ *
+ *   Finally, a file rewritten behind an open cached handle must be
+ *   reloaded.
+ *
+ *   Options:
+ *     -i <iterations>  Files generated per pass (default 2000)
+ *     -r <seed>        Random seed (default 1)
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+#include "inistream.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define INI_PATH     "/tmp/inifuzz.ini"
+#define DEF_ITER     2000
+#define MAX_LINES    25
+#define NQUERIES     30
+#define MAX_WRITES   8
+#define DEFVALUE     "<def>"
+#define NELEM(a)     (sizeof(a) / sizeof((a)[0]))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char *g_sections[] =
+{
+  "s1", "S1", "s2", "sec three", "x", ""
+};
+
+static const char *g_variables[] =
+{
+  "a", "A", "b", "key ", "k2", "longkey", "=", "c"
+};
+
+static const char *g_wsections[] =
+{
+  "s1", "S1", "s2", "sec three", "x", "new", "New2"
+};
+
+static const char *g_wvariables[] =
+{
+  "a", "A", "b", "key ", "k2", "longkey", "c", "z"
+};
+
+static const char *g_wvalues[] =
+{
+  "1", "hello", "", "77"
+};
+
+static unsigned long g_failures;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static double rnd(void)
+{
+  return (double)random() / ((double)RAND_MAX + 1);
+}
+
+static const char *pick(const char **array, size_t n)
+{
+  return array[random() % n];
+}
+
+#define PICK(a) pick(a, NELEM(a))
+
+/* Append one random line, without the newline */
+
+static void gen_line(FILE *f)
+{
+  static const char *ws[] =
+  {
+    "", "  ", "\t", " \r"
+  };
+
+  static const char *close[] =
+  {
+    "]", "]x", "", " ]"
+  };
+
+  static const char *bad[] =
+  {
+    "[", "[]", "[a"
+  };
+
+  static const char *values[] =
+  {
+    "", "1", "0x10", "hello world", " sp", "-5", "a=b"
+  };
+
+  static const char *assign[] =
+  {
+    "=", "=", "\r="
+  };
+
+  static const char *eol[] =
+  {
+    "", "\r"
+  };
+
+  double r = rnd();
+  int n;
+
+  if (r < 0.1)
+    {
+      return;
+    }
+
+  if (r < 0.15)
+    {
+      fputs(PICK(ws), f);
+    }
+  else if (r < 0.2)
+    {
+      fprintf(f, "%s;%s=1", PICK(ws), PICK(g_variables));
+    }
+  else if (r < 0.35)
+    {
+      fprintf(f, "%s[%s%s", PICK(ws), PICK(g_sections), PICK(close));
+    }
+  else if (r < 0.38)
+    {
+      fputs(PICK(bad), f);
+    }
+  else if (r < 0.4)
+    {
+      /* Longer than CONFIG_FSUTILS_INIFILE_MAXLINE */
+
+      fprintf(f, "%s%s=", PICK(ws), PICK(g_variables));
+      for (n = 240 + random() % 31; n > 0; n--)
+        {
+          fputc('v', f);
+        }
+    }
+  else if (r < 0.45)
+    {
+      fprintf(f, "%s%s", PICK(ws), PICK(g_variables));
+    }
+  else
+    {
+      fprintf(f, "%s%s%s%s%s", PICK(ws), PICK(g_variables), PICK(assign),
+              PICK(values), PICK(eol));
+    }
+}
+
+static void gen_file(void)
+{
+  FILE *f = fopen(INI_PATH, "w");
+  int nlines = random() % (MAX_LINES + 1);
+  int i;
+
+  for (i = 0; i < nlines; i++)
+    {
+      if (i > 0)
+        {
+          fputc('\n', f);
+        }
+
+      gen_line(f);
+    }
+
+  if (random() & 1)
+    {
+      fputc('\n', f);
+    }
+
+  fclose(f);
+}
+
+static void dump_file(void)
+{
+  FILE *f = fopen(INI_PATH, "r");
+  int c;
+
+  printf("---- %s\n", INI_PATH);
+  while (f && (c = fgetc(f)) != EOF)
+    {
+      putchar(c);
+    }
+
+  printf("\n----\n");
+  if (f)
+    {
+      fclose(f);
+    }
+}
+
+static void failure(const char *fmt, const char *section,
+                    const char *variable, const char *a, const char *b)
+{
+  if (g_failures++ < 3)
+    {
+      printf(fmt, section, variable, a, b);
+      dump_file();
+    }
+}
+
+static char *read_stream(const char *section, const char *variable)
+{
+  INIHANDLE handle = inistream_initialize(INI_PATH);
+  char *value;
+  char *copy;
+
+  value = inistream_read_string(handle, section, variable, DEFVALUE);
+  copy = strdup(value);
+  inistream_free_string(value);
+  inistream_uninitialize(handle);
+  return copy;
+}
+
+/* Random files and lookups through both parsers */
+
+static void fuzz_read(int iterations)
+{
+  int it;
+  int q;
+
+  for (it = 0; it < iterations; it++)
+    {
+      INIHANDLE cache;
+      INIHANDLE stream;
+
+      gen_file();
+      stream = inistream_initialize(INI_PATH);
+      cache = inifile_initialize(INI_PATH);
+
+      for (q = 0; q < NQUERIES; q++)
+        {
+          const char *section = PICK(g_sections);
+          const char *variable = PICK(g_variables);
+          char *a;
+          char *b;
+
+          a = inistream_read_string(stream, section, variable, DEFVALUE);
+          b = inifile_read_string(cache, section, variable, DEFVALUE);
+          if (strcmp(a, b))
+            {
+              failure("read [%s] %s: streaming \"%s\", cached \"%s\"\n",
+                      section, variable, a, b);
+            }
+
+          inistream_free_string(a);
+          inifile_free_string(b);
+        }
+
+      inifile_uninitialize(cache);
+      inistream_uninitialize(stream);
+    }
+}
+
+/* Random writes, commit and reload */
+
+static void fuzz_write(int iterations)
+{
+  const char *expect[NELEM(g_wsections)][NELEM(g_wvariables)];
+  char *before[NELEM(g_wsections)][NELEM(g_wvariables)];
+  int it;
+  int n;
+  int s;
+  int v;
+
+  for (it = 0; it < iterations; it++)
+    {
+      INIHANDLE cache;
+      int nwrites;
+      int ret;
+
+      gen_file();
+      cache = inifile_initialize(INI_PATH);
+      memset(expect, 0, sizeof(expect));
+
+      nwrites = 1 + random() % MAX_WRITES;
+      for (n = 0; n < nwrites; n++)
+        {
+          const char *section = PICK(g_wsections);
+          const char *variable = PICK(g_wvariables);
+          const char *value = PICK(g_wvalues);
+
+          ret = inifile_write_string(cache, section, variable, value);
+          if (ret != OK)
+            {
+              failure("write [%s] %s = %s: %s\n", section, variable, value,
+                      "failed");
+              continue;
+            }
+
+          /* Names are case insensitive: every spelling sees the value */
+
+          for (s = 0; s < NELEM(g_wsections); s++)
+            {
+              for (v = 0; v < NELEM(g_wvariables); v++)
+                {
+                  if (!strcasecmp(g_wsections[s], section) &&
+                      !strcasecmp(g_wvariables[v], variable))
+                    {
+                      expect[s][v] = *value ? value : DEFVALUE;
+                    }
+                }
+            }
+        }
+
+      for (s = 0; s < NELEM(g_wsections); s++)
+        {
+          for (v = 0; v < NELEM(g_wvariables); v++)
+            {
+              before[s][v] = inifile_read_string(cache, g_wsections[s],
+                                                 g_wvariables[v], DEFVALUE);
+              if (expect[s][v] && strcmp(before[s][v], expect[s][v]))
+                {
+                  failure("written [%s] %s: expected \"%s\", read \"%s\"\n",
+                          g_wsections[s], g_wvariables[v], expect[s][v],
+                          before[s][v]);
+                }
+            }
+        }
+
+      ret = inifile_commit(cache);
+      if (ret != OK)
+        {
+          failure("commit%s%s: %s%s\n", "", "", "failed", "");
+        }
+
+      for (s = 0; s < NELEM(g_wsections); s++)
+        {
+          for (v = 0; v < NELEM(g_wvariables); v++)
+            {
+              char *after = inifile_read_string(cache, g_wsections[s],
+                                                g_wvariables[v], DEFVALUE);
+              char *stream = read_stream(g_wsections[s], g_wvariables[v]);
+
+              if (strcmp(before[s][v], after) ||
+                  strcmp(before[s][v], stream))
+                {
+                  failure("committed [%s] %s: cached \"%s\", "
+                          "streaming \"%s\"\n", g_wsections[s],
+                          g_wvariables[v], after, stream);
+                }
+
+              inifile_free_string(before[s][v]);
+              inifile_free_string(after);
+              free(stream);
+            }
+        }
+
+      inifile_uninitialize(cache);
+    }
+}
+
+/* A file rewritten behind an open handle is reloaded */
+
+static void check_reload(void)
+{
+  INIHANDLE cache;
+  FILE *f;
+  long a;
+  long b;
+
+  f = fopen(INI_PATH, "w");
+  fputs("[a]\nx=1\n", f);
+  fclose(f);
+
+  cache = inifile_initialize(INI_PATH);
+  a = inifile_read_integer(cache, "a", "x", -1);
+
+  f = fopen(INI_PATH, "w");
+  fputs("[a]\nx=22\n", f);
+  fclose(f);
+
+  b = inifile_read_integer(cache, "a", "x", -1);
+  inifile_uninitialize(cache);
+
+  if (a != 1 || b != 22)
+    {
+      char sa[16];
+      char sb[16];
+
+      snprintf(sa, sizeof(sa), "%ld", a);
+      snprintf(sb, sizeof(sb), "%ld", b);
+      failure("reload [%s] %s: read %s, then %s\n", "a", "x", sa, sb);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  int iterations = DEF_ITER;
+  unsigned int seed = 1;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "i:r:")) != -1)
+    {
+      switch (opt)
+        {
+          case 'i':
+            iterations = atoi(optarg);
+            break;
+
+          case 'r':
+            seed = strtoul(optarg, NULL, 0);
+            break;
+
+          default:
+            fprintf(stderr, "usage: %s [-i iterations] [-r seed]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+  srandom(seed);
+  fuzz_read(iterations);
+  printf("reads:  %d files, %lu failures\n", iterations, g_failures);
+
+  fuzz_write(iterations);
+  printf("writes: %d files, %lu failures\n", iterations, g_failures);
+
+  check_reload();
+  unlink(INI_PATH);
+
+  printf("%s\n", g_failures ? "FAIL" : "PASS");
+  return g_failures != 0;
+}
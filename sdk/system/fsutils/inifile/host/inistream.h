@@ -0,0 +1,62 @@
+/****************************************************************************
+ * system/fsutils/inifile/host/inistream.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_SYSTEM_FSUTILS_INIFILE_HOST_INISTREAM_H
+#define __APPS_SYSTEM_FSUTILS_INIFILE_HOST_INISTREAM_H
+
+/* The streaming parser is linked next to the cached one, with its public
+ * functions renamed.  inifile.c is compiled with -DINISTREAM_RENAME and
+ * -include inistream.h for that.
+ */
+
+#ifdef INISTREAM_RENAME
+#  define inifile_initialize     inistream_initialize
+#  define inifile_uninitialize   inistream_uninitialize
+#  define inifile_read_string    inistream_read_string
+#  define inifile_read_integer   inistream_read_integer
+#  define inifile_free_string    inistream_free_string
+#endif
+
+#include "fsutils/inifile.h"
+
+INIHANDLE inistream_initialize(const char *inifile_name);
+void inistream_uninitialize(INIHANDLE handle);
+char *inistream_read_string(INIHANDLE handle, const char *section,
+                            const char *variable, const char *defvalue);
+long inistream_read_integer(INIHANDLE handle, const char *section,
+                            const char *variable, long defvalue);
+void inistream_free_string(char *value);
+
+#endif /* __APPS_SYSTEM_FSUTILS_INIFILE_HOST_INISTREAM_H */
@@ -39,9 +39,16 @@
 
 #include <sdk/config.h>
 
+#include <sys/stat.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
 #include <debug.h>
 
 #include "fsutils/inifile.h"
@@ -88,6 +95,19 @@
 #  endif
 #endif
 
+#ifdef CONFIG_FSUTILS_INIFILE_CACHE
+/* FNV-1a parameters of the case-insensitive section/variable name hash */
+
+#  define INIFILE_HASH_INIT   2166136261u
+#  define INIFILE_HASH_PRIME  16777619u
+
+/* Initial sizes of the cache tables */
+
+#  define INIFILE_MINSECTIONS 4
+#  define INIFILE_MINENTRIES  16
+#  define INIFILE_MINBUCKETS  16
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -100,12 +120,65 @@ struct inifile_var_s
   FAR char *value;
 };
 
+#ifdef CONFIG_FSUTILS_INIFILE_CACHE
+/* A section of the cached INI file.  Only the first header of a section
+ * is indexed, just like inifile_seek_to_section() only ever finds the
+ * first one.
+ */
+
+struct inifile_section_s
+{
+  FAR const char *name;        /* Section name (not NUL terminated) */
+  FAR const char *end;         /* End of the last line of the section, NULL
+                                * if the section was added by
+                                * inifile_write_string() */
+  FAR char *newname;           /* Storage of an added section name */
+  uint32_t hash;               /* Hash of the section name */
+  uint16_t namelen;            /* Length of the section name */
+};
+
+/* A variable assignment of the cached INI file.  Names and values point
+ * into the file image, values set by inifile_write_string() are held in
+ * separately allocated strings until the next inifile_commit().
+ */
+
+struct inifile_entry_s
+{
+  FAR const char *variable;    /* Variable name (not NUL terminated) */
+  FAR const char *value;       /* Value in the file image */
+  FAR char *newname;           /* Storage of an added variable name */
+  FAR char *newvalue;          /* Value set by inifile_write_string() */
+  uint32_t hash;               /* Hash of the section and variable names */
+  int      next;               /* Next entry in the hash bucket or -1 */
+  uint16_t section;            /* Index of the section of the variable */
+  uint16_t varlen;             /* Length of the variable name */
+  uint16_t vallen;             /* Length of the value in the file image */
+};
+#endif
+
 /* This structure describes the state of one instance of the INI file parser */
 
 struct inifile_state_s
 {
+#ifdef CONFIG_FSUTILS_INIFILE_CACHE
+  FAR char *path;              /* Path of the INI file */
+  FAR char *buffer;            /* Image of the INI file, CRs removed */
+  size_t    buflen;            /* Number of bytes in the image */
+  time_t    mtime;             /* Modification time of the image */
+  off_t     size;              /* File size of the image */
+  bool      dirty;             /* Uncommitted inifile_write_string() */
+  FAR struct inifile_section_s *sections;
+  FAR struct inifile_entry_s *entries;
+  FAR int  *buckets;           /* Hash table of entry indices */
+  int       nsections;
+  int       maxsections;
+  int       nentries;
+  int       maxentries;
+  int       nbuckets;          /* Always a power of two */
+#else
   FILE *instream;
   int   nextch;
+#endif
   char  line[CONFIG_FSUTILS_INIFILE_MAXLINE+1];
 };
 
@@ -117,6 +190,7 @@ struct inifile_state_s
  * Private Function Prototypes
  ****************************************************************************/
 
+#ifndef CONFIG_FSUTILS_INIFILE_CACHE
 static bool inifile_next_line(FAR struct inifile_state_s *priv);
 static int  inifile_read_line(FAR struct inifile_state_s *priv);
 static int  inifile_read_noncomment_line(FAR struct inifile_state_s *priv);
@@ -127,6 +201,11 @@ static bool inifile_read_variable(FAR struct inifile_state_s *priv,
 static FAR char *
             inifile_find_section_variable(FAR struct inifile_state_s *priv,
               FAR const char *variable);
+#else
+static void inifile_cache_free(FAR struct inifile_state_s *priv);
+static int  inifile_cache_load(FAR struct inifile_state_s *priv);
+static void inifile_cache_check(FAR struct inifile_state_s *priv);
+#endif
 static FAR char *
             inifile_find_variable(FAR struct inifile_state_s *priv,
               FAR const char *section, FAR const char *variable);
@@ -135,6 +214,8 @@ static FAR char *
  * Private Functions
  ****************************************************************************/
 
+#ifndef CONFIG_FSUTILS_INIFILE_CACHE
+
 /****************************************************************************
  * Name:  inifile_next_line
  *
@@ -488,6 +569,733 @@ static FAR char *inifile_find_variable(FAR struct inifile_state_s *priv,
   return ret;
 }
 
+#else /* CONFIG_FSUTILS_INIFILE_CACHE */
+
+/****************************************************************************
+ * Name:  inifile_hash
+ *
+ * Description:
+ *   Continue the case-insensitive hash 'hash' over 'len' characters of
+ *   'str'.
+ *
+ ****************************************************************************/
+
+static uint32_t inifile_hash(uint32_t hash, FAR const char *str, size_t len)
+{
+  while (len-- > 0)
+    {
+      hash = (hash ^ (uint8_t)tolower(*str++)) * INIFILE_HASH_PRIME;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name:  inifile_match
+ *
+ * Description:
+ *   Compare two names of known length, ignoring case like strcasecmp().
+ *
+ ****************************************************************************/
+
+static bool inifile_match(FAR const char *name1, size_t len1,
+                          FAR const char *name2, size_t len2)
+{
+  return len1 == len2 && strncasecmp(name1, name2, len1) == 0;
+}
+
+/****************************************************************************
+ * Name:  inifile_cache_section
+ *
+ * Description:
+ *   Return the index of the section 'name' or -1 if there is no such
+ *   section.  INI files have few sections, so these are searched linearly
+ *   by hash.
+ *
+ ****************************************************************************/
+
+static int inifile_cache_section(FAR struct inifile_state_s *priv,
+                                 FAR const char *name, size_t len)
+{
+  uint32_t hash = inifile_hash(INIFILE_HASH_INIT, name, len);
+  int i;
+
+  for (i = 0; i < priv->nsections; i++)
+    {
+      FAR struct inifile_section_s *sect = &priv->sections[i];
+
+      if (sect->hash == hash &&
+          inifile_match(sect->name, sect->namelen, name, len))
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name:  inifile_cache_find
+ *
+ * Description:
+ *   Return the entry of the variable 'variable' in the section with index
+ *   'section' or NULL if there is no such variable.
+ *
+ ****************************************************************************/
+
+static FAR struct inifile_entry_s *
+  inifile_cache_find(FAR struct inifile_state_s *priv, int section,
+                     FAR const char *variable, size_t varlen)
+{
+  uint32_t hash = inifile_hash(priv->sections[section].hash,
+                               variable, varlen);
+  int i;
+
+  if (priv->nbuckets == 0)
+    {
+      return NULL;
+    }
+
+  for (i = priv->buckets[hash & (priv->nbuckets - 1)]; i >= 0;
+       i = priv->entries[i].next)
+    {
+      FAR struct inifile_entry_s *entry = &priv->entries[i];
+
+      if (entry->hash == hash && entry->section == section &&
+          inifile_match(entry->variable, entry->varlen, variable, varlen))
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name:  inifile_cache_rehash
+ *
+ * Description:
+ *   (Re-)build the hash table so that there is at least one bucket per
+ *   entry.
+ *
+ ****************************************************************************/
+
+static int inifile_cache_rehash(FAR struct inifile_state_s *priv)
+{
+  FAR int *buckets;
+  int nbuckets;
+  int i;
+
+  for (nbuckets = INIFILE_MINBUCKETS; nbuckets < priv->nentries;
+       nbuckets <<= 1);
+
+  if (nbuckets != priv->nbuckets)
+    {
+      buckets = (FAR int *)realloc(priv->buckets, nbuckets * sizeof(int));
+      if (!buckets)
+        {
+          return -ENOMEM;
+        }
+
+      priv->buckets  = buckets;
+      priv->nbuckets = nbuckets;
+    }
+
+  memset(priv->buckets, 0xff, nbuckets * sizeof(int));
+
+  for (i = 0; i < priv->nentries; i++)
+    {
+      FAR int *head = &priv->buckets[priv->entries[i].hash & (nbuckets - 1)];
+
+      priv->entries[i].next = *head;
+      *head = i;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name:  inifile_cache_add_section
+ *
+ * Description:
+ *   Append a new section to the section table and return its index or a
+ *   negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int inifile_cache_add_section(FAR struct inifile_state_s *priv,
+                                     FAR const char *name, size_t len)
+{
+  FAR struct inifile_section_s *sect;
+
+  if (priv->nsections >= UINT16_MAX)
+    {
+      return -E2BIG;
+    }
+
+  if (priv->nsections >= priv->maxsections)
+    {
+      int maxsections = priv->maxsections ?
+                        priv->maxsections * 2 : INIFILE_MINSECTIONS;
+
+      sect = (FAR struct inifile_section_s *)
+        realloc(priv->sections, maxsections * sizeof(*sect));
+      if (!sect)
+        {
+          return -ENOMEM;
+        }
+
+      priv->sections    = sect;
+      priv->maxsections = maxsections;
+    }
+
+  sect          = &priv->sections[priv->nsections];
+  sect->name    = name;
+  sect->end     = NULL;
+  sect->newname = NULL;
+  sect->hash    = inifile_hash(INIFILE_HASH_INIT, name, len);
+  sect->namelen = len;
+
+  return priv->nsections++;
+}
+
+/****************************************************************************
+ * Name:  inifile_cache_add_entry
+ *
+ * Description:
+ *   Append a new variable to the entry table.  The entry is not linked
+ *   into the hash table.
+ *
+ ****************************************************************************/
+
+static FAR struct inifile_entry_s *
+  inifile_cache_add_entry(FAR struct inifile_state_s *priv, int section,
+                          FAR const char *variable, size_t varlen)
+{
+  FAR struct inifile_entry_s *entry;
+
+  if (priv->nentries >= priv->maxentries)
+    {
+      int maxentries = priv->maxentries ?
+                       priv->maxentries * 2 : INIFILE_MINENTRIES;
+
+      entry = (FAR struct inifile_entry_s *)
+        realloc(priv->entries, maxentries * sizeof(*entry));
+      if (!entry)
+        {
+          return NULL;
+        }
+
+      priv->entries    = entry;
+      priv->maxentries = maxentries;
+    }
+
+  entry           = &priv->entries[priv->nentries++];
+  entry->variable = variable;
+  entry->value    = NULL;
+  entry->newname  = NULL;
+  entry->newvalue = NULL;
+  entry->hash     = inifile_hash(priv->sections[section].hash,
+                                 variable, varlen);
+  entry->next     = -1;
+  entry->section  = section;
+  entry->varlen   = varlen;
+  entry->vallen   = 0;
+
+  return entry;
+}
+
+/****************************************************************************
+ * Name:  inifile_cache_parse
+ *
+ * Description:
+ *   Index all sections and variables of the file image.  The visibility
+ *   rules of the streaming parser are kept: lines are truncated to
+ *   CONFIG_FSUTILS_INIFILE_MAXLINE characters after the leading white
+ *   space, a section ends at the first blank line or '[' line, only the
+ *   first header of a section and the first assignment of a variable in it
+ *   count.
+ *
+ ****************************************************************************/
+
+static int inifile_cache_parse(FAR struct inifile_state_s *priv)
+{
+  FAR struct inifile_entry_s *entry;
+  FAR const char *ptr = priv->buffer;
+  FAR const char *end = priv->buffer + priv->buflen;
+  FAR const char *eol;
+  FAR const char *next;
+  FAR const char *line;
+  FAR const char *delim;
+  size_t len;
+  int section = -1;
+
+  while (ptr < end)
+    {
+      eol  = memchr(ptr, '\n', end - ptr);
+      eol  = eol ? eol : end;
+      next = eol < end ? eol + 1 : end;
+
+      /* Ignore any leading whitespace on the line */
+
+      for (line = ptr; line < eol && (*line == ' ' || *line == '\t'); line++);
+
+      len = eol - line;
+      if (len > CONFIG_FSUTILS_INIFILE_MAXLINE)
+        {
+          len = CONFIG_FSUTILS_INIFILE_MAXLINE;
+        }
+
+      if (len == 0 || line[0] == '[')
+        {
+          /* A blank line or any '[' line ends the current section.  It
+           * takes at least three bytes of data to be a section header.
+           */
+
+          section = -1;
+          if (len >= 3)
+            {
+              delim = memchr(&line[1], ']', len - 1);
+              len   = delim ? delim - &line[1] : len - 1;
+
+              if (inifile_cache_section(priv, &line[1], len) < 0)
+                {
+                  section = inifile_cache_add_section(priv, &line[1], len);
+                  if (section < 0)
+                    {
+                      return section;
+                    }
+                }
+            }
+        }
+      else if (line[0] != ';' && section >= 0 &&
+               (delim = memchr(&line[1], '=', len - 1)) != NULL &&
+               !inifile_cache_find(priv, section, line, delim - line))
+        {
+          entry = inifile_cache_add_entry(priv, section, line, delim - line);
+          if (!entry)
+            {
+              return -ENOMEM;
+            }
+
+          entry->value  = delim + 1;
+          entry->vallen = &line[len] - entry->value;
+
+          /* Link the entry at once so that a later assignment of the same
+           * variable is recognized as a duplicate.
+           */
+
+          if (priv->nentries > priv->nbuckets)
+            {
+              int ret = inifile_cache_rehash(priv);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+          else
+            {
+              FAR int *head =
+                &priv->buckets[entry->hash & (priv->nbuckets - 1)];
+
+              entry->next = *head;
+              *head = priv->nentries - 1;
+            }
+        }
+
+      if (section >= 0)
+        {
+          priv->sections[section].end = next;
+        }
+
+      ptr = next;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name:  inifile_cache_free
+ *
+ * Description:
+ *   Release the file image, the index and all uncommitted changes.
+ *
+ ****************************************************************************/
+
+static void inifile_cache_free(FAR struct inifile_state_s *priv)
+{
+  int i;
+
+  for (i = 0; i < priv->nsections; i++)
+    {
+      free(priv->sections[i].newname);
+    }
+
+  for (i = 0; i < priv->nentries; i++)
+    {
+      free(priv->entries[i].newname);
+      free(priv->entries[i].newvalue);
+    }
+
+  free(priv->sections);
+  free(priv->entries);
+  free(priv->buckets);
+  free(priv->buffer);
+
+  priv->buffer      = NULL;
+  priv->buflen      = 0;
+  priv->sections    = NULL;
+  priv->nsections   = 0;
+  priv->maxsections = 0;
+  priv->entries     = NULL;
+  priv->nentries    = 0;
+  priv->maxentries  = 0;
+  priv->buckets     = NULL;
+  priv->nbuckets    = 0;
+  priv->dirty       = false;
+}
+
+/****************************************************************************
+ * Name:  inifile_cache_load
+ *
+ * Description:
+ *   Read the whole INI file with a single read() and index it.  Any
+ *   previous image and uncommitted changes are discarded.
+ *
+ ****************************************************************************/
+
+static int inifile_cache_load(FAR struct inifile_state_s *priv)
+{
+  struct stat buf;
+  FAR char *src;
+  FAR char *dest;
+  ssize_t nread;
+  size_t total;
+  int ret;
+  int fd;
+
+  inifile_cache_free(priv);
+
+  fd = open(priv->path, O_RDONLY);
+  if (fd < 0)
+    {
+      ret = -errno;
+      inidbg("ERROR: Could not open \"%s\": %d\n", priv->path, ret);
+      return ret;
+    }
+
+  if (fstat(fd, &buf) < 0)
+    {
+      ret = -errno;
+      goto errout_with_fd;
+    }
+
+  priv->mtime  = buf.st_mtime;
+  priv->size   = buf.st_size;
+  priv->buffer = (FAR char *)malloc(buf.st_size + 1);
+  if (!priv->buffer)
+    {
+      ret = -ENOMEM;
+      goto errout_with_fd;
+    }
+
+  for (total = 0; total < (size_t)buf.st_size; total += nread)
+    {
+      nread = read(fd, priv->buffer + total, buf.st_size - total);
+      if (nread < 0)
+        {
+          ret = -errno;
+          goto errout_with_fd;
+        }
+      else if (nread == 0)
+        {
+          break;
+        }
+    }
+
+  close(fd);
+
+  /* Always ignore carriage returns */
+
+  for (src = dest = priv->buffer; src < priv->buffer + total; src++)
+    {
+      if (*src != '\r')
+        {
+          *dest++ = *src;
+        }
+    }
+
+  priv->buflen = dest - priv->buffer;
+
+  ret = inifile_cache_rehash(priv);
+  if (ret >= 0)
+    {
+      ret = inifile_cache_parse(priv);
+    }
+
+  if (ret < 0)
+    {
+      inidbg("ERROR: Failed to index \"%s\": %d\n", priv->path, ret);
+      inifile_cache_free(priv);
+      return ret;
+    }
+
+  iniinfo("Indexed %d sections %d variables\n",
+          priv->nsections, priv->nentries);
+  return OK;
+
+errout_with_fd:
+  close(fd);
+  inifile_cache_free(priv);
+  return ret;
+}
+
+/****************************************************************************
+ * Name:  inifile_cache_check
+ *
+ * Description:
+ *   Reload the INI file if its modification time or size differs from the
+ *   cached image.  A modified image is kept until it is committed.
+ *
+ ****************************************************************************/
+
+static void inifile_cache_check(FAR struct inifile_state_s *priv)
+{
+  struct stat buf;
+
+  if (!priv->dirty && stat(priv->path, &buf) == 0 &&
+      (buf.st_mtime != priv->mtime || buf.st_size != priv->size))
+    {
+      iniinfo("\"%s\" changed, reloading\n", priv->path);
+      (void)inifile_cache_load(priv);
+    }
+}
+
+/****************************************************************************
+ * Name:  inifile_find_variable
+ *
+ * Description:
+ *   Obtains the specified string value for the specified variable name
+ *   within the specified section of the cached INI file.  The value is
+ *   copied to the line buffer, so that it is volatile just like the one
+ *   returned by the streaming parser.
+ *
+ ****************************************************************************/
+
+static FAR char *inifile_find_variable(FAR struct inifile_state_s *priv,
+                                       FAR const char *section,
+                                       FAR const char *variable)
+{
+  FAR struct inifile_entry_s *entry = NULL;
+  FAR char *ret = NULL;
+  int index;
+
+  iniinfo("section=\"%s\" variable=\"%s\"\n", section, variable);
+
+  inifile_cache_check(priv);
+
+  index = inifile_cache_section(priv, section, strlen(section));
+  if (index >= 0)
+    {
+      entry = inifile_cache_find(priv, index, variable, strlen(variable));
+    }
+
+  if (entry)
+    {
+      if (entry->newvalue)
+        {
+          strcpy(priv->line, entry->newvalue);
+        }
+      else
+        {
+          memcpy(priv->line, entry->value, entry->vallen);
+          priv->line[entry->vallen] = '\0';
+        }
+
+      if (priv->line[0] != '\0')
+        {
+          iniinfo("variable_value=\"%s\"\n", priv->line);
+          ret = priv->line;
+        }
+    }
+
+  /* Return the string that we found. */
+
+  iniinfo("Returning 0x%p\n", ret);
+  return ret;
+}
+
+/****************************************************************************
+ * Name:  inifile_commit_write
+ *
+ * Description:
+ *   Write 'len' bytes to the temporary file and remember the last one.
+ *
+ ****************************************************************************/
+
+static int inifile_commit_write(FAR FILE *stream, FAR const char *data,
+                                size_t len, FAR char *last)
+{
+  if (len == 0)
+    {
+      return OK;
+    }
+
+  *last = data[len - 1];
+  return fwrite(data, 1, len, stream) == len ? OK : -EIO;
+}
+
+/****************************************************************************
+ * Name:  inifile_commit_section
+ *
+ * Description:
+ *   Write the header of an added section and the variables added to the
+ *   section with index 'section'.  The current output position is at the
+ *   end of the last line of the section.
+ *
+ ****************************************************************************/
+
+static int inifile_commit_section(FAR struct inifile_state_s *priv,
+                                  FAR FILE *stream, int section,
+                                  FAR char *last)
+{
+  FAR struct inifile_section_s *sect = &priv->sections[section];
+  int ret = OK;
+  int i;
+
+  if (sect->newname)
+    {
+      /* Separate the section from the preceding ones by a blank line */
+
+      if (*last != '\n')
+        {
+          ret = inifile_commit_write(stream, "\n", 1, last);
+        }
+
+      if (ret >= 0 && priv->buflen > 0)
+        {
+          ret = inifile_commit_write(stream, "\n", 1, last);
+        }
+
+      if (ret >= 0 && fprintf(stream, "[%s]\n", sect->newname) < 0)
+        {
+          ret = -EIO;
+        }
+
+      *last = '\n';
+    }
+
+  for (i = 0; i < priv->nentries && ret >= 0; i++)
+    {
+      FAR struct inifile_entry_s *entry = &priv->entries[i];
+
+      if (entry->section == section && entry->newname)
+        {
+          if (*last != '\n')
+            {
+              ret = inifile_commit_write(stream, "\n", 1, last);
+            }
+
+          if (ret >= 0 &&
+              fprintf(stream, "%s=%s\n", entry->newname,
+                      entry->newvalue) < 0)
+            {
+              ret = -EIO;
+            }
+
+          *last = '\n';
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name:  inifile_commit_image
+ *
+ * Description:
+ *   Write the file image with all changes applied.  Unchanged lines,
+ *   comments included, are copied as they are.
+ *
+ ****************************************************************************/
+
+static int inifile_commit_image(FAR struct inifile_state_s *priv,
+                                FAR FILE *stream)
+{
+  FAR const char *end = priv->buffer + priv->buflen;
+  FAR const char *pos = priv->buffer;
+  FAR const char *eol;
+  char last = '\n';
+  int section = 0;
+  int ret = OK;
+  int i;
+
+  /* Original entries and sections are in file order, added ones follow */
+
+  for (i = 0; i <= priv->nentries && ret >= 0; i++)
+    {
+      FAR struct inifile_entry_s *entry =
+        i < priv->nentries ? &priv->entries[i] : NULL;
+
+      if (entry && (entry->newname || !entry->newvalue))
+        {
+          continue;
+        }
+
+      /* Insert the added variables of the sections ending before this
+       * entry.
+       */
+
+      while (ret >= 0 && section < priv->nsections &&
+             priv->sections[section].end &&
+             (!entry || priv->sections[section].end <= entry->value))
+        {
+          eol = priv->sections[section].end;
+          ret = inifile_commit_write(stream, pos, eol - pos, &last);
+          if (ret >= 0)
+            {
+              ret = inifile_commit_section(priv, stream, section, &last);
+            }
+
+          pos = eol;
+          section++;
+        }
+
+      if (ret >= 0 && entry)
+        {
+          /* Replace the rest of the line after the '=' */
+
+          eol = memchr(entry->value, '\n', end - entry->value);
+          eol = eol ? eol : end;
+
+          ret = inifile_commit_write(stream, pos, entry->value - pos, &last);
+          if (ret >= 0)
+            {
+              ret = inifile_commit_write(stream, entry->newvalue,
+                                         strlen(entry->newvalue), &last);
+            }
+
+          pos = eol;
+        }
+    }
+
+  if (ret >= 0)
+    {
+      ret = inifile_commit_write(stream, pos, end - pos, &last);
+    }
+
+  /* Then the added sections */
+
+  for (; section < priv->nsections && ret >= 0; section++)
+    {
+      ret = inifile_commit_section(priv, stream, section, &last);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_FSUTILS_INIFILE_CACHE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -513,6 +1321,20 @@ INIHANDLE inifile_initialize(FAR const char *inifile_name)
       return (INIHANDLE)NULL;
     }
 
+#ifdef CONFIG_FSUTILS_INIFILE_CACHE
+  /* Read and index the whole INI file at once */
+
+  memset(priv, 0, sizeof(struct inifile_state_s));
+  priv->path = strdup(inifile_name);
+  if (priv->path && inifile_cache_load(priv) == OK)
+    {
+      return (INIHANDLE)priv;
+    }
+
+  free(priv->path);
+  free(priv);
+  return (INIHANDLE)NULL;
+#else
   /* Open the specified INI file for reading */
 
   priv->instream = fopen(inifile_name, "r");
@@ -530,6 +1352,7 @@ INIHANDLE inifile_initialize(FAR const char *inifile_name)
       free(priv);
       return (INIHANDLE)NULL;
     }
+#endif
 }
 
 /****************************************************************************
@@ -546,12 +1369,21 @@ void inifile_uninitialize(INIHANDLE handle)
 
   if (priv)
     {
+#ifdef CONFIG_FSUTILS_INIFILE_CACHE
+      /* Release the file image and the index.  Uncommitted changes are
+       * lost.
+       */
+
+      inifile_cache_free(priv);
+      free(priv->path);
+#else
       /* Close the INI file stream */
 
       if (priv->instream)
         {
           fclose(priv->instream);
         }
+#endif
 
       /* Release the state structure */
 
@@ -669,3 +1501,213 @@ void inifile_free_string(FAR char *value)
       free(value);
     }
 }
+
+#ifdef CONFIG_FSUTILS_INIFILE_CACHE
+/****************************************************************************
+ * Name: inifile_write_string
+ *
+ * Description:
+ *   Set the specified variable within the specified section of the cached
+ *   INI file.  The section and the variable are created if they do not
+ *   exist.  The change is visible to subsequent reads at once, but the INI
+ *   file is only updated by inifile_commit().
+ *
+ ****************************************************************************/
+
+int inifile_write_string(INIHANDLE handle,
+                         FAR const char *section,
+                         FAR const char *variable,
+                         FAR const char *value)
+{
+  FAR struct inifile_state_s *priv = (FAR struct inifile_state_s *)handle;
+  FAR struct inifile_entry_s *entry;
+  FAR char *newvalue;
+  FAR char *newname;
+  size_t sectlen;
+  size_t varlen;
+  int index;
+
+  iniinfo("section=\"%s\" variable=\"%s\" value=\"%s\"\n",
+          section, variable, value);
+
+  /* The assignment must read back as it is written */
+
+  sectlen = strlen(section);
+  varlen  = strlen(variable);
+
+  if (sectlen == 0 || varlen == 0 || strpbrk(section, "]\r\n") ||
+      strpbrk(variable, "=\r\n") || strpbrk(value, "\r\n") ||
+      strchr(" \t;[", variable[0]))
+    {
+      return -EINVAL;
+    }
+
+  if (varlen + 1 + strlen(value) > CONFIG_FSUTILS_INIFILE_MAXLINE ||
+      sectlen + 2 > CONFIG_FSUTILS_INIFILE_MAXLINE)
+    {
+      return -E2BIG;
+    }
+
+  inifile_cache_check(priv);
+
+  newvalue = strdup(value);
+  if (!newvalue)
+    {
+      return -ENOMEM;
+    }
+
+  index = inifile_cache_section(priv, section, sectlen);
+  if (index < 0)
+    {
+      newname = strdup(section);
+      if (!newname)
+        {
+          goto errout_with_value;
+        }
+
+      index = inifile_cache_add_section(priv, newname, sectlen);
+      if (index < 0)
+        {
+          free(newname);
+          goto errout_with_value;
+        }
+
+      priv->sections[index].newname = newname;
+    }
+
+  entry = inifile_cache_find(priv, index, variable, varlen);
+  if (!entry)
+    {
+      newname = strdup(variable);
+      if (!newname)
+        {
+          goto errout_with_value;
+        }
+
+      entry = inifile_cache_add_entry(priv, index, newname, varlen);
+      if (!entry)
+        {
+          free(newname);
+          goto errout_with_value;
+        }
+
+      entry->newname = newname;
+
+      /* Rebuilding the hash table also links the new entry */
+
+      if (inifile_cache_rehash(priv) < 0)
+        {
+          free(newname);
+          priv->nentries--;
+          goto errout_with_value;
+        }
+    }
+
+  free(entry->newvalue);
+  entry->newvalue = newvalue;
+  priv->dirty     = true;
+  return OK;
+
+errout_with_value:
+  free(newvalue);
+  return -ENOMEM;
+}
+
+/****************************************************************************
+ * Name: inifile_write_integer
+ *
+ * Description:
+ *   Set the specified variable within the specified section of the cached
+ *   INI file to a decimal integer value.  See inifile_write_string().
+ *
+ ****************************************************************************/
+
+int inifile_write_integer(INIHANDLE handle,
+                          FAR const char *section,
+                          FAR const char *variable,
+                          long value)
+{
+  char buffer[24];
+
+  snprintf(buffer, sizeof(buffer), "%ld", value);
+  return inifile_write_string(handle, section, variable, buffer);
+}
+
+/****************************************************************************
+ * Name: inifile_commit
+ *
+ * Description:
+ *   Write the changes made by inifile_write_string() back to the INI file.
+ *   The new contents are written to a temporary file next to the INI file
+ *   which then replaces the INI file by rename(), so that readers see
+ *   either the old or the new file in full.  Comments and the layout of
+ *   unchanged lines are kept.  The INI file is reloaded afterwards.
+ *
+ ****************************************************************************/
+
+int inifile_commit(INIHANDLE handle)
+{
+  FAR struct inifile_state_s *priv = (FAR struct inifile_state_s *)handle;
+  FAR FILE *stream;
+  FAR char *tmppath;
+  int ret;
+
+  if (!priv->dirty)
+    {
+      return OK;
+    }
+
+  tmppath = (FAR char *)malloc(strlen(priv->path) + 5);
+  if (!tmppath)
+    {
+      return -ENOMEM;
+    }
+
+  sprintf(tmppath, "%s.tmp", priv->path);
+
+  stream = fopen(tmppath, "w");
+  if (!stream)
+    {
+      ret = -errno;
+      inidbg("ERROR: Could not create \"%s\": %d\n", tmppath, ret);
+      goto errout_with_path;
+    }
+
+  ret = inifile_commit_image(priv, stream);
+  if (ret >= 0 && (fflush(stream) != 0 || fsync(fileno(stream)) < 0))
+    {
+      ret = -errno;
+    }
+
+  if (fclose(stream) != 0 && ret >= 0)
+    {
+      ret = -errno;
+    }
+
+  if (ret >= 0 && rename(tmppath, priv->path) < 0)
+    {
+      ret = -errno;
+
+      /* Some file systems refuse to replace an existing file */
+
+      if (ret == -EEXIST && unlink(priv->path) == 0)
+        {
+          ret = rename(tmppath, priv->path) < 0 ? -errno : OK;
+        }
+    }
+
+  if (ret < 0)
+    {
+      inidbg("ERROR: Failed to commit \"%s\": %d\n", priv->path, ret);
+      unlink(tmppath);
+      goto errout_with_path;
+    }
+
+  free(tmppath);
+  return inifile_cache_load(priv);
+
+errout_with_path:
+  free(tmppath);
+  return ret;
+}
+#endif /* CONFIG_FSUTILS_INIFILE_CACHE */
@@ -130,6 +130,51 @@ long inifile_read_integer(INIHANDLE handle,
 
 void inifile_free_string(FAR char *value);
 
+#ifdef CONFIG_FSUTILS_INIFILE_CACHE
+/****************************************************************************
+ * Name: inifile_write_string
+ *
+ * Description:
+ *   Set the specified variable within the specified section of the cached
+ *   INI file, creating the section and the variable if needed.  The value
+ *   is visible to subsequent reads at once; the INI file itself is only
+ *   updated by inifile_commit().  Returns zero (OK) on success or a
+ *   negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int inifile_write_string(INIHANDLE handle,
+                         FAR const char *section,
+                         FAR const char *variable,
+                         FAR const char *value);
+
+/****************************************************************************
+ * Name: inifile_write_integer
+ *
+ * Description:
+ *   Set the specified variable within the specified section of the cached
+ *   INI file to a decimal integer value.  See inifile_write_string().
+ *
+ ****************************************************************************/
+
+int inifile_write_integer(INIHANDLE handle,
+                          FAR const char *section,
+                          FAR const char *variable,
+                          long value);
+
+/****************************************************************************
+ * Name: inifile_commit
+ *
+ * Description:
+ *   Atomically replace the INI file with the cached contents, including
+ *   all changes made by inifile_write_string().  Returns zero (OK) on
+ *   success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int inifile_commit(INIHANDLE handle);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -42,6 +42,8 @@ extern "C"
  * Included Files
  ****************************************************************************/
 
+#include <sdk/config.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -56,6 +58,12 @@ extern "C"
 
 #define cJSON_IsReference 256
 
+/* Events passed to a cJSON_StreamHandler */
+
+#define cJSON_StreamBegin 0    /* Start of an array or object */
+#define cJSON_StreamEnd   1    /* End of an array or object */
+#define cJSON_StreamValue 2    /* A string, number, boolean or null */
+
 #define cJSON_AddNullToObject(object,name) \
   cJSON_AddItemToObject(object, name, cJSON_CreateNull())
 #define cJSON_AddTrueToObject(object,name) \
@@ -97,6 +105,16 @@ typedef struct cJSON
    */
 
   char *string;
+
+  int flags;              /* Ownership of the item, private to cJSON.c */
+
+#ifdef CONFIG_NETUTILS_JSON_HASH_INDEX
+  /* Hashed key index of an object. Built on demand by
+   * cJSON_GetObjectItem() and dropped when the object is modified.
+   */
+
+  struct cJSON_Index *index;
+#endif
 } cJSON;
 
 typedef struct cJSON_Hooks
@@ -105,6 +123,20 @@ typedef struct cJSON_Hooks
   void (*free_fn)(void *ptr);
 } cJSON_Hooks;
 
+/* Handler called by cJSON_ParseStream() for each event.
+ *
+ *   event - cJSON_StreamBegin, cJSON_StreamEnd or cJSON_StreamValue
+ *   key   - Member name if the item is in an object, otherwise NULL
+ *   item  - Temporary item holding the type and the value. Strings point
+ *           into the parsed text.
+ *   depth - Nesting level, 0 for the top-level value
+ *
+ * Return non-zero to stop parsing.
+ */
+
+typedef int (*cJSON_StreamHandler)(void *arg, int event, const char *key,
+                                   const cJSON *item, int depth);
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -119,6 +151,29 @@ void cJSON_InitHooks(cJSON_Hooks* hooks);
 
 cJSON *cJSON_Parse(const char *value);
 
+/* Same as cJSON_Parse(), but all the items and strings of the document are
+ * allocated from a single memory block. The items remain valid until the
+ * returned root is deleted with cJSON_Delete().
+ */
+
+cJSON *cJSON_ParseArena(const char *value);
+
+/* Same as cJSON_ParseArena(), but strings are decoded in place. The text is
+ * modified, and must remain valid as long as the returned document is used.
+ */
+
+cJSON *cJSON_ParseInSitu(char *value);
+
+/* Parse the text without building a tree, calling the handler for each
+ * array, object and value. Strings are decoded in place, so the text is
+ * modified. No memory is allocated.
+ *
+ * Returns 0 when the whole text has been parsed, 1 when the handler stopped
+ * parsing, and -1 on a parse error (see cJSON_GetErrorPtr()).
+ */
+
+int cJSON_ParseStream(char *value, cJSON_StreamHandler handler, void *arg);
+
 /* Render a cJSON entity to text for transfer/storage. Free the char* when
  * finished.
  */
@@ -66,6 +66,12 @@
  *     transfers.  Default: 512 bytes.
  *   CONFIG_FTPD_WORKERSTACKSIZE - The stacksize to allocate for each
  *     FTP daemon worker thread.  Default:  2048 bytes.
+ *   CONFIG_FTPD_PIPELINE - Overlap file and network I/O of binary transfers
+ *     with a read-ahead thread.  Default: n
+ *   CONFIG_FTPD_PIPELINE_NBUFFERS - Number of data buffers in flight during
+ *     an overlapped transfer.  Default: 2
+ *   CONFIG_FTPD_PIPELINE_STACKSIZE - The stacksize of the read-ahead
+ *     thread.  Default: 1024 bytes.
  */
 
 #ifdef CONFIG_DISABLE_PTHREAD
@@ -96,6 +102,18 @@
 #  define CONFIG_FTPD_WORKERSTACKSIZE 2048
 #endif
 
+#ifdef CONFIG_FTPD_PIPELINE
+#  ifndef CONFIG_FTPD_PIPELINE_NBUFFERS
+#    define CONFIG_FTPD_PIPELINE_NBUFFERS 2
+#  endif
+#  if CONFIG_FTPD_PIPELINE_NBUFFERS < 2
+#    error "CONFIG_FTPD_PIPELINE_NBUFFERS must be at least 2"
+#  endif
+#  ifndef CONFIG_FTPD_PIPELINE_STACKSIZE
+#    define CONFIG_FTPD_PIPELINE_STACKSIZE 1024
+#  endif
+#endif
+
 /* Interface definitions ****************************************************/
 
 #define FTPD_ACCOUNTFLAG_NONE    (0)
@@ -0,0 +1,222 @@
+/****************************************************************************
+ * system/include/system/logsave.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INCLUDE_SYSTEM_LOGSAVE_H
+#define __APPS_INCLUDE_SYSTEM_LOGSAVE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************/
+
+/* The number of bytes of a log entry which are compressed and written as
+ * one chunk.  The work buffers used by logsave_write() are allocated from
+ * the heap and are about this size plus LOGSAVE_HASHSIZE.
+ */
+
+#ifndef CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE
+#  define CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE 4096
+#endif
+
+/* Chunk format *************************************************************/
+
+/* A compressed log file is a sequence of chunks.  Each chunk is a struct
+ * logsave_chunk_s header followed by 'size' bytes of payload which expand
+ * to 'rawsize' bytes of the original log.  The CRC covers the header
+ * fields before 'crc' and the payload, so a chunk cut short by a power
+ * loss during the save is detected and skipped by the reader.  All fields
+ * are little endian.
+ */
+
+#define LOGSAVE_CHUNK_MAGIC   0x4b4e4843  /* 'C''H''N''K' */
+
+#define LOGSAVE_CHUNK_STORED  0x0001      /* Payload is not compressed */
+#define LOGSAVE_CHUNK_FIRST   0x0002      /* First chunk of a log entry */
+#define LOGSAVE_CHUNK_LAST    0x0004      /* Last chunk of a log entry */
+
+/* Size of the hash table passed to logsave_compress() */
+
+#define LOGSAVE_HASHBITS      11
+#define LOGSAVE_HASHSIZE      ((1 << LOGSAVE_HASHBITS) * sizeof(uint16_t))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct logsave_chunk_s
+{
+  uint32_t magic;    /* LOGSAVE_CHUNK_MAGIC */
+  uint16_t rawsize;  /* Size of the chunk after decompression */
+  uint16_t size;     /* Size of the payload following this header */
+  uint16_t seq;      /* Chunk number in the log entry */
+  uint16_t flags;    /* LOGSAVE_CHUNK_* */
+  uint32_t crc;      /* CRC32 of the fields above and the payload */
+};
+
+/* Result of logsave_unpack() */
+
+struct logsave_unpack_s
+{
+  uint32_t entries;  /* Number of log entries found */
+  uint32_t chunks;   /* Number of chunks decoded */
+  uint32_t bad;      /* Number of corrupted or truncated chunks */
+  uint32_t lost;     /* Number of chunks missing from an entry */
+  size_t   rawsize;  /* Total number of bytes decoded */
+  size_t   skipped;  /* Number of bytes skipped to find the next chunk */
+};
+
+/* Called by logsave_unpack() for each decoded chunk.  A negative return
+ * value stops the unpacking and is returned by logsave_unpack().
+ */
+
+typedef CODE int (*logsave_output_t)(FAR void *arg,
+                                     FAR const struct logsave_chunk_s *chunk,
+                                     FAR const uint8_t *data, size_t len);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: logsave_compress
+ *
+ * Description:
+ *   Compress a buffer of at most 64KiB with a fast LZ77 coder of the LZF
+ *   family.
+ *
+ * Input Parameters:
+ *   src    - The data to compress
+ *   srclen - The size of the data
+ *   dst    - The buffer receiving the compressed data
+ *   dstlen - The size of the buffer
+ *   htab   - A work area of LOGSAVE_HASHSIZE bytes
+ *
+ * Returned Value:
+ *   The size of the compressed data, or zero if it doesn't fit in dstlen.
+ *
+ ****************************************************************************/
+
+size_t logsave_compress(FAR const uint8_t *src, size_t srclen,
+                        FAR uint8_t *dst, size_t dstlen,
+                        FAR uint16_t *htab);
+
+/****************************************************************************
+ * Name: logsave_decompress
+ *
+ * Description:
+ *   Expand data compressed with logsave_compress().
+ *
+ * Returned Value:
+ *   The size of the expanded data, or -EINVAL if the data is malformed or
+ *   doesn't fit in dstlen.
+ *
+ ****************************************************************************/
+
+ssize_t logsave_decompress(FAR const uint8_t *src, size_t srclen,
+                           FAR uint8_t *dst, size_t dstlen);
+
+/****************************************************************************
+ * Name: logsave_write
+ *
+ * Description:
+ *   Compress a log entry and write it to a file as a sequence of chunks of
+ *   CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE bytes.  The log is read in place, so
+ *   only one chunk is held in memory at a time.
+ *
+ * Input Parameters:
+ *   fd   - The file descriptor to write to
+ *   addr - The log data
+ *   size - The size of the log data
+ *
+ * Returned Value:
+ *   The number of bytes written on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t logsave_write(int fd, FAR const void *addr, size_t size);
+
+/****************************************************************************
+ * Name: logsave_unpack
+ *
+ * Description:
+ *   Decode the chunks of a compressed log file held in memory.  Chunks
+ *   with a bad CRC are counted and skipped, and decoding resumes at the
+ *   next valid chunk header.
+ *
+ * Input Parameters:
+ *   buf    - The contents of the file
+ *   len    - The size of the file
+ *   output - The function called with each decoded chunk
+ *   arg    - The argument passed to output
+ *   stat   - Returns the statistics of the file. May be NULL.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int logsave_unpack(FAR const uint8_t *buf, size_t len,
+                   logsave_output_t output, FAR void *arg,
+                   FAR struct logsave_unpack_s *stat);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __APPS_INCLUDE_SYSTEM_LOGSAVE_H */
@@ -44,6 +44,7 @@
 #include <string.h>
 #include <syslog.h>
 #include <time.h>
+#include <errno.h>
 
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -53,6 +54,22 @@
 
 #include "logdump.h"
 
+#ifdef CONFIG_SYSTEM_LOGSAVE_COMPRESS
+#  include "system/logsave.h"
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSTEM_LOGSAVE_COMPRESS
+struct logdump_buf_s
+{
+  uint8_t *data;
+  size_t len;
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -71,6 +88,65 @@ static void logdump_sub(char *name, void *addr, size_t size)
     }
 }
 
+#ifdef CONFIG_SYSTEM_LOGSAVE_COMPRESS
+static int logdump_append(void *arg, const struct logsave_chunk_s *chunk,
+                          const uint8_t *data, size_t len)
+{
+  struct logdump_buf_s *buf = (struct logdump_buf_s *)arg;
+  uint8_t *newdata;
+
+  newdata = realloc(buf->data, buf->len + len);
+  if (!newdata)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newdata + buf->len, data, len);
+  buf->data = newdata;
+  buf->len += len;
+  return OK;
+}
+
+/* Expand a file saved by logsave with CONFIG_SYSTEM_LOGSAVE_COMPRESS.
+ * Files saved without compression are left as they are.
+ */
+
+static void logdump_unpack(void **addr, size_t *size)
+{
+  struct logdump_buf_s buf;
+  struct logsave_unpack_s stat;
+  uint32_t magic;
+
+  if (*size < sizeof(magic))
+    {
+      return;
+    }
+
+  memcpy(&magic, *addr, sizeof(magic));
+  if (magic != LOGSAVE_CHUNK_MAGIC)
+    {
+      return;
+    }
+
+  buf.data = NULL;
+  buf.len  = 0;
+
+  if (logsave_unpack(*addr, *size, logdump_append, &buf, &stat) < 0)
+    {
+      printf("Not enough memory\n");
+      free(buf.data);
+      return;
+    }
+
+  printf("=== %u entries, %u chunks (%u bad, %u lost)\n",
+         stat.entries, stat.chunks, stat.bad, stat.lost);
+
+  free(*addr);
+  *addr = buf.data;
+  *size = buf.len;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -140,6 +216,10 @@ int logdump_main(int argc, char **argv)
       fseek(fp, 0, SEEK_SET);
       fread(addr, size, 1, fp);
 
+#ifdef CONFIG_SYSTEM_LOGSAVE_COMPRESS
+      logdump_unpack(&addr, &size);
+#endif
+
       printf("=== Dump %s (%d bytes)\n", logfile, size);
       logdump_sub(name, addr, size);
 
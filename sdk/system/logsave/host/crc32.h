@@ -0,0 +1,79 @@
+/****************************************************************************
+ * system/logsave/host/crc32.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_SYSTEM_LOGSAVE_HOST_CRC32_H
+#define __APPS_SYSTEM_LOGSAVE_HOST_CRC32_H
+
+/* Table driven CRC32 matching the one of the NuttX C library */
+
+#include <stddef.h>
+#include <stdint.h>
+
+static inline uint32_t crc32part(const uint8_t *src, size_t len,
+                                 uint32_t crc32val)
+{
+  static uint32_t table[256];
+  uint32_t c;
+  int i;
+  int j;
+
+  if (table[1] == 0)
+    {
+      for (i = 0; i < 256; i++)
+        {
+          for (c = i, j = 0; j < 8; j++)
+            {
+              c = (c >> 1) ^ (0xedb88320 & -(c & 1));
+            }
+
+          table[i] = c;
+        }
+    }
+
+  crc32val = ~crc32val;
+  while (len-- > 0)
+    {
+      crc32val = table[(crc32val ^ *src++) & 0xff] ^ (crc32val >> 8);
+    }
+
+  return ~crc32val;
+}
+
+static inline uint32_t crc32(const uint8_t *src, size_t len)
+{
+  return crc32part(src, len, 0);
+}
+
+#endif /* __APPS_SYSTEM_LOGSAVE_HOST_CRC32_H */
@@ -0,0 +1,830 @@
+/****************************************************************************
+ * system/logsave/host/logsavebench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark for logsave.  Each simulated boot leaves a crash dump, a
+ *   binary audio debug log and a syslog text log in the backup SRAM, and
+ *   logsave_main() saves them to CONFIG_SYSTEM_LOGSAVE_MOUNTPOINT.  The
+ *   saved files, including the rotated ones, are read back and compared
+ *   with the logs of the last boots.  For each log the bytes written, the
+ *   compression ratio, the CPU time and the flash write time at the given
+ *   rate are reported.
+ *
+ *   With -t, the chunk reader is also checked against truncated and
+ *   corrupted files.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <errno.h>
+
+#include <arch/chip/backuplog.h>
+
+#include "system/logsave.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NLOGS          3
+#define DEF_BOOTS      16
+#define DEF_FLASHRATE  64    /* KiB/s, SPI flash through smartfs */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct samplelog_s
+{
+  const char *name;
+  size_t size;
+  void (*generate)(uint8_t *buf, size_t size, uint32_t seed);
+  uint8_t *buf;
+  bool saved;
+  uint64_t written;     /* Bytes written to the file system */
+  uint64_t cputime;     /* Nanoseconds spent in logsave */
+};
+
+struct collect_s
+{
+  uint8_t *buf;
+  size_t len;
+  size_t max;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+int logsave_main(int argc, char **argv);
+
+static void gen_crash(uint8_t *buf, size_t size, uint32_t seed);
+static void gen_audio(uint8_t *buf, size_t size, uint32_t seed);
+static void gen_syslog(uint8_t *buf, size_t size, uint32_t seed);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct samplelog_s g_logs[NLOGS] =
+{
+  { "crash",    1024,  gen_crash  },
+  { "audiodbg", 8192,  gen_audio  },
+  { "syslog",   16384, gen_syslog },
+};
+
+static int g_current = -1;
+static struct timespec g_start;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t rnd(uint32_t *seed)
+{
+  *seed = *seed * 1103515245 + 12345;
+  return *seed >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+  memcpy(p, &v, sizeof(v));
+}
+
+/* A crashdump fullcontext_t: the fault information with the registers,
+ * followed by the interrupt and user stacks.  Parts of the stacks are still
+ * painted with the stack coloring pattern.
+ */
+
+static void gen_crash(uint8_t *buf, size_t size, uint32_t seed)
+{
+  static const char *tasks[] =
+  {
+    "audio_task", "gnss_main", "lte_daemon", "sensor_mgr"
+  };
+
+  size_t i;
+  uint32_t v;
+
+  memset(buf, 0, size);
+  put32(&buf[0], 3600 + rnd(&seed) % 100000);
+  put32(&buf[4], rnd(&seed) % 1000000000);
+  put32(&buf[8], 0x07);
+  put32(&buf[12], 0x0d0f8000 + (rnd(&seed) & 0xff0));
+  put32(&buf[16], 100 + rnd(&seed) % 2000);
+  put32(&buf[20], 3 + rnd(&seed) % 20);
+
+  /* S0-S31 and FPSCR are mostly unused, then R0-R15 and xPSR */
+
+  for (i = 0; i < 8; i++)
+    {
+      put32(&buf[24 + i * 4], rnd(&seed) % 4 == 0 ? rnd(&seed) : 0);
+    }
+
+  for (i = 0; i < 17; i++)
+    {
+      v = rnd(&seed);
+      put32(&buf[24 + (33 + i) * 4], v % 3 == 0 ? 0x0d000000 + (v & 0x3fffc) :
+                                     v % 3 == 1 ? 0x0d0f0000 + (v & 0xfffc) :
+                                     v % 64);
+    }
+
+  snprintf((char *)&buf[260], 32, "%s", tasks[rnd(&seed) % 4]);
+  snprintf((char *)&buf[292], 40, "cxd56_%s.c", rnd(&seed) % 2 ? "dmac" :
+                                                                 "uart");
+
+  /* The stacks: return addresses, stack pointers and small values, with
+   * the unused end still painted
+   */
+
+  for (i = 336; i + 4 <= size; i += 4)
+    {
+      v = rnd(&seed);
+      if ((i > 560 && i < 680) || i > 900)
+        {
+          v = 0xdeadbeef;
+        }
+      else if (v % 4 == 0)
+        {
+          v = (0x0d010000 + (v & 0x1fffe)) | 1;
+        }
+      else if (v % 4 == 1)
+        {
+          v = 0x0d0f0000 + (v & 0xfffc);
+        }
+      else if (v % 4 == 2)
+        {
+          v = 0;
+        }
+      else
+        {
+          v %= 256;
+        }
+
+      put32(&buf[i], v);
+    }
+}
+
+/* Fixed size trace records of the audio components */
+
+static void gen_audio(uint8_t *buf, size_t size, uint32_t seed)
+{
+  uint32_t time = rnd(&seed) % 1000000;
+  size_t i;
+
+  for (i = 0; i + 16 <= size; i += 16)
+    {
+      uint32_t event = rnd(&seed) % 12;
+
+      time += 100 + rnd(&seed) % 2000;
+      put32(&buf[i], time);
+      put32(&buf[i + 4], event | (event < 6 ? 0x00010000 : 0x00020000));
+      put32(&buf[i + 8], event < 4 ? 0x0d080000 + (rnd(&seed) & 0x7f00) :
+                                     rnd(&seed) % 4096);
+      put32(&buf[i + 12], rnd(&seed) % 16);
+    }
+}
+
+static void gen_syslog(uint8_t *buf, size_t size, uint32_t seed)
+{
+  static const char *msgs[] =
+  {
+    "cxd56_audio: set volume %d dB",
+    "gnss: fix acquired, %d satellites",
+    "lte: modem state changed to %d",
+    "smartfs: sector %d allocated",
+    "usbdev: configuration %d selected",
+    "sensor: accel fifo level %d",
+    "lte: rssi %d dBm",
+    "cxd56_dmac: channel %d transfer done",
+  };
+
+  uint32_t ms = rnd(&seed) % 100000;
+  size_t len = 0;
+  char line[128];
+  int n;
+
+  while (len < size)
+    {
+      uint32_t m = rnd(&seed) % 8;
+
+      ms += rnd(&seed) % 500;
+      n = snprintf(line, sizeof(line), "[%6u.%03u] ", ms / 1000, ms % 1000);
+      n += snprintf(&line[n], sizeof(line) - n, msgs[m],
+                    (int)(rnd(&seed) % 100) - (m == 0 || m == 6 ? 90 : 0));
+      line[n++] = '\n';
+
+      if (n > size - len)
+        {
+          n = size - len;
+        }
+
+      memcpy(&buf[len], line, n);
+      len += n;
+    }
+}
+
+static void account(void)
+{
+  uint64_t t = now_ns();
+
+  if (g_current >= 0)
+    {
+      g_logs[g_current].cputime += t - ((uint64_t)g_start.tv_sec *
+                                        1000000000ull + g_start.tv_nsec);
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &g_start);
+}
+
+static void make_logs(int boot)
+{
+  int i;
+
+  for (i = 0; i < NLOGS; i++)
+    {
+      g_logs[i].generate(g_logs[i].buf, g_logs[i].size, boot * NLOGS + i);
+      g_logs[i].saved = false;
+    }
+}
+
+static int collect(FAR void *arg, FAR const struct logsave_chunk_s *chunk,
+                   FAR const uint8_t *data, size_t len)
+{
+  struct collect_s *c = (struct collect_s *)arg;
+
+  if (c->len + len > c->max)
+    {
+      return -E2BIG;
+    }
+
+  memcpy(&c->buf[c->len], data, len);
+  c->len += len;
+  return OK;
+}
+
+static uint8_t *read_file(const char *path, size_t *size)
+{
+  struct stat st;
+  uint8_t *buf;
+  int fd;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0 || fstat(fd, &st) < 0)
+    {
+      return NULL;
+    }
+
+  buf = malloc(st.st_size + 1);
+  if (read(fd, buf, st.st_size) != st.st_size)
+    {
+      free(buf);
+      buf = NULL;
+    }
+
+  close(fd);
+  *size = st.st_size;
+  return buf;
+}
+
+/* Read back the saved files of a log, oldest first, and compare them with
+ * the logs of the last boots.  Returns the number of boots found.
+ */
+
+static int verify(struct samplelog_s *log, int boots)
+{
+  struct collect_s c;
+  char path[128];
+  uint8_t *expect;
+  uint8_t *file;
+  size_t size;
+  int nboots;
+  int i;
+
+  c.max = (size_t)boots * log->size;
+  c.buf = malloc(c.max);
+  c.len = 0;
+
+  for (i = CONFIG_SYSTEM_LOGSAVE_NFILES; i >= 0; i--)
+    {
+      if (i == 0)
+        {
+          snprintf(path, sizeof(path),
+                   CONFIG_SYSTEM_LOGSAVE_MOUNTPOINT "/%s.log", log->name);
+        }
+      else
+        {
+          snprintf(path, sizeof(path),
+                   CONFIG_SYSTEM_LOGSAVE_MOUNTPOINT "/%s.%d.log",
+                   log->name, i);
+        }
+
+      file = read_file(path, &size);
+      if (file == NULL)
+        {
+          continue;
+        }
+
+      if (i >= CONFIG_SYSTEM_LOGSAVE_NFILES)
+        {
+          printf("ERROR: %s should have been removed\n", path);
+          free(file);
+          free(c.buf);
+          return -1;
+        }
+
+#ifdef CONFIG_SYSTEM_LOGSAVE_COMPRESS
+      {
+        struct logsave_unpack_s stat;
+
+        if (logsave_unpack(file, size, collect, &c, &stat) < 0 ||
+            stat.bad != 0 || stat.lost != 0)
+          {
+            printf("ERROR: %s: %u bad, %u lost chunks\n", path,
+                   stat.bad, stat.lost);
+            free(file);
+            free(c.buf);
+            return -1;
+          }
+      }
+#else
+      collect(&c, NULL, file, size);
+#endif
+
+      free(file);
+    }
+
+  /* The files hold the logs of the last nboots boots */
+
+  nboots = c.len / log->size;
+  expect = malloc(log->size);
+
+  for (i = 0; i < nboots && c.len % log->size == 0; i++)
+    {
+      log->generate(expect, log->size, (boots - nboots + i) * NLOGS +
+                                       (log - g_logs));
+      if (memcmp(expect, &c.buf[i * log->size], log->size) != 0)
+        {
+          break;
+        }
+    }
+
+  free(expect);
+  free(c.buf);
+  return i == nboots && nboots > 0 ? nboots : -1;
+}
+
+#ifdef CONFIG_SYSTEM_LOGSAVE_COMPRESS
+/* Save a log into memory the way logsave_write() writes it to a file */
+
+static uint8_t *pack(const uint8_t *src, size_t size, size_t *len)
+{
+  char path[] = "/tmp/logsavebench-XXXXXX";
+  uint8_t *buf;
+  int fd;
+
+  fd = mkstemp(path);
+  if (fd < 0)
+    {
+      return NULL;
+    }
+
+  unlink(path);
+  if (logsave_write(fd, src, size) < 0)
+    {
+      close(fd);
+      return NULL;
+    }
+
+  *len = lseek(fd, 0, SEEK_CUR);
+  buf  = malloc(*len);
+  if (pread(fd, buf, *len, 0) != (ssize_t)*len)
+    {
+      free(buf);
+      buf = NULL;
+    }
+
+  close(fd);
+  return buf;
+}
+
+static int put_chunk(FAR void *arg, FAR const struct logsave_chunk_s *chunk,
+                     FAR const uint8_t *data, size_t len)
+{
+  struct collect_s *c = (struct collect_s *)arg;
+  size_t offset = (size_t)chunk->seq * CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE;
+
+  if (offset + len > c->max)
+    {
+      return -E2BIG;
+    }
+
+  memcpy(&c->buf[offset], data, len);
+  c->len++;
+  return OK;
+}
+
+/* Check the reader against files cut short or corrupted during the save */
+
+static int test_reader(void)
+{
+  struct logsave_unpack_s stat;
+  struct collect_s c;
+  uint8_t *orig;
+  uint8_t *file;
+  uint8_t *copy;
+  uint8_t *comp;
+  uint16_t *htab;
+  size_t nchunks;
+  size_t size = 16384;
+  size_t len;
+  size_t n;
+  size_t i;
+  ssize_t ret;
+  uint32_t seed = 1;
+  int errors = 0;
+
+  orig = malloc(size);
+  gen_syslog(orig, size, 42);
+  nchunks = (size + CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE - 1) /
+            CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE;
+
+  file = pack(orig, size, &len);
+  if (file == NULL)
+    {
+      printf("ERROR: Failed to save the log\n");
+      free(orig);
+      return -1;
+    }
+
+  copy = malloc(len + size + 64);
+  c.max = 2 * size;
+  c.buf = malloc(c.max);
+
+  /* Truncation at every position: the complete chunks are decoded and the
+   * rest is reported
+   */
+
+  for (n = 0; n < len; n++)
+    {
+      c.len = 0;
+      if (logsave_unpack(file, n, collect, &c, &stat) < 0 ||
+          memcmp(c.buf, orig, c.len) != 0 ||
+          c.len % CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE != 0 ||
+          (n > 0 && stat.bad + stat.lost == 0))
+        {
+          printf("ERROR: truncated at %lu: %lu bytes, %u bad, %u lost\n",
+                 (unsigned long)n, (unsigned long)c.len, stat.bad,
+                 stat.lost);
+          errors++;
+        }
+    }
+
+  /* A corrupted byte loses only the chunk holding it */
+
+  for (n = 0; n < len; n++)
+    {
+      memcpy(copy, file, len);
+      copy[n] ^= 1 << (n % 8);
+
+      memset(c.buf, 0, c.max);
+      c.len = 0;
+      if (logsave_unpack(copy, len, put_chunk, &c, &stat) < 0 ||
+          stat.bad != 1 || c.len != nchunks - 1)
+        {
+          printf("ERROR: corrupted at %lu: %lu chunks, %u bad\n",
+                 (unsigned long)n, (unsigned long)c.len, stat.bad);
+          errors++;
+          continue;
+        }
+
+      for (i = 0; i < nchunks; i++)
+        {
+          size_t off = i * CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE;
+          size_t clen = size - off < CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE ?
+                        size - off : CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE;
+
+          /* The lost chunk is left zero filled */
+
+          if (memcmp(&c.buf[off], &orig[off], clen) != 0 &&
+              (c.buf[off] != 0 ||
+               memcmp(&c.buf[off], &c.buf[off + 1], clen - 1) != 0))
+            {
+              printf("ERROR: corrupted at %lu: chunk %lu differs\n",
+                     (unsigned long)n, (unsigned long)i);
+              errors++;
+            }
+        }
+    }
+
+  /* A save interrupted by a reset, followed by the save of the next boot */
+
+  for (n = 1; n < len; n += 97)
+    {
+      memcpy(copy, file, n);
+      memcpy(&copy[n], file, len);
+
+      c.len = 0;
+      if (logsave_unpack(copy, n + len, collect, &c, &stat) < 0 ||
+          stat.entries < 1 || stat.bad + stat.lost == 0 || c.len < size ||
+          memcmp(&c.buf[c.len - size], orig, size) != 0)
+        {
+          printf("ERROR: appended after %lu: %u entries, %u bad, "
+                 "%u lost\n", (unsigned long)n, stat.entries, stat.bad,
+                 stat.lost);
+          errors++;
+        }
+    }
+
+  /* Round trip of the compressor with data of various entropy, and output
+   * buffers too small for the result
+   */
+
+  comp = malloc(2 * size);
+  htab = malloc(LOGSAVE_HASHSIZE);
+
+  for (n = 1; n < 2000; n++)
+    {
+      size_t len2 = 1 + rnd(&seed) % size;
+      uint32_t mask = (1u << (rnd(&seed) % 9)) - 1;
+      size_t clen;
+
+      for (i = 0; i < len2; i++)
+        {
+          copy[i] = i > 64 && rnd(&seed) % 4 ? copy[i - 1 - rnd(&seed) % 64] :
+                    (uint8_t)(rnd(&seed) & mask);
+        }
+
+      clen = logsave_compress(copy, len2, comp, 2 * size, htab);
+      ret  = logsave_decompress(comp, clen, c.buf, len2);
+      if (clen == 0 || ret != (ssize_t)len2 || memcmp(c.buf, copy, len2))
+        {
+          printf("ERROR: round trip of %lu bytes failed\n",
+                 (unsigned long)len2);
+          errors++;
+        }
+
+      if (clen > 1 &&
+          logsave_compress(copy, len2, comp, clen - 1, htab) != 0)
+        {
+          printf("ERROR: overflow of %lu bytes not detected\n",
+                 (unsigned long)(clen - 1));
+          errors++;
+        }
+    }
+
+  printf("reader: %lu truncations, %lu corruptions: %s\n",
+         (unsigned long)len, (unsigned long)len, errors ? "FAILED" : "OK");
+
+  free(htab);
+  free(comp);
+  free(c.buf);
+  free(copy);
+  free(file);
+  free(orig);
+  return errors ? -1 : 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int up_backuplog_entry(char *name, void **addr, size_t *size)
+{
+  int i;
+
+  account();
+
+  for (i = 0; i < NLOGS; i++)
+    {
+      if (!g_logs[i].saved)
+        {
+          strncpy(name, g_logs[i].name, 8);
+          *addr = g_logs[i].buf;
+          *size = g_logs[i].size;
+          g_current = i;
+          return OK;
+        }
+    }
+
+  g_current = -1;
+  return -ENOENT;
+}
+
+void up_backuplog_free(const char *name)
+{
+  int i;
+
+  for (i = 0; i < NLOGS; i++)
+    {
+      if (strncmp(g_logs[i].name, name, 8) == 0)
+        {
+          g_logs[i].saved = true;
+        }
+    }
+}
+
+/* Count the bytes logsave writes to the file system */
+
+ssize_t __real_write(int fd, const void *buf, size_t count);
+
+ssize_t __wrap_write(int fd, const void *buf, size_t count)
+{
+  ssize_t ret = __real_write(fd, buf, count);
+
+  if (ret > 0 && g_current >= 0)
+    {
+      g_logs[g_current].written += ret;
+    }
+
+  return ret;
+}
+
+int main(int argc, FAR char **argv)
+{
+  uint64_t raw = 0;
+  uint64_t written = 0;
+  uint64_t cputime = 0;
+  int boots = DEF_BOOTS;
+  int rate = DEF_FLASHRATE;
+  bool test = false;
+  int failed = 0;
+  int stdoutfd;
+  int nullfd;
+  int option;
+  int boot;
+  int kept;
+  int i;
+
+  while ((option = getopt(argc, argv, ":n:w:th")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'n':
+            boots = atoi(optarg);
+            break;
+
+          case 'w':
+            rate = atoi(optarg);
+            break;
+
+          case 't':
+            test = true;
+            break;
+
+          default:
+            fprintf(stderr, "USAGE: %s [-n <boots>] [-w <KiB/s>] [-t]\n",
+                    argv[0]);
+            fprintf(stderr, "\t-n <boots>: Number of boots. Default: %d\n",
+                    DEF_BOOTS);
+            fprintf(stderr, "\t-w <KiB/s>: Flash write rate. Default: %d\n",
+                    DEF_FLASHRATE);
+            fprintf(stderr, "\t-t: Test the reader with damaged files\n");
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+  if (system("rm -rf " CONFIG_SYSTEM_LOGSAVE_MOUNTPOINT) != 0 ||
+      mkdir(CONFIG_SYSTEM_LOGSAVE_MOUNTPOINT, 0755) < 0)
+    {
+      fprintf(stderr, "ERROR: Failed to create %s\n",
+              CONFIG_SYSTEM_LOGSAVE_MOUNTPOINT);
+      return EXIT_FAILURE;
+    }
+
+  for (i = 0; i < NLOGS; i++)
+    {
+      g_logs[i].buf = malloc(g_logs[i].size);
+    }
+
+  /* Run logsave once per boot with its messages discarded */
+
+  nullfd   = open("/dev/null", O_WRONLY);
+  stdoutfd = dup(STDOUT_FILENO);
+
+  for (boot = 0; boot < boots; boot++)
+    {
+      make_logs(boot);
+
+      fflush(stdout);
+      dup2(nullfd, STDOUT_FILENO);
+      g_current = -1;
+      logsave_main(argc, argv);
+      fflush(stdout);
+      dup2(stdoutfd, STDOUT_FILENO);
+    }
+
+  printf("%s, %d boots, chunk %d bytes, flash %d KiB/s\n",
+#ifdef CONFIG_SYSTEM_LOGSAVE_COMPRESS
+         "compressed",
+#else
+         "uncompressed",
+#endif
+         boots, CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE, rate);
+  printf("%-9s %7s %8s %6s %9s %9s %5s\n", "log", "raw", "written",
+         "ratio", "cpu [us]", "flash[ms]", "kept");
+
+  for (i = 0; i < NLOGS; i++)
+    {
+      struct samplelog_s *log = &g_logs[i];
+
+      kept = verify(log, boots);
+      if (kept < 0)
+        {
+          failed++;
+        }
+
+      printf("%-9s %7lu %8lu %5.1f%% %9.1f %9.1f %5d\n", log->name,
+             (unsigned long)log->size,
+             (unsigned long)(log->written / boots),
+             100.0 * log->written / ((double)log->size * boots),
+             log->cputime / 1000.0 / boots,
+             log->written * 1000.0 / (rate * 1024.0) / boots, kept);
+
+      raw     += log->size;
+      written += log->written;
+      cputime += log->cputime;
+    }
+
+  printf("%-9s %7lu %8lu %5.1f%% %9.1f %9.1f\n", "per boot",
+         (unsigned long)raw, (unsigned long)(written / boots),
+         100.0 * written / ((double)raw * boots),
+         cputime / 1000.0 / boots,
+         written * 1000.0 / (rate * 1024.0) / boots);
+  printf("verify: %s\n", failed ? "MISMATCH" : "OK");
+
+#ifdef CONFIG_SYSTEM_LOGSAVE_COMPRESS
+  if (test && test_reader() < 0)
+    {
+      failed++;
+    }
+#else
+  (void)test;
+#endif
+
+  for (i = 0; i < NLOGS; i++)
+    {
+      free(g_logs[i].buf);
+    }
+
+  close(nullfd);
+  close(stdoutfd);
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
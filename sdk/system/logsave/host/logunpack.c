@@ -0,0 +1,245 @@
+/****************************************************************************
+ * system/logsave/host/logunpack.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host reader for the log files saved by logsave with
+ *   CONFIG_SYSTEM_LOGSAVE_COMPRESS.  The chunks of each file are checked,
+ *   expanded and written in order to the output.  Files which are not
+ *   compressed are copied as they are, so rotated files of both formats can
+ *   be given at once, oldest first:
+ *
+ *     logunpack -o crash.bin crash.2.log crash.1.log crash.log
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "system/logsave.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(FAR const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-o <output>] [-v] <file> [<file> ...]\n",
+                  progname);
+  fprintf(stderr, "\t-o <output>: Write the expanded logs here. "
+                  "Default: stdout\n");
+  fprintf(stderr, "\t-v: Show each chunk\n");
+  fprintf(stderr, "\t-h: Show this text and exit\n");
+  exit(errcode);
+}
+
+static FAR uint8_t *read_file(FAR const char *path, FAR size_t *size)
+{
+  FAR uint8_t *buf;
+  FILE *fp;
+  long len;
+
+  fp = fopen(path, "rb");
+  if (fp == NULL)
+    {
+      return NULL;
+    }
+
+  fseek(fp, 0, SEEK_END);
+  len = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  buf = malloc(len > 0 ? len : 1);
+  if (buf != NULL && fread(buf, 1, len, fp) != (size_t)len)
+    {
+      free(buf);
+      buf = NULL;
+    }
+
+  fclose(fp);
+  *size = len;
+  return buf;
+}
+
+static int write_chunk(FAR void *arg, FAR const struct logsave_chunk_s *chunk,
+                       FAR const uint8_t *data, size_t len)
+{
+  FILE *out = (FILE *)arg;
+
+  if (fwrite(data, 1, len, out) != len)
+    {
+      return -EIO;
+    }
+
+  return OK;
+}
+
+static int show_chunk(FAR void *arg, FAR const struct logsave_chunk_s *chunk,
+                      FAR const uint8_t *data, size_t len)
+{
+  fprintf(stderr, "  chunk %5u: %5u -> %5u bytes%s%s%s\n",
+          chunk->seq, chunk->size, chunk->rawsize,
+          chunk->flags & LOGSAVE_CHUNK_STORED ? " stored" : "",
+          chunk->flags & LOGSAVE_CHUNK_FIRST ? " first" : "",
+          chunk->flags & LOGSAVE_CHUNK_LAST ? " last" : "");
+  return write_chunk(arg, chunk, data, len);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, FAR char **argv)
+{
+  struct logsave_unpack_s stat;
+  FAR const char *outpath = NULL;
+  FAR uint8_t *buf;
+  FILE *out = stdout;
+  bool verbose = false;
+  bool failed = false;
+  uint32_t magic;
+  size_t size;
+  int option;
+  int ret;
+
+  while ((option = getopt(argc, argv, ":o:vh")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'o':
+            outpath = optarg;
+            break;
+
+          case 'v':
+            verbose = true;
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (optind >= argc)
+    {
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+
+  if (outpath != NULL)
+    {
+      out = fopen(outpath, "wb");
+      if (out == NULL)
+        {
+          fprintf(stderr, "ERROR: Failed to open %s: %d\n", outpath, errno);
+          return EXIT_FAILURE;
+        }
+    }
+
+  for (; optind < argc; optind++)
+    {
+      buf = read_file(argv[optind], &size);
+      if (buf == NULL)
+        {
+          fprintf(stderr, "ERROR: Failed to read %s\n", argv[optind]);
+          failed = true;
+          continue;
+        }
+
+      magic = 0;
+      if (size >= sizeof(magic))
+        {
+          memcpy(&magic, buf, sizeof(magic));
+        }
+
+      if (magic != LOGSAVE_CHUNK_MAGIC)
+        {
+          fprintf(stderr, "%s: %lu bytes, not compressed\n", argv[optind],
+                  (unsigned long)size);
+          fwrite(buf, 1, size, out);
+          free(buf);
+          continue;
+        }
+
+      if (verbose)
+        {
+          fprintf(stderr, "%s:\n", argv[optind]);
+        }
+
+      ret = logsave_unpack(buf, size, verbose ? show_chunk : write_chunk,
+                           out, &stat);
+      if (ret < 0)
+        {
+          fprintf(stderr, "ERROR: Failed to unpack %s: %d\n",
+                  argv[optind], ret);
+          failed = true;
+        }
+
+      fprintf(stderr, "%s: %lu -> %lu bytes (%.1f%%), %u entries, "
+              "%u chunks, %u bad, %u lost, %lu bytes skipped\n",
+              argv[optind], (unsigned long)size,
+              (unsigned long)stat.rawsize,
+              stat.rawsize ? 100.0 * size / stat.rawsize : 0.0,
+              stat.entries, stat.chunks, stat.bad, stat.lost,
+              (unsigned long)stat.skipped);
+
+      if (stat.bad > 0 || stat.lost > 0)
+        {
+          failed = true;
+        }
+
+      free(buf);
+    }
+
+  if (out != stdout)
+    {
+      fclose(out);
+    }
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
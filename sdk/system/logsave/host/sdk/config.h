@@ -0,0 +1,59 @@
+/****************************************************************************
+ * system/logsave/host/sdk/config.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_SYSTEM_LOGSAVE_HOST_SDK_CONFIG_H
+#define __APPS_SYSTEM_LOGSAVE_HOST_SDK_CONFIG_H
+
+/* Configuration for building logsave and its reader on the host.  The
+ * uncompressed variant of the benchmark is built with -DLOGSAVE_RAW.
+ */
+
+#include <stdint.h>
+
+#define OK    0
+#define ERROR -1
+#define FAR
+#define CODE
+
+#ifndef LOGSAVE_RAW
+#  define CONFIG_SYSTEM_LOGSAVE_COMPRESS 1
+#endif
+
+#define CONFIG_SYSTEM_LOGSAVE_MOUNTPOINT  "/tmp/logsavebench"
+#define CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE   4096
+#define CONFIG_SYSTEM_LOGSAVE_MAXSIZE     32768
+#define CONFIG_SYSTEM_LOGSAVE_NFILES      3
+
+#endif /* __APPS_SYSTEM_LOGSAVE_HOST_SDK_CONFIG_H */
@@ -45,12 +45,115 @@
 #include <syslog.h>
 #include <errno.h>
 #include <debug.h>
+#include <unistd.h>
 
 #include <sys/stat.h>
 #include <fcntl.h>
 
 #include <arch/chip/backuplog.h>
 
+#ifdef CONFIG_SYSTEM_LOGSAVE_COMPRESS
+#  include "system/logsave.h"
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SYSTEM_LOGSAVE_MAXSIZE
+#  define CONFIG_SYSTEM_LOGSAVE_MAXSIZE 0
+#endif
+
+#ifndef CONFIG_SYSTEM_LOGSAVE_NFILES
+#  define CONFIG_SYSTEM_LOGSAVE_NFILES 1
+#endif
+
+#define LOGSAVE_PATHLEN 64
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void logsave_path(FAR char *path, FAR const char *name, int index)
+{
+  if (index == 0)
+    {
+      snprintf(path, LOGSAVE_PATHLEN,
+               CONFIG_SYSTEM_LOGSAVE_MOUNTPOINT"/%s.log", name);
+    }
+  else
+    {
+      snprintf(path, LOGSAVE_PATHLEN,
+               CONFIG_SYSTEM_LOGSAVE_MOUNTPOINT"/%s.%d.log", name, index);
+    }
+}
+
+/* When <name>.log has grown to CONFIG_SYSTEM_LOGSAVE_MAXSIZE, shift it to
+ * <name>.1.log, <name>.1.log to <name>.2.log and so on, dropping the oldest
+ * one so that at most CONFIG_SYSTEM_LOGSAVE_NFILES files are kept.
+ */
+
+static void logsave_rotate(FAR const char *name)
+{
+  char oldpath[LOGSAVE_PATHLEN];
+  char newpath[LOGSAVE_PATHLEN];
+  struct stat filestat;
+  int i;
+
+  if (CONFIG_SYSTEM_LOGSAVE_MAXSIZE == 0)
+    {
+      return;
+    }
+
+  logsave_path(oldpath, name, 0);
+  if (stat(oldpath, &filestat) < 0 ||
+      filestat.st_size < CONFIG_SYSTEM_LOGSAVE_MAXSIZE)
+    {
+      return;
+    }
+
+  for (i = CONFIG_SYSTEM_LOGSAVE_NFILES - 1; i > 0; i--)
+    {
+      logsave_path(oldpath, name, i - 1);
+      logsave_path(newpath, name, i);
+      (void)unlink(newpath);
+      (void)rename(oldpath, newpath);
+    }
+
+  logsave_path(oldpath, name, 0);
+  (void)unlink(oldpath);
+}
+
+static ssize_t logsave_file(FAR const char *logfile, FAR const void *addr,
+                            size_t size)
+{
+  ssize_t ret;
+  int fd;
+
+  fd = open(logfile, O_WRONLY | O_CREAT | O_APPEND, 0666);
+  if (fd < 0)
+    {
+      return -errno;
+    }
+
+#ifdef CONFIG_SYSTEM_LOGSAVE_COMPRESS
+  ret = logsave_write(fd, addr, size);
+#else
+  ret = write(fd, addr, size);
+  if (ret < 0)
+    {
+      ret = -errno;
+    }
+  else if ((size_t)ret != size)
+    {
+      ret = -ENOSPC;
+    }
+#endif
+
+  close(fd);
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -61,11 +164,11 @@ int main(int argc, FAR char *argv[])
 int logsave_main(int argc, char **argv)
 #endif
 {
-  FILE *fp;
-  char logfile[64];
+  char logfile[LOGSAVE_PATHLEN];
   void *addr = NULL;
   size_t size = 0;
   char name[8 + 1];
+  ssize_t nwritten;
   int ret;
 
   for (; ;)
@@ -81,20 +184,25 @@ int logsave_main(int argc, char **argv)
         }
 
       name[8] = '\0';
-      snprintf(logfile, 64, CONFIG_SYSTEM_LOGSAVE_MOUNTPOINT"/%s.log", name);
+      logsave_rotate(name);
+      logsave_path(logfile, name, 0);
 
       /* Save the logging data */
 
       printf("Save at 0x%08x (%d bytes) into %s\n", (uint32_t)addr, size, logfile);
 
-      fp = fopen(logfile, "ab");
-      if (fp == NULL)
+      nwritten = logsave_file(logfile, addr, size);
+      if (nwritten < 0)
         {
-          printf("open failed %s\n", logfile);
+          /* Keep the entry on the backup sram to retry on the next boot */
+
+          printf("save failed %s: %d\n", logfile, (int)nwritten);
           break;
         }
-      fwrite(addr, size, 1, fp);
-      fclose(fp);
+
+#ifdef CONFIG_SYSTEM_LOGSAVE_COMPRESS
+      printf("Compressed to %d bytes\n", (int)nwritten);
+#endif
 
       /* Remove the entry */
 
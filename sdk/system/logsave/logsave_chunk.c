@@ -0,0 +1,336 @@
+/****************************************************************************
+ * system/logsave/logsave_chunk.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stddef.h>
+#include <errno.h>
+#include <crc32.h>
+
+#include "system/logsave.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CHUNK_HDRSIZE   sizeof(struct logsave_chunk_s)
+#define CHUNK_CRCSIZE   offsetof(struct logsave_chunk_s, crc)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t chunk_crc(FAR const struct logsave_chunk_s *chunk,
+                          FAR const uint8_t *payload)
+{
+  uint32_t crc;
+
+  crc = crc32((FAR const uint8_t *)chunk, CHUNK_CRCSIZE);
+  return crc32part(payload, chunk->size, crc);
+}
+
+static int write_all(int fd, FAR const uint8_t *buf, size_t len)
+{
+  ssize_t n;
+
+  while (len > 0)
+    {
+      n = write(fd, buf, len);
+      if (n < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          return -errno;
+        }
+
+      buf += n;
+      len -= n;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: logsave_write
+ ****************************************************************************/
+
+ssize_t logsave_write(int fd, FAR const void *addr, size_t size)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)addr;
+  FAR struct logsave_chunk_s *chunk;
+  FAR uint8_t *payload;
+  FAR uint16_t *htab;
+  FAR uint8_t *work;
+  ssize_t total = 0;
+  uint16_t seq = 0;
+  size_t offset;
+  size_t clen;
+  size_t n;
+  int ret = OK;
+
+  /* The header and the payload are kept together so that every chunk is
+   * written with a single call, the hash table follows them.
+   */
+
+  work = (FAR uint8_t *)malloc(CHUNK_HDRSIZE +
+                               CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE +
+                               LOGSAVE_HASHSIZE);
+  if (work == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  chunk   = (FAR struct logsave_chunk_s *)work;
+  payload = work + CHUNK_HDRSIZE;
+  htab    = (FAR uint16_t *)(payload + CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE);
+
+  for (offset = 0; offset < size; offset += n, seq++)
+    {
+      n = size - offset;
+      if (n > CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE)
+        {
+          n = CONFIG_SYSTEM_LOGSAVE_CHUNKSIZE;
+        }
+
+      chunk->magic   = LOGSAVE_CHUNK_MAGIC;
+      chunk->rawsize = (uint16_t)n;
+      chunk->seq     = seq;
+      chunk->flags   = 0;
+
+      if (offset == 0)
+        {
+          chunk->flags |= LOGSAVE_CHUNK_FIRST;
+        }
+
+      if (offset + n == size)
+        {
+          chunk->flags |= LOGSAVE_CHUNK_LAST;
+        }
+
+      /* Keep the chunk only if it got smaller, otherwise store it as is */
+
+      clen = logsave_compress(&src[offset], n, payload, n - 1, htab);
+      if (clen == 0)
+        {
+          memcpy(payload, &src[offset], n);
+          clen = n;
+          chunk->flags |= LOGSAVE_CHUNK_STORED;
+        }
+
+      chunk->size = (uint16_t)clen;
+      chunk->crc  = chunk_crc(chunk, payload);
+
+      ret = write_all(fd, work, CHUNK_HDRSIZE + clen);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      total += CHUNK_HDRSIZE + clen;
+    }
+
+  free(work);
+  return ret < 0 ? ret : total;
+}
+
+/****************************************************************************
+ * Name: logsave_unpack
+ ****************************************************************************/
+
+int logsave_unpack(FAR const uint8_t *buf, size_t len,
+                   logsave_output_t output, FAR void *arg,
+                   FAR struct logsave_unpack_s *stat)
+{
+  struct logsave_unpack_s local;
+  struct logsave_chunk_s chunk;
+  FAR const uint8_t *payload;
+  FAR const uint8_t *data;
+  FAR uint8_t *raw = NULL;
+  size_t rawlen = 0;
+  size_t pos = 0;
+  uint16_t expect = 0;
+  bool inentry = false;
+  bool resync = false;
+  ssize_t n;
+  int ret = OK;
+
+  if (stat == NULL)
+    {
+      stat = &local;
+    }
+
+  memset(stat, 0, sizeof(*stat));
+
+  while (pos + CHUNK_HDRSIZE <= len)
+    {
+      memcpy(&chunk, &buf[pos], CHUNK_HDRSIZE);
+      payload = &buf[pos + CHUNK_HDRSIZE];
+
+      /* A bad chunk is counted once, then the following bytes are scanned
+       * for the next header which passes the CRC check.
+       */
+
+      if (chunk.magic != LOGSAVE_CHUNK_MAGIC ||
+          chunk.size > len - pos - CHUNK_HDRSIZE ||
+          chunk_crc(&chunk, payload) != chunk.crc)
+        {
+          if (!resync)
+            {
+              stat->bad++;
+              resync = true;
+            }
+
+          stat->skipped++;
+          pos++;
+          continue;
+        }
+
+      resync = false;
+
+      if (chunk.flags & LOGSAVE_CHUNK_STORED)
+        {
+          if (chunk.size != chunk.rawsize)
+            {
+              stat->bad++;
+              pos += CHUNK_HDRSIZE + chunk.size;
+              continue;
+            }
+
+          data = payload;
+        }
+      else
+        {
+          if (chunk.rawsize > rawlen)
+            {
+              FAR uint8_t *newraw = (FAR uint8_t *)realloc(raw,
+                                                           chunk.rawsize);
+              if (newraw == NULL)
+                {
+                  ret = -ENOMEM;
+                  break;
+                }
+
+              raw    = newraw;
+              rawlen = chunk.rawsize;
+            }
+
+          n = logsave_decompress(payload, chunk.size, raw, chunk.rawsize);
+          if (n != chunk.rawsize)
+            {
+              stat->bad++;
+              pos += CHUNK_HDRSIZE + chunk.size;
+              continue;
+            }
+
+          data = raw;
+        }
+
+      /* Account for chunks which never made it to the file */
+
+      if (chunk.flags & LOGSAVE_CHUNK_FIRST)
+        {
+          if (inentry)
+            {
+              stat->lost++;
+            }
+
+          stat->entries++;
+          expect = 0;
+        }
+      else if (!inentry)
+        {
+          stat->entries++;
+          stat->lost += chunk.seq;
+        }
+      else if (chunk.seq != expect)
+        {
+          stat->lost += (uint16_t)(chunk.seq - expect);
+        }
+
+      expect  = chunk.seq + 1;
+      inentry = !(chunk.flags & LOGSAVE_CHUNK_LAST);
+
+      stat->chunks++;
+      stat->rawsize += chunk.rawsize;
+
+      ret = output(arg, &chunk, data, chunk.rawsize);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      pos += CHUNK_HDRSIZE + chunk.size;
+    }
+
+  /* Trailing bytes too short for a header, or an unfinished entry */
+
+  if (ret >= 0)
+    {
+      if (pos < len)
+        {
+          if (!resync)
+            {
+              stat->bad++;
+            }
+
+          stat->skipped += len - pos;
+        }
+
+      if (inentry)
+        {
+          stat->lost++;
+        }
+
+      ret = OK;
+    }
+
+  free(raw);
+  return ret;
+}
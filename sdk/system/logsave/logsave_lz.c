@@ -0,0 +1,272 @@
+/****************************************************************************
+ * system/logsave/logsave_lz.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <string.h>
+#include <errno.h>
+
+#include "system/logsave.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The compressed data is a sequence of literal runs and back references.
+ * The top 3 bits of the control byte select the kind:
+ *
+ *   000LLLLL <L + 1 literal bytes>
+ *   LLLOOOOO OOOOOOOO                   match of L + 2 bytes
+ *   111OOOOO LLLLLLLL OOOOOOOO          match of L + 9 bytes
+ *
+ * where O is the distance back to the match minus one.
+ */
+
+#define MAX_LIT   (1 << 5)
+#define MAX_OFF   (1 << 13)
+#define MAX_REF   ((1 << 8) + (1 << 3))
+
+#define HASH(p)   ((((uint32_t)(p)[0] << 16 | (p)[1] << 8 | (p)[2]) * \
+                    2654435761u) >> (32 - LOGSAVE_HASHBITS))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: logsave_compress
+ ****************************************************************************/
+
+size_t logsave_compress(FAR const uint8_t *src, size_t srclen,
+                        FAR uint8_t *dst, size_t dstlen,
+                        FAR uint16_t *htab)
+{
+  size_t ip = 0;
+  size_t op = 1;   /* Room for the control byte of the first literal run */
+  size_t lit = 0;
+
+  if (srclen == 0 || srclen > UINT16_MAX + 1)
+    {
+      return 0;
+    }
+
+  /* Stale entries are harmless, every candidate is compared below */
+
+  memset(htab, 0, LOGSAVE_HASHSIZE);
+
+  while (ip + 2 < srclen)
+    {
+      uint32_t h   = HASH(&src[ip]);
+      size_t   ref = htab[h];
+      size_t   off = ip - ref - 1;
+
+      htab[h] = (uint16_t)ip;
+
+      if (ref < ip && off < MAX_OFF &&
+          src[ref] == src[ip] && src[ref + 1] == src[ip + 1] &&
+          src[ref + 2] == src[ip + 2])
+        {
+          size_t maxlen = srclen - ip;
+          size_t len    = 3;
+
+          if (maxlen > MAX_REF)
+            {
+              maxlen = MAX_REF;
+            }
+
+          while (len < maxlen && src[ref + len] == src[ip + len])
+            {
+              len++;
+            }
+
+          /* Close the pending literal run, or give back its control byte */
+
+          if (lit > 0)
+            {
+              dst[op - lit - 1] = (uint8_t)(lit - 1);
+              lit = 0;
+            }
+          else
+            {
+              op--;
+            }
+
+          if (op + 3 > dstlen)
+            {
+              return 0;
+            }
+
+          ip  += len;
+          len -= 2;
+
+          if (len < 7)
+            {
+              dst[op++] = (uint8_t)((len << 5) | (off >> 8));
+            }
+          else
+            {
+              dst[op++] = (uint8_t)((7 << 5) | (off >> 8));
+              dst[op++] = (uint8_t)(len - 7);
+            }
+
+          dst[op++] = (uint8_t)off;
+
+          /* Index the last position of the match so that runs of repeated
+           * records keep finding each other.
+           */
+
+          if (ip + 2 < srclen)
+            {
+              htab[HASH(&src[ip - 1])] = (uint16_t)(ip - 1);
+            }
+
+          op++;
+          continue;
+        }
+
+      if (op >= dstlen)
+        {
+          return 0;
+        }
+
+      dst[op++] = src[ip++];
+      if (++lit == MAX_LIT)
+        {
+          dst[op - lit - 1] = (uint8_t)(lit - 1);
+          lit = 0;
+          op++;
+        }
+    }
+
+  /* Copy the last bytes which are too short to start a match */
+
+  while (ip < srclen)
+    {
+      if (op >= dstlen)
+        {
+          return 0;
+        }
+
+      dst[op++] = src[ip++];
+      if (++lit == MAX_LIT)
+        {
+          dst[op - lit - 1] = (uint8_t)(lit - 1);
+          lit = 0;
+          op++;
+        }
+    }
+
+  if (lit > 0)
+    {
+      dst[op - lit - 1] = (uint8_t)(lit - 1);
+    }
+  else
+    {
+      op--;
+    }
+
+  return op;
+}
+
+/****************************************************************************
+ * Name: logsave_decompress
+ ****************************************************************************/
+
+ssize_t logsave_decompress(FAR const uint8_t *src, size_t srclen,
+                           FAR uint8_t *dst, size_t dstlen)
+{
+  size_t ip = 0;
+  size_t op = 0;
+
+  while (ip < srclen)
+    {
+      uint8_t ctrl = src[ip++];
+      size_t  len;
+
+      if (ctrl < MAX_LIT)
+        {
+          len = ctrl + 1;
+          if (ip + len > srclen || op + len > dstlen)
+            {
+              return -EINVAL;
+            }
+
+          memcpy(&dst[op], &src[ip], len);
+          ip += len;
+          op += len;
+        }
+      else
+        {
+          size_t off;
+
+          len = ctrl >> 5;
+          if (len == 7)
+            {
+              if (ip >= srclen)
+                {
+                  return -EINVAL;
+                }
+
+              len += src[ip++];
+            }
+
+          if (ip >= srclen)
+            {
+              return -EINVAL;
+            }
+
+          off = ((size_t)(ctrl & 0x1f) << 8 | src[ip++]) + 1;
+          len += 2;
+
+          if (off > op || op + len > dstlen)
+            {
+              return -EINVAL;
+            }
+
+          /* The match may overlap the bytes it produces */
+
+          for (; len > 0; len--, op++)
+            {
+              dst[op] = dst[op - off];
+            }
+        }
+    }
+
+  return (ssize_t)op;
+}
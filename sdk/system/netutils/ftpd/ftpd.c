@@ -57,6 +57,9 @@
 #include <fcntl.h>
 #include <poll.h>
 #include <libgen.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -72,6 +75,20 @@
 
 #define __NUTTX__ 1 /* Flags some unusual NuttX dependencies */
 
+/* How often the read-ahead thread of an overlapped STOR checks whether the
+ * transfer was aborted while it waits for data.
+ */
+
+#define FTPD_PIPELINE_POLLMSEC 500
+
+/* Use the monotonic clock for transfer rates if it is available */
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#  define FTPD_CLOCK CLOCK_MONOTONIC
+#else
+#  define FTPD_CLOCK CLOCK_REALTIME
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -134,6 +151,15 @@ static int  ftpd_getpath(FAR struct ftpd_session_s *session,
 static int  ftpd_changedir(FAR struct ftpd_session_s *session,
               FAR const char *rempath);
 static off_t ftpd_offsatoi(FAR const char *filename, off_t offset);
+static void ftpd_xfercomplete(FAR struct ftpd_session_s *session,
+              off_t nbytes, FAR const struct timespec *start);
+#ifdef CONFIG_FTPD_PIPELINE
+static ssize_t ftpd_piperecv(FAR struct ftpd_pipeline_s *xfer,
+              FAR char *buffer);
+static FAR void *ftpd_pipeworker(FAR void *arg);
+static int ftpd_pipeline(FAR struct ftpd_session_s *session, int cmdtype,
+              FAR off_t *nxfer);
+#endif
 static int ftpd_stream(FAR struct ftpd_session_s *session, int cmdtype);
 static uint8_t ftpd_listoption(FAR char **param);
 static int  ftpd_listbuffer(FAR struct ftpd_session_s *session,
@@ -1711,6 +1737,279 @@ static off_t ftpd_offsatoi(FAR const char *filename, off_t offset)
   return ret;
 }
 
+/****************************************************************************
+ * Name: ftpd_xfercomplete
+ *
+ * Description:
+ *   Send the 226 reply of a successful transfer, with the number of bytes
+ *   transferred and the transfer rate.
+ *
+ ****************************************************************************/
+
+static void ftpd_xfercomplete(FAR struct ftpd_session_s *session,
+                              off_t nbytes, FAR const struct timespec *start)
+{
+  struct timespec now;
+  unsigned long msec;
+  unsigned long rate;
+  char msg[80];
+
+  (void)clock_gettime(FTPD_CLOCK, &now);
+  msec = (unsigned long)(now.tv_sec - start->tv_sec) * 1000 +
+         (now.tv_nsec - start->tv_nsec) / 1000000;
+  if (msec == 0)
+    {
+      msec = 1;
+    }
+
+  /* bytes/s, without overflowing the intermediate product */
+
+  if ((unsigned long)nbytes < 0xffffffffUL / 1000)
+    {
+      rate = (unsigned long)nbytes * 1000 / msec;
+    }
+  else
+    {
+      rate = (unsigned long)nbytes / msec * 1000;
+    }
+
+  ninfo("%lu bytes in %lu ms (%lu bytes/s)\n",
+        (unsigned long)nbytes, msec, rate);
+
+  (void)snprintf(msg, sizeof(msg),
+                 "Transfer complete (%lu bytes, %lu bytes/sec)",
+                 (unsigned long)nbytes, rate);
+  (void)ftpd_response(session->cmd.sd, session->txtimeout,
+                      g_respfmt1, 226, ' ', msg);
+}
+
+#ifdef CONFIG_FTPD_PIPELINE
+/****************************************************************************
+ * Name: ftpd_piperecv
+ *
+ * Description:
+ *   Receive the next buffer of an overlapped STOR/APPE.  The wait is split
+ *   in short polls so that the read-ahead thread notices when the session
+ *   thread aborts the transfer.
+ *
+ ****************************************************************************/
+
+static ssize_t ftpd_piperecv(FAR struct ftpd_pipeline_s *xfer,
+                             FAR char *buffer)
+{
+  FAR struct ftpd_session_s *session = xfer->session;
+  int waited = 0;
+  ssize_t ret;
+
+  for (;;)
+    {
+      ret = ftpd_recv(session->data.sd, buffer, xfer->buflen,
+                      FTPD_PIPELINE_POLLMSEC);
+      if (ret != -ETIMEDOUT || xfer->abort)
+        {
+          return ret;
+        }
+
+      waited += FTPD_PIPELINE_POLLMSEC;
+      if (session->rxtimeout >= 0 && waited >= session->rxtimeout)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: ftpd_pipeworker
+ *
+ * Description:
+ *   Read-ahead thread of an overlapped transfer.  Fills the ring buffers in
+ *   order until the end of the source, an error, or an abort.
+ *
+ ****************************************************************************/
+
+static FAR void *ftpd_pipeworker(FAR void *arg)
+{
+  FAR struct ftpd_pipeline_s *xfer = (FAR struct ftpd_pipeline_s *)arg;
+  ssize_t nread;
+  int index = 0;
+
+  do
+    {
+      while (sem_wait(&xfer->empty) < 0)
+        {
+          DEBUGASSERT(errno == EINTR);
+        }
+
+      if (xfer->abort)
+        {
+          break;
+        }
+
+      if (xfer->cmdtype == 0)
+        {
+          nread = read(xfer->session->fd, xfer->buffer[index], xfer->buflen);
+          if (nread < 0)
+            {
+              nread = -errno;
+            }
+        }
+      else
+        {
+          nread = ftpd_piperecv(xfer, xfer->buffer[index]);
+        }
+
+      xfer->nbytes[index] = nread;
+      sem_post(&xfer->full);
+
+      index = (index + 1) % xfer->nbuffers;
+    }
+  while (nread > 0);
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ftpd_pipeline
+ *
+ * Description:
+ *   Binary transfer with overlapped reads and writes.  The session's data
+ *   buffer is the first buffer of the ring; the others are allocated here.
+ *   If only some of them can be allocated, the transfer goes on with fewer
+ *   buffers.  The number of bytes transferred is added to *nxfer.
+ *
+ * Returned Value:
+ *   0 on success, a negated errno value on failure (the reply has been
+ *   sent), or 1 if no extra buffer or no read-ahead thread could be set up.
+ *   In that case nothing has been transferred nor replied, and the caller
+ *   falls back to the sequential loop.
+ *
+ ****************************************************************************/
+
+static int ftpd_pipeline(FAR struct ftpd_session_s *session, int cmdtype,
+                         FAR off_t *nxfer)
+{
+  struct ftpd_pipeline_s xfer;
+  pthread_attr_t attr;
+  pthread_t worker;
+  ssize_t nbytes;
+  ssize_t wrbytes;
+  int index;
+  int ret;
+
+  xfer.session   = session;
+  xfer.cmdtype   = cmdtype;
+  xfer.buflen    = session->data.buflen;
+  xfer.abort     = false;
+  xfer.buffer[0] = session->data.buffer;
+
+  for (xfer.nbuffers = 1; xfer.nbuffers < CONFIG_FTPD_PIPELINE_NBUFFERS;
+       xfer.nbuffers++)
+    {
+      xfer.buffer[xfer.nbuffers] = (FAR char *)malloc(xfer.buflen);
+      if (!xfer.buffer[xfer.nbuffers])
+        {
+          nwarn("WARNING: Only %d data buffers\n", xfer.nbuffers);
+          break;
+        }
+    }
+
+  if (xfer.nbuffers < 2)
+    {
+      return 1;
+    }
+
+  sem_init(&xfer.empty, 0, xfer.nbuffers);
+  sem_init(&xfer.full, 0, 0);
+
+  ret = pthread_attr_init(&attr);
+  if (ret == 0)
+    {
+      (void)pthread_attr_setstacksize(&attr, CONFIG_FTPD_PIPELINE_STACKSIZE);
+      ret = pthread_create(&worker, &attr, ftpd_pipeworker, &xfer);
+      pthread_attr_destroy(&attr);
+    }
+
+  if (ret != 0)
+    {
+      nwarn("WARNING: pthread_create() failed: %d\n", ret);
+      ret = 1;
+      goto errout_with_buffers;
+    }
+
+  for (index = 0; ; index = (index + 1) % xfer.nbuffers)
+    {
+      while (sem_wait(&xfer.full) < 0)
+        {
+          DEBUGASSERT(errno == EINTR);
+        }
+
+      nbytes = xfer.nbytes[index];
+      if (nbytes < 0)
+        {
+          nerr("ERROR: Read failed: %d\n", nbytes);
+          (void)ftpd_response(session->cmd.sd, session->txtimeout,
+                              g_respfmt1, 550, ' ', "Data read error !");
+          ret = (int)nbytes;
+          break;
+        }
+
+      if (nbytes == 0)
+        {
+          /* End-of-file */
+
+          ret = 0;
+          break;
+        }
+
+      if (cmdtype == 0)
+        {
+          wrbytes = ftpd_send(session->data.sd, xfer.buffer[index], nbytes,
+                              session->txtimeout);
+        }
+      else
+        {
+          wrbytes = write(session->fd, xfer.buffer[index], nbytes);
+          if (wrbytes < 0)
+            {
+              wrbytes = -errno;
+            }
+        }
+
+      if (wrbytes != nbytes)
+        {
+          nerr("ERROR: Write failed: wrbytes=%d\n", wrbytes);
+          (void)ftpd_response(session->cmd.sd, session->txtimeout,
+                              g_respfmt1, 550, ' ', "Data send error !");
+          ret = wrbytes < 0 ? (int)wrbytes : -EIO;
+
+          /* Stop the read-ahead thread, waking it up if it waits for a
+           * free buffer.
+           */
+
+          xfer.abort = true;
+          sem_post(&xfer.empty);
+          break;
+        }
+
+      *nxfer += nbytes;
+      sem_post(&xfer.empty);
+    }
+
+  (void)pthread_join(worker, NULL);
+
+errout_with_buffers:
+  sem_destroy(&xfer.full);
+  sem_destroy(&xfer.empty);
+
+  while (xfer.nbuffers > 1)
+    {
+      free(xfer.buffer[--xfer.nbuffers]);
+    }
+
+  return ret;
+}
+#endif /* CONFIG_FTPD_PIPELINE */
+
 /****************************************************************************
  * Name: ftpd_stream
  ****************************************************************************/
@@ -1727,6 +2026,8 @@ static int ftpd_stream(FAR struct ftpd_session_s *session, int cmdtype)
   ssize_t rdbytes;
   ssize_t wrbytes;
   off_t pos = 0;
+  off_t nxfer = 0;
+  struct timespec start;
   int errval = 0;
   int ret;
 
@@ -1871,6 +2172,28 @@ static int ftpd_stream(FAR struct ftpd_session_s *session, int cmdtype)
       goto errout_with_session;
     }
 
+  (void)clock_gettime(FTPD_CLOCK, &start);
+
+#ifdef CONFIG_FTPD_PIPELINE
+  if (session->type != FTPD_SESSIONTYPE_A)
+    {
+      /* Binary transfer: overlap reading and writing */
+
+      ret = ftpd_pipeline(session, cmdtype, &nxfer);
+      if (ret == 0)
+        {
+          ftpd_xfercomplete(session, nxfer, &start);
+        }
+
+      if (ret <= 0)
+        {
+          goto errout_with_session;
+        }
+
+      /* Not enough resources to overlap: use the single-buffer loop */
+    }
+#endif
+
   for (;;)
     {
       /* Read from the source (file or TCP connection) */
@@ -1931,8 +2254,7 @@ static int ftpd_stream(FAR struct ftpd_session_s *session, int cmdtype)
         {
           /* End-of-file */
 
-          (void)ftpd_response(session->cmd.sd, session->txtimeout,
-                              g_respfmt1, 226, ' ', "Transfer complete");
+          ftpd_xfercomplete(session, nxfer, &start);
 
           /* Return success */
 
@@ -2003,7 +2325,8 @@ static int ftpd_stream(FAR struct ftpd_session_s *session, int cmdtype)
 
       /* Get the next file offset */
 
-      pos += (off_t)wrbytes;
+      pos   += (off_t)wrbytes;
+      nxfer += (off_t)wrbytes;
     }
 
 errout_with_session:;
@@ -2022,6 +2345,10 @@ errout_with_path:
     free(abspath);
 
 errout:
+    /* A restart position only applies to the transfer following REST */
+
+    session->restartpos = 0;
+    session->flags &= ~FTPD_SESSIONFLAG_RESTARTPOS;
     return ret;
 }
 
@@ -4385,7 +4712,10 @@ void ftpd_close(FTPD_SESSION handle)
   DEBUGASSERT(handle);
 
   server = (struct ftpd_server_s *)handle;
-  ftpd_account_free(server->head);
+  if (server->head)
+    {
+      ftpd_account_free(server->head);
+    }
 
   if (server->sd >= 0)
     {
@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <semaphore.h>
 
 #include <netinet/in.h>
 
@@ -161,6 +162,28 @@ struct ftpd_session_s
   FAR char                  *renamefrom;
 };
 
+#ifdef CONFIG_FTPD_PIPELINE
+/* State shared by the session thread and the read-ahead thread of an
+ * overlapped transfer.  The read-ahead thread fills the buffers in turn from
+ * the source (the file for RETR, the data connection for STOR/APPE) while
+ * the session thread drains them to the destination.
+ */
+
+struct ftpd_pipeline_s
+{
+  FAR struct ftpd_session_s *session;
+  int                        cmdtype;  /* 0: retr, 1: stor, 2: appe */
+  int                        nbuffers; /* Number of buffers in the ring */
+  size_t                     buflen;   /* Size of each buffer */
+  sem_t                      empty;    /* Counts buffers free to fill */
+  sem_t                      full;     /* Counts buffers ready to drain */
+  volatile bool              abort;    /* Set to stop the read-ahead */
+  FAR char                  *buffer[CONFIG_FTPD_PIPELINE_NBUFFERS];
+  ssize_t                    nbytes[CONFIG_FTPD_PIPELINE_NBUFFERS];
+                                       /* Bytes read, 0: EOF, <0: -errno */
+};
+#endif
+
 typedef int (*ftpd_cmdhandler_t)(struct ftpd_session_s *);
 
 struct ftpd_cmd_s
@@ -0,0 +1,626 @@
+/****************************************************************************
+ * system/netutils/ftpd/host/ftpdbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host throughput benchmark for ftpd.  The server runs in a child process
+ *   on the port chosen by ftpd_open() (21 or 2211), rooted at
+ *   /tmp/ftpdbench.  File reads and writes are slowed down to the given
+ *   storage rate and socket sends and receives to the given network rate,
+ *   so that the time of a sequential transfer is the sum of both while an
+ *   overlapped one approaches the slower of the two.  A client in the
+ *   parent process logs in, runs a binary RETR and STOR through an active
+ *   (PORT) data connection, checks the data, and reports the time, the rate
+ *   and the 226 reply.  PASV is not used because a socket bound to
+ *   INADDR_ANY reports no address on the host.
+ *
+ *   Options:
+ *     -s <KiB>    File size (default 512)
+ *     -f <KiB/s>  Storage rate (default 1024)
+ *     -n <KiB/s>  Network rate (default 1024)
+ *     -F          Make the read-ahead thread creation fail, so that the
+ *                 overlapped transfers fall back to the single-buffer loop
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <errno.h>
+
+#include "netutils/ftpd.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FTP_PORT     21           /* See ftpd_open() */
+#define FTP_ALTPORT  2211
+#define ROOTDIR      "/tmp/ftpdbench"
+#define DEF_SIZE     512
+#define DEF_FILERATE 1024
+#define DEF_NETRATE  1024
+#define CHUNK        8192
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct ctrl_s
+{
+  int sd;
+  size_t len;
+  char buf[512];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+ssize_t __real_read(int fd, void *buf, size_t count);
+ssize_t __real_write(int fd, const void *buf, size_t count);
+ssize_t __real_send(int sd, const void *buf, size_t len, int flags);
+ssize_t __real_recv(int sd, void *buf, size_t len, int flags);
+int __real_pthread_create(pthread_t *thread, const pthread_attr_t *attr,
+                          void *(*start)(void *), void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static bool g_server;           /* Slow down I/O in the server process only */
+static bool g_failthread;       /* Fail the read-ahead thread creation */
+static unsigned long g_filerate = DEF_FILERATE * 1024;
+static unsigned long g_netrate = DEF_NETRATE * 1024;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static double now_sec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Spend the time the given number of bytes takes at the given rate. */
+
+static void io_delay(ssize_t nbytes, unsigned long rate)
+{
+  struct timespec ts;
+  unsigned long long ns;
+
+  if (!g_server || nbytes <= 0)
+    {
+      return;
+    }
+
+  ns = (unsigned long long)nbytes * 1000000000ULL / rate;
+  ts.tv_sec = ns / 1000000000ULL;
+  ts.tv_nsec = ns % 1000000000ULL;
+  clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+}
+
+static bool is_file(int fd)
+{
+  struct stat st;
+
+  return fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+/* Wrappers of the I/O of ftpd.c (linked with -Wl,--wrap) */
+
+ssize_t __wrap_read(int fd, void *buf, size_t count)
+{
+  ssize_t ret = __real_read(fd, buf, count);
+
+  if (is_file(fd))
+    {
+      io_delay(ret, g_filerate);
+    }
+
+  return ret;
+}
+
+ssize_t __wrap_write(int fd, const void *buf, size_t count)
+{
+  if (is_file(fd))
+    {
+      io_delay(count, g_filerate);
+    }
+
+  return __real_write(fd, buf, count);
+}
+
+ssize_t __wrap_send(int sd, const void *buf, size_t len, int flags)
+{
+  io_delay(len, g_netrate);
+  return __real_send(sd, buf, len, flags);
+}
+
+ssize_t __wrap_recv(int sd, void *buf, size_t len, int flags)
+{
+  ssize_t ret = __real_recv(sd, buf, len, flags);
+
+  io_delay(ret, g_netrate);
+  return ret;
+}
+
+int __wrap_pthread_create(pthread_t *thread, const pthread_attr_t *attr,
+                          void *(*start)(void *), void *arg)
+{
+#ifdef CONFIG_FTPD_PIPELINE
+  size_t stacksize;
+
+  /* The read-ahead thread is the only one with this stack size */
+
+  if (g_failthread && attr != NULL &&
+      pthread_attr_getstacksize(attr, &stacksize) == 0 &&
+      stacksize == CONFIG_FTPD_PIPELINE_STACKSIZE)
+    {
+      return EAGAIN;
+    }
+#endif
+
+  return __real_pthread_create(thread, attr, start, arg);
+}
+
+static void run_server(void)
+{
+  FTPD_SESSION handle;
+
+  g_server = true;
+  handle = ftpd_open();
+  if (handle == NULL ||
+      ftpd_adduser(handle, FTPD_ACCOUNTFLAG_ADMIN, "bench", "bench",
+                   ROOTDIR) < 0)
+    {
+      fprintf(stderr, "ftpd setup failed\n");
+      _exit(1);
+    }
+
+  for (; ; )
+    {
+      (void)ftpd_session(handle, -1);
+    }
+}
+
+static int connect_port(uint32_t addr, int port)
+{
+  struct sockaddr_in sa;
+  int sd;
+
+  sd = socket(AF_INET, SOCK_STREAM, 0);
+  if (sd < 0)
+    {
+      return -1;
+    }
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(port);
+  sa.sin_addr.s_addr = htonl(addr);
+  if (connect(sd, (struct sockaddr *)&sa, sizeof(sa)) < 0)
+    {
+      close(sd);
+      return -1;
+    }
+
+  return sd;
+}
+
+/* Read the next reply, skipping the lines of multi-line replies. Returns
+ * the reply code, or -1.
+ */
+
+static int get_reply(struct ctrl_s *c, char *line, size_t size)
+{
+  char *eol;
+  ssize_t n;
+  size_t len;
+
+  for (; ; )
+    {
+      while ((eol = memchr(c->buf, '\n', c->len)) == NULL)
+        {
+          if (c->len == sizeof(c->buf))
+            {
+              return -1;
+            }
+
+          n = recv(c->sd, c->buf + c->len, sizeof(c->buf) - c->len, 0);
+          if (n <= 0)
+            {
+              return -1;
+            }
+
+          c->len += n;
+        }
+
+      len = eol + 1 - c->buf;
+      snprintf(line, size, "%.*s", (int)len, c->buf);
+      memmove(c->buf, eol + 1, c->len - len);
+      c->len -= len;
+
+      if (len >= 4 && line[3] == ' ' && line[0] >= '1' && line[0] <= '5')
+        {
+          line[strcspn(line, "\r\n")] = '\0';
+          return atoi(line);
+        }
+    }
+}
+
+static int command(struct ctrl_s *c, char *line, size_t size,
+                   const char *cmd)
+{
+  char req[128];
+  int len;
+
+  len = snprintf(req, sizeof(req), "%s\r\n", cmd);
+  if (send(c->sd, req, len, 0) != len)
+    {
+      return -1;
+    }
+
+  return get_reply(c, line, size);
+}
+
+/* Listen for the data connection and announce it with PORT. Returns the
+ * listening socket, or -1.
+ */
+
+static int open_active(struct ctrl_s *c)
+{
+  struct sockaddr_in sa;
+  socklen_t len = sizeof(sa);
+  char line[256];
+  char cmd[64];
+  int port;
+  int sd;
+
+  sd = socket(AF_INET, SOCK_STREAM, 0);
+  if (sd < 0)
+    {
+      return -1;
+    }
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(sd, (struct sockaddr *)&sa, sizeof(sa)) < 0 ||
+      listen(sd, 1) < 0 ||
+      getsockname(sd, (struct sockaddr *)&sa, &len) < 0)
+    {
+      close(sd);
+      return -1;
+    }
+
+  port = ntohs(sa.sin_port);
+  snprintf(cmd, sizeof(cmd), "PORT 127,0,0,1,%d,%d", port >> 8, port & 255);
+  if (command(c, line, sizeof(line), cmd) != 200)
+    {
+      close(sd);
+      return -1;
+    }
+
+  return sd;
+}
+
+/* Start a transfer command on an announced data connection. Returns the
+ * data socket, or -1 if the transfer did not start.
+ */
+
+static int start_transfer(struct ctrl_s *c, const char *cmd)
+{
+  char line[256];
+  int lsd;
+  int sd = -1;
+
+  lsd = open_active(c);
+  if (lsd < 0)
+    {
+      return -1;
+    }
+
+  if (command(c, line, sizeof(line), cmd) == 150)
+    {
+      sd = accept(lsd, NULL, NULL);
+    }
+
+  close(lsd);
+  return sd;
+}
+
+static void report(const char *cmd, size_t size, double secs, int code,
+                   const char *line, bool ok)
+{
+  printf("%-5s %8zu bytes %7.3f s %8.0f KiB/s  %s  %s\n", cmd, size, secs,
+         size / secs / 1024, ok ? "OK  " : "FAIL", code == 226 ? line : "");
+}
+
+static bool do_retr(struct ctrl_s *c, const char *data, size_t size)
+{
+  char line[256];
+  char *buf = malloc(CHUNK);
+  size_t got = 0;
+  bool ok = true;
+  double start;
+  ssize_t n;
+  int code;
+  int sd;
+
+  start = now_sec();
+  sd = start_transfer(c, "RETR big.bin");
+  if (sd < 0)
+    {
+      printf("RETR  did not start\n");
+      free(buf);
+      return false;
+    }
+
+  while ((n = recv(sd, buf, CHUNK, 0)) > 0)
+    {
+      if (got + n > size || memcmp(buf, data + got, n))
+        {
+          ok = false;
+        }
+
+      got += n;
+    }
+
+  close(sd);
+
+  code = get_reply(c, line, sizeof(line));
+  ok = ok && code == 226 && got == size;
+  report("RETR", got, now_sec() - start, code, line, ok);
+  free(buf);
+  return ok;
+}
+
+static bool do_stor(struct ctrl_s *c, const char *data, size_t size)
+{
+  char line[256];
+  size_t sent = 0;
+  bool ok = true;
+  double start;
+  ssize_t n;
+  int code;
+  int sd;
+  int fd;
+
+  start = now_sec();
+  sd = start_transfer(c, "STOR up.bin");
+  if (sd < 0)
+    {
+      printf("STOR  did not start\n");
+      return false;
+    }
+
+  while (sent < size)
+    {
+      n = send(sd, data + sent, size - sent > CHUNK ? CHUNK : size - sent, 0);
+      if (n <= 0)
+        {
+          ok = false;
+          break;
+        }
+
+      sent += n;
+    }
+
+  close(sd);
+
+  code = get_reply(c, line, sizeof(line));
+  ok = ok && code == 226;
+  report("STOR", sent, now_sec() - start, code, line, ok);
+
+  /* Check what the server stored */
+
+  if (ok)
+    {
+      char *buf = malloc(size + 1);
+
+      fd = open(ROOTDIR "/up.bin", O_RDONLY);
+      ok = fd >= 0 && read(fd, buf, size + 1) == size &&
+           !memcmp(buf, data, size);
+      if (fd >= 0)
+        {
+          close(fd);
+        }
+
+      free(buf);
+      if (!ok)
+        {
+          printf("STOR  stored file differs\n");
+        }
+    }
+
+  return ok;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  struct ctrl_s ctrl;
+  char line[256];
+  size_t size = DEF_SIZE * 1024;
+  uint32_t seed = 1;
+  char *data;
+  bool ok = true;
+  pid_t pid;
+  size_t i;
+  int opt;
+  int fd;
+
+  while ((opt = getopt(argc, argv, "s:f:n:F")) != -1)
+    {
+      switch (opt)
+        {
+          case 's':
+            size = strtoul(optarg, NULL, 0) * 1024;
+            break;
+
+          case 'f':
+            g_filerate = strtoul(optarg, NULL, 0) * 1024;
+            break;
+
+          case 'n':
+            g_netrate = strtoul(optarg, NULL, 0) * 1024;
+            break;
+
+          case 'F':
+            g_failthread = true;
+            break;
+
+          default:
+            fprintf(stderr, "usage: %s [-s KiB] [-f KiB/s] [-n KiB/s] "
+                    "[-F]\n", argv[0]);
+            return 2;
+        }
+    }
+
+  if (size == 0 || g_filerate == 0 || g_netrate == 0)
+    {
+      fprintf(stderr, "sizes and rates must be positive\n");
+      return 2;
+    }
+
+  signal(SIGPIPE, SIG_IGN);
+
+  data = malloc(size);
+  for (i = 0; i < size; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      data[i] = (char)(seed >> 16);
+    }
+
+  mkdir(ROOTDIR, 0755);
+  fd = open(ROOTDIR "/big.bin", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0 || write(fd, data, size) != size)
+    {
+      perror(ROOTDIR "/big.bin");
+      return 1;
+    }
+
+  close(fd);
+
+  pid = fork();
+  if (pid == 0)
+    {
+      run_server();
+    }
+
+  memset(&ctrl, 0, sizeof(ctrl));
+  line[0] = '\0';
+  for (i = 0; i < 100; i++)
+    {
+      ctrl.sd = connect_port(INADDR_LOOPBACK, FTP_PORT);
+      if (ctrl.sd < 0)
+        {
+          ctrl.sd = connect_port(INADDR_LOOPBACK, FTP_ALTPORT);
+        }
+
+      if (ctrl.sd >= 0)
+        {
+          break;
+        }
+
+      usleep(10000);
+    }
+
+#ifdef CONFIG_FTPD_PIPELINE
+  printf("ftpd: overlapped%s, %lu KiB/s storage, %lu KiB/s network\n",
+         g_failthread ? " (thread creation fails)" : "",
+         g_filerate / 1024, g_netrate / 1024);
+#else
+  printf("ftpd: sequential, %lu KiB/s storage, %lu KiB/s network\n",
+         g_filerate / 1024, g_netrate / 1024);
+#endif
+
+  if (ctrl.sd < 0 || get_reply(&ctrl, line, sizeof(line)) != 220 ||
+      command(&ctrl, line, sizeof(line), "USER bench") != 331 ||
+      command(&ctrl, line, sizeof(line), "PASS bench") != 230 ||
+      command(&ctrl, line, sizeof(line), "TYPE I") != 200)
+    {
+      printf("login failed: %s\n", line);
+      ok = false;
+    }
+  else
+    {
+      ok = do_retr(&ctrl, data, size);
+      ok = do_stor(&ctrl, data, size) && ok;
+      (void)command(&ctrl, line, sizeof(line), "QUIT");
+    }
+
+  if (ctrl.sd >= 0)
+    {
+      close(ctrl.sd);
+    }
+
+  kill(pid, SIGKILL);
+  waitpid(pid, NULL, 0);
+
+  unlink(ROOTDIR "/big.bin");
+  unlink(ROOTDIR "/up.bin");
+  rmdir(ROOTDIR);
+  free(data);
+
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return !ok;
+}
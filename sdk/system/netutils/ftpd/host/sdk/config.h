@@ -0,0 +1,72 @@
+/****************************************************************************
+ * system/netutils/ftpd/host/sdk/config.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_SYSTEM_NETUTILS_FTPD_HOST_SDK_CONFIG_H
+#define __APPS_SYSTEM_NETUTILS_FTPD_HOST_SDK_CONFIG_H
+
+/* Configuration for building ftpd on the host.  The overlapped transfers
+ * are enabled by the Makefile with -DCONFIG_FTPD_PIPELINE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define FAR
+#define CODE
+#define OK 0
+
+#define CONFIG_HAVE_LONG_LONG              1
+#define CONFIG_CLOCK_MONOTONIC             1
+#define CONFIG_NET_HAVE_REUSEADDR          1
+
+#define CONFIG_FTPD_DATABUFFERSIZE         4096
+#define CONFIG_FTPD_WORKERSTACKSIZE        65536
+
+#ifdef CONFIG_FTPD_PIPELINE
+#  define CONFIG_FTPD_PIPELINE_NBUFFERS    4
+#  define CONFIG_FTPD_PIPELINE_STACKSIZE   32768
+#endif
+
+typedef void *(*pthread_startroutine_t)(void *);
+
+static inline void *zalloc(size_t n)
+{
+  return calloc(1, n);
+}
+
+#endif /* __APPS_SYSTEM_NETUTILS_FTPD_HOST_SDK_CONFIG_H */
@@ -50,6 +50,58 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Bits of cJSON.flags */
+
+#define cJSON_IsArena     1    /* Item belongs to the memory block of a
+                                * document from parse_arena() */
+#define cJSON_OwnsString  2    /* Arena item whose name was set by cJSON_malloc */
+#define cJSON_IsArenaRoot 4    /* Root item placed right after the arena */
+#define cJSON_NoIndex     8    /* Object found too small to be indexed */
+
+#define ARENA_HDRSIZE ((sizeof(struct cjson_arena_s) + 7) & ~7)
+
+#ifndef CONFIG_NETUTILS_JSON_INDEX_MINITEMS
+#  define CONFIG_NETUTILS_JSON_INDEX_MINITEMS 16
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Memory block holding a whole document parsed by cJSON_ParseArena() or
+ * cJSON_ParseInSitu(). Items are taken from the bottom and strings from the
+ * top, so that items stay aligned without padding. The root item follows
+ * the header.
+ */
+
+struct cjson_arena_s
+{
+  size_t lo;                    /* Offset of the free area */
+  size_t hi;                    /* End offset of the free area */
+};
+
+/* Parser state */
+
+struct cjson_parser_s
+{
+  struct cjson_arena_s *arena;  /* NULL: allocate with cJSON_malloc */
+  bool insitu;                  /* Decode strings into the text itself */
+  cJSON_StreamHandler handler;  /* Non-NULL: don't build a tree */
+  void *arg;                    /* Argument of the handler */
+  int depth;                    /* Current nesting level */
+  bool stop;                    /* The handler requested to stop */
+};
+
+#ifdef CONFIG_NETUTILS_JSON_HASH_INDEX
+/* Open-addressing hash table from member names to items */
+
+struct cJSON_Index
+{
+  unsigned int mask;            /* Number of slots - 1 */
+  cJSON *slot[1];               /* Actually mask + 1 slots */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -66,11 +118,14 @@ static void (*cJSON_free)(void *ptr)    = free;
  * Private Prototypes
  ****************************************************************************/
 
-static const char *parse_value(cJSON *item, const char *value);
+static const char *parse_value(struct cjson_parser_s *p, cJSON *item,
+                               const char *value);
 static char *print_value(cJSON *item, int depth, int fmt);
-static const char *parse_array(cJSON *item, const char *value);
+static const char *parse_array(struct cjson_parser_s *p, cJSON *item,
+                               const char *value);
 static char *print_array(cJSON *item, int depth, int fmt);
-static const char *parse_object(cJSON *item, const char *value);
+static const char *parse_object(struct cjson_parser_s *p, cJSON *item,
+                                const char *value);
 static char *print_object(cJSON *item, int depth, int fmt);
 
 /****************************************************************************
@@ -105,6 +160,81 @@ static cJSON *cJSON_New_Item(void)
   return node;
 }
 
+/* Allocate an item or a string for the document being parsed. */
+
+static cJSON *parser_new_item(struct cjson_parser_s *p)
+{
+  struct cjson_arena_s *arena = p->arena;
+  cJSON *node;
+
+  if (!arena)
+    {
+      return cJSON_New_Item();
+    }
+
+  if (arena->hi - arena->lo < sizeof(cJSON))
+    {
+      return 0;
+    }
+
+  node = (cJSON *)((char *)arena + arena->lo);
+  arena->lo += sizeof(cJSON);
+  memset(node, 0, sizeof(cJSON));
+  node->flags = cJSON_IsArena;
+  return node;
+}
+
+static char *parser_new_string(struct cjson_parser_s *p, size_t len)
+{
+  struct cjson_arena_s *arena = p->arena;
+
+  if (!arena)
+    {
+      return (char *)cJSON_malloc(len);
+    }
+
+  if (arena->hi - arena->lo < len)
+    {
+      return 0;
+    }
+
+  arena->hi -= len;
+  return (char *)arena + arena->hi;
+}
+
+/* Convert 4 hex digits, returning 0 (an invalid code point) on error. */
+
+static unsigned parse_hex4(const char *str)
+{
+  unsigned h = 0;
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      char c = str[i];
+
+      h <<= 4;
+      if (c >= '0' && c <= '9')
+        {
+          h += c - '0';
+        }
+      else if (c >= 'a' && c <= 'f')
+        {
+          h += c - 'a' + 10;
+        }
+      else if (c >= 'A' && c <= 'F')
+        {
+          h += c - 'A' + 10;
+        }
+      else
+        {
+          return 0;
+        }
+    }
+
+  return h;
+}
+
 static int cJSON_strcasecmp(const char *s1, const char *s2)
 {
   if (!s1)
@@ -252,7 +382,8 @@ static char *print_number(cJSON *item)
 
 /* Parse the input text into an unescaped cstring, and populate item. */
 
-static const char *parse_string(cJSON *item, const char *str)
+static const char *parse_string(struct cjson_parser_s *p, cJSON *item,
+                                const char *str)
 {
   const char *ptr = str + 1;
   char *ptr2;
@@ -269,22 +400,31 @@ static const char *parse_string(cJSON *item, const char *str)
       return 0;
     }
 
-  while (*ptr != '\"' && *ptr && ++len)
+  if (p->insitu)
     {
-      /* Skip escaped quotes. */
+      /* The decoded string is never longer than the quoted one. */
 
-      if (*ptr++ == '\\')
+      out = (char *)ptr;
+    }
+  else
+    {
+      while (*ptr != '\"' && *ptr && ++len)
         {
-          ptr++;
+          /* Skip escaped quotes. */
+
+          if (*ptr++ == '\\')
+            {
+              ptr++;
+            }
         }
-    }
 
-  /* This is how long we need for the string, roughly. */
+      /* This is how long we need for the string, roughly. */
 
-  out = (char *)cJSON_malloc(len + 1);
-  if (!out)
-    {
-      return 0;
+      out = parser_new_string(p, len + 1);
+      if (!out)
+        {
+          return 0;
+        }
     }
 
   ptr = str + 1;
@@ -324,7 +464,7 @@ static const char *parse_string(cJSON *item, const char *str)
               /* Transcode utf16 to utf8. */
               /* Get the unicode char. */
 
-              sscanf(ptr + 1, "%4x", &uc);
+              uc = parse_hex4(ptr + 1);
               ptr += 4;
 
               /* Check for invalid. */
@@ -343,7 +483,7 @@ static const char *parse_string(cJSON *item, const char *str)
                       break;
                     }
 
-                  sscanf(ptr + 3, "%4x", &uc2);
+                  uc2 = parse_hex4(ptr + 3);
                   ptr += 6;
                   if (uc2 < 0xdc00 || uc2 > 0xdfff)
                     {
@@ -398,12 +538,14 @@ static const char *parse_string(cJSON *item, const char *str)
         }
     }
 
-  *ptr2 = 0;
+  /* Step over the quote first, in-place decoding may overwrite it. */
+
   if (*ptr == '\"')
     {
       ptr++;
     }
 
+  *ptr2 = 0;
   item->valuestring = out;
   item->type = cJSON_String;
   return ptr;
@@ -523,7 +665,8 @@ static const char *skip(const char *in)
 
 /* Parser core - when encountering text, process appropriately. */
 
-static const char *parse_value(cJSON *item, const char *value)
+static const char *parse_value(struct cjson_parser_s *p, cJSON *item,
+                               const char *value)
 {
   if (!value)
     {
@@ -553,7 +696,7 @@ static const char *parse_value(cJSON *item, const char *value)
 
   if (*value == '\"')
     {
-      return parse_string(item, value);
+      return parse_string(p, item, value);
     }
 
   if (*value == '-' || (*value >= '0' && *value <= '9'))
@@ -563,12 +706,12 @@ static const char *parse_value(cJSON *item, const char *value)
 
   if (*value == '[')
     {
-      return parse_array(item, value);
+      return parse_array(p, item, value);
     }
 
   if (*value == '{')
     {
-      return parse_object(item, value);
+      return parse_object(p, item, value);
     }
 
   /* Failure. */
@@ -621,9 +764,59 @@ static char *print_value(cJSON *item, int depth, int fmt)
   return out;
 }
 
+/* Report an event to the handler of cJSON_ParseStream(). */
+
+static void stream_emit(struct cjson_parser_s *p, int event, const char *key,
+                        const cJSON *item)
+{
+  if (p->handler(p->arg, event, key, item, p->depth))
+    {
+      p->stop = true;
+    }
+}
+
+/* Parse a value in stream mode, reporting it instead of linking it. */
+
+static const char *stream_value(struct cjson_parser_s *p, const char *key,
+                                const char *value)
+{
+  cJSON item;
+
+  memset(&item, 0, sizeof(cJSON));
+  item.string = (char *)key;
+  value = parse_value(p, &item, value);
+  if (value && !p->stop && item.type != cJSON_Array &&
+      item.type != cJSON_Object)
+    {
+      stream_emit(p, cJSON_StreamValue, key, &item);
+    }
+
+  return value;
+}
+
+/* Begin/end events of an array or object in stream mode. */
+
+static const char *stream_nest(struct cjson_parser_s *p, cJSON *item,
+                               const char *value, bool begin)
+{
+  if (begin)
+    {
+      stream_emit(p, cJSON_StreamBegin, item->string, item);
+      p->depth++;
+    }
+  else
+    {
+      p->depth--;
+      stream_emit(p, cJSON_StreamEnd, item->string, item);
+    }
+
+  return value;
+}
+
 /* Build an array from input text. */
 
-static const char *parse_array(cJSON *item, const char *value)
+static const char *parse_array(struct cjson_parser_s *p, cJSON *item,
+                               const char *value)
 {
   cJSON *child;
 
@@ -636,15 +829,42 @@ static const char *parse_array(cJSON *item, const char *value)
     }
 
   item->type = cJSON_Array;
+  if (p->handler)
+    {
+      stream_nest(p, item, value, true);
+    }
+
   value = skip(value + 1);
   if (*value == ']')
     {
       /* Empty array. */
 
-      return value + 1;
+      return p->handler ? stream_nest(p, item, value + 1, false) : value + 1;
     }
 
-  item->child = child = cJSON_New_Item();
+  if (p->handler)
+    {
+      value = skip(stream_value(p, NULL, skip(value)));
+      while (value && !p->stop && *value == ',')
+        {
+          value = skip(stream_value(p, NULL, skip(value + 1)));
+        }
+
+      if (!value || p->stop)
+        {
+          return value;
+        }
+
+      if (*value == ']')
+        {
+          return stream_nest(p, item, value + 1, false);
+        }
+
+      ep = value;
+      return 0;
+    }
+
+  item->child = child = parser_new_item(p);
   if (!item->child)
     {
       /* Memory fail */
@@ -654,7 +874,7 @@ static const char *parse_array(cJSON *item, const char *value)
 
   /* Skip any spacing, get the value. */
 
-  value = skip(parse_value(child, skip(value)));
+  value = skip(parse_value(p, child, skip(value)));
   if (!value)
     {
       return 0;
@@ -663,7 +883,7 @@ static const char *parse_array(cJSON *item, const char *value)
   while (*value == ',')
     {
       cJSON *new_item;
-      if (!(new_item = cJSON_New_Item()))
+      if (!(new_item = parser_new_item(p)))
         {
           /* <emory fail */
 
@@ -673,7 +893,7 @@ static const char *parse_array(cJSON *item, const char *value)
       child->next = new_item;
       new_item->prev = child;
       child = new_item;
-      value = skip(parse_value(child, skip(value + 1)));
+      value = skip(parse_value(p, child, skip(value + 1)));
       if (!value)
         {
           /* Memory fail */
@@ -817,9 +1037,32 @@ static char *print_array(cJSON *item, int depth, int fmt)
   return out;
 }
 
+/* Parse one "name": value member of an object in stream mode. */
+
+static const char *stream_member(struct cjson_parser_s *p, const char *value)
+{
+  cJSON name;
+
+  memset(&name, 0, sizeof(cJSON));
+  value = skip(parse_string(p, &name, skip(value)));
+  if (!value)
+    {
+      return 0;
+    }
+
+  if (*value != ':')
+    {
+      ep = value;
+      return 0;
+    }
+
+  return skip(stream_value(p, name.valuestring, skip(value + 1)));
+}
+
 /* Build an object from the text. */
 
-static const char *parse_object(cJSON *item, const char *value)
+static const char *parse_object(struct cjson_parser_s *p, cJSON *item,
+                                const char *value)
 {
   cJSON *child;
   if (*value != '{')
@@ -831,21 +1074,48 @@ static const char *parse_object(cJSON *item, const char *value)
     }
 
   item->type = cJSON_Object;
+  if (p->handler)
+    {
+      stream_nest(p, item, value, true);
+    }
+
   value = skip(value + 1);
   if (*value == '}')
     {
       /* Empty array. */
 
-      return value + 1;
+      return p->handler ? stream_nest(p, item, value + 1, false) : value + 1;
+    }
+
+  if (p->handler)
+    {
+      value = stream_member(p, value);
+      while (value && !p->stop && *value == ',')
+        {
+          value = stream_member(p, value + 1);
+        }
+
+      if (!value || p->stop)
+        {
+          return value;
+        }
+
+      if (*value == '}')
+        {
+          return stream_nest(p, item, value + 1, false);
+        }
+
+      ep = value;
+      return 0;
     }
 
-  item->child = child = cJSON_New_Item();
+  item->child = child = parser_new_item(p);
   if (!item->child)
     {
       return 0;
     }
 
-  value = skip(parse_string(child, skip(value)));
+  value = skip(parse_string(p, child, skip(value)));
   if (!value)
     {
       return 0;
@@ -861,7 +1131,7 @@ static const char *parse_object(cJSON *item, const char *value)
 
   /* Skip any spacing, get the value. */
 
-  value = skip(parse_value(child, skip(value + 1)));
+  value = skip(parse_value(p, child, skip(value + 1)));
   if (!value)
     {
       return 0;
@@ -870,7 +1140,7 @@ static const char *parse_object(cJSON *item, const char *value)
   while (*value == ',')
     {
       cJSON *new_item;
-      if (!(new_item = cJSON_New_Item()))
+      if (!(new_item = parser_new_item(p)))
         {
           /* Memory fail */
 
@@ -880,7 +1150,7 @@ static const char *parse_object(cJSON *item, const char *value)
       child->next = new_item;
       new_item->prev = child;
       child = new_item;
-      value = skip(parse_string(child, skip(value + 1)));
+      value = skip(parse_string(p, child, skip(value + 1)));
       if (!value)
         {
           return 0;
@@ -896,7 +1166,7 @@ static const char *parse_object(cJSON *item, const char *value)
 
      /* Skip any spacing, get the value. */
 
-      value = skip(parse_value(child, skip(value + 1)));
+      value = skip(parse_value(p, child, skip(value + 1)));
       if (!value)
         {
           return 0;
@@ -1077,6 +1347,195 @@ static char *print_object(cJSON *item, int depth, int fmt)
   return out;
 }
 
+/* Set the name of an object member. */
+
+static void set_item_name(cJSON *item, const char *string)
+{
+  if (item->string &&
+      (!(item->flags & cJSON_IsArena) || (item->flags & cJSON_OwnsString)))
+    {
+      cJSON_free(item->string);
+    }
+
+  item->string = cJSON_strdup(string);
+  if (item->flags & cJSON_IsArena)
+    {
+      item->flags |= cJSON_OwnsString;
+    }
+}
+
+#ifdef CONFIG_NETUTILS_JSON_HASH_INDEX
+/* Case insensitive FNV-1a hash of a member name. */
+
+static unsigned int hash_name(const char *str)
+{
+  unsigned int h = 2166136261u;
+
+  while (*str)
+    {
+      h ^= (unsigned char)tolower(*(const unsigned char *)str++);
+      h *= 16777619u;
+    }
+
+  return h;
+}
+
+static void drop_index(cJSON *object)
+{
+  if (object)
+    {
+      if (object->index)
+        {
+          cJSON_free(object->index);
+          object->index = 0;
+        }
+
+      object->flags &= ~cJSON_NoIndex;
+    }
+}
+
+/* Build the index of an object having enough members. The first member of
+ * duplicated names wins, the same as the linear search. An object that
+ * can't be indexed is marked so that later lookups don't count its members
+ * again until it is modified.
+ */
+
+static struct cJSON_Index *build_index(cJSON *object)
+{
+  struct cJSON_Index *index;
+  unsigned int slots = 1;
+  unsigned int num = 0;
+  unsigned int i;
+  cJSON *c;
+
+  if (object->flags & cJSON_NoIndex)
+    {
+      return 0;
+    }
+
+  for (c = object->child; c; c = c->next)
+    {
+      if (!c->string)
+        {
+          object->flags |= cJSON_NoIndex;
+          return 0;
+        }
+
+      num++;
+    }
+
+  if (num < CONFIG_NETUTILS_JSON_INDEX_MINITEMS)
+    {
+      object->flags |= cJSON_NoIndex;
+      return 0;
+    }
+
+  while (slots < num * 2)
+    {
+      slots <<= 1;
+    }
+
+  index = (struct cJSON_Index *)
+    cJSON_malloc(sizeof(struct cJSON_Index) + (slots - 1) * sizeof(cJSON *));
+  if (!index)
+    {
+      return 0;
+    }
+
+  memset(index->slot, 0, slots * sizeof(cJSON *));
+  index->mask = slots - 1;
+  for (c = object->child; c; c = c->next)
+    {
+      for (i = hash_name(c->string) & index->mask; index->slot[i];
+           i = (i + 1) & index->mask)
+        {
+          if (!cJSON_strcasecmp(index->slot[i]->string, c->string))
+            {
+              break;
+            }
+        }
+
+      if (!index->slot[i])
+        {
+          index->slot[i] = c;
+        }
+    }
+
+  object->index = index;
+  return index;
+}
+
+static cJSON *lookup_index(struct cJSON_Index *index, const char *string)
+{
+  unsigned int i;
+
+  for (i = hash_name(string) & index->mask; index->slot[i];
+       i = (i + 1) & index->mask)
+    {
+      if (!cJSON_strcasecmp(index->slot[i]->string, string))
+        {
+          return index->slot[i];
+        }
+    }
+
+  return 0;
+}
+#else
+#  define drop_index(object)
+#endif
+
+/* Parse a whole document into a single memory block. */
+
+static cJSON *parse_arena(const char *value, bool insitu)
+{
+  struct cjson_parser_s p;
+  const char *ptr;
+  size_t nodes = 1;
+  size_t size;
+  cJSON *root;
+
+  /* Every item except the root follows a '[', '{' or ',' and every string
+   * is shorter than its quoted form, so this block never runs short.
+   */
+
+  for (ptr = value; *ptr; ptr++)
+    {
+      if (*ptr == ',' || *ptr == '[' || *ptr == '{')
+        {
+          nodes++;
+        }
+    }
+
+  size = ARENA_HDRSIZE + nodes * sizeof(cJSON);
+  if (!insitu)
+    {
+      size += (ptr - value) + 1;
+    }
+
+  memset(&p, 0, sizeof(p));
+  p.insitu = insitu;
+  p.arena = (struct cjson_arena_s *)cJSON_malloc(size);
+  if (!p.arena)
+    {
+      return 0;
+    }
+
+  p.arena->lo = ARENA_HDRSIZE;
+  p.arena->hi = size;
+
+  root = parser_new_item(&p);
+  root->flags |= cJSON_IsArenaRoot;
+  ep = 0;
+
+  if (!parse_value(&p, root, skip(value)))
+    {
+      cJSON_Delete(root);
+      return 0;
+    }
+
+  return root;
+}
+
 /* Utility for array list handling. */
 
 static void suffix_object(cJSON *prev, cJSON *item)
@@ -1098,6 +1557,10 @@ static cJSON *create_reference(cJSON *item)
   memcpy(ref, item, sizeof(cJSON));
   ref->string = 0;
   ref->type |= cJSON_IsReference;
+  ref->flags = 0;
+#ifdef CONFIG_NETUTILS_JSON_HASH_INDEX
+  ref->index = 0;
+#endif
   ref->next = ref->prev = 0;
   return ref;
 }
@@ -1139,17 +1602,31 @@ void cJSON_Delete(cJSON *c)
           cJSON_Delete(c->child);
         }
 
-      if (!(c->type & cJSON_IsReference) && c->valuestring)
+      if (!(c->type & cJSON_IsReference) && !(c->flags & cJSON_IsArena) &&
+          c->valuestring)
         {
           cJSON_free(c->valuestring);
         }
 
-      if (c->string)
+      if (c->string &&
+          (!(c->flags & cJSON_IsArena) || (c->flags & cJSON_OwnsString)))
         {
           cJSON_free(c->string);
         }
 
-      cJSON_free(c);
+      drop_index(c);
+
+      /* Items of an arena go away together with the root. */
+
+      if (c->flags & cJSON_IsArenaRoot)
+        {
+          cJSON_free((char *)c - ARENA_HDRSIZE);
+        }
+      else if (!(c->flags & cJSON_IsArena))
+        {
+          cJSON_free(c);
+        }
+
       c = next;
     }
 }
@@ -1158,6 +1635,7 @@ void cJSON_Delete(cJSON *c)
 
 cJSON *cJSON_Parse(const char *value)
 {
+  struct cjson_parser_s p;
   cJSON *c = cJSON_New_Item();
   ep = 0;
   if (!c)
@@ -1167,7 +1645,8 @@ cJSON *cJSON_Parse(const char *value)
       return 0;
     }
 
-  if (!parse_value(c, skip(value)))
+  memset(&p, 0, sizeof(p));
+  if (!parse_value(&p, c, skip(value)))
     {
       cJSON_Delete(c);
       return 0;
@@ -1176,6 +1655,36 @@ cJSON *cJSON_Parse(const char *value)
   return c;
 }
 
+cJSON *cJSON_ParseArena(const char *value)
+{
+  return parse_arena(value, false);
+}
+
+cJSON *cJSON_ParseInSitu(char *value)
+{
+  return parse_arena(value, true);
+}
+
+/* Parse without building a tree. */
+
+int cJSON_ParseStream(char *value, cJSON_StreamHandler handler, void *arg)
+{
+  struct cjson_parser_s p;
+
+  memset(&p, 0, sizeof(p));
+  p.insitu = true;
+  p.handler = handler;
+  p.arg = arg;
+  ep = 0;
+
+  if (!stream_value(&p, NULL, skip(value)))
+    {
+      return -1;
+    }
+
+  return p.stop ? 1 : 0;
+}
+
 /* Render a cJSON item/entity/structure to text. */
 
 char *cJSON_Print(cJSON *item)
@@ -1221,6 +1730,13 @@ cJSON *cJSON_GetObjectItem(cJSON *object, const char *string)
 {
   cJSON *c = object->child;
 
+#ifdef CONFIG_NETUTILS_JSON_HASH_INDEX
+  if (string && (object->index || build_index(object)))
+    {
+      return lookup_index(object->index, string);
+    }
+#endif
+
   while (c && cJSON_strcasecmp(c->string, string))
     {
       c = c->next;
@@ -1239,6 +1755,7 @@ void cJSON_AddItemToArray(cJSON *array, cJSON *item)
       return;
     }
 
+  drop_index(array);
   if (!c)
     {
       array->child = item;
@@ -1261,12 +1778,7 @@ void cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item)
       return;
     }
 
-  if (item->string)
-    {
-      cJSON_free(item->string);
-    }
-
-  item->string = cJSON_strdup(string);
+  set_item_name(item, string);
   cJSON_AddItemToArray(object, item);
 }
 
@@ -1294,6 +1806,7 @@ cJSON *cJSON_DetachItemFromArray(cJSON *array, int which)
       return 0;
     }
 
+  drop_index(array);
   if (c->prev)
     {
       c->prev->next = c->next;
@@ -1358,6 +1871,7 @@ void cJSON_ReplaceItemInArray(cJSON *array, int which, cJSON *newitem)
       return;
     }
 
+  drop_index(array);
   newitem->next = c->next;
   newitem->prev = c->prev;
   if (newitem->next)
@@ -1391,7 +1905,7 @@ void cJSON_ReplaceItemInObject(cJSON *object, const char *string, cJSON *newitem
 
   if (c)
     {
-      newitem->string = cJSON_strdup(string);
+      set_item_name(newitem, string);
       cJSON_ReplaceItemInArray(object, i, newitem);
     }
 }
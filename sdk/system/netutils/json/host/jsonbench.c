@@ -0,0 +1,508 @@
+/****************************************************************************
+ * system/netutils/json/host/jsonbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host benchmark for cJSON.  A document of sensor records is generated
+ *   and parsed with cJSON_Parse(), cJSON_ParseArena(), cJSON_ParseInSitu()
+ *   and cJSON_ParseStream().  The documents are printed back and compared,
+ *   the streamed values are compared with a walk of the tree, and the type
+ *   of the parsed items is checked.  For each mode the throughput and the
+ *   number of allocations per document are reported.
+ *
+ *   cJSON_GetObjectItem() is then timed on a small record and on a large
+ *   object, and an object growing past the index threshold is checked to
+ *   be found through the index.
+ *
+ *   Options:
+ *     -r <records>  Number of records of the document (default 1000)
+ *     -t <msec>     Time spent measuring each case (default 300)
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "netutils/cJSON.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DEF_RECORDS    1000
+#define DEF_MSEC       300
+#define TABLE_MEMBERS  64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct walk_s
+{
+  unsigned long values;
+  unsigned long nests;
+  double sum;
+  unsigned long chars;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static unsigned long g_nalloc;
+static unsigned long g_nfree;
+static int g_msec = DEF_MSEC;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void *count_malloc(size_t sz)
+{
+  g_nalloc++;
+  return malloc(sz);
+}
+
+static void count_free(void *ptr)
+{
+  if (ptr)
+    {
+      g_nfree++;
+    }
+
+  free(ptr);
+}
+
+static double now_sec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static char *gen_document(int nrec)
+{
+  size_t max = 256 + nrec * 320 + TABLE_MEMBERS * 32;
+  char *buf = malloc(max);
+  size_t len;
+  int i;
+
+  len = snprintf(buf, max, "{\"device\":\"spresense\",\"records\":[");
+  for (i = 0; i < nrec; i++)
+    {
+      len += snprintf(buf + len, max - len,
+                      "%s{\"id\":%d,\"name\":\"sensor-%d\",\"active\":%s,"
+                      "\"value\":%d.%03d,\"tags\":[\"temp\",\"room %d\"],"
+                      "\"pos\":{\"lat\":35.%06d,\"lon\":139.%06d},"
+                      "\"note\":\"say \\\"hi\\\" \\u00e9\\t%d\","
+                      "\"extra\":null}",
+                      i ? "," : "", i, i, (i & 1) ? "true" : "false",
+                      i * 7 % 1000, i * 13 % 1000, i % 16,
+                      i * 37 % 1000000, i * 91 % 1000000, i);
+    }
+
+  len += snprintf(buf + len, max - len, "],\"table\":{");
+  for (i = 0; i < TABLE_MEMBERS; i++)
+    {
+      len += snprintf(buf + len, max - len, "%s\"key%d\":%d",
+                      i ? "," : "", i, i * 3);
+    }
+
+  snprintf(buf + len, max - len, "}}");
+  return buf;
+}
+
+static void walk_tree(cJSON *item, struct walk_s *w)
+{
+  for (; item; item = item->next)
+    {
+      switch (item->type & 255)
+        {
+          case cJSON_Array:
+          case cJSON_Object:
+            w->nests++;
+            walk_tree(item->child, w);
+            break;
+
+          case cJSON_Number:
+            w->values++;
+            w->sum += item->valuedouble;
+            break;
+
+          case cJSON_String:
+            w->values++;
+            w->chars += strlen(item->valuestring);
+            break;
+
+          default:
+            w->values++;
+            break;
+        }
+    }
+}
+
+static int stream_handler(void *arg, int event, const char *key,
+                          const cJSON *item, int depth)
+{
+  struct walk_s *w = arg;
+
+  if (event == cJSON_StreamBegin)
+    {
+      w->nests++;
+    }
+  else if (event == cJSON_StreamValue)
+    {
+      w->values++;
+      if (item->type == cJSON_Number)
+        {
+          w->sum += item->valuedouble;
+        }
+      else if (item->type == cJSON_String)
+        {
+          w->chars += strlen(item->valuestring);
+        }
+    }
+
+  return 0;
+}
+
+/* Parse the document once in the given mode. mode: 0 cJSON_Parse, 1 arena,
+ * 2 in situ, 3 stream.
+ */
+
+static cJSON *parse_mode(int mode, const char *doc, char *work, size_t len,
+                         struct walk_s *w)
+{
+  switch (mode)
+    {
+      case 0:
+        return cJSON_Parse(doc);
+
+      case 1:
+        return cJSON_ParseArena(doc);
+
+      case 2:
+        memcpy(work, doc, len + 1);
+        return cJSON_ParseInSitu(work);
+
+      default:
+        memcpy(work, doc, len + 1);
+        memset(w, 0, sizeof(*w));
+        cJSON_ParseStream(work, stream_handler, w);
+        return 0;
+    }
+}
+
+/* Check that the items of a parsed document carry plain type values. */
+
+static bool check_types(cJSON *root)
+{
+  cJSON *rec = cJSON_GetArrayItem(cJSON_GetObjectItem(root, "records"), 0);
+
+  return root->type == cJSON_Object &&
+         cJSON_GetObjectItem(rec, "id")->type == cJSON_Number &&
+         cJSON_GetObjectItem(rec, "name")->type == cJSON_String &&
+         cJSON_GetObjectItem(rec, "active")->type == cJSON_False &&
+         cJSON_GetObjectItem(rec, "tags")->type == cJSON_Array &&
+         cJSON_GetObjectItem(rec, "pos")->type == cJSON_Object &&
+         cJSON_GetObjectItem(rec, "extra")->type == cJSON_NULL;
+}
+
+static int bench_parse(const char *doc)
+{
+  static const char *names[] =
+  {
+    "cJSON_Parse", "cJSON_ParseArena", "cJSON_ParseInSitu",
+    "cJSON_ParseStream"
+  };
+
+  size_t len = strlen(doc);
+  char *work = malloc(len + 1);
+  struct walk_s ref;
+  struct walk_s w;
+  char *text = 0;
+  int ret = 0;
+  int mode;
+
+  printf("document: %zu bytes\n", len);
+  printf("%-18s %10s %12s %8s\n", "mode", "MB/s", "allocs/doc", "check");
+
+  for (mode = 0; mode < 4; mode++)
+    {
+      unsigned long nalloc;
+      unsigned long n = 0;
+      double start;
+      double copy;
+      double t;
+      bool ok = true;
+      cJSON *root;
+
+      /* One checked run, counting the allocations */
+
+      g_nalloc = g_nfree = 0;
+      root = parse_mode(mode, doc, work, len, &w);
+      nalloc = g_nalloc;
+
+      if (mode < 3)
+        {
+          char *out = 0;
+
+          if (!root || !check_types(root) ||
+              !(out = cJSON_PrintUnformatted(root)))
+            {
+              ok = false;
+            }
+          else if (mode == 0)
+            {
+              memset(&ref, 0, sizeof(ref));
+              walk_tree(root, &ref);
+              text = strdup(out);
+            }
+          else
+            {
+              ok = !strcmp(out, text);
+            }
+
+          count_free(out);
+
+          cJSON_Delete(root);
+        }
+      else
+        {
+          /* The root is an object, reported as a nest */
+
+          ok = w.values == ref.values && w.nests == ref.nests &&
+               w.sum == ref.sum && w.chars == ref.chars;
+        }
+
+      if (g_nalloc != g_nfree)
+        {
+          ok = false;
+        }
+
+      /* Time the parse and delete, less the copy of the text */
+
+      start = now_sec();
+      do
+        {
+          root = parse_mode(mode, doc, work, len, &w);
+          cJSON_Delete(root);
+          n++;
+          t = now_sec() - start;
+        }
+      while (t < g_msec / 1000.0);
+
+      copy = 0;
+      if (mode >= 2)
+        {
+          unsigned long i;
+
+          start = now_sec();
+          for (i = 0; i < n; i++)
+            {
+              memcpy(work, doc, len + 1);
+            }
+
+          copy = now_sec() - start;
+        }
+
+      printf("%-18s %10.1f %12lu %8s\n", names[mode],
+             (double)len * n / (t - copy) / 1e6, nalloc, ok ? "OK" : "FAIL");
+      if (!ok)
+        {
+          ret = 1;
+        }
+    }
+
+  free(text);
+  free(work);
+  return ret;
+}
+
+static double time_lookup(cJSON *object, const char **keys, int nkeys)
+{
+  volatile unsigned long found = 0;
+  unsigned long n = 0;
+  double start;
+  double t;
+  int i;
+
+  start = now_sec();
+  do
+    {
+      for (i = 0; i < nkeys; i++)
+        {
+          found += cJSON_GetObjectItem(object, keys[i]) != 0;
+        }
+
+      n += nkeys;
+      t = now_sec() - start;
+    }
+  while (t < g_msec / 1000.0);
+
+  return t / n * 1e9;
+}
+
+static int bench_lookup(const char *doc)
+{
+  static const char *reckeys[] =
+  {
+    "id", "name", "active", "value", "tags", "pos", "note", "extra"
+  };
+
+  char *tabkeys[TABLE_MEMBERS];
+  char name[16];
+  cJSON *root;
+  cJSON *rec;
+  cJSON *table;
+  cJSON *grow;
+  int ret = 0;
+  int i;
+
+  root = cJSON_Parse(doc);
+  rec = cJSON_GetArrayItem(cJSON_GetObjectItem(root, "records"), 0);
+  table = cJSON_GetObjectItem(root, "table");
+
+  for (i = 0; i < TABLE_MEMBERS; i++)
+    {
+      snprintf(name, sizeof(name), "KEY%d", i);
+      tabkeys[i] = strdup(name);
+    }
+
+  printf("cJSON_GetObjectItem: %d members %.1f ns, %d members %.1f ns\n",
+         (int)(sizeof(reckeys) / sizeof(reckeys[0])),
+         time_lookup(rec, reckeys, sizeof(reckeys) / sizeof(reckeys[0])),
+         TABLE_MEMBERS,
+         time_lookup(table, (const char **)tabkeys, TABLE_MEMBERS));
+
+  /* A small object looked up once must still be found after it grows */
+
+  grow = cJSON_CreateObject();
+  cJSON_AddNumberToObject(grow, "first", 1);
+  if (!cJSON_GetObjectItem(grow, "first") ||
+      cJSON_GetObjectItem(grow, "key0"))
+    {
+      ret = 1;
+    }
+
+  for (i = 0; i < TABLE_MEMBERS; i++)
+    {
+      snprintf(name, sizeof(name), "key%d", i);
+      cJSON_AddNumberToObject(grow, name, i);
+      if (!cJSON_GetObjectItem(grow, "first") ||
+          cJSON_GetObjectItem(grow, name)->valueint != i)
+        {
+          ret = 1;
+        }
+    }
+
+  cJSON_DeleteItemFromObject(grow, "key10");
+  if (cJSON_GetObjectItem(grow, "key10") ||
+      cJSON_GetObjectItem(grow, "key11")->valueint != 11)
+    {
+      ret = 1;
+    }
+
+  printf("growing object: %s\n", ret ? "FAIL" : "OK");
+
+  cJSON_Delete(grow);
+  cJSON_Delete(root);
+  for (i = 0; i < TABLE_MEMBERS; i++)
+    {
+      free(tabkeys[i]);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  cJSON_Hooks hooks;
+  int nrec = DEF_RECORDS;
+  char *doc;
+  int ret;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "r:t:")) != -1)
+    {
+      switch (opt)
+        {
+          case 'r':
+            nrec = atoi(optarg);
+            break;
+
+          case 't':
+            g_msec = atoi(optarg);
+            break;
+
+          default:
+            fprintf(stderr, "usage: %s [-r records] [-t msec]\n", argv[0]);
+            return 2;
+        }
+    }
+
+  hooks.malloc_fn = count_malloc;
+  hooks.free_fn = count_free;
+  cJSON_InitHooks(&hooks);
+
+#ifdef CONFIG_NETUTILS_JSON_HASH_INDEX
+  printf("jsonbench (hash index)\n");
+#else
+  printf("jsonbench\n");
+#endif
+
+  doc = gen_document(nrec);
+  ret = bench_parse(doc);
+  ret |= bench_lookup(doc);
+  free(doc);
+
+  printf("%s\n", ret ? "FAIL" : "PASS");
+  return ret;
+}
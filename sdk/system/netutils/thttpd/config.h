@@ -213,6 +213,24 @@
 #    define CONFIG_THTTPD_IDLE_SEND_LIMIT_SEC 300
 #  endif
 
+/* How many bytes to send on one connection before servicing the others. */
+
+#  ifndef CONFIG_THTTPD_SEND_SLICE
+#    define CONFIG_THTTPD_SEND_SLICE 4096
+#  endif
+
+/* How many seconds to wait for the next request on a persistent connection. */
+
+#  ifndef CONFIG_THTTPD_KEEPALIVE_TIMEOUT_SEC
+#    define CONFIG_THTTPD_KEEPALIVE_TIMEOUT_SEC 5
+#  endif
+
+/* sendfile() is only available if the network supports it */
+
+#  if defined(CONFIG_THTTPD_SENDFILE) && !defined(CONFIG_NET_SENDFILE)
+#    undef CONFIG_THTTPD_SENDFILE
+#  endif
+
 /* Memory debug instrumentation depends on other debug options */
 
 #  if (!defined(CONFIG_DEBUG_FEATURES) || !defined(CONFIG_DEBUG_NET)) && defined(CONFIG_THTTPD_MEMDEBUG)
@@ -236,6 +236,21 @@ void fdwatch_add_fd(struct fdwatch_s *fw, int fd, void *client_data)
   fdwatch_dump("After adding:", fw);
 }
 
+/* Select whether a watched descriptor is polled for input or output */
+
+void fdwatch_set_write(struct fdwatch_s *fw, int fd, bool write)
+{
+  int pollndx;
+
+  fwinfo("fd: %d write: %d\n", fd, write);
+
+  pollndx = fdwatch_pollndx(fw, fd);
+  if (pollndx >= 0)
+    {
+      fw->pollfds[pollndx].events = write ? POLLOUT : POLLIN;
+    }
+}
+
 /* Remove a descriptor from the watch list. */
 
 void fdwatch_del_fd(struct fdwatch_s *fw, int fd)
@@ -299,7 +314,8 @@ int fdwatch(struct fdwatch_s *fw, long timeout_msecs)
         {
           /* Is there activity on this descriptor? */
 
-          if (fw->pollfds[i].revents & (POLLIN | POLLERR | POLLHUP | POLLNVAL))
+          if (fw->pollfds[i].revents &
+              (POLLIN | POLLOUT | POLLERR | POLLHUP | POLLNVAL))
             {
               /* Yes... save it in a shorter list */
 
@@ -338,7 +354,8 @@ int fdwatch_check_fd(struct fdwatch_s *fw, int fd)
   pollndx = fdwatch_pollndx(fw, fd);
   if (pollndx >= 0 && (fw->pollfds[pollndx].revents & POLLERR) == 0)
     {
-      return fw->pollfds[pollndx].revents & (POLLIN | POLLHUP | POLLNVAL);
+      return fw->pollfds[pollndx].revents &
+             (POLLIN | POLLOUT | POLLHUP | POLLNVAL);
     }
 
   fwinfo("POLLERR fd: %d\n", fd);
@@ -42,6 +42,7 @@
 
 #include <sdk/config.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 /****************************************************************************
  * Pre-Processor Definitions
@@ -86,6 +87,12 @@ extern void fdwatch_uninitialize(struct fdwatch_s *fw);
 
 extern void fdwatch_add_fd(struct fdwatch_s *fw, int fd, void *client_data);
 
+/* Select whether a watched descriptor is polled for readability (the
+ * default) or for writability.
+ */
+
+extern void fdwatch_set_write(struct fdwatch_s *fw, int fd, bool write);
+
 /* Delete a descriptor from the watch list. */
 
 extern void fdwatch_del_fd(struct fdwatch_s *fw, int fd);
@@ -0,0 +1,77 @@
+/****************************************************************************
+ * system/netutils/thttpd/host/sdk/config.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_SYSTEM_NETUTILS_THTTPD_HOST_SDK_CONFIG_H
+#define __APPS_SYSTEM_NETUTILS_THTTPD_HOST_SDK_CONFIG_H
+
+/* Configuration for building thttpd on the host.  The optional features
+ * (keep-alive, sendfile, file cache) are selected by the Makefile.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#define FAR
+#define CODE
+
+#define CONFIG_NET                          1
+#define CONFIG_NET_TCP                      1
+#define CONFIG_NET_TCPBACKLOG               1
+#define CONFIG_NET_TCP_READAHEAD            1
+#define CONFIG_NSOCKET_DESCRIPTORS          16
+#define CONFIG_NFILE_DESCRIPTORS            8
+#define CONFIG_FS_BINFS                     1
+
+#define CONFIG_NETUTILS_THTTPD              1
+#define CONFIG_THTTPD_PORT                  18080
+#define CONFIG_THTTPD_IPADDR                0x7f000001
+#define CONFIG_THTTPD_PATH                  "/tmp/thttpdbench"
+#define CONFIG_THTTPD_IOBUFFERSIZE          512
+
+#ifdef CONFIG_THTTPD_FILE_CACHE
+#  define CONFIG_THTTPD_FILE_CACHE_SIZE     16384
+#  define CONFIG_THTTPD_FILE_CACHE_MAXFILE  4096
+#endif
+
+#define HTONS(x) htons(x)
+#define HTONL(x) htonl(x)
+
+static inline void *zalloc(size_t n)
+{
+  return calloc(1, n);
+}
+
+#endif /* __APPS_SYSTEM_NETUTILS_THTTPD_HOST_SDK_CONFIG_H */
@@ -0,0 +1,496 @@
+/****************************************************************************
+ * system/netutils/thttpd/host/thttpdbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host load benchmark for thttpd.  The server runs in a child process on
+ *   port CONFIG_THTTPD_PORT and serves files generated in
+ *   CONFIG_THTTPD_PATH.  Client threads request a small page and then a
+ *   large file over and over, asking for persistent connections, and check
+ *   every body against the file.  For each file the requests per second,
+ *   the throughput and the number of connections opened are reported.
+ *
+ *   Options:
+ *     -c <clients>  Number of concurrent clients (default 8)
+ *     -t <msec>     Time spent on each file (default 1000)
+ *     -s <bytes>    Size of the small page (default 1024)
+ *     -b <bytes>    Size of the large file (default 1048576)
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <errno.h>
+
+#include "netutils/thttpd.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MAX_CLIENTS   64
+#define DEF_CLIENTS   8
+#define DEF_MSEC      1000
+#define DEF_SMALL     1024
+#define DEF_BIG       (1024 * 1024)
+#define HDR_MAX       1024
+#define RECV_CHUNK    16384
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct testfile_s
+{
+  const char *name;
+  size_t size;
+  char *data;
+};
+
+struct client_s
+{
+  pthread_t thread;
+  const struct testfile_s *file;
+  double deadline;
+  unsigned long requests;
+  unsigned long connects;
+  unsigned long errors;
+  unsigned long long bytes;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static int g_msec = DEF_MSEC;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static double now_sec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int make_file(struct testfile_s *file, bool text)
+{
+  char path[128];
+  uint32_t seed = 12345;
+  size_t i;
+  int fd;
+
+  file->data = malloc(file->size);
+  for (i = 0; i < file->size; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      file->data[i] = text ? 'a' + (seed >> 16) % 26 : (char)(seed >> 16);
+    }
+
+  snprintf(path, sizeof(path), "%s/%s", CONFIG_THTTPD_PATH, file->name);
+  fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0 || write(fd, file->data, file->size) != file->size)
+    {
+      perror(path);
+      return -1;
+    }
+
+  close(fd);
+  return 0;
+}
+
+static void remove_file(struct testfile_s *file)
+{
+  char path[128];
+
+  snprintf(path, sizeof(path), "%s/%s", CONFIG_THTTPD_PATH, file->name);
+  unlink(path);
+  free(file->data);
+}
+
+static int connect_server(void)
+{
+  struct sockaddr_in sa;
+  struct timeval tv;
+  int fd;
+
+  fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    {
+      return -1;
+    }
+
+  tv.tv_sec = 5;
+  tv.tv_usec = 0;
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(CONFIG_THTTPD_PORT);
+  sa.sin_addr.s_addr = htonl(CONFIG_THTTPD_IPADDR);
+  if (connect(fd, (struct sockaddr *)&sa, sizeof(sa)) < 0)
+    {
+      close(fd);
+      return -1;
+    }
+
+  return fd;
+}
+
+/* Read the response header, leaving the first body bytes in buf. Returns
+ * the header length, or -1 on error.
+ */
+
+static int read_header(int fd, char *buf, size_t *len, size_t *clen,
+                       bool *close_conn)
+{
+  char *end = NULL;
+  char *line;
+  ssize_t n;
+
+  *len = 0;
+  while (!end)
+    {
+      if (*len >= HDR_MAX - 1)
+        {
+          return -1;
+        }
+
+      n = recv(fd, buf + *len, HDR_MAX - 1 - *len, 0);
+      if (n <= 0)
+        {
+          return -1;
+        }
+
+      *len += n;
+      buf[*len] = '\0';
+      end = strstr(buf, "\r\n\r\n");
+    }
+
+  if (strncmp(buf, "HTTP/1.", 7) || strncmp(buf + 8, " 200", 4))
+    {
+      return -1;
+    }
+
+  *clen = (size_t)-1;
+  *close_conn = true;
+  for (line = strstr(buf, "\r\n") + 2; line < end;
+       line = strstr(line, "\r\n") + 2)
+    {
+      if (!strncasecmp(line, "Content-Length:", 15))
+        {
+          *clen = strtoul(line + 15, NULL, 10);
+        }
+      else if (!strncasecmp(line, "Connection: keep-alive", 22))
+        {
+          *close_conn = false;
+        }
+    }
+
+  return end + 4 - buf;
+}
+
+/* Issue one request on *fd, connecting first if needed, and check the
+ * body. The connection is closed unless the server keeps it alive.
+ */
+
+static int do_request(struct client_s *c, int *fd, char *buf)
+{
+  const struct testfile_s *file = c->file;
+  char req[128];
+  size_t hlen;
+  size_t len;
+  size_t clen;
+  size_t got;
+  bool close_conn;
+  ssize_t n;
+  int ret;
+
+  if (*fd < 0)
+    {
+      *fd = connect_server();
+      if (*fd < 0)
+        {
+          return -1;
+        }
+
+      c->connects++;
+    }
+
+  len = snprintf(req, sizeof(req), "GET /%s HTTP/1.1\r\nHost: localhost\r\n"
+                 "Connection: keep-alive\r\n\r\n", file->name);
+  if (send(*fd, req, len, 0) != len)
+    {
+      return -1;
+    }
+
+  ret = read_header(*fd, buf, &len, &clen, &close_conn);
+  if (ret < 0 || clen != file->size)
+    {
+      return -1;
+    }
+
+  hlen = ret;
+  got = len - hlen;
+  if (got > clen || memcmp(buf + hlen, file->data, got))
+    {
+      return -1;
+    }
+
+  while (got < clen)
+    {
+      n = recv(*fd, buf, RECV_CHUNK, 0);
+      if (n <= 0 || got + n > clen || memcmp(buf, file->data + got, n))
+        {
+          return -1;
+        }
+
+      got += n;
+    }
+
+  c->requests++;
+  c->bytes += clen;
+  if (close_conn)
+    {
+      close(*fd);
+      *fd = -1;
+    }
+
+  return 0;
+}
+
+static void *client_thread(void *arg)
+{
+  struct client_s *c = arg;
+  char *buf = malloc(RECV_CHUNK > HDR_MAX ? RECV_CHUNK : HDR_MAX);
+  int fd = -1;
+
+  while (now_sec() < c->deadline)
+    {
+      if (do_request(c, &fd, buf) < 0)
+        {
+          c->errors++;
+          if (fd >= 0)
+            {
+              close(fd);
+              fd = -1;
+            }
+        }
+    }
+
+  if (fd >= 0)
+    {
+      close(fd);
+    }
+
+  free(buf);
+  return NULL;
+}
+
+static int run_load(const struct testfile_s *file, int nclients)
+{
+  struct client_s clients[MAX_CLIENTS];
+  unsigned long long bytes = 0;
+  unsigned long requests = 0;
+  unsigned long connects = 0;
+  unsigned long errors = 0;
+  double start;
+  double t;
+  int i;
+
+  memset(clients, 0, sizeof(clients));
+  start = now_sec();
+  for (i = 0; i < nclients; i++)
+    {
+      clients[i].file = file;
+      clients[i].deadline = start + g_msec / 1000.0;
+      pthread_create(&clients[i].thread, NULL, client_thread, &clients[i]);
+    }
+
+  for (i = 0; i < nclients; i++)
+    {
+      pthread_join(clients[i].thread, NULL);
+      requests += clients[i].requests;
+      connects += clients[i].connects;
+      errors += clients[i].errors;
+      bytes += clients[i].bytes;
+    }
+
+  t = now_sec() - start;
+  printf("%-10s %8zu %10.0f %10.2f %10lu %8lu\n", file->name, file->size,
+         requests / t, bytes / t / 1e6, connects, errors);
+  return errors || !requests;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  struct testfile_s small =
+  {
+    "small.html", DEF_SMALL
+  };
+
+  struct testfile_s big =
+  {
+    "big.bin", DEF_BIG
+  };
+
+  int nclients = DEF_CLIENTS;
+  pid_t pid;
+  int ret;
+  int opt;
+  int fd;
+  int i;
+
+  while ((opt = getopt(argc, argv, "c:t:s:b:")) != -1)
+    {
+      switch (opt)
+        {
+          case 'c':
+            nclients = atoi(optarg);
+            break;
+
+          case 't':
+            g_msec = atoi(optarg);
+            break;
+
+          case 's':
+            small.size = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'b':
+            big.size = strtoul(optarg, NULL, 0);
+            break;
+
+          default:
+            fprintf(stderr, "usage: %s [-c clients] [-t msec] "
+                    "[-s bytes] [-b bytes]\n", argv[0]);
+            return 2;
+        }
+    }
+
+  if (nclients < 1 || nclients > MAX_CLIENTS)
+    {
+      fprintf(stderr, "clients must be 1 to %d\n", MAX_CLIENTS);
+      return 2;
+    }
+
+  signal(SIGPIPE, SIG_IGN);
+  mkdir(CONFIG_THTTPD_PATH, 0755);
+  if (make_file(&small, true) < 0 || make_file(&big, false) < 0)
+    {
+      return 1;
+    }
+
+  pid = fork();
+  if (pid == 0)
+    {
+      thttpd_main(0, NULL);
+      _exit(1);
+    }
+
+  for (i = 0; i < 100 && (fd = connect_server()) < 0; i++)
+    {
+      usleep(10000);
+    }
+
+  if (fd < 0)
+    {
+      fprintf(stderr, "server did not start\n");
+      kill(pid, SIGKILL);
+      return 1;
+    }
+
+  close(fd);
+
+  printf("thttpd:%s%s%s, %d clients\n",
+#ifdef CONFIG_THTTPD_KEEPALIVE
+         " keep-alive",
+#else
+         "",
+#endif
+#ifdef CONFIG_THTTPD_SENDFILE
+         " sendfile",
+#else
+         "",
+#endif
+#ifdef CONFIG_THTTPD_FILE_CACHE
+         " file-cache",
+#else
+         "",
+#endif
+         nclients);
+  printf("%-10s %8s %10s %10s %10s %8s\n",
+         "file", "bytes", "req/s", "MB/s", "connects", "errors");
+
+  ret = run_load(&small, nclients);
+  ret |= run_load(&big, nclients);
+
+  kill(pid, SIGKILL);
+  waitpid(pid, NULL, 0);
+
+  remove_file(&small);
+  remove_file(&big);
+  rmdir(CONFIG_THTTPD_PATH);
+
+  printf("%s\n", ret ? "FAIL" : "PASS");
+  return ret;
+}
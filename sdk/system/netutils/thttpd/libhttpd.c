@@ -58,6 +58,11 @@
 #include <signal.h>
 #include <sched.h>
 #include <errno.h>
+
+#ifdef CONFIG_THTTPD_KEEPALIVE
+#  include <netinet/in.h>
+#  include <netinet/tcp.h>
+#endif
 #include <debug.h>
 
 #include <nuttx/lib/regex.h>
@@ -71,6 +76,7 @@
 #include "thttpd_cgi.h"
 #include "tdate_parse.h"
 #include "fdwatch.h"
+#include "thttpd_cache.h"
 
 #ifdef CONFIG_THTTPD
 
@@ -112,6 +118,16 @@ extern CODE char *crypt(const char *key, const char *setting);
 #  define ERROR_FORM(a,b) a
 #endif
 
+/* Extra headers of static file responses.  Caches must not hand out a
+ * compressed response to a client that does not accept it.
+ */
+
+#ifdef CONFIG_THTTPD_GZIP_STATIC
+#  define FILE_EXTRAHEADS "Vary: Accept-Encoding\r\n"
+#else
+#  define FILE_EXTRAHEADS ""
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -154,6 +170,11 @@ static char *bufgets(httpd_conn *hc);
 static void de_dotdot(char *file);
 static void init_mime(void);
 static void figure_mime(httpd_conn *hc);
+#ifdef CONFIG_THTTPD_GZIP_STATIC
+static bool accepts_gzip(httpd_conn *hc);
+static void figure_gzip(httpd_conn *hc);
+#endif
+static void reset_request(httpd_conn *hc);
 #ifdef CONFIG_THTTPD_GENERATE_INDICES
 static void ls_child(int argc, char **argv);
 static int  ls(httpd_conn *hc);
@@ -361,7 +382,23 @@ static void send_mime(httpd_conn *hc, int status, const char *title, const char
       (void)snprintf(buf, sizeof(buf), "Last-Modified: %s\r\n", tmbuf);
       add_response(hc, buf);
       add_response(hc, "Accept-Ranges: bytes\r\n");
-      add_response(hc, "Connection: close\r\n");
+
+#ifdef CONFIG_THTTPD_KEEPALIVE
+      /* The connection can only be reused if the client can tell where
+       * the response body ends.
+       */
+
+      hc->do_keep_alive = hc->keep_alive && hc->method != METHOD_POST &&
+                          (length >= 0 || status == 304);
+      if (hc->do_keep_alive)
+        {
+          add_response(hc, "Connection: keep-alive\r\n");
+        }
+      else
+#endif
+        {
+          add_response(hc, "Connection: close\r\n");
+        }
 
       s100 = status / 100;
       if (s100 != 2 && s100 != 3)
@@ -1537,6 +1574,125 @@ done:
     }
 }
 
+#ifdef CONFIG_THTTPD_GZIP_STATIC
+/* Check whether the Accept-Encoding list allows the gzip content coding
+ * (and does not give it a q-value of zero).
+ */
+
+static bool accepts_gzip(httpd_conn *hc)
+{
+  const char *cp = hc->accepte;
+  const char *q;
+  size_t len;
+
+  while (*cp != '\0')
+    {
+      cp += strspn(cp, " \t,");
+      len = strcspn(cp, ",");
+      if (len >= 4 && strncasecmp(cp, "gzip", 4) == 0 &&
+          (len == 4 || cp[4] == ';' || cp[4] == ' ' || cp[4] == '\t'))
+        {
+          q = strchr(cp, '=');
+          return q == NULL || q >= cp + len || strtod(q + 1, NULL) > 0.0;
+        }
+
+      cp += len;
+    }
+
+  return false;
+}
+
+/* If the client accepts gzip and a precompressed <file>.gz exists, send
+ * that file instead.  The MIME type is still the one of the original file.
+ */
+
+static void figure_gzip(httpd_conn *hc)
+{
+  struct stat sb;
+  size_t expnlen;
+
+  if (hc->encodings[0] != '\0' || hc->got_range || !accepts_gzip(hc))
+    {
+      return;
+    }
+
+  expnlen = strlen(hc->expnfilename);
+  httpd_realloc_str(&hc->expnfilename, &hc->maxexpnfilename, expnlen + 3);
+  (void)strcpy(&hc->expnfilename[expnlen], ".gz");
+
+  if (stat(hc->expnfilename, &sb) < 0 || !S_ISREG(sb.st_mode) ||
+      !(sb.st_mode & S_IROTH))
+    {
+      hc->expnfilename[expnlen] = '\0';
+      return;
+    }
+
+  ninfo("Sending %s\n", hc->expnfilename);
+  hc->sb = sb;
+  httpd_realloc_str(&hc->encodings, &hc->maxencodings, 4);
+  (void)strcpy(hc->encodings, "gzip");
+}
+#endif /* CONFIG_THTTPD_GZIP_STATIC */
+
+/* Reset the per-request state of a connection */
+
+static void reset_request(httpd_conn *hc)
+{
+  hc->read_idx          = 0;
+  hc->checked_idx       = 0;
+  hc->checked_state     = CHST_FIRSTWORD;
+  hc->method            = METHOD_UNKNOWN;
+  hc->bytes_to_send     = 0;
+  hc->bytes_sent        = 0;
+  hc->encodedurl        = "";
+  hc->decodedurl[0]     = '\0';
+  hc->protocol          = "UNKNOWN";
+  hc->origfilename[0]   = '\0';
+  hc->expnfilename[0]   = '\0';
+  hc->encodings[0]      = '\0';
+  hc->pathinfo[0]       = '\0';
+  hc->query[0]          = '\0';
+  hc->referer           = "";
+  hc->useragent         = "";
+  hc->accept[0]         = '\0';
+  hc->accepte[0]        = '\0';
+  hc->acceptl           = "";
+  hc->cookie            = "";
+  hc->contenttype       = "";
+  hc->reqhost[0]        = '\0';
+  hc->hdrhost           = "";
+  hc->hostdir[0]        = '\0';
+  hc->authorization     = "";
+  hc->remoteuser[0]     = '\0';
+  hc->buffer[0]         = '\0';
+#ifdef CONFIG_THTTPD_TILDE_MAP2
+  hc->altdir[0]         = '\0';
+#endif
+  hc->buflen = 0;
+  hc->if_modified_since = (time_t) - 1;
+  hc->range_if          = (time_t)-1;
+  hc->contentlength     = -1;
+  hc->type = "";
+#ifdef CONFIG_THTTPD_VHOST
+  hc->vhostname         = NULL;
+#endif
+  hc->mime_flag         = true;
+  hc->one_one           = false;
+  hc->got_range         = false;
+  hc->tildemapped       = false;
+  hc->range_start       = 0;
+  hc->range_end         = -1;
+  hc->keep_alive        = false;
+  hc->should_linger     = false;
+  hc->file_fd           = -1;
+#ifdef CONFIG_THTTPD_KEEPALIVE
+  hc->do_keep_alive     = false;
+#endif
+#ifdef CONFIG_THTTPD_FILE_CACHE
+  hc->cache             = NULL;
+#endif
+}
+
 /* qsort comparison routine. */
 
 #ifdef CONFIG_THTTPD_GENERATE_INDICES
@@ -2310,6 +2466,18 @@ int httpd_get_conn(httpd_server *hs, int listen_fd, httpd_conn *hc)
       return GC_FAIL;
     }
 
+#if defined(CONFIG_THTTPD_KEEPALIVE) && defined(TCP_NODELAY)
+  /* A persistent connection is not closed after the response, so the last
+   * small segment of a response must not wait for the previous one to be
+   * acknowledged.
+   */
+
+  {
+    int on = 1;
+    (void)setsockopt(hc->conn_fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  }
+#endif
+
 #ifdef CONFIG_DEBUG_FEATURES_FEATURES
   if (!sockaddr_check(&sa))
     {
@@ -2323,53 +2491,7 @@ int httpd_get_conn(httpd_server *hs, int listen_fd, httpd_conn *hc)
   hc->hs = hs;
   (void)memset(&hc->client_addr, 0, sizeof(hc->client_addr));
   (void)memmove(&hc->client_addr, &sa, sockaddr_len(&sa));
-  hc->read_idx          = 0;
-  hc->checked_idx       = 0;
-  hc->checked_state     = CHST_FIRSTWORD;
-  hc->method            = METHOD_UNKNOWN;
-  hc->bytes_to_send     = 0;
-  hc->bytes_sent        = 0;
-  hc->encodedurl        = "";
-  hc->decodedurl[0]     = '\0';
-  hc->protocol          = "UNKNOWN";
-  hc->origfilename[0]   = '\0';
-  hc->expnfilename[0]   = '\0';
-  hc->encodings[0]      = '\0';
-  hc->pathinfo[0]       = '\0';
-  hc->query[0]          = '\0';
-  hc->referer           = "";
-  hc->useragent         = "";
-  hc->accept[0]         = '\0';
-  hc->accepte[0]        = '\0';
-  hc->acceptl           = "";
-  hc->cookie            = "";
-  hc->contenttype       = "";
-  hc->reqhost[0]        = '\0';
-  hc->hdrhost           = "";
-  hc->hostdir[0]        = '\0';
-  hc->authorization     = "";
-  hc->remoteuser[0]     = '\0';
-  hc->buffer[0]         = '\0';
-#ifdef CONFIG_THTTPD_TILDE_MAP2
-  hc->altdir[0]         = '\0';
-#endif
-  hc->buflen = 0;
-  hc->if_modified_since = (time_t) - 1;
-  hc->range_if          = (time_t)-1;
-  hc->contentlength     = -1;
-  hc->type = "";
-#ifdef CONFIG_THTTPD_VHOST
-  hc->vhostname         = NULL;
-#endif
-  hc->mime_flag         = true;
-  hc->one_one           = false;
-  hc->got_range         = false;
-  hc->tildemapped       = false;
-  hc->range_start       = 0;
-  hc->range_end         = -1;
-  hc->keep_alive        = false;
-  hc->should_linger     = false;
-  hc->file_fd           = -1;
+  reset_request(hc);
 
   ninfo("New connection accepted on %d\n", hc->conn_fd);
   return GC_OK;
@@ -2637,6 +2759,13 @@ int httpd_parse_request(httpd_conn *hc)
           if (strcasecmp(protocol, "HTTP/1.0") != 0)
             {
               hc->one_one = true;
+#ifdef CONFIG_THTTPD_KEEPALIVE
+              /* HTTP/1.1 connections are persistent unless the client
+               * says otherwise.
+               */
+
+              hc->keep_alive = true;
+#endif
             }
         }
     }
@@ -2911,6 +3040,10 @@ int httpd_parse_request(httpd_conn *hc)
                {
                  hc->keep_alive = true;
                }
+              else if (strcasecmp(cp, "close") == 0)
+               {
+                 hc->keep_alive = false;
+               }
            }
 #ifdef LOG_UNKNOWN_HEADERS
           else if (strncasecmp(buf, "Accept-Charset:", 15) == 0 ||
@@ -2963,10 +3096,10 @@ int httpd_parse_request(httpd_conn *hc)
         }
 
       /* If the client wants to do keep-alives, it might also be doing
-       * pipelining.  There's no way for us to tell.  Since we don't
-       * implement keep-alives yet, if we close such a connection there
-       * might be unread pipelined requests waiting.  So, we have to do a
-       * lingering close.
+       * pipelining.  There's no way for us to tell.  If we close such a
+       * connection (keep-alives are not configured, or the response does
+       * not allow it) there might be unread pipelined requests waiting.
+       * So, we have to do a lingering close.
        */
 
       if (hc->keep_alive)
@@ -3076,6 +3209,39 @@ int httpd_parse_request(httpd_conn *hc)
   return 0;
 }
 
+#ifdef CONFIG_THTTPD_KEEPALIVE
+size_t httpd_keepalive_conn(httpd_conn *hc)
+{
+  size_t pipelined;
+
+  if (hc->file_fd >= 0)
+    {
+      (void)close(hc->file_fd);
+    }
+
+#ifdef CONFIG_THTTPD_FILE_CACHE
+  if (hc->cache != NULL)
+    {
+      httpd_cache_release(hc->cache);
+    }
+#endif
+
+  /* httpd_parse_request() leaves checked_idx just past the blank line that
+   * ends the request headers.  Anything after it is the next request.
+   */
+
+  pipelined = hc->read_idx - hc->checked_idx;
+  if (pipelined > 0)
+    {
+      memmove(hc->read_buf, &hc->read_buf[hc->checked_idx], pipelined);
+    }
+
+  reset_request(hc);
+  hc->read_idx = pipelined;
+  return pipelined;
+}
+#endif
+
 void httpd_close_conn(httpd_conn *hc)
 {
   if (hc->file_fd >= 0)
@@ -3084,6 +3250,14 @@ void httpd_close_conn(httpd_conn *hc)
       hc->file_fd = -1;
     }
 
+#ifdef CONFIG_THTTPD_FILE_CACHE
+  if (hc->cache != NULL)
+    {
+      httpd_cache_release(hc->cache);
+      hc->cache = NULL;
+    }
+#endif
+
   if (hc->conn_fd >= 0)
     {
       (void)close(hc->conn_fd);
@@ -3394,28 +3568,40 @@ int httpd_start_request(httpd_conn *hc, struct timeval *nowP)
     }
 
   figure_mime(hc);
+#ifdef CONFIG_THTTPD_GZIP_STATIC
+  figure_gzip(hc);
+#endif
 
   if (hc->method == METHOD_HEAD)
     {
-      send_mime(hc, 200, ok200title, hc->encodings, "", hc->type,
+      send_mime(hc, 200, ok200title, hc->encodings, FILE_EXTRAHEADS, hc->type,
                 hc->sb.st_size, hc->sb.st_mtime);
     }
   else if (hc->if_modified_since != (time_t) - 1 &&
            hc->if_modified_since >= hc->sb.st_mtime)
     {
-      send_mime(hc, 304, err304title, hc->encodings, "", hc->type, (off_t) - 1,
-                hc->sb.st_mtime);
+      send_mime(hc, 304, err304title, hc->encodings, FILE_EXTRAHEADS, hc->type,
+                (off_t) - 1, hc->sb.st_mtime);
     }
   else
     {
-      hc->file_fd = open(hc->expnfilename, O_RDONLY);
-      if (hc->file_fd < 0)
+#ifdef CONFIG_THTTPD_FILE_CACHE
+      /* Small files are sent from RAM if possible */
+
+      hc->cache = httpd_cache_get(hc->expnfilename, &hc->sb);
+      if (hc->cache == NULL)
+#endif
         {
-          INTERNALERROR(hc->expnfilename);
-          httpd_send_err(hc, 500, err500title, "", err500form, hc->encodedurl);
-          return -1;
+          hc->file_fd = open(hc->expnfilename, O_RDONLY);
+          if (hc->file_fd < 0)
+            {
+              INTERNALERROR(hc->expnfilename);
+              httpd_send_err(hc, 500, err500title, "", err500form, hc->encodedurl);
+              return -1;
+            }
         }
-      send_mime(hc, 200, ok200title, hc->encodings, "", hc->type,
+
+      send_mime(hc, 200, ok200title, hc->encodings, FILE_EXTRAHEADS, hc->type,
                 hc->sb.st_size, hc->sb.st_mtime);
     }
 
@@ -171,6 +171,10 @@ typedef struct
   int   listen_fd;
 } httpd_server;
 
+#ifdef CONFIG_THTTPD_FILE_CACHE
+struct httpd_cache_s;
+#endif
+
 /* A connection. */
 
 typedef struct
@@ -223,8 +227,14 @@ typedef struct
   bool tildemapped;            /* this connection got tilde-mapped */
   bool keep_alive;
   bool should_linger;
+#ifdef CONFIG_THTTPD_KEEPALIVE
+  bool do_keep_alive;          /* The response lets the connection be reused */
+#endif
   int conn_fd;                 /* Connection to the client */
   int file_fd;                 /* Descriptor for open, outgoing file */
+#ifdef CONFIG_THTTPD_FILE_CACHE
+  FAR struct httpd_cache_s *cache; /* Cached file to send instead of file_fd */
+#endif
   off_t range_start;           /* File range start from Range= */
   off_t range_end;             /* File range end from Range= */
   struct stat sb;
@@ -287,8 +297,8 @@ extern int httpd_parse_request(httpd_conn *hc);
 /* Starts sending data back to the client.  In some cases (directories,
  * CGI programs), finishes sending by itself - in those cases, hc->file_fd
  * is negative.  If there is more data to be sent, then hc->file_fd is a file
- * stream for the file to send.  If you don't have a current timeval
- * handy just pass in 0.
+ * stream for the file to send, or hc->cache holds the file contents.  If
+ * you don't have a current timeval handy just pass in 0.
  *
  * Returns -1 on error.
  */
@@ -299,6 +309,16 @@ extern int httpd_start_request(httpd_conn *hc, struct timeval *nowP);
 
 extern void httpd_write_response(httpd_conn *hc);
 
+#ifdef CONFIG_THTTPD_KEEPALIVE
+/* Call this when a response allowing keep-alive has been sent, to prepare
+ * the connection for the next request.  Bytes of pipelined requests that
+ * were already read are moved to the start of hc->read_buf.  Returns the
+ * number of such bytes.
+ */
+
+extern size_t httpd_keepalive_conn(httpd_conn *hc);
+#endif
+
 /* Call this to close down a connection and free the data. */
 
 extern void httpd_close_conn(httpd_conn *hc);
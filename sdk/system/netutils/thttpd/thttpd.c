@@ -54,6 +54,9 @@
 #include <debug.h>
 
 #include <arpa/inet.h>
+#ifdef CONFIG_THTTPD_SENDFILE
+#  include <sys/sendfile.h>
+#endif
 
 #include <nuttx/compiler.h>
 #include <nuttx/binfmt/symtab.h>
@@ -63,6 +66,7 @@
 #include "fdwatch.h"
 #include "libhttpd.h"
 #include "thttpd_alloc.h"
+#include "thttpd_cache.h"
 #include "thttpd_strings.h"
 #include "timers.h"
 
@@ -100,7 +104,12 @@ struct connect_s
   Timer *linger_timer;
   off_t end_offset;            /* The final offset+1 of the file to send */
   off_t offset;                /* The current offset into the file to send */
+  size_t hdrlen;               /* Response header bytes left in hc->buffer */
   bool eof;                    /* Set true when length==0 read from file */
+  bool zerocopy;               /* File data is not copied to hc->buffer */
+#ifdef CONFIG_THTTPD_KEEPALIVE
+  bool reused;                 /* At least one request was served */
+#endif
 };
 
 /****************************************************************************
@@ -123,8 +132,10 @@ static struct fdwatch_s *fw;
 static void shut_down(void);
 static int  handle_newconnect(struct timeval *tv, int listen_fd);
 static void handle_read(struct connect_s *conn, struct timeval *tv);
+static void handle_request(struct connect_s *conn, struct timeval *tv);
 static void handle_send(struct connect_s *conn, struct timeval *tv);
 static void handle_linger(struct connect_s *conn, struct timeval *tv);
+static bool finish_request(struct connect_s *conn, struct timeval *tv);
 static void finish_connection(struct connect_s *conn, struct timeval *tv);
 static void clear_connection(struct connect_s *conn, struct timeval *tv);
 static void really_clear_connection(struct connect_s *conn);
@@ -246,6 +257,11 @@ static int handle_newconnect(FAR struct timeval *tv, int listen_fd)
       conn->wakeup_timer      = NULL;
       conn->linger_timer      = NULL;
       conn->offset            = 0;
+      conn->hdrlen            = 0;
+      conn->zerocopy          = false;
+#ifdef CONFIG_THTTPD_KEEPALIVE
+      conn->reused            = false;
+#endif
 
       /* Set the connection file descriptor to no-delay mode */
 
@@ -257,7 +273,6 @@ static int handle_newconnect(FAR struct timeval *tv, int listen_fd)
 static void handle_read(struct connect_s *conn, struct timeval *tv)
 {
   httpd_conn *hc = conn->hc;
-  off_t actual;
   int sz;
 
   /* Is there room in our buffer to read more bytes? */
@@ -277,6 +292,16 @@ static void handle_read(struct connect_s *conn, struct timeval *tv)
   sz = read(hc->conn_fd, &(hc->read_buf[hc->read_idx]), hc->read_size - hc->read_idx);
   if (sz == 0)
     {
+#ifdef CONFIG_THTTPD_KEEPALIVE
+      if (conn->reused && hc->read_idx == 0)
+        {
+          /* The client closed a persistent connection between requests */
+
+          clear_connection(conn, tv);
+          return;
+        }
+#endif
+
       BADREQUEST("EOF");
       goto errout_with_400;
     }
@@ -302,86 +327,134 @@ static void handle_read(struct connect_s *conn, struct timeval *tv)
   hc->read_idx += sz;
   conn->active_at = tv->tv_sec;
 
-  /* Do we have a complete request yet? */
+  handle_request(conn, tv);
+  return;
 
-  switch (httpd_got_request(hc))
-    {
-    case GR_NO_REQUEST:
-      return;
-    case GR_BAD_REQUEST:
-     BADREQUEST("httpd_got_request");
-     goto errout_with_400;
-    }
+errout_with_400:
+  BADREQUEST("errout");
+  httpd_send_err(hc, 400, httpd_err400title, "", httpd_err400form, "");
+  finish_connection(conn, tv);
+}
+
+/* Process the request(s) read so far on a connection.  With keep-alive,
+ * there may be several pipelined requests in hc->read_buf; the ones which
+ * need no file to be sent are answered here in turn.
+ */
 
-  /* Yes.  Try parsing and resolving it */
+static void handle_request(struct connect_s *conn, struct timeval *tv)
+{
+  httpd_conn *hc = conn->hc;
+  off_t actual;
 
-  if (httpd_parse_request(hc) < 0)
+  for (;;)
     {
-      goto errout_with_connection;
-    }
+      /* Do we have a complete request yet? */
 
-  /* Start the connection going */
+      switch (httpd_got_request(hc))
+        {
+        case GR_NO_REQUEST:
+          return;
+        case GR_BAD_REQUEST:
+         BADREQUEST("httpd_got_request");
+         goto errout_with_400;
+        }
 
-  if (httpd_start_request(hc, tv) < 0)
-    {
-      /* Something went wrong.  Close down the connection */
+      /* Yes.  Try parsing and resolving it */
 
-      goto errout_with_connection;
-    }
+      if (httpd_parse_request(hc) < 0)
+        {
+          goto errout_with_connection;
+        }
 
-  /* Set up the file offsets to read */
+      /* Start the connection going */
 
-  conn->eof            = false;
-  if (hc->got_range)
-    {
-      conn->offset     = hc->range_start;
-      conn->end_offset = hc->range_end + 1;
-    }
-  else
-    {
-      conn->offset     = 0;
-      if (hc->bytes_to_send < 0)
+      if (httpd_start_request(hc, tv) < 0)
         {
-          conn->end_offset = 0;
+          /* Something went wrong.  Close down the connection */
+
+          goto errout_with_connection;
+        }
+
+      /* Set up the file offsets to read */
+
+      conn->eof            = false;
+      if (hc->got_range)
+        {
+          conn->offset     = hc->range_start;
+          conn->end_offset = hc->range_end + 1;
         }
       else
         {
-          conn->end_offset = hc->bytes_to_send;
+          conn->offset     = 0;
+          if (hc->bytes_to_send < 0)
+            {
+              conn->end_offset = 0;
+            }
+          else
+            {
+              conn->end_offset = hc->bytes_to_send;
+            }
         }
-    }
 
-  /* Check if it's already handled */
+      /* Check if it's already handled */
 
-  if (hc->file_fd < 0)
-    {
-      /* No file descriptor means someone else is handling it */
+#ifdef CONFIG_THTTPD_FILE_CACHE
+      if (hc->file_fd < 0 && hc->cache == NULL)
+#else
+      if (hc->file_fd < 0)
+#endif
+        {
+          /* No file descriptor means someone else is handling it */
 
-      conn->offset = hc->bytes_sent;
-      goto errout_with_connection;
-    }
+          conn->offset = hc->bytes_sent;
+        }
+      else if (conn->offset < conn->end_offset)
+        {
+          /* There is a file to send */
 
-  if (conn->offset >= conn->end_offset)
-    {
-      /* There's nothing to send */
+          break;
+        }
 
-      goto errout_with_connection;
+      /* There's nothing (more) to send.  Go on with the next request if
+       * the connection is kept open.
+       */
+
+      if (!finish_request(conn, tv))
+        {
+          return;
+        }
     }
 
-  /* Seek to the offset of the next byte to send */
+#if defined(CONFIG_THTTPD_SENDFILE)
+  conn->zerocopy = true;
+#elif defined(CONFIG_THTTPD_FILE_CACHE)
+  conn->zerocopy = (hc->cache != NULL);
+#else
+  conn->zerocopy = false;
+#endif
 
-  actual = lseek(hc->file_fd, conn->offset, SEEK_SET);
-  if (actual != conn->offset)
+  if (!conn->zerocopy)
     {
-       nerr("ERROR: fseek to %d failed: offset=%d errno=%d\n",
-            conn->offset, actual, errno);
-       BADREQUEST("lseek");
-       goto errout_with_400;
+      /* Seek to the offset of the next byte to send */
+
+      actual = lseek(hc->file_fd, conn->offset, SEEK_SET);
+      if (actual != conn->offset)
+        {
+           nerr("ERROR: fseek to %d failed: offset=%d errno=%d\n",
+                conn->offset, actual, errno);
+           BADREQUEST("lseek");
+           goto errout_with_400;
+        }
     }
 
-  /* We have a valid connection and a file to send to it */
+  /* We have a valid connection and a file to send to it.  The response
+   * header is still in hc->buffer; send it first, then the file as the
+   * connection becomes writable.
+   */
 
+  conn->hdrlen     = hc->buflen;
   conn->conn_state = CNST_SENDING;
-  fdwatch_del_fd(fw, hc->conn_fd);
+  fdwatch_set_write(fw, hc->conn_fd, true);
   return;
 
 errout_with_400:
@@ -397,16 +470,28 @@ static inline int read_buffer(struct connect_s *conn)
 {
   httpd_conn *hc = conn->hc;
   ssize_t nread = 0;
+  off_t pending;
+  off_t remaining;
+  size_t nbytes;
+
+  /* Never read beyond the end of the range to send */
 
-  if (hc->buflen < CONFIG_THTTPD_IOBUFFERSIZE && !conn->eof)
+  pending   = hc->buflen - conn->hdrlen;
+  remaining = conn->end_offset - conn->offset - pending;
+  nbytes    = CONFIG_THTTPD_IOBUFFERSIZE - hc->buflen;
+  if ((off_t)nbytes > remaining)
     {
-      nread = read(hc->file_fd, &hc->buffer[hc->buflen],
-                   CONFIG_THTTPD_IOBUFFERSIZE - hc->buflen);
+      nbytes = remaining > 0 ? remaining : 0;
+    }
+
+  if (nbytes > 0 && !conn->eof)
+    {
+      nread = read(hc->file_fd, &hc->buffer[hc->buflen], nbytes);
       if (nread == 0)
         {
           /* Reading zero bytes means we are at the end of file */
 
-          conn->end_offset = conn->offset;
+          conn->end_offset = conn->offset + pending;
           conn->eof        = true;
         }
       else if (nread > 0)
@@ -417,64 +502,142 @@ static inline int read_buffer(struct connect_s *conn)
   return nread;
 }
 
+#if defined(CONFIG_THTTPD_SENDFILE) || defined(CONFIG_THTTPD_FILE_CACHE)
+/* Send file data without copying it through hc->buffer */
+
+static ssize_t send_direct(struct connect_s *conn, size_t nbytes)
+{
+  httpd_conn *hc = conn->hc;
+#ifdef CONFIG_THTTPD_SENDFILE
+  off_t offset;
+#endif
+
+#ifdef CONFIG_THTTPD_FILE_CACHE
+  if (hc->cache != NULL)
+    {
+      return write(hc->conn_fd, &hc->cache->data[conn->offset], nbytes);
+    }
+#endif
+
+#ifdef CONFIG_THTTPD_SENDFILE
+  offset = conn->offset;
+  return sendfile(hc->conn_fd, hc->file_fd, &offset, nbytes);
+#else
+  errno = EBADF;
+  return -1;
+#endif
+}
+#endif
+
 static void handle_send(struct connect_s *conn, struct timeval *tv)
 {
   httpd_conn *hc = conn->hc;
-  int nwritten;
+  size_t budget = CONFIG_THTTPD_SEND_SLICE;
+  ssize_t nwritten;
+  size_t nheader;
+  bool buffered;
   int nread;
 
-  /* Read until the entire file is sent -- this could take awhile!! */
+  /* Send until the socket would block or the slice is used up, then
+   * return to service the other connections.
+   */
 
-  while (conn->offset < conn->end_offset)
+  while (budget > 0)
     {
       ninfo("offset: %d end_offset: %d bytes_sent: %d\n",
             conn->offset, conn->end_offset, conn->hc->bytes_sent);
 
       /* Fill the rest of the response buffer with file data */
 
-      nread = read_buffer(conn);
-      if (nread < 0)
+      if (!conn->zerocopy)
         {
-          nerr("ERROR: File read error: %d\n", errno);
-          goto errout_clear_connection;
+          nread = read_buffer(conn);
+          if (nread < 0)
+            {
+              nerr("ERROR: File read error: %d\n", errno);
+              goto errout_clear_connection;
+            }
+          ninfo("Read %d bytes, buflen %d\n", nread, hc->buflen);
         }
-      ninfo("Read %d bytes, buflen %d\n", nread, hc->buflen);
 
-      /* Send the buffer */
+      /* Send the buffer (the response header and, unless file data is sent
+       * directly, the file data read so far), then the file data.
+       */
 
-      if (hc->buflen > 0)
+      buffered = hc->buflen > 0;
+      if (buffered)
         {
-          /* httpd_write does not return until all bytes have been sent
-           * (or an error occurs).
-           */
+          nwritten = write(hc->conn_fd, hc->buffer, hc->buflen);
+        }
+#if defined(CONFIG_THTTPD_SENDFILE) || defined(CONFIG_THTTPD_FILE_CACHE)
+      else if (conn->zerocopy && conn->offset < conn->end_offset)
+        {
+          nwritten = send_direct(conn, MIN(budget, conn->end_offset - conn->offset));
+          if (nwritten == 0)
+            {
+              /* The file was truncated while being sent */
+
+              conn->end_offset = conn->offset;
+            }
+        }
+#endif
+      else
+        {
+          break;
+        }
 
-          nwritten = httpd_write(hc->conn_fd, hc->buffer, hc->buflen);
-          if (nwritten < 0)
+      if (nwritten < 0)
+        {
+          if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
             {
-              nerr("ERROR: Error sending %s: %d\n",
-                   hc->encodedurl, errno);
-              goto errout_clear_connection;
+              /* Wait until the socket is writable again */
+
+              return;
             }
 
-          /* We wrote one full buffer of data (httpd_write does not
-           * return until the full buffer is written (or an error occurs).
-           */
+          nerr("ERROR: Error sending %s: %d\n",
+               hc->encodedurl, errno);
+          goto errout_clear_connection;
+        }
 
-          conn->active_at       = tv->tv_sec;
-          hc->buflen            = 0;
+      conn->active_at = tv->tv_sec;
+      budget         -= MIN(budget, (size_t)nwritten);
 
-          /* And update how much of the file we wrote */
+      /* Account only for the file data that went out */
 
-          conn->offset         += nwritten;
-          conn->hc->bytes_sent += nwritten;
-          ninfo("Wrote %d bytes\n", nwritten);
+      nheader = 0;
+      if (buffered)
+        {
+          nheader       = MIN((size_t)nwritten, conn->hdrlen);
+          conn->hdrlen -= nheader;
+          hc->buflen   -= nwritten;
+          if (hc->buflen > 0)
+            {
+              memmove(hc->buffer, &hc->buffer[nwritten], hc->buflen);
+            }
         }
+
+      conn->offset         += nwritten - nheader;
+      conn->hc->bytes_sent += nwritten - nheader;
+      ninfo("Wrote %d bytes\n", nwritten);
     }
 
-  /* The file transfer is complete -- finish the connection */
+  if (hc->buflen > 0 || conn->offset < conn->end_offset)
+    {
+      /* More to send the next time the socket is writable */
 
-  ninfo("Finish connection\n");
-  finish_connection(conn, tv);
+      return;
+    }
+
+  /* The file transfer is complete -- finish the request, and serve any
+   * request which was pipelined behind it.
+   */
+
+  ninfo("Finish request\n");
+  if (finish_request(conn, tv) && hc->read_idx > 0)
+    {
+      handle_request(conn, tv);
+    }
   return;
 
 errout_clear_connection:
@@ -504,6 +667,36 @@ static void handle_linger(struct connect_s *conn, struct timeval *tv)
     }
 }
 
+/* The response to the current request has been sent.  Returns true if the
+ * connection was kept open for the next request, false if it was closed.
+ */
+
+static bool finish_request(struct connect_s *conn, struct timeval *tv)
+{
+#ifdef CONFIG_THTTPD_KEEPALIVE
+  httpd_conn *hc = conn->hc;
+
+  if (hc->do_keep_alive)
+    {
+      /* If we haven't actually sent the buffered response yet, do so now */
+
+      httpd_write_response(hc);
+      (void)httpd_keepalive_conn(hc);
+
+      conn->conn_state = CNST_READING;
+      conn->active_at  = tv->tv_sec;
+      conn->offset     = 0;
+      conn->hdrlen     = 0;
+      conn->reused     = true;
+      fdwatch_set_write(fw, hc->conn_fd, false);
+      return true;
+    }
+#endif
+
+  finish_connection(conn, tv);
+  return false;
+}
+
 static void finish_connection(struct connect_s *conn, struct timeval *tv)
 {
   /* If we haven't actually sent the buffered response yet, do so now */
@@ -595,6 +788,19 @@ static void idle(ClientData client_data, struct timeval *nowP)
       switch (conn->conn_state)
         {
         case CNST_READING:
+#ifdef CONFIG_THTTPD_KEEPALIVE
+          if (conn->reused && conn->hc->read_idx == 0)
+            {
+              /* Waiting for the next request on a persistent connection */
+
+              if (nowP->tv_sec - conn->active_at >= CONFIG_THTTPD_KEEPALIVE_TIMEOUT_SEC)
+                {
+                  clear_connection(conn, nowP);
+                }
+              break;
+            }
+#endif
+
           if (nowP->tv_sec - conn->active_at >= CONFIG_THTTPD_IDLE_READ_LIMIT_SEC)
             {
               nerr("ERROR: %s connection timed out reading\n",
@@ -835,9 +1041,8 @@ int thttpd_main(int argc, char **argv)
 
                       case CNST_SENDING:
                         {
-                          /* Send a file -- this really should be performed on a
-                           * separate thread to keep the serve from locking up during
-                           * the write.
+                          /* Send the next slice of the file.  The socket is
+                           * polled for output until the whole file is sent.
                            */
 
                           handle_send(conn, &tv);
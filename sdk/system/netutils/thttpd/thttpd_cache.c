@@ -0,0 +1,262 @@
+/****************************************************************************
+ * system/netutils/thttpd/thttpd_cache.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <debug.h>
+
+#include "config.h"
+#include "libhttpd.h"
+#include "thttpd_alloc.h"
+#include "thttpd_cache.h"
+
+#if defined(CONFIG_THTTPD) && defined(CONFIG_THTTPD_FILE_CACHE)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Cached files, most recently used first */
+
+static FAR struct httpd_cache_s *g_cache_head;
+static FAR struct httpd_cache_s *g_cache_tail;
+
+/* Number of file bytes held by the cache */
+
+static size_t g_cache_bytes;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void cache_unlink(FAR struct httpd_cache_s *entry)
+{
+  if (entry->blink)
+    {
+      entry->blink->flink = entry->flink;
+    }
+  else
+    {
+      g_cache_head = entry->flink;
+    }
+
+  if (entry->flink)
+    {
+      entry->flink->blink = entry->blink;
+    }
+  else
+    {
+      g_cache_tail = entry->blink;
+    }
+
+  entry->flink = NULL;
+  entry->blink = NULL;
+}
+
+static void cache_link_head(FAR struct httpd_cache_s *entry)
+{
+  entry->blink = NULL;
+  entry->flink = g_cache_head;
+  if (g_cache_head)
+    {
+      g_cache_head->blink = entry;
+    }
+  else
+    {
+      g_cache_tail = entry;
+    }
+
+  g_cache_head = entry;
+}
+
+/* Remove an entry from the cache.  It is freed now if no connection is
+ * sending it, otherwise when the last connection releases it.
+ */
+
+static void cache_drop(FAR struct httpd_cache_s *entry)
+{
+  cache_unlink(entry);
+  g_cache_bytes -= entry->size;
+  entry->stale   = true;
+
+  if (entry->refs == 0)
+    {
+      httpd_free(entry);
+    }
+}
+
+/* Drop least recently used entries until 'size' more bytes fit */
+
+static bool cache_make_room(size_t size)
+{
+  FAR struct httpd_cache_s *entry;
+  FAR struct httpd_cache_s *prev;
+
+  for (entry = g_cache_tail;
+       entry != NULL && g_cache_bytes + size > CONFIG_THTTPD_FILE_CACHE_SIZE;
+       entry = prev)
+    {
+      prev = entry->blink;
+      if (entry->refs == 0)
+        {
+          ninfo("Evict %s\n", entry->path);
+          cache_drop(entry);
+        }
+    }
+
+  return g_cache_bytes + size <= CONFIG_THTTPD_FILE_CACHE_SIZE;
+}
+
+static FAR struct httpd_cache_s *cache_load(FAR const char *path,
+                                            FAR const struct stat *sb)
+{
+  FAR struct httpd_cache_s *entry;
+  size_t pathlen = strlen(path) + 1;
+  int fd;
+  int nread;
+
+  entry = (FAR struct httpd_cache_s *)
+    httpd_malloc(sizeof(struct httpd_cache_s) + pathlen + sb->st_size);
+  if (entry == NULL)
+    {
+      return NULL;
+    }
+
+  entry->path  = (FAR char *)&entry[1];
+  entry->data  = (FAR uint8_t *)entry->path + pathlen;
+  entry->size  = sb->st_size;
+  entry->mtime = sb->st_mtime;
+  entry->refs  = 0;
+  entry->stale = false;
+  memcpy(entry->path, path, pathlen);
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0)
+    {
+      httpd_free(entry);
+      return NULL;
+    }
+
+  nread = httpd_read(fd, entry->data, entry->size);
+  (void)close(fd);
+
+  if (nread != entry->size)
+    {
+      nerr("ERROR: Short read of %s: %d\n", path, nread);
+      httpd_free(entry);
+      return NULL;
+    }
+
+  return entry;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+FAR struct httpd_cache_s *httpd_cache_get(FAR const char *path,
+                                          FAR const struct stat *sb)
+{
+  FAR struct httpd_cache_s *entry;
+
+  if (sb->st_size <= 0 || sb->st_size > CONFIG_THTTPD_FILE_CACHE_MAXFILE)
+    {
+      return NULL;
+    }
+
+  for (entry = g_cache_head; entry != NULL; entry = entry->flink)
+    {
+      if (strcmp(entry->path, path) == 0)
+        {
+          break;
+        }
+    }
+
+  if (entry != NULL)
+    {
+      if (entry->size == sb->st_size && entry->mtime == sb->st_mtime)
+        {
+          /* Hit: move it to the head of the LRU list */
+
+          cache_unlink(entry);
+          cache_link_head(entry);
+          entry->refs++;
+          return entry;
+        }
+
+      /* The file has changed since it was cached */
+
+      cache_drop(entry);
+    }
+
+  if (!cache_make_room(sb->st_size))
+    {
+      return NULL;
+    }
+
+  entry = cache_load(path, sb);
+  if (entry == NULL)
+    {
+      return NULL;
+    }
+
+  ninfo("Cache %s (%d bytes)\n", path, (int)entry->size);
+
+  cache_link_head(entry);
+  g_cache_bytes += entry->size;
+  entry->refs = 1;
+  return entry;
+}
+
+void httpd_cache_release(FAR struct httpd_cache_s *entry)
+{
+  if (--entry->refs == 0 && entry->stale)
+    {
+      httpd_free(entry);
+    }
+}
+
+#endif /* CONFIG_THTTPD && CONFIG_THTTPD_FILE_CACHE */
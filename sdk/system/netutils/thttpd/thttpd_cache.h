@@ -0,0 +1,93 @@
+/****************************************************************************
+ * system/netutils/thttpd/thttpd_cache.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __NETUTILS_THTTPD_THTTPD_CACHE_H
+#define __NETUTILS_THTTPD_THTTPD_CACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "config.h"
+
+#if defined(CONFIG_THTTPD) && defined(CONFIG_THTTPD_FILE_CACHE)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One cached file.  The file contents follow the path name in the same
+ * allocation.
+ */
+
+struct httpd_cache_s
+{
+  FAR struct httpd_cache_s *flink;  /* Next entry, less recently used */
+  FAR struct httpd_cache_s *blink;  /* Previous entry, more recently used */
+  FAR char *path;                   /* Expanded file name */
+  FAR uint8_t *data;                /* File contents */
+  off_t size;                       /* File size */
+  time_t mtime;                     /* File modification time */
+  uint16_t refs;                    /* Number of connections sending it */
+  bool stale;                       /* Dropped, free on the last release */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Return the cached contents of the file 'path' whose attributes are 'sb',
+ * reading the file into the cache if it is not there yet.  Returns NULL if
+ * the file is too large to be cached, or if there is not enough room.  The
+ * entry is held until httpd_cache_release() is called.
+ */
+
+FAR struct httpd_cache_s *httpd_cache_get(FAR const char *path,
+                                          FAR const struct stat *sb);
+
+/* Release an entry returned by httpd_cache_get() */
+
+void httpd_cache_release(FAR struct httpd_cache_s *entry);
+
+#endif /* CONFIG_THTTPD && CONFIG_THTTPD_FILE_CACHE */
+#endif /* __NETUTILS_THTTPD_THTTPD_CACHE_H */
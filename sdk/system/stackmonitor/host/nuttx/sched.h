@@ -0,0 +1,68 @@
+/****************************************************************************
+ * system/stackmonitor/host/nuttx/sched.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* The part of the task control block used by the profiler.  The simulation
+ * provides sched_foreach() over its own tasks.
+ */
+
+#ifndef __SYSTEM_STACKMONITOR_HOST_NUTTX_SCHED_H
+#define __SYSTEM_STACKMONITOR_HOST_NUTTX_SCHED_H
+
+#include <sys/types.h>
+#include <stdint.h>
+
+enum tstate_e
+{
+  TSTATE_TASK_INVALID = 0,
+  TSTATE_TASK_PENDING,
+  TSTATE_TASK_READYTORUN,
+  TSTATE_TASK_RUNNING,
+  TSTATE_TASK_INACTIVE,
+  TSTATE_WAIT_SEM
+};
+
+struct tcb_s
+{
+  pid_t pid;
+  uint8_t sched_priority;
+  uint8_t task_state;
+  char name[CONFIG_TASK_NAME_SIZE + 1];
+};
+
+typedef void (*sched_foreach_t)(FAR struct tcb_s *tcb, FAR void *arg);
+
+void sched_foreach(sched_foreach_t handler, FAR void *arg);
+
+#endif /* __SYSTEM_STACKMONITOR_HOST_NUTTX_SCHED_H */
@@ -0,0 +1,69 @@
+/****************************************************************************
+ * system/stackmonitor/host/sdk/config.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Minimal configuration for building the profiler on the host. */
+
+#ifndef __SYSTEM_STACKMONITOR_HOST_SDK_CONFIG_H
+#define __SYSTEM_STACKMONITOR_HOST_SDK_CONFIG_H
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#define OK    0
+#define ERROR -1
+#define FAR
+
+#define CONFIG_SYSTEM_STACKMONITOR          1
+#define CONFIG_SYSTEM_STACKMONITOR_PROFILER 1
+#define CONFIG_SCHED_INSTRUMENTATION        1
+#define CONFIG_TASK_NAME_SIZE               15
+
+/* The simulated clock counts nanoseconds */
+
+#define CONFIG_SYSTEM_STACKMONITOR_PROF_HZ  1000000000
+
+/* The profiler looks for the calling task */
+
+pid_t sim_getpid(void);
+#define getpid sim_getpid
+
+/* Not in the host C library before glibc 2.38 */
+
+size_t sim_strlcpy(FAR char *dst, FAR const char *src, size_t size);
+#define strlcpy sim_strlcpy
+
+#endif /* __SYSTEM_STACKMONITOR_HOST_SDK_CONFIG_H */
@@ -0,0 +1,748 @@
+/****************************************************************************
+ * system/stackmonitor/host/stkprofsim.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host simulation of the stkprof profiler.  A priority scheduler runs a
+ *   set of periodic tasks in virtual time and calls the instrumentation
+ *   hooks and the tick hook as NuttX does, while keeping its own record of
+ *   CPU time, switches, waits and PC samples.  The records are compared
+ *   with the binary export of the profiler.
+ *
+ *   With -r a reader thread saves the profile while it is recording,
+ *   which pauses sampling, so samples are not compared.  The cost of the
+ *   hooks is measured afterwards by calling them in a loop.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/sched_note.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "stkprof.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SIM_NTASKS     8
+#define SIM_US         1000ull        /* Virtual clock counts ns */
+#define SIM_IDLE       0
+
+#define SIM_PC(pid, r) (0x08000000u + (pid) * 0x1000u + ((r) % 16) * 4)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct simtask_s
+{
+  struct tcb_s tcb;
+  uint64_t period;             /* 0: never blocks */
+  uint64_t work;               /* Per period */
+  uint64_t born;               /* Task is created */
+  uint64_t dies;               /* Task exits, 0 for never */
+  bool alive;
+
+  uint64_t wakeup;             /* Next release */
+  uint64_t remain;             /* Work left in this period */
+  uint64_t seq;                /* Order in the ready list */
+
+  struct stkprof_task_s truth; /* Expected record */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static pthread_mutex_t g_critsect = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+static struct simtask_s g_tasks[SIM_NTASKS] =
+{
+  /* pid, prio, name; period, work, born, dies */
+
+  { { 0,   0, 0, "Idle" },   0,                    0,            0, 0 },
+  { { 1, 100, 0, "nsh" },    0,                    0,            0, 0 },
+  { { 3, 200, 0, "audio" },  1000 * SIM_US,   150 * SIM_US,      0, 0 },
+  { { 4, 150, 0, "sensor" }, 5000 * SIM_US,   700 * SIM_US,      0, 0 },
+  { { 5, 100, 0, "net" },    20000 * SIM_US, 4000 * SIM_US,      0, 0 },
+  { { 6,  50, 0, "bg" },     100000 * SIM_US, 40000 * SIM_US,    0, 0 },
+  { { 7, 120, 0, "worker" }, 3000 * SIM_US,   500 * SIM_US,
+    2000000 * SIM_US, 6000000 * SIM_US },
+  { { 39, 120, 0, "worker2" }, 7000 * SIM_US, 900 * SIM_US,
+    3000000 * SIM_US, 0 },
+};
+
+static uint64_t g_now;
+static uint64_t g_seq;
+static uint32_t g_rand = 1;
+static struct simtask_s *g_running;
+static bool g_profiling;
+
+static uint32_t g_tickus = 10000;
+static uint32_t g_seconds = 10;
+static bool g_reader;
+static bool g_done;
+
+/* Expected totals */
+
+static uint64_t g_cycles;
+static uint32_t g_switches;
+static uint32_t g_nsamples;
+static struct stkprof_sample_s g_samples[CONFIG_SYSTEM_STACKMONITOR_PROF_NSAMPLES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t sim_rand(void)
+{
+  g_rand = g_rand * 1103515245 + 12345;
+  return g_rand >> 16;
+}
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* Expected records, kept the way the profiler defines them */
+
+static void truth_ready(struct simtask_s *t)
+{
+  if ((t->truth.flags & STKPROF_READY) == 0)
+    {
+      t->truth.flags  |= STKPROF_READY;
+      t->truth.readyts = (uint32_t)g_now;
+    }
+}
+
+static void truth_resume(struct simtask_s *t)
+{
+  uint32_t wait;
+  int b;
+
+  g_switches++;
+  t->truth.switches++;
+
+  if (t->truth.flags & STKPROF_READY)
+    {
+      t->truth.flags &= ~STKPROF_READY;
+      wait = (uint32_t)g_now - t->truth.readyts;
+
+      for (b = 0; b < STKPROF_NBUCKETS - 1 &&
+                  (wait >> (STKPROF_HISTSHIFT + b)) != 0; b++);
+
+      t->truth.hist[b]++;
+      t->truth.waits++;
+      if (wait > t->truth.maxwait)
+        {
+          t->truth.maxwait = wait;
+        }
+    }
+}
+
+/* Scheduler */
+
+static struct simtask_s *sim_highest(void)
+{
+  struct simtask_s *best = NULL;
+  struct simtask_s *t;
+  int i;
+
+  for (i = 0; i < SIM_NTASKS; i++)
+    {
+      t = &g_tasks[i];
+      if (t->alive && t->tcb.task_state == TSTATE_TASK_READYTORUN &&
+          (!best || t->tcb.sched_priority > best->tcb.sched_priority ||
+           (t->tcb.sched_priority == best->tcb.sched_priority &&
+            t->seq < best->seq)))
+        {
+          best = t;
+        }
+    }
+
+  return best;
+}
+
+static void sim_makeready(struct simtask_s *t)
+{
+  t->tcb.task_state = TSTATE_TASK_READYTORUN;
+  t->seq = g_seq++;
+}
+
+/* Switch to the highest ready task.  old is still ready when preempted,
+ * blocked when waiting, or gone when it exited.
+ */
+
+static void sim_switch(bool exited)
+{
+  struct simtask_s *old = g_running;
+  struct simtask_s *next = sim_highest();
+
+  if (!exited && old->tcb.task_state == TSTATE_TASK_RUNNING)
+    {
+      if (!next || next->tcb.sched_priority <= old->tcb.sched_priority)
+        {
+          return;
+        }
+
+      sim_makeready(old);
+    }
+
+  if (!exited)
+    {
+      sched_note_suspend(&old->tcb);
+      if (g_profiling && old->tcb.task_state == TSTATE_TASK_READYTORUN)
+        {
+          old->truth.preempted++;
+          truth_ready(old);
+        }
+    }
+
+  next->tcb.task_state = TSTATE_TASK_RUNNING;
+  g_running = next;
+
+  sched_note_resume(&next->tcb);
+  if (g_profiling)
+    {
+      truth_resume(next);
+    }
+}
+
+static void sim_advance(uint64_t to)
+{
+  uint64_t dt = to - g_now;
+
+  if (g_running->period > 0)
+    {
+      g_running->remain -= dt;
+    }
+
+  if (g_profiling)
+    {
+      g_running->truth.cycles += dt;
+      g_cycles += dt;
+    }
+
+  g_now = to;
+}
+
+static void sim_tick(void)
+{
+  uint32_t pc = SIM_PC(g_running->tcb.pid, sim_rand());
+  struct simtask_s *t;
+  int i;
+
+  stkprof_tick(pc);
+
+  if (!g_profiling)
+    {
+      return;
+    }
+
+  g_samples[g_nsamples % CONFIG_SYSTEM_STACKMONITOR_PROF_NSAMPLES].pc = pc;
+  g_samples[g_nsamples % CONFIG_SYSTEM_STACKMONITOR_PROF_NSAMPLES].pid =
+    g_running->tcb.pid;
+  g_nsamples++;
+
+  for (i = 0; i < SIM_NTASKS; i++)
+    {
+      t = &g_tasks[i];
+      if (t->alive && t->tcb.task_state == TSTATE_TASK_READYTORUN)
+        {
+          truth_ready(t);
+        }
+    }
+}
+
+static void sim_run(uint64_t end)
+{
+  struct simtask_s *t;
+  uint64_t nexttick = g_tickus * SIM_US;
+  uint64_t next;
+  int i;
+
+  while (g_now < end)
+    {
+      /* Next event: tick, release, birth, death or end of work */
+
+      next = nexttick;
+      for (i = 0; i < SIM_NTASKS; i++)
+        {
+          t = &g_tasks[i];
+          if (!t->alive && t->born > g_now && t->born < next)
+            {
+              next = t->born;
+            }
+
+          if (t->alive && t->dies > 0 && t->dies < next)
+            {
+              next = t->dies;
+            }
+
+          if (t->alive && t->period > 0 && t->wakeup < next)
+            {
+              next = t->wakeup;
+            }
+        }
+
+      if (g_running->period > 0 && g_now + g_running->remain < next)
+        {
+          next = g_now + g_running->remain;
+        }
+
+      enter_critical_section();
+
+      sim_advance(next);
+
+      /* Work done, wait for the next period */
+
+      if (g_running->period > 0 && g_running->remain == 0)
+        {
+          g_running->tcb.task_state = TSTATE_WAIT_SEM;
+          sim_switch(false);
+        }
+
+      for (i = 0; i < SIM_NTASKS; i++)
+        {
+          t = &g_tasks[i];
+          if (!t->alive && t->born == g_now && g_now > 0)
+            {
+              t->alive  = true;
+              t->wakeup = g_now + t->period;
+              t->remain = t->work;
+              sim_makeready(t);
+              sched_note_start(&t->tcb);
+              sim_switch(false);
+            }
+          else if (t->alive && t->dies == g_now)
+            {
+              sched_note_stop(&t->tcb);
+              t->alive = false;
+              t->tcb.task_state = TSTATE_TASK_INACTIVE;
+              if (t == g_running)
+                {
+                  sim_switch(true);
+                }
+            }
+          else if (t->alive && t->period > 0 && t->wakeup == g_now)
+            {
+              /* A release while still running is an overrun, the work
+               * adds up.
+               */
+
+              t->wakeup += t->period;
+              t->remain += t->work * (80 + sim_rand() % 41) / 100;
+              if (t->tcb.task_state == TSTATE_WAIT_SEM)
+                {
+                  sim_makeready(t);
+                  sim_switch(false);
+                }
+            }
+        }
+
+      if (g_now == nexttick)
+        {
+          sim_tick();
+          nexttick += g_tickus * SIM_US;
+        }
+
+      leave_critical_section(0);
+    }
+}
+
+static void sim_reset(void)
+{
+  struct simtask_s *t;
+  int i;
+
+  g_now = 0;
+  g_seq = 0;
+  g_rand = 1;
+  g_cycles = 0;
+  g_switches = 0;
+  g_nsamples = 0;
+
+  for (i = 0; i < SIM_NTASKS; i++)
+    {
+      t = &g_tasks[i];
+      memset(&t->truth, 0, sizeof(t->truth));
+      t->alive  = t->born == 0;
+
+      /* Not in phase with the tick, or the same task is always sampled */
+
+      t->wakeup = t->period + (t->period ? t->tcb.pid * 137 * SIM_US %
+                                           t->period : 0);
+      t->remain = t->work;
+      t->tcb.task_state = t->period > 0 ? TSTATE_WAIT_SEM :
+                                          TSTATE_TASK_READYTORUN;
+    }
+
+  /* nsh starts the profiler, then waits */
+
+  g_running = &g_tasks[1];
+  g_running->tcb.task_state = TSTATE_TASK_RUNNING;
+}
+
+static void sim_nshwait(void)
+{
+  enter_critical_section();
+  g_running->tcb.task_state = TSTATE_WAIT_SEM;
+  sim_switch(false);
+  leave_critical_section(0);
+}
+
+static void *reader_thread(void *arg)
+{
+  int fd = open("/dev/null", O_WRONLY);
+  bool done = false;
+
+  while (!done)
+    {
+      stkprof_save(fd);
+      usleep(1000);
+
+      enter_critical_section();
+      done = g_done;
+      leave_critical_section(0);
+    }
+
+  close(fd);
+  return NULL;
+}
+
+static void measure(void)
+{
+  struct simtask_s *a = &g_tasks[2];
+  struct simtask_s *b = &g_tasks[3];
+  uint64_t t0;
+  uint64_t sw;
+  uint64_t tick;
+  int i;
+
+  stkprof_start();
+
+  t0 = now_ns();
+  for (i = 0; i < 1000000; i++)
+    {
+      g_now += 1000;
+      a->tcb.task_state = TSTATE_TASK_READYTORUN;
+      sched_note_suspend(&a->tcb);
+      sched_note_resume(&b->tcb);
+      b->tcb.task_state = TSTATE_WAIT_SEM;
+      sched_note_suspend(&b->tcb);
+      sched_note_resume(&a->tcb);
+    }
+
+  sw = now_ns() - t0;
+
+  t0 = now_ns();
+  for (i = 0; i < 1000000; i++)
+    {
+      g_now += 1000;
+      stkprof_tick(i);
+    }
+
+  tick = now_ns() - t0;
+  stkprof_stop();
+
+  printf("hooks: %.1f ns per switch, %.1f ns per tick with %d tasks "
+         "on the host\n", sw / 2e6, tick / 1e6, SIM_NTASKS);
+}
+
+static int verify(const char *path)
+{
+  struct stkprof_header_s hdr;
+  struct stkprof_task_s rec;
+  struct stkprof_sample_s s;
+  struct simtask_s *t;
+  uint32_t first;
+  uint32_t i;
+  int ret = OK;
+  int j;
+  FILE *fp;
+
+  fp = fopen(path, "rb");
+  if (!fp || fread(&hdr, sizeof(hdr), 1, fp) != 1)
+    {
+      printf("verify: cannot read %s\n", path);
+      return ERROR;
+    }
+
+  if (hdr.magic != STKPROF_MAGIC || hdr.cycles != g_cycles ||
+      hdr.switches != g_switches || hdr.lost != 0)
+    {
+      printf("verify: header %08x %llu/%llu cycles %u/%u switches\n",
+             hdr.magic, (unsigned long long)hdr.cycles,
+             (unsigned long long)g_cycles, hdr.switches, g_switches);
+      ret = ERROR;
+    }
+
+  for (i = 0; i < hdr.ntasks; i++)
+    {
+      if (fread(&rec, sizeof(rec), 1, fp) != 1)
+        {
+          printf("verify: short file\n");
+          fclose(fp);
+          return ERROR;
+        }
+
+      for (j = 0; j < SIM_NTASKS && g_tasks[j].tcb.pid != rec.pid; j++);
+      if (j == SIM_NTASKS)
+        {
+          printf("verify: unknown pid %d\n", rec.pid);
+          ret = ERROR;
+          continue;
+        }
+
+      t = &g_tasks[j];
+      if (rec.cycles != t->truth.cycles ||
+          rec.switches != t->truth.switches ||
+          rec.preempted != t->truth.preempted ||
+          rec.waits != t->truth.waits ||
+          rec.maxwait != t->truth.maxwait ||
+          memcmp(rec.hist, t->truth.hist, sizeof(rec.hist)) != 0 ||
+          strcmp(rec.name, t->tcb.name) != 0 ||
+          ((rec.flags & STKPROF_EXITED) != 0) != (t->dies > 0 && !t->alive))
+        {
+          printf("verify: pid %d: %llu/%llu cycles, %u/%u switches, "
+                 "%u/%u preempted, %u/%u waits\n", rec.pid,
+                 (unsigned long long)rec.cycles,
+                 (unsigned long long)t->truth.cycles,
+                 rec.switches, t->truth.switches, rec.preempted,
+                 t->truth.preempted, rec.waits, t->truth.waits);
+          ret = ERROR;
+        }
+    }
+
+  if (hdr.ntasks != SIM_NTASKS)
+    {
+      printf("verify: %u tasks, expected %u\n", hdr.ntasks, SIM_NTASKS);
+      ret = ERROR;
+    }
+
+  /* Samples are the latest ones, oldest first */
+
+  first = g_nsamples > CONFIG_SYSTEM_STACKMONITOR_PROF_NSAMPLES ?
+          g_nsamples - CONFIG_SYSTEM_STACKMONITOR_PROF_NSAMPLES : 0;
+
+  for (i = 0; !g_reader && i < hdr.nsamples; i++)
+    {
+      struct stkprof_sample_s *e =
+        &g_samples[(first + i) % CONFIG_SYSTEM_STACKMONITOR_PROF_NSAMPLES];
+
+      if (fread(&s, sizeof(s), 1, fp) != 1 || s.pc != e->pc ||
+          s.pid != e->pid)
+        {
+          printf("verify: sample %u differs\n", i);
+          ret = ERROR;
+          break;
+        }
+    }
+
+  if (!g_reader && hdr.nsamples != g_nsamples - first)
+    {
+      printf("verify: %u samples, expected %u\n", hdr.nsamples,
+             g_nsamples - first);
+      ret = ERROR;
+    }
+
+  fclose(fp);
+  printf("verify: %s\n", ret == OK ? "OK" : "FAILED");
+  return ret;
+}
+
+static void show_usage(FAR const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-d <sec>] [-t <us>] [-r]\n", progname);
+  fprintf(stderr, "\t-d: Simulated seconds. Default: %u\n", g_seconds);
+  fprintf(stderr, "\t-t: Tick period in us. Default: %u\n", g_tickus);
+  fprintf(stderr, "\t-r: Read the profile while recording\n");
+  exit(errcode);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+irqstate_t enter_critical_section(void)
+{
+  pthread_mutex_lock(&g_critsect);
+  return 0;
+}
+
+void leave_critical_section(irqstate_t flags)
+{
+  pthread_mutex_unlock(&g_critsect);
+}
+
+void sched_foreach(sched_foreach_t handler, FAR void *arg)
+{
+  int i;
+
+  enter_critical_section();
+  for (i = 0; i < SIM_NTASKS; i++)
+    {
+      if (g_tasks[i].alive)
+        {
+          handler(&g_tasks[i].tcb, arg);
+        }
+    }
+
+  leave_critical_section(0);
+}
+
+uint32_t stkprof_cycles(void)
+{
+  return (uint32_t)g_now;
+}
+
+pid_t sim_getpid(void)
+{
+  return g_running->tcb.pid;
+}
+
+size_t sim_strlcpy(FAR char *dst, FAR const char *src, size_t size)
+{
+  size_t len = strlen(src);
+
+  if (size > 0)
+    {
+      size_t n = len < size - 1 ? len : size - 1;
+
+      memcpy(dst, src, n);
+      dst[n] = '\0';
+    }
+
+  return len;
+}
+
+int main(int argc, FAR char **argv)
+{
+  char path[64];
+  pthread_t reader;
+  int option;
+  int ret;
+  int fd;
+
+  while ((option = getopt(argc, argv, ":d:t:rh")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'd':
+            g_seconds = strtoul(optarg, NULL, 0);
+            break;
+
+          case 't':
+            g_tickus = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'r':
+            g_reader = true;
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (g_tickus == 0 || g_seconds == 0)
+    {
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+
+  sim_reset();
+  stkprof_start();
+  g_profiling = true;
+  sim_nshwait();
+
+  if (g_reader)
+    {
+      pthread_create(&reader, NULL, reader_thread, NULL);
+    }
+
+  sim_run((uint64_t)g_seconds * 1000000 * SIM_US);
+
+  enter_critical_section();
+  g_done = true;
+  leave_critical_section(0);
+
+  if (g_reader)
+    {
+      pthread_join(reader, NULL);
+    }
+
+  stkprof_stop();
+  stkprof_show();
+
+  printf("\n");
+
+  snprintf(path, sizeof(path), "/tmp/stkprof-%d.bin", (int)getpid());
+  fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  ret = fd >= 0 ? stkprof_save(fd) : -errno;
+  if (fd >= 0)
+    {
+      close(fd);
+    }
+
+  ret = ret == OK ? verify(path) : ERROR;
+  unlink(path);
+
+  measure();
+
+  return ret == OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -41,6 +41,9 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <sched.h>
 #include <syslog.h>
@@ -48,6 +51,10 @@
 
 #include <nuttx/arch.h>
 
+#ifdef CONFIG_SYSTEM_STACKMONITOR_PROFILER
+#  include "stkprof.h"
+#endif
+
 #ifdef CONFIG_SYSTEM_STACKMONITOR
 
 /****************************************************************************
@@ -196,4 +203,51 @@ int stackmonitor_stop(int argc, char **argv)
   return 0;
 }
 
+#ifdef CONFIG_SYSTEM_STACKMONITOR_PROFILER
+int stkprof_main(int argc, char **argv)
+{
+  int ret = OK;
+  int fd;
+
+  if (argc == 2 && strcmp(argv[1], "start") == 0)
+    {
+      stkprof_start();
+    }
+  else if (argc == 2 && strcmp(argv[1], "stop") == 0)
+    {
+      stkprof_stop();
+    }
+  else if (argc == 2 && strcmp(argv[1], "show") == 0)
+    {
+      ret = stkprof_show();
+    }
+  else if (argc == 3 && strcmp(argv[1], "save") == 0)
+    {
+      fd = open(argv[2], O_WRONLY | O_CREAT | O_TRUNC, 0666);
+      if (fd < 0)
+        {
+          ret = -errno;
+        }
+      else
+        {
+          ret = stkprof_save(fd);
+          close(fd);
+        }
+    }
+  else
+    {
+      printf("Usage: %s start|stop|show|save <file>\n", argv[0]);
+      return 1;
+    }
+
+  if (ret < 0)
+    {
+      printf("%s: %s failed: %d\n", argv[0], argv[1], ret);
+      return 1;
+    }
+
+  return 0;
+}
+#endif
+
 #endif /* CONFIG_SYSTEM_STACKMONITOR */
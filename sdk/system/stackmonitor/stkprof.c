@@ -0,0 +1,814 @@
+/****************************************************************************
+ * system/stackmonitor/stkprof.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/sched_note.h>
+
+#ifdef CONFIG_CXD56_SYSTICK_PCHOOK
+#  include <arch/chip/timer.h>
+#endif
+
+#include "stkprof.h"
+
+#ifdef CONFIG_SYSTEM_STACKMONITOR_PROFILER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NTASKS   CONFIG_SYSTEM_STACKMONITOR_PROF_NTASKS
+#define NSAMPLES CONFIG_SYSTEM_STACKMONITOR_PROF_NSAMPLES
+
+#define STKPROF_TOPPCS 10
+
+/* Cortex-M4 data watchpoint and trace unit, the cycle counter */
+
+#ifdef CONFIG_ARCH_CHIP_CXD56XX
+#  define DWT_CTRL       ((volatile uint32_t *)0xe0001000)
+#  define DWT_CYCCNT     ((volatile uint32_t *)0xe0001004)
+#  define DEMCR          ((volatile uint32_t *)0xe000edfc)
+#  define DWT_CYCCNTENA  (1 << 0)
+#  define DEMCR_TRCENA   (1 << 24)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct stkprof_s
+{
+  volatile bool enabled;
+  bool exporting;                   /* Samples are being read */
+
+  FAR struct stkprof_task_s *running;
+  uint32_t lastts;                  /* Cycles accounted up to */
+  uint64_t cycles;                  /* Profiled time */
+  uint32_t switches;
+  uint32_t lost;
+  uint32_t nsamples;                /* Samples taken, the ring wraps */
+  uint16_t ntasks;
+
+  struct timespec start;            /* For the cycle counter frequency */
+  struct timespec end;
+
+  struct stkprof_task_s tasks[NTASKS];
+#if NSAMPLES > 0
+  struct stkprof_sample_s samples[NSAMPLES];
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct stkprof_s g_stkprof;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stkprof_account
+ *
+ * Description:
+ *   Charge the cycles since the last event to the running task.  Called
+ *   often enough for the 32 bit counter not to wrap in between.
+ *
+ ****************************************************************************/
+
+static uint32_t stkprof_account(void)
+{
+  FAR struct stkprof_s *p = &g_stkprof;
+  uint32_t now = stkprof_cycles();
+  uint32_t delta = now - p->lastts;
+
+  p->cycles += delta;
+  if (p->running)
+    {
+      p->running->cycles += delta;
+    }
+
+  p->lastts = now;
+  return now;
+}
+
+/****************************************************************************
+ * Name: stkprof_init
+ ****************************************************************************/
+
+static void stkprof_init(FAR struct stkprof_task_s *t,
+                         FAR struct tcb_s *tcb)
+{
+  memset(t, 0, sizeof(struct stkprof_task_s));
+
+  t->pid      = tcb->pid;
+  t->priority = tcb->sched_priority;
+  t->flags    = STKPROF_USED;
+#if CONFIG_TASK_NAME_SIZE > 0
+  strlcpy(t->name, tcb->name, sizeof(t->name));
+#endif
+}
+
+/****************************************************************************
+ * Name: stkprof_lookup
+ *
+ * Description:
+ *   Find the record of a task, add it if it is not there yet.
+ *
+ ****************************************************************************/
+
+static FAR struct stkprof_task_s *stkprof_lookup(FAR struct tcb_s *tcb)
+{
+  FAR struct stkprof_s *p = &g_stkprof;
+  FAR struct stkprof_task_s *t;
+  int i = tcb->pid % NTASKS;
+  int n;
+
+  for (n = 0; n < NTASKS; n++)
+    {
+      t = &p->tasks[i];
+      if (t->flags == 0)
+        {
+          stkprof_init(t, tcb);
+          p->ntasks++;
+          return t;
+        }
+
+      if (t->pid == tcb->pid)
+        {
+          return t;
+        }
+
+      i = i + 1 < NTASKS ? i + 1 : 0;
+    }
+
+  p->lost++;
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: stkprof_register
+ ****************************************************************************/
+
+static void stkprof_register(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  (void)stkprof_lookup(tcb);
+}
+
+/****************************************************************************
+ * Name: stkprof_scanready
+ *
+ * Description:
+ *   Tasks made ready to run without preempting the running one are not
+ *   reported by the scheduler.  Their wait is measured from the first
+ *   tick they are seen ready.
+ *
+ ****************************************************************************/
+
+static void stkprof_scanready(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct stkprof_task_s *t;
+
+  if (tcb->task_state == TSTATE_TASK_READYTORUN ||
+      tcb->task_state == TSTATE_TASK_PENDING)
+    {
+      t = stkprof_lookup(tcb);
+      if (t && (t->flags & STKPROF_READY) == 0)
+        {
+          t->flags  |= STKPROF_READY;
+          t->readyts = *(FAR uint32_t *)arg;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: stkprof_hz
+ ****************************************************************************/
+
+static uint32_t stkprof_hz(FAR const struct timespec *end,
+                           uint64_t cycles)
+{
+  FAR struct stkprof_s *p = &g_stkprof;
+  uint64_t ns;
+
+  if (CONFIG_SYSTEM_STACKMONITOR_PROF_HZ > 0)
+    {
+      return CONFIG_SYSTEM_STACKMONITOR_PROF_HZ;
+    }
+
+  ns = (uint64_t)(end->tv_sec - p->start.tv_sec) * 1000000000ull +
+       end->tv_nsec - p->start.tv_nsec;
+
+  return ns > 0 ? (uint32_t)(cycles * 1000000000ull / ns) : 0;
+}
+
+/****************************************************************************
+ * Name: stkprof_snapshot
+ *
+ * Description:
+ *   Copy the used task records and the header.  Sampling is held off until
+ *   stkprof_release() so that the samples can be read in place.
+ *
+ ****************************************************************************/
+
+static FAR struct stkprof_task_s *
+stkprof_snapshot(FAR struct stkprof_header_s *hdr)
+{
+  FAR struct stkprof_s *p = &g_stkprof;
+  FAR struct stkprof_task_s *tasks;
+  struct timespec end;
+  irqstate_t flags;
+  int i;
+  int n;
+
+  tasks = (FAR struct stkprof_task_s *)
+    malloc(NTASKS * sizeof(struct stkprof_task_s));
+  if (!tasks)
+    {
+      return NULL;
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  flags = enter_critical_section();
+
+  if (p->enabled)
+    {
+      (void)stkprof_account();
+    }
+  else
+    {
+      end = p->end;
+    }
+
+  for (i = 0, n = 0; i < NTASKS; i++)
+    {
+      if (p->tasks[i].flags != 0)
+        {
+          tasks[n++] = p->tasks[i];
+        }
+    }
+
+  hdr->magic    = STKPROF_MAGIC;
+  hdr->version  = STKPROF_VERSION;
+  hdr->ntasks   = n;
+  hdr->cycles   = p->cycles;
+  hdr->switches = p->switches;
+  hdr->lost     = p->lost;
+  hdr->nsamples = p->nsamples < NSAMPLES ? p->nsamples : NSAMPLES;
+  p->exporting  = true;
+
+  leave_critical_section(flags);
+
+  hdr->hz = stkprof_hz(&end, hdr->cycles);
+  return tasks;
+}
+
+/****************************************************************************
+ * Name: stkprof_release
+ ****************************************************************************/
+
+static void stkprof_release(FAR struct stkprof_task_s *tasks)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  g_stkprof.exporting = false;
+  leave_critical_section(flags);
+
+  free(tasks);
+}
+
+#if NSAMPLES > 0
+/****************************************************************************
+ * Name: stkprof_sample
+ *
+ * Description:
+ *   Get the n-th oldest sample.
+ *
+ ****************************************************************************/
+
+static FAR struct stkprof_sample_s *stkprof_sample(uint32_t n)
+{
+  FAR struct stkprof_s *p = &g_stkprof;
+
+  if (p->nsamples > NSAMPLES)
+    {
+      n += p->nsamples;
+    }
+
+  return &p->samples[n % NSAMPLES];
+}
+
+/****************************************************************************
+ * Name: stkprof_comparepc
+ ****************************************************************************/
+
+static int stkprof_comparepc(FAR const void *a, FAR const void *b)
+{
+  uint32_t pa = *(FAR const uint32_t *)a;
+  uint32_t pb = *(FAR const uint32_t *)b;
+
+  return pa < pb ? -1 : pa > pb;
+}
+
+/****************************************************************************
+ * Name: stkprof_showpcs
+ *
+ * Description:
+ *   Print the most sampled PCs.  Resolve them with addr2line.
+ *
+ ****************************************************************************/
+
+static void stkprof_showpcs(uint32_t nsamples)
+{
+  uint32_t toppc[STKPROF_TOPPCS];
+  uint32_t topcount[STKPROF_TOPPCS];
+  FAR uint32_t *pcs;
+  uint32_t count;
+  uint32_t i;
+  int j;
+  int k;
+
+  pcs = (FAR uint32_t *)malloc(nsamples * sizeof(uint32_t));
+  if (!pcs || nsamples == 0)
+    {
+      free(pcs);
+      return;
+    }
+
+  for (i = 0; i < nsamples; i++)
+    {
+      pcs[i] = stkprof_sample(i)->pc;
+    }
+
+  qsort(pcs, nsamples, sizeof(uint32_t), stkprof_comparepc);
+
+  memset(topcount, 0, sizeof(topcount));
+  for (i = 0; i < nsamples; i += count)
+    {
+      for (count = 1; i + count < nsamples && pcs[i + count] == pcs[i];
+           count++);
+
+      for (j = 0; j < STKPROF_TOPPCS && topcount[j] >= count; j++);
+      if (j < STKPROF_TOPPCS)
+        {
+          for (k = STKPROF_TOPPCS - 1; k > j; k--)
+            {
+              toppc[k]    = toppc[k - 1];
+              topcount[k] = topcount[k - 1];
+            }
+
+          toppc[j]    = pcs[i];
+          topcount[j] = count;
+        }
+    }
+
+  free(pcs);
+
+  printf("%-10s %6s %6s\n", "PC", "COUNT", "%");
+  for (j = 0; j < STKPROF_TOPPCS && topcount[j] > 0; j++)
+    {
+      printf("0x%08lx %6lu %5lu%%\n", (unsigned long)toppc[j],
+             (unsigned long)topcount[j],
+             (unsigned long)(topcount[j] * 100 / nsamples));
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_note_*
+ *
+ * Description:
+ *   Scheduler instrumentation hooks, called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sched_note_start(FAR struct tcb_s *tcb)
+{
+  FAR struct stkprof_task_s *t;
+
+  if (g_stkprof.enabled)
+    {
+      /* A new task may reuse the pid of an exited one */
+
+      t = stkprof_lookup(tcb);
+      if (t && (t->flags & STKPROF_EXITED) != 0)
+        {
+          stkprof_init(t, tcb);
+        }
+    }
+}
+
+void sched_note_stop(FAR struct tcb_s *tcb)
+{
+  FAR struct stkprof_task_s *t;
+
+  if (g_stkprof.enabled)
+    {
+      t = stkprof_lookup(tcb);
+      if (t)
+        {
+          t->flags |= STKPROF_EXITED;
+        }
+    }
+}
+
+void sched_note_suspend(FAR struct tcb_s *tcb)
+{
+  FAR struct stkprof_s *p = &g_stkprof;
+  FAR struct stkprof_task_s *t;
+  uint32_t now;
+
+  if (!p->enabled)
+    {
+      return;
+    }
+
+  now = stkprof_account();
+  p->running = NULL;
+
+  /* Still ready to run means preempted, the wait starts now */
+
+  if (tcb->task_state == TSTATE_TASK_READYTORUN ||
+      tcb->task_state == TSTATE_TASK_PENDING)
+    {
+      t = stkprof_lookup(tcb);
+      if (t)
+        {
+          t->preempted++;
+          t->flags  |= STKPROF_READY;
+          t->readyts = now;
+        }
+    }
+}
+
+void sched_note_resume(FAR struct tcb_s *tcb)
+{
+  FAR struct stkprof_s *p = &g_stkprof;
+  FAR struct stkprof_task_s *t;
+  uint32_t wait;
+  uint32_t now;
+  int b;
+
+  if (!p->enabled)
+    {
+      return;
+    }
+
+  now = stkprof_account();
+  p->switches++;
+
+  t = stkprof_lookup(tcb);
+  p->running = t;
+  if (!t)
+    {
+      return;
+    }
+
+  t->switches++;
+  if (tcb->sched_priority > t->priority)
+    {
+      t->priority = tcb->sched_priority;
+    }
+
+  if (t->flags & STKPROF_READY)
+    {
+      t->flags &= ~STKPROF_READY;
+      wait = now - t->readyts;
+
+      b = (wait >> STKPROF_HISTSHIFT) == 0 ? 0 :
+          32 - __builtin_clz(wait >> STKPROF_HISTSHIFT);
+      t->hist[b < STKPROF_NBUCKETS ? b : STKPROF_NBUCKETS - 1]++;
+      t->waits++;
+
+      if (wait > t->maxwait)
+        {
+          t->maxwait = wait;
+        }
+    }
+}
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
+void sched_note_premption(FAR struct tcb_s *tcb, bool locked)
+{
+}
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
+void sched_note_csection(FAR struct tcb_s *tcb, bool enter)
+{
+}
+#endif
+
+/****************************************************************************
+ * Name: board_systick_pchook, board_timerhook
+ *
+ * Description:
+ *   Timer tick.  The CXD56xx system timer reports the interrupted PC, other
+ *   chips only have the tick.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_CXD56_SYSTICK_PCHOOK)
+void board_systick_pchook(uint32_t pc)
+{
+  stkprof_tick(pc);
+}
+#elif defined(CONFIG_SYSTEMTICK_HOOK)
+void board_timerhook(void)
+{
+  stkprof_tick(0);
+}
+#endif
+
+/****************************************************************************
+ * Name: stkprof_cycles
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_CHIP_CXD56XX
+uint32_t stkprof_cycles(void)
+{
+  return *DWT_CYCCNT;
+}
+#endif
+
+/****************************************************************************
+ * Name: stkprof_tick
+ ****************************************************************************/
+
+void stkprof_tick(uint32_t pc)
+{
+  FAR struct stkprof_s *p = &g_stkprof;
+  uint32_t now;
+
+  if (!p->enabled)
+    {
+      return;
+    }
+
+  now = stkprof_account();
+
+#if NSAMPLES > 0
+  if (!p->exporting)
+    {
+      FAR struct stkprof_sample_s *s = &p->samples[p->nsamples % NSAMPLES];
+
+      s->pc  = pc;
+      s->pid = p->running ? p->running->pid : -1;
+      p->nsamples++;
+    }
+#endif
+
+  sched_foreach(stkprof_scanready, &now);
+}
+
+/****************************************************************************
+ * Name: stkprof_start
+ ****************************************************************************/
+
+void stkprof_start(void)
+{
+  FAR struct stkprof_s *p = &g_stkprof;
+  irqstate_t flags;
+  pid_t self = getpid();
+  int i;
+
+#ifdef CONFIG_ARCH_CHIP_CXD56XX
+  *DEMCR    |= DEMCR_TRCENA;
+  *DWT_CTRL |= DWT_CYCCNTENA;
+#endif
+
+  flags = enter_critical_section();
+
+  memset(p, 0, sizeof(struct stkprof_s));
+  clock_gettime(CLOCK_MONOTONIC, &p->start);
+
+  /* Known tasks first, the caller is running */
+
+  sched_foreach(stkprof_register, NULL);
+
+  for (i = 0; i < NTASKS; i++)
+    {
+      if (p->tasks[i].flags != 0 && p->tasks[i].pid == self)
+        {
+          p->running = &p->tasks[i];
+        }
+    }
+
+  p->lastts  = stkprof_cycles();
+  p->enabled = true;
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: stkprof_stop
+ ****************************************************************************/
+
+void stkprof_stop(void)
+{
+  FAR struct stkprof_s *p = &g_stkprof;
+  struct timespec end;
+  irqstate_t flags;
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  flags = enter_critical_section();
+
+  if (p->enabled)
+    {
+      (void)stkprof_account();
+      p->enabled = false;
+      p->running = NULL;
+      p->end     = end;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: stkprof_show
+ ****************************************************************************/
+
+int stkprof_show(void)
+{
+  FAR struct stkprof_task_s *tasks;
+  FAR struct stkprof_task_s *t;
+  struct stkprof_header_s hdr;
+  uint32_t cycles;
+  uint32_t us;
+  int i;
+  int b;
+
+  tasks = stkprof_snapshot(&hdr);
+  if (!tasks)
+    {
+      return -ENOMEM;
+    }
+
+  us = hdr.hz ? (uint32_t)(hdr.cycles * 1000000ull / hdr.hz) : 0;
+  printf("%lu.%06lu sec, %lu Hz, %lu switches, %lu samples, %lu lost\n",
+         (unsigned long)(us / 1000000), (unsigned long)(us % 1000000),
+         (unsigned long)hdr.hz, (unsigned long)hdr.switches,
+         (unsigned long)hdr.nsamples, (unsigned long)hdr.lost);
+
+  printf("%5s %3s %6s %7s %7s %7s %9s %s\n", "PID", "PRI", "CPU%",
+         "SWITCH", "PREEMPT", "WAITS", "MAXWAIT", "NAME");
+
+  for (i = 0; i < hdr.ntasks; i++)
+    {
+      t = &tasks[i];
+      cycles = hdr.cycles ? (uint32_t)(t->cycles * 10000 / hdr.cycles) : 0;
+      us = hdr.hz ? (uint32_t)((uint64_t)t->maxwait * 1000000 / hdr.hz) : 0;
+
+      printf("%5d %3d %3lu.%02lu %7lu %7lu %7lu %7luus %s%s\n",
+             t->pid, t->priority, (unsigned long)(cycles / 100),
+             (unsigned long)(cycles % 100), (unsigned long)t->switches,
+             (unsigned long)t->preempted, (unsigned long)t->waits,
+             (unsigned long)us, t->name,
+             t->flags & STKPROF_EXITED ? " (exited)" : "");
+    }
+
+  /* Wait histogram, upper bucket bounds in us */
+
+  printf("\n%5s", "WAIT<");
+  for (b = 0; b < STKPROF_NBUCKETS - 1; b++)
+    {
+      us = hdr.hz ?
+        (uint32_t)((1000000ull << (STKPROF_HISTSHIFT + b)) / hdr.hz) : 0;
+      printf(" %5lu", (unsigned long)us);
+    }
+
+  printf("   more\n");
+
+  for (i = 0; i < hdr.ntasks; i++)
+    {
+      t = &tasks[i];
+      if (t->waits == 0)
+        {
+          continue;
+        }
+
+      printf("%5d", t->pid);
+      for (b = 0; b < STKPROF_NBUCKETS; b++)
+        {
+          printf(" %5lu", (unsigned long)t->hist[b]);
+        }
+
+      printf("\n");
+    }
+
+#if NSAMPLES > 0
+  printf("\n");
+  stkprof_showpcs(hdr.nsamples);
+#endif
+
+  stkprof_release(tasks);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stkprof_save
+ ****************************************************************************/
+
+int stkprof_save(int fd)
+{
+  FAR struct stkprof_task_s *tasks;
+  struct stkprof_header_s hdr;
+  size_t len;
+  int ret = OK;
+#if NSAMPLES > 0
+  uint32_t first;
+  uint32_t n;
+#endif
+
+  tasks = stkprof_snapshot(&hdr);
+  if (!tasks)
+    {
+      return -ENOMEM;
+    }
+
+  len = hdr.ntasks * sizeof(struct stkprof_task_s);
+  if (write(fd, &hdr, sizeof(hdr)) != (ssize_t)sizeof(hdr) ||
+      write(fd, tasks, len) != (ssize_t)len)
+    {
+      ret = -errno;
+    }
+
+#if NSAMPLES > 0
+  /* Oldest samples first, at most two runs of the ring */
+
+  first = g_stkprof.nsamples > NSAMPLES ? g_stkprof.nsamples % NSAMPLES : 0;
+  for (n = 0; ret == OK && n < hdr.nsamples; n += len)
+    {
+      len = NSAMPLES - (first + n) % NSAMPLES;
+      len = len < hdr.nsamples - n ? len : hdr.nsamples - n;
+
+      if (write(fd, stkprof_sample(n), len * sizeof(struct stkprof_sample_s))
+          != (ssize_t)(len * sizeof(struct stkprof_sample_s)))
+        {
+          ret = -errno;
+        }
+    }
+#endif
+
+  stkprof_release(tasks);
+  return ret;
+}
+
+#endif /* CONFIG_SYSTEM_STACKMONITOR_PROFILER */
@@ -0,0 +1,187 @@
+/****************************************************************************
+ * system/stackmonitor/stkprof.h
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __SYSTEM_STACKMONITOR_STKPROF_H
+#define __SYSTEM_STACKMONITOR_STKPROF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SYSTEM_STACKMONITOR_PROF_NTASKS
+#  define CONFIG_SYSTEM_STACKMONITOR_PROF_NTASKS 32
+#endif
+
+#ifndef CONFIG_SYSTEM_STACKMONITOR_PROF_NSAMPLES
+#  define CONFIG_SYSTEM_STACKMONITOR_PROF_NSAMPLES 512
+#endif
+
+#ifndef CONFIG_SYSTEM_STACKMONITOR_PROF_HZ
+#  define CONFIG_SYSTEM_STACKMONITOR_PROF_HZ 0
+#endif
+
+#define STKPROF_MAGIC      0x46525053  /* "SPRF" */
+#define STKPROF_VERSION    1
+
+#define STKPROF_NAMESIZE   16
+
+/* Wait histogram.  Bucket 0 counts waits below 2^STKPROF_HISTSHIFT
+ * cycles, bucket n waits below 2^(STKPROF_HISTSHIFT + n) cycles, the last
+ * bucket everything longer.
+ */
+
+#define STKPROF_NBUCKETS   16
+#define STKPROF_HISTSHIFT  10
+
+/* Task flags */
+
+#define STKPROF_USED       (1 << 0)
+#define STKPROF_READY      (1 << 1)  /* Ready to run since readyts */
+#define STKPROF_EXITED     (1 << 2)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Binary export: a header, the used task records and the PC samples
+ * oldest first, in target byte order.
+ */
+
+struct stkprof_header_s
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t ntasks;                  /* Task records following */
+  uint32_t hz;                      /* Cycles per second */
+  uint32_t nsamples;                /* PC samples following */
+  uint64_t cycles;                  /* Profiled time */
+  uint32_t switches;                /* Context switches */
+  uint32_t lost;                    /* Events of tasks not in the table */
+};
+
+struct stkprof_task_s
+{
+  uint64_t cycles;                  /* CPU time */
+  uint32_t switches;                /* Times switched in */
+  uint32_t preempted;               /* Times switched out while ready */
+  uint32_t waits;                   /* Waits in the histogram */
+  uint32_t maxwait;                 /* Longest wait in cycles */
+  uint32_t hist[STKPROF_NBUCKETS];  /* Ready to running wait */
+  uint32_t readyts;
+  int16_t pid;
+  uint8_t priority;
+  uint8_t flags;
+  char name[STKPROF_NAMESIZE];
+};
+
+struct stkprof_sample_s
+{
+  uint32_t pc;                      /* Interrupted instruction */
+  int16_t pid;                      /* Running task, -1 if unknown */
+  uint16_t reserved;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stkprof_start
+ *
+ * Description:
+ *   Clear the buffer and start recording.
+ *
+ ****************************************************************************/
+
+void stkprof_start(void);
+
+/****************************************************************************
+ * Name: stkprof_stop
+ ****************************************************************************/
+
+void stkprof_stop(void);
+
+/****************************************************************************
+ * Name: stkprof_tick
+ *
+ * Description:
+ *   Account the running task and record a PC sample.  Called from the
+ *   timer interrupt.
+ *
+ ****************************************************************************/
+
+void stkprof_tick(uint32_t pc);
+
+/****************************************************************************
+ * Name: stkprof_show
+ *
+ * Description:
+ *   Print the text summary to stdout.
+ *
+ ****************************************************************************/
+
+int stkprof_show(void);
+
+/****************************************************************************
+ * Name: stkprof_save
+ *
+ * Description:
+ *   Write the binary export to a file descriptor.
+ *
+ ****************************************************************************/
+
+int stkprof_save(int fd);
+
+/****************************************************************************
+ * Name: stkprof_cycles
+ *
+ * Description:
+ *   Free running 32 bit cycle counter, provided by the platform.
+ *
+ ****************************************************************************/
+
+uint32_t stkprof_cycles(void);
+
+#endif /* __SYSTEM_STACKMONITOR_STKPROF_H */
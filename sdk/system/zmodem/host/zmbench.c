@@ -0,0 +1,314 @@
+/****************************************************************************
+ * system/zmodem/host/zmbench.c
+ *
+ *   Copyright 2019 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Description:
+ *   Host throughput benchmark for the Zmodem sender/receiver.  A pseudo
+ *   terminal pair is created, a child process receives on the slave side
+ *   with zmr_receive() and the parent sends a generated file on the master
+ *   side with zms_send().  The elapsed time, the throughput and the result
+ *   of comparing the received file with the original are reported.
+ *
+ *   The received file is stored in CONFIG_SYSTEM_ZMODEM_MOUNTPOINT.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <time.h>
+#include <signal.h>
+#include <errno.h>
+
+#include "system/zmodem.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ZMBENCH_FILENAME  "zmbench.dat"
+#define ZMBENCH_DEFSIZE   (1024 * 1024)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(FAR const char *progname, int errcode)
+{
+  fprintf(stderr, "USAGE: %s [-s <size>] [-t] [-h]\n", progname);
+  fprintf(stderr, "\t-s <size>: Number of bytes to transfer. Default: %d\n",
+                  ZMBENCH_DEFSIZE);
+  fprintf(stderr, "\t-t: Send text-like data (few escaped bytes) instead "
+                  "of random data\n");
+  fprintf(stderr, "\t-h: Show this text and exit\n");
+  exit(errcode);
+}
+
+static int make_file(FAR const char *path, size_t size, bool text)
+{
+  uint8_t buffer[4096];
+  uint32_t seed = 0x12345678;
+  size_t remaining;
+  size_t i;
+  int fd;
+
+  fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    {
+      return -errno;
+    }
+
+  for (remaining = size; remaining > 0; )
+    {
+      size_t n = remaining < sizeof(buffer) ? remaining : sizeof(buffer);
+
+      for (i = 0; i < n; i++)
+        {
+          seed = seed * 1103515245 + 12345;
+          buffer[i] = text ? (uint8_t)(' ' + (seed >> 16) % 95) :
+                             (uint8_t)(seed >> 16);
+        }
+
+      if (write(fd, buffer, n) != (ssize_t)n)
+        {
+          close(fd);
+          return -EIO;
+        }
+
+      remaining -= n;
+    }
+
+  close(fd);
+  return OK;
+}
+
+static int compare_files(FAR const char *path1, FAR const char *path2)
+{
+  uint8_t buf1[4096];
+  uint8_t buf2[4096];
+  ssize_t n1;
+  ssize_t n2;
+  int fd1;
+  int fd2;
+  int ret = ERROR;
+
+  fd1 = open(path1, O_RDONLY);
+  fd2 = open(path2, O_RDONLY);
+  if (fd1 >= 0 && fd2 >= 0)
+    {
+      do
+        {
+          n1 = read(fd1, buf1, sizeof(buf1));
+          n2 = read(fd2, buf2, sizeof(buf2));
+          if (n1 != n2 || (n1 > 0 && memcmp(buf1, buf2, n1) != 0))
+            {
+              break;
+            }
+        }
+      while (n1 > 0);
+
+      if (n1 == 0 && n2 == 0)
+        {
+          ret = OK;
+        }
+    }
+
+  if (fd1 >= 0)
+    {
+      close(fd1);
+    }
+
+  if (fd2 >= 0)
+    {
+      close(fd2);
+    }
+
+  return ret;
+}
+
+static int receiver(FAR const char *slavename)
+{
+  ZMRHANDLE handle;
+  int ret;
+  int fd;
+
+  fd = open(slavename, O_RDWR | O_NOCTTY);
+  if (fd < 0)
+    {
+      fprintf(stderr, "ERROR: Failed to open %s: %d\n", slavename, errno);
+      return EXIT_FAILURE;
+    }
+
+  handle = zmr_initialize(fd);
+  if (!handle)
+    {
+      close(fd);
+      return EXIT_FAILURE;
+    }
+
+  ret = zmr_receive(handle);
+  (void)zmr_release(handle);
+  close(fd);
+
+  return ret < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, FAR char **argv)
+{
+  FAR const char *slavename;
+  ZMSHANDLE handle;
+  struct timespec start;
+  struct timespec end;
+  struct termios tio;
+  char srcpath[64];
+  char dstpath[128];
+  size_t size = ZMBENCH_DEFSIZE;
+  bool text = false;
+  double elapsed;
+  pid_t pid;
+  int status;
+  int master;
+  int option;
+  int ret;
+
+  while ((option = getopt(argc, argv, ":s:th")) != ERROR)
+    {
+      switch (option)
+        {
+          case 's':
+            size = strtoul(optarg, NULL, 0);
+            break;
+
+          case 't':
+            text = true;
+            break;
+
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+
+          default:
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  snprintf(srcpath, sizeof(srcpath), "/tmp/zmbench-%d.src", (int)getpid());
+  snprintf(dstpath, sizeof(dstpath), "%s/%s",
+           CONFIG_SYSTEM_ZMODEM_MOUNTPOINT, ZMBENCH_FILENAME);
+  unlink(dstpath);
+
+  ret = make_file(srcpath, size, text);
+  if (ret < 0)
+    {
+      fprintf(stderr, "ERROR: Failed to create %s: %d\n", srcpath, ret);
+      return EXIT_FAILURE;
+    }
+
+  /* Create the pseudo terminal pair */
+
+  master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0 ||
+      (slavename = ptsname(master)) == NULL)
+    {
+      fprintf(stderr, "ERROR: Failed to create a pty pair: %d\n", errno);
+      unlink(srcpath);
+      return EXIT_FAILURE;
+    }
+
+  /* Binary transparent line discipline.  This must be set before the
+   * sender starts, otherwise the slave side echoes the "rz\r" prologue.
+   */
+
+  tcgetattr(master, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(master, TCSANOW, &tio);
+
+  pid = fork();
+  if (pid == 0)
+    {
+      close(master);
+      exit(receiver(slavename));
+    }
+
+  handle = zms_initialize(master);
+  if (!handle)
+    {
+      fprintf(stderr, "ERROR: Failed to get Zmodem handle\n");
+      kill(pid, SIGTERM);
+      unlink(srcpath);
+      return EXIT_FAILURE;
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  ret = zms_send(handle, srcpath, ZMBENCH_FILENAME, XM_XFERTYPE_BINARY,
+                 XM_OPTION_REPLACE, false);
+  (void)zms_release(handle);
+  waitpid(pid, &status, 0);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  elapsed = (double)(end.tv_sec - start.tv_sec) +
+            (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+  printf("%s: %lu bytes in %.3f sec: %.1f KiB/sec (%s data)\n",
+         ret < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ?
+         "FAILED" : "sent", (unsigned long)size, elapsed,
+         (double)size / 1024.0 / elapsed, text ? "text" : "random");
+
+  ret = compare_files(srcpath, dstpath);
+  printf("verify: %s\n", ret == OK ? "OK" : "MISMATCH");
+
+  close(master);
+  unlink(srcpath);
+  unlink(dstpath);
+  return ret == OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
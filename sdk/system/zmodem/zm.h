@@ -218,6 +218,24 @@
 
 #define ZM_PKTBUFSIZE (CONFIG_SYSTEM_ZMODEM_PKTBUFSIZE + 5)
 
+/* Number of unacknowledged bytes the sender may stream with ZCRCG before
+ * it asks for a ZACK with ZCRCQ (only when the receiver reports CANFDX and
+ * CANOVIO without a receive buffer limit).
+ */
+
+#ifndef CONFIG_SYSTEM_ZMODEM_SNDWINDOW
+#  define CONFIG_SYSTEM_ZMODEM_SNDWINDOW 4096
+#endif
+
+/* CRC routines.  With CONFIG_SYSTEM_ZMODEM_FASTCRC, the slice-by-8 versions
+ * in zm_crc.c are used instead of the byte-wise library routines.
+ */
+
+#ifndef CONFIG_SYSTEM_ZMODEM_FASTCRC
+#  define zm_crc16part(s,l,c) crc16part(s,l,c)
+#  define zm_crc32part(s,l,c) crc32part(s,l,c)
+#endif
+
 /* Debug Definitions ********************************************************/
 
 /* Non-standard debug selectable with CONFIG_DEBUG_ZMODEM.  Debug output goes
@@ -415,6 +433,12 @@ struct zms_state_s
   off_t zrpos;               /* Last offset from ZRPOS */
   off_t filesize;            /* Size of the file to send */
   int infd;                  /* Local input file descriptor */
+
+  /* File data read for the packet being composed.  Each byte may expand to
+   * two when escaped, so half of the send buffer is enough.
+   */
+
+  uint8_t rdbuf[CONFIG_SYSTEM_ZMODEM_SNDBUFSIZE / 2];
 };
 
 /****************************************************************************
@@ -577,6 +601,20 @@ int zm_writefile(int fd, FAR const uint8_t *buffer, size_t buflen, bool zcnl);
 
 uint32_t zm_filecrc(FAR struct zm_state_s *pzm, FAR const char *filename);
 
+/****************************************************************************
+ * Name: zm_crc16part and zm_crc32part
+ *
+ * Description:
+ *   Continue a CRC-16 (ZBIN) or CRC-32 (ZBIN32) calculation on a part of a
+ *   buffer.  Same results as crc16part() and crc32part().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSTEM_ZMODEM_FASTCRC
+uint16_t zm_crc16part(FAR const uint8_t *src, size_t len, uint16_t crc16val);
+uint32_t zm_crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val);
+#endif
+
 /****************************************************************************
  * Name: zm_putzdle
  *
@@ -593,6 +631,28 @@ uint32_t zm_filecrc(FAR struct zm_state_s *pzm, FAR const char *filename);
 FAR uint8_t *zm_putzdle(FAR struct zm_state_s *pzm, FAR uint8_t *buffer,
                         uint8_t ch);
 
+/****************************************************************************
+ * Name: zm_putzdlebuf
+ *
+ * Description:
+ *   Transfer a buffer of values performing ZDLE escaping where necessary.
+ *   Runs of characters that never need escaping are copied as a block.
+ *   The destination must have room for 2 * buflen bytes.
+ *
+ * Input Parameters:
+ *   pzm    - Zmodem session state
+ *   buffer - Buffer in which to add the possibly escaped characters
+ *   src    - The raw, unescaped characters to be added
+ *   buflen - The number of characters in src
+ *
+ * Returned Value:
+ *   The position in buffer following the last character added.
+ *
+ ****************************************************************************/
+
+FAR uint8_t *zm_putzdlebuf(FAR struct zm_state_s *pzm, FAR uint8_t *buffer,
+                           FAR const uint8_t *src, size_t buflen);
+
 /****************************************************************************
  * Name: zm_senddata
  *
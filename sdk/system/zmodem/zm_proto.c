@@ -44,6 +44,7 @@
 #include <sdk/config.h>
 
 #include <stdio.h>
+#include <string.h>
 #include <crc16.h>
 #include <crc32.h>
 
@@ -53,6 +54,64 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Character classes for ZDLE escaping (see g_zdletab) */
+
+#define ZM_ZDLE_ALWAYS  (1 << 0)  /* ZDLE, DLE, XON, XOFF, GS (+/- 8th bit) */
+#define ZM_ZDLE_CTRL    (1 << 1)  /* Control character, escaped on request */
+#define ZM_ZDLE_CR      (1 << 2)  /* CR, escaped when following '@' */
+#define ZM_ZDLE_AT      (1 << 3)  /* '@' */
+
+#ifndef CONFIG_SYSTEM_ZMODEM_DISABLE_ZRUB
+#  define ZM_ZDLE_DEL   ZM_ZDLE_ALWAYS
+#else
+#  define ZM_ZDLE_DEL   0
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* ZDLE escape classification of each character value.  A zero entry never
+ * needs escaping and does not affect the '@' tracking, so runs of such
+ * characters can be copied to the output as they are.
+ */
+
+static const uint8_t g_zdletab[256] =
+{
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  /* 0x00 */
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02,
+  0x03, 0x03, 0x02, 0x03, 0x02, 0x02, 0x02, 0x02,  /* 0x10 */
+  0x03, 0x02, 0x02, 0x02, 0x02, 0x03, 0x02, 0x02,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 0x20 */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 0x30 */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 0x40 */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 0x50 */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 0x60 */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 0x70 */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, ZM_ZDLE_DEL,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  /* 0x80 */
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02,
+  0x03, 0x03, 0x02, 0x03, 0x02, 0x02, 0x02, 0x02,  /* 0x90 */
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x03, 0x02, 0x02,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 0xa0 */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 0xb0 */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 0xc0 */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 0xd0 */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 0xe0 */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 0xf0 */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, ZM_ZDLE_DEL
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -104,7 +163,7 @@ const uint8_t g_canistr[CANISTR_SIZE] =
 FAR uint8_t *zm_putzdle(FAR struct zm_state_s *pzm, FAR uint8_t *buffer,
                         uint8_t ch)
 {
-  uint8_t ch7 = ch & 0x7f;
+  uint8_t cls = g_zdletab[ch];
 
   /* Check if this character requires ZDLE escaping.
    *
@@ -112,20 +171,9 @@ FAR uint8_t *zm_putzdle(FAR struct zm_state_s *pzm, FAR uint8_t *buffer,
    * following '@' be escaped.
    */
 
-  if (ch   == ZDLE ||
-      ch7  == ASCII_DLE ||
-      ch7  == ASCII_DC1 ||
-      ch7  == ASCII_DC3 ||
-      ch7  == ASCII_GS ||
-      (ch7 == '\r' && (pzm->flags & ZM_FLAG_ATSIGN)  != 0) ||
-#ifndef CONFIG_SYSTEM_ZMODEM_DISABLE_ZRUB
-      (ch7 <  ' '  && (pzm->flags & ZM_FLAG_ESCCTRL) != 0) ||
-      ch7  == ASCII_DEL ||
-      ch   == 0xff
-#else
-      (ch7 <  ' '  && (pzm->flags & ZM_FLAG_ESCCTRL) != 0)
-#endif /* CONFIG_SYSTEM_ZMODEM_DISABLE_ZRUB */
-      )
+  if ((cls & ZM_ZDLE_ALWAYS) != 0 ||
+      ((cls & ZM_ZDLE_CR) != 0 && (pzm->flags & ZM_FLAG_ATSIGN) != 0) ||
+      ((cls & ZM_ZDLE_CTRL) != 0 && (pzm->flags & ZM_FLAG_ESCCTRL) != 0))
     {
       /* Yes... save the data link escape the character */
 
@@ -153,7 +201,7 @@ FAR uint8_t *zm_putzdle(FAR struct zm_state_s *pzm, FAR uint8_t *buffer,
 
   /* Check if the character is the AT sign */
 
-  if (ch7 == '@')
+  if ((cls & ZM_ZDLE_AT) != 0)
     {
       pzm->flags |= ZM_FLAG_ATSIGN;
     }
@@ -165,6 +213,55 @@ FAR uint8_t *zm_putzdle(FAR struct zm_state_s *pzm, FAR uint8_t *buffer,
   return buffer;
 }
 
+/****************************************************************************
+ * Name: zm_putzdlebuf
+ *
+ * Description:
+ *   Transfer a buffer of values performing ZDLE escaping where necessary.
+ *   Runs of characters that never need escaping are copied as a block.
+ *   The destination must have room for 2 * buflen bytes.
+ *
+ * Input Parameters:
+ *   pzm    - Zmodem session state
+ *   buffer - Buffer in which to add the possibly escaped characters
+ *   src    - The raw, unescaped characters to be added
+ *   buflen - The number of characters in src
+ *
+ * Returned Value:
+ *   The position in buffer following the last character added.
+ *
+ ****************************************************************************/
+
+FAR uint8_t *zm_putzdlebuf(FAR struct zm_state_s *pzm, FAR uint8_t *buffer,
+                           FAR const uint8_t *src, size_t buflen)
+{
+  FAR const uint8_t *end = src + buflen;
+  FAR const uint8_t *run;
+
+  while (src < end)
+    {
+      /* Find the run of characters that need no escaping and copy it */
+
+      for (run = src; src < end && g_zdletab[*src] == 0; src++);
+
+      if (src > run)
+        {
+          memcpy(buffer, run, src - run);
+          buffer     += src - run;
+          pzm->flags &= ~ZM_FLAG_ATSIGN;
+        }
+
+      /* The character that ended the run may need escaping */
+
+      if (src < end)
+        {
+          buffer = zm_putzdle(pzm, buffer, *src++);
+        }
+    }
+
+  return buffer;
+}
+
 /****************************************************************************
  * Name: zm_senddata
  *
@@ -208,19 +305,16 @@ int zm_senddata(FAR struct zm_state_s *pzm, FAR const uint8_t *buffer,
 
   /* Transfer the data to the I/O buffer, accumulating the CRC */
 
-  while (buflen-- > 0)
+  if (zbin == ZBIN)
     {
-      if (zbin == ZBIN)
-        {
-          crc = (uint32_t)crc16part(buffer, 1, (uint16_t)crc);
-        }
-      else /* zbin = ZBIN32 */
-        {
-          crc = crc32part(buffer, 1, crc);
-        }
-
-      ptr = zm_putzdle(pzm, ptr, *buffer++);
+      crc = (uint32_t)zm_crc16part(buffer, buflen, (uint16_t)crc);
     }
+  else /* zbin = ZBIN32 */
+    {
+      crc = zm_crc32part(buffer, buflen, crc);
+    }
+
+  ptr = zm_putzdlebuf(pzm, ptr, buffer, buflen);
 
   /* Trasnfer the data link escape character (without updating the CRC) */
 
@@ -230,11 +324,11 @@ int zm_senddata(FAR struct zm_state_s *pzm, FAR const uint8_t *buffer,
 
   if (zbin == ZBIN)
     {
-      crc = (uint32_t)crc16part((FAR const uint8_t *)&term, 1, (uint16_t)crc);
+      crc = (uint32_t)zm_crc16part((FAR const uint8_t *)&term, 1, (uint16_t)crc);
     }
   else
     {
-      crc = crc32part((FAR const uint8_t *)&term, 1, crc);
+      crc = zm_crc32part((FAR const uint8_t *)&term, 1, crc);
     }
 
   *ptr++ = term;
@@ -305,12 +399,12 @@ int zm_sendhexhdr(FAR struct zm_state_s *pzm, int type,
 
   /* type */
 
-  crc = crc16part((FAR const uint8_t *)&type, 1, 0);
+  crc = zm_crc16part((FAR const uint8_t *)&type, 1, 0);
   ptr = zm_puthex8(ptr, type);
 
   /* f3/p0 f2/p1 f1/p2 f0/p3 */
 
-  crc = crc16part(buffer, 4, crc);
+  crc = zm_crc16part(buffer, 4, crc);
   for (i = 0; i < 4; i++)
     {
       ptr = zm_puthex8(ptr, *buffer++);
@@ -382,12 +476,12 @@ int zm_sendbin16hdr(FAR struct zm_state_s *pzm, int type,
 
   /* type */
 
-  crc = crc16part((FAR const uint8_t *)&type, 1, 0);
+  crc = zm_crc16part((FAR const uint8_t *)&type, 1, 0);
   ptr = zm_putzdle(pzm, ptr, type);
 
   /* f3/p0 f2/p1 f1/p2 f0/p3 */
 
-  crc = crc16part(buffer, 4, crc);
+  crc = zm_crc16part(buffer, 4, crc);
   for (i = 0; i < 4; i++)
     {
       ptr = zm_putzdle(pzm, ptr, *buffer++);
@@ -449,11 +543,11 @@ int zm_sendbin32hdr(FAR struct zm_state_s *pzm, int type,
   /* type */
 
   ptr = zm_putzdle(pzm, ptr, type);
-  crc = crc32part((FAR const uint8_t *)&type, 1, 0xffffffffL);
+  crc = zm_crc32part((FAR const uint8_t *)&type, 1, 0xffffffffL);
 
   /* f3/p0 f2/p1 f1/p2 f0/p3 */
 
-  crc = crc32part(buffer, 4, crc);
+  crc = zm_crc32part(buffer, 4, crc);
   for (i = 0; i < 4; i++)
     {
       ptr = zm_putzdle(pzm, ptr, *buffer++);
@@ -163,6 +163,7 @@ static int zms_error(FAR struct zm_state_s *pzm);
 
 /* Internal helpers */
 
+static int32_t zms_window(FAR struct zms_state_s *pzms);
 static int zms_startfiledata(FAR struct zms_state_s *pzms);
 static int zms_sendfile(FAR struct zms_state_s *pzms, FAR const char *filename,
                         FAR const char *rfilename, uint8_t f0, uint8_t f1);
@@ -862,18 +863,26 @@ static int zms_sendpacket(FAR struct zm_state_s *pzm)
 {
   FAR struct zms_state_s *pzms = (FAR struct zms_state_s *)pzm;
   ssize_t nwritten;
+  ssize_t nread;
   int32_t unacked;
+  int32_t window;
   bool bcrc32;
+  bool eof;
   uint32_t crc;
   uint8_t by[4];
   uint8_t *ptr;
   uint8_t type;
-  bool wait = false;
   int sndsize;
   int pktsize;
-  int ret;
+  int avail;
   int i;
 
+  /* The number of unacknowledged bytes that may be outstanding.  Zero means
+   * that there is no limit.
+   */
+
+  window = zms_window(pzms);
+
   /* Loop, sending packets while we can if the receiver supports streaming
    * data.
    */
@@ -888,47 +897,101 @@ static int zms_sendpacket(FAR struct zm_state_s *pzm)
 
       unacked = pzms->offset - pzms->lastoffs;
 
-      /* Can we still send?  If so, how much?   If rcvmax is zero, then the
-       * remote can handle full streaming and we never have to wait.
+      /* Can we still send?  If so, how much?   If there is no window, then
+       * the remote can handle full streaming and we never have to wait.
        * Otherwise, we have to restrict the total number of unacknowledged
-       * bytes to rcvmax.
+       * bytes to the window.
        */
 
-      zmdbg("sndsize: %d unacked: %d rcvmax: %d\n",
-            sndsize, unacked, pzms->rcvmax);
+      zmdbg("sndsize: %d unacked: %d window: %d\n",
+            sndsize, unacked, window);
 
-     if (pzms->rcvmax != 0)
+      if (window != 0)
         {
-          /* If we were to send 'sndsize' more bytes, would that exceed recvmax? */
+          sndsize = window - unacked;
+          zmdbg("Clipped sndsize: %d\n", sndsize);
+
+          /* Can we send anything? */
 
-          if (sndsize + unacked > pzms->rcvmax)
+          if (sndsize <= 0)
             {
-              /* Yes... clip the maximum so that we stay within that limit */
+              /* No, not now. Keep waiting */
 
-              int maximum = pzms->rcvmax - unacked;
-              if (sndsize < maximum)
-                {
-                  sndsize = maximum;
-                }
+              zmdbg("ZMS_STATE %d->%d\n", pzm->state, ZMS_SENDWAIT);
 
-              wait = true;
-              zmdbg("Clipped sndsize: %d\n", sndsize);
+              pzm->state   = ZMS_SENDWAIT;
+              pzm->timeout = CONFIG_SYSTEM_ZMODEM_RESPTIME;
+              return OK;
             }
         }
 
-      /* Can we send anything? */
+      /* Read file data into the packet buffer until it is full, the window
+       * is used up, or the file is exhausted.  The data is read in chunks
+       * no larger than half of the remaining room, so that the escaped data
+       * always fits.  Room is reserved for ZDLE, the packet type and an
+       * escaped 4-byte CRC.
+       */
+
+      bcrc32      = ((pzm->flags & ZM_FLAG_CRC32) != 0);
+      crc         = bcrc32 ? 0xffffffff : 0;
+      pzm->flags &= ~ZM_FLAG_ATSIGN;
+
+      ptr         = pzm->scratch;
+      eof         = false;
 
-      if (sndsize <= 0)
+      while ((avail = (CONFIG_SYSTEM_ZMODEM_SNDBUFSIZE - 11) -
+                      (int)(ptr - pzm->scratch)) >= 2)
         {
-          /* No, not now. Keep waiting */
+          avail /= 2;
+          if (window != 0 && avail > sndsize)
+            {
+              avail = sndsize;
+            }
 
-          zmdbg("ZMS_STATE %d->%d\n", pzm->state, ZMS_SENDWAIT);
+          if (avail <= 0)
+            {
+              break;
+            }
 
-          pzm->state   = ZMS_SENDWAIT;
-          pzm->timeout = CONFIG_SYSTEM_ZMODEM_RESPTIME;
-          return OK;
+          nread = zm_read(pzms->infd, pzms->rdbuf, avail);
+          if (nread <= 0)
+            {
+              eof = true;
+              break;
+            }
+
+          /* Add the new data to the accumulated CRC */
+
+          if (!bcrc32)
+            {
+              crc = (uint32_t)zm_crc16part(pzms->rdbuf, nread, (uint16_t)crc);
+            }
+          else
+            {
+              crc = zm_crc32part(pzms->rdbuf, nread, crc);
+            }
+
+          /* Put the data into the buffer, escaping as necessary */
+
+          ptr = zm_putzdlebuf(pzm, ptr, pzms->rdbuf, nread);
+
+          /* And increment the file offset */
+
+          pzms->offset += nread;
+          sndsize      -= nread;
+        }
+
+      /* There is no need to wait for a zero-length read to find the end of
+       * the file.
+       */
+
+      if (pzms->offset >= pzms->filesize)
+        {
+          eof = true;
         }
 
+      pktsize = (int32_t)(ptr - pzm->scratch);
+
       /* Determine what kind of packet to send
        *
        * ZCRCW:
@@ -949,6 +1012,10 @@ static int zms_sendpacket(FAR struct zm_state_s *pzm)
        *    with the last good file offset.  Another data subpacket
        *    continues immediately.  ZCRCQ subpackets are not used if the
        *    receiver does not indicate FDX ability with the CANFDX bit.
+       *
+       * With a window, the subpackets within the window are streamed with
+       * ZCRCG and the one that fills the window asks for a ZACK with the
+       * data packet type selected for the receiver (ZCRCW or ZCRCQ).
        */
 
       if ((pzm->flags & ZM_FLAG_WAIT) != 0)
@@ -956,56 +1023,15 @@ static int zms_sendpacket(FAR struct zm_state_s *pzm)
           type = ZCRCW;
           pzm->flags &= ~ZM_FLAG_WAIT;
         }
-      else if (wait)
+      else if (window != 0 && pzms->offset - pzms->lastoffs < window)
         {
-          type = ZCRCW;
+          type = ZCRCG;
         }
       else
         {
           type = pzms->dpkttype;
         }
 
-      /* Read characters from file and put into buffer until buffer is full
-       * or file is exhausted
-       */
-
-      bcrc32      = ((pzm->flags & ZM_FLAG_CRC32) != 0);
-      crc         = bcrc32 ? 0xffffffff : 0;
-      pzm->flags &= ~ZM_FLAG_ATSIGN;
-
-      ptr         = pzm->scratch;
-      pktsize     = 0;
-
-      while (pktsize <= (CONFIG_SYSTEM_ZMODEM_SNDBUFSIZE - 10) &&
-             (ret = zm_getc(pzms->infd)) != EOF)
-        {
-          /* Add the new value to the accumulated CRC */
-
-          uint8_t ch = (uint8_t)ret;
-          if (!bcrc32)
-            {
-              crc = (uint32_t)crc16part(&ch, 1, (uint16_t)crc);
-            }
-          else
-            {
-              crc = crc32part(&ch, 1, crc);
-            }
-
-          /* Put the character into the buffer, escaping as necessary */
-
-          ptr = zm_putzdle(pzm, ptr, ch);
-
-          /* Recalculate the accumulated packet size to handle expansion due
-           * to escaping.
-           */
-
-          pktsize = (int32_t)(ptr - pzm->scratch);
-
-          /* And increment the file offset */
-
-          pzms->offset++;
-        }
-
       /* If we've reached file end, a ZEOF header will follow.  If there's
        * room in the outgoing buffer for it, end the packet with ZCRCE and
        * append the ZEOF header.  If there isn't room, we'll have to do a
@@ -1013,10 +1039,10 @@ static int zms_sendpacket(FAR struct zm_state_s *pzm)
        */
 
       pzm->flags &= ~ZM_FLAG_EOF;
-      if (ret == EOF)
+      if (eof)
         {
           pzm->flags |= ZM_FLAG_EOF;
-          if (wait || (pzms->rcvmax != 0 && pktsize < 24))
+          if (type == ZCRCW || (pzms->rcvmax != 0 && pktsize < 24))
             {
               type = ZCRCW;
             }
@@ -1034,11 +1060,11 @@ static int zms_sendpacket(FAR struct zm_state_s *pzm)
 
       if (!bcrc32)
         {
-          crc = (uint32_t)crc16part(&type, 1, (uint16_t)crc);
+          crc = (uint32_t)zm_crc16part(&type, 1, (uint16_t)crc);
         }
       else
         {
-          crc = crc32part(&type, 1, crc);
+          crc = zm_crc32part(&type, 1, crc);
         }
 
       *ptr++ = type;
@@ -1121,10 +1147,15 @@ static int zms_sendpacket(FAR struct zm_state_s *pzm)
           break;
         }
     }
+
+  /* Keep streaming ZCRCG subpackets.  After a ZCRCQ, sending resumes when
+   * the ZACK arrives (see zms_sendack()).
+   */
+
 #ifdef CONFIG_SYSTEM_ZMODEM_RCVSAMPLE
-  while (pzm->state == ZMS_SENDING && !zm_rcvpending(pzm));
+  while (pzm->state == ZMS_SENDING && type == ZCRCG && !zm_rcvpending(pzm));
 #else
-  while (0);
+  while (pzm->state == ZMS_SENDING && type == ZCRCG);
 #endif
 
   return OK;
@@ -1177,6 +1208,17 @@ static int zms_sendack(FAR struct zm_state_s *pzm)
     }
 
   zmdbg("ZMS_STATE %d: offset: %ld\n", pzm->state, (unsigned long)pzms->offset);
+
+  /* The ZACK of a ZCRCQ subpacket re-opens the window: continue streaming
+   * subpackets of the same frame.
+   */
+
+  if (zms_window(pzms) != 0 &&
+      pzms->offset - pzms->lastoffs < zms_window(pzms))
+    {
+      return zms_sendpacket(pzm);
+    }
+
   return OK;
 }
 
@@ -1411,6 +1453,34 @@ static int zms_error(FAR struct zm_state_s *pzm)
   return OK;
 }
 
+/****************************************************************************
+ * Name: zms_window
+ *
+ * Description:
+ *   Return the number of file data bytes that may be sent without being
+ *   acknowledged, or zero if there is no limit.  The window is the receive
+ *   buffer length if the receiver gave one; otherwise a receiver that can
+ *   overlap serial and disk I/O is streamed CONFIG_SYSTEM_ZMODEM_SNDWINDOW
+ *   bytes per ZCRCQ.
+ *
+ ****************************************************************************/
+
+static int32_t zms_window(FAR struct zms_state_s *pzms)
+{
+  if (pzms->rcvmax != 0)
+    {
+      return pzms->rcvmax;
+    }
+
+  if (pzms->dpkttype == ZCRCQ)
+    {
+      return CONFIG_SYSTEM_ZMODEM_SNDWINDOW > 0 ?
+             CONFIG_SYSTEM_ZMODEM_SNDWINDOW : 1;
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: zms_sendfiledata
  *
@@ -197,7 +197,7 @@ static int zm_hdrevent(FAR struct zm_state_s *pzm)
 
       /* Checksum is over 9 bytes:  The header type, 4 data bytes, plus 4 CRC bytes */
 
-      crc = crc32part(pzm->hdrdata, 9, 0xffffffff);
+      crc = zm_crc32part(pzm->hdrdata, 9, 0xffffffff);
       if (crc != 0xdebb20e3)
         {
           zmdbg("ERROR: ZBIN32 CRC32 failure: %08x vs debb20e3\n", crc);
@@ -210,7 +210,7 @@ static int zm_hdrevent(FAR struct zm_state_s *pzm)
 
       /* Checksum is over 7 bytes:  The header type, 4 data bytes, plus 2 CRC bytes */
 
-      crc = crc16part(pzm->hdrdata, 7, 0);
+      crc = zm_crc16part(pzm->hdrdata, 7, 0);
       if (crc != 0)
         {
           zmdbg("ERROR: ZBIN/ZHEX CRC16 failure: %04x vs 0000\n", crc);
@@ -246,7 +246,7 @@ static int zm_dataevent(FAR struct zm_state_s *pzm)
     {
       uint32_t crc;
 
-      crc = crc32part(pzm->pktbuf, pzm->pktlen, 0xffffffff);
+      crc = zm_crc32part(pzm->pktbuf, pzm->pktlen, 0xffffffff);
       if (crc != 0xdebb20e3)
         {
           zmdbg("ERROR: ZBIN32 CRC32 failure: %08x vs debb20e3\n", crc);
@@ -267,7 +267,7 @@ static int zm_dataevent(FAR struct zm_state_s *pzm)
     {
       uint16_t crc;
 
-      crc = crc16part(pzm->pktbuf, pzm->pktlen, 0);
+      crc = zm_crc16part(pzm->pktbuf, pzm->pktlen, 0);
       if (crc != 0)
         {
           zmdbg("ERROR: ZBIN/ZHEX CRC16 failure: %04x vs 0000\n", crc);